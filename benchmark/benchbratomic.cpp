@@ -0,0 +1,188 @@
+/***************************************
+
+	Benchmarks for the atomic memory functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbratomic.h"
+#include "benchmark.h"
+#include "bratomic.h"
+#include "brcriticalsection.h"
+#include "brtick.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded benchmarks
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
+#define USETHREADS
+#endif
+
+struct AtomicData_t {
+	volatile Word32 m_uStart;	// Set when all threads are to begin
+	volatile Word32 m_uCounter;	// Shared counter
+	SpinLock m_SpinLock;		// Lock for the SpinLock benchmark
+	CriticalSection m_Lock;		// Lock for the CriticalSection benchmark
+	Thread::FunctionPtr m_pProc;	// Function each thread runs
+	WordPtr m_uIterations;		// Number of increments each thread performs
+	Word m_uThreads;			// Number of threads to run
+};
+
+//
+// Thread counts to test, each must have a name below
+//
+
+static const Word g_ThreadCounts[5] = {1,2,4,8,16};
+
+static const char *g_FetchAddNames[5] = {
+	"AtomicFetchAdd 1 thread","AtomicFetchAdd 2 threads","AtomicFetchAdd 4 threads",
+	"AtomicFetchAdd 8 threads","AtomicFetchAdd 16 threads"
+};
+
+static const char *g_CompareNames[5] = {
+	"AtomicCompareExchange 1 thread","AtomicCompareExchange 2 threads","AtomicCompareExchange 4 threads",
+	"AtomicCompareExchange 8 threads","AtomicCompareExchange 16 threads"
+};
+
+static const char *g_SpinLockNames[5] = {
+	"SpinLock 1 thread","SpinLock 2 threads","SpinLock 4 threads",
+	"SpinLock 8 threads","SpinLock 16 threads"
+};
+
+static const char *g_CriticalSectionNames[5] = {
+	"CriticalSection 1 thread","CriticalSection 2 threads","CriticalSection 4 threads",
+	"CriticalSection 8 threads","CriticalSection 16 threads"
+};
+
+static void WaitForStart(AtomicData_t *pAtomic)
+{
+	while (!AtomicLoad(&pAtomic->m_uStart,MEMORYORDER_ACQUIRE)) {
+		Sleep(SLEEP_YIELD);
+	}
+}
+
+static WordPtr BURGER_API FetchAddThread(void *pData)
+{
+	AtomicData_t *pAtomic = static_cast<AtomicData_t *>(pData);
+	WaitForStart(pAtomic);
+	WordPtr i = pAtomic->m_uIterations;
+	do {
+		AtomicFetchAdd(&pAtomic->m_uCounter,1,MEMORYORDER_RELAXED);
+	} while (--i);
+	return 0;
+}
+
+static WordPtr BURGER_API CompareThread(void *pData)
+{
+	AtomicData_t *pAtomic = static_cast<AtomicData_t *>(pData);
+	WaitForStart(pAtomic);
+	WordPtr i = pAtomic->m_uIterations;
+	do {
+		Word32 uExpected = AtomicLoad(&pAtomic->m_uCounter,MEMORYORDER_RELAXED);
+		while (!AtomicCompareExchange(&pAtomic->m_uCounter,&uExpected,uExpected+1,MEMORYORDER_RELAXED)) {
+		}
+	} while (--i);
+	return 0;
+}
+
+static WordPtr BURGER_API SpinLockThread(void *pData)
+{
+	AtomicData_t *pAtomic = static_cast<AtomicData_t *>(pData);
+	WaitForStart(pAtomic);
+	WordPtr i = pAtomic->m_uIterations;
+	do {
+		pAtomic->m_SpinLock.Lock();
+		pAtomic->m_uCounter = pAtomic->m_uCounter+1;
+		pAtomic->m_SpinLock.Unlock();
+	} while (--i);
+	return 0;
+}
+
+static WordPtr BURGER_API CriticalSectionThread(void *pData)
+{
+	AtomicData_t *pAtomic = static_cast<AtomicData_t *>(pData);
+	WaitForStart(pAtomic);
+	WordPtr i = pAtomic->m_uIterations;
+	do {
+		pAtomic->m_Lock.Lock();
+		pAtomic->m_uCounter = pAtomic->m_uCounter+1;
+		pAtomic->m_Lock.Unlock();
+	} while (--i);
+	return 0;
+}
+
+/***************************************
+
+	Run the threads, each performs uIterations
+	increments of the shared counter
+
+***************************************/
+
+static void BURGER_API BenchThreads(void *pData,WordPtr uIterations)
+{
+	AtomicData_t *pAtomic = static_cast<AtomicData_t *>(pData);
+	pAtomic->m_uIterations = uIterations;
+	pAtomic->m_uCounter = 0;
+	// A single thread doesn't need to wait
+	Word uThreads = pAtomic->m_uThreads;
+	pAtomic->m_uStart = (uThreads==1);
+	Thread Threads[16];
+	Word i = 1;
+	while (i<uThreads) {
+		Threads[i].Start(pAtomic->m_pProc,pAtomic);
+		++i;
+	}
+	AtomicStore(&pAtomic->m_uStart,1,MEMORYORDER_RELEASE);
+	pAtomic->m_pProc(pAtomic);
+	i = 1;
+	while (i<uThreads) {
+		Threads[i].Wait();
+		++i;
+	}
+}
+
+/***************************************
+
+	Compare the cost of contended updates with
+	atomic increments, compare and swap loops, a
+	SpinLock and a CriticalSection. The throughput
+	is in increments per second for all threads
+
+***************************************/
+
+void BURGER_API BenchBratomic(Benchmark *pBench)
+{
+	AtomicData_t Data;
+	Word uMaxThreads = 1;
+#if defined(USETHREADS)
+	uMaxThreads = Thread::GetProcessorCount();
+	if (uMaxThreads<2) {
+		uMaxThreads = 2;
+	}
+#endif
+	Word i = 0;
+	do {
+		Word uThreads = g_ThreadCounts[i];
+		if (uThreads>uMaxThreads) {
+			break;
+		}
+		Data.m_uThreads = uThreads;
+		Data.m_pProc = FetchAddThread;
+		pBench->Run(g_FetchAddNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+		Data.m_pProc = CompareThread;
+		pBench->Run(g_CompareNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+		Data.m_pProc = SpinLockThread;
+		pBench->Run(g_SpinLockNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+		Data.m_pProc = CriticalSectionThread;
+		pBench->Run(g_CriticalSectionNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+	} while (++i<BURGER_ARRAYSIZE(g_ThreadCounts));
+}
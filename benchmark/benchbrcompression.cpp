@@ -0,0 +1,205 @@
+/***************************************
+
+	Benchmarks for the compression classes
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrcompression.h"
+#include "benchmark.h"
+#include "brcompresslzss.h"
+#include "brdecompresslzss.h"
+#include "brcompresslbmrle.h"
+#include "brdecompresslbmrle.h"
+#include "brcompresslz4.h"
+#include "brdecompresslz4.h"
+#include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Size of the uncompressed data
+//
+
+static const WordPtr cRawLength = 0x10000;
+
+struct CompressionData_t {
+	Compress *m_pCompress;		// Compressor to test
+	const Word8 *m_pRaw;		// Uncompressed data
+	const Word8 *m_pPacked;		// Compressed data
+	WordPtr m_uPackedLength;	// Size of the compressed data
+	Word8 *m_pOutput;			// Buffer for decompression
+};
+
+//
+// Words used to create compressible data
+//
+
+static const char *g_Words[16] = {
+	"burger ","library ","compression ","the ","of ","and ","image ","sound ",
+	"file ","manager ","0123 ","\t","\n","\n\n","    ","renderer "
+};
+
+/***************************************
+
+	Create data that's a mix of repeated words,
+	runs of a single byte and noise
+
+***************************************/
+
+static void CreateCompressibleData(Word8 *pOutput,WordPtr uLength)
+{
+	Word32 uSeed = 0xBADBEEFU;
+	while (uLength) {
+		uSeed = (uSeed*1664525U)+1013904223U;
+		Word uToken = static_cast<Word>(uSeed>>24U);
+		WordPtr uChunk;
+		if (uToken<160U) {
+			// Dictionary word
+			const char *pWord = g_Words[uToken&15U];
+			uChunk = StringLength(pWord);
+			if (uChunk>uLength) {
+				uChunk = uLength;
+			}
+			MemoryCopy(pOutput,pWord,uChunk);
+		} else if (uToken<224U) {
+			// Run of a single byte
+			uChunk = (uToken&31U)+2U;
+			if (uChunk>uLength) {
+				uChunk = uLength;
+			}
+			MemoryFill(pOutput,static_cast<Word8>(uSeed>>8U),uChunk);
+		} else {
+			// Noise
+			uChunk = (uToken&15U)+1U;
+			if (uChunk>uLength) {
+				uChunk = uLength;
+			}
+			FillRandom(pOutput,uChunk,uSeed);
+		}
+		pOutput += uChunk;
+		uLength -= uChunk;
+	}
+}
+
+static void BURGER_API BenchCompress(void *pData,WordPtr uIterations)
+{
+	const CompressionData_t *pCompression = static_cast<const CompressionData_t *>(pData);
+	Compress *pCompress = pCompression->m_pCompress;
+	do {
+		pCompress->Init();
+		pCompress->Process(pCompression->m_pRaw,cRawLength);
+		pCompress->Finalize();
+		DoNotOptimize(pCompress->GetOutputSize());
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDecompressLZSS(void *pData,WordPtr uIterations)
+{
+	const CompressionData_t *pCompression = static_cast<const CompressionData_t *>(pData);
+	do {
+		DoNotOptimize(SimpleDecompressLZSS(pCompression->m_pOutput,cRawLength,pCompression->m_pPacked,pCompression->m_uPackedLength));
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDecompressILBMRLE(void *pData,WordPtr uIterations)
+{
+	const CompressionData_t *pCompression = static_cast<const CompressionData_t *>(pData);
+	do {
+		DoNotOptimize(SimpleDecompressILBMRLE(pCompression->m_pOutput,cRawLength,pCompression->m_pPacked,pCompression->m_uPackedLength));
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDecompressLZ4(void *pData,WordPtr uIterations)
+{
+	const CompressionData_t *pCompression = static_cast<const CompressionData_t *>(pData);
+	do {
+		DoNotOptimize(SimpleDecompressLZ4(pCompression->m_pOutput,cRawLength,pCompression->m_pPacked,pCompression->m_uPackedLength));
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Compress the raw data and return a
+	buffer with the packed result
+
+***************************************/
+
+static Word8 *PackData(Compress *pCompress,const Word8 *pRaw,WordPtr *pLength)
+{
+	pCompress->Init();
+	pCompress->Process(pRaw,cRawLength);
+	pCompress->Finalize();
+	return static_cast<Word8 *>(pCompress->GetOutput()->Flatten(pLength));
+}
+
+/***************************************
+
+	Benchmark the compression classes
+
+***************************************/
+
+void BURGER_API BenchBrcompression(Benchmark *pBench)
+{
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(cRawLength));
+	Word8 *pOutput = static_cast<Word8 *>(Alloc(cRawLength));
+	if (pRaw && pOutput) {
+		CreateCompressibleData(pRaw,cRawLength);
+
+		CompressionData_t Data;
+		Data.m_pRaw = pRaw;
+		Data.m_pOutput = pOutput;
+
+		CompressLZSS Lzss;
+		Data.m_pCompress = &Lzss;
+		Word8 *pPacked = PackData(&Lzss,pRaw,&Data.m_uPackedLength);
+		if (pPacked) {
+			Data.m_pPacked = pPacked;
+			pBench->Run("CompressLZSS 64K",BenchCompress,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			pBench->Run("SimpleDecompressLZSS 64K",BenchDecompressLZSS,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			Free(pPacked);
+		}
+
+		CompressILBMRLE Rle;
+		Data.m_pCompress = &Rle;
+		pPacked = PackData(&Rle,pRaw,&Data.m_uPackedLength);
+		if (pPacked) {
+			Data.m_pPacked = pPacked;
+			pBench->Run("CompressILBMRLE 64K",BenchCompress,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			pBench->Run("SimpleDecompressILBMRLE 64K",BenchDecompressILBMRLE,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			Free(pPacked);
+		}
+
+		// The same data as above so the codecs can be compared
+		CompressLZ4 Lz4;
+		Data.m_pCompress = &Lz4;
+		pPacked = PackData(&Lz4,pRaw,&Data.m_uPackedLength);
+		if (pPacked) {
+			Data.m_pPacked = pPacked;
+			pBench->Run("CompressLZ4 64K",BenchCompress,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			pBench->Run("SimpleDecompressLZ4 64K",BenchDecompressLZ4,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			Free(pPacked);
+		}
+
+		Lz4.SetHighCompression(TRUE);
+		pPacked = PackData(&Lz4,pRaw,&Data.m_uPackedLength);
+		if (pPacked) {
+			Data.m_pPacked = pPacked;
+			pBench->Run("CompressLZ4 high 64K",BenchCompress,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			pBench->Run("SimpleDecompressLZ4 high 64K",BenchDecompressLZ4,&Data,cRawLength,Benchmark::UNITS_BYTES);
+			Free(pPacked);
+		}
+	}
+	Free(pOutput);
+	Free(pRaw);
+}
@@ -0,0 +1,136 @@
+/***************************************
+
+	Benchmarks for the hash and checksum functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrhashes.h"
+#include "benchmark.h"
+#include "bradler16.h"
+#include "bradler32.h"
+#include "brcrc32.h"
+#include "brmd2.h"
+#include "brmd4.h"
+#include "brmd5.h"
+#include "brsha1.h"
+#include "brsdbmhash.h"
+#include "brdjb2hash.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Size of the buffer to hash
+//
+
+static const WordPtr cHashLength = 0x10000;
+
+static void BURGER_API BenchCRC32B(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(CalcCRC32B(pData,cHashLength));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchAdler32(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(CalcAdler32(pData,cHashLength));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchAdler16(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(CalcAdler16(pData,cHashLength));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMD2(void *pData,WordPtr uIterations)
+{
+	MD2_t Output;
+	do {
+		Hash(&Output,pData,cHashLength);
+		DoNotOptimize(Output);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMD4(void *pData,WordPtr uIterations)
+{
+	MD4_t Output;
+	do {
+		Hash(&Output,pData,cHashLength);
+		DoNotOptimize(Output);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMD5(void *pData,WordPtr uIterations)
+{
+	MD5_t Output;
+	do {
+		Hash(&Output,pData,cHashLength);
+		DoNotOptimize(Output);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchSHA1(void *pData,WordPtr uIterations)
+{
+	SHA1_t Output;
+	do {
+		Hash(&Output,pData,cHashLength);
+		DoNotOptimize(Output);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchSDBMHash(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(SDBMHash(pData,cHashLength));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDJB2HashAdd(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(DJB2HashAdd(pData,cHashLength));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDJB2HashAddCase(void *pData,WordPtr uIterations)
+{
+	do {
+		DoNotOptimize(DJB2HashAddCase(pData,cHashLength));
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Benchmark the hash and checksum functions
+
+***************************************/
+
+void BURGER_API BenchBrhashes(Benchmark *pBench)
+{
+	void *pBuffer = Alloc(cHashLength);
+	if (pBuffer) {
+		FillRandom(pBuffer,cHashLength,0x12345678U);
+		pBench->Run("CalcCRC32B 64K",BenchCRC32B,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("CalcAdler32 64K",BenchAdler32,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("CalcAdler16 64K",BenchAdler16,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("MD2 64K",BenchMD2,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("MD4 64K",BenchMD4,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("MD5 64K",BenchMD5,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("SHA1 64K",BenchSHA1,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("SDBMHash 64K",BenchSDBMHash,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("DJB2HashAdd 64K",BenchDJB2HashAdd,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		pBench->Run("DJB2HashAddCase 64K",BenchDJB2HashAddCase,pBuffer,cHashLength,Benchmark::UNITS_BYTES);
+		Free(pBuffer);
+	}
+}
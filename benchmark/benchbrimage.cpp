@@ -0,0 +1,234 @@
+/***************************************
+
+	Benchmarks for the image functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrimage.h"
+#include "benchmark.h"
+#include "brimage.h"
+#include "brpalette.h"
+#include "brdxt1.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Size of the source image
+//
+
+static const Word cImageSize = 256;
+static const Word cPixelCount = cImageSize*cImageSize;
+static const Word cBlockCount = (cImageSize/4)*(cImageSize/4);
+
+struct ImageData_t {
+	Image m_Source;					// True color source image
+	Image m_Resized;				// Destination for resizing
+	Image m_MipMapped;				// Image with mip maps
+	Image m_Remapped;				// 8 bit destination
+	Dxt1Packet_t *m_pPackets;		// DXT1 compressed image
+	RGBAWord8_t m_Palette[256];		// Palette for the 8 bit image
+	InverseColorTable m_Inverse;	// Lookup table for m_Palette
+	Word8 m_RGBPalette[256*3];		// m_Palette as RGB triplets
+};
+
+static void BURGER_API BenchResizeBox(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_Resized.Resize(&pImages->m_Source,cImageSize/2,cImageSize/2,Image::FILTER_BOX);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchResizeLanczos(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_Resized.Resize(&pImages->m_Source,cImageSize/2,cImageSize/2,Image::FILTER_LANCZOS);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchResizeKaiserUp(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_Resized.Resize(&pImages->m_Source,(cImageSize*3)/2,(cImageSize*3)/2,Image::FILTER_KAISER);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchGenerateMipMaps(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_MipMapped.GenerateMipMaps(Image::FILTER_BOX);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchVerticleFlip(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_Source.VerticleFlip();
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchHorizontalFlip(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		pImages->m_Source.HorizontalFlip();
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDxt1Decompress(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	RGBAWord8_t *pOutput = reinterpret_cast<RGBAWord8_t *>(pImages->m_Source.GetImage());
+	WordPtr uStride = pImages->m_Source.GetStride();
+	do {
+		DecompressImage(pOutput,uStride,cImageSize,cImageSize,pImages->m_pPackets,(cImageSize/4)*sizeof(Dxt1Packet_t));
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchRemapImage(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		Palette::RemapImage(&pImages->m_Remapped,&pImages->m_Source,pImages->m_Palette,256,Palette::DITHER_NONE);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchRemapImageDither(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	do {
+		Palette::RemapImage(&pImages->m_Remapped,&pImages->m_Source,pImages->m_Palette,256,Palette::DITHER_ERRORDIFFUSION);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchQuantize(void *pData,WordPtr uIterations)
+{
+	ImageData_t *pImages = static_cast<ImageData_t *>(pData);
+	RGBAWord8_t NewPalette[256];
+	do {
+		Palette::Quantize(&pImages->m_Remapped,NewPalette,&pImages->m_Source,256,Palette::DITHER_NONE);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchFindColorIndex(void *pData,WordPtr uIterations)
+{
+	const ImageData_t *pImages = static_cast<const ImageData_t *>(pData);
+	Word32 uSeed = 0x2468ACE0U;
+	do {
+		uSeed = (uSeed*1664525U)+1013904223U;
+		DoNotOptimize(Palette::FindColorIndex(pImages->m_RGBPalette,uSeed>>24U,(uSeed>>16U)&0xFFU,(uSeed>>8U)&0xFFU,256));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchInverseColorTable(void *pData,WordPtr uIterations)
+{
+	const ImageData_t *pImages = static_cast<const ImageData_t *>(pData);
+	Word32 uSeed = 0x2468ACE0U;
+	do {
+		uSeed = (uSeed*1664525U)+1013904223U;
+		DoNotOptimize(pImages->m_Inverse.FindColorIndex(uSeed>>24U,(uSeed>>16U)&0xFFU,(uSeed>>8U)&0xFFU));
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Create a true color image with smooth
+	gradients and a little noise
+
+***************************************/
+
+static void CreateImage(Image *pImage)
+{
+	Word8 *pLine = pImage->GetImage();
+	WordPtr uStride = pImage->GetStride();
+	Word32 uSeed = 0x31415926U;
+	Word y = 0;
+	do {
+		Word8 *pWork = pLine;
+		Word x = 0;
+		do {
+			uSeed = (uSeed*1664525U)+1013904223U;
+			Word uNoise = (uSeed>>28U);
+			pWork[0] = static_cast<Word8>(x+uNoise);
+			pWork[1] = static_cast<Word8>(y+uNoise);
+			pWork[2] = static_cast<Word8>(((x^y)&0x80U)+(uNoise*4U));
+			pWork[3] = 0xFF;
+			pWork+=4;
+		} while (++x<cImageSize);
+		pLine += uStride;
+	} while (++y<cImageSize);
+}
+
+/***************************************
+
+	Benchmark the image functions
+
+***************************************/
+
+void BURGER_API BenchBrimage(Benchmark *pBench)
+{
+	void *pMemory = Alloc(sizeof(ImageData_t));
+	if (pMemory) {
+		ImageData_t *pImages = new (pMemory) ImageData_t;
+		pImages->m_pPackets = static_cast<Dxt1Packet_t *>(Alloc(sizeof(Dxt1Packet_t)*cBlockCount));
+		if (pImages->m_pPackets &&
+			!pImages->m_Source.Init(cImageSize,cImageSize,Image::PIXELTYPE8888) &&
+			!pImages->m_MipMapped.Init(cImageSize,cImageSize,Image::PIXELTYPE8888,8)) {
+			CreateImage(&pImages->m_Source);
+			CreateImage(&pImages->m_MipMapped);
+
+			pBench->Run("Image::Resize box 256 to 128",BenchResizeBox,pImages,(cImageSize/2)*(cImageSize/2),Benchmark::UNITS_ITEMS);
+			pBench->Run("Image::Resize Lanczos 256 to 128",BenchResizeLanczos,pImages,(cImageSize/2)*(cImageSize/2),Benchmark::UNITS_ITEMS);
+			pBench->Run("Image::Resize Kaiser 256 to 384",BenchResizeKaiserUp,pImages,((cImageSize*3)/2)*((cImageSize*3)/2),Benchmark::UNITS_ITEMS);
+			pBench->Run("Image::GenerateMipMaps box 256",BenchGenerateMipMaps,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+			pBench->Run("Image::VerticleFlip 256",BenchVerticleFlip,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+			pBench->Run("Image::HorizontalFlip 256",BenchHorizontalFlip,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+
+			// Any bit pattern is valid DXT1 data
+			FillRandom(pImages->m_pPackets,sizeof(Dxt1Packet_t)*cBlockCount,0x0BADF00DU);
+			pBench->Run("DecompressImage DXT1 256",BenchDxt1Decompress,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+
+			// The decompression overwrote the source, restore it and create a palette for it
+			CreateImage(&pImages->m_Source);
+			if (!Palette::Quantize(&pImages->m_Remapped,pImages->m_Palette,&pImages->m_Source,256,Palette::DITHER_NONE) &&
+				!pImages->m_Inverse.Init(pImages->m_Palette,256)) {
+				WordPtr i = 0;
+				do {
+					pImages->m_RGBPalette[i*3] = pImages->m_Palette[i].m_uRed;
+					pImages->m_RGBPalette[i*3+1] = pImages->m_Palette[i].m_uGreen;
+					pImages->m_RGBPalette[i*3+2] = pImages->m_Palette[i].m_uBlue;
+				} while (++i<256);
+				pBench->Run("Palette::Quantize 256",BenchQuantize,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+				pBench->Run("Palette::RemapImage 256",BenchRemapImage,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+				pBench->Run("Palette::RemapImage dithered 256",BenchRemapImageDither,pImages,cPixelCount,Benchmark::UNITS_ITEMS);
+				pBench->Run("Palette::FindColorIndex",BenchFindColorIndex,pImages,1,Benchmark::UNITS_ITEMS);
+				pBench->Run("InverseColorTable::FindColorIndex",BenchInverseColorTable,pImages,1,Benchmark::UNITS_ITEMS);
+			}
+		}
+		Free(pImages->m_pPackets);
+		pImages->~ImageData_t();
+		Free(pImages);
+	}
+}
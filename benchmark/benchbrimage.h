@@ -0,0 +1,24 @@
+/***************************************
+
+	Benchmarks for the image functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BENCHBRIMAGE_H__
+#define __BENCHBRIMAGE_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+class Benchmark;
+extern void BURGER_API BenchBrimage(Benchmark *pBench);
+
+#endif
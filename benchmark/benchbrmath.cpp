@@ -0,0 +1,215 @@
+/***************************************
+
+	Benchmarks for the math functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrmath.h"
+#include "benchmark.h"
+#include "brfloatingpoint.h"
+#include "brfixedpoint.h"
+#include "brmatrix4d.h"
+#include "brvector4d.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Number of values processed by each iteration
+//
+
+static const WordPtr cValueCount = 1024;
+
+struct MathData_t {
+	float m_Floats[cValueCount];			// Values from -1000 to 1000
+	Fixed32 m_Fixed[cValueCount];			// Same values in 16.16 fixed point
+	Word32 m_Integers[cValueCount];			// Positive integers
+	Vector4D_t m_Vectors[cValueCount];		// Points to transform
+	Matrix4D_t m_Matrices[2];				// Matrices to multiply
+};
+
+static void BURGER_API BenchSqrt(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		float fTotal = 0.0f;
+		WordPtr i = 0;
+		do {
+			fTotal += Sqrt(Abs(pFloats[i]));
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchSin(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		float fTotal = 0.0f;
+		WordPtr i = 0;
+		do {
+			fTotal += Sin(pFloats[i]);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchCos(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		float fTotal = 0.0f;
+		WordPtr i = 0;
+		do {
+			fTotal += Cos(pFloats[i]);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchATan2(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		float fTotal = 0.0f;
+		WordPtr i = 0;
+		do {
+			fTotal += ATan2(pFloats[i],pFloats[(i+1)&(cValueCount-1)]);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchFloor(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		float fTotal = 0.0f;
+		WordPtr i = 0;
+		do {
+			fTotal += Floor(pFloats[i]);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchFloatToIntFloor(void *pData,WordPtr uIterations)
+{
+	const float *pFloats = static_cast<const MathData_t *>(pData)->m_Floats;
+	do {
+		Int32 iTotal = 0;
+		WordPtr i = 0;
+		do {
+			iTotal += FloatToIntFloor(pFloats[i]);
+		} while (++i<cValueCount);
+		DoNotOptimize(iTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchFixedMultiply(void *pData,WordPtr uIterations)
+{
+	const Fixed32 *pFixed = static_cast<const MathData_t *>(pData)->m_Fixed;
+	do {
+		Fixed32 fTotal = 0;
+		WordPtr i = 0;
+		do {
+			fTotal += FixedMultiply(pFixed[i],pFixed[(i+1)&(cValueCount-1)]);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchFixedDivide(void *pData,WordPtr uIterations)
+{
+	const Fixed32 *pFixed = static_cast<const MathData_t *>(pData)->m_Fixed;
+	do {
+		Fixed32 fTotal = 0;
+		WordPtr i = 0;
+		do {
+			fTotal += FixedDivide(pFixed[i],pFixed[(i+1)&(cValueCount-1)]|1);
+		} while (++i<cValueCount);
+		DoNotOptimize(fTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchIntegerSqrt(void *pData,WordPtr uIterations)
+{
+	const Word32 *pIntegers = static_cast<const MathData_t *>(pData)->m_Integers;
+	do {
+		Word32 uTotal = 0;
+		WordPtr i = 0;
+		do {
+			uTotal += Sqrt(pIntegers[i]);
+		} while (++i<cValueCount);
+		DoNotOptimize(uTotal);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMatrixMultiply(void *pData,WordPtr uIterations)
+{
+	const MathData_t *pMath = static_cast<const MathData_t *>(pData);
+	Matrix4D_t Output;
+	do {
+		Output.Multiply(&pMath->m_Matrices[0],&pMath->m_Matrices[1]);
+		DoNotOptimize(Output);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMatrixTransform(void *pData,WordPtr uIterations)
+{
+	MathData_t *pMath = static_cast<MathData_t *>(pData);
+	Vector4D_t Output;
+	do {
+		WordPtr i = 0;
+		do {
+			pMath->m_Matrices[0].Transform(&Output,&pMath->m_Vectors[i]);
+			DoNotOptimize(Output);
+		} while (++i<cValueCount);
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Benchmark the math functions
+
+***************************************/
+
+void BURGER_API BenchBrmath(Benchmark *pBench)
+{
+	MathData_t *pMath = static_cast<MathData_t *>(Alloc(sizeof(MathData_t)));
+	if (pMath) {
+		Word32 uSeed = 0x13579BDFU;
+		WordPtr i = 0;
+		do {
+			uSeed = (uSeed*1664525U)+1013904223U;
+			// -1000.0f to 1000.0f
+			float fValue = (static_cast<float>(uSeed>>8U)*(2000.0f/16777216.0f))-1000.0f;
+			pMath->m_Floats[i] = fValue;
+			pMath->m_Fixed[i] = FLOATTOFIXED(fValue);
+			pMath->m_Integers[i] = uSeed>>1U;
+			pMath->m_Vectors[i].Set(fValue,fValue*0.5f,fValue*0.25f,1.0f);
+		} while (++i<cValueCount);
+		pMath->m_Matrices[0].SetYXZ(0.5f,1.0f,1.5f);
+		pMath->m_Matrices[1].SetZYX(1.25f,0.75f,0.25f);
+
+		pBench->Run("Sqrt(float)",BenchSqrt,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("Sin(float)",BenchSin,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("Cos(float)",BenchCos,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("ATan2(float)",BenchATan2,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("Floor(float)",BenchFloor,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("FloatToIntFloor",BenchFloatToIntFloor,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("FixedMultiply",BenchFixedMultiply,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("FixedDivide",BenchFixedDivide,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("Sqrt(Word32)",BenchIntegerSqrt,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		pBench->Run("Matrix4D_t::Multiply",BenchMatrixMultiply,pMath,1,Benchmark::UNITS_ITEMS);
+		pBench->Run("Matrix4D_t::Transform(Vector4D_t)",BenchMatrixTransform,pMath,cValueCount,Benchmark::UNITS_ITEMS);
+		Free(pMath);
+	}
+}
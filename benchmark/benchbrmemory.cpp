@@ -0,0 +1,153 @@
+/***************************************
+
+	Benchmarks for the memory copy functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrmemory.h"
+#include "benchmark.h"
+#include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+#include <string.h>
+
+using namespace Burger;
+
+//
+// Largest buffer to copy
+//
+
+static const WordPtr cMaxLength = 0x100000;
+
+struct MemoryData_t {
+	Word8 *m_pOutput;		// Destination buffer
+	const Word8 *m_pInput;	// Source buffer
+	WordPtr m_uLength;		// Number of bytes to process
+};
+
+//
+// Buffer sizes to test, from a few bytes to beyond the
+// size of most level 2 caches
+//
+
+static const WordPtr g_Lengths[5] = {
+	16,256,4096,0x10000,cMaxLength
+};
+
+static const char *g_CopyNames[5] = {
+	"MemoryCopy 16","MemoryCopy 256","MemoryCopy 4K","MemoryCopy 64K","MemoryCopy 1M"
+};
+
+static const char *g_memcpyNames[5] = {
+	"memcpy 16","memcpy 256","memcpy 4K","memcpy 64K","memcpy 1M"
+};
+
+static const char *g_MoveNames[5] = {
+	"MemoryMove overlap 16","MemoryMove overlap 256","MemoryMove overlap 4K","MemoryMove overlap 64K","MemoryMove overlap 1M"
+};
+
+static const char *g_FillNames[5] = {
+	"MemoryFill 16","MemoryFill 256","MemoryFill 4K","MemoryFill 64K","MemoryFill 1M"
+};
+
+static const char *g_ClearNames[5] = {
+	"MemoryClear 16","MemoryClear 256","MemoryClear 4K","MemoryClear 64K","MemoryClear 1M"
+};
+
+static const char *g_CompareNames[5] = {
+	"MemoryCompare 16","MemoryCompare 256","MemoryCompare 4K","MemoryCompare 64K","MemoryCompare 1M"
+};
+
+static void BURGER_API BenchMemoryCopy(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		MemoryCopy(pMemory->m_pOutput,pMemory->m_pInput,pMemory->m_uLength);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API Benchmemcpy(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		memcpy(pMemory->m_pOutput,pMemory->m_pInput,pMemory->m_uLength);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMemoryMove(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		// Overlapping copy one byte higher, forcing a backwards copy
+		MemoryMove(pMemory->m_pOutput+1,pMemory->m_pOutput,pMemory->m_uLength);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMemoryFill(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		MemoryFill(pMemory->m_pOutput,0xD5,pMemory->m_uLength);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMemoryClear(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		MemoryClear(pMemory->m_pOutput,pMemory->m_uLength);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchMemoryCompare(void *pData,WordPtr uIterations)
+{
+	const MemoryData_t *pMemory = static_cast<const MemoryData_t *>(pData);
+	do {
+		DoNotOptimize(MemoryCompare(pMemory->m_pOutput,pMemory->m_pInput,pMemory->m_uLength));
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Benchmark the memory functions
+
+***************************************/
+
+void BURGER_API BenchBrmemory(Benchmark *pBench)
+{
+	Word8 *pInput = static_cast<Word8 *>(Alloc(cMaxLength));
+	// Extra space for the overlapping move
+	Word8 *pOutput = static_cast<Word8 *>(Alloc(cMaxLength+16));
+	if (pInput && pOutput) {
+		FillRandom(pInput,cMaxLength,0xDEADBEEFU);
+		MemoryData_t Data;
+		Data.m_pOutput = pOutput;
+		Data.m_pInput = pInput;
+		WordPtr i = 0;
+		do {
+			WordPtr uLength = g_Lengths[i];
+			Data.m_uLength = uLength;
+			pBench->Run(g_CopyNames[i],BenchMemoryCopy,&Data,uLength,Benchmark::UNITS_BYTES);
+			pBench->Run(g_memcpyNames[i],Benchmemcpy,&Data,uLength,Benchmark::UNITS_BYTES);
+			pBench->Run(g_MoveNames[i],BenchMemoryMove,&Data,uLength,Benchmark::UNITS_BYTES);
+			pBench->Run(g_FillNames[i],BenchMemoryFill,&Data,uLength,Benchmark::UNITS_BYTES);
+			pBench->Run(g_ClearNames[i],BenchMemoryClear,&Data,uLength,Benchmark::UNITS_BYTES);
+			// Make the buffers match so the entire length is compared
+			MemoryCopy(pOutput,pInput,uLength);
+			pBench->Run(g_CompareNames[i],BenchMemoryCompare,&Data,uLength,Benchmark::UNITS_BYTES);
+		} while (++i<BURGER_ARRAYSIZE(g_Lengths));
+	}
+	Free(pOutput);
+	Free(pInput);
+}
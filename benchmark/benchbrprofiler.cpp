@@ -0,0 +1,54 @@
+/***************************************
+
+	Benchmarks for the profiler
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+// Compile in the zones for this file
+#define BURGER_PROFILER
+
+#include "benchbrprofiler.h"
+#include "benchmark.h"
+#include "brprofiler.h"
+
+using namespace Burger;
+
+//
+// Number of events in the ring buffer, it wraps
+// around while recording
+//
+
+static const Word cEventCount = 65536;
+
+static const char g_Zone[] = "Zone";
+
+static void BURGER_API BenchZone(void * /* pData */,WordPtr uIterations)
+{
+	do {
+		ProfileZone Zone(g_Zone);
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Measure the cost of a zone when the profiler
+	is stopped and when it's recording
+
+***************************************/
+
+void BURGER_API BenchBrprofiler(Benchmark *pBench)
+{
+	Profiler::Init(cEventCount);
+	pBench->Run("ProfileZone stopped",BenchZone,NULL);
+	Profiler::Start();
+	pBench->Run("ProfileZone recording",BenchZone,NULL);
+	Profiler::Stop();
+	Profiler::Shutdown();
+}
@@ -0,0 +1,267 @@
+/***************************************
+
+	Benchmarks for the software renderers
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrrenderer.h"
+#include "benchmark.h"
+#include "brrenderersoftware8.h"
+#include "brrenderersoftware16.h"
+#include "brrenderersoftware32.h"
+#include "brimage.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Size of the frame buffer and the number of sprites in a frame
+//
+
+static const Word cBenchWidth = 640;
+static const Word cBenchHeight = 480;
+static const Word cBenchSprites = 2000;
+
+//
+// Sprite sizes drawn, from tiny to large
+//
+
+struct SpriteSize_t {
+	Word m_uWidth;		// Width in pixels
+	Word m_uHeight;		// Height in pixels
+};
+
+static const SpriteSize_t g_SpriteSizes[8] = {
+	{8,8},{16,16},{24,13},{32,32},{48,20},{64,64},{100,37},{128,128}
+};
+
+struct Placement_t {
+	int m_iX;			// Left edge, may be off screen
+	int m_iY;			// Top edge, may be off screen
+	Word m_uWidth;		// Width in pixels
+	Word m_uHeight;		// Height in pixels
+};
+
+struct RendererData_t {
+	Renderer *m_pRenderer;				// Renderer to draw with
+	RendererSoftware32 *m_pRenderer32;	// True color renderer for blending
+	const Word8 *m_pSprite;				// 8 bit sprite shape
+	const Image *m_pImage;				// True color image for blending
+	Word m_uMode;						// Blend mode for DrawImage()
+	Placement_t m_Placements[cBenchSprites];	// Where each sprite in a frame is drawn
+};
+
+static const char *g_PixelsNames[4] = {
+	"RendererSoftware8 Draw8BitPixels","RendererSoftware16 Draw8BitPixels",
+	"RendererSoftware32 Draw8BitPixels","RendererSoftware32 deferred Draw8BitPixels"
+};
+
+static const char *g_MaskedNames[4] = {
+	"RendererSoftware8 Draw8BitPixelsMasked","RendererSoftware16 Draw8BitPixelsMasked",
+	"RendererSoftware32 Draw8BitPixelsMasked","RendererSoftware32 deferred Draw8BitPixelsMasked"
+};
+
+static const char *g_RectNames[4] = {
+	"RendererSoftware8 DrawRect","RendererSoftware16 DrawRect",
+	"RendererSoftware32 DrawRect","RendererSoftware32 deferred DrawRect"
+};
+
+static const char *g_BlendNames[4] = {
+	"RendererSoftware32 DrawImage opaque","RendererSoftware32 DrawImage alpha",
+	"RendererSoftware32 DrawImage additive","RendererSoftware32 DrawImage premultiplied"
+};
+
+static void BURGER_API BenchDraw8BitPixels(void *pData,WordPtr uIterations)
+{
+	const RendererData_t *pRenderer = static_cast<const RendererData_t *>(pData);
+	Renderer *pTarget = pRenderer->m_pRenderer;
+	do {
+		pTarget->BeginScene();
+		const Placement_t *pPlacement = pRenderer->m_Placements;
+		Word i = cBenchSprites;
+		do {
+			pTarget->Draw8BitPixels(pPlacement->m_iX,pPlacement->m_iY,pPlacement->m_uWidth,pPlacement->m_uHeight,128,pRenderer->m_pSprite);
+			++pPlacement;
+		} while (--i);
+		pTarget->EndScene();
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDraw8BitPixelsMasked(void *pData,WordPtr uIterations)
+{
+	const RendererData_t *pRenderer = static_cast<const RendererData_t *>(pData);
+	Renderer *pTarget = pRenderer->m_pRenderer;
+	do {
+		pTarget->BeginScene();
+		const Placement_t *pPlacement = pRenderer->m_Placements;
+		Word i = cBenchSprites;
+		do {
+			pTarget->Draw8BitPixelsMasked(pPlacement->m_iX,pPlacement->m_iY,pPlacement->m_uWidth,pPlacement->m_uHeight,128,pRenderer->m_pSprite);
+			++pPlacement;
+		} while (--i);
+		pTarget->EndScene();
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDrawRect(void *pData,WordPtr uIterations)
+{
+	const RendererData_t *pRenderer = static_cast<const RendererData_t *>(pData);
+	Renderer *pTarget = pRenderer->m_pRenderer;
+	do {
+		pTarget->BeginScene();
+		const Placement_t *pPlacement = pRenderer->m_Placements;
+		Word i = cBenchSprites;
+		do {
+			pTarget->DrawRect(pPlacement->m_iX,pPlacement->m_iY,pPlacement->m_uWidth,pPlacement->m_uHeight,i);
+			++pPlacement;
+		} while (--i);
+		pTarget->EndScene();
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchDrawImage(void *pData,WordPtr uIterations)
+{
+	const RendererData_t *pRenderer = static_cast<const RendererData_t *>(pData);
+	RendererSoftware32 *pTarget = pRenderer->m_pRenderer32;
+	const Image *pImage = pRenderer->m_pImage;
+	RendererSoftware32::eBlendMode eMode = static_cast<RendererSoftware32::eBlendMode>(pRenderer->m_uMode);
+	do {
+		const Placement_t *pPlacement = pRenderer->m_Placements;
+		Word i = cBenchSprites;
+		do {
+			// Use a sub rectangle of the source image
+			Image Sprite;
+			Sprite.Init(pPlacement->m_uWidth,pPlacement->m_uHeight,Image::PIXELTYPE8888,pImage->GetStride(),pImage->GetImage(),Image::FLAGS_IMAGENOTALLOCATED);
+			pTarget->DrawImage(pPlacement->m_iX,pPlacement->m_iY,&Sprite,eMode);
+			++pPlacement;
+		} while (--i);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Create the sprite positions for a frame, some
+	sprites will be partially off screen, and
+	return the number of pixels drawn
+
+***************************************/
+
+static WordPtr CreatePlacements(Placement_t *pOutput)
+{
+	Word8 Random[cBenchSprites*3];
+	FillRandom(Random,sizeof(Random),0x5A5A5A5AU);
+	const Word8 *pRandom = Random;
+	WordPtr uPixels = 0;
+	Word i = cBenchSprites;
+	do {
+		const SpriteSize_t *pSize = &g_SpriteSizes[pRandom[0]&7U];
+		Word uWidth = pSize->m_uWidth;
+		Word uHeight = pSize->m_uHeight;
+		pOutput->m_iX = static_cast<int>((pRandom[1]*(cBenchWidth+uWidth))>>8U)-static_cast<int>(uWidth/2);
+		pOutput->m_iY = static_cast<int>((pRandom[2]*(cBenchHeight+uHeight))>>8U)-static_cast<int>(uHeight/2);
+		pOutput->m_uWidth = uWidth;
+		pOutput->m_uHeight = uHeight;
+		uPixels += uWidth*uHeight;
+		pRandom += 3;
+		++pOutput;
+	} while (--i);
+	return uPixels;
+}
+
+/***************************************
+
+	Create a sprite with a third of the
+	pixels transparent
+
+***************************************/
+
+static void CreateSprite(Word8 *pOutput,WordPtr uSize)
+{
+	FillRandom(pOutput,uSize,0xDEADBEEFU);
+	do {
+		if (pOutput[0]<85U) {
+			pOutput[0] = 0;
+		}
+		++pOutput;
+	} while (--uSize);
+}
+
+/***************************************
+
+	Draw every sprite type with each renderer
+
+***************************************/
+
+static void BenchRenderer(Benchmark *pBench,RendererData_t *pData,Renderer *pRenderer,Word uIndex,WordPtr uPixels)
+{
+	pData->m_pRenderer = pRenderer;
+	pBench->Run(g_PixelsNames[uIndex],BenchDraw8BitPixels,pData,uPixels,Benchmark::UNITS_ITEMS);
+	pBench->Run(g_MaskedNames[uIndex],BenchDraw8BitPixelsMasked,pData,uPixels,Benchmark::UNITS_ITEMS);
+	pBench->Run(g_RectNames[uIndex],BenchDrawRect,pData,uPixels,Benchmark::UNITS_ITEMS);
+}
+
+/***************************************
+
+	Benchmark the software renderers, the
+	throughput is in pixels per second
+
+***************************************/
+
+void BURGER_API BenchBrrenderer(Benchmark *pBench)
+{
+	Word32 *pBuffer = static_cast<Word32 *>(AllocClear(cBenchWidth*cBenchHeight*4));
+	Word8 *pSprite = static_cast<Word8 *>(Alloc(128*128));
+	RendererData_t *pData = static_cast<RendererData_t *>(Alloc(sizeof(RendererData_t)));
+	if (pBuffer && pSprite && pData) {
+		CreateSprite(pSprite,128*128);
+		WordPtr uPixels = CreatePlacements(pData->m_Placements);
+		pData->m_pSprite = pSprite;
+
+		RendererSoftware8 Renderer8;
+		Renderer8.Init(cBenchWidth,cBenchHeight,8,0);
+		Renderer8.SetFrameBuffer(pBuffer);
+		Renderer8.SetStride(cBenchWidth);
+		BenchRenderer(pBench,pData,&Renderer8,0,uPixels);
+
+		RendererSoftware16 Renderer16;
+		Renderer16.Init(cBenchWidth,cBenchHeight,16,0);
+		Renderer16.SetFrameBuffer(pBuffer);
+		Renderer16.SetStride(cBenchWidth*2);
+		BenchRenderer(pBench,pData,&Renderer16,1,uPixels);
+
+		RendererSoftware32 Renderer32;
+		Renderer32.Init(cBenchWidth,cBenchHeight,32,0);
+		Renderer32.SetFrameBuffer(pBuffer);
+		Renderer32.SetStride(cBenchWidth*4);
+		BenchRenderer(pBench,pData,&Renderer32,2,uPixels);
+		Renderer32.SetDeferred(TRUE);
+		BenchRenderer(pBench,pData,&Renderer32,3,uPixels);
+		Renderer32.SetDeferred(FALSE);
+
+		Image TrueColor;
+		if (!TrueColor.Init(128,128,Image::PIXELTYPE8888)) {
+			FillRandom(TrueColor.GetImage(),128*128*4,0x12345678U);
+			pData->m_pRenderer32 = &Renderer32;
+			pData->m_pImage = &TrueColor;
+			Word uMode = RendererSoftware32::BLEND_OPAQUE;
+			do {
+				pData->m_uMode = uMode;
+				pBench->Run(g_BlendNames[uMode],BenchDrawImage,pData,uPixels,Benchmark::UNITS_ITEMS);
+			} while (++uMode<=RendererSoftware32::BLEND_PREMULTIPLIED);
+		}
+	}
+	Free(pData);
+	Free(pSprite);
+	Free(pBuffer);
+}
@@ -0,0 +1,384 @@
+/***************************************
+
+	Benchmarks for the lock free queues
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrringqueue.h"
+#include "benchmark.h"
+#include "brringqueue.h"
+#include "brqueue.h"
+#include "bratomic.h"
+#include "brcriticalsection.h"
+#include "brtick.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded benchmarks
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USETHREADS
+#endif
+
+//
+// Number of entries in the ring buffers
+//
+
+static const WordPtr cQueueSize = 1024;
+
+//
+// Push and pop on the same thread, the cost without contention
+//
+
+template<class Q>
+static void BURGER_API BenchPushPop(void *pData,WordPtr uIterations)
+{
+	Q *pQueue = static_cast<Q *>(pData);
+	Word32 uValue = 0;
+	do {
+		pQueue->push(uValue);
+		pQueue->pop(&uValue);
+	} while (--uIterations);
+	DoNotOptimize(uValue);
+}
+
+template<class Q>
+static void BURGER_API BenchPushPopBatch(void *pData,WordPtr uIterations)
+{
+	Q *pQueue = static_cast<Q *>(pData);
+	Word32 Batch[32];
+	Word32 i = 0;
+	do {
+		Batch[i] = i;
+	} while (++i<32);
+	do {
+		pQueue->push(Batch,32);
+		pQueue->pop(Batch,32);
+	} while (--uIterations);
+	DoNotOptimize(Batch);
+}
+
+#if defined(USETHREADS)
+
+struct QueueData_t {
+	void *m_pQueue;				// Queue under test
+	CriticalSection *m_pLock;	// Lock for the Queue<T> comparison
+	Thread::FunctionPtr m_pProducer;	// Function for the producer threads
+	Thread::FunctionPtr m_pConsumer;	// Function for the consumer threads
+	volatile Word32 m_uStart;	// Set when all threads are to begin
+	volatile Word32 m_uConsumed;	// Number of entries consumed by all threads
+	Word32 m_uTotal;			// Number of entries to pass through the queue
+	Word32 m_uThreads;			// Number of producers, and of consumers
+	Word32 m_uBatch;			// Number of entries to push or pop at a time
+};
+
+struct Producer_t {
+	QueueData_t *m_pData;		// Shared state
+	Word32 m_uCount;			// Entries for this thread to produce
+};
+
+static BURGER_INLINE void Backoff(Word *pSpins)
+{
+	if (++pSpins[0]>=64) {
+		pSpins[0] = 0;
+		Sleep(SLEEP_YIELD);
+	}
+}
+
+static void WaitForStart(const QueueData_t *pData)
+{
+	Word uSpins = 0;
+	while (!AtomicGet(&pData->m_uStart)) {
+		Backoff(&uSpins);
+	}
+}
+
+//
+// Queue<T> guarded by a CriticalSection for comparison
+//
+
+static WordPtr BURGER_API LockedProducer(void *pThis)
+{
+	Producer_t *pProducer = static_cast<Producer_t *>(pThis);
+	QueueData_t *pData = pProducer->m_pData;
+	Queue<Word32> *pQueue = static_cast<Queue<Word32> *>(pData->m_pQueue);
+	WaitForStart(pData);
+	Word32 i = 0;
+	while (i<pProducer->m_uCount) {
+		pData->m_pLock->Lock();
+		pQueue->push(i);
+		pData->m_pLock->Unlock();
+		++i;
+	}
+	return 0;
+}
+
+static WordPtr BURGER_API LockedConsumer(void *pThis)
+{
+	QueueData_t *pData = static_cast<Producer_t *>(pThis)->m_pData;
+	Queue<Word32> *pQueue = static_cast<Queue<Word32> *>(pData->m_pQueue);
+	WaitForStart(pData);
+	Word uSpins = 0;
+	while (AtomicGet(&pData->m_uConsumed)<pData->m_uTotal) {
+		pData->m_pLock->Lock();
+		Word bFound = !pQueue->empty();
+		if (bFound) {
+			pQueue->pop();
+		}
+		pData->m_pLock->Unlock();
+		if (bFound) {
+			AtomicPreIncrement(&pData->m_uConsumed);
+		} else {
+			Backoff(&uSpins);
+		}
+	}
+	return 0;
+}
+
+template<class Q>
+static WordPtr BURGER_API BenchProducer(void *pThis)
+{
+	Producer_t *pProducer = static_cast<Producer_t *>(pThis);
+	QueueData_t *pData = pProducer->m_pData;
+	Q *pQueue = static_cast<Q *>(pData->m_pQueue);
+	Word32 Batch[32];
+	Word32 i = 0;
+	do {
+		Batch[i] = i;
+	} while (++i<32);
+	WaitForStart(pData);
+	Word32 uRemaining = pProducer->m_uCount;
+	Word32 uBatch = pData->m_uBatch;
+	Word uSpins = 0;
+	while (uRemaining) {
+		WordPtr uCount;
+		if (uBatch==1) {
+			uCount = pQueue->push(Batch[0]);
+		} else {
+			uCount = pQueue->push(Batch,(uRemaining<uBatch) ? uRemaining : uBatch);
+		}
+		if (!uCount) {
+			Backoff(&uSpins);
+		}
+		uRemaining -= static_cast<Word32>(uCount);
+	}
+	return 0;
+}
+
+template<class Q>
+static WordPtr BURGER_API BenchConsumer(void *pThis)
+{
+	QueueData_t *pData = static_cast<Producer_t *>(pThis)->m_pData;
+	Q *pQueue = static_cast<Q *>(pData->m_pQueue);
+	Word32 Batch[32];
+	Word32 uBatch = pData->m_uBatch;
+	WaitForStart(pData);
+	Word uSpins = 0;
+	while (AtomicGet(&pData->m_uConsumed)<pData->m_uTotal) {
+		WordPtr uCount;
+		if (uBatch==1) {
+			uCount = pQueue->pop(Batch);
+		} else {
+			uCount = pQueue->pop(Batch,uBatch);
+		}
+		if (!uCount) {
+			Backoff(&uSpins);
+		} else {
+			AtomicAdd(&pData->m_uConsumed,static_cast<Word32>(uCount));
+		}
+	}
+	return 0;
+}
+
+/***************************************
+
+	Pass uIterations entries through the queue with
+	the producer and consumer threads
+
+***************************************/
+
+static void BURGER_API BenchThroughput(void *pThis,WordPtr uIterations)
+{
+	QueueData_t *pData = static_cast<QueueData_t *>(pThis);
+	Word32 uThreads = pData->m_uThreads;
+	pData->m_uStart = 0;
+	pData->m_uConsumed = 0;
+	pData->m_uTotal = static_cast<Word32>(uIterations);
+	Producer_t Producers[16];
+	Thread Threads[16];
+	Word32 i = 0;
+	do {
+		Producers[i].m_pData = pData;
+		// The first producer gets the remainder
+		Word32 uCount = 0;
+		if (i<uThreads) {
+			uCount = static_cast<Word32>(uIterations/uThreads);
+			if (!i) {
+				uCount += static_cast<Word32>(uIterations%uThreads);
+			}
+		}
+		Producers[i].m_uCount = uCount;
+		Threads[i].Start((i<uThreads) ? pData->m_pProducer : pData->m_pConsumer,&Producers[i]);
+	} while (++i<(uThreads*2));
+	AtomicSet(&pData->m_uStart,1);
+	i = 0;
+	do {
+		Threads[i].Wait();
+	} while (++i<(uThreads*2));
+}
+
+//
+// Bounce a value between two threads to measure the hand off latency
+//
+
+struct PingPong_t {
+	SPSCQueue<Word32> m_Ping;	// Queue to the echo thread
+	SPSCQueue<Word32> m_Pong;	// Queue back to the timing thread
+	WordPtr m_uCount;			// Number of round trips
+};
+
+static WordPtr BURGER_API EchoThread(void *pThis)
+{
+	PingPong_t *pPingPong = static_cast<PingPong_t *>(pThis);
+	WordPtr uCount = pPingPong->m_uCount;
+	do {
+		Word32 uValue;
+		while (!pPingPong->m_Ping.pop(&uValue)) {
+		}
+		while (!pPingPong->m_Pong.push(uValue+1)) {
+		}
+	} while (--uCount);
+	return 0;
+}
+
+static void BURGER_API BenchRoundTrip(void *pThis,WordPtr uIterations)
+{
+	PingPong_t *pPingPong = static_cast<PingPong_t *>(pThis);
+	pPingPong->m_uCount = uIterations;
+	Thread Echo(EchoThread,pPingPong);
+	Word32 i = 0;
+	do {
+		pPingPong->m_Ping.push(i);
+		Word32 uValue;
+		while (!pPingPong->m_Pong.pop(&uValue)) {
+		}
+		++i;
+	} while (--uIterations);
+	Echo.Wait();
+}
+
+//
+// Thread counts for MPMCQueue, each must have a name below
+//
+
+static const Word32 g_ThreadCounts[4] = {1,2,4,8};
+
+static const char *g_MPMCNames[4] = {
+	"MPMCQueue 1:1 threads","MPMCQueue 2:2 threads","MPMCQueue 4:4 threads","MPMCQueue 8:8 threads"
+};
+
+static const char *g_MPMCBatchNames[4] = {
+	"MPMCQueue 1:1 threads batch 32","MPMCQueue 2:2 threads batch 32",
+	"MPMCQueue 4:4 threads batch 32","MPMCQueue 8:8 threads batch 32"
+};
+
+#endif
+
+/***************************************
+
+	Compare the throughput of the queues with different
+	thread counts and the round trip time of SPSCQueue.
+	The throughput is in entries per second
+
+***************************************/
+
+void BURGER_API BenchBrringqueue(Benchmark *pBench)
+{
+	{
+		SPSCQueue<Word32> SPSC;
+		if (!SPSC.Init(cQueueSize)) {
+			pBench->Run("SPSCQueue push and pop",BenchPushPop<SPSCQueue<Word32> >,&SPSC,1,Benchmark::UNITS_ITEMS);
+			pBench->Run("SPSCQueue push and pop batch 32",BenchPushPopBatch<SPSCQueue<Word32> >,&SPSC,32,Benchmark::UNITS_ITEMS);
+		}
+		MPMCQueue<Word32> MPMC;
+		if (!MPMC.Init(cQueueSize)) {
+			pBench->Run("MPMCQueue push and pop",BenchPushPop<MPMCQueue<Word32> >,&MPMC,1,Benchmark::UNITS_ITEMS);
+			pBench->Run("MPMCQueue push and pop batch 32",BenchPushPopBatch<MPMCQueue<Word32> >,&MPMC,32,Benchmark::UNITS_ITEMS);
+		}
+	}
+
+#if defined(USETHREADS)
+	Word32 uMaxThreads = Thread::GetProcessorCount()/2;
+	if (uMaxThreads<1) {
+		uMaxThreads = 1;
+	}
+	QueueData_t Data;
+
+	// Baseline, the linked list queue with a lock
+	{
+		Queue<Word32> Locked;
+		CriticalSection Lock;
+		Data.m_pQueue = &Locked;
+		Data.m_pLock = &Lock;
+		Data.m_pProducer = LockedProducer;
+		Data.m_pConsumer = LockedConsumer;
+		Data.m_uThreads = 1;
+		Data.m_uBatch = 1;
+		pBench->Run("Queue+CriticalSection 1:1 threads",BenchThroughput,&Data,1,Benchmark::UNITS_ITEMS);
+	}
+
+	{
+		SPSCQueue<Word32> SPSC;
+		if (!SPSC.Init(cQueueSize)) {
+			Data.m_pQueue = &SPSC;
+			Data.m_pLock = NULL;
+			Data.m_pProducer = BenchProducer<SPSCQueue<Word32> >;
+			Data.m_pConsumer = BenchConsumer<SPSCQueue<Word32> >;
+			Data.m_uThreads = 1;
+			Data.m_uBatch = 1;
+			pBench->Run("SPSCQueue 1:1 threads",BenchThroughput,&Data,1,Benchmark::UNITS_ITEMS);
+			Data.m_uBatch = 32;
+			pBench->Run("SPSCQueue 1:1 threads batch 32",BenchThroughput,&Data,1,Benchmark::UNITS_ITEMS);
+		}
+	}
+
+	{
+		MPMCQueue<Word32> MPMC;
+		if (!MPMC.Init(cQueueSize)) {
+			Data.m_pQueue = &MPMC;
+			Data.m_pLock = NULL;
+			Data.m_pProducer = BenchProducer<MPMCQueue<Word32> >;
+			Data.m_pConsumer = BenchConsumer<MPMCQueue<Word32> >;
+			Word i = 0;
+			do {
+				Word32 uThreads = g_ThreadCounts[i];
+				if (uThreads>uMaxThreads) {
+					break;
+				}
+				Data.m_uThreads = uThreads;
+				Data.m_uBatch = 1;
+				pBench->Run(g_MPMCNames[i],BenchThroughput,&Data,1,Benchmark::UNITS_ITEMS);
+				Data.m_uBatch = 32;
+				pBench->Run(g_MPMCBatchNames[i],BenchThroughput,&Data,1,Benchmark::UNITS_ITEMS);
+			} while (++i<BURGER_ARRAYSIZE(g_ThreadCounts));
+		}
+	}
+
+	// Latency, only meaningful if there are two CPUs to spin on
+	if (Thread::GetProcessorCount()>=2) {
+		PingPong_t PingPong;
+		if (!PingPong.m_Ping.Init(16) && !PingPong.m_Pong.Init(16)) {
+			pBench->Run("SPSCQueue round trip",BenchRoundTrip,&PingPong);
+		}
+	}
+#endif
+}
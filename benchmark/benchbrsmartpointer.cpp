@@ -0,0 +1,186 @@
+/***************************************
+
+	Benchmarks for the smart pointer classes
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrsmartpointer.h"
+#include "benchmark.h"
+#include "brsmartpointer.h"
+#include "brcriticalsection.h"
+#include "bratomic.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded benchmarks
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USETHREADS
+#endif
+
+class SingleObject : public ReferenceCounter {
+	BURGER_ALLOW_WEAK_POINTERS();
+public:
+	Word m_uValue;
+	SingleObject() : m_uValue(0) {}
+};
+
+class SharedObject : public AtomicReferenceCounter {
+	BURGER_ALLOW_WEAK_POINTERS();
+public:
+	Word m_uValue;
+	SharedObject() : m_uValue(0) {}
+};
+
+struct PointerData_t {
+	SmartPointer<SingleObject> m_pSingle;	// Object with a non-atomic count
+	SmartPointer<SharedObject> m_pShared;	// Object with an atomic count
+	CriticalSection m_Lock;					// Lock guarding the non-atomic count
+	Thread::FunctionPtr m_pProc;			// Function each thread runs
+	volatile Word32 m_uStart;				// Set when all threads are to begin
+	WordPtr m_uIterations;					// Number of copies each thread makes
+	Word m_uThreads;						// Number of threads to run
+};
+
+static void BURGER_API BenchSingleCopy(void *pData,WordPtr uIterations)
+{
+	PointerData_t *pPointers = static_cast<PointerData_t *>(pData);
+	do {
+		SmartPointer<SingleObject> pCopy(pPointers->m_pSingle);
+		DoNotOptimize(pCopy);
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchSharedCopy(void *pData,WordPtr uIterations)
+{
+	PointerData_t *pPointers = static_cast<PointerData_t *>(pData);
+	do {
+		SmartPointer<SharedObject> pCopy(pPointers->m_pShared);
+		DoNotOptimize(pCopy);
+	} while (--uIterations);
+}
+
+#if defined(USETHREADS)
+
+//
+// Thread counts to test, each must have a name below
+//
+
+static const Word g_ThreadCounts[4] = {2,4,8,16};
+
+static const char *g_LockedNames[4] = {
+	"ReferenceCounter+CriticalSection 2 threads","ReferenceCounter+CriticalSection 4 threads",
+	"ReferenceCounter+CriticalSection 8 threads","ReferenceCounter+CriticalSection 16 threads"
+};
+
+static const char *g_AtomicNames[4] = {
+	"AtomicReferenceCounter 2 threads","AtomicReferenceCounter 4 threads",
+	"AtomicReferenceCounter 8 threads","AtomicReferenceCounter 16 threads"
+};
+
+//
+// Non-atomic count, serialized with a lock so it can be shared
+//
+
+static WordPtr BURGER_API LockedCopies(void *pData)
+{
+	PointerData_t *pPointers = static_cast<PointerData_t *>(pData);
+	while (!AtomicGet(&pPointers->m_uStart)) {
+	}
+	WordPtr uCount = pPointers->m_uIterations;
+	do {
+		pPointers->m_Lock.Lock();
+		{
+			SmartPointer<SingleObject> pCopy(pPointers->m_pSingle);
+		}
+		pPointers->m_Lock.Unlock();
+	} while (--uCount);
+	return 0;
+}
+
+static WordPtr BURGER_API AtomicCopies(void *pData)
+{
+	PointerData_t *pPointers = static_cast<PointerData_t *>(pData);
+	while (!AtomicGet(&pPointers->m_uStart)) {
+	}
+	WordPtr uCount = pPointers->m_uIterations;
+	do {
+		SmartPointer<SharedObject> pCopy(pPointers->m_pShared);
+	} while (--uCount);
+	return 0;
+}
+
+/***************************************
+
+	Run the threads, each makes uIterations copies
+	of the shared pointer
+
+***************************************/
+
+static void BURGER_API BenchThreads(void *pData,WordPtr uIterations)
+{
+	PointerData_t *pPointers = static_cast<PointerData_t *>(pData);
+	pPointers->m_uIterations = uIterations;
+	pPointers->m_uStart = 0;
+	Word uThreads = pPointers->m_uThreads;
+	Thread Threads[16];
+	Word i = 0;
+	do {
+		Threads[i].Start(pPointers->m_pProc,pPointers);
+	} while (++i<uThreads);
+	AtomicSet(&pPointers->m_uStart,1);
+	i = 0;
+	do {
+		Threads[i].Wait();
+	} while (++i<uThreads);
+}
+#endif
+
+/***************************************
+
+	Compare the cost of copying a SmartPointer with
+	each reference count policy, with and without
+	contention. The throughput is in copies per second
+	for all threads
+
+***************************************/
+
+void BURGER_API BenchBrsmartpointer(Benchmark *pBench)
+{
+	PointerData_t Data;
+	Data.m_pSingle = New<SingleObject>();
+	Data.m_pShared = New<SharedObject>();
+
+	// Uncontended cost of each policy
+	pBench->Run("ReferenceCounter copy",BenchSingleCopy,&Data,1,Benchmark::UNITS_ITEMS);
+	pBench->Run("AtomicReferenceCounter copy",BenchSharedCopy,&Data,1,Benchmark::UNITS_ITEMS);
+
+#if defined(USETHREADS)
+	// Sharing an object between threads, the non-atomic count needs a lock
+	Word uMaxThreads = Thread::GetProcessorCount();
+	if (uMaxThreads<2) {
+		uMaxThreads = 2;
+	}
+	Word i = 0;
+	do {
+		Word uThreads = g_ThreadCounts[i];
+		if (uThreads>uMaxThreads) {
+			break;
+		}
+		Data.m_uThreads = uThreads;
+		Data.m_pProc = LockedCopies;
+		pBench->Run(g_LockedNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+		Data.m_pProc = AtomicCopies;
+		pBench->Run(g_AtomicNames[i],BenchThreads,&Data,uThreads,Benchmark::UNITS_ITEMS);
+	} while (++i<BURGER_ARRAYSIZE(g_ThreadCounts));
+#endif
+}
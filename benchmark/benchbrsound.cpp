@@ -0,0 +1,80 @@
+/***************************************
+
+	Benchmarks for the software sound mixer
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrsound.h"
+#include "benchmark.h"
+#include "brsoundmixer.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Number of sample frames in the looping sound
+//
+
+static const Word cSampleFrames = 22050;
+
+struct SoundData_t {
+	SoundMixer *m_pMixer;	// Mixer with every voice playing
+	float *m_pOutput;		// Buffer for a block of mixed stereo frames
+};
+
+static void BURGER_API BenchMix(void *pData,WordPtr uIterations)
+{
+	const SoundData_t *pSound = static_cast<const SoundData_t *>(pData);
+	do {
+		pSound->m_pMixer->Mix(pSound->m_pOutput,SoundMixer::BLOCKSIZE);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Mix every voice at a sample rate that needs
+	resampling, the throughput is in output
+	frames per second
+
+***************************************/
+
+void BURGER_API BenchBrsound(Benchmark *pBench)
+{
+	Word8 *pSamples = static_cast<Word8 *>(Alloc(cSampleFrames*2));
+	float *pOutput = static_cast<float *>(Alloc(sizeof(float)*SoundMixer::BLOCKSIZE*2));
+	if (pSamples && pOutput) {
+		FillRandom(pSamples,cSampleFrames*2,0x5A5A5A5AU);
+		SoundMixer Mixer;
+		Mixer.Init(NULL,44100,2);
+		SoundMixer::VoiceInit_t Init;
+		Init.m_pSamples = pSamples;
+		Init.m_uLength = cSampleFrames*2;
+		Init.m_uLoopStart = 0;
+		Init.m_uLoopEnd = cSampleFrames;
+		Init.m_pCompletion = NULL;
+		Init.m_pCompletionData = NULL;
+		Init.m_eDataType = Sound::TYPELSHORT;
+		Init.m_uVolume = 128;
+		Word i = 0;
+		do {
+			Init.m_uSampleRate = 11025+(i*997);
+			Init.m_uPan = i*2047;
+			Mixer.Play(&Init);
+		} while (++i<SoundMixer::MAXVOICES);
+
+		SoundData_t Data;
+		Data.m_pMixer = &Mixer;
+		Data.m_pOutput = pOutput;
+		pBench->Run("SoundMixer::Mix all voices",BenchMix,&Data,SoundMixer::BLOCKSIZE,Benchmark::UNITS_ITEMS);
+	}
+	Free(pOutput);
+	Free(pSamples);
+}
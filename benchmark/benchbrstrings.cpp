@@ -0,0 +1,163 @@
+/***************************************
+
+	Benchmarks for the string functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchbrstrings.h"
+#include "benchmark.h"
+#include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+
+using namespace Burger;
+
+//
+// Size of the strings to scan
+//
+
+static const WordPtr cTextLength = 1024;
+
+struct StringData_t {
+	char m_Text[cTextLength+1];			// Lower case text
+	char m_Copy[cTextLength+1];			// Identical copy of m_Text
+	char m_Upper[cTextLength+1];		// Upper case copy of m_Text
+	char m_Output[cTextLength+1];		// Destination buffer
+};
+
+//
+// Numbers to convert
+//
+
+static const char *g_Integers[8] = {
+	"0","7","42","1234","65535","1000000","123456789","4294967295"
+};
+
+static const char *g_Floats[8] = {
+	"0.0","1.5","-3.25","42.125","3.14159","-1000.5","65536.75","0.0001"
+};
+
+static void BURGER_API BenchStringLength(void *pData,WordPtr uIterations)
+{
+	const char *pText = static_cast<const StringData_t *>(pData)->m_Text;
+	do {
+		DoNotOptimize(StringLength(pText));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchStringCopy(void *pData,WordPtr uIterations)
+{
+	StringData_t *pStrings = static_cast<StringData_t *>(pData);
+	do {
+		StringCopy(pStrings->m_Output,sizeof(pStrings->m_Output),pStrings->m_Text);
+		ClobberMemory();
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchStringCompare(void *pData,WordPtr uIterations)
+{
+	const StringData_t *pStrings = static_cast<const StringData_t *>(pData);
+	do {
+		DoNotOptimize(StringCompare(pStrings->m_Text,pStrings->m_Copy));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchStringCaseCompare(void *pData,WordPtr uIterations)
+{
+	const StringData_t *pStrings = static_cast<const StringData_t *>(pData);
+	do {
+		DoNotOptimize(StringCaseCompare(pStrings->m_Text,pStrings->m_Upper));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchStringString(void *pData,WordPtr uIterations)
+{
+	const StringData_t *pStrings = static_cast<const StringData_t *>(pData);
+	// The last word of the text is the only match
+	const char *pTest = pStrings->m_Text+(cTextLength-8);
+	do {
+		DoNotOptimize(StringString(pStrings->m_Text,pTest));
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchNumberToAscii(void *pData,WordPtr uIterations)
+{
+	char *pOutput = static_cast<StringData_t *>(pData)->m_Output;
+	Word32 uValue = 0x12345678U;
+	do {
+		DoNotOptimize(NumberToAscii(pOutput,uValue));
+		uValue = (uValue*1664525U)+1013904223U;
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchNumberToAsciiDouble(void *pData,WordPtr uIterations)
+{
+	char *pOutput = static_cast<StringData_t *>(pData)->m_Output;
+	double dValue = 3.14159;
+	do {
+		DoNotOptimize(NumberToAscii(pOutput,dValue));
+		dValue = dValue*1.5;
+		if (dValue>1000000.0) {
+			dValue = 3.14159;
+		}
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchAsciiToInteger(void * /* pData */,WordPtr uIterations)
+{
+	WordPtr uIndex = 0;
+	do {
+		DoNotOptimize(AsciiToInteger(g_Integers[uIndex]));
+		uIndex = (uIndex+1)&7U;
+	} while (--uIterations);
+}
+
+static void BURGER_API BenchAsciiToFloat(void * /* pData */,WordPtr uIterations)
+{
+	WordPtr uIndex = 0;
+	do {
+		DoNotOptimize(AsciiToFloat(g_Floats[uIndex]));
+		uIndex = (uIndex+1)&7U;
+	} while (--uIterations);
+}
+
+/***************************************
+
+	Benchmark the string functions
+
+***************************************/
+
+void BURGER_API BenchBrstrings(Benchmark *pBench)
+{
+	StringData_t *pStrings = static_cast<StringData_t *>(Alloc(sizeof(StringData_t)));
+	if (pStrings) {
+		// Fill with words of lower case letters
+		FillRandom(pStrings->m_Text,cTextLength,0x5A5A5A5AU);
+		WordPtr i = 0;
+		do {
+			Word uTemp = reinterpret_cast<Word8 *>(pStrings->m_Text)[i];
+			pStrings->m_Text[i] = ((uTemp&7U)==7U) ? ' ' : static_cast<char>('a'+(uTemp%26U));
+		} while (++i<cTextLength);
+		pStrings->m_Text[cTextLength] = 0;
+		StringCopy(pStrings->m_Copy,pStrings->m_Text);
+		StringCopy(pStrings->m_Upper,pStrings->m_Text);
+		StringUppercase(pStrings->m_Upper);
+
+		pBench->Run("StringLength 1K",BenchStringLength,pStrings,cTextLength,Benchmark::UNITS_BYTES);
+		pBench->Run("StringCopy 1K",BenchStringCopy,pStrings,cTextLength,Benchmark::UNITS_BYTES);
+		pBench->Run("StringCompare 1K",BenchStringCompare,pStrings,cTextLength,Benchmark::UNITS_BYTES);
+		pBench->Run("StringCaseCompare 1K",BenchStringCaseCompare,pStrings,cTextLength,Benchmark::UNITS_BYTES);
+		pBench->Run("StringString 1K",BenchStringString,pStrings,cTextLength,Benchmark::UNITS_BYTES);
+		pBench->Run("NumberToAscii(Word32)",BenchNumberToAscii,pStrings,1,Benchmark::UNITS_ITEMS);
+		pBench->Run("NumberToAscii(double)",BenchNumberToAsciiDouble,pStrings,1,Benchmark::UNITS_ITEMS);
+		pBench->Run("AsciiToInteger",BenchAsciiToInteger,NULL,1,Benchmark::UNITS_ITEMS);
+		pBench->Run("AsciiToFloat",BenchAsciiToFloat,NULL,1,Benchmark::UNITS_ITEMS);
+		Free(pStrings);
+	}
+}
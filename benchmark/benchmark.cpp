@@ -0,0 +1,689 @@
+/***************************************
+
+	Microbenchmark framework for burgerlib
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "benchmark.h"
+#include "benchbrstrings.h"
+#include "benchbrhashes.h"
+#include "benchbrcompression.h"
+#include "benchbrmemory.h"
+#include "benchbrmath.h"
+#include "benchbrimage.h"
+#include "benchbrrenderer.h"
+#include "benchbrsound.h"
+#include "benchbratomic.h"
+#include "benchbrringqueue.h"
+#include "benchbrsmartpointer.h"
+#include "benchbrprofiler.h"
+#include "brtick.h"
+#include "broutputmemorystream.h"
+#include "brfilemanager.h"
+#include "brstringfunctions.h"
+#include "brglobalmemorymanager.h"
+#include "brconsolemanager.h"
+#include "brcommandparameterstring.h"
+#include "brcommandparameterwordptr.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace Burger;
+
+//
+// Largest number of iterations in a single sample
+//
+
+static const WordPtr cMaxIterations = 0x40000000U;
+
+#if !defined(BURGER_GNUC) && !defined(BURGER_LLVM) && !defined(BURGER_SNSYSTEMS)
+
+//
+// Global the optimizer can't see through, used by DoNotOptimize()
+//
+
+const void * volatile g_pBenchmarkSink;
+
+#if !defined(BURGER_MSVC)
+void BURGER_API ClobberMemory(void)
+{
+}
+#endif
+#endif
+
+/*! ************************************
+
+	\class Benchmark
+	\brief Microbenchmark runner
+
+	Each benchmark is a function that performs the operation being
+	measured a requested number of times. The runner calls it with
+	an increasing iteration count until a single sample takes at least
+	the sample time, warms up the caches and branch predictors and
+	then records a number of samples. The median, fastest, 90th and 99th
+	percentile times per iteration are saved and optionally printed.
+
+	If the amount of work in each iteration is supplied, the throughput
+	in bytes or items per second is calculated from the median.
+
+	\code
+	static void BURGER_API BenchLength(void *pData,WordPtr uIterations)
+	{
+		do {
+			DoNotOptimize(StringLength(static_cast<const char *>(pData)));
+		} while (--uIterations);
+	}
+
+	Bench.Run("StringLength",BenchLength,g_Text,sizeof(g_Text)-1,Benchmark::UNITS_BYTES);
+	\endcode
+
+	\sa DoNotOptimize(const T &) or ClobberMemory(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn template<class T> void DoNotOptimize(const T &rValue)
+	\brief Prevent the optimizer from discarding a value
+
+	Results that are never used can be removed by the compiler, which
+	turns a benchmark into an empty loop. Pass the result to this function
+	and the compiler must assume it was read.
+
+	\param rValue Value that must be computed
+	\sa ClobberMemory(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void ClobberMemory(void)
+	\brief Force all pending memory writes to be performed
+
+	Act as a compiler barrier so writes to buffers that are never
+	read again are not removed by the optimizer.
+
+	\sa DoNotOptimize(const T &)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize the benchmark runner
+
+	Set the sample count, sample time and warmup time to their defaults.
+
+***************************************/
+
+Benchmark::Benchmark() :
+	m_Results(),
+	m_pSuite(""),
+	m_pFilter(NULL),
+	m_uSampleTime(static_cast<Word64>(DEFAULTSAMPLETIME)*1000000U),
+	m_uWarmupTime(static_cast<Word64>(DEFAULTWARMUPTIME)*1000000U),
+	m_uSamples(DEFAULTSAMPLES),
+	m_bQuiet(FALSE)
+{
+}
+
+/*! ************************************
+
+	\fn void Benchmark::SetSuite(const char *pSuite)
+	\brief Set the suite name for the following benchmarks
+
+	\param pSuite Pointer to a static "C" string with the suite name
+	\sa GetSuite(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn const char *Benchmark::GetSuite(void) const
+	\brief Return the current suite name
+
+	\return Pointer to the "C" string passed to SetSuite(const char *)
+	\sa SetSuite(const char *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Benchmark::SetFilter(const char *pFilter)
+	\brief Only run benchmarks that contain a string
+
+	\param pFilter Pointer to a "C" string to find in the benchmark names or \ref NULL to run them all
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Benchmark::SetSampleTime(Word uMilliseconds)
+	\brief Set the minimum time of each sample
+
+	The iteration count is increased until a single sample takes at
+	least this long. Longer samples reduce the timer error.
+
+	\param uMilliseconds Minimum time of a sample in milliseconds
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Benchmark::SetWarmupTime(Word uMilliseconds)
+	\brief Set the time spent running a benchmark before samples are taken
+
+	\param uMilliseconds Warmup time in milliseconds
+
+***************************************/
+
+/*! ************************************
+
+	\brief Set the number of samples taken for each benchmark
+
+	\param uSamples Number of samples, clamped to 1 through \ref MAXSAMPLES
+
+***************************************/
+
+void BURGER_API Benchmark::SetSamples(Word uSamples)
+{
+	if (!uSamples) {
+		uSamples = 1;
+	} else if (uSamples>MAXSAMPLES) {
+		uSamples = MAXSAMPLES;
+	}
+	m_uSamples = uSamples;
+}
+
+/*! ************************************
+
+	\fn void Benchmark::SetQuiet(Word bQuiet)
+	\brief Disable printing of results as they are generated
+
+	\param bQuiet \ref TRUE to run silently
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Benchmark::GetResultCount(void) const
+	\brief Return the number of benchmarks that were run
+
+	\return Number of valid entries for GetResult(WordPtr) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn const Result_t *Benchmark::GetResult(WordPtr uIndex) const
+	\brief Return the result of a benchmark
+
+	\param uIndex Index of the result, must be less than GetResultCount(void) const
+	\return Pointer to the result
+
+***************************************/
+
+/*! ************************************
+
+	\brief Time a number of iterations of a benchmark
+
+	\param pProc Benchmark function
+	\param pData Data passed to the function
+	\param uIterations Number of iterations to perform
+	\return Elapsed time in nanoseconds
+
+***************************************/
+
+Word64 BURGER_API Benchmark::TimeIterations(BenchmarkProc pProc,void *pData,WordPtr uIterations)
+{
+	Word64 uMark = Tick::ReadNanoseconds();
+	pProc(pData,uIterations);
+	return Tick::ReadNanoseconds()-uMark;
+}
+
+/***************************************
+
+	Called by qsort() to sort the samples
+
+***************************************/
+
+static int BURGER_ANSIAPI CompareSamples(const void *pFirst,const void *pSecond)
+{
+	double dFirst = static_cast<const double *>(pFirst)[0];
+	double dSecond = static_cast<const double *>(pSecond)[0];
+	if (dFirst<dSecond) {
+		return -1;
+	}
+	return dFirst>dSecond;
+}
+
+/***************************************
+
+	Return a percentile from a sorted list of samples
+	using the nearest rank method
+
+***************************************/
+
+static double Percentile(const double *pSamples,Word uCount,Word uPercent)
+{
+	Word uRank = (uCount*uPercent+99U)/100U;
+	if (uRank) {
+		--uRank;
+	}
+	return pSamples[uRank];
+}
+
+/*! ************************************
+
+	\brief Run a benchmark and record the result
+
+	The iteration count is scaled until a sample takes at least the
+	sample time, the benchmark is run until the warmup time has passed
+	and then the samples are taken and sorted.
+
+	If a filter was set with SetFilter(const char *) and the name
+	doesn't contain the filter text, the benchmark is skipped.
+
+	\note The suite and benchmark names are stored as pointers and
+	written to the JSON output without escaping, so they must be static
+	strings without quotes.
+
+	\param pName Pointer to a static "C" string with the name of the benchmark
+	\param pProc Function that performs the operation a requested number of times
+	\param pData Data pointer passed to pProc
+	\param uWork Number of bytes or items processed by each iteration
+	\param eUnitType Type of units uWork is measured in
+	\return Zero if no error, non-zero if the result couldn't be stored
+	\sa DoNotOptimize(const T &)
+
+***************************************/
+
+Word BURGER_API Benchmark::Run(const char *pName,BenchmarkProc pProc,void *pData,WordPtr uWork,eUnits eUnitType)
+{
+	if (m_pFilter && m_pFilter[0] && !StringString(pName,m_pFilter)) {
+		return 0;
+	}
+
+	// Scale up the iteration count until a sample is long enough
+	// to be measured accurately
+
+	Word64 uStart = Tick::ReadNanoseconds();
+	Word64 uSampleTime = m_uSampleTime;
+	WordPtr uIterations = 1;
+	for (;;) {
+		Word64 uElapsed = TimeIterations(pProc,pData,uIterations);
+		if ((uElapsed>=uSampleTime) || (uIterations>=cMaxIterations)) {
+			break;
+		}
+		WordPtr uNext;
+		if (uElapsed<(uSampleTime/10U)) {
+			uNext = uIterations*10U;
+		} else {
+			// Predict the count with a little slop so the next pass is long enough
+			uNext = static_cast<WordPtr>((static_cast<double>(uSampleTime)*1.2*static_cast<double>(uIterations))/static_cast<double>(uElapsed))+1U;
+		}
+		if (uNext>cMaxIterations) {
+			uNext = cMaxIterations;
+		}
+		uIterations = uNext;
+	}
+
+	// Warm up the caches
+
+	while ((Tick::ReadNanoseconds()-uStart)<m_uWarmupTime) {
+		TimeIterations(pProc,pData,uIterations);
+	}
+
+	// Take the samples
+
+	double Samples[MAXSAMPLES];
+	Word uCount = m_uSamples;
+	Word i = 0;
+	do {
+		Samples[i] = static_cast<double>(TimeIterations(pProc,pData,uIterations))/static_cast<double>(uIterations);
+	} while (++i<uCount);
+	qsort(Samples,uCount,sizeof(Samples[0]),CompareSamples);
+
+	Result_t Result;
+	Result.m_pSuite = m_pSuite;
+	Result.m_pName = pName;
+	Result.m_dMinimum = Samples[0];
+	if (uCount&1U) {
+		Result.m_dMedian = Samples[uCount>>1U];
+	} else {
+		Result.m_dMedian = (Samples[(uCount>>1U)-1]+Samples[uCount>>1U])*0.5;
+	}
+	Result.m_dP90 = Percentile(Samples,uCount,90);
+	Result.m_dP99 = Percentile(Samples,uCount,99);
+	Result.m_dThroughput = 0.0;
+	if ((eUnitType!=UNITS_NONE) && (Result.m_dMedian>0.0)) {
+		Result.m_dThroughput = (static_cast<double>(uWork)*1000000000.0)/Result.m_dMedian;
+	}
+	Result.m_uIterations = uIterations;
+	Result.m_uWork = uWork;
+	Result.m_eUnits = eUnitType;
+	m_Results.push_back(Result);
+	if (!m_bQuiet) {
+		PrintResult(&Result);
+	}
+	return m_Results.GetPtr()==NULL;
+}
+
+/*! ************************************
+
+	\brief Print a benchmark result to stdout
+
+	\param pResult Pointer to the result to print
+
+***************************************/
+
+void BURGER_API Benchmark::PrintResult(const Result_t *pResult)
+{
+	char Throughput[64];
+	Throughput[0] = 0;
+	if (pResult->m_eUnits==UNITS_BYTES) {
+		sprintf(Throughput,"%10.1f MB/s",pResult->m_dThroughput/(1024.0*1024.0));
+	} else if (pResult->m_eUnits==UNITS_ITEMS) {
+		sprintf(Throughput,"%10.2f M/s",pResult->m_dThroughput/1000000.0);
+	}
+	printf("%-12s %-36s %12.1f ns p90 %12.1f p99 %12.1f %s\n",pResult->m_pSuite,pResult->m_pName,
+		pResult->m_dMedian,pResult->m_dP90,pResult->m_dP99,Throughput);
+	fflush(stdout);
+}
+
+/*! ************************************
+
+	\brief Save the results as JSON
+
+	Each result is written on its own line as an object with the suite,
+	name, iteration count, times in nanoseconds per iteration and throughput.
+	The output can be passed to CompareJSON(const char *,Word) const
+	for a future run.
+
+	\param pOutput Stream to receive the JSON text
+	\return Zero on success, non-zero on a memory error
+	\sa SaveJSON(const char *) const
+
+***************************************/
+
+Word BURGER_API Benchmark::SaveJSON(OutputMemoryStream *pOutput) const
+{
+	static const char *s_UnitNames[3] = {"none","bytes","items"};
+	pOutput->Append("{\"benchmarks\":[");
+	WordPtr uCount = m_Results.size();
+	WordPtr i = 0;
+	while (i<uCount) {
+		const Result_t *pResult = &m_Results[i];
+		if (i) {
+			pOutput->Append(',');
+		}
+		pOutput->Append("\n{\"suite\":\"");
+		pOutput->Append(pResult->m_pSuite);
+		pOutput->Append("\",\"name\":\"");
+		pOutput->Append(pResult->m_pName);
+		pOutput->Append("\",\"iterations\":");
+		pOutput->AppendAscii(static_cast<Word64>(pResult->m_uIterations));
+		pOutput->Append(",\"minimum\":");
+		pOutput->AppendAscii(pResult->m_dMinimum);
+		pOutput->Append(",\"median\":");
+		pOutput->AppendAscii(pResult->m_dMedian);
+		pOutput->Append(",\"p90\":");
+		pOutput->AppendAscii(pResult->m_dP90);
+		pOutput->Append(",\"p99\":");
+		pOutput->AppendAscii(pResult->m_dP99);
+		pOutput->Append(",\"units\":\"");
+		pOutput->Append(s_UnitNames[pResult->m_eUnits]);
+		pOutput->Append("\",\"work\":");
+		pOutput->AppendAscii(static_cast<Word64>(pResult->m_uWork));
+		pOutput->Append(",\"throughput\":");
+		pOutput->AppendAscii(pResult->m_dThroughput);
+		pOutput->Append('}');
+		++i;
+	}
+	return pOutput->Append("\n]}\n");
+}
+
+/*! ************************************
+
+	\brief Save the results to a JSON file
+
+	\param pFilename Burgerlib formatted name of the file to create
+	\return Zero on success, non-zero on an error
+	\sa SaveJSON(OutputMemoryStream *) const
+
+***************************************/
+
+Word BURGER_API Benchmark::SaveJSON(const char *pFilename) const
+{
+	OutputMemoryStream Output;
+	Word uResult = SaveJSON(&Output);
+	if (!uResult) {
+		uResult = Output.SaveFile(pFilename);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Find the median of a benchmark in a JSON baseline
+
+	Return a negative number if not found
+
+***************************************/
+
+static double FindBaselineMedian(const char *pBaseline,const char *pSuite,const char *pName)
+{
+	char Key[256];
+	StringCopy(Key,sizeof(Key),"\"suite\":\"");
+	StringConcatenate(Key,sizeof(Key),pSuite);
+	StringConcatenate(Key,sizeof(Key),"\",\"name\":\"");
+	StringConcatenate(Key,sizeof(Key),pName);
+	StringConcatenate(Key,sizeof(Key),"\"");
+	const char *pFound = StringString(pBaseline,Key);
+	if (pFound) {
+		const char *pMedian = StringString(pFound,"\"median\":");
+		const char *pEnd = StringCharacter(pFound,'}');
+		// Make sure the median belongs to this object
+		if (pMedian && (!pEnd || (pMedian<pEnd))) {
+			return static_cast<double>(AsciiToFloat(pMedian+9));
+		}
+	}
+	return -1.0;
+}
+
+/*! ************************************
+
+	\brief Compare the results against a JSON baseline
+
+	Look up each result by suite and name in JSON text previously
+	created by SaveJSON(OutputMemoryStream *) const and print the
+	change in the median time. Any benchmark that is slower than the
+	baseline by more than the threshold is reported as a regression.
+
+	\param pBaseline Pointer to a "C" string with the baseline JSON
+	\param uThreshold Percentage slowdown allowed before a regression is reported
+	\return Zero if there are no regressions, non-zero if any benchmark regressed
+	\sa Compare(const char *,Word) const
+
+***************************************/
+
+Word BURGER_API Benchmark::CompareJSON(const char *pBaseline,Word uThreshold) const
+{
+	printf("\n%-12s %-36s %15s %15s %9s\n","Suite","Benchmark","Baseline","Current","Change");
+	Word uRegressions = 0;
+	WordPtr uCount = m_Results.size();
+	WordPtr i = 0;
+	while (i<uCount) {
+		const Result_t *pResult = &m_Results[i];
+		double dBaseline = FindBaselineMedian(pBaseline,pResult->m_pSuite,pResult->m_pName);
+		if (dBaseline<=0.0) {
+			printf("%-12s %-36s %15s %12.1f ns %9s\n",pResult->m_pSuite,pResult->m_pName,
+				"-",pResult->m_dMedian,"new");
+		} else {
+			double dChange = ((pResult->m_dMedian-dBaseline)*100.0)/dBaseline;
+			const char *pStatus = "";
+			if (dChange>static_cast<double>(uThreshold)) {
+				pStatus = " REGRESSION";
+				++uRegressions;
+			} else if (dChange<-static_cast<double>(uThreshold)) {
+				pStatus = " improved";
+			}
+			printf("%-12s %-36s %12.1f ns %12.1f ns %+8.1f%%%s\n",pResult->m_pSuite,pResult->m_pName,
+				dBaseline,pResult->m_dMedian,dChange,pStatus);
+		}
+		++i;
+	}
+	printf("%u regression(s) found with a %u%% threshold\n",uRegressions,uThreshold);
+	return uRegressions!=0;
+}
+
+/*! ************************************
+
+	\brief Compare the results against a JSON baseline file
+
+	\param pFilename Burgerlib formatted name of the JSON file saved by SaveJSON(const char *) const
+	\param uThreshold Percentage slowdown allowed before a regression is reported
+	\return Zero if there are no regressions, non-zero if any benchmark regressed or the file couldn't be read
+	\sa CompareJSON(const char *,Word) const
+
+***************************************/
+
+Word BURGER_API Benchmark::Compare(const char *pFilename,Word uThreshold) const
+{
+	WordPtr uLength;
+	void *pFile = FileManager::LoadFile(pFilename,&uLength);
+	if (!pFile) {
+		printf("Baseline file %s could not be loaded\n",pFilename);
+		return 10;
+	}
+	// Zero terminate the text for the string searches
+	char *pBaseline = static_cast<char *>(Alloc(uLength+1));
+	Word uResult = 10;
+	if (pBaseline) {
+		MemoryCopy(pBaseline,pFile,uLength);
+		pBaseline[uLength] = 0;
+		uResult = CompareJSON(pBaseline,uThreshold);
+		Free(pBaseline);
+	}
+	Free(pFile);
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Fill a buffer with repeatable pseudo random bytes
+
+	Benchmarks use this to create input data that is the same
+	on every run and every platform.
+
+	\param pOutput Buffer to fill
+	\param uLength Number of bytes to fill
+	\param uSeed Starting seed for the generator
+
+***************************************/
+
+void BURGER_API FillRandom(void *pOutput,WordPtr uLength,Word32 uSeed)
+{
+	Word8 *pWork = static_cast<Word8 *>(pOutput);
+	while (uLength) {
+		uSeed = (uSeed*1664525U)+1013904223U;
+		pWork[0] = static_cast<Word8>(uSeed>>24U);
+		++pWork;
+		--uLength;
+	}
+}
+
+//
+// All of the benchmark suites
+//
+
+struct BenchmarkSuite_t {
+	const char *m_pName;							// Name of the suite
+	void (BURGER_API *m_pProc)(Benchmark *pBench);	// Function to run the suite
+};
+
+static const BenchmarkSuite_t g_Suites[] = {
+	{"strings",BenchBrstrings},
+	{"hashes",BenchBrhashes},
+	{"compression",BenchBrcompression},
+	{"memory",BenchBrmemory},
+	{"math",BenchBrmath},
+	{"images",BenchBrimage},
+	{"renderer",BenchBrrenderer},
+	{"sound",BenchBrsound},
+	{"atomic",BenchBratomic},
+	{"ringqueue",BenchBrringqueue},
+	{"smartpointer",BenchBrsmartpointer},
+	{"profiler",BenchBrprofiler}
+};
+
+//
+// Run the benchmarks
+//
+
+int BURGER_ANSIAPI main(int argc,const char **argv)
+{
+	ConsoleApp MyApp(argc,argv);
+	CommandParameterString Suite("Only run this suite (strings, hashes, compression, memory, math, images, renderer, sound, atomic, ringqueue, smartpointer or profiler)","suite");
+	CommandParameterString Filter("Only run benchmarks whose name contains this text","filter");
+	CommandParameterString JSON("Save the results as JSON to this file","json");
+	CommandParameterString Baseline("Compare the results against this JSON file","compare");
+	CommandParameterWordPtr Threshold("Percentage slowdown reported as a regression","threshold",10,0,1000);
+	CommandParameterWordPtr Samples("Number of samples per benchmark","samples",Benchmark::DEFAULTSAMPLES,1,Benchmark::MAXSAMPLES);
+	CommandParameterWordPtr SampleTime("Minimum milliseconds per sample","time",Benchmark::DEFAULTSAMPLETIME,1,10000);
+	CommandParameterWordPtr Warmup("Milliseconds of warmup per benchmark","warmup",Benchmark::DEFAULTWARMUPTIME,0,10000);
+
+	const CommandParameter *MyParms[] = {
+		&Suite,
+		&Filter,
+		&JSON,
+		&Baseline,
+		&Threshold,
+		&Samples,
+		&SampleTime,
+		&Warmup
+	};
+	argc = CommandParameter::Process(MyApp.GetArgc(),MyApp.GetArgv(),MyParms,BURGER_ARRAYSIZE(MyParms),
+		"Usage: benchmarks [-suite name] [-json results.json] [-compare baseline.json]\n\n"
+		"Run the burgerlib microbenchmarks.\nCopyright by Rebecca Ann Heineman\n");
+	if (argc<0) {
+		return 10;
+	}
+
+	Benchmark Bench;
+	Bench.SetFilter(Filter.GetValue());
+	Bench.SetSamples(static_cast<Word>(Samples.GetValue()));
+	Bench.SetSampleTime(static_cast<Word>(SampleTime.GetValue()));
+	Bench.SetWarmupTime(static_cast<Word>(Warmup.GetValue()));
+
+	const char *pSuite = Suite.GetValue();
+	const BenchmarkSuite_t *pWork = g_Suites;
+	WordPtr uCount = BURGER_ARRAYSIZE(g_Suites);
+	do {
+		if (!pSuite[0] || !StringCaseCompare(pSuite,pWork->m_pName)) {
+			Bench.SetSuite(pWork->m_pName);
+			pWork->m_pProc(&Bench);
+		}
+		++pWork;
+	} while (--uCount);
+
+	int iResult = 0;
+	if (JSON.GetValue()[0]) {
+		if (Bench.SaveJSON(JSON.GetValue())) {
+			printf("Results could not be saved to %s\n",JSON.GetValue());
+			iResult = 10;
+		}
+	}
+	if (Baseline.GetValue()[0]) {
+		if (Bench.Compare(Baseline.GetValue(),static_cast<Word>(Threshold.GetValue()))) {
+			iResult = 10;
+		}
+	}
+	return iResult;
+}
@@ -0,0 +1,109 @@
+/***************************************
+
+	Microbenchmark framework for burgerlib
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRSIMPLEARRAY_H__
+#include "brsimplearray.h"
+#endif
+
+#if defined(BURGER_MSVC)
+#ifndef __BRVISUALSTUDIO_H__
+#include "brvisualstudio.h"
+#endif
+#endif
+
+namespace Burger {
+class OutputMemoryStream;
+}
+
+typedef void (BURGER_API *BenchmarkProc)(void *pData,WordPtr uIterations);
+
+class Benchmark {
+	BURGER_DISABLECOPYCONSTRUCTORS(Benchmark);
+public:
+	enum {
+		MAXSAMPLES=101,				///< Largest number of samples taken for each benchmark
+		DEFAULTSAMPLES=15,			///< Default number of samples taken for each benchmark
+		DEFAULTSAMPLETIME=10,		///< Default minimum time of each sample in milliseconds
+		DEFAULTWARMUPTIME=50		///< Default time spent warming up each benchmark in milliseconds
+	};
+	enum eUnits {
+		UNITS_NONE,					///< No throughput is reported
+		UNITS_BYTES,				///< Throughput is reported in bytes per second
+		UNITS_ITEMS					///< Throughput is reported in items per second
+	};
+	struct Result_t {
+		const char *m_pSuite;		///< Name of the suite, must be a static string
+		const char *m_pName;		///< Name of the benchmark, must be a static string
+		double m_dMinimum;			///< Fastest sample in nanoseconds per iteration
+		double m_dMedian;			///< Median sample in nanoseconds per iteration
+		double m_dP90;				///< 90th percentile sample in nanoseconds per iteration
+		double m_dP99;				///< 99th percentile sample in nanoseconds per iteration
+		double m_dThroughput;		///< Work units per second using the median, zero if \ref UNITS_NONE
+		WordPtr m_uIterations;		///< Number of iterations in each sample
+		WordPtr m_uWork;			///< Work units processed by each iteration
+		eUnits m_eUnits;			///< Type of work units
+	};
+private:
+	Burger::SimpleArray<Result_t> m_Results;	///< Results of every benchmark that was run
+	const char *m_pSuite;		///< Name of the suite currently running
+	const char *m_pFilter;		///< If not \ref NULL, only run benchmarks whose name contains this string
+	Word64 m_uSampleTime;		///< Minimum time of each sample in nanoseconds
+	Word64 m_uWarmupTime;		///< Time spent warming up in nanoseconds
+	Word m_uSamples;			///< Number of samples to take
+	Word m_bQuiet;				///< \ref TRUE if results are not printed as they are generated
+	static Word64 BURGER_API TimeIterations(BenchmarkProc pProc,void *pData,WordPtr uIterations);
+public:
+	Benchmark();
+	BURGER_INLINE void SetSuite(const char *pSuite) { m_pSuite = pSuite; }
+	BURGER_INLINE const char *GetSuite(void) const { return m_pSuite; }
+	BURGER_INLINE void SetFilter(const char *pFilter) { m_pFilter = pFilter; }
+	BURGER_INLINE void SetSampleTime(Word uMilliseconds) { m_uSampleTime = static_cast<Word64>(uMilliseconds)*1000000U; }
+	BURGER_INLINE void SetWarmupTime(Word uMilliseconds) { m_uWarmupTime = static_cast<Word64>(uMilliseconds)*1000000U; }
+	void BURGER_API SetSamples(Word uSamples);
+	BURGER_INLINE void SetQuiet(Word bQuiet) { m_bQuiet = bQuiet; }
+	Word BURGER_API Run(const char *pName,BenchmarkProc pProc,void *pData,WordPtr uWork=0,eUnits eUnitType=UNITS_NONE);
+	BURGER_INLINE WordPtr GetResultCount(void) const { return m_Results.size(); }
+	BURGER_INLINE const Result_t *GetResult(WordPtr uIndex) const { return &m_Results[uIndex]; }
+	static void BURGER_API PrintResult(const Result_t *pResult);
+	Word BURGER_API SaveJSON(Burger::OutputMemoryStream *pOutput) const;
+	Word BURGER_API SaveJSON(const char *pFilename) const;
+	Word BURGER_API CompareJSON(const char *pBaseline,Word uThreshold) const;
+	Word BURGER_API Compare(const char *pFilename,Word uThreshold) const;
+};
+
+#if defined(BURGER_GNUC) || defined(BURGER_LLVM) || defined(BURGER_SNSYSTEMS)
+template<class T>
+BURGER_INLINE void DoNotOptimize(const T &rValue) { __asm__ __volatile__("" : : "m"(rValue) : "memory"); }
+BURGER_INLINE void ClobberMemory(void) { __asm__ __volatile__("" : : : "memory"); }
+#else
+extern const void * volatile g_pBenchmarkSink;
+template<class T>
+BURGER_INLINE void DoNotOptimize(const T &rValue) { g_pBenchmarkSink = &rValue; }
+#if defined(BURGER_MSVC)
+BURGER_INLINE void ClobberMemory(void) { _ReadWriteBarrier(); }
+#else
+extern void BURGER_API ClobberMemory(void);
+#endif
+#endif
+
+extern void BURGER_API FillRandom(void *pOutput,WordPtr uLength,Word32 uSeed);
+extern int BURGER_ANSIAPI main(int argc,const char **argv);
+
+#endif
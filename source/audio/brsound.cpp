@@ -48,12 +48,384 @@ Burger::Sound::~Sound()
 }
 
 #if !defined(BURGER_WINDOWS) && !defined(BURGER_XBOX360)
+#include "brsoundmixer.h"
+#include "brglobalmemorymanager.h"
+
+/***************************************
+
+	On platforms without a native mixer, all audio is
+	mixed in software by a SoundMixer
+
+***************************************/
+
+Burger::Sound::Sound(GameApp *pGameApp) :
+	m_pGameApp(pGameApp),
+	m_pMixer(NULL),
+	m_pSink(NULL),
+	m_pDefaultSink(NULL),
+	m_uActiveVoices(0),
+	m_uMaxVoices(MAXVOICECOUNT),
+	m_uVolume(255),
+	m_bStereoAvailable(TRUE),
+	m_bBufferDepth(16),
+	m_uOutputSamplesPerSecond(44100)
+{
+}
+
+/***************************************
+
+	Init the sound manager
+
+	If SetSink() wasn't called, the audio is sent to a
+	SoundSinkNull that runs in real time
+
+***************************************/
+
+Word Burger::Sound::Init(void)
+{
+	Shutdown();
+	Word uResult = 10;
+	SoundSink *pSink = m_pSink;
+	if (!pSink) {
+		void *pMemory = Alloc(sizeof(SoundSinkNull));
+		if (pMemory) {
+			m_pDefaultSink = new (pMemory) SoundSinkNull(TRUE);
+			pSink = m_pDefaultSink;
+		}
+	}
+	if (pSink) {
+		m_pMixer = New<SoundMixer>();
+		if (m_pMixer) {
+			if (!m_pMixer->Init(pSink,m_uOutputSamplesPerSecond,m_bStereoAvailable ? 2U : 1U)) {
+				m_pMixer->SetMaxVoices(m_uMaxVoices);
+				m_pMixer->SetVolume(m_uVolume);
+				// Without threads, the application has to call SoundMixer::Mix()
+				m_pMixer->Start();
+				uResult = 0;
+			}
+		}
+	}
+	if (uResult) {
+		Shutdown();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Shut down the sound manager
+
+***************************************/
+
 void Burger::Sound::Shutdown(void)
+{
+	Voice *pVoice = m_ActiveVoices;
+	Word i = MAXVOICECOUNT;
+	do {
+		pVoice->Shutdown();
+		++pVoice;
+	} while (--i);
+	Delete(m_pMixer);
+	m_pMixer = NULL;
+	Delete(m_pDefaultSink);
+	m_pDefaultSink = NULL;
+}
+
+/***************************************
+
+	Play a sound buffer
+
+***************************************/
+
+Word Burger::Sound::Play(Buffer *pInput,Voice *pVoice)
+{
+	Word uResult = 10;
+	if (m_pMixer && pInput) {
+		SoundMixer::VoiceInit_t Init;
+		Init.m_pSamples = pInput->GetData();
+		Init.m_uLength = pInput->GetDataSize();
+		Init.m_uLoopStart = pInput->GetLoopStart();
+		Init.m_uLoopEnd = pInput->GetLoopEnd();
+		Init.m_pCompletion = pInput->GetCompletionFunction();
+		Init.m_pCompletionData = pInput->GetCompletionFunctionData();
+		Init.m_eDataType = pInput->GetDataType();
+		Init.m_uSampleRate = pInput->GetSampleRate();
+		Init.m_uVolume = pInput->GetDefaultVolume();
+		Init.m_uPan = pInput->GetDefaultPan();
+		Word uVoiceID = m_pMixer->Play(&Init);
+		if (uVoiceID) {
+			if (pVoice) {
+				pVoice->m_pMixer = m_pMixer;
+				pVoice->m_uVoiceID = uVoiceID;
+				pVoice->m_pBuffer = pInput;
+				pVoice->m_uLoopStart = Init.m_uLoopStart;
+				pVoice->m_uLoopEnd = Init.m_uLoopEnd;
+				pVoice->m_uSampleRate = Init.m_uSampleRate;
+				pVoice->m_uPan = Init.m_uPan;
+				pVoice->m_uVolume = Init.m_uVolume;
+				pVoice->m_bPlaying = TRUE;
+			}
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Stop all sounds
+
+***************************************/
+
+Word Burger::Sound::Stop(void)
+{
+	if (m_pMixer) {
+		m_pMixer->StopAll();
+	}
+	return 0;
+}
+
+/***************************************
+
+	Pause all sounds
+
+***************************************/
+
+Word Burger::Sound::Pause(void)
+{
+	if (m_pMixer) {
+		m_pMixer->Pause();
+	}
+	return 0;
+}
+
+/***************************************
+
+	Resume all sounds
+
+***************************************/
+
+Word Burger::Sound::Resume(void)
+{
+	if (m_pMixer) {
+		m_pMixer->Resume();
+	}
+	return 0;
+}
+
+/***************************************
+
+	Set the maximum number of voices to mix
+
+***************************************/
+
+void Burger::Sound::SetMaxVoices(Word uMax)
+{
+	if (uMax>MAXVOICECOUNT) {
+		uMax = MAXVOICECOUNT;
+	}
+	m_uMaxVoices = uMax;
+	if (m_pMixer) {
+		m_pMixer->SetMaxVoices(uMax);
+	}
+}
+
+/***************************************
+
+	Set the master volume
+
+***************************************/
+
+void Burger::Sound::SetVolume(Word uVolume)
+{
+	m_uVolume = uVolume;
+	if (m_pMixer) {
+		m_pMixer->SetVolume(uVolume);
+	}
+}
+
+/***************************************
+
+	Return the number of voices being mixed
+
+***************************************/
+
+Word Burger::Sound::GetActiveVoiceCount(void) const
+{
+	if (m_pMixer) {
+		return m_pMixer->GetActiveVoiceCount();
+	}
+	return 0;
+}
+
+/***************************************
+
+	Set the output for the software mixer
+
+	Must be called before Init() to take effect
+
+***************************************/
+
+void Burger::Sound::SetSink(SoundSink *pSink)
+{
+	m_pSink = pSink;
+}
+
+/***************************************
+
+	Sound buffers
+
+***************************************/
+
+Burger::Sound::Buffer::Buffer() :
+	m_pBuffer(NULL),
+	m_CompletionProc(NULL),
+	m_pCompletionData(NULL),
+	m_uBufferSize(0),
+	m_uLoopStart(0),
+	m_uLoopEnd(0),
+	m_eDataType(TYPEBYTE),
+	m_uDefaultSampleRate(22050),
+	m_uDefaultPan(0x8000),
+	m_uDefaultVolume(255),
+	m_bPlaying(FALSE)
+{
+}
+
+Burger::Sound::Buffer::Buffer(const void *pBuffer,WordPtr uLength,DataType eType) :
+	m_pBuffer(static_cast<Word8 *>(const_cast<void *>(pBuffer))),
+	m_CompletionProc(NULL),
+	m_pCompletionData(NULL),
+	m_uBufferSize(uLength),
+	m_uLoopStart(0),
+	m_uLoopEnd(0),
+	m_eDataType(eType),
+	m_uDefaultSampleRate(22050),
+	m_uDefaultPan(0x8000),
+	m_uDefaultVolume(255),
+	m_bPlaying(FALSE)
+{
+}
+
+Burger::Sound::Buffer::~Buffer()
+{
+	Shutdown();
+}
+
+void Burger::Sound::Buffer::Shutdown(void)
+{
+}
+
+/***************************************
+
+	Voices
+
+***************************************/
+
+Burger::Sound::Voice::Voice() :
+	m_pMixer(NULL),
+	m_uVoiceID(0),
+	m_pBuffer(NULL),
+	m_uLoopStart(0),
+	m_uLoopEnd(0),
+	m_uSampleRate(22050),
+	m_uPan(0x8000),
+	m_uVolume(255),
+	m_bPlaying(FALSE)
 {
 }
 
 Burger::Sound::Voice::~Voice()
 {
+	Shutdown();
+}
+
+void Burger::Sound::Voice::Shutdown(void)
+{
+	if (m_pMixer) {
+		m_pMixer->StopVoice(m_uVoiceID);
+		m_pMixer = NULL;
+		m_uVoiceID = 0;
+	}
+	m_pBuffer = NULL;
+	m_bPlaying = FALSE;
+}
+
+Word Burger::Sound::Voice::SetVolume(Word uVolume)
+{
+	m_uVolume = uVolume;
+	if (m_pMixer) {
+		m_pMixer->SetVoiceVolume(m_uVoiceID,uVolume);
+	}
+	return FALSE;
+}
+
+Word Burger::Sound::Voice::SetPan(Word uPan)
+{
+	m_uPan = uPan;
+	if (m_pMixer) {
+		m_pMixer->SetVoicePan(m_uVoiceID,uPan);
+	}
+	return FALSE;
+}
+
+Word Burger::Sound::Voice::SetSampleRate(Word uSamplesPerSecond)
+{
+	m_uSampleRate = uSamplesPerSecond;
+	if (m_pMixer) {
+		m_pMixer->SetVoiceSampleRate(m_uVoiceID,uSamplesPerSecond);
+	}
+	return FALSE;
+}
+
+Word Burger::Sound::Voice::IsPlaying(void) const
+{
+	if (m_pMixer) {
+		return m_pMixer->IsVoicePlaying(m_uVoiceID);
+	}
+	return FALSE;
+}
+
+/***************************************
+
+	Sound buffers from a resource file
+
+***************************************/
+
+Burger::SoundBufferRez::SoundBufferRez(void) :
+	Burger::Sound::Buffer(),
+	m_pRezFile(NULL),
+	m_ppHandle(NULL),
+	m_uRezNum(0)
+{
+}
+
+Burger::SoundBufferRez::SoundBufferRez(Burger::RezFile *pRezFile,Word uRezNum) :
+	Burger::Sound::Buffer(),
+	m_pRezFile(pRezFile),
+	m_ppHandle(NULL),
+	m_uRezNum(uRezNum)
+{
+}
+
+Burger::SoundBufferRez::~SoundBufferRez()
+{
+	Shutdown();
+}
+
+void Burger::SoundBufferRez::Shutdown(void)
+{
+}
+
+void Burger::SoundBufferRez::Set(RezFile *pRezFile,Word uRezNum)
+{
+	m_pRezFile = pRezFile;
+	m_uRezNum = uRezNum;
+}
+
+void Burger::SoundBufferRez::Set(Word uRezNum)
+{
+	m_uRezNum = uRezNum;
 }
 
 #endif
\ No newline at end of file
@@ -47,6 +47,9 @@ typedef struct WAVEFORMATEX {
 #endif
 
 namespace Burger {
+class SoundMixer;
+class SoundSink;
+class SoundSinkNull;
 class Sound {
 	BURGER_DISABLECOPYCONSTRUCTORS(Sound);
 public:
@@ -96,6 +99,11 @@ public:
 		BURGER_INLINE CompletionProc GetCompletionFunction(void) const { return m_CompletionProc; }
 		BURGER_INLINE void *GetCompletionFunctionData(void) const { return m_pCompletionData; }
 		BURGER_INLINE Word IsPlaying(void) const { return m_bPlaying; }
+		BURGER_INLINE const void *GetData(void) const { return m_pBuffer; }
+		BURGER_INLINE WordPtr GetDataSize(void) const { return m_uBufferSize; }
+		BURGER_INLINE DataType GetDataType(void) const { return m_eDataType; }
+		BURGER_INLINE WordPtr GetLoopStart(void) const { return m_uLoopStart; }
+		BURGER_INLINE WordPtr GetLoopEnd(void) const { return m_uLoopEnd; }
 	protected:
 #if defined(BURGER_WINDOWS) || defined(DOXYGEN)
 		IDirectSoundBuffer *m_pDirectSoundBuffer8;	///< DirectSound buffer (Windows Only)
@@ -117,6 +125,9 @@ public:
 
 
 	class Voice {
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+		friend class Sound;
+#endif
 	public:
 		Voice();
 		~Voice();
@@ -127,10 +138,18 @@ public:
 		BURGER_INLINE Word GetPan(void) const { return m_uPan; }
 		Word SetSampleRate(Word uSamplesPerSecond);
 		BURGER_INLINE Word GetSampleRate(void) const { return m_uSampleRate; }
+#if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
 		BURGER_INLINE Word IsPlaying(void) const { return m_bPlaying; }
+#else
+		Word IsPlaying(void) const;
+#endif
 	private:
 #if defined(BURGER_WINDOWS) || defined(DOXYGEN)
 		IDirectSoundBuffer *m_pDirectSoundBuffer8;	///< DirectSound buffer (Windows Only)
+#endif
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+		SoundMixer *m_pMixer;	///< Mixer playing the voice (Software mixer only)
+		Word m_uVoiceID;		///< ID of the voice in the mixer (Software mixer only)
 #endif
 		Buffer *m_pBuffer;		///< Sound buffer to play
 		WordPtr	m_uLoopStart;	///< Sample to start from
@@ -158,9 +177,17 @@ public:
 	Word Resume(void);
 	void SetMaxVoices(Word uMax);
 	BURGER_INLINE Word GetMaxVoices(void) const { return m_uMaxVoices; }
+#if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
 	BURGER_INLINE Word GetActiveVoiceCount(void) const { return m_uActiveVoices; }
+#else
+	Word GetActiveVoiceCount(void) const;
+#endif
 	void SetVolume(Word uVolume);
 	BURGER_INLINE Word GetVolume(void) const { return m_uVolume; }
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+	void SetSink(SoundSink *pSink);
+	BURGER_INLINE SoundMixer *GetMixer(void) const { return m_pMixer; }
+#endif
 private:
 	static RunQueue::eReturnCode BURGER_API Callback(void *);
 
@@ -177,6 +204,11 @@ private:
 	Word m_uDeviceFlags;					///< DSCAPS for DirectSound Device (Windows Only)
 	Word m_uBufferAllocationType;			///< Preferred method of allocating audio memory (Windows Only)
 	void *m_hEvents[MAXVOICECOUNT];			///< Events for DirectSound completion functions (Windows Only)
+#endif
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
+	SoundMixer *m_pMixer;			///< Software mixer (Software mixer only)
+	SoundSink *m_pSink;				///< Output for the mixer supplied by the application (Software mixer only)
+	SoundSinkNull *m_pDefaultSink;	///< Output used when no sink was supplied (Software mixer only)
 #endif
 	Voice m_ActiveVoices[MAXVOICECOUNT];	///< Array of active sound buffers being played
 	Word m_uActiveVoices;			///< Number of active voices
@@ -0,0 +1,1488 @@
+/***************************************
+
+	Software sound mixer
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brsoundmixer.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brtick.h"
+#include "brulaw.h"
+#include "bralaw.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
+/*! ************************************
+
+	\class Burger::SoundSink
+	\brief Base class for the output of a SoundMixer
+
+	A SoundSink receives blocks of mixed audio from a SoundMixer.
+	The samples are 32 bit floats in the range of -1.0 to 1.0
+	and if the output is in stereo, the samples are interleaved
+	left and then right.
+
+	Derived classes can send the data to an audio device, a file
+	or simply throw it away. Write() is called from the mixer
+	thread and it's expected to block until the audio device
+	can accept more data, which is what paces the mixer.
+
+	\sa SoundSinkNull, SoundSinkWaveFile or SoundMixer
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SoundSink::SoundSink()
+	\brief Default constructor
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default destructor
+
+***************************************/
+
+Burger::SoundSink::~SoundSink()
+{
+}
+
+/*! ************************************
+
+	\brief Prepare to receive audio
+
+	Called by SoundMixer::Start() before the first call to Write().
+
+	\param uSampleRate Sample frames per second
+	\param uChannels Number of channels per sample frame (1 or 2)
+	\return Zero if no error, non-zero if the output can't be started
+	\sa Stop()
+
+***************************************/
+
+Word Burger::SoundSink::Start(Word /* uSampleRate */,Word /* uChannels */)
+{
+	return 0;
+}
+
+/*! ************************************
+
+	\fn Word Burger::SoundSink::Write(const float *pInput,Word uFrameCount)
+	\brief Accept a block of mixed audio
+
+	\param pInput Pointer to the interleaved samples
+	\param uFrameCount Number of sample frames in the block
+	\return Zero if no error, non-zero on error
+	\sa Start()
+
+***************************************/
+
+/*! ************************************
+
+	\brief Finish receiving audio
+
+	Called by SoundMixer::Stop() after the last call to Write().
+
+	\sa Start()
+
+***************************************/
+
+void Burger::SoundSink::Stop(void)
+{
+}
+
+/*! ************************************
+
+	\class Burger::SoundSinkNull
+	\brief SoundSink that discards all audio
+
+	This sink is used on platforms without an audio device backend
+	and for testing. It counts the sample frames that were written
+	and if requested, it will sleep for the amount of time the audio
+	would have taken to play so the mixer runs at the same
+	rate as it would with a real device.
+
+	\sa SoundSink or SoundSinkWaveFile
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+	\param bRealTime \ref TRUE if Write() should sleep for the duration of the audio
+
+***************************************/
+
+Burger::SoundSinkNull::SoundSinkNull(Word bRealTime) :
+	m_uFrameCount(0),
+	m_uSampleRate(44100),
+	m_bRealTime(bRealTime)
+{
+}
+
+/*! ************************************
+
+	\brief Reset the frame counter
+
+	\param uSampleRate Sample frames per second
+	\param uChannels Number of channels per sample frame (Ignored)
+	\return Zero
+	\sa GetFrameCount()
+
+***************************************/
+
+Word Burger::SoundSinkNull::Start(Word uSampleRate,Word /* uChannels */)
+{
+	m_uFrameCount = 0;
+	m_uSampleRate = uSampleRate ? uSampleRate : 1;
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Discard a block of audio
+
+	\param pInput Pointer to the interleaved samples (Ignored)
+	\param uFrameCount Number of sample frames in the block
+	\return Zero
+
+***************************************/
+
+Word Burger::SoundSinkNull::Write(const float * /* pInput */,Word uFrameCount)
+{
+	m_uFrameCount += uFrameCount;
+	if (m_bRealTime) {
+		Sleep(static_cast<Word32>((static_cast<Word64>(uFrameCount)*1000U)/m_uSampleRate));
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\fn Word64 Burger::SoundSinkNull::GetFrameCount(void) const
+	\brief Return the number of sample frames written since Start()
+
+	\return Number of sample frames discarded
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::SoundSinkWaveFile
+	\brief SoundSink that records audio to a *.WAV file
+
+	The mixed audio is converted to 16 bit signed samples and
+	saved as an uncompressed RIFF WAVE file. This is useful
+	for capturing audio on machines without an audio device and
+	for comparing mixer output across platforms.
+
+	\sa SoundSink or SoundSinkNull
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+***************************************/
+
+Burger::SoundSinkWaveFile::SoundSinkWaveFile() :
+	m_uDataSize(0),
+	m_uChannels(2)
+{
+}
+
+/*! ************************************
+
+	\brief Default destructor
+
+	Finalizes the file header and closes the file.
+
+***************************************/
+
+Burger::SoundSinkWaveFile::~SoundSinkWaveFile()
+{
+	Stop();
+}
+
+/*! ************************************
+
+	\brief Create the file to record into
+
+	\param pFileName Burgerlib formatted filename of the *.WAV file to create
+	\return Zero if no error, non-zero if the file couldn't be created
+
+***************************************/
+
+Word Burger::SoundSinkWaveFile::Open(const char *pFileName)
+{
+	Stop();
+	return m_File.Open(pFileName,File::WRITEONLY);
+}
+
+/***************************************
+
+	Store a 16 or 32 bit value in little endian order
+
+***************************************/
+
+static void BURGER_API StoreLittle16(Word8 *pOutput,Word uInput)
+{
+	pOutput[0] = static_cast<Word8>(uInput);
+	pOutput[1] = static_cast<Word8>(uInput>>8U);
+}
+
+static void BURGER_API StoreLittle32(Word8 *pOutput,Word32 uInput)
+{
+	pOutput[0] = static_cast<Word8>(uInput);
+	pOutput[1] = static_cast<Word8>(uInput>>8U);
+	pOutput[2] = static_cast<Word8>(uInput>>16U);
+	pOutput[3] = static_cast<Word8>(uInput>>24U);
+}
+
+/*! ************************************
+
+	\brief Write the *.WAV file header
+
+	The header is written with a data size of zero, it's
+	updated with the proper sizes when Stop() is called.
+
+	\param uSampleRate Sample frames per second
+	\param uChannels Number of channels per sample frame
+	\return Zero if no error, non-zero if the file isn't open or can't be written to
+
+***************************************/
+
+Word Burger::SoundSinkWaveFile::Start(Word uSampleRate,Word uChannels)
+{
+	Word uResult = 10;
+	if (m_File.IsOpened()) {
+		m_uChannels = uChannels;
+		m_uDataSize = 0;
+		Word8 Header[44];
+		Header[0] = 'R';
+		Header[1] = 'I';
+		Header[2] = 'F';
+		Header[3] = 'F';
+		StoreLittle32(Header+4,36);
+		Header[8] = 'W';
+		Header[9] = 'A';
+		Header[10] = 'V';
+		Header[11] = 'E';
+		Header[12] = 'f';
+		Header[13] = 'm';
+		Header[14] = 't';
+		Header[15] = ' ';
+		StoreLittle32(Header+16,16);
+		StoreLittle16(Header+20,1);				// WAVE_FORMAT_PCM
+		StoreLittle16(Header+22,uChannels);
+		StoreLittle32(Header+24,uSampleRate);
+		StoreLittle32(Header+28,uSampleRate*uChannels*2);
+		StoreLittle16(Header+32,uChannels*2);
+		StoreLittle16(Header+34,16);
+		Header[36] = 'd';
+		Header[37] = 'a';
+		Header[38] = 't';
+		Header[39] = 'a';
+		StoreLittle32(Header+40,0);
+		m_File.SetMark(0);
+		if (m_File.Write(Header,sizeof(Header))==sizeof(Header)) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Convert and save a block of audio
+
+	\param pInput Pointer to the interleaved samples
+	\param uFrameCount Number of sample frames in the block
+	\return Zero if no error, non-zero on a write error
+
+***************************************/
+
+Word Burger::SoundSinkWaveFile::Write(const float *pInput,Word uFrameCount)
+{
+	Word uResult = 10;
+	if (m_File.IsOpened()) {
+		Int16 Buffer[1024];
+		WordPtr uCount = static_cast<WordPtr>(uFrameCount)*m_uChannels;
+		uResult = 0;
+		while (uCount) {
+			WordPtr uChunk = (uCount<BURGER_ARRAYSIZE(Buffer)) ? uCount : BURGER_ARRAYSIZE(Buffer);
+			ConvertToInt16(Buffer,pInput,uChunk);
+#if defined(BURGER_BIGENDIAN)
+			// *.WAV files are little endian
+			WordPtr i = 0;
+			do {
+				Word uTemp = static_cast<Word16>(Buffer[i]);
+				StoreLittle16(reinterpret_cast<Word8 *>(&Buffer[i]),uTemp);
+			} while (++i<uChunk);
+#endif
+			if (m_File.Write(Buffer,uChunk*2)!=(uChunk*2)) {
+				uResult = 10;
+				break;
+			}
+			m_uDataSize += static_cast<Word32>(uChunk*2);
+			pInput += uChunk;
+			uCount -= uChunk;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Update the *.WAV header and close the file
+
+	\sa Start()
+
+***************************************/
+
+void Burger::SoundSinkWaveFile::Stop(void)
+{
+	if (m_File.IsOpened()) {
+		Word8 Size[4];
+		StoreLittle32(Size,m_uDataSize+36);
+		m_File.SetMark(4);
+		m_File.Write(Size,4);
+		StoreLittle32(Size,m_uDataSize);
+		m_File.SetMark(40);
+		m_File.Write(Size,4);
+		m_File.Close();
+	}
+}
+
+/*! ************************************
+
+	\brief Convert floating point samples to 16 bit integers
+
+	Samples are clamped to -1.0 to 1.0, scaled by 32767 and
+	rounded to the nearest integer with halfway cases
+	rounded away from zero. NaN is converted to -32767. The
+	SIMD and scalar versions produce identical results.
+
+	\param pOutput Pointer to the buffer to receive the 16 bit samples
+	\param pInput Pointer to the floating point samples
+	\param uCount Number of samples to convert
+
+***************************************/
+
+void BURGER_API Burger::SoundSinkWaveFile::ConvertToInt16(Int16 *pOutput,const float *pInput,WordPtr uCount)
+{
+#if defined(BURGER_SSE2)
+	if (uCount>=8) {
+		const __m128 vMax = _mm_set1_ps(1.0f);
+		const __m128 vMin = _mm_set1_ps(-1.0f);
+		const __m128 vScale = _mm_set1_ps(32767.0f);
+		const __m128 vHalf = _mm_set1_ps(0.5f);
+		const __m128 vSign = _mm_set1_ps(-0.0f);
+		do {
+			// _mm_max_ps() returns the second operand for NaN
+			__m128 vA = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pInput),vMin),vMax);
+			__m128 vB = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pInput+4),vMin),vMax);
+			vA = _mm_mul_ps(vA,vScale);
+			vB = _mm_mul_ps(vB,vScale);
+			// Add 0.5 with the sign of the sample and truncate
+			vA = _mm_add_ps(vA,_mm_or_ps(_mm_and_ps(vA,vSign),vHalf));
+			vB = _mm_add_ps(vB,_mm_or_ps(_mm_and_ps(vB,vSign),vHalf));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),_mm_packs_epi32(_mm_cvttps_epi32(vA),_mm_cvttps_epi32(vB)));
+			pInput += 8;
+			pOutput += 8;
+			uCount -= 8;
+		} while (uCount>=8);
+	}
+#elif defined(BURGER_NEON)
+	if (uCount>=8) {
+		const float32x4_t vMax = vdupq_n_f32(1.0f);
+		const float32x4_t vMin = vdupq_n_f32(-1.0f);
+		const float32x4_t vScale = vdupq_n_f32(32767.0f);
+		const uint32x4_t vSign = vdupq_n_u32(0x80000000U);
+		const uint32x4_t vHalf = vreinterpretq_u32_f32(vdupq_n_f32(0.5f));
+		do {
+			float32x4_t vA = vld1q_f32(pInput);
+			float32x4_t vB = vld1q_f32(pInput+4);
+			// Replace NaN with -1.0 to match the scalar version
+			vA = vbslq_f32(vceqq_f32(vA,vA),vA,vMin);
+			vB = vbslq_f32(vceqq_f32(vB,vB),vB,vMin);
+			vA = vmulq_f32(vminq_f32(vmaxq_f32(vA,vMin),vMax),vScale);
+			vB = vmulq_f32(vminq_f32(vmaxq_f32(vB,vMin),vMax),vScale);
+			vA = vaddq_f32(vA,vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(vA),vSign),vHalf)));
+			vB = vaddq_f32(vB,vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(vB),vSign),vHalf)));
+			vst1q_s16(pOutput,vcombine_s16(vqmovn_s32(vcvtq_s32_f32(vA)),vqmovn_s32(vcvtq_s32_f32(vB))));
+			pInput += 8;
+			pOutput += 8;
+			uCount -= 8;
+		} while (uCount>=8);
+	}
+#endif
+	if (uCount) {
+		do {
+			float fTemp = pInput[0];
+			// NaN fails both tests
+			if (!(fTemp>=-1.0f)) {
+				fTemp = -1.0f;
+			} else if (fTemp>1.0f) {
+				fTemp = 1.0f;
+			}
+			fTemp *= 32767.0f;
+			fTemp += (fTemp<0.0f) ? -0.5f : 0.5f;
+			pOutput[0] = static_cast<Int16>(static_cast<int>(fTemp));
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
+
+/*! ************************************
+
+	\class Burger::SoundMixer
+	\brief Portable software audio mixer
+
+	This class mixes up to \ref MAXVOICES mono sound buffers
+	into a mono or stereo stream of 32 bit floating point samples and
+	passes the result to a SoundSink. It's used as the Sound backend
+	on platforms that don't have a hardware or operating system
+	mixer.
+
+	Each voice is resampled to the output sample rate with linear
+	interpolation from a 32.32 fixed point position, so any source
+	sample rate can be played at any output rate and loops are
+	sample accurate. Volume and pan changes, starts and stops
+	are ramped over \ref RAMPLENGTH sample frames to prevent clicks.
+
+	Mixing is performed in blocks of \ref BLOCKSIZE sample frames
+	by a background thread started with Start(). Mix() can also be called
+	directly to render audio without a thread, which is what the
+	unit tests do.
+
+	Voices are referenced by an ID returned by Play(). The ID
+	contains a serial number so an ID for a voice that has finished
+	and was reused is detected and ignored.
+
+	\sa SoundSink or Sound
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::SoundMixer::VoiceInit_t
+	\brief Description of a sound to play
+
+	\sa Play(const VoiceInit_t *)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+	Call Init() to attach a SoundSink and allocate the
+	mixing buffers.
+
+	\sa Init(SoundSink *,Word,Word)
+
+***************************************/
+
+Burger::SoundMixer::SoundMixer() :
+	m_pSink(NULL),
+	m_pBus(NULL),
+	m_pScratch(NULL),
+	m_pResampled(NULL),
+	m_uSampleRate(44100),
+	m_uChannels(2),
+	m_uMaxVoices(MAXVOICES),
+	m_uVolume(255),
+	m_uSerial(0),
+	m_bQuit(FALSE),
+	m_bPaused(FALSE),
+	m_bStarted(FALSE)
+{
+	MemoryClear(m_Voices,sizeof(m_Voices));
+}
+
+/*! ************************************
+
+	\brief Default destructor
+
+	\sa Shutdown()
+
+***************************************/
+
+Burger::SoundMixer::~SoundMixer()
+{
+	Shutdown();
+}
+
+/*! ************************************
+
+	\brief Prepare the mixer for output
+
+	Allocate the mixing buffers and set the output format.
+	Start() must be called to begin sending audio to the
+	SoundSink.
+
+	\param pSink Pointer to the output (Can be \ref NULL if only Mix() will be called)
+	\param uSampleRate Output sample frames per second
+	\param uChannels Output channels, 1 for mono, 2 for stereo
+	\return Zero if no error, non-zero on a bad parameter or out of memory
+
+***************************************/
+
+Word Burger::SoundMixer::Init(SoundSink *pSink,Word uSampleRate,Word uChannels)
+{
+	Shutdown();
+	Word uResult = 10;
+	if (uSampleRate && ((uChannels==1) || (uChannels==2))) {
+		float *pBuffer = static_cast<float *>(Alloc(sizeof(float)*((BLOCKSIZE*2)+SCRATCHSIZE+BLOCKSIZE)));
+		if (pBuffer) {
+			m_pBus = pBuffer;
+			m_pScratch = pBuffer+(BLOCKSIZE*2);
+			m_pResampled = m_pScratch+SCRATCHSIZE;
+			m_pSink = pSink;
+			m_uSampleRate = uSampleRate;
+			m_uChannels = uChannels;
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Stop the mixer and release resources
+
+	Voices that are playing are discarded without
+	calling their completion functions.
+
+	\sa Init(SoundSink *,Word,Word)
+
+***************************************/
+
+void Burger::SoundMixer::Shutdown(void)
+{
+	Stop();
+	MemoryClear(m_Voices,sizeof(m_Voices));
+	Free(m_pBus);
+	m_pBus = NULL;
+	m_pScratch = NULL;
+	m_pResampled = NULL;
+	m_pSink = NULL;
+}
+
+/*! ************************************
+
+	\brief Start the mixer thread
+
+	Call SoundSink::Start() and spawn a thread that calls Mix()
+	and passes the result to SoundSink::Write() until
+	Stop() is called.
+
+	On platforms without thread support, this will fail and
+	the application has to call Mix() itself.
+
+	\return Zero if no error, non-zero if there is no sink or the thread couldn't be started
+	\sa Stop()
+
+***************************************/
+
+Word Burger::SoundMixer::Start(void)
+{
+	Word uResult = 10;
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+	if (m_pSink && m_pBus && !m_bStarted) {
+		if (!m_pSink->Start(m_uSampleRate,m_uChannels)) {
+			m_bQuit = FALSE;
+			if (!m_Thread.Start(MixerThread,this)) {
+				m_bStarted = TRUE;
+				uResult = 0;
+			} else {
+				m_pSink->Stop();
+			}
+		}
+	}
+#endif
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Stop the mixer thread
+
+	Wait for the mixer thread to exit and call SoundSink::Stop().
+
+	\sa Start()
+
+***************************************/
+
+void Burger::SoundMixer::Stop(void)
+{
+	if (m_bStarted) {
+		m_bQuit = TRUE;
+		m_Thread.Wait();
+		m_pSink->Stop();
+		m_bStarted = FALSE;
+	}
+}
+
+/***************************************
+
+	Look up a voice from its ID, the lock must be held
+
+***************************************/
+
+Burger::SoundMixer::Voice_t *Burger::SoundMixer::GetVoice(Word uVoiceID)
+{
+	Word uIndex = uVoiceID&0xFFU;
+	if (uIndex<MAXVOICES) {
+		Voice_t *pVoice = &m_Voices[uIndex];
+		if (pVoice->m_bActive && (pVoice->m_uSerial==(uVoiceID>>8U))) {
+			return pVoice;
+		}
+	}
+	return NULL;
+}
+
+/***************************************
+
+	Set the target gains for a voice from its volume, pan
+	and the master volume, and either snap to them or
+	ramp to them
+
+***************************************/
+
+void Burger::SoundMixer::SetGains(Voice_t *pVoice,Word bRamp) const
+{
+	float fLeft = 0.0f;
+	float fRight = 0.0f;
+	if (!pVoice->m_bStopping) {
+		float fVolume = static_cast<float>(pVoice->m_uVolume*m_uVolume)*(1.0f/65025.0f);
+		Word uPan = pVoice->m_uPan;
+		fLeft = fVolume;
+		fRight = fVolume;
+		if (uPan>0x8000U) {
+			fLeft *= static_cast<float>(0xFFFFU-uPan)*(1.0f/32767.0f);
+		} else if (uPan<0x8000U) {
+			fRight *= static_cast<float>(uPan)*(1.0f/32768.0f);
+		}
+	}
+	if (bRamp) {
+		pVoice->m_fLeftStep = (fLeft-pVoice->m_fLeft)*(1.0f/static_cast<float>(RAMPLENGTH));
+		pVoice->m_fRightStep = (fRight-pVoice->m_fRight)*(1.0f/static_cast<float>(RAMPLENGTH));
+		pVoice->m_uRampCount = RAMPLENGTH;
+	} else {
+		pVoice->m_fLeft = fLeft;
+		pVoice->m_fRight = fRight;
+		pVoice->m_fLeftStep = 0.0f;
+		pVoice->m_fRightStep = 0.0f;
+		pVoice->m_uRampCount = 0;
+	}
+}
+
+/***************************************
+
+	Set the fixed point step from the voice's sample rate
+
+***************************************/
+
+static Word64 BURGER_API GetStep(Word uSampleRate,Word uOutputRate)
+{
+	if (!uSampleRate) {
+		uSampleRate = 1;
+	}
+	Word64 uStep = (static_cast<Word64>(uSampleRate)<<32U)/uOutputRate;
+	// Cap to 64x the output rate so the source span of a block is bounded
+	if (uStep>(static_cast<Word64>(64)<<32U)) {
+		uStep = static_cast<Word64>(64)<<32U;
+	}
+	return uStep;
+}
+
+/***************************************
+
+	Resample a voice into m_pResampled
+
+	Returns the number of sample frames generated. If less
+	than uFrameCount, the voice reached the end of its data
+	and the rest of the buffer is silence.
+
+***************************************/
+
+Word Burger::SoundMixer::MixVoice(Voice_t *pVoice,Word uFrameCount)
+{
+	float *pOutput = m_pResampled;
+	const Word8 *pSamples = pVoice->m_pSamples;
+	const Sound::DataType eType = pVoice->m_eDataType;
+	const WordPtr uSampleSize = ((eType==Sound::TYPELSHORT) || (eType==Sound::TYPEBSHORT)) ? 2U : 1U;
+	const Word64 uStep = pVoice->m_uStep;
+	const Word bLooping = pVoice->m_uLoopEnd!=0;
+	const WordPtr uEnd = bLooping ? pVoice->m_uLoopEnd : pVoice->m_uSampleCount;
+	const Word64 uEndFixed = static_cast<Word64>(uEnd)<<32U;
+	Word64 uPosition = pVoice->m_uPosition;
+	Word uRemaining = uFrameCount;
+
+	while (uRemaining) {
+		// Handle the end of the data
+		if (uPosition>=uEndFixed) {
+			if (!bLooping) {
+				break;
+			}
+			const Word64 uLoopLength = static_cast<Word64>(uEnd-pVoice->m_uLoopStart)<<32U;
+			do {
+				uPosition -= uLoopLength;
+			} while (uPosition>=uEndFixed);
+		}
+
+		// How many frames can be made before the end of the data?
+		Word64 uLimit = ((uEndFixed-uPosition-1U)/uStep)+1U;
+		Word uChunk = (uLimit<uRemaining) ? static_cast<Word>(uLimit) : uRemaining;
+
+		// How many frames fit in the scratch buffer?
+		Word64 uFraction = uPosition&0xFFFFFFFFU;
+		uLimit = (((static_cast<Word64>(SCRATCHSIZE-2)<<32U)-uFraction)/uStep)+1U;
+		if (uLimit<uChunk) {
+			uChunk = static_cast<Word>(uLimit);
+		}
+
+		// Convert the source samples needed
+		WordPtr uFirst = static_cast<WordPtr>(uPosition>>32U);
+		WordPtr uLast = static_cast<WordPtr>((uPosition+(uStep*(uChunk-1)))>>32U);
+		WordPtr uCount = (uLast-uFirst)+1;
+		float *pScratch = m_pScratch;
+		if ((uLast+1)<uEnd) {
+			ConvertToFloat(pScratch,pSamples+(uFirst*uSampleSize),uCount+1,eType);
+		} else {
+			// The sample after the last one is either the loop start or a copy of the last sample
+			ConvertToFloat(pScratch,pSamples+(uFirst*uSampleSize),uCount,eType);
+			if (bLooping) {
+				ConvertToFloat(pScratch+uCount,pSamples+(pVoice->m_uLoopStart*uSampleSize),1,eType);
+			} else {
+				pScratch[uCount] = pScratch[uCount-1];
+			}
+		}
+
+		// Interpolate
+		Word64 uLocal = uFraction;
+		Word i = uChunk;
+		do {
+			const float *pSource = pScratch+static_cast<WordPtr>(uLocal>>32U);
+			float fFraction = static_cast<float>(static_cast<Word32>(uLocal))*(1.0f/4294967296.0f);
+			pOutput[0] = pSource[0]+((pSource[1]-pSource[0])*fFraction);
+			++pOutput;
+			uLocal += uStep;
+		} while (--i);
+		uPosition += uStep*uChunk;
+		uRemaining -= uChunk;
+	}
+	pVoice->m_uPosition = uPosition;
+	if (uRemaining) {
+		MemoryClear(pOutput,sizeof(float)*uRemaining);
+	}
+	return uFrameCount-uRemaining;
+}
+
+/***************************************
+
+	Mixer thread, mix blocks and send them to the sink
+
+***************************************/
+
+WordPtr BURGER_API Burger::SoundMixer::MixerThread(void *pThis)
+{
+	SoundMixer *pMixer = static_cast<SoundMixer *>(pThis);
+	while (!pMixer->m_bQuit) {
+		pMixer->Mix(pMixer->m_pBus,BLOCKSIZE);
+		if (pMixer->m_pSink->Write(pMixer->m_pBus,BLOCKSIZE)) {
+			// Don't spin if the output is failing
+			Sleep(1);
+		}
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Mix all playing voices
+
+	Render sample frames into a buffer. The output is interleaved if
+	the mixer is in stereo. Voices that reach the end of their data
+	are stopped and their completion functions are called after
+	the voices are unlocked, so it's safe to call Play() from a
+	completion function.
+
+	If the mixer is paused, the buffer is filled with silence and
+	the voices are not advanced.
+
+	\param pOutput Pointer to a buffer of uFrameCount*GetChannels() floats
+	\param uFrameCount Number of sample frames to render
+
+***************************************/
+
+void Burger::SoundMixer::Mix(float *pOutput,Word uFrameCount)
+{
+	const Word uChannels = m_uChannels;
+	MemoryClear(pOutput,sizeof(float)*uFrameCount*uChannels);
+	if (!m_pResampled) {
+		return;
+	}
+
+	Sound::CompletionProc Procs[MAXVOICES];
+	void *Data[MAXVOICES];
+	Word uCompletionCount = 0;
+
+	m_Lock.Lock();
+	if (!m_bPaused) {
+		while (uFrameCount) {
+			const Word uBlock = (uFrameCount<BLOCKSIZE) ? uFrameCount : static_cast<Word>(BLOCKSIZE);
+			Voice_t *pVoice = m_Voices;
+			Word i = MAXVOICES;
+			do {
+				if (pVoice->m_bActive) {
+					const Word uMixed = MixVoice(pVoice,uBlock);
+					const float *pInput = m_pResampled;
+					float *pMix = pOutput;
+					Word uLeft = uMixed;
+
+					// Apply the volume ramp one frame at a time
+					if (pVoice->m_uRampCount) {
+						Word uRamp = (pVoice->m_uRampCount<uLeft) ? pVoice->m_uRampCount : uLeft;
+						pVoice->m_uRampCount -= uRamp;
+						uLeft -= uRamp;
+						float fLeft = pVoice->m_fLeft;
+						float fRight = pVoice->m_fRight;
+						if (uRamp) {
+							do {
+								fLeft += pVoice->m_fLeftStep;
+								fRight += pVoice->m_fRightStep;
+								if (uChannels==2) {
+									pMix[0] += pInput[0]*fLeft;
+									pMix[1] += pInput[0]*fRight;
+									pMix += 2;
+								} else {
+									pMix[0] += pInput[0]*((fLeft+fRight)*0.5f);
+									++pMix;
+								}
+								++pInput;
+							} while (--uRamp);
+						}
+						pVoice->m_fLeft = fLeft;
+						pVoice->m_fRight = fRight;
+						if (!pVoice->m_uRampCount) {
+							if (pVoice->m_bStopping) {
+								// The fade out is done, the voice is stopped
+								pVoice->m_bActive = FALSE;
+								uLeft = 0;
+							} else {
+								// Remove the accumulated rounding error
+								SetGains(pVoice,FALSE);
+							}
+						}
+					}
+
+					// Mix the rest at a constant volume
+					if (uLeft) {
+						if (uChannels==2) {
+							MixStereo(pMix,pInput,uLeft,pVoice->m_fLeft,pVoice->m_fRight);
+						} else {
+							MixMono(pMix,pInput,uLeft,(pVoice->m_fLeft+pVoice->m_fRight)*0.5f);
+						}
+					}
+
+					// Did the sound finish?
+					if (pVoice->m_bActive && (uMixed<uBlock)) {
+						pVoice->m_bActive = FALSE;
+						if (!pVoice->m_bStopping && pVoice->m_pCompletion) {
+							Procs[uCompletionCount] = pVoice->m_pCompletion;
+							Data[uCompletionCount] = pVoice->m_pCompletionData;
+							++uCompletionCount;
+						}
+					}
+				}
+				++pVoice;
+			} while (--i);
+			pOutput += uBlock*uChannels;
+			uFrameCount -= uBlock;
+		}
+	}
+	m_Lock.Unlock();
+
+	// Issue the completion callbacks
+	Word j = 0;
+	while (j<uCompletionCount) {
+		Procs[j](Data[j]);
+		++j;
+	}
+}
+
+/*! ************************************
+
+	\brief Start playing a sound
+
+	The voice fades in over \ref RAMPLENGTH sample frames.
+
+	\param pInit Pointer to the description of the sound to play
+	\return Voice ID for the sound or zero if there was no free voice or the data isn't supported
+	\sa StopVoice(Word) or IsDataTypeSupported(Sound::DataType)
+
+***************************************/
+
+Word Burger::SoundMixer::Play(const VoiceInit_t *pInit)
+{
+	Word uResult = 0;
+	if (pInit->m_pSamples && IsDataTypeSupported(pInit->m_eDataType)) {
+		const Sound::DataType eType = pInit->m_eDataType;
+		WordPtr uSampleCount = pInit->m_uLength;
+		if ((eType==Sound::TYPELSHORT) || (eType==Sound::TYPEBSHORT)) {
+			uSampleCount >>= 1U;
+		}
+		if (uSampleCount) {
+			CriticalSectionLock Lock(&m_Lock);
+			Voice_t *pVoice = m_Voices;
+			Word i = 0;
+			do {
+				if (!pVoice->m_bActive) {
+					break;
+				}
+				++pVoice;
+			} while (++i<m_uMaxVoices);
+			if (i<m_uMaxVoices) {
+				pVoice->m_pSamples = static_cast<const Word8 *>(pInit->m_pSamples);
+				pVoice->m_pCompletion = pInit->m_pCompletion;
+				pVoice->m_pCompletionData = pInit->m_pCompletionData;
+				pVoice->m_uPosition = 0;
+				pVoice->m_uStep = GetStep(pInit->m_uSampleRate,m_uSampleRate);
+				pVoice->m_uSampleCount = uSampleCount;
+				// Only accept sane loops
+				WordPtr uLoopEnd = pInit->m_uLoopEnd;
+				if (uLoopEnd>uSampleCount) {
+					uLoopEnd = uSampleCount;
+				}
+				if (pInit->m_uLoopStart>=uLoopEnd) {
+					uLoopEnd = 0;
+				}
+				pVoice->m_uLoopStart = uLoopEnd ? pInit->m_uLoopStart : 0;
+				pVoice->m_uLoopEnd = uLoopEnd;
+				pVoice->m_fLeft = 0.0f;
+				pVoice->m_fRight = 0.0f;
+				pVoice->m_eDataType = eType;
+				pVoice->m_uSampleRate = pInit->m_uSampleRate;
+				pVoice->m_uVolume = (pInit->m_uVolume<255U) ? pInit->m_uVolume : 255U;
+				pVoice->m_uPan = (pInit->m_uPan<0xFFFFU) ? pInit->m_uPan : 0xFFFFU;
+				Word uSerial = (m_uSerial+1)&0xFFFFFFU;
+				if (!uSerial) {
+					uSerial = 1;
+				}
+				m_uSerial = uSerial;
+				pVoice->m_uSerial = uSerial;
+				pVoice->m_bActive = TRUE;
+				pVoice->m_bStopping = FALSE;
+				SetGains(pVoice,TRUE);
+				uResult = (uSerial<<8U)|i;
+			}
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Stop a voice
+
+	The voice fades out over \ref RAMPLENGTH sample frames and
+	its completion function is not called.
+
+	\param uVoiceID ID returned by Play(const VoiceInit_t *)
+	\return Zero if the voice was stopped, non-zero if the voice wasn't playing
+
+***************************************/
+
+Word Burger::SoundMixer::StopVoice(Word uVoiceID)
+{
+	Word uResult = 10;
+	CriticalSectionLock Lock(&m_Lock);
+	Voice_t *pVoice = GetVoice(uVoiceID);
+	if (pVoice && !pVoice->m_bStopping) {
+		pVoice->m_bStopping = TRUE;
+		SetGains(pVoice,TRUE);
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Stop all voices
+
+	\sa StopVoice(Word)
+
+***************************************/
+
+void Burger::SoundMixer::StopAll(void)
+{
+	CriticalSectionLock Lock(&m_Lock);
+	Voice_t *pVoice = m_Voices;
+	Word i = MAXVOICES;
+	do {
+		if (pVoice->m_bActive && !pVoice->m_bStopping) {
+			pVoice->m_bStopping = TRUE;
+			SetGains(pVoice,TRUE);
+		}
+		++pVoice;
+	} while (--i);
+}
+
+/*! ************************************
+
+	\brief Test if a voice is still playing
+
+	A voice that is fading out from a call to StopVoice(Word) is
+	considered stopped.
+
+	\param uVoiceID ID returned by Play(const VoiceInit_t *)
+	\return \ref TRUE if the voice is playing
+
+***************************************/
+
+Word Burger::SoundMixer::IsVoicePlaying(Word uVoiceID)
+{
+	CriticalSectionLock Lock(&m_Lock);
+	const Voice_t *pVoice = GetVoice(uVoiceID);
+	return pVoice && !pVoice->m_bStopping;
+}
+
+/*! ************************************
+
+	\brief Change the volume of a voice
+
+	\param uVoiceID ID returned by Play(const VoiceInit_t *)
+	\param uVolume New volume (0-255)
+	\return Zero if no error, non-zero if the voice wasn't playing
+
+***************************************/
+
+Word Burger::SoundMixer::SetVoiceVolume(Word uVoiceID,Word uVolume)
+{
+	Word uResult = 10;
+	CriticalSectionLock Lock(&m_Lock);
+	Voice_t *pVoice = GetVoice(uVoiceID);
+	if (pVoice && !pVoice->m_bStopping) {
+		pVoice->m_uVolume = (uVolume<255U) ? uVolume : 255U;
+		SetGains(pVoice,TRUE);
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Change the pan of a voice
+
+	\param uVoiceID ID returned by Play(const VoiceInit_t *)
+	\param uPan New pan (0 = left, 0x8000 = center, 0xFFFF = right)
+	\return Zero if no error, non-zero if the voice wasn't playing
+
+***************************************/
+
+Word Burger::SoundMixer::SetVoicePan(Word uVoiceID,Word uPan)
+{
+	Word uResult = 10;
+	CriticalSectionLock Lock(&m_Lock);
+	Voice_t *pVoice = GetVoice(uVoiceID);
+	if (pVoice && !pVoice->m_bStopping) {
+		pVoice->m_uPan = (uPan<0xFFFFU) ? uPan : 0xFFFFU;
+		SetGains(pVoice,TRUE);
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Change the sample rate of a voice
+
+	\param uVoiceID ID returned by Play(const VoiceInit_t *)
+	\param uSampleRate New rate in samples per second
+	\return Zero if no error, non-zero if the voice wasn't playing
+
+***************************************/
+
+Word Burger::SoundMixer::SetVoiceSampleRate(Word uVoiceID,Word uSampleRate)
+{
+	Word uResult = 10;
+	CriticalSectionLock Lock(&m_Lock);
+	Voice_t *pVoice = GetVoice(uVoiceID);
+	if (pVoice) {
+		pVoice->m_uSampleRate = uSampleRate;
+		pVoice->m_uStep = GetStep(uSampleRate,m_uSampleRate);
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Set the master volume
+
+	All playing voices ramp to the new volume.
+
+	\param uVolume New volume (0-255)
+	\sa GetVolume(void) const
+
+***************************************/
+
+void Burger::SoundMixer::SetVolume(Word uVolume)
+{
+	CriticalSectionLock Lock(&m_Lock);
+	m_uVolume = (uVolume<255U) ? uVolume : 255U;
+	Voice_t *pVoice = m_Voices;
+	Word i = MAXVOICES;
+	do {
+		if (pVoice->m_bActive && !pVoice->m_bStopping) {
+			SetGains(pVoice,TRUE);
+		}
+		++pVoice;
+	} while (--i);
+}
+
+/*! ************************************
+
+	\brief Set the maximum number of voices to play
+
+	Voices that are already playing are not affected,
+	the limit only applies to calls to Play(const VoiceInit_t *).
+
+	\param uMax Number of voices (1 through \ref MAXVOICES)
+
+***************************************/
+
+void Burger::SoundMixer::SetMaxVoices(Word uMax)
+{
+	if (!uMax) {
+		uMax = 1;
+	} else if (uMax>MAXVOICES) {
+		uMax = MAXVOICES;
+	}
+	m_uMaxVoices = uMax;
+}
+
+/*! ************************************
+
+	\brief Return the number of voices playing
+
+	\return Number of voices being mixed, including ones fading out
+
+***************************************/
+
+Word Burger::SoundMixer::GetActiveVoiceCount(void)
+{
+	CriticalSectionLock Lock(&m_Lock);
+	Word uResult = 0;
+	const Voice_t *pVoice = m_Voices;
+	Word i = MAXVOICES;
+	do {
+		uResult += (pVoice->m_bActive!=0);
+		++pVoice;
+	} while (--i);
+	return uResult;
+}
+
+/*! ************************************
+
+	\fn void Burger::SoundMixer::Pause(void)
+	\brief Pause mixing
+
+	Output silence and stop advancing the voices.
+
+	\sa Resume(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::SoundMixer::Resume(void)
+	\brief Resume mixing
+
+	\sa Pause(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SoundMixer::IsPaused(void) const
+	\brief Return \ref TRUE if mixing is paused
+
+	\return \ref TRUE if paused
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SoundMixer::GetVolume(void) const
+	\brief Return the master volume
+
+	\return Volume (0-255)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SoundMixer::GetMaxVoices(void) const
+	\brief Return the maximum number of voices to play
+
+	\return Number of voices (1 through \ref MAXVOICES)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SoundMixer::GetSampleRate(void) const
+	\brief Return the output sample rate
+
+	\return Sample frames per second
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SoundMixer::GetChannels(void) const
+	\brief Return the number of output channels
+
+	\return 1 for mono, 2 for stereo
+
+***************************************/
+
+/*! ************************************
+
+	\brief Test if a data type can be mixed
+
+	PCM, u-Law and A-Law samples can be played directly since any sample
+	can be located without decoding the ones before it. ADPCM data
+	has to be decoded to 16 bit samples first with MicrosoftADPCMDecode()
+	or DVIADPCMDecode().
+
+	\param eType Type of the sample data
+	\return \ref TRUE if the mixer can play the data directly
+
+***************************************/
+
+Word BURGER_API Burger::SoundMixer::IsDataTypeSupported(Sound::DataType eType)
+{
+	return (eType==Sound::TYPEBYTE) || (eType==Sound::TYPECHAR) ||
+		(eType==Sound::TYPELSHORT) || (eType==Sound::TYPEBSHORT) ||
+		(eType==Sound::TYPEULAW) || (eType==Sound::TYPEALAW);
+}
+
+/*! ************************************
+
+	\brief Convert samples to floating point
+
+	Convert 8 or 16 bit samples to floats in the range of -1.0 to 1.0.
+	The samples don't need to be aligned. u-Law and A-Law samples
+	are expanded with their lookup tables.
+
+	\param pOutput Pointer to the buffer to receive the floats
+	\param pInput Pointer to the source samples
+	\param uCount Number of samples to convert
+	\param eType Type of the source samples
+	\sa IsDataTypeSupported(Sound::DataType)
+
+***************************************/
+
+void BURGER_API Burger::SoundMixer::ConvertToFloat(float *pOutput,const Word8 *pInput,WordPtr uCount,Sound::DataType eType)
+{
+	if (uCount) {
+		switch (eType) {
+		case Sound::TYPEBYTE:
+			do {
+				pOutput[0] = static_cast<float>(static_cast<int>(pInput[0])-128)*(1.0f/128.0f);
+				++pInput;
+				++pOutput;
+			} while (--uCount);
+			break;
+		case Sound::TYPECHAR:
+			do {
+				pOutput[0] = static_cast<float>(static_cast<Int8>(pInput[0]))*(1.0f/128.0f);
+				++pInput;
+				++pOutput;
+			} while (--uCount);
+			break;
+		case Sound::TYPELSHORT:
+#if defined(BURGER_SSE2)
+			if (uCount>=8) {
+				const __m128 vScale = _mm_set1_ps(1.0f/32768.0f);
+				do {
+					__m128i vInput = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+					// Sign extend by placing the shorts in the upper half
+					__m128i vLow = _mm_srai_epi32(_mm_unpacklo_epi16(vInput,vInput),16);
+					__m128i vHigh = _mm_srai_epi32(_mm_unpackhi_epi16(vInput,vInput),16);
+					_mm_storeu_ps(pOutput,_mm_mul_ps(_mm_cvtepi32_ps(vLow),vScale));
+					_mm_storeu_ps(pOutput+4,_mm_mul_ps(_mm_cvtepi32_ps(vHigh),vScale));
+					pInput += 16;
+					pOutput += 8;
+					uCount -= 8;
+				} while (uCount>=8);
+				if (!uCount) {
+					break;
+				}
+			}
+#elif defined(BURGER_NEON) && defined(BURGER_LITTLEENDIAN)
+			if (uCount>=8) {
+				const float32x4_t vScale = vdupq_n_f32(1.0f/32768.0f);
+				do {
+					int16x8_t vInput = vreinterpretq_s16_u8(vld1q_u8(pInput));
+					vst1q_f32(pOutput,vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(vInput))),vScale));
+					vst1q_f32(pOutput+4,vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(vInput))),vScale));
+					pInput += 16;
+					pOutput += 8;
+					uCount -= 8;
+				} while (uCount>=8);
+				if (!uCount) {
+					break;
+				}
+			}
+#endif
+			do {
+				pOutput[0] = static_cast<float>(static_cast<Int16>(pInput[0]|(pInput[1]<<8U)))*(1.0f/32768.0f);
+				pInput += 2;
+				++pOutput;
+			} while (--uCount);
+			break;
+		case Sound::TYPEBSHORT:
+			do {
+				pOutput[0] = static_cast<float>(static_cast<Int16>((pInput[0]<<8U)|pInput[1]))*(1.0f/32768.0f);
+				pInput += 2;
+				++pOutput;
+			} while (--uCount);
+			break;
+		case Sound::TYPEULAW:
+			do {
+				pOutput[0] = static_cast<float>(g_ULawToLinearTable[pInput[0]])*(1.0f/32768.0f);
+				++pInput;
+				++pOutput;
+			} while (--uCount);
+			break;
+		case Sound::TYPEALAW:
+			do {
+				pOutput[0] = static_cast<float>(g_ALawToLinearTable[pInput[0]])*(1.0f/32768.0f);
+				++pInput;
+				++pOutput;
+			} while (--uCount);
+			break;
+		default:
+			MemoryClear(pOutput,sizeof(float)*uCount);
+			break;
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Add a scaled mono buffer to a mono buffer
+
+	\param pOutput Pointer to the buffer to mix into
+	\param pInput Pointer to the samples to add
+	\param uFrameCount Number of samples
+	\param fGain Scale to apply to the input samples
+
+***************************************/
+
+void BURGER_API Burger::SoundMixer::MixMono(float *pOutput,const float *pInput,Word uFrameCount,float fGain)
+{
+#if defined(BURGER_SSE2)
+	if (uFrameCount>=4) {
+		const __m128 vGain = _mm_set1_ps(fGain);
+		do {
+			_mm_storeu_ps(pOutput,_mm_add_ps(_mm_loadu_ps(pOutput),_mm_mul_ps(_mm_loadu_ps(pInput),vGain)));
+			pInput += 4;
+			pOutput += 4;
+			uFrameCount -= 4;
+		} while (uFrameCount>=4);
+	}
+#elif defined(BURGER_NEON)
+	if (uFrameCount>=4) {
+		do {
+			vst1q_f32(pOutput,vmlaq_n_f32(vld1q_f32(pOutput),vld1q_f32(pInput),fGain));
+			pInput += 4;
+			pOutput += 4;
+			uFrameCount -= 4;
+		} while (uFrameCount>=4);
+	}
+#endif
+	if (uFrameCount) {
+		do {
+			pOutput[0] += pInput[0]*fGain;
+			++pInput;
+			++pOutput;
+		} while (--uFrameCount);
+	}
+}
+
+/*! ************************************
+
+	\brief Add a mono buffer to a stereo buffer
+
+	The output is interleaved left and right.
+
+	\param pOutput Pointer to the stereo buffer to mix into
+	\param pInput Pointer to the mono samples to add
+	\param uFrameCount Number of sample frames
+	\param fLeft Scale to apply for the left channel
+	\param fRight Scale to apply for the right channel
+
+***************************************/
+
+void BURGER_API Burger::SoundMixer::MixStereo(float *pOutput,const float *pInput,Word uFrameCount,float fLeft,float fRight)
+{
+#if defined(BURGER_SSE2)
+	if (uFrameCount>=4) {
+		const __m128 vGain = _mm_setr_ps(fLeft,fRight,fLeft,fRight);
+		do {
+			__m128 vInput = _mm_loadu_ps(pInput);
+			__m128 vLow = _mm_mul_ps(_mm_unpacklo_ps(vInput,vInput),vGain);
+			__m128 vHigh = _mm_mul_ps(_mm_unpackhi_ps(vInput,vInput),vGain);
+			_mm_storeu_ps(pOutput,_mm_add_ps(_mm_loadu_ps(pOutput),vLow));
+			_mm_storeu_ps(pOutput+4,_mm_add_ps(_mm_loadu_ps(pOutput+4),vHigh));
+			pInput += 4;
+			pOutput += 8;
+			uFrameCount -= 4;
+		} while (uFrameCount>=4);
+	}
+#elif defined(BURGER_NEON)
+	if (uFrameCount>=4) {
+		do {
+			float32x4_t vInput = vld1q_f32(pInput);
+			float32x4x2_t vMix = vld2q_f32(pOutput);
+			vMix.val[0] = vmlaq_n_f32(vMix.val[0],vInput,fLeft);
+			vMix.val[1] = vmlaq_n_f32(vMix.val[1],vInput,fRight);
+			vst2q_f32(pOutput,vMix);
+			pInput += 4;
+			pOutput += 8;
+			uFrameCount -= 4;
+		} while (uFrameCount>=4);
+	}
+#endif
+	if (uFrameCount) {
+		do {
+			pOutput[0] += pInput[0]*fLeft;
+			pOutput[1] += pInput[0]*fRight;
+			++pInput;
+			pOutput += 2;
+		} while (--uFrameCount);
+	}
+}
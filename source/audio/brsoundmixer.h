@@ -0,0 +1,166 @@
+/***************************************
+
+	Software sound mixer
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRSOUNDMIXER_H__
+#define __BRSOUNDMIXER_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRSOUND_H__
+#include "brsound.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+#ifndef __BRFILE_H__
+#include "brfile.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class SoundSink {
+	BURGER_DISABLECOPYCONSTRUCTORS(SoundSink);
+public:
+	SoundSink() {}
+	virtual ~SoundSink();
+	virtual Word Start(Word uSampleRate,Word uChannels);
+	virtual Word Write(const float *pInput,Word uFrameCount) = 0;
+	virtual void Stop(void);
+};
+
+class SoundSinkNull : public SoundSink {
+	Word64 m_uFrameCount;	///< Number of sample frames written since Start()
+	Word m_uSampleRate;		///< Sample rate the mixer is running at
+	Word m_bRealTime;		///< \ref TRUE if Write() sleeps to simulate a real audio device
+public:
+	SoundSinkNull(Word bRealTime=FALSE);
+	virtual Word Start(Word uSampleRate,Word uChannels);
+	virtual Word Write(const float *pInput,Word uFrameCount);
+	BURGER_INLINE Word64 GetFrameCount(void) const { return m_uFrameCount; }
+};
+
+class SoundSinkWaveFile : public SoundSink {
+	File m_File;			///< Output file
+	Word32 m_uDataSize;		///< Number of bytes of sample data written
+	Word m_uChannels;		///< Number of channels per sample frame
+public:
+	SoundSinkWaveFile();
+	virtual ~SoundSinkWaveFile();
+	Word Open(const char *pFileName);
+	virtual Word Start(Word uSampleRate,Word uChannels);
+	virtual Word Write(const float *pInput,Word uFrameCount);
+	virtual void Stop(void);
+	static void BURGER_API ConvertToInt16(Int16 *pOutput,const float *pInput,WordPtr uCount);
+};
+
+class SoundMixer {
+	BURGER_DISABLECOPYCONSTRUCTORS(SoundMixer);
+public:
+	enum {
+		MAXVOICES=Sound::MAXVOICECOUNT,	///< Maximum number of voices that can be mixed
+		BLOCKSIZE=256,			///< Number of sample frames mixed at a time
+		RAMPLENGTH=64,			///< Number of sample frames to ramp a volume or pan change
+		SCRATCHSIZE=1024		///< Number of source samples converted at a time
+	};
+	struct VoiceInit_t {
+		const void *m_pSamples;		///< Pointer to the sample data
+		WordPtr m_uLength;			///< Length of the sample data in bytes
+		WordPtr m_uLoopStart;		///< Sample to restart at when looping
+		WordPtr m_uLoopEnd;			///< Sample to loop at (0 for no looping)
+		Sound::CompletionProc m_pCompletion;	///< Function to call when the voice stops on its own (Can be \ref NULL)
+		void *m_pCompletionData;	///< Data passed to the completion function
+		Sound::DataType m_eDataType;	///< Type of the sample data
+		Word m_uSampleRate;			///< Samples per second
+		Word m_uVolume;				///< Volume (0-255)
+		Word m_uPan;				///< Pan (0 = left, 0x8000 = center, 0xFFFF = right)
+	};
+private:
+	struct Voice_t {
+		const Word8 *m_pSamples;	///< Pointer to the sample data
+		Sound::CompletionProc m_pCompletion;	///< Function to call when the voice ends
+		void *m_pCompletionData;	///< Data passed to the completion function
+		Word64 m_uPosition;			///< Current sample in 32.32 fixed point
+		Word64 m_uStep;				///< Source samples per output frame in 32.32 fixed point
+		WordPtr m_uSampleCount;		///< Number of samples in the data
+		WordPtr m_uLoopStart;		///< Sample to restart at when looping
+		WordPtr m_uLoopEnd;			///< Sample to loop at (0 for no looping)
+		float m_fLeft;				///< Current left gain
+		float m_fRight;				///< Current right gain
+		float m_fLeftStep;			///< Left gain change per frame while ramping
+		float m_fRightStep;			///< Right gain change per frame while ramping
+		Sound::DataType m_eDataType;	///< Type of the sample data
+		Word m_uRampCount;			///< Number of frames left to ramp
+		Word m_uSampleRate;			///< Samples per second
+		Word m_uVolume;				///< Volume (0-255)
+		Word m_uPan;				///< Pan (0 = left, 0x8000 = center, 0xFFFF = right)
+		Word m_uSerial;				///< Serial number to detect stale voice IDs
+		Word m_bActive;				///< \ref TRUE if the voice is playing
+		Word m_bStopping;			///< \ref TRUE if the voice is fading out to stop
+	};
+	CriticalSection m_Lock;			///< Lock for the voices
+	Thread m_Thread;				///< Mixer thread
+	SoundSink *m_pSink;				///< Output for mixed samples
+	float *m_pBus;					///< Mixing buffer
+	float *m_pScratch;				///< Buffer for converted source samples
+	float *m_pResampled;			///< Buffer for resampled voice data
+	Word m_uSampleRate;				///< Output samples per second
+	Word m_uChannels;				///< Output channels (1 or 2)
+	Word m_uMaxVoices;				///< Maximum number of voices to play
+	Word m_uVolume;					///< Master volume (0-255)
+	Word m_uSerial;					///< Next voice serial number
+	volatile Word m_bQuit;			///< \ref TRUE when the mixer thread is to exit
+	Word m_bPaused;					///< \ref TRUE if mixing is paused
+	Word m_bStarted;				///< \ref TRUE if the mixer thread is running
+	Voice_t m_Voices[MAXVOICES];	///< Voices to mix
+	Voice_t *GetVoice(Word uVoiceID);
+	void SetGains(Voice_t *pVoice,Word bRamp) const;
+	Word MixVoice(Voice_t *pVoice,Word uFrameCount);
+	static WordPtr BURGER_API MixerThread(void *pThis);
+public:
+	SoundMixer();
+	~SoundMixer();
+	Word Init(SoundSink *pSink,Word uSampleRate=44100,Word uChannels=2);
+	void Shutdown(void);
+	Word Start(void);
+	void Stop(void);
+	void Mix(float *pOutput,Word uFrameCount);
+	Word Play(const VoiceInit_t *pInit);
+	Word StopVoice(Word uVoiceID);
+	void StopAll(void);
+	Word IsVoicePlaying(Word uVoiceID);
+	Word SetVoiceVolume(Word uVoiceID,Word uVolume);
+	Word SetVoicePan(Word uVoiceID,Word uPan);
+	Word SetVoiceSampleRate(Word uVoiceID,Word uSampleRate);
+	void SetVolume(Word uVolume);
+	BURGER_INLINE Word GetVolume(void) const { return m_uVolume; }
+	void SetMaxVoices(Word uMax);
+	BURGER_INLINE Word GetMaxVoices(void) const { return m_uMaxVoices; }
+	Word GetActiveVoiceCount(void);
+	BURGER_INLINE void Pause(void) { m_bPaused = TRUE; }
+	BURGER_INLINE void Resume(void) { m_bPaused = FALSE; }
+	BURGER_INLINE Word IsPaused(void) const { return m_bPaused; }
+	BURGER_INLINE Word GetSampleRate(void) const { return m_uSampleRate; }
+	BURGER_INLINE Word GetChannels(void) const { return m_uChannels; }
+	static Word BURGER_API IsDataTypeSupported(Sound::DataType eType);
+	static void BURGER_API ConvertToFloat(float *pOutput,const Word8 *pInput,WordPtr uCount,Sound::DataType eType);
+	static void BURGER_API MixMono(float *pOutput,const float *pInput,Word uFrameCount,float fGain);
+	static void BURGER_API MixStereo(float *pOutput,const float *pInput,Word uFrameCount,float fLeft,float fRight);
+};
+}
+/* END */
+
+#endif
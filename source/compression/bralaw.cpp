@@ -0,0 +1,174 @@
+/***************************************
+
+	A-Law decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "bralaw.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
+/*! ************************************
+
+	\var Burger::g_ALawToLinearTable
+	\brief Table to convert A-Law samples to 16 bit linear samples
+
+	A-Law is the ITU G.711 logarithmic encoding used by European
+	telephony. Each 8 bit value has its even bits inverted and contains
+	a sign bit, a 3 bit exponent and a 4 bit mantissa. The table contains
+	the decoded values scaled to the full range of a signed 16 bit sample.
+
+	\sa ALawToLinear(Word) or ALawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+const Int16 Burger::g_ALawToLinearTable[256] = {
+	 -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736,
+	 -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784,
+	 -2752, -2624, -3008, -2880, -2240, -2112, -2496, -2368,
+	 -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392,
+	-22016,-20992,-24064,-23040,-17920,-16896,-19968,-18944,
+	-30208,-29184,-32256,-31232,-26112,-25088,-28160,-27136,
+	-11008,-10496,-12032,-11520, -8960, -8448, -9984, -9472,
+	-15104,-14592,-16128,-15616,-13056,-12544,-14080,-13568,
+	  -344,  -328,  -376,  -360,  -280,  -264,  -312,  -296,
+	  -472,  -456,  -504,  -488,  -408,  -392,  -440,  -424,
+	   -88,   -72,  -120,  -104,   -24,    -8,   -56,   -40,
+	  -216,  -200,  -248,  -232,  -152,  -136,  -184,  -168,
+	 -1376, -1312, -1504, -1440, -1120, -1056, -1248, -1184,
+	 -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696,
+	  -688,  -656,  -752,  -720,  -560,  -528,  -624,  -592,
+	  -944,  -912, -1008,  -976,  -816,  -784,  -880,  -848,
+	  5504,  5248,  6016,  5760,  4480,  4224,  4992,  4736,
+	  7552,  7296,  8064,  7808,  6528,  6272,  7040,  6784,
+	  2752,  2624,  3008,  2880,  2240,  2112,  2496,  2368,
+	  3776,  3648,  4032,  3904,  3264,  3136,  3520,  3392,
+	 22016, 20992, 24064, 23040, 17920, 16896, 19968, 18944,
+	 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136,
+	 11008, 10496, 12032, 11520,  8960,  8448,  9984,  9472,
+	 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568,
+	   344,   328,   376,   360,   280,   264,   312,   296,
+	   472,   456,   504,   488,   408,   392,   440,   424,
+	    88,    72,   120,   104,    24,     8,    56,    40,
+	   216,   200,   248,   232,   152,   136,   184,   168,
+	  1376,  1312,  1504,  1440,  1120,  1056,  1248,  1184,
+	  1888,  1824,  2016,  1952,  1632,  1568,  1760,  1696,
+	   688,   656,   752,   720,   560,   528,   624,   592,
+	   944,   912,  1008,   976,   816,   784,   880,   848
+};
+
+/*! ************************************
+
+	\fn Int16 Burger::ALawToLinear(Word uInput)
+	\brief Convert an A-Law sample to a 16 bit linear sample
+
+	\param uInput A-Law encoded sample (Only the lower 8 bits are used)
+	\return Signed 16 bit sample
+	\sa ALawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Decompress A-Law audio to 16 bit samples
+
+	Convert a buffer of A-Law samples to signed 16 bit samples
+	in native endian. Since every sample is a single byte, interleaved
+	multi-channel data is converted in place to interleaved 16 bit
+	samples.
+
+	On SSE2 and NEON targets, 16 samples are decoded at a time
+	by computing the G.711 expansion in parallel, the results are
+	identical to g_ALawToLinearTable.
+
+	\param pInput Pointer to the A-Law samples
+	\param pOutput Pointer to the buffer to receive uCount 16 bit samples
+	\param uCount Number of samples to convert
+	\sa ALawToLinear(Word) or ULawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+#if defined(BURGER_SSE2)
+static BURGER_INLINE __m128i ALawExpand8(__m128i vInput)
+{
+	// vInput has A-Law bytes with the even bits flipped in the lower 8 bits of each lane
+	const __m128i vZero = _mm_setzero_si128();
+	__m128i vExponent = _mm_srli_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x70)),4);
+	// The first segment has no implied leading bit
+	__m128i vMask = _mm_cmpeq_epi16(vExponent,vZero);
+	__m128i vTemp = _mm_slli_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x0F)),4);
+	vTemp = _mm_add_epi16(vTemp,_mm_or_si128(_mm_and_si128(vMask,_mm_set1_epi16(8)),_mm_andnot_si128(vMask,_mm_set1_epi16(0x108))));
+	// Shift left by the exponent minus one, one bit at a time
+	vExponent = _mm_subs_epu16(vExponent,_mm_set1_epi16(1));
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vExponent,_mm_set1_epi16(1)),_mm_set1_epi16(1));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,1)),_mm_andnot_si128(vMask,vTemp));
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vExponent,_mm_set1_epi16(2)),_mm_set1_epi16(2));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,2)),_mm_andnot_si128(vMask,vTemp));
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vExponent,_mm_set1_epi16(4)),_mm_set1_epi16(4));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,4)),_mm_andnot_si128(vMask,vTemp));
+	// A set sign bit is positive
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x80)),vZero);
+	return _mm_sub_epi16(_mm_xor_si128(vTemp,vMask),vMask);
+}
+#elif defined(BURGER_NEON)
+static BURGER_INLINE int16x8_t ALawExpand8(uint16x8_t vInput)
+{
+	// vInput has A-Law bytes with the even bits flipped in the lower 8 bits of each lane
+	uint16x8_t vExponent = vandq_u16(vshrq_n_u16(vInput,4),vdupq_n_u16(7));
+	uint16x8_t vMask = vceqq_u16(vExponent,vdupq_n_u16(0));
+	int16x8_t vTemp = vreinterpretq_s16_u16(vshlq_n_u16(vandq_u16(vInput,vdupq_n_u16(0x0F)),4));
+	vTemp = vaddq_s16(vTemp,vbslq_s16(vMask,vdupq_n_s16(8),vdupq_n_s16(0x108)));
+	vTemp = vshlq_s16(vTemp,vreinterpretq_s16_u16(vqsubq_u16(vExponent,vdupq_n_u16(1))));
+	vMask = vtstq_u16(vInput,vdupq_n_u16(0x80));
+	return vbslq_s16(vMask,vTemp,vnegq_s16(vTemp));
+}
+#endif
+
+void BURGER_API Burger::ALawExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uCount)
+{
+#if defined(BURGER_SSE2)
+	if (uCount>=16) {
+		const __m128i vFlip = _mm_set1_epi8(0x55);
+		const __m128i vZero = _mm_setzero_si128();
+		do {
+			__m128i vInput = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)),vFlip);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),ALawExpand8(_mm_unpacklo_epi8(vInput,vZero)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput+8),ALawExpand8(_mm_unpackhi_epi8(vInput,vZero)));
+			pInput += 16;
+			pOutput += 16;
+			uCount -= 16;
+		} while (uCount>=16);
+	}
+#elif defined(BURGER_NEON)
+	if (uCount>=16) {
+		const uint8x16_t vFlip = vdupq_n_u8(0x55);
+		do {
+			uint8x16_t vInput = veorq_u8(vld1q_u8(pInput),vFlip);
+			vst1q_s16(pOutput,ALawExpand8(vmovl_u8(vget_low_u8(vInput))));
+			vst1q_s16(pOutput+8,ALawExpand8(vmovl_u8(vget_high_u8(vInput))));
+			pInput += 16;
+			pOutput += 16;
+			uCount -= 16;
+		} while (uCount>=16);
+	}
+#endif
+	if (uCount) {
+		const Int16 *pTable = g_ALawToLinearTable;
+		do {
+			pOutput[0] = pTable[pInput[0]];
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
@@ -0,0 +1,29 @@
+/***************************************
+
+	A-Law decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRALAW_H__
+#define __BRALAW_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+extern const Int16 g_ALawToLinearTable[256];
+BURGER_INLINE Int16 ALawToLinear(Word uInput) { return g_ALawToLinearTable[uInput&0xFFU]; }
+extern void BURGER_API ALawExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uCount);
+}
+/* END */
+
+#endif
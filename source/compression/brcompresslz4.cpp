@@ -0,0 +1,634 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcompresslz4.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brendian.h"
+
+/*! ************************************
+
+	\class Burger::CompressLZ4
+	\brief Compress data using LZ4 encoding
+
+	LZ4 is a byte aligned Lempel Ziv encoding that trades some
+	compression for very fast decompression. It's explained here.
+
+	http://en.wikipedia.org/wiki/LZ4_(compression_algorithm)
+
+	The data is split into 64K blocks and each block is encoded as
+	a series of sequences. Each sequence starts with a token byte, the
+	upper 4 bits are the number of literal bytes and the lower 4 bits
+	are the length of the string match minus 4. A value of 15 means the
+	length continues with bytes that are added to it until a byte that's
+	not 255 is found. The literal bytes follow, then a 16 bit little endian
+	distance back into the output for the match and then the extra match
+	length bytes, if any. The last sequence of a block only has literals.
+
+	The frame is a 4 byte header followed by blocks and
+	a 32 bit zero to mark the end.
+
+	* Byte 0, version, always 1
+	* Byte 1, flags, 0x01 if blocks are independent
+	* Byte 2, block size as a power of 2 (16 to 22)
+	* Byte 3, reserved, always 0
+
+	Each block starts with a 32 bit little endian size. If the high bit is
+	set, the data is stored without compression and the size is
+	the number of bytes that follow. Otherwise, the size
+	is the number of compressed bytes and it's followed by
+	a 32 bit little endian size of the decompressed data.
+
+	By default, matches can reference the previous block. With
+	SetIndependentBlocks(\ref TRUE), each block only references
+	itself, so blocks can be decompressed in any order.
+
+	By default, a single hash table lookup is used to find
+	matches. With SetHighCompression(\ref TRUE), hash chains
+	are searched for the longest match and a match is
+	skipped if a longer one starts at the next byte.
+	This is much slower to compress, but makes
+	smaller data that decompresses at the same speed.
+
+	\sa Burger::DecompressLZ4
+
+***************************************/
+
+/***************************************
+
+	Hash 4 bytes to an index
+
+***************************************/
+
+static BURGER_INLINE Word HashSequence(Word32 uInput,Word uHashLog)
+{
+	return static_cast<Word>((uInput*2654435761U)>>(32U-uHashLog));
+}
+
+/***************************************
+
+	Return the number of bytes that match
+	from pInput up to pLimit
+
+***************************************/
+
+static WordPtr MatchLength(const Word8 *pInput,const Word8 *pMatch,const Word8 *pLimit)
+{
+	const Word8 *pStart = pInput;
+	while (((pInput+4)<=pLimit) &&
+		(Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput))==Burger::LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pMatch)))) {
+		pInput+=4;
+		pMatch+=4;
+	}
+	while ((pInput<pLimit) && (pInput[0]==pMatch[0])) {
+		++pInput;
+		++pMatch;
+	}
+	return static_cast<WordPtr>(pInput-pStart);
+}
+
+/***************************************
+
+	Output the bytes for the part of a length
+	that didn't fit in the token
+
+***************************************/
+
+static BURGER_INLINE Word8 *OutputLength(Word8 *pOutput,WordPtr uLength)
+{
+	while (uLength>=255) {
+		pOutput[0] = 255;
+		++pOutput;
+		uLength -= 255;
+	}
+	pOutput[0] = static_cast<Word8>(uLength);
+	return pOutput+1;
+}
+
+/***************************************
+
+	Output literals and an optional match
+
+***************************************/
+
+static Word8 *OutputSequence(Word8 *pOutput,const Word8 *pLiterals,WordPtr uLiteralLength,WordPtr uOffset,WordPtr uMatchLength)
+{
+	Word8 *pToken = pOutput;
+	++pOutput;
+	Word uToken;
+	if (uLiteralLength>=15) {
+		uToken = 15U<<4U;
+		pOutput = OutputLength(pOutput,uLiteralLength-15);
+	} else {
+		uToken = static_cast<Word>(uLiteralLength<<4U);
+	}
+	Burger::MemoryCopy(pOutput,pLiterals,uLiteralLength);
+	pOutput += uLiteralLength;
+
+	// Is there a match?
+	if (uMatchLength) {
+		pOutput[0] = static_cast<Word8>(uOffset);
+		pOutput[1] = static_cast<Word8>(uOffset>>8U);
+		pOutput += 2;
+		uMatchLength -= Burger::DecompressLZ4::MINMATCH;
+		if (uMatchLength>=15) {
+			uToken |= 15U;
+			pOutput = OutputLength(pOutput,uMatchLength-15);
+		} else {
+			uToken |= static_cast<Word>(uMatchLength);
+		}
+	}
+	pToken[0] = static_cast<Word8>(uToken);
+	return pOutput;
+}
+
+/*! ************************************
+
+	\brief Initialize the compressor to defaults
+
+	Fast compression with linked blocks is the default.
+
+***************************************/
+
+Burger::CompressLZ4::CompressLZ4(void) :
+	Compress(),
+	m_pBuffer(NULL),
+	m_pPacked(NULL),
+	m_pHashTable(NULL),
+	m_pChainTable(NULL),
+	m_uBlockLength(0),
+	m_uNextToUpdate(BLOCKSIZE),
+	m_bHeaderSent(FALSE),
+	m_bHistory(FALSE),
+	m_bLinked(TRUE),
+	m_bHighCompression(FALSE),
+	m_bIndependentBlocks(FALSE)
+{
+	reinterpret_cast<Word32 *>(m_uSignature)[0] = Signature;
+}
+
+/*! ************************************
+
+	\brief Release the compression buffers
+
+***************************************/
+
+Burger::CompressLZ4::~CompressLZ4()
+{
+	Free(m_pChainTable);
+	Free(m_pHashTable);
+	Free(m_pPacked);
+	Free(m_pBuffer);
+}
+
+/***************************************
+
+	Allocate the buffers on first use
+
+	Returns TRUE if out of memory
+
+***************************************/
+
+Word Burger::CompressLZ4::AllocBuffers(void)
+{
+	if (!m_pBuffer) {
+		m_pBuffer = static_cast<Word8 *>(Alloc(BLOCKSIZE*2));
+		if (!m_pBuffer) {
+			return TRUE;
+		}
+	}
+	if (!m_pPacked) {
+		// Worst case size for incompressible data
+		m_pPacked = static_cast<Word8 *>(Alloc(BLOCKSIZE+(BLOCKSIZE/255)+16));
+		if (!m_pPacked) {
+			return TRUE;
+		}
+	}
+	if (!m_pHashTable) {
+		m_pHashTable = static_cast<Word32 *>(AllocClear(sizeof(Word32)<<HASHLOGHIGH));
+		if (!m_pHashTable) {
+			return TRUE;
+		}
+	}
+	if (m_bHighCompression && !m_pChainTable) {
+		m_pChainTable = static_cast<Word16 *>(AllocClear(sizeof(Word16)*65536));
+		if (!m_pChainTable) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/***************************************
+
+	Compress a block using one hash table lookup
+	for each position, skipping ahead faster
+	while no matches are found
+
+***************************************/
+
+WordPtr Burger::CompressLZ4::EncodeFast(WordPtr uLength,Word32 uLowLimit)
+{
+	const Word8 *pBase = m_pBuffer;
+	const Word8 *pInput = pBase+BLOCKSIZE;
+	const Word8 *pEnd = pInput+uLength;
+	const Word8 *pAnchor = pInput;
+	Word8 *pOutput = m_pPacked;
+
+	if (uLength>MFLIMIT) {
+		const Word8 *pLimit = pEnd-MFLIMIT;
+		const Word8 *pMatchLimit = pEnd-LASTLITERALS;
+		const Word8 *pLowest = pBase+uLowLimit;
+		Word32 *pHashTable = m_pHashTable;
+		for (;;) {
+			// Find a match
+			const Word8 *pMatch;
+			Word uSearch = 1U<<SKIPSTRENGTH;
+			for (;;) {
+				if (pInput>=pLimit) {
+					goto LastLiterals;
+				}
+				Word32 uSequence = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput));
+				Word32 *pSlot = &pHashTable[HashSequence(uSequence,HASHLOGFAST)];
+				Word32 uCandidate = pSlot[0];
+				Word32 uPosition = static_cast<Word32>(pInput-pBase);
+				pSlot[0] = uPosition;
+				if ((uCandidate>=uLowLimit) && ((uPosition-uCandidate-1U)<DecompressLZ4::MAXOFFSET) &&
+					(LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pBase+uCandidate))==uSequence)) {
+					pMatch = pBase+uCandidate;
+					break;
+				}
+				pInput += uSearch>>SKIPSTRENGTH;
+				++uSearch;
+			}
+
+			// Include any matching bytes before the match
+			while ((pInput>pAnchor) && (pMatch>pLowest) && (pInput[-1]==pMatch[-1])) {
+				--pInput;
+				--pMatch;
+			}
+			WordPtr uMatchLength = MatchLength(pInput+DecompressLZ4::MINMATCH,pMatch+DecompressLZ4::MINMATCH,pMatchLimit)+DecompressLZ4::MINMATCH;
+			pOutput = OutputSequence(pOutput,pAnchor,static_cast<WordPtr>(pInput-pAnchor),static_cast<WordPtr>(pInput-pMatch),uMatchLength);
+			pInput += uMatchLength;
+			pAnchor = pInput;
+
+			// Add a position from inside the match to help the next search
+			if (pInput<pLimit) {
+				pHashTable[HashSequence(LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput-2)),HASHLOGFAST)] = static_cast<Word32>((pInput-2)-pBase);
+			}
+		}
+	}
+LastLiterals:
+	pOutput = OutputSequence(pOutput,pAnchor,static_cast<WordPtr>(pEnd-pAnchor),0,0);
+	return static_cast<WordPtr>(pOutput-m_pPacked);
+}
+
+/***************************************
+
+	Add all positions up to uPosition
+	to the hash chains
+
+***************************************/
+
+void Burger::CompressLZ4::InsertChain(Word32 uPosition)
+{
+	const Word8 *pBase = m_pBuffer;
+	Word32 *pHashTable = m_pHashTable;
+	Word16 *pChainTable = m_pChainTable;
+	Word32 uNext = m_uNextToUpdate;
+	while (uNext<uPosition) {
+		Word32 *pSlot = &pHashTable[HashSequence(LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pBase+uNext)),HASHLOGHIGH)];
+		Word32 uDelta = uNext-pSlot[0];
+		// Zero ends the chain
+		if (uDelta>DecompressLZ4::MAXOFFSET) {
+			uDelta = 0;
+		}
+		pChainTable[uNext&0xFFFFU] = static_cast<Word16>(uDelta);
+		pSlot[0] = uNext;
+		++uNext;
+	}
+	m_uNextToUpdate = uNext;
+}
+
+/***************************************
+
+	Search the hash chain for the longest match
+
+	Returns zero if no match was found
+
+***************************************/
+
+WordPtr Burger::CompressLZ4::FindLongestMatch(const Word8 *pInput,const Word8 *pMatchLimit,Word32 uLowLimit,const Word8 **ppMatch)
+{
+	const Word8 *pBase = m_pBuffer;
+	Word32 uPosition = static_cast<Word32>(pInput-pBase);
+	InsertChain(uPosition);
+
+	WordPtr uMaxLength = static_cast<WordPtr>(pMatchLimit-pInput);
+	WordPtr uBest = 0;
+	Word32 uSequence = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pInput));
+	Word32 uCandidate = m_pHashTable[HashSequence(uSequence,HASHLOGHIGH)];
+	Word uAttempts = MAXATTEMPTS;
+	while ((uCandidate>=uLowLimit) && ((uPosition-uCandidate-1U)<DecompressLZ4::MAXOFFSET)) {
+		const Word8 *pMatch = pBase+uCandidate;
+		// Only check matches that could be longer
+		if ((pMatch[uBest]==pInput[uBest]) && (LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pMatch))==uSequence)) {
+			WordPtr uLength = MatchLength(pInput+DecompressLZ4::MINMATCH,pMatch+DecompressLZ4::MINMATCH,pMatchLimit)+DecompressLZ4::MINMATCH;
+			if (uLength>uBest) {
+				uBest = uLength;
+				ppMatch[0] = pMatch;
+				if (uLength==uMaxLength) {
+					break;
+				}
+			}
+		}
+		if (!--uAttempts) {
+			break;
+		}
+		Word uDelta = m_pChainTable[uCandidate&0xFFFFU];
+		if (!uDelta) {
+			break;
+		}
+		uCandidate -= uDelta;
+	}
+	return uBest;
+}
+
+/***************************************
+
+	Compress a block by searching the hash chains for
+	the longest match and checking if a longer
+	match starts at the next byte
+
+***************************************/
+
+WordPtr Burger::CompressLZ4::EncodeHigh(WordPtr uLength,Word32 uLowLimit)
+{
+	const Word8 *pInput = m_pBuffer+BLOCKSIZE;
+	const Word8 *pEnd = pInput+uLength;
+	const Word8 *pAnchor = pInput;
+	Word8 *pOutput = m_pPacked;
+	if (m_uNextToUpdate<uLowLimit) {
+		m_uNextToUpdate = uLowLimit;
+	}
+
+	if (uLength>MFLIMIT) {
+		const Word8 *pLimit = pEnd-MFLIMIT;
+		const Word8 *pMatchLimit = pEnd-LASTLITERALS;
+		while (pInput<pLimit) {
+			const Word8 *pMatch;
+			WordPtr uMatchLength = FindLongestMatch(pInput,pMatchLimit,uLowLimit,&pMatch);
+			if (!uMatchLength) {
+				++pInput;
+				continue;
+			}
+			// Is there a better match at the next byte?
+			while ((pInput+1)<pLimit) {
+				const Word8 *pNextMatch;
+				WordPtr uNextLength = FindLongestMatch(pInput+1,pMatchLimit,uLowLimit,&pNextMatch);
+				if (uNextLength<=uMatchLength) {
+					break;
+				}
+				++pInput;
+				uMatchLength = uNextLength;
+				pMatch = pNextMatch;
+			}
+			pOutput = OutputSequence(pOutput,pAnchor,static_cast<WordPtr>(pInput-pAnchor),static_cast<WordPtr>(pInput-pMatch),uMatchLength);
+			pInput += uMatchLength;
+			pAnchor = pInput;
+		}
+	}
+	pOutput = OutputSequence(pOutput,pAnchor,static_cast<WordPtr>(pEnd-pAnchor),0,0);
+	return static_cast<WordPtr>(pOutput-m_pPacked);
+}
+
+/***************************************
+
+	Compress the block in the buffer and append it
+	to the output stream
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::CompressBlock(void)
+{
+	if (AllocBuffers()) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	WordPtr uLength = m_uBlockLength;
+	const Word8 *pBlock = m_pBuffer+BLOCKSIZE;
+	// Matches can go back into the previous block if linked
+	Word32 uLowLimit = (m_bLinked && m_bHistory) ? 1U : BLOCKSIZE;
+	WordPtr uPacked;
+	if (m_bHighCompression) {
+		uPacked = EncodeHigh(uLength,uLowLimit);
+	} else {
+		uPacked = EncodeFast(uLength,uLowLimit);
+	}
+
+	Word uError;
+	if (uPacked<uLength) {
+		uError = m_Output.Append(static_cast<Word32>(uPacked));
+		uError |= m_Output.Append(static_cast<Word32>(uLength));
+		uError |= m_Output.Append(m_pPacked,uPacked);
+	} else {
+		// Incompressible, store it
+		uError = m_Output.Append(static_cast<Word32>(uLength|DecompressLZ4::BLOCKSTORED));
+		uError |= m_Output.Append(pBlock,uLength);
+	}
+
+	// The block becomes the history for the next block
+	if (m_bLinked) {
+		MemoryCopy(m_pBuffer,pBlock,uLength);
+	}
+	Word32 *pHashTable = m_pHashTable;
+	Word uCount = 1U<<HASHLOGHIGH;
+	do {
+		Word32 uPosition = pHashTable[0];
+		pHashTable[0] = (uPosition>=BLOCKSIZE) ? uPosition-BLOCKSIZE : 0;
+		++pHashTable;
+	} while (--uCount);
+	m_uNextToUpdate = (m_uNextToUpdate>=BLOCKSIZE) ? m_uNextToUpdate-BLOCKSIZE : 0;
+	m_bHistory = TRUE;
+	m_uBlockLength = 0;
+	if (uError) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	return COMPRESS_OKAY;
+}
+
+/***************************************
+
+	Output the frame header, the block
+	mode is fixed for the rest of the frame
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::SendHeader(void)
+{
+	m_bHeaderSent = TRUE;
+	m_bLinked = !m_bIndependentBlocks;
+	Word8 Header[DecompressLZ4::FRAMEHEADERSIZE];
+	Header[0] = DecompressLZ4::FRAMEVERSION;
+	Header[1] = static_cast<Word8>(m_bLinked ? 0U : static_cast<Word>(DecompressLZ4::FRAMEINDEPENDENT));
+	Header[2] = static_cast<Word8>(BLOCKSHIFT);
+	Header[3] = 0;
+	if (m_Output.Append(Header,sizeof(Header))) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Initialize the compressor
+
+	Clear the output and prepare for a new frame. The
+	settings from SetHighCompression() and SetIndependentBlocks()
+	are retained.
+
+	\return Compress::COMPRESS_OKAY (No error is possible)
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Init(void)
+{
+	// Clear any previous output
+	m_Output.Clear();
+	m_uBlockLength = 0;
+	m_uNextToUpdate = BLOCKSIZE;
+	m_bHeaderSent = FALSE;
+	m_bHistory = FALSE;
+	if (m_pHashTable) {
+		MemoryClear(m_pHashTable,sizeof(Word32)<<HASHLOGHIGH);
+	}
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Compress data using LZ4
+
+	Data is compressed each time a 64K block is filled.
+
+	\param pInput Pointer to the data to compress
+	\param uInputLength Number of bytes to compress
+	\return Compress::COMPRESS_OKAY or Compress::COMPRESS_OUTOFMEMORY
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Process(const void *pInput,WordPtr uInputLength)
+{
+	if (!m_bHeaderSent) {
+		if (SendHeader()) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+	}
+	if (uInputLength) {
+		if (AllocBuffers()) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+		do {
+			WordPtr uChunk = BLOCKSIZE-m_uBlockLength;
+			if (uChunk>uInputLength) {
+				uChunk = uInputLength;
+			}
+			MemoryCopy(m_pBuffer+BLOCKSIZE+m_uBlockLength,pInput,uChunk);
+			pInput = static_cast<const Word8 *>(pInput)+uChunk;
+			uInputLength -= uChunk;
+			m_uBlockLength += uChunk;
+			if (m_uBlockLength==BLOCKSIZE) {
+				eError uError = CompressBlock();
+				if (uError) {
+					return uError;
+				}
+			}
+		} while (uInputLength);
+	}
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Finish the LZ4 frame
+
+	Compress the partial block, if any, and
+	mark the end of the frame.
+
+	\return Compress::COMPRESS_OKAY or Compress::COMPRESS_OUTOFMEMORY
+
+***************************************/
+
+Burger::Compress::eError Burger::CompressLZ4::Finalize(void)
+{
+	if (!m_bHeaderSent) {
+		if (SendHeader()) {
+			return COMPRESS_OUTOFMEMORY;
+		}
+	}
+	if (m_uBlockLength) {
+		eError uError = CompressBlock();
+		if (uError) {
+			return uError;
+		}
+	}
+	if (m_Output.Append(static_cast<Word32>(0))) {
+		return COMPRESS_OUTOFMEMORY;
+	}
+	return COMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\fn void Burger::CompressLZ4::SetHighCompression(Word bEnable)
+	\brief Enable the slower, smaller compression mode
+
+	The change takes effect with the next block that's compressed.
+
+	\param bEnable \ref TRUE to search hash chains for the longest match, \ref FALSE for a single lookup
+	\sa GetHighCompression(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZ4::GetHighCompression(void) const
+	\brief Return \ref TRUE if high compression is enabled
+
+	\return \ref TRUE if the hash chains are searched
+	\sa SetHighCompression(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::CompressLZ4::SetIndependentBlocks(Word bEnable)
+	\brief Create blocks that don't reference previous blocks
+
+	Independent blocks compress slightly worse, but each
+	block can be decoded on its own with Burger::DecompressLZ4::DecodeBlock().
+	The change takes effect with the next frame.
+
+	\param bEnable \ref TRUE for independent blocks
+	\sa GetIndependentBlocks(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::CompressLZ4::GetIndependentBlocks(void) const
+	\brief Return \ref TRUE if blocks are independent
+
+	\return \ref TRUE if new frames have independent blocks
+	\sa SetIndependentBlocks(Word)
+
+***************************************/
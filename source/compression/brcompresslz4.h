@@ -0,0 +1,86 @@
+/***************************************
+
+	Compress using LZ4
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRCOMPRESSLZ4_H__
+#define __BRCOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRBASE_H__
+#include "brbase.h"
+#endif
+
+#ifndef __BROUTPUTMEMORYSTREAM_H__
+#include "broutputmemorystream.h"
+#endif
+
+#ifndef __BRCOMPRESS_H__
+#include "brcompress.h"
+#endif
+
+#ifndef __BRDECOMPRESSLZ4_H__
+#include "brdecompresslz4.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class CompressLZ4 : public Compress {
+	BURGER_DISABLECOPYCONSTRUCTORS(CompressLZ4);
+	static const Word BLOCKSHIFT=16;			///< Size of a block as a power of 2
+	static const Word BLOCKSIZE=1U<<BLOCKSHIFT;	///< Bytes of input compressed at a time
+	static const Word HASHLOGFAST=12;			///< Hash table size as a power of 2 for fast compression
+	static const Word HASHLOGHIGH=15;			///< Hash table size as a power of 2 for high compression
+	static const Word SKIPSTRENGTH=6;			///< Speed up scanning of incompressible data
+	static const Word MFLIMIT=12;				///< A match must start this many bytes before the end of a block
+	static const Word LASTLITERALS=5;			///< A block always ends with this many literals
+	static const Word MAXATTEMPTS=256;			///< Maximum number of hash chain entries searched for high compression
+	Word8 *m_pBuffer;				///< Previous block followed by the block being filled
+	Word8 *m_pPacked;				///< Buffer for a compressed block
+	Word32 *m_pHashTable;			///< Most recent position for each hash of 4 bytes
+	Word16 *m_pChainTable;			///< Distance to the previous position with the same hash (High compression only)
+	WordPtr m_uBlockLength;			///< Number of bytes in the block being filled
+	Word32 m_uNextToUpdate;			///< Next position to add to m_pChainTable
+	Word m_bHeaderSent;				///< \ref TRUE if the frame header was output
+	Word m_bHistory;				///< \ref TRUE if the previous block is in m_pBuffer
+	Word m_bLinked;					///< \ref TRUE if the frame being output has linked blocks
+	Word m_bHighCompression;		///< \ref TRUE for the slower hash chain search
+	Word m_bIndependentBlocks;		///< \ref TRUE if blocks don't reference previous blocks
+	Word AllocBuffers(void);
+	WordPtr EncodeFast(WordPtr uLength,Word32 uLowLimit);
+	WordPtr EncodeHigh(WordPtr uLength,Word32 uLowLimit);
+	void InsertChain(Word32 uPosition);
+	WordPtr FindLongestMatch(const Word8 *pInput,const Word8 *pMatchLimit,Word32 uLowLimit,const Word8 **ppMatch);
+	eError CompressBlock(void);
+	eError SendHeader(void);
+public:
+#if defined(BURGER_BIGENDIAN)
+	static const Word32 Signature = 0x4C5A3442;		///< 'LZ4B'
+#else
+	static const Word32 Signature = 0x42345A4C;		///< 'LZ4B'
+#endif
+	CompressLZ4(void);
+	virtual ~CompressLZ4();
+	virtual eError Init(void);
+	virtual eError Process(const void *pInput,WordPtr uInputLength);
+	virtual eError Finalize(void);
+	BURGER_INLINE void SetHighCompression(Word bEnable) { m_bHighCompression = bEnable; }
+	BURGER_INLINE Word GetHighCompression(void) const { return m_bHighCompression; }
+	BURGER_INLINE void SetIndependentBlocks(Word bEnable) { m_bIndependentBlocks = bEnable; }
+	BURGER_INLINE Word GetIndependentBlocks(void) const { return m_bIndependentBlocks; }
+};
+}
+/* END */
+
+#endif
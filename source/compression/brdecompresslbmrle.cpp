@@ -12,6 +12,14 @@
 ***************************************/
 
 #include "brdecompresslbmrle.h"
+#include "brstringfunctions.h"
+#include "brprofiler.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
 
 /*! ************************************
 
@@ -77,6 +85,7 @@ Burger::Decompress::eError Burger::DecompressILBMRLE::Reset(void)
 
 Burger::Decompress::eError Burger::DecompressILBMRLE::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	BURGER_PROFILE_ZONE("DecompressILBMRLE::Process");
 	m_uInputLength = uInputChunkLength;
 	m_uOutputLength = uOutputChunkLength;
 
@@ -204,11 +213,37 @@ Run:
 	return DECOMPRESS_OKAY;
 }
 
+/***************************************
+
+	A token can read 129 bytes and write 129 bytes.
+	Runs are copied and filled 16 bytes at a time, so
+	there must be extra room for the copies to overrun into.
+
+***************************************/
+
+static const WordPtr cRLETokenInput = 1+128+16;
+static const WordPtr cRLETokenOutput = 129+16;
+
 /*! ************************************
 
 	\brief Decompress data using RLE compression
 
-	Using the RLE compression algorithm, decompress the data in one pass
+	Using the RLE compression algorithm, decompress the data in one pass.
+
+	When all the compressed data and the entire output buffer
+	are available, the data is decompressed without
+	the state machine used by DecompressILBMRLE::Process().
+	Fills are performed with 16 byte vector stores and
+	raw data is copied 16 bytes at a time. The stores can write
+	past the end of the run, which is overwritten by the data
+	that follows. When the end of either buffer is near,
+	DecompressILBMRLE::Process() decompresses the rest so
+	data is never written past the output buffer.
+
+	The return value and decompressed data are identical to calling
+	DecompressILBMRLE::Process() once with the same buffers. If the
+	input runs out early, the contents of the output buffer after
+	the decompressed data are undefined.
 
 	\param pOutput Pointer to the buffer to accept the decompressed data
 	\param uOutputChunkLength Number of bytes in the output buffer
@@ -222,7 +257,64 @@ Run:
 
 Burger::Decompress::eError BURGER_API Burger::SimpleDecompressILBMRLE(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	BURGER_PROFILE_ZONE("SimpleDecompressILBMRLE");
+	Word8 *pDest = static_cast<Word8 *>(pOutput);
+	Word8 *pDestEnd = pDest+uOutputChunkLength;
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	const Word8 *pSourceEnd = pSource+uInputChunkLength;
+
+	// Decode tokens while there's room
+	while ((static_cast<WordPtr>(pSourceEnd-pSource)>=cRLETokenInput) &&
+		(static_cast<WordPtr>(pDestEnd-pDest)>=cRLETokenOutput)) {
+		WordPtr uRunLength = pSource[0];
+		if (uRunLength>=128) {
+			uRunLength = 257-uRunLength;	// Count the run (2-129)
+			Word8 *pStop = pDest+uRunLength;
+#if defined(BURGER_SSE2)
+			__m128i vFill = _mm_set1_epi8(static_cast<char>(pSource[1]));
+			do {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),vFill);
+				pDest+=16;
+			} while (pDest<pStop);
+#elif defined(BURGER_NEON)
+			uint8x16_t vFill = vdupq_n_u8(pSource[1]);
+			do {
+				vst1q_u8(pDest,vFill);
+				pDest+=16;
+			} while (pDest<pStop);
+#else
+			Burger::MemoryFill(pDest,pSource[1],uRunLength);
+#endif
+			pDest = pStop;
+			pSource += 2;
+		} else {
+			++uRunLength;		// Count the data (1-128)
+			++pSource;
+			Word8 *pStop = pDest+uRunLength;
+#if defined(BURGER_SSE2)
+			const Word8 *pWork = pSource;
+			do {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),_mm_loadu_si128(reinterpret_cast<const __m128i *>(pWork)));
+				pDest+=16;
+				pWork+=16;
+			} while (pDest<pStop);
+#elif defined(BURGER_NEON)
+			const Word8 *pWork = pSource;
+			do {
+				vst1q_u8(pDest,vld1q_u8(pWork));
+				pDest+=16;
+				pWork+=16;
+			} while (pDest<pStop);
+#else
+			Burger::MemoryCopy(pDest,pSource,uRunLength);
+#endif
+			pDest = pStop;
+			pSource += uRunLength;
+		}
+	}
+
+	// Let the state machine handle the end of the data
 	Burger::DecompressILBMRLE Local;
 	Local.DecompressILBMRLE::Reset();
-	return Local.DecompressILBMRLE::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+	return Local.DecompressILBMRLE::Process(pDest,static_cast<WordPtr>(pDestEnd-pDest),pSource,static_cast<WordPtr>(pSourceEnd-pSource));
 }
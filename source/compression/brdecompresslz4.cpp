@@ -0,0 +1,542 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdecompresslz4.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brendian.h"
+#include "brprofiler.h"
+#include "brlzcopy.h"
+
+/*! ************************************
+
+	\class Burger::DecompressLZ4
+	\brief Decompress LZ4 format
+
+	Decompress data in LZ4 format (Documented here Burger::CompressLZ4 )
+
+	Decoding is done a block at a time. If the entire block and
+	enough space for the decoded block are passed to Process(),
+	it's decoded directly into the output buffer using 8 and 16 byte
+	moves that may write up to \ref SLOPSIZE bytes past the end of a copy,
+	as long as those bytes are within the output buffer. Otherwise,
+	the block is gathered and decoded in an internal buffer and then copied
+	to the output as space is made available.
+
+	\note Blocks that reference previous blocks require that all of
+	the output from previous calls to Process() immediately precedes
+	the output buffer, which is the same requirement as
+	Burger::DecompressLZSS. Frames with independent blocks
+	don't have this requirement.
+
+	\sa Burger::Decompress, Burger::CompressLZ4 and Burger::SimpleDecompressLZ4()
+
+***************************************/
+
+/***************************************
+
+	Decode the sequences of a block
+
+	pOutput/uOutputLength is the exact size of the decoded block,
+	uOutputCapacity is how much can be written to pOutput, which
+	allows copies to overrun the end of the block.
+
+	pHistoryEnd/uHistoryLength is the data that preceded the
+	block. If pHistoryEnd is the same as pOutput, the history
+	is in the same buffer as the output.
+
+	Returns TRUE if the data is corrupt
+
+***************************************/
+
+static Word BURGER_API DecodeSequences(Word8 *pOutput,WordPtr uOutputLength,WordPtr uOutputCapacity,
+	const Word8 *pInput,WordPtr uInputLength,const Word8 *pHistoryEnd,WordPtr uHistoryLength)
+{
+	Word8 *pDest = pOutput;
+	Word8 *pDestEnd = pOutput+uOutputLength;
+	Word8 *pCapacityEnd = pOutput+uOutputCapacity;
+	const Word8 *pSource = pInput;
+	const Word8 *pSourceEnd = pInput+uInputLength;
+
+	// Matches can reach into history that's in the same buffer
+	const Word8 *pLowest = pOutput;
+	if (pHistoryEnd==pOutput) {
+		pLowest = pOutput-uHistoryLength;
+		uHistoryLength = 0;
+	}
+
+	for (;;) {
+		if (pSource>=pSourceEnd) {
+			return TRUE;
+		}
+		Word uToken = pSource[0];
+		++pSource;
+
+		// Copy the literals
+		WordPtr uLength = uToken>>4U;
+		if (uLength==15) {
+			Word uExtra;
+			do {
+				if (pSource>=pSourceEnd) {
+					return TRUE;
+				}
+				uExtra = pSource[0];
+				++pSource;
+				uLength += uExtra;
+			} while (uExtra==255);
+		}
+		WordPtr uSourceLeft = static_cast<WordPtr>(pSourceEnd-pSource);
+		if (uLength) {
+			if ((uLength>uSourceLeft) || (uLength>static_cast<WordPtr>(pDestEnd-pDest))) {
+				return TRUE;
+			}
+			// Over copy if there's room on both sides
+			if (((uLength+Burger::DecompressLZ4::SLOPSIZE)<=uSourceLeft) &&
+				((uLength+Burger::DecompressLZ4::SLOPSIZE)<=static_cast<WordPtr>(pCapacityEnd-pDest))) {
+				Word8 *pWork = pDest;
+				const Word8 *pFrom = pSource;
+				do {
+					LZCopy16(pWork,pFrom);
+					pWork+=16;
+					pFrom+=16;
+				} while (pWork<(pDest+uLength));
+			} else {
+				Burger::MemoryCopy(pDest,pSource,uLength);
+			}
+			pDest += uLength;
+			pSource += uLength;
+			uSourceLeft -= uLength;
+		}
+
+		// The last sequence is only literals
+		if (!uSourceLeft) {
+			break;
+		}
+		if (uSourceLeft<2) {
+			return TRUE;
+		}
+		WordPtr uOffset = static_cast<WordPtr>(pSource[0])|(static_cast<WordPtr>(pSource[1])<<8U);
+		pSource += 2;
+		uLength = uToken&15U;
+		if (uLength==15) {
+			Word uExtra;
+			do {
+				if (pSource>=pSourceEnd) {
+					return TRUE;
+				}
+				uExtra = pSource[0];
+				++pSource;
+				uLength += uExtra;
+			} while (uExtra==255);
+		}
+		uLength += Burger::DecompressLZ4::MINMATCH;
+		if (!uOffset || (uLength>static_cast<WordPtr>(pDestEnd-pDest))) {
+			return TRUE;
+		}
+
+		// Is the start of the match in a separate history buffer?
+		WordPtr uPrefix = static_cast<WordPtr>(pDest-pLowest);
+		if (uOffset>uPrefix) {
+			WordPtr uBack = uOffset-uPrefix;
+			if (uBack>uHistoryLength) {
+				return TRUE;
+			}
+			WordPtr uChunk = (uBack<uLength) ? uBack : uLength;
+			Burger::MemoryCopy(pDest,pHistoryEnd-uBack,uChunk);
+			pDest += uChunk;
+			uLength -= uChunk;
+			if (!uLength) {
+				continue;
+			}
+		}
+
+		// Copy the match, which may overlap the output
+		const Word8 *pMatch = pDest-uOffset;
+		Word8 *pStop = pDest+uLength;
+		if ((uLength+Burger::DecompressLZ4::SLOPSIZE)<=static_cast<WordPtr>(pCapacityEnd-pDest)) {
+			LZCopyMatch(pDest,uOffset,pStop);
+			pDest = pStop;
+		} else {
+			do {
+				pDest[0] = pMatch[0];
+				++pDest;
+				++pMatch;
+			} while (pDest<pStop);
+		}
+	}
+	// The block must decode to the exact size
+	return pDest!=pDestEnd;
+}
+
+/*! ************************************
+
+	\brief Default constructor
+
+	Initializes the defaults
+
+***************************************/
+
+Burger::DecompressLZ4::DecompressLZ4() :
+	m_pBuffer(NULL),
+	m_uBlockSize(0),
+	m_uPackedSize(0),
+	m_uUnpackedSize(0),
+	m_uCount(0),
+	m_uFrameFlags(0),
+	m_eState(STATE_FRAMEHEADER)
+{
+	reinterpret_cast<Word32 *>(m_uSignature)[0] = Signature;
+}
+
+/*! ************************************
+
+	\brief Release the decompression buffer
+
+***************************************/
+
+Burger::DecompressLZ4::~DecompressLZ4()
+{
+	Free(m_pBuffer);
+}
+
+/***************************************
+
+	Allocate the buffer for split blocks
+
+***************************************/
+
+Word8 *Burger::DecompressLZ4::GetBuffer(void)
+{
+	Word8 *pBuffer = m_pBuffer;
+	if (!pBuffer) {
+		// Room for the compressed block and the decoded block
+		pBuffer = static_cast<Word8 *>(Alloc((m_uBlockSize*2)+SLOPSIZE));
+		m_pBuffer = pBuffer;
+	}
+	return pBuffer;
+}
+
+/*! ************************************
+
+	\brief Reset the LZ4 decompression
+
+	\return Decompress::DECOMPRESS_OKAY (No error is possible)
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Reset(void)
+{
+	m_uTotalOutput = 0;
+	m_uTotalInput = 0;
+	m_uCount = 0;
+	m_eState = STATE_FRAMEHEADER;
+	return DECOMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Decompress data using LZ4 compression
+
+	Using the LZ4 compression algorithm, decompress the data.
+	The frame header, block headers and blocks can be split
+	across calls in any way.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa Burger::SimpleDecompressLZ4()
+
+***************************************/
+
+Burger::Decompress::eError Burger::DecompressLZ4::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	BURGER_PROFILE_ZONE("DecompressLZ4::Process");
+	m_uInputLength = uInputChunkLength;
+	m_uOutputLength = uOutputChunkLength;
+
+	Word8 *pOutputWork = static_cast<Word8 *>(pOutput);
+	const Word8 *pInputWork = static_cast<const Word8 *>(pInput);
+	eState MyState = m_eState;
+	for (;;) {
+		WordPtr uChunk;
+		switch (MyState) {
+
+		// Gather and validate the frame header
+		case STATE_FRAMEHEADER:
+			uChunk = FRAMEHEADERSIZE-m_uCount;
+			if (uChunk>uInputChunkLength) {
+				uChunk = uInputChunkLength;
+			}
+			MemoryCopy(m_Header+m_uCount,pInputWork,uChunk);
+			pInputWork += uChunk;
+			uInputChunkLength -= uChunk;
+			m_uCount += uChunk;
+			if (m_uCount<FRAMEHEADERSIZE) {
+				goto Exit;
+			}
+			if ((m_Header[0]!=FRAMEVERSION) || (m_Header[1]&(~FRAMEINDEPENDENT)) ||
+				(m_Header[2]<MINBLOCKSHIFT) || (m_Header[2]>MAXBLOCKSHIFT) || m_Header[3]) {
+				MyState = STATE_ERROR;
+				goto Exit;
+			}
+			m_uFrameFlags = m_Header[1];
+			uChunk = static_cast<WordPtr>(1U)<<m_Header[2];
+			// Only keep the buffer if it's the right size
+			if (uChunk!=m_uBlockSize) {
+				Free(m_pBuffer);
+				m_pBuffer = NULL;
+				m_uBlockSize = uChunk;
+			}
+			m_uCount = 0;
+			MyState = STATE_BLOCKHEADER;
+			break;
+
+		// Block headers are 4 bytes for stored blocks and the end
+		// of the frame and 8 bytes for compressed blocks
+		case STATE_BLOCKHEADER:
+			{
+				WordPtr uNeeded = (m_uCount<4) ? 4U : 8U;
+				uChunk = uNeeded-m_uCount;
+				if (uChunk>uInputChunkLength) {
+					uChunk = uInputChunkLength;
+				}
+				MemoryCopy(m_Header+m_uCount,pInputWork,uChunk);
+				pInputWork += uChunk;
+				uInputChunkLength -= uChunk;
+				m_uCount += uChunk;
+				if (m_uCount<uNeeded) {
+					goto Exit;
+				}
+				Word32 uPacked = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(m_Header));
+				if (uNeeded==4) {
+					if (!uPacked) {
+						MyState = STATE_DONE;
+						goto Exit;
+					}
+					if (uPacked&BLOCKSTORED) {
+						uPacked &= BLOCKSIZEMASK;
+						if (!uPacked || (uPacked>m_uBlockSize)) {
+							MyState = STATE_ERROR;
+							goto Exit;
+						}
+						m_uPackedSize = uPacked;
+						m_uCount = 0;
+						MyState = STATE_STORED;
+					}
+					// Otherwise get the rest of the header
+					break;
+				}
+				WordPtr uUnpacked = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(m_Header+4));
+				if ((uPacked>m_uBlockSize) || !uUnpacked || (uUnpacked>m_uBlockSize)) {
+					MyState = STATE_ERROR;
+					goto Exit;
+				}
+				m_uPackedSize = uPacked;
+				m_uUnpackedSize = uUnpacked;
+				m_uCount = 0;
+				// Is the entire block here and is there room for the output?
+				if ((uInputChunkLength>=uPacked) && (uOutputChunkLength>=uUnpacked)) {
+					WordPtr uHistory = 0;
+					if (!(m_uFrameFlags&FRAMEINDEPENDENT)) {
+						uHistory = m_uTotalOutput+static_cast<WordPtr>(pOutputWork-static_cast<Word8 *>(pOutput));
+					}
+					if (DecodeSequences(pOutputWork,uUnpacked,uOutputChunkLength,pInputWork,uPacked,pOutputWork,uHistory)) {
+						MyState = STATE_ERROR;
+						goto Exit;
+					}
+					pInputWork += uPacked;
+					uInputChunkLength -= uPacked;
+					pOutputWork += uUnpacked;
+					uOutputChunkLength -= uUnpacked;
+				} else {
+					MyState = STATE_COLLECT;
+				}
+			}
+			break;
+
+		// Copy uncompressed data
+		case STATE_STORED:
+			uChunk = m_uPackedSize-m_uCount;
+			if (uChunk>uInputChunkLength) {
+				uChunk = uInputChunkLength;
+			}
+			if (uChunk>uOutputChunkLength) {
+				uChunk = uOutputChunkLength;
+			}
+			MemoryCopy(pOutputWork,pInputWork,uChunk);
+			pInputWork += uChunk;
+			uInputChunkLength -= uChunk;
+			pOutputWork += uChunk;
+			uOutputChunkLength -= uChunk;
+			m_uCount += uChunk;
+			if (m_uCount<m_uPackedSize) {
+				goto Exit;
+			}
+			m_uCount = 0;
+			MyState = STATE_BLOCKHEADER;
+			break;
+
+		// Gather a compressed block and decode it
+		case STATE_COLLECT:
+			{
+				Word8 *pBuffer = GetBuffer();
+				if (!pBuffer) {
+					MyState = STATE_ERROR;
+					goto Exit;
+				}
+				uChunk = m_uPackedSize-m_uCount;
+				if (uChunk>uInputChunkLength) {
+					uChunk = uInputChunkLength;
+				}
+				MemoryCopy(pBuffer+m_uCount,pInputWork,uChunk);
+				pInputWork += uChunk;
+				uInputChunkLength -= uChunk;
+				m_uCount += uChunk;
+				if (m_uCount<m_uPackedSize) {
+					goto Exit;
+				}
+				WordPtr uHistory = 0;
+				if (!(m_uFrameFlags&FRAMEINDEPENDENT)) {
+					uHistory = m_uTotalOutput+static_cast<WordPtr>(pOutputWork-static_cast<Word8 *>(pOutput));
+				}
+				m_uCount = 0;
+				if (uOutputChunkLength>=m_uUnpackedSize) {
+					// Decode straight to the output
+					if (DecodeSequences(pOutputWork,m_uUnpackedSize,uOutputChunkLength,pBuffer,m_uPackedSize,pOutputWork,uHistory)) {
+						MyState = STATE_ERROR;
+						goto Exit;
+					}
+					pOutputWork += m_uUnpackedSize;
+					uOutputChunkLength -= m_uUnpackedSize;
+					MyState = STATE_BLOCKHEADER;
+				} else {
+					// Decode to the buffer and copy it out as room is made
+					if (DecodeSequences(pBuffer+m_uBlockSize,m_uUnpackedSize,m_uBlockSize+SLOPSIZE,pBuffer,m_uPackedSize,pOutputWork,uHistory)) {
+						MyState = STATE_ERROR;
+						goto Exit;
+					}
+					MyState = STATE_FLUSH;
+				}
+			}
+			break;
+
+		// Copy decoded data to the output
+		case STATE_FLUSH:
+			uChunk = m_uUnpackedSize-m_uCount;
+			if (uChunk>uOutputChunkLength) {
+				uChunk = uOutputChunkLength;
+			}
+			MemoryCopy(pOutputWork,m_pBuffer+m_uBlockSize+m_uCount,uChunk);
+			pOutputWork += uChunk;
+			uOutputChunkLength -= uChunk;
+			m_uCount += uChunk;
+			if (m_uCount<m_uUnpackedSize) {
+				goto Exit;
+			}
+			m_uCount = 0;
+			MyState = STATE_BLOCKHEADER;
+			break;
+
+		// STATE_DONE and STATE_ERROR
+		default:
+			goto Exit;
+		}
+	}
+Exit:
+	m_eState = MyState;
+
+	// How did the decompression go?
+
+	m_uOutputLength -= uOutputChunkLength;
+	m_uInputLength -= uInputChunkLength;
+	m_uTotalOutput += m_uOutputLength;
+	m_uTotalInput += m_uInputLength;
+
+	if (MyState==STATE_ERROR) {
+		return DECOMPRESS_BADINPUT;
+	}
+	// Output buffer not big enough?
+	if (uOutputChunkLength) {
+		return DECOMPRESS_OUTPUTUNDERRUN;
+	}
+	if (MyState==STATE_DONE) {
+		// Data after the end of the frame?
+		if (uInputChunkLength) {
+			return DECOMPRESS_OUTPUTOVERRUN;
+		}
+		// Decompression is complete
+		return DECOMPRESS_OKAY;
+	}
+	// Input data or decoded data remaining?
+	if (uInputChunkLength || (MyState==STATE_FLUSH) || (MyState==STATE_STORED)) {
+		return DECOMPRESS_OUTPUTOVERRUN;
+	}
+	// The end of the frame hasn't been found yet
+	return DECOMPRESS_OUTPUTUNDERRUN;
+}
+
+/*! ************************************
+
+	\brief Decompress a single independent LZ4 block
+
+	Decode the data of one block from a frame that was created
+	with Burger::CompressLZ4::SetIndependentBlocks(\ref TRUE). The
+	block header contains the compressed and decompressed
+	sizes, so the location of every block can be found
+	with a quick scan of the headers and the blocks can
+	then be decoded on separate threads.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputLength Exact number of bytes the block decompresses to
+	\param pInput Pointer to the block data, after the block header
+	\param uInputLength Number of bytes of block data
+
+	\return Decompress::DECOMPRESS_OKAY or Decompress::DECOMPRESS_BADINPUT
+	\sa Process(void *,WordPtr,const void *,WordPtr)
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::DecompressLZ4::DecodeBlock(void *pOutput,WordPtr uOutputLength,const void *pInput,WordPtr uInputLength)
+{
+	if (DecodeSequences(static_cast<Word8 *>(pOutput),uOutputLength,uOutputLength,static_cast<const Word8 *>(pInput),uInputLength,NULL,0)) {
+		return DECOMPRESS_BADINPUT;
+	}
+	return DECOMPRESS_OKAY;
+}
+
+/*! ************************************
+
+	\brief Decompress an LZ4 frame in one pass
+
+	When the entire frame and output buffer are passed,
+	every block is decoded directly into the output
+	buffer and no memory is allocated.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa Burger::DecompressLZ4
+
+***************************************/
+
+Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
+{
+	Burger::DecompressLZ4 Local;
+	return Local.DecompressLZ4::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+}
@@ -0,0 +1,77 @@
+/***************************************
+
+	Decompression manager version of LZ4
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDECOMPRESSLZ4_H__
+#define __BRDECOMPRESSLZ4_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRDECOMPRESS_H__
+#include "brdecompress.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class DecompressLZ4 : public Decompress {
+	BURGER_DISABLECOPYCONSTRUCTORS(DecompressLZ4);
+public:
+	enum {
+		FRAMEVERSION=1,				///< Version number in the frame header
+		FRAMEHEADERSIZE=4,			///< Size of the frame header in bytes
+		FRAMEINDEPENDENT=0x01,		///< Frame header flag for blocks that don't reference previous blocks
+		BLOCKSTORED=0x80000000U,	///< Block header flag for data that's not compressed
+		BLOCKSIZEMASK=0x7FFFFFFFU,	///< Block header mask for the size of the block data
+		MINBLOCKSHIFT=16,			///< Smallest block size as a power of 2 (64K)
+		MAXBLOCKSHIFT=22,			///< Largest block size as a power of 2 (4M)
+		MINMATCH=4,					///< Smallest string match
+		MAXOFFSET=0xFFFF,			///< Farthest distance for a string match
+		SLOPSIZE=32					///< Bytes of output that may be overwritten past a copy
+	};
+private:
+	enum eState {
+		STATE_FRAMEHEADER,	///< Reading the frame header
+		STATE_BLOCKHEADER,	///< Reading a block header
+		STATE_STORED,		///< Copying an uncompressed block
+		STATE_COLLECT,		///< Gathering a compressed block that was split
+		STATE_FLUSH,		///< Copying a decoded block to the output
+		STATE_DONE,			///< End of the frame was found
+		STATE_ERROR			///< Bad data was found
+	};
+	Word8 *m_pBuffer;		///< Buffer for a split compressed block followed by its decoded data
+	WordPtr m_uBlockSize;	///< Largest block size in bytes from the frame header
+	WordPtr m_uPackedSize;	///< Compressed size of the current block
+	WordPtr m_uUnpackedSize;	///< Decompressed size of the current block
+	WordPtr m_uCount;		///< Bytes gathered or copied for the current state
+	Word m_uFrameFlags;		///< Flags from the frame header
+	eState m_eState;		///< State of the decompression
+	Word8 m_Header[8];		///< Cache for a split header
+	Word8 *GetBuffer(void);
+public:
+#if defined(BURGER_BIGENDIAN)
+	static const Word32 Signature = 0x4C5A3442;		///< 'LZ4B'
+#else
+	static const Word32 Signature = 0x42345A4C;		///< 'LZ4B'
+#endif
+	DecompressLZ4();
+	virtual ~DecompressLZ4();
+	virtual eError Reset(void);
+	virtual eError Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+	static eError BURGER_API DecodeBlock(void *pOutput,WordPtr uOutputLength,const void *pInput,WordPtr uInputLength);
+};
+extern Decompress::eError BURGER_API SimpleDecompressLZ4(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength);
+}
+/* END */
+
+#endif
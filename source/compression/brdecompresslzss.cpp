@@ -12,6 +12,8 @@
 ***************************************/
 
 #include "brdecompresslzss.h"
+#include "brprofiler.h"
+#include "brlzcopy.h"
 
 /*! ************************************
 
@@ -74,6 +76,7 @@ Burger::Decompress::eError Burger::DecompressLZSS::Reset(void)
 
 Burger::Decompress::eError Burger::DecompressLZSS::Process(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	BURGER_PROFILE_ZONE("DecompressLZSS::Process");
 	m_uInputLength = uInputChunkLength;
 	m_uOutputLength = uOutputChunkLength;
 
@@ -259,15 +262,87 @@ Exit:
 
 /***************************************
 
-	Decompress using LZSS.
-	I assume I can decompress in one pass.
-	This makes for fast and tight code.
+	A group of 8 tokens can read 17 bytes and write
+	144 bytes. Literals are copied 8 bytes at a time and
+	matches 16 bytes at a time, so there must be extra
+	room past the group for the copies to overrun into.
+
+***************************************/
+
+static const WordPtr cLZSSGroupInput = 1+(8*2)+8;
+static const WordPtr cLZSSGroupOutput = (8*18)+16;
+
+/*! ************************************
+
+	\brief Decompress LZSS data in one pass
+
+	When all the compressed data and the entire output buffer
+	are available, the data is decompressed
+	without the state machine used by DecompressLZSS::Process().
+	Literals are copied 8 bytes at a time and string matches
+	are copied 8 or 16 bytes at a time. The copies can write
+	past the end of the string being copied, which is overwritten
+	by the data that follows. When the end of either buffer
+	is near, DecompressLZSS::Process() decompresses the rest
+	so data is never written past the output buffer.
+
+	The return value and decompressed data are identical to calling
+	DecompressLZSS::Process() once with the same buffers. If the
+	input runs out early, the contents of the output buffer after
+	the decompressed data are undefined.
+
+	\param pOutput Pointer to the buffer to accept the decompressed data
+	\param uOutputChunkLength Number of bytes in the output buffer
+	\param pInput Pointer to data to compress
+	\param uInputChunkLength Number of bytes in the data to decompress
+
+	\return Decompress::eError code with zero if no failure, non-zero is an error code
+	\sa DecompressLZSS::Process()
 
 ***************************************/
 
 Burger::Decompress::eError BURGER_API Burger::SimpleDecompressLZSS(void *pOutput,WordPtr uOutputChunkLength,const void *pInput,WordPtr uInputChunkLength)
 {
+	BURGER_PROFILE_ZONE("SimpleDecompressLZSS");
+	Word8 *pDest = static_cast<Word8 *>(pOutput);
+	Word8 *pDestEnd = pDest+uOutputChunkLength;
+	const Word8 *pSource = static_cast<const Word8 *>(pInput);
+	const Word8 *pSourceEnd = pSource+uInputChunkLength;
+
+	// Decode entire groups of 8 tokens while there's room
+	while ((static_cast<WordPtr>(pSourceEnd-pSource)>=cLZSSGroupInput) &&
+		(static_cast<WordPtr>(pDestEnd-pDest)>=cLZSSGroupOutput)) {
+		Word uBitBucket = pSource[0];
+		++pSource;
+		Word uCount = 8;
+		do {
+			if (uBitBucket&1U) {
+				// Copy all the literals in a row at once
+				Word uLiterals = 1;
+				while ((uLiterals<uCount) && ((uBitBucket>>uLiterals)&1U)) {
+					++uLiterals;
+				}
+				LZCopy8(pDest,pSource);
+				pDest += uLiterals;
+				pSource += uLiterals;
+				uBitBucket >>= uLiterals;
+				uCount -= uLiterals;
+			} else {
+				Word uToken = static_cast<Word>(pSource[0])|(static_cast<Word>(pSource[1])<<8U);
+				pSource += 2;
+				// The offset is 1 to 4096 bytes back
+				WordPtr uOffset = 0x1000U-(uToken&0xFFFU);
+				Word8 *pStop = pDest+((uToken>>12U)+3U);
+				LZCopyMatch(pDest,uOffset,pStop);
+				pDest = pStop;
+				uBitBucket >>= 1U;
+				--uCount;
+			}
+		} while (uCount);
+	}
+
+	// Let the state machine handle the end of the data
 	Burger::DecompressLZSS Local;
 	Local.DecompressLZSS::Reset();
-	return Local.DecompressLZSS::Process(pOutput,uOutputChunkLength,pInput,uInputChunkLength);
+	return Local.DecompressLZSS::Process(pDest,static_cast<WordPtr>(pDestEnd-pDest),pSource,static_cast<WordPtr>(pSourceEnd-pSource));
 }
@@ -0,0 +1,324 @@
+/***************************************
+
+	Intel DVI/IMA ADPCM decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdviadpcm.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\struct Burger::DVIADPCMState_t
+	\brief State of a DVI/IMA ADPCM channel
+
+	Intel DVI ADPCM, later standardized by the IMA, encodes each
+	sample as a 4 bit step from the previous sample. The step size
+	adapts from a table of 89 entries.
+
+	In *.WAV files (WAVE_FORMAT_DVI_ADPCM), the audio is stored in
+	blocks with a header for each channel that resets this state. For
+	headerless streams, DVIADPCMExpand() carries the state from one
+	call to the next the same way as MACEExp1to3() does.
+
+	To initialize this structure, fill all members with zero
+
+	\sa DVIADPCMDecodeBlock() or DVIADPCMExpand()
+
+***************************************/
+
+/***************************************
+
+	Quantization step sizes
+
+***************************************/
+
+static const Int16 s_StepTable[89] = {
+	    7,    8,    9,   10,   11,   12,   13,   14,
+	   16,   17,   19,   21,   23,   25,   28,   31,
+	   34,   37,   41,   45,   50,   55,   60,   66,
+	   73,   80,   88,   97,  107,  118,  130,  143,
+	  157,  173,  190,  209,  230,  253,  279,  307,
+	  337,  371,  408,  449,  494,  544,  598,  658,
+	  724,  796,  876,  963, 1060, 1166, 1282, 1411,
+	 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+	 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484,
+	 7132, 7845, 8630, 9493,10442,11487,12635,13899,
+	15289,16818,18500,20350,22385,24623,27086,29794,
+	32767
+};
+
+/***************************************
+
+	Step index adjustments, indexed by the encoded nibble
+
+***************************************/
+
+static const Int8 s_IndexTable[16] = {
+	-1,-1,-1,-1,2,4,6,8,
+	-1,-1,-1,-1,2,4,6,8
+};
+
+/***************************************
+
+	Decode a single nibble and update the state
+
+***************************************/
+
+static BURGER_INLINE Int32 DecodeNibble(Word uNibble,Int32 *pPredictor,Int32 *pStepIndex)
+{
+	Int32 iStepIndex = pStepIndex[0];
+	Int32 iStep = s_StepTable[iStepIndex];
+	// Same as ((uNibble&7)*2+1)*iStep/8 without the multiply
+	Int32 iDifference = iStep>>3;
+	if (uNibble&4U) {
+		iDifference += iStep;
+	}
+	if (uNibble&2U) {
+		iDifference += iStep>>1;
+	}
+	if (uNibble&1U) {
+		iDifference += iStep>>2;
+	}
+	Int32 iPredictor = pPredictor[0];
+	if (uNibble&8U) {
+		iPredictor -= iDifference;
+		if (iPredictor<-32768) {
+			iPredictor = -32768;
+		}
+	} else {
+		iPredictor += iDifference;
+		if (iPredictor>32767) {
+			iPredictor = 32767;
+		}
+	}
+	pPredictor[0] = iPredictor;
+	iStepIndex += s_IndexTable[uNibble];
+	if (iStepIndex<0) {
+		iStepIndex = 0;
+	} else if (iStepIndex>88) {
+		iStepIndex = 88;
+	}
+	pStepIndex[0] = iStepIndex;
+	return iPredictor;
+}
+
+/*! ************************************
+
+	\brief Return the number of sample frames in a DVI/IMA ADPCM block
+
+	Each block has a 4 byte header per channel that contains the
+	first sample, the rest of the block has 4 bits per sample
+	in groups of 8 samples per channel.
+
+	\param uBlockSize Size of the block in bytes (nBlockAlign in the *.WAV header)
+	\param uNumChannels Number of interleaved channels
+	\return Number of sample frames the block decodes to, zero if the block is too small
+	\sa DVIADPCMDecodeBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::DVIADPCMGetSamplesPerBlock(WordPtr uBlockSize,Word uNumChannels)
+{
+	if (!uNumChannels || (uBlockSize<(4U*uNumChannels))) {
+		return 0;
+	}
+	return (((uBlockSize-(4U*uNumChannels))/(4U*uNumChannels))*8U)+1U;
+}
+
+/*! ************************************
+
+	\brief Decompress a block of DVI/IMA ADPCM audio
+
+	Decode a single block into signed 16 bit native endian samples.
+	If the data has more than one channel, the output is interleaved.
+
+	\note The output buffer must hold DVIADPCMGetSamplesPerBlock(uBlockSize,uNumChannels)*uNumChannels samples
+
+	\param pInput Pointer to the compressed block
+	\param pOutput Pointer to the buffer to receive the decompressed samples
+	\param uBlockSize Size of the block in bytes
+	\param uNumChannels Number of interleaved channels (1 through DVIADPCMState_t::MAXCHANNELS)
+	\param pOutputStates Pointer to an array of uNumChannels states to receive the state at the end of the block (Can be \ref NULL)
+	\return Number of sample frames decoded, zero if the block is invalid
+	\sa DVIADPCMDecode() or DVIADPCMGetSamplesPerBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::DVIADPCMDecodeBlock(const Word8 *pInput,Int16 *pOutput,WordPtr uBlockSize,Word uNumChannels,DVIADPCMState_t *pOutputStates)
+{
+	WordPtr uFrames = DVIADPCMGetSamplesPerBlock(uBlockSize,uNumChannels);
+	if (!uFrames || (uNumChannels>DVIADPCMState_t::MAXCHANNELS)) {
+		return 0;
+	}
+	DVIADPCMState_t States[DVIADPCMState_t::MAXCHANNELS];
+
+	// Parse the header for each channel
+	Word i = 0;
+	do {
+		Word uStepIndex = pInput[2];
+		if (uStepIndex>88) {
+			return 0;
+		}
+		States[i].m_iPredictor = static_cast<Int16>(pInput[0]|(pInput[1]<<8U));
+		States[i].m_iStepIndex = static_cast<Int32>(uStepIndex);
+		pOutput[i] = static_cast<Int16>(States[i].m_iPredictor);
+		pInput += 4;
+	} while (++i<uNumChannels);
+	pOutput += uNumChannels;
+
+	// Each channel has 4 bytes of 8 samples, low nibble first
+	WordPtr uGroups = (uFrames-1)>>3U;
+	if (uGroups) {
+		const WordPtr uStride = uNumChannels;
+		do {
+			i = 0;
+			do {
+				Int32 iPredictor = States[i].m_iPredictor;
+				Int32 iStepIndex = States[i].m_iStepIndex;
+				Int16 *pWork = pOutput+i;
+				Word j = 4;
+				do {
+					Word uTemp = pInput[0];
+					pWork[0] = static_cast<Int16>(DecodeNibble(uTemp&0xFU,&iPredictor,&iStepIndex));
+					pWork[uStride] = static_cast<Int16>(DecodeNibble(uTemp>>4U,&iPredictor,&iStepIndex));
+					pWork += uStride*2;
+					++pInput;
+				} while (--j);
+				States[i].m_iPredictor = iPredictor;
+				States[i].m_iStepIndex = iStepIndex;
+			} while (++i<uNumChannels);
+			pOutput += uStride*8;
+		} while (--uGroups);
+	}
+	if (pOutputStates) {
+		MemoryCopy(pOutputStates,States,sizeof(DVIADPCMState_t)*uNumChannels);
+	}
+	return uFrames;
+}
+
+/*! ************************************
+
+	\brief Decompress a stream of DVI/IMA ADPCM blocks
+
+	Decode consecutive blocks into signed 16 bit native endian samples.
+	If the data has more than one channel, the output is interleaved. The
+	last block may be shorter than uBlockSize, as is common
+	at the end of a *.WAV file.
+
+	Since each block is self contained, a large sound can be decoded
+	in pieces, or in parallel, by passing runs of whole blocks.
+
+	\param pInput Pointer to the compressed blocks
+	\param pOutput Pointer to the buffer to receive the decompressed samples
+	\param uInputSize Number of bytes of compressed data
+	\param uBlockSize Size of each block in bytes (nBlockAlign in the *.WAV header)
+	\param uNumChannels Number of interleaved channels
+	\return Number of sample frames decoded, decoding stops at the first invalid block
+	\sa DVIADPCMDecodeBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::DVIADPCMDecode(const Word8 *pInput,Int16 *pOutput,WordPtr uInputSize,WordPtr uBlockSize,Word uNumChannels)
+{
+	WordPtr uTotal = 0;
+	if (uBlockSize) {
+		while (uInputSize) {
+			WordPtr uChunk = (uInputSize<uBlockSize) ? uInputSize : uBlockSize;
+			WordPtr uFrames = DVIADPCMDecodeBlock(pInput,pOutput,uChunk,uNumChannels);
+			if (!uFrames) {
+				break;
+			}
+			uTotal += uFrames;
+			pOutput += uFrames*uNumChannels;
+			pInput += uChunk;
+			uInputSize -= uChunk;
+		}
+	}
+	return uTotal;
+}
+
+/*! ************************************
+
+	\brief Decompress a headerless DVI/IMA ADPCM stream
+
+	Decode a stream of 4 bit samples with no block headers, carrying the
+	state from one call to the next. Each packet is one byte that
+	yields two samples, low nibble first.
+
+	Each call will only decompress one channel of data, the input
+	is assumed to have the packets of each channel interleaved and the
+	samples are written into an interleaved output buffer. To decompress
+	stereo input, call this function twice like this
+
+	\code
+		// Decompress mono
+		Int16 SoundBufferMono[1024*2];
+		Word8 CompressedMono[1024];
+		Burger::DVIADPCMExpand(CompressedMono,SoundBufferMono,1024,NULL,NULL,1,1);
+
+		// Decompress stereo into an interleaved buffer
+		Int16 SoundBufferStereo[1024*2*2];
+		Word8 Compressed[1024*2];
+		Burger::DVIADPCMExpand(Compressed,SoundBufferStereo,1024,NULL,NULL,2,1);
+		Burger::DVIADPCMExpand(Compressed,SoundBufferStereo,1024,NULL,NULL,2,2);
+	\endcode
+
+	\param pInput Pointer to the compressed data
+	\param pOutput Pointer to the buffer to receive the decompressed data
+	\param uPacketCount Number of compressed packets per channel to decompress
+	\param pInputState Pointer to a running \ref DVIADPCMState_t for partial decompression
+	\param pOutputState Pointer to a \ref DVIADPCMState_t for the state of the decompression after this call completes
+	\param uNumChannels Number of interleaved channels
+	\param uWhichChannel 1 for the first channel, 2 for the second channel and so on
+	\sa DVIADPCMDecodeBlock() or MACEExp1to3()
+
+***************************************/
+
+void BURGER_API Burger::DVIADPCMExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uPacketCount,DVIADPCMState_t *pInputState,DVIADPCMState_t *pOutputState,Word uNumChannels,Word uWhichChannel)
+{
+	DVIADPCMState_t TempState;
+
+	// First, is there an input state?
+	if (!pInputState) {
+		MemoryClear(&TempState,sizeof(TempState));
+		pInputState = &TempState;
+	}
+
+	// Do I want the output?
+	if (!pOutputState) {
+		pOutputState = pInputState;
+	} else {
+		MemoryCopy(pOutputState,pInputState,sizeof(DVIADPCMState_t));
+	}
+
+	if (uPacketCount) {
+		pInput += uWhichChannel-1;
+		pOutput += uWhichChannel-1;
+		const WordPtr uStride = uNumChannels;
+		Int32 iPredictor = pOutputState->m_iPredictor;
+		Int32 iStepIndex = pOutputState->m_iStepIndex;
+		// Guard against a damaged state
+		if (iStepIndex<0) {
+			iStepIndex = 0;
+		} else if (iStepIndex>88) {
+			iStepIndex = 88;
+		}
+		do {
+			Word uTemp = pInput[0];
+			pOutput[0] = static_cast<Int16>(DecodeNibble(uTemp&0xFU,&iPredictor,&iStepIndex));
+			pOutput[uStride] = static_cast<Int16>(DecodeNibble(uTemp>>4U,&iPredictor,&iStepIndex));
+			pOutput += uStride*2;
+			pInput += uStride;
+		} while (--uPacketCount);
+		pOutputState->m_iPredictor = iPredictor;
+		pOutputState->m_iStepIndex = iStepIndex;
+	}
+}
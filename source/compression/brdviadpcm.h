@@ -0,0 +1,37 @@
+/***************************************
+
+	Intel DVI/IMA ADPCM decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDVIADPCM_H__
+#define __BRDVIADPCM_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct DVIADPCMState_t {
+	enum {
+		MAXCHANNELS=8		///< Maximum number of channels in a block
+	};
+	Int32 m_iPredictor;		///< Last decoded sample
+	Int32 m_iStepIndex;		///< Index into the step size table (0-88)
+};
+extern WordPtr BURGER_API DVIADPCMGetSamplesPerBlock(WordPtr uBlockSize,Word uNumChannels);
+extern WordPtr BURGER_API DVIADPCMDecodeBlock(const Word8 *pInput,Int16 *pOutput,WordPtr uBlockSize,Word uNumChannels,DVIADPCMState_t *pOutputStates=NULL);
+extern WordPtr BURGER_API DVIADPCMDecode(const Word8 *pInput,Int16 *pOutput,WordPtr uInputSize,WordPtr uBlockSize,Word uNumChannels);
+extern void BURGER_API DVIADPCMExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uPacketCount,DVIADPCMState_t *pInputState,DVIADPCMState_t *pOutputState,Word uNumChannels,Word uWhichChannel);
+}
+/* END */
+
+#endif
@@ -0,0 +1,125 @@
+/***************************************
+
+	Copy functions shared by the LZ decompressors
+
+	This header is only included by the decompressors
+	and is not part of the public headers.
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRLZCOPY_H__
+#define __BRLZCOPY_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
+/***************************************
+
+	Copy 8 bytes, the buffers can't overlap
+	within the 8 bytes
+
+***************************************/
+
+static BURGER_INLINE void LZCopy8(Word8 *pOutput,const Word8 *pInput)
+{
+#if defined(BURGER_SSE2)
+	_mm_storel_epi64(reinterpret_cast<__m128i *>(pOutput),_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pInput)));
+#elif defined(BURGER_NEON)
+	vst1_u8(pOutput,vld1_u8(pInput));
+#else
+	Word8 uTemp0 = pInput[0];
+	Word8 uTemp1 = pInput[1];
+	Word8 uTemp2 = pInput[2];
+	Word8 uTemp3 = pInput[3];
+	Word8 uTemp4 = pInput[4];
+	Word8 uTemp5 = pInput[5];
+	Word8 uTemp6 = pInput[6];
+	Word8 uTemp7 = pInput[7];
+	pOutput[0] = uTemp0;
+	pOutput[1] = uTemp1;
+	pOutput[2] = uTemp2;
+	pOutput[3] = uTemp3;
+	pOutput[4] = uTemp4;
+	pOutput[5] = uTemp5;
+	pOutput[6] = uTemp6;
+	pOutput[7] = uTemp7;
+#endif
+}
+
+/***************************************
+
+	Copy 16 bytes, the buffers can't overlap
+	within the 16 bytes
+
+***************************************/
+
+static BURGER_INLINE void LZCopy16(Word8 *pOutput,const Word8 *pInput)
+{
+#if defined(BURGER_SSE2)
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)));
+#elif defined(BURGER_NEON)
+	vst1q_u8(pOutput,vld1q_u8(pInput));
+#else
+	LZCopy8(pOutput,pInput);
+	LZCopy8(pOutput+8,pInput+8);
+#endif
+}
+
+/***************************************
+
+	Copy a string match that starts uOffset bytes
+	before pOutput and ends at pStop. The match may
+	overlap the output. Up to 15 bytes past pStop may
+	be written, so the caller must make sure there's
+	room for them.
+
+***************************************/
+
+static BURGER_INLINE void LZCopyMatch(Word8 *pOutput,WordPtr uOffset,Word8 *pStop)
+{
+	const Word8 *pMatch = pOutput-uOffset;
+	if (uOffset>=16) {
+		do {
+			LZCopy16(pOutput,pMatch);
+			pOutput+=16;
+			pMatch+=16;
+		} while (pOutput<pStop);
+	} else {
+		if (uOffset<8) {
+			// Copy a byte at a time until the pattern
+			// repeats at a distance of at least 8 bytes
+			WordPtr uDistance = uOffset;
+			do {
+				uDistance += uOffset;
+			} while (uDistance<8);
+			Word8 *pPattern = pOutput+uDistance;
+			do {
+				pOutput[0] = pMatch[0];
+				++pOutput;
+				++pMatch;
+			} while (pOutput<pPattern);
+			pMatch = pOutput-uDistance;
+		}
+		while (pOutput<pStop) {
+			LZCopy8(pOutput,pMatch);
+			pOutput+=8;
+			pMatch+=8;
+		}
+	}
+}
+
+#endif
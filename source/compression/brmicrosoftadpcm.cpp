@@ -0,0 +1,226 @@
+/***************************************
+
+	Microsoft ADPCM decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brmicrosoftadpcm.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\struct Burger::MicrosoftADPCMState_t
+	\brief State of a Microsoft ADPCM channel
+
+	Microsoft ADPCM (WAVE_FORMAT_ADPCM) stores audio in blocks. Each
+	block starts with a header for every channel that sets this state,
+	so blocks can be decoded independently and in any order. The
+	state at the end of a block can be retrieved with
+	MicrosoftADPCMDecodeBlock() for streaming decoders that need it.
+
+	\sa MicrosoftADPCMDecodeBlock() or MicrosoftADPCMDecode()
+
+***************************************/
+
+/***************************************
+
+	Standard predictor coefficient pairs in 8.8 fixed point.
+	These are the 7 pairs every Microsoft ADPCM encoder uses.
+
+***************************************/
+
+static const Int16 s_Coefficients[7][2] = {
+	{256,0},{512,-256},{0,0},{192,64},{240,0},{460,-208},{392,-232}
+};
+
+/***************************************
+
+	Scale factors to adapt the quantization step
+	in 8.8 fixed point, indexed by the encoded nibble
+
+***************************************/
+
+static const Int16 s_Adaptation[16] = {
+	230,230,230,230,307,409,512,614,
+	768,614,512,409,307,230,230,230
+};
+
+/***************************************
+
+	Load a little endian signed 16 bit value
+
+***************************************/
+
+static BURGER_INLINE Int32 LoadLittleInt16(const Word8 *pInput)
+{
+	return static_cast<Int16>(pInput[0]|(pInput[1]<<8U));
+}
+
+/*! ************************************
+
+	\brief Return the number of sample frames in a Microsoft ADPCM block
+
+	Each block has a 7 byte header per channel that contains the first
+	two samples and the rest of the block has 4 bits per sample.
+
+	\param uBlockSize Size of the block in bytes (nBlockAlign in the *.WAV header)
+	\param uNumChannels Number of interleaved channels
+	\return Number of sample frames the block decodes to, zero if the block is too small
+	\sa MicrosoftADPCMDecodeBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::MicrosoftADPCMGetSamplesPerBlock(WordPtr uBlockSize,Word uNumChannels)
+{
+	if (!uNumChannels || (uBlockSize<(7U*uNumChannels))) {
+		return 0;
+	}
+	return (((uBlockSize-(7U*uNumChannels))*2U)/uNumChannels)+2U;
+}
+
+/*! ************************************
+
+	\brief Decompress a block of Microsoft ADPCM audio
+
+	Decode a single block into signed 16 bit native endian samples.
+	If the data has more than one channel, the output is interleaved.
+
+	Only the 7 standard predictor coefficient pairs are supported, these
+	are the ones every encoder writes in the *.WAV header.
+
+	\note The output buffer must hold MicrosoftADPCMGetSamplesPerBlock(uBlockSize,uNumChannels)*uNumChannels samples
+
+	\param pInput Pointer to the compressed block
+	\param pOutput Pointer to the buffer to receive the decompressed samples
+	\param uBlockSize Size of the block in bytes
+	\param uNumChannels Number of interleaved channels (1 through MicrosoftADPCMState_t::MAXCHANNELS)
+	\param pOutputStates Pointer to an array of uNumChannels states to receive the state at the end of the block (Can be \ref NULL)
+	\return Number of sample frames decoded, zero if the block is invalid
+	\sa MicrosoftADPCMDecode() or MicrosoftADPCMGetSamplesPerBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::MicrosoftADPCMDecodeBlock(const Word8 *pInput,Int16 *pOutput,WordPtr uBlockSize,Word uNumChannels,MicrosoftADPCMState_t *pOutputStates)
+{
+	if ((uNumChannels>MicrosoftADPCMState_t::MAXCHANNELS) ||
+		!MicrosoftADPCMGetSamplesPerBlock(uBlockSize,uNumChannels)) {
+		return 0;
+	}
+	MicrosoftADPCMState_t States[MicrosoftADPCMState_t::MAXCHANNELS];
+
+	// Parse the block header, all predictors first, then
+	// the deltas, then the two starting samples
+	Word i = 0;
+	do {
+		Word uPredictor = pInput[i];
+		if (uPredictor>=BURGER_ARRAYSIZE(s_Coefficients)) {
+			return 0;
+		}
+		MicrosoftADPCMState_t *pState = &States[i];
+		pState->m_iCoef1 = s_Coefficients[uPredictor][0];
+		pState->m_iCoef2 = s_Coefficients[uPredictor][1];
+		const Word8 *pHeader = pInput+uNumChannels+(i*2);
+		pState->m_iDelta = LoadLittleInt16(pHeader);
+		pHeader += uNumChannels*2;
+		pState->m_iSample1 = LoadLittleInt16(pHeader);
+		pHeader += uNumChannels*2;
+		pState->m_iSample2 = LoadLittleInt16(pHeader);
+		// The older sample is output first
+		pOutput[i] = static_cast<Int16>(pState->m_iSample2);
+		pOutput[i+uNumChannels] = static_cast<Int16>(pState->m_iSample1);
+	} while (++i<uNumChannels);
+
+	WordPtr uFrames = MicrosoftADPCMGetSamplesPerBlock(uBlockSize,uNumChannels);
+	WordPtr uCount = (uFrames-2)*uNumChannels;
+	pInput += uNumChannels*7;
+	pOutput += uNumChannels*2;
+	if (uCount) {
+		// Nibbles are stored high nibble first and cycle through the channels
+		Word uChannel = 0;
+		Word uNibble = 0;
+		do {
+			Word uTemp = pInput[0];
+			if (!uNibble) {
+				uTemp >>= 4U;
+			} else {
+				uTemp &= 0xFU;
+				++pInput;
+			}
+			uNibble ^= 1;
+			MicrosoftADPCMState_t *pState = &States[uChannel];
+			Int32 iDelta = pState->m_iDelta;
+			Int32 iSample = ((pState->m_iSample1*pState->m_iCoef1)+(pState->m_iSample2*pState->m_iCoef2))>>8;
+			// Sign extend the nibble
+			iSample += ((static_cast<Int32>(uTemp^8U))-8)*iDelta;
+			if (iSample>32767) {
+				iSample = 32767;
+			} else if (iSample<-32768) {
+				iSample = -32768;
+			}
+			pOutput[0] = static_cast<Int16>(iSample);
+			++pOutput;
+			pState->m_iSample2 = pState->m_iSample1;
+			pState->m_iSample1 = iSample;
+			iDelta = (s_Adaptation[uTemp]*iDelta)>>8;
+			if (iDelta<16) {
+				iDelta = 16;
+			}
+			pState->m_iDelta = iDelta;
+			if (++uChannel>=uNumChannels) {
+				uChannel = 0;
+			}
+		} while (--uCount);
+	}
+	if (pOutputStates) {
+		MemoryCopy(pOutputStates,States,sizeof(MicrosoftADPCMState_t)*uNumChannels);
+	}
+	return uFrames;
+}
+
+/*! ************************************
+
+	\brief Decompress a stream of Microsoft ADPCM blocks
+
+	Decode consecutive blocks into signed 16 bit native endian samples.
+	If the data has more than one channel, the output is interleaved. The
+	last block may be shorter than uBlockSize, as is common
+	at the end of a *.WAV file.
+
+	Since each block is self contained, a large sound can be decoded
+	in pieces, or in parallel, by passing runs of whole blocks.
+
+	\param pInput Pointer to the compressed blocks
+	\param pOutput Pointer to the buffer to receive the decompressed samples
+	\param uInputSize Number of bytes of compressed data
+	\param uBlockSize Size of each block in bytes (nBlockAlign in the *.WAV header)
+	\param uNumChannels Number of interleaved channels
+	\return Number of sample frames decoded, decoding stops at the first invalid block
+	\sa MicrosoftADPCMDecodeBlock()
+
+***************************************/
+
+WordPtr BURGER_API Burger::MicrosoftADPCMDecode(const Word8 *pInput,Int16 *pOutput,WordPtr uInputSize,WordPtr uBlockSize,Word uNumChannels)
+{
+	WordPtr uTotal = 0;
+	if (uBlockSize) {
+		while (uInputSize) {
+			WordPtr uChunk = (uInputSize<uBlockSize) ? uInputSize : uBlockSize;
+			WordPtr uFrames = MicrosoftADPCMDecodeBlock(pInput,pOutput,uChunk,uNumChannels);
+			if (!uFrames) {
+				break;
+			}
+			uTotal += uFrames;
+			pOutput += uFrames*uNumChannels;
+			pInput += uChunk;
+			uInputSize -= uChunk;
+		}
+	}
+	return uTotal;
+}
@@ -0,0 +1,39 @@
+/***************************************
+
+	Microsoft ADPCM decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRMICROSOFTADPCM_H__
+#define __BRMICROSOFTADPCM_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+struct MicrosoftADPCMState_t {
+	enum {
+		MAXCHANNELS=8		///< Maximum number of channels in a block
+	};
+	Int32 m_iSample1;		///< Last decoded sample
+	Int32 m_iSample2;		///< Sample decoded before m_iSample1
+	Int32 m_iCoef1;			///< Prediction coefficient for m_iSample1 in 8.8 fixed point
+	Int32 m_iCoef2;			///< Prediction coefficient for m_iSample2 in 8.8 fixed point
+	Int32 m_iDelta;			///< Current quantization step
+};
+extern WordPtr BURGER_API MicrosoftADPCMGetSamplesPerBlock(WordPtr uBlockSize,Word uNumChannels);
+extern WordPtr BURGER_API MicrosoftADPCMDecodeBlock(const Word8 *pInput,Int16 *pOutput,WordPtr uBlockSize,Word uNumChannels,MicrosoftADPCMState_t *pOutputStates=NULL);
+extern WordPtr BURGER_API MicrosoftADPCMDecode(const Word8 *pInput,Int16 *pOutput,WordPtr uInputSize,WordPtr uBlockSize,Word uNumChannels);
+}
+/* END */
+
+#endif
@@ -0,0 +1,168 @@
+/***************************************
+
+	u-Law decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brulaw.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
+/*! ************************************
+
+	\var Burger::g_ULawToLinearTable
+	\brief Table to convert u-Law samples to 16 bit linear samples
+
+	u-Law is the ITU G.711 logarithmic encoding used by North American
+	and Japanese telephony and by Sun *.au files. Each 8 bit value is
+	stored inverted and contains a sign bit, a 3 bit exponent and
+	a 4 bit mantissa. The table contains the decoded values scaled to
+	the full range of a signed 16 bit sample.
+
+	\sa ULawToLinear(Word) or ULawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+const Int16 Burger::g_ULawToLinearTable[256] = {
+	-32124,-31100,-30076,-29052,-28028,-27004,-25980,-24956,
+	-23932,-22908,-21884,-20860,-19836,-18812,-17788,-16764,
+	-15996,-15484,-14972,-14460,-13948,-13436,-12924,-12412,
+	-11900,-11388,-10876,-10364, -9852, -9340, -8828, -8316,
+	 -7932, -7676, -7420, -7164, -6908, -6652, -6396, -6140,
+	 -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092,
+	 -3900, -3772, -3644, -3516, -3388, -3260, -3132, -3004,
+	 -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980,
+	 -1884, -1820, -1756, -1692, -1628, -1564, -1500, -1436,
+	 -1372, -1308, -1244, -1180, -1116, -1052,  -988,  -924,
+	  -876,  -844,  -812,  -780,  -748,  -716,  -684,  -652,
+	  -620,  -588,  -556,  -524,  -492,  -460,  -428,  -396,
+	  -372,  -356,  -340,  -324,  -308,  -292,  -276,  -260,
+	  -244,  -228,  -212,  -196,  -180,  -164,  -148,  -132,
+	  -120,  -112,  -104,   -96,   -88,   -80,   -72,   -64,
+	   -56,   -48,   -40,   -32,   -24,   -16,    -8,     0,
+	 32124, 31100, 30076, 29052, 28028, 27004, 25980, 24956,
+	 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764,
+	 15996, 15484, 14972, 14460, 13948, 13436, 12924, 12412,
+	 11900, 11388, 10876, 10364,  9852,  9340,  8828,  8316,
+	  7932,  7676,  7420,  7164,  6908,  6652,  6396,  6140,
+	  5884,  5628,  5372,  5116,  4860,  4604,  4348,  4092,
+	  3900,  3772,  3644,  3516,  3388,  3260,  3132,  3004,
+	  2876,  2748,  2620,  2492,  2364,  2236,  2108,  1980,
+	  1884,  1820,  1756,  1692,  1628,  1564,  1500,  1436,
+	  1372,  1308,  1244,  1180,  1116,  1052,   988,   924,
+	   876,   844,   812,   780,   748,   716,   684,   652,
+	   620,   588,   556,   524,   492,   460,   428,   396,
+	   372,   356,   340,   324,   308,   292,   276,   260,
+	   244,   228,   212,   196,   180,   164,   148,   132,
+	   120,   112,   104,    96,    88,    80,    72,    64,
+	    56,    48,    40,    32,    24,    16,     8,     0
+};
+
+/*! ************************************
+
+	\fn Int16 Burger::ULawToLinear(Word uInput)
+	\brief Convert a u-Law sample to a 16 bit linear sample
+
+	\param uInput u-Law encoded sample (Only the lower 8 bits are used)
+	\return Signed 16 bit sample
+	\sa ULawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Decompress u-Law audio to 16 bit samples
+
+	Convert a buffer of u-Law samples to signed 16 bit samples
+	in native endian. Since every sample is a single byte, interleaved
+	multi-channel data is converted in place to interleaved 16 bit
+	samples.
+
+	On SSE2 and NEON targets, 16 samples are decoded at a time
+	by computing the G.711 expansion in parallel, the results are
+	identical to g_ULawToLinearTable.
+
+	\param pInput Pointer to the u-Law samples
+	\param pOutput Pointer to the buffer to receive uCount 16 bit samples
+	\param uCount Number of samples to convert
+	\sa ULawToLinear(Word) or ALawExpand(const Word8 *,Int16 *,WordPtr)
+
+***************************************/
+
+#if defined(BURGER_SSE2)
+static BURGER_INLINE __m128i ULawExpand8(__m128i vInput)
+{
+	// vInput has inverted u-Law bytes in the lower 8 bits of each lane
+	const __m128i vBias = _mm_set1_epi16(0x84);
+	__m128i vTemp = _mm_add_epi16(_mm_slli_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x0F)),3),vBias);
+	// Shift left by the exponent, one bit of the exponent at a time
+	__m128i vMask = _mm_cmpeq_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x10)),_mm_set1_epi16(0x10));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,1)),_mm_andnot_si128(vMask,vTemp));
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x20)),_mm_set1_epi16(0x20));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,2)),_mm_andnot_si128(vMask,vTemp));
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x40)),_mm_set1_epi16(0x40));
+	vTemp = _mm_or_si128(_mm_and_si128(vMask,_mm_slli_epi16(vTemp,4)),_mm_andnot_si128(vMask,vTemp));
+	// Apply the sign
+	vMask = _mm_cmpeq_epi16(_mm_and_si128(vInput,_mm_set1_epi16(0x80)),_mm_set1_epi16(0x80));
+	return _mm_or_si128(_mm_and_si128(vMask,_mm_sub_epi16(vBias,vTemp)),_mm_andnot_si128(vMask,_mm_sub_epi16(vTemp,vBias)));
+}
+#elif defined(BURGER_NEON)
+static BURGER_INLINE int16x8_t ULawExpand8(uint16x8_t vInput)
+{
+	// vInput has inverted u-Law bytes in the lower 8 bits of each lane
+	const int16x8_t vBias = vdupq_n_s16(0x84);
+	int16x8_t vTemp = vaddq_s16(vreinterpretq_s16_u16(vshlq_n_u16(vandq_u16(vInput,vdupq_n_u16(0x0F)),3)),vBias);
+	int16x8_t vExponent = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(vInput,4),vdupq_n_u16(7)));
+	vTemp = vshlq_s16(vTemp,vExponent);
+	uint16x8_t vMask = vtstq_u16(vInput,vdupq_n_u16(0x80));
+	return vbslq_s16(vMask,vsubq_s16(vBias,vTemp),vsubq_s16(vTemp,vBias));
+}
+#endif
+
+void BURGER_API Burger::ULawExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uCount)
+{
+#if defined(BURGER_SSE2)
+	if (uCount>=16) {
+		const __m128i vInvert = _mm_set1_epi8(-1);
+		const __m128i vZero = _mm_setzero_si128();
+		do {
+			__m128i vInput = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)),vInvert);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput),ULawExpand8(_mm_unpacklo_epi8(vInput,vZero)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pOutput+8),ULawExpand8(_mm_unpackhi_epi8(vInput,vZero)));
+			pInput += 16;
+			pOutput += 16;
+			uCount -= 16;
+		} while (uCount>=16);
+	}
+#elif defined(BURGER_NEON)
+	if (uCount>=16) {
+		do {
+			uint8x16_t vInput = vmvnq_u8(vld1q_u8(pInput));
+			vst1q_s16(pOutput,ULawExpand8(vmovl_u8(vget_low_u8(vInput))));
+			vst1q_s16(pOutput+8,ULawExpand8(vmovl_u8(vget_high_u8(vInput))));
+			pInput += 16;
+			pOutput += 16;
+			uCount -= 16;
+		} while (uCount>=16);
+	}
+#endif
+	if (uCount) {
+		const Int16 *pTable = g_ULawToLinearTable;
+		do {
+			pOutput[0] = pTable[pInput[0]];
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+}
@@ -0,0 +1,29 @@
+/***************************************
+
+	u-Law decompressor
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRULAW_H__
+#define __BRULAW_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+extern const Int16 g_ULawToLinearTable[256];
+BURGER_INLINE Int16 ULawToLinear(Word uInput) { return g_ULawToLinearTable[uInput&0xFFU]; }
+extern void BURGER_API ULawExpand(const Word8 *pInput,Int16 *pOutput,WordPtr uCount);
+}
+/* END */
+
+#endif
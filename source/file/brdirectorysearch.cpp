@@ -52,12 +52,17 @@
 			
 ***************************************/
 
-Burger::DirectorySearch::DirectorySearch()
+Burger::DirectorySearch::DirectorySearch() :
+	m_bLink(FALSE)
 {
 #if defined(BURGER_MAC)
 	m_pIterator = NULL;		// I do not own an iterator object, yet
 #elif defined(BURGER_MACOSX) || defined(BURGER_IOS)
 	m_fp = -1;
+#elif defined(BURGER_LINUX)
+	m_iDirectory = -1;
+	m_uBufferIndex = 0;
+	m_uBufferSize = 0;
 #elif defined(BURGER_MSDOS)
 	m_bHandleOk = 0;		// No file open yet
 #elif defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)
@@ -104,7 +109,7 @@ Word Burger::DirectorySearch::Open(const char *pDirName)
 			
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360))
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX))
 Word Burger::DirectorySearch::Open(Filename * /* pDirName */)
 {
 	return TRUE;		// Error!
@@ -125,7 +130,7 @@ Word Burger::DirectorySearch::Open(Filename * /* pDirName */)
 			
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word Burger::DirectorySearch::GetNextEntry(void)
 {
 	return TRUE;		// Error!
@@ -186,7 +191,7 @@ Word Burger::DirectorySearch::GetNextEntryExtension(const char *pExt)
 			
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 void Burger::DirectorySearch::Close(void)
 {
 }
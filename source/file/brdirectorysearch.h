@@ -49,6 +49,7 @@ public:
 	Word8 m_bSystem;		///< True if this is a system file
 	Word8 m_bHidden;		///< True if this file is hidden
 	Word8 m_bLocked;		///< True if this file is read only
+	Word8 m_bLink;			///< True if this is a symbolic link or junction (Always false on platforms without links)
 	char m_Name[256];		///< UTF8 Filename
 #if (defined(BURGER_MACOS) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	Word32 m_uFileType;		///< File's type (MacOS and iOS Only)
@@ -61,6 +62,12 @@ private:
 #if (defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	int m_fp;				///< Open directory file (MacOSX Only)
 #endif
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	int m_iDirectory;		///< Open directory file descriptor (Linux Only)
+	Word m_uBufferIndex;	///< Offset to the next entry in m_Buffer (Linux Only)
+	Word m_uBufferSize;		///< Number of valid bytes in m_Buffer (Linux Only)
+	Word64 m_Buffer[512];	///< 4K batch of linux_dirent64 records from getdents64(), Word64 for alignment (Linux Only)
+#endif
 #if defined(BURGER_MSDOS) || defined(DOXYGEN)
 	Word m_bHandleOk;		///< Handle is valid (MSDOS Only)
 	short m_sFileHandle;	///< Handle to the open directory (MSDOS Only)
@@ -0,0 +1,474 @@
+/***************************************
+
+	Multithreaded recursive directory scanner
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdirectorywalker.h"
+#include "brdirectorysearch.h"
+#include "brfile.h"
+#include "bratomic.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\class Burger::DirectoryWalker
+	\brief Scan a directory tree on multiple threads
+
+	Scanning a large tree of directories one at a time with
+	DirectorySearch leaves the CPU waiting on the file system for
+	every directory. This class keeps a list of directories that
+	have yet to be scanned and has a number of threads pull
+	directories from it, so several directories are read
+	at once. Subdirectories found by a thread are added to the
+	list for any thread to pick up.
+
+	The filenames are tested against a wildcard pattern that's
+	compiled once into a GlobPattern, and the entries that match
+	are collected into batches and passed to a callback function,
+	so the callback isn't invoked for every file. The size,
+	dates and flags of each entry are retrieved while the directory
+	is read, so the callback doesn't need to query each file.
+
+	The callback is only called by one thread at a time, so it
+	does not need to be thread safe, however the order of the
+	entries is not defined.
+
+	\code
+	static void BURGER_API FoundTextures(void *pData,const Burger::DirectoryWalker::Entry_t *pEntries,WordPtr uCount)
+	{
+		TextureList *pList = static_cast<TextureList *>(pData);
+		do {
+			pList->Add(pEntries->m_pPath,pEntries->m_uFileSize);
+			++pEntries;
+		} while (--uCount);
+	}
+
+	Burger::DirectoryWalker Walker;
+	Walker.Walk("9:data:","*.png;*.tga",FoundTextures,&MyTextureList);
+	\endcode
+
+	\sa DirectorySearch or GlobPattern
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::DirectoryWalker::Entry_t
+	\brief Description of a file found by DirectoryWalker
+
+	The strings are only valid until the callback returns,
+	so they must be copied if they are needed later.
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::DirectoryWalker::BatchProc
+	\brief Function to receive entries found by Walk()
+
+	The first parameter is the data pointer passed to Walk(),
+	followed by a pointer to an array of entries and the number
+	of entries in the array, which is never zero.
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize the scanner
+
+	\sa Walk(const char *,const char *,BatchProc,void *,Word,Word)
+
+***************************************/
+
+Burger::DirectoryWalker::DirectoryWalker() :
+	m_Pattern(),
+	m_pProc(NULL),
+	m_pData(NULL),
+	m_pPending(NULL),
+	m_uFlags(0),
+	m_uActive(0),
+	m_bDone(FALSE),
+	m_uError(File::OKAY),
+	m_uDirectoryCount(0),
+	m_uEntryCount(0)
+{
+}
+
+/*! ************************************
+
+	\brief Release resources
+
+***************************************/
+
+Burger::DirectoryWalker::~DirectoryWalker()
+{
+	ReleasePending();
+}
+
+/*! ************************************
+
+	\brief Scan a directory and optionally all of its subdirectories
+
+	The scan is performed by the calling thread and up to
+	uMaxThreads-1 worker threads, and this function
+	returns once all the directories have been scanned and
+	all entries have been passed to the callback.
+
+	Each file, and each directory if \ref FLAG_DIRECTORIES is
+	set, whose name matches the pattern is passed to pProc.
+	The pattern only applies to the names of the entries, all
+	subdirectories are scanned if \ref FLAG_RECURSE is set.
+	Symbolic links to directories are reported but not scanned,
+	so link loops can't cause infinite recursion, and directories
+	deeper than \ref MAXDEPTH levels are skipped.
+
+	\param pDirName Pointer to a "C" string of the directory to scan in BurgerLib format
+	\param pPattern Pointer to a wildcard pattern in GlobPattern format, \ref NULL matches everything
+	\param pProc Function to receive the entries that match
+	\param pData Pointer passed to pProc
+	\param uFlags Any combination of \ref FLAG_RECURSE, \ref FLAG_DIRECTORIES, \ref FLAG_HIDDEN and \ref FLAG_CASESENSITIVE
+	\param uMaxThreads Maximum number of threads to use, zero means Thread::GetProcessorCount()
+	\return File::OKAY if no error, File::FILENOTFOUND if the directory can't be opened, File::OUTOFRANGE if the pattern is too long, a pathname is longer than \ref BATCHTEXTSIZE or out of memory
+	\sa GlobPattern::Compile(const char *,Word)
+
+***************************************/
+
+Word BURGER_API Burger::DirectoryWalker::Walk(const char *pDirName,const char *pPattern,BatchProc pProc,void *pData,Word uFlags,Word uMaxThreads)
+{
+	m_uDirectoryCount = 0;
+	m_uEntryCount = 0;
+	if (!pPattern) {
+		pPattern = "*";
+	}
+	if (m_Pattern.Compile(pPattern,(uFlags&FLAG_CASESENSITIVE) ? static_cast<Word>(GlobPattern::FLAG_CASESENSITIVE) : 0U)) {
+		return File::OUTOFRANGE;
+	}
+
+	// Set up the starting directory
+	Directory_t *pRoot = NewDirectory(pDirName,StringLength(pDirName),NULL,0);
+	if (!pRoot) {
+		return File::OUTOFRANGE;
+	}
+
+	m_pProc = pProc;
+	m_pData = pData;
+	m_uFlags = uFlags;
+	m_uActive = 0;
+	m_bDone = FALSE;
+	m_uError = File::OKAY;
+	// The root must be on the list before any thread starts
+	// since Thread::Start() runs the thread immediately on
+	// platforms without threads
+	m_pPending = pRoot;
+
+	// Only one directory to scan if not recursing
+	if (!(uFlags&FLAG_RECURSE)) {
+		uMaxThreads = 1;
+	} else if (uMaxThreads>MAXTHREADS) {
+		uMaxThreads = MAXTHREADS;
+	}
+	ParallelRun(WorkerThread,this,uMaxThreads);
+
+	// If no thread could get a batch buffer, nothing was scanned
+	if (m_pPending) {
+		m_uError = File::OUTOFRANGE;
+	}
+	ReleasePending();
+	m_pProc = NULL;
+	m_pData = NULL;
+	return m_uError;
+}
+
+/*! ************************************
+
+	\fn Word Burger::DirectoryWalker::GetDirectoryCount(void) const
+	\brief Return the number of directories scanned by the last call to Walk()
+
+	\return Number of directories scanned
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::DirectoryWalker::GetEntryCount(void) const
+	\brief Return the number of entries passed to the callback by the last call to Walk()
+
+	\return Number of matching entries found
+
+***************************************/
+
+/*! ************************************
+
+	\brief Entry point for the worker threads
+
+	Every thread needs its own batch buffer. If one can't
+	be allocated, the thread exits and the other threads
+	perform the work. This is called on the thread that
+	called Walk() as well.
+
+	\param pThis Pointer to the DirectoryWalker
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::DirectoryWalker::WorkerThread(void *pThis)
+{
+	Batch_t *pBatch = static_cast<Batch_t *>(Alloc(sizeof(Batch_t)));
+	if (pBatch) {
+		pBatch->m_uCount = 0;
+		pBatch->m_uTextSize = 0;
+		static_cast<DirectoryWalker *>(pThis)->ScanAll(pBatch);
+		Free(pBatch);
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Allocate a directory record
+
+	Create a record with the concatenation of a path
+	and a name, ending with a colon.
+
+	\param pPath Pointer to the directory name
+	\param uPathLength Length of the directory name in bytes
+	\param pName Pointer to a "C" string of a filename to append or \ref NULL
+	\param uDepth Number of directories below the starting directory
+	\return Pointer to the new record or \ref NULL if out of memory
+
+***************************************/
+
+Burger::DirectoryWalker::Directory_t * BURGER_API Burger::DirectoryWalker::NewDirectory(const char *pPath,WordPtr uPathLength,const char *pName,Word uDepth)
+{
+	WordPtr uNameLength = 0;
+	if (pName) {
+		uNameLength = StringLength(pName);
+	}
+	// Add room for the colon and zero terminator
+	Directory_t *pDirectory = static_cast<Directory_t *>(Alloc(sizeof(Directory_t)+uPathLength+uNameLength));
+	if (pDirectory) {
+		pDirectory->m_pNext = NULL;
+		pDirectory->m_uDepth = uDepth;
+		char *pOutput = pDirectory->m_Path;
+		MemoryCopy(pOutput,pPath,uPathLength);
+		pOutput += uPathLength;
+		MemoryCopy(pOutput,pName,uNameLength);
+		pOutput += uNameLength;
+		if ((pOutput!=pDirectory->m_Path) && (pOutput[-1]!=':')) {
+			pOutput[0] = ':';
+			++pOutput;
+		}
+		pOutput[0] = 0;
+	}
+	return pDirectory;
+}
+
+/*! ************************************
+
+	\brief Scan directories until they are all done
+
+	Pull a directory from the list and scan it. If the list is empty
+	but other threads are still scanning, wait for them to add more
+	directories or to finish. When there's nothing left, pass
+	any entries in the batch to the callback.
+
+	\param pBatch Pointer to this thread's batch buffer
+
+***************************************/
+
+void BURGER_API Burger::DirectoryWalker::ScanAll(Batch_t *pBatch)
+{
+	DirectorySearch Search;
+	m_Lock.Lock();
+	for (;;) {
+		Directory_t *pDirectory = m_pPending;
+		if (pDirectory) {
+			m_pPending = pDirectory->m_pNext;
+			++m_uActive;
+			m_Lock.Unlock();
+
+			ScanDirectory(&Search,pDirectory,pBatch);
+			Free(pDirectory);
+
+			m_Lock.Lock();
+			// Subdirectories were already added, so if nothing is
+			// running and nothing is pending, it's all done
+			if (!--m_uActive && !m_pPending) {
+				m_bDone = TRUE;
+				m_WorkReady.Broadcast();
+			}
+		} else {
+			// Exit if finished or if threads are not supported
+			if (m_bDone || m_WorkReady.Wait(&m_Lock)) {
+				break;
+			}
+		}
+	}
+	m_Lock.Unlock();
+	Flush(pBatch);
+}
+
+/*! ************************************
+
+	\brief Scan a single directory
+
+	Matching entries are added to the batch and subdirectories
+	are added to the pending list all at once when the scan is
+	complete, so the lock is only taken once per directory.
+
+	\param pSearch Pointer to a DirectorySearch to use for scanning
+	\param pDirectory Pointer to the directory to scan
+	\param pBatch Pointer to this thread's batch buffer
+
+***************************************/
+
+void BURGER_API Burger::DirectoryWalker::ScanDirectory(DirectorySearch *pSearch,const Directory_t *pDirectory,Batch_t *pBatch)
+{
+	AtomicPreIncrement(&m_uDirectoryCount);
+	if (pSearch->Open(pDirectory->m_Path)) {
+		// Only report an error if the starting directory is missing
+		if (!pDirectory->m_uDepth) {
+			m_uError = File::FILENOTFOUND;
+		}
+	} else {
+		Word uFlags = m_uFlags;
+		WordPtr uPathLength = StringLength(pDirectory->m_Path);
+		Word uDepth = pDirectory->m_uDepth+1;
+		Directory_t *pFirst = NULL;
+		Directory_t **ppLast = &pFirst;
+		while (!pSearch->GetNextEntry()) {
+			if (pSearch->m_bHidden && !(uFlags&FLAG_HIDDEN)) {
+				continue;
+			}
+			if (pSearch->m_bDir) {
+				if ((uFlags&FLAG_RECURSE) && !pSearch->m_bLink && (uDepth<MAXDEPTH)) {
+					Directory_t *pNew = NewDirectory(pDirectory->m_Path,uPathLength,pSearch->m_Name,uDepth);
+					if (pNew) {
+						ppLast[0] = pNew;
+						ppLast = &pNew->m_pNext;
+					}
+				}
+				if (!(uFlags&FLAG_DIRECTORIES)) {
+					continue;
+				}
+			}
+			if (m_Pattern.Match(pSearch->m_Name)) {
+				AddEntry(pBatch,pSearch,pDirectory,uPathLength,uDepth-1);
+			}
+		}
+		pSearch->Close();
+
+		// Hand the subdirectories to the other threads
+		if (pFirst) {
+			m_Lock.Lock();
+			ppLast[0] = m_pPending;
+			m_pPending = pFirst;
+			m_WorkReady.Broadcast();
+			m_Lock.Unlock();
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Add a directory entry to the batch
+
+	If the batch is full, it's passed to the callback first.
+	If the pathname is too long to fit in an empty batch, the
+	entry is skipped and Walk() will return File::OUTOFRANGE.
+
+	\param pBatch Pointer to this thread's batch buffer
+	\param pSearch Pointer to the DirectorySearch with the entry
+	\param pDirectory Pointer to the directory being scanned
+	\param uPathLength Length of the directory's pathname
+	\param uDepth Depth of the directory being scanned
+
+***************************************/
+
+void BURGER_API Burger::DirectoryWalker::AddEntry(Batch_t *pBatch,const DirectorySearch *pSearch,const Directory_t *pDirectory,WordPtr uPathLength,Word uDepth)
+{
+	WordPtr uNameLength = StringLength(pSearch->m_Name);
+	// Zero terminator and a trailing colon for directories
+	WordPtr uLength = uPathLength+uNameLength+1+pSearch->m_bDir;
+	if (uLength<=BATCHTEXTSIZE) {
+		if ((pBatch->m_uCount>=BATCHSIZE) || ((pBatch->m_uTextSize+uLength)>BATCHTEXTSIZE)) {
+			Flush(pBatch);
+		}
+		char *pOutput = pBatch->m_Text+pBatch->m_uTextSize;
+		pBatch->m_uTextSize += uLength;
+		Entry_t *pEntry = &pBatch->m_Entries[pBatch->m_uCount];
+		++pBatch->m_uCount;
+
+		pEntry->m_pPath = pOutput;
+		MemoryCopy(pOutput,pDirectory->m_Path,uPathLength);
+		pOutput += uPathLength;
+		pEntry->m_pName = pOutput;
+		MemoryCopy(pOutput,pSearch->m_Name,uNameLength);
+		pOutput += uNameLength;
+		if (pSearch->m_bDir) {
+			pOutput[0] = ':';
+			++pOutput;
+		}
+		pOutput[0] = 0;
+		pEntry->m_uFileSize = pSearch->m_uFileSize;
+		pEntry->m_CreationDate = pSearch->m_CreationDate;
+		pEntry->m_ModificationDate = pSearch->m_ModificatonDate;
+		pEntry->m_uDepth = uDepth;
+		pEntry->m_bDir = pSearch->m_bDir;
+		pEntry->m_bSystem = pSearch->m_bSystem;
+		pEntry->m_bHidden = pSearch->m_bHidden;
+		pEntry->m_bLocked = pSearch->m_bLocked;
+	} else {
+		m_uError = File::OUTOFRANGE;
+	}
+}
+
+/*! ************************************
+
+	\brief Pass the batch to the callback
+
+	Only one thread at a time calls the callback. The
+	batch is empty on exit.
+
+	\param pBatch Pointer to this thread's batch buffer
+
+***************************************/
+
+void BURGER_API Burger::DirectoryWalker::Flush(Batch_t *pBatch)
+{
+	WordPtr uCount = pBatch->m_uCount;
+	if (uCount) {
+		AtomicAdd(&m_uEntryCount,static_cast<Word32>(uCount));
+		m_CallbackLock.Lock();
+		m_pProc(m_pData,pBatch->m_Entries,uCount);
+		m_CallbackLock.Unlock();
+		pBatch->m_uCount = 0;
+		pBatch->m_uTextSize = 0;
+	}
+}
+
+/*! ************************************
+
+	\brief Dispose of all pending directory records
+
+***************************************/
+
+void BURGER_API Burger::DirectoryWalker::ReleasePending(void)
+{
+	Directory_t *pDirectory = m_pPending;
+	m_pPending = NULL;
+	while (pDirectory) {
+		Directory_t *pNext = pDirectory->m_pNext;
+		Free(pDirectory);
+		pDirectory = pNext;
+	}
+}
@@ -0,0 +1,104 @@
+/***************************************
+
+	Multithreaded recursive directory scanner
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRDIRECTORYWALKER_H__
+#define __BRDIRECTORYWALKER_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRTIMEDATE_H__
+#include "brtimedate.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+#ifndef __BRGLOBPATTERN_H__
+#include "brglobpattern.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class DirectorySearch;
+class DirectoryWalker {
+	BURGER_DISABLECOPYCONSTRUCTORS(DirectoryWalker);
+public:
+	struct Entry_t {
+		const char *m_pPath;			///< Full BurgerLib pathname, directories end with a colon
+		const char *m_pName;			///< Pointer to the filename inside of m_pPath
+		WordPtr m_uFileSize;			///< Size of the file in bytes, zero for directories
+		TimeDate_t m_CreationDate;		///< File creation time
+		TimeDate_t m_ModificationDate;	///< File last modification time
+		Word m_uDepth;					///< Number of directories below the starting directory
+		Word8 m_bDir;					///< \ref TRUE if this is a directory
+		Word8 m_bSystem;				///< \ref TRUE if this is a system file
+		Word8 m_bHidden;				///< \ref TRUE if this file is hidden
+		Word8 m_bLocked;				///< \ref TRUE if this file is read only
+	};
+	typedef void (BURGER_API *BatchProc)(void *pData,const Entry_t *pEntries,WordPtr uCount);	///< Batch callback function prototype
+	enum {
+		BATCHSIZE=256,				///< Maximum number of entries passed to the callback at once
+		BATCHTEXTSIZE=32768,		///< Bytes of pathname storage for each batch
+		MAXTHREADS=16,				///< Maximum number of threads used for scanning
+		MAXDEPTH=64,				///< Deepest level of directories scanned
+		FLAG_RECURSE=0x01,			///< Scan all the directories inside the starting directory
+		FLAG_DIRECTORIES=0x02,		///< Pass directories that match the pattern to the callback
+		FLAG_HIDDEN=0x04,			///< Include hidden files and directories
+		FLAG_CASESENSITIVE=0x08		///< Match the pattern with case sensitivity
+	};
+private:
+	struct Directory_t {
+		Directory_t *m_pNext;		///< Next directory to scan
+		Word m_uDepth;				///< Number of directories below the starting directory
+		char m_Path[4];				///< Full pathname of the directory (Variable length)
+	};
+	struct Batch_t {
+		WordPtr m_uCount;			///< Number of valid entries in m_Entries
+		WordPtr m_uTextSize;		///< Number of bytes used in m_Text
+		Entry_t m_Entries[BATCHSIZE];	///< Entries waiting to be passed to the callback
+		char m_Text[BATCHTEXTSIZE];	///< Storage for the pathnames in m_Entries
+	};
+	GlobPattern m_Pattern;			///< Compiled filename pattern
+	BatchProc m_pProc;				///< Function to receive the entries
+	void *m_pData;					///< Data pointer passed to m_pProc
+	Directory_t *m_pPending;		///< Directories waiting to be scanned (Guarded by m_Lock)
+	Word m_uFlags;					///< Flags passed to Walk()
+	Word m_uActive;					///< Number of threads scanning a directory (Guarded by m_Lock)
+	Word m_bDone;					///< \ref TRUE when all directories are scanned (Guarded by m_Lock)
+	Word m_uError;					///< Error code for Walk()
+	volatile Word32 m_uDirectoryCount;	///< Number of directories scanned
+	volatile Word32 m_uEntryCount;	///< Number of entries passed to the callback
+	CriticalSection m_Lock;			///< Lock for the pending directory list
+	CriticalSection m_CallbackLock;	///< Lock so only one thread calls m_pProc at a time
+	ConditionVariable m_WorkReady;	///< Signaled when directories are added or all work is done
+	static WordPtr BURGER_API WorkerThread(void *pThis);
+	static Directory_t * BURGER_API NewDirectory(const char *pPath,WordPtr uPathLength,const char *pName,Word uDepth);
+	void BURGER_API ScanAll(Batch_t *pBatch);
+	void BURGER_API ScanDirectory(DirectorySearch *pSearch,const Directory_t *pDirectory,Batch_t *pBatch);
+	void BURGER_API AddEntry(Batch_t *pBatch,const DirectorySearch *pSearch,const Directory_t *pDirectory,WordPtr uPathLength,Word uDepth);
+	void BURGER_API Flush(Batch_t *pBatch);
+	void BURGER_API ReleasePending(void);
+public:
+	DirectoryWalker();
+	~DirectoryWalker();
+	Word BURGER_API Walk(const char *pDirName,const char *pPattern,BatchProc pProc,void *pData=NULL,Word uFlags=FLAG_RECURSE,Word uMaxThreads=0);
+	BURGER_INLINE Word GetDirectoryCount(void) const { return m_uDirectoryCount; }
+	BURGER_INLINE Word GetEntryCount(void) const { return m_uEntryCount; }
+};
+}
+/* END */
+
+#endif
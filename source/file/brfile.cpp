@@ -13,6 +13,7 @@
 
 #include "brfile.h"
 #include "brendian.h"
+#include "brcriticalsection.h"
 #include <stdio.h>
 
 /*! ************************************
@@ -205,7 +206,7 @@ Word Burger::File::Open(const char *pFileName,eFileAccess eAccess)
 
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word Burger::File::Open(Filename *pFileName,eFileAccess eAccess)
 {
 	static const char *g_OpenFlags[4] = {
@@ -481,6 +482,122 @@ Word Burger::File::SetCreationTime(const TimeDate_t * /* pInput */)
 }
 #endif
 
+/*! ************************************
+
+	\brief Read data from an open file at a specific offset
+
+	If a file is open, read data starting at the offset into the file
+	without using the shared file mark. Several threads can read
+	from the same File this way without serializing on
+	GetMark() and SetMark().
+
+	\note On platforms without native positional reads, the
+	file mark is saved, moved, and restored around a call to Read()
+	while holding a global lock, so concurrent calls to
+	ReadAt() and WriteAt() are safe, but calls to Read() or Write()
+	performed at the same time on another thread are not.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa WriteAt(Word64,const void *,WordPtr) or Read(void *,WordPtr)
+
+***************************************/
+
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_MACOSX) || defined(BURGER_LINUX)) || defined(DOXYGEN)
+static Burger::CriticalSectionStatic g_PositionalLock;
+
+WordPtr Burger::File::ReadAt(Word64 uOffset,void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	// The mark can't go beyond the range of a WordPtr
+	if (uSize && pOutput && m_pFile && (uOffset==static_cast<WordPtr>(uOffset))) {
+		g_PositionalLock.Lock();
+		WordPtr uOldMark = GetMark();
+		if (SetMark(static_cast<WordPtr>(uOffset))==OKAY) {
+			uResult = Read(pOutput,uSize);
+		}
+		SetMark(uOldMark);
+		g_PositionalLock.Unlock();
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Write data into an open file at a specific offset
+
+	If a file is open, write data starting at the offset into the file
+	without using the shared file mark.
+
+	\note On platforms without native positional writes, the
+	file mark is saved, moved, and restored around a call to Write()
+	while holding a global lock.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa ReadAt(Word64,void *,WordPtr) or Write(const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::WriteAt(Word64 uOffset,const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput && m_pFile && (uOffset==static_cast<WordPtr>(uOffset))) {
+		g_PositionalLock.Lock();
+		WordPtr uOldMark = GetMark();
+		if (SetMark(static_cast<WordPtr>(uOffset))==OKAY) {
+			uResult = Write(pInput,uSize);
+		}
+		SetMark(uOldMark);
+		g_PositionalLock.Unlock();
+	}
+	return uResult;
+}
+#endif
+
+/*! ************************************
+
+	\brief Write several buffers into an open file at a specific offset
+
+	If a file is open, write the buffers one after another starting at
+	the offset into the file without using the shared file mark. On
+	platforms that support it, all of the buffers are sent to the
+	operating system with a single call.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pVectors Pointer to an array of buffer descriptions
+	\param uCount Number of entries in pVectors
+	\return Number of bytes written (Can be less than what was requested due to write errors)
+	\sa WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+#if !defined(BURGER_LINUX) || defined(DOXYGEN)
+WordPtr Burger::File::WriteAt(Word64 uOffset,const IOVector_t *pVectors,WordPtr uCount)
+{
+	WordPtr uResult = 0;
+	if (uCount) {
+		do {
+			WordPtr uLength = pVectors->m_uLength;
+			if (uLength) {
+				WordPtr uWritten = WriteAt(uOffset+uResult,pVectors->m_pBuffer,uLength);
+				uResult += uWritten;
+				// Stop on a write error
+				if (uWritten!=uLength) {
+					break;
+				}
+			}
+			++pVectors;
+		} while (--uCount);
+	}
+	return uResult;
+}
+#endif
+
 /*! ************************************
 
 	\fn Burger::File::SetAuxType(Word32 uAuxType)
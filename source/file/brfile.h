@@ -28,7 +28,9 @@
 
 /* BEGIN */
 namespace Burger {
+class FileIOQueue;
 class File {
+	friend class FileIOQueue;
 public:
 	enum eFileAccess {
 		READONLY=0x00,		///< Open file with read access only
@@ -45,6 +47,10 @@ public:
 		OUTOFRANGE=5,		///< Parameter out of range
 		FILENOTFOUND=6		///< File not found
 	};
+	struct IOVector_t {
+		const void *m_pBuffer;	///< Pointer to the data
+		WordPtr m_uLength;		///< Number of bytes in the buffer
+	};
 	File();
 	File(const char *pFileName,eFileAccess eAccess=READONLY);
 	File(Filename *pFileName,eFileAccess eAccess=READONLY);
@@ -58,6 +64,9 @@ public:
 	WordPtr GetSize(void);
 	WordPtr Read(void *pOutput,WordPtr uSize);
 	WordPtr Write(const void *pInput,WordPtr uSize);
+	WordPtr ReadAt(Word64 uOffset,void *pOutput,WordPtr uSize);
+	WordPtr WriteAt(Word64 uOffset,const void *pInput,WordPtr uSize);
+	WordPtr WriteAt(Word64 uOffset,const IOVector_t *pVectors,WordPtr uCount);
 	WordPtr GetMark(void);
 	Word SetMark(WordPtr uMark);
 	Word SetMarkAtEOF(void);
@@ -0,0 +1,690 @@
+/***************************************
+
+	Asynchronous file I/O queue
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfileioqueue.h"
+#include "brglobalmemorymanager.h"
+
+/*! ************************************
+
+	\class Burger::FileIOQueue
+	\brief Queue of asynchronous file reads and writes
+
+	File::Read() and File::Write() block and share the file mark,
+	so only one transfer per file can be performed at a time. This
+	class accepts any number of positional reads and writes, hands
+	them to the operating system in batches, and calls a completion
+	function for each one when it's done. A loader can keep dozens
+	of reads in flight and decode data as it arrives.
+
+	Requests are queued with ReadAsync() or WriteAsync() and are
+	not started until Submit() is called, so a batch can be sent
+	with a single call to the operating system. Completion functions
+	are only called from Poll(), WaitForCompletion() or WaitAll()
+	on the thread that owns the queue, so they don't need to be
+	thread safe and they are free to queue more requests. The one
+	exception is when every request is in use. ReadAsync() and
+	WriteAsync() then call WaitForCompletion() to free a request,
+	which calls the completion functions of the requests that
+	finished. Use a depth large enough for the requests that
+	are queued between calls to Poll() if that's a problem.
+
+	On Linux, the requests are performed by the kernel with io_uring.
+	If io_uring is not available, or on other platforms, a pool of worker
+	threads calls File::ReadAt() and File::WriteAt(). On platforms without
+	threads, the requests are performed by Submit().
+
+	\code
+	static void BURGER_API ChunkLoaded(void *pData,Word uError,WordPtr uRead)
+	{
+		if (!uError) {
+			DecodeChunk(static_cast<Chunk_t *>(pData),uRead);
+		}
+	}
+
+	Burger::FileIOQueue Queue;
+	Queue.Init();
+	for (Word i=0;i<uChunkCount;i++) {
+		Queue.ReadAsync(&MyFile,pChunks[i].m_uOffset,pChunks[i].m_pBuffer,pChunks[i].m_uSize,ChunkLoaded,&pChunks[i]);
+	}
+	Queue.WaitAll();
+	\endcode
+
+	\note The File and buffer for each request must remain valid
+	until its completion function is called.
+
+	\sa File::ReadAt(Word64,void *,WordPtr) or File::WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::FileIOQueue::CompletionProc
+	\brief Function called when a request completes
+
+	The first parameter is the data pointer passed to ReadAsync()
+	or WriteAsync(), the second is File::OKAY or a File error code
+	and the third is the number of bytes transferred. A read that
+	hits the end of the file completes with File::OKAY and the number
+	of bytes that were available.
+
+***************************************/
+
+/*! ************************************
+
+	\brief Create an uninitialized queue
+
+	\sa Init(Word,Word,Word)
+
+***************************************/
+
+Burger::FileIOQueue::FileIOQueue() :
+	m_pRequests(NULL),
+	m_pFreeList(NULL),
+	m_pQueuedFirst(NULL),
+	m_ppQueuedLast(&m_pQueuedFirst),
+	m_pWorkFirst(NULL),
+	m_ppWorkLast(&m_pWorkFirst),
+	m_pDoneFirst(NULL),
+	m_ppDoneLast(&m_pDoneFirst),
+	m_uDepth(0),
+	m_uQueued(0),
+	m_uInFlight(0),
+	m_eBackend(BACKEND_NONE),
+	m_uWorkerCount(0),
+	m_bQuit(FALSE),
+	m_Lock(),
+	m_WorkReady(),
+	m_WorkDone()
+#if defined(BURGER_LINUX)
+	,m_iRing(-1),
+	m_pSubmissionRing(NULL),
+	m_uSubmissionRingSize(0),
+	m_pCompletionRing(NULL),
+	m_uCompletionRingSize(0),
+	m_pSubmissionEntries(NULL),
+	m_uSubmissionEntriesSize(0),
+	m_pSubmissionHead(NULL),
+	m_pSubmissionTail(NULL),
+	m_pSubmissionArray(NULL),
+	m_uSubmissionMask(0),
+	m_uCompletionMask(0),
+	m_pCompletionHead(NULL),
+	m_pCompletionTail(NULL),
+	m_pCompletionEntries(NULL)
+#endif
+{
+}
+
+/*! ************************************
+
+	\brief Wait for all pending I/O and release resources
+
+	\sa Shutdown(void)
+
+***************************************/
+
+Burger::FileIOQueue::~FileIOQueue()
+{
+	Shutdown();
+}
+
+/*! ************************************
+
+	\brief Initialize the queue
+
+	Allocate the requests and select the method to perform
+	the I/O. The kernel queue is tried first, then worker
+	threads and if neither is available, the requests are
+	performed synchronously by Submit().
+
+	\param uDepth Maximum number of requests that can be queued or in flight at once, zero means \ref DEFAULTDEPTH
+	\param uFlags \ref FLAG_NOKERNEL and/or \ref FLAG_NOTHREADS to disable methods of performing the I/O
+	\param uWorkerCount Number of worker threads if threads are used, zero means Thread::GetProcessorCount()
+	\return File::OKAY if successful, File::OUTOFRANGE if the requests could not be allocated
+	\sa Shutdown(void) or GetBackend(void) const
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::Init(Word uDepth,Word uFlags,Word uWorkerCount)
+{
+	Shutdown();
+	if (!uDepth) {
+		uDepth = DEFAULTDEPTH;
+	}
+	Request_t *pRequests = static_cast<Request_t *>(AllocClear(sizeof(Request_t)*uDepth));
+	if (!pRequests) {
+		return File::OUTOFRANGE;
+	}
+	m_pRequests = pRequests;
+	m_uDepth = uDepth;
+
+	// Chain all the requests into the free list
+	Word i = uDepth-1;
+	while (i) {
+		pRequests[i-1].m_pNext = &pRequests[i];
+		--i;
+	}
+	m_pFreeList = pRequests;
+
+	// Try the operating system first
+	m_eBackend = BACKEND_SYNCHRONOUS;
+	if (!(uFlags&FLAG_NOKERNEL) && (InitKernelQueue()==File::OKAY)) {
+		m_eBackend = BACKEND_KERNEL;
+
+	// Use worker threads
+	} else if (!(uFlags&FLAG_NOTHREADS)) {
+		if (!uWorkerCount) {
+			uWorkerCount = Thread::GetProcessorCount();
+		}
+		if (uWorkerCount>MAXWORKERS) {
+			uWorkerCount = MAXWORKERS;
+		}
+		if (uWorkerCount>uDepth) {
+			uWorkerCount = uDepth;
+		}
+		m_bQuit = FALSE;
+		// If threads are not supported, Start() will fail
+		while (m_uWorkerCount<uWorkerCount) {
+			if (m_Workers[m_uWorkerCount].Start(WorkerThread,this)) {
+				break;
+			}
+			++m_uWorkerCount;
+		}
+		if (m_uWorkerCount) {
+			m_eBackend = BACKEND_THREADS;
+		}
+	}
+	return File::OKAY;
+}
+
+/*! ************************************
+
+	\brief Wait for all pending I/O and release resources
+
+	All queued requests are submitted and their completion
+	functions are called before the resources are released.
+
+	\sa Init(Word,Word,Word)
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::Shutdown(void)
+{
+	if (m_eBackend!=BACKEND_NONE) {
+		// Don't leave the kernel or a thread writing into buffers
+		WaitAll();
+
+		// Stop the worker threads
+		if (m_uWorkerCount) {
+			m_Lock.Lock();
+			m_bQuit = TRUE;
+			m_WorkReady.Broadcast();
+			m_Lock.Unlock();
+			Word i = 0;
+			do {
+				m_Workers[i].Wait();
+			} while (++i<m_uWorkerCount);
+			m_uWorkerCount = 0;
+		}
+		if (m_eBackend==BACKEND_KERNEL) {
+			ShutdownKernelQueue();
+		}
+		m_eBackend = BACKEND_NONE;
+	}
+	Free(m_pRequests);
+	m_pRequests = NULL;
+	m_pFreeList = NULL;
+	m_pQueuedFirst = NULL;
+	m_ppQueuedLast = &m_pQueuedFirst;
+	m_pWorkFirst = NULL;
+	m_ppWorkLast = &m_pWorkFirst;
+	m_pDoneFirst = NULL;
+	m_ppDoneLast = &m_pDoneFirst;
+	m_uDepth = 0;
+	m_uQueued = 0;
+	m_uInFlight = 0;
+}
+
+/*! ************************************
+
+	\fn Word Burger::FileIOQueue::ReadAsync(File *pFile,Word64 uOffset,void *pOutput,WordPtr uSize,CompletionProc pProc,void *pData)
+	\brief Queue a read from a file
+
+	Queue a read from the offset in the file into a buffer. The read
+	is not started until Submit() is called. If all of the requests are
+	in use, this will call WaitForCompletion(), which calls the
+	completion functions of the requests that finished.
+
+	\param pFile Pointer to an open File
+	\param uOffset Offset in bytes from the start of the file
+	\param pOutput Buffer to receive the data
+	\param uSize Number of bytes to read
+	\param pProc Function to call when the read completes, can be \ref NULL
+	\param pData Pointer passed to pProc
+	\return File::OKAY if queued or an error code
+	\sa WriteAsync(File *,Word64,const void *,WordPtr,CompletionProc,void *) or Submit(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::FileIOQueue::WriteAsync(File *pFile,Word64 uOffset,const void *pInput,WordPtr uSize,CompletionProc pProc,void *pData)
+	\brief Queue a write to a file
+
+	Queue a write from a buffer to the offset in the file. The write
+	is not started until Submit() is called. If all of the requests are
+	in use, this will call WaitForCompletion(), which calls the
+	completion functions of the requests that finished.
+
+	\note If less than uSize bytes were written, the completion
+	function is passed File::WRITEERROR.
+
+	\param pFile Pointer to an open File
+	\param uOffset Offset in bytes from the start of the file
+	\param pInput Buffer of data to write
+	\param uSize Number of bytes to write
+	\param pProc Function to call when the write completes, can be \ref NULL
+	\param pData Pointer passed to pProc
+	\return File::OKAY if queued or an error code
+	\sa ReadAsync(File *,Word64,void *,WordPtr,CompletionProc,void *) or Submit(void)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Queue a request
+
+	\param pFile Pointer to an open File
+	\param uOffset Offset in bytes from the start of the file
+	\param pBuffer Buffer for the data
+	\param uSize Number of bytes to transfer
+	\param pProc Function to call when the transfer completes
+	\param pData Pointer passed to pProc
+	\param bWrite \ref TRUE to write, \ref FALSE to read
+	\return File::OKAY if queued or an error code
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::Queue(File *pFile,Word64 uOffset,Word8 *pBuffer,WordPtr uSize,CompletionProc pProc,void *pData,Word bWrite)
+{
+	if (m_eBackend==BACKEND_NONE) {
+		return File::IOERROR;
+	}
+	if (!pFile || !pFile->IsOpened()) {
+		return File::FILENOTFOUND;
+	}
+	Request_t *pRequest;
+	// If every request is in use, wait for some to finish
+	while ((pRequest = m_pFreeList)==NULL) {
+		if (!WaitForCompletion()) {
+			return File::OUTOFRANGE;
+		}
+	}
+	m_pFreeList = pRequest->m_pNext;
+
+	pRequest->m_pNext = NULL;
+	pRequest->m_pFile = pFile;
+	pRequest->m_pBuffer = pBuffer;
+	pRequest->m_uOffset = uOffset;
+	pRequest->m_uSize = uSize;
+	pRequest->m_uTransferred = 0;
+	pRequest->m_pProc = pProc;
+	pRequest->m_pData = pData;
+	pRequest->m_uError = File::OKAY;
+	pRequest->m_bWrite = bWrite;
+
+	// Append to the batch
+	m_ppQueuedLast[0] = pRequest;
+	m_ppQueuedLast = &pRequest->m_pNext;
+	++m_uQueued;
+	return File::OKAY;
+}
+
+/*! ************************************
+
+	\brief Start all queued requests
+
+	Send all of the requests queued since the last call to
+	the operating system or the worker threads. On platforms without
+	threads, the requests are performed before this function returns.
+
+	\return Number of requests submitted
+	\sa Poll(void) or WaitAll(void)
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::Submit(void)
+{
+	Word uCount = m_uQueued;
+	if (uCount) {
+		Request_t *pList = m_pQueuedFirst;
+		Request_t **ppLast = m_ppQueuedLast;
+		m_pQueuedFirst = NULL;
+		m_ppQueuedLast = &m_pQueuedFirst;
+		m_uQueued = 0;
+		m_uInFlight += uCount;
+
+		if (m_eBackend==BACKEND_KERNEL) {
+			SubmitKernelQueue(pList);
+		} else if (m_eBackend==BACKEND_THREADS) {
+			// Hand the batch to the workers
+			m_Lock.Lock();
+			m_ppWorkLast[0] = pList;
+			m_ppWorkLast = ppLast;
+			m_WorkReady.Broadcast();
+			m_Lock.Unlock();
+		} else {
+			// Do it now
+			Request_t *pWork = pList;
+			do {
+				Perform(pWork);
+				pWork = pWork->m_pNext;
+			} while (pWork);
+			m_ppDoneLast[0] = pList;
+			m_ppDoneLast = ppLast;
+		}
+	}
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Call the completion functions of finished requests
+
+	Check for requests that have completed and call their
+	completion functions. This function doesn't wait.
+
+	\return Number of completion functions called
+	\sa WaitForCompletion(void) or Submit(void)
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::Poll(void)
+{
+	Word uResult = 0;
+	if (m_uInFlight) {
+		Request_t *pList;
+		if (m_eBackend==BACKEND_KERNEL) {
+			pList = ReapKernelQueue(FALSE);
+		} else {
+			m_Lock.Lock();
+			pList = m_pDoneFirst;
+			m_pDoneFirst = NULL;
+			m_ppDoneLast = &m_pDoneFirst;
+			m_Lock.Unlock();
+		}
+		uResult = Dispatch(pList);
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Wait for at least one request to complete
+
+	Submit any queued requests and then sleep until at least one
+	request has completed. The completion functions of all
+	finished requests are called.
+
+	\return Number of completion functions called, zero if nothing was in flight
+	\sa Poll(void) or WaitAll(void)
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::WaitForCompletion(void)
+{
+	if (m_uQueued) {
+		Submit();
+	}
+	Word uResult = 0;
+	while (m_uInFlight) {
+		Request_t *pList;
+		if (m_eBackend==BACKEND_KERNEL) {
+			pList = ReapKernelQueue(TRUE);
+		} else {
+			m_Lock.Lock();
+			while (!m_pDoneFirst) {
+				// Error? Threads aren't working
+				if (m_WorkDone.Wait(&m_Lock)) {
+					break;
+				}
+			}
+			pList = m_pDoneFirst;
+			m_pDoneFirst = NULL;
+			m_ppDoneLast = &m_pDoneFirst;
+			m_Lock.Unlock();
+		}
+		// Nothing when told to wait? Don't spin forever
+		if (!pList) {
+			break;
+		}
+		uResult = Dispatch(pList);
+		if (uResult) {
+			break;
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Wait for all requests to complete
+
+	Submit any queued requests and sleep until every request
+	has completed and its completion function was called. Requests
+	queued by the completion functions are waited on as well.
+
+	\sa WaitForCompletion(void) or Submit(void)
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::WaitAll(void)
+{
+	while (m_uInFlight || m_uQueued) {
+		if (!WaitForCompletion()) {
+			break;
+		}
+	}
+}
+
+/*! ************************************
+
+	\fn eBackend Burger::FileIOQueue::GetBackend(void) const
+	\brief Get the method used to perform the I/O
+
+	\return \ref BACKEND_NONE if Init() was not called, or the method selected by Init()
+	\sa Init(Word,Word,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::FileIOQueue::GetDepth(void) const
+	\brief Get the maximum number of requests
+
+	\return Number of requests that can be queued or in flight at once
+	\sa Init(Word,Word,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::FileIOQueue::GetQueuedCount(void) const
+	\brief Get the number of requests waiting for Submit()
+
+	\return Number of requests queued and not started
+	\sa Submit(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::FileIOQueue::GetInFlightCount(void) const
+	\brief Get the number of requests started but not dispatched
+
+	\return Number of requests submitted whose completion function was not called yet
+	\sa Poll(void)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Perform a request on the calling thread
+
+	\param pRequest Pointer to the request to perform
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::Perform(Request_t *pRequest)
+{
+	if (pRequest->m_bWrite) {
+		WordPtr uWritten = pRequest->m_pFile->WriteAt(pRequest->m_uOffset,pRequest->m_pBuffer,pRequest->m_uSize);
+		pRequest->m_uTransferred = uWritten;
+		pRequest->m_uError = (uWritten==pRequest->m_uSize) ? File::OKAY : File::WRITEERROR;
+	} else {
+		pRequest->m_uTransferred = pRequest->m_pFile->ReadAt(pRequest->m_uOffset,pRequest->m_pBuffer,pRequest->m_uSize);
+		pRequest->m_uError = File::OKAY;
+	}
+}
+
+/*! ************************************
+
+	\brief Worker thread for BACKEND_THREADS
+
+	Take requests from the work list, perform them and
+	move them into the completed list until told to quit.
+
+	\param pThis Pointer to the FileIOQueue
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::FileIOQueue::WorkerThread(void *pThis)
+{
+	FileIOQueue *pQueue = static_cast<FileIOQueue *>(pThis);
+	pQueue->m_Lock.Lock();
+	for (;;) {
+		Request_t *pRequest = pQueue->m_pWorkFirst;
+		if (pRequest) {
+			pQueue->m_pWorkFirst = pRequest->m_pNext;
+			if (!pRequest->m_pNext) {
+				pQueue->m_ppWorkLast = &pQueue->m_pWorkFirst;
+			}
+			// Perform the I/O without holding the lock
+			pQueue->m_Lock.Unlock();
+			Perform(pRequest);
+			pQueue->m_Lock.Lock();
+			pRequest->m_pNext = NULL;
+			pQueue->m_ppDoneLast[0] = pRequest;
+			pQueue->m_ppDoneLast = &pRequest->m_pNext;
+			pQueue->m_WorkDone.Signal();
+		} else {
+			if (pQueue->m_bQuit) {
+				break;
+			}
+			// An error means threads are not available
+			if (pQueue->m_WorkReady.Wait(&pQueue->m_Lock)) {
+				break;
+			}
+		}
+	}
+	pQueue->m_Lock.Unlock();
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Call the completion functions for a list of requests
+
+	Each request is returned to the free list before its completion
+	function is called so the function can queue another request.
+
+	\param pList Linked list of completed requests, can be \ref NULL
+	\return Number of completion functions called
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::Dispatch(Request_t *pList)
+{
+	Word uCount = 0;
+	while (pList) {
+		Request_t *pNext = pList->m_pNext;
+		CompletionProc pProc = pList->m_pProc;
+		void *pData = pList->m_pData;
+		Word uError = pList->m_uError;
+		WordPtr uTransferred = pList->m_uTransferred;
+		pList->m_pNext = m_pFreeList;
+		m_pFreeList = pList;
+		--m_uInFlight;
+		if (pProc) {
+			pProc(pData,uError,uTransferred);
+		}
+		++uCount;
+		pList = pNext;
+	}
+	return uCount;
+}
+
+/*! ************************************
+
+	\brief Start the operating system's asynchronous I/O
+
+	\return File::OKAY if the kernel queue is available, File::NOT_IMPLEMENTED if not
+	\sa ShutdownKernelQueue(void)
+
+***************************************/
+
+#if !defined(BURGER_LINUX) || defined(DOXYGEN)
+Word BURGER_API Burger::FileIOQueue::InitKernelQueue(void)
+{
+	return File::NOT_IMPLEMENTED;
+}
+
+/*! ************************************
+
+	\brief Release the operating system's asynchronous I/O
+
+	\sa InitKernelQueue(void)
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::ShutdownKernelQueue(void)
+{
+}
+
+/*! ************************************
+
+	\brief Send a list of requests to the operating system
+
+	\param pList Linked list of requests to start
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::SubmitKernelQueue(Request_t * /* pList */)
+{
+}
+
+/*! ************************************
+
+	\brief Get the requests the operating system has completed
+
+	\param bWait \ref TRUE to sleep until at least one request completes
+	\return Linked list of completed requests or \ref NULL if none
+
+***************************************/
+
+Burger::FileIOQueue::Request_t * BURGER_API Burger::FileIOQueue::ReapKernelQueue(Word /* bWait */)
+{
+	return NULL;
+}
+#endif
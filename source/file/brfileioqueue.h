@@ -0,0 +1,129 @@
+/***************************************
+
+	Asynchronous file I/O queue
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRFILEIOQUEUE_H__
+#define __BRFILEIOQUEUE_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRFILE_H__
+#include "brfile.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+#if defined(BURGER_LINUX)
+#include <sys/uio.h>
+#endif
+
+/* BEGIN */
+namespace Burger {
+class FileIOQueue {
+	BURGER_DISABLECOPYCONSTRUCTORS(FileIOQueue);
+public:
+	typedef void (BURGER_API *CompletionProc)(void *pData,Word uError,WordPtr uTransferred);	///< Completion function prototype
+	enum eBackend {
+		BACKEND_NONE,			///< Not initialized
+		BACKEND_SYNCHRONOUS,	///< Requests are performed on the calling thread by Submit()
+		BACKEND_THREADS,		///< Requests are performed by worker threads
+		BACKEND_KERNEL			///< Requests are performed by the operating system (io_uring on Linux)
+	};
+	enum {
+		DEFAULTDEPTH=64,		///< Default number of requests that can be in flight
+		MAXWORKERS=8,			///< Maximum number of worker threads for BACKEND_THREADS
+		FLAG_NOKERNEL=0x01,		///< Don't use the operating system's asynchronous I/O
+		FLAG_NOTHREADS=0x02		///< Don't spawn worker threads
+	};
+private:
+	struct Request_t {
+		Request_t *m_pNext;			///< Next request in the list
+		File *m_pFile;				///< File to perform the I/O on
+		Word8 *m_pBuffer;			///< Buffer to read into or write from
+		Word64 m_uOffset;			///< Offset into the file
+		WordPtr m_uSize;			///< Number of bytes to transfer
+		WordPtr m_uTransferred;		///< Number of bytes transferred so far
+		CompletionProc m_pProc;		///< Function to call on completion
+		void *m_pData;				///< Data pointer passed to m_pProc
+		Word m_uError;				///< File error code on completion
+		Word m_bWrite;				///< \ref TRUE for a write, \ref FALSE for a read
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+		struct iovec m_IOVector;	///< Remaining data to transfer (Linux only)
+#endif
+	};
+	Request_t *m_pRequests;			///< Array of all requests
+	Request_t *m_pFreeList;			///< Requests available for use
+	Request_t *m_pQueuedFirst;		///< Requests waiting for Submit()
+	Request_t **m_ppQueuedLast;		///< Where to append to m_pQueuedFirst
+	Request_t *m_pWorkFirst;		///< Requests waiting for a worker thread (Guarded by m_Lock)
+	Request_t **m_ppWorkLast;		///< Where to append to m_pWorkFirst
+	Request_t *m_pDoneFirst;		///< Completed requests waiting for dispatch (Guarded by m_Lock)
+	Request_t **m_ppDoneLast;		///< Where to append to m_pDoneFirst
+	Word m_uDepth;					///< Number of entries in m_pRequests
+	Word m_uQueued;					///< Number of requests waiting for Submit()
+	Word m_uInFlight;				///< Number of submitted requests not dispatched yet
+	eBackend m_eBackend;			///< Method used to perform the I/O
+	Word m_uWorkerCount;			///< Number of running worker threads
+	Word m_bQuit;					///< \ref TRUE when the worker threads are to exit (Guarded by m_Lock)
+	CriticalSection m_Lock;			///< Lock for the worker thread lists
+	ConditionVariable m_WorkReady;	///< Signaled when work is added for the worker threads
+	ConditionVariable m_WorkDone;	///< Signaled when a worker thread completes a request
+	Thread m_Workers[MAXWORKERS];	///< Worker threads for BACKEND_THREADS
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	int m_iRing;					///< io_uring file descriptor (Linux only)
+	void *m_pSubmissionRing;		///< Mapped submission ring (Linux only)
+	WordPtr m_uSubmissionRingSize;	///< Size of the submission ring mapping (Linux only)
+	void *m_pCompletionRing;		///< Mapped completion ring, can be m_pSubmissionRing (Linux only)
+	WordPtr m_uCompletionRingSize;	///< Size of the completion ring mapping (Linux only)
+	void *m_pSubmissionEntries;		///< Mapped array of submission entries (Linux only)
+	WordPtr m_uSubmissionEntriesSize;	///< Size of the submission entry mapping (Linux only)
+	volatile Word32 *m_pSubmissionHead;	///< Index of the next entry the kernel will take (Linux only)
+	volatile Word32 *m_pSubmissionTail;	///< Index of the next entry to fill (Linux only)
+	Word32 *m_pSubmissionArray;		///< Ring of indexes into m_pSubmissionEntries (Linux only)
+	Word32 m_uSubmissionMask;		///< Mask for submission ring indexes (Linux only)
+	Word32 m_uCompletionMask;		///< Mask for completion ring indexes (Linux only)
+	volatile Word32 *m_pCompletionHead;	///< Index of the next completion to read (Linux only)
+	volatile Word32 *m_pCompletionTail;	///< Index of the next completion the kernel will write (Linux only)
+	void *m_pCompletionEntries;		///< Array of completion entries (Linux only)
+#endif
+	static void BURGER_API Perform(Request_t *pRequest);
+	static WordPtr BURGER_API WorkerThread(void *pThis);
+	Word BURGER_API Dispatch(Request_t *pList);
+	Word BURGER_API Queue(File *pFile,Word64 uOffset,Word8 *pBuffer,WordPtr uSize,CompletionProc pProc,void *pData,Word bWrite);
+	Word BURGER_API InitKernelQueue(void);
+	void BURGER_API ShutdownKernelQueue(void);
+	void BURGER_API SubmitKernelQueue(Request_t *pList);
+	Request_t * BURGER_API ReapKernelQueue(Word bWait);
+public:
+	FileIOQueue();
+	~FileIOQueue();
+	Word BURGER_API Init(Word uDepth=DEFAULTDEPTH,Word uFlags=0,Word uWorkerCount=0);
+	void BURGER_API Shutdown(void);
+	BURGER_INLINE Word ReadAsync(File *pFile,Word64 uOffset,void *pOutput,WordPtr uSize,CompletionProc pProc,void *pData=NULL) { return Queue(pFile,uOffset,static_cast<Word8 *>(pOutput),uSize,pProc,pData,FALSE); }
+	BURGER_INLINE Word WriteAsync(File *pFile,Word64 uOffset,const void *pInput,WordPtr uSize,CompletionProc pProc,void *pData=NULL) { return Queue(pFile,uOffset,static_cast<Word8 *>(const_cast<void *>(pInput)),uSize,pProc,pData,TRUE); }
+	Word BURGER_API Submit(void);
+	Word BURGER_API Poll(void);
+	Word BURGER_API WaitForCompletion(void);
+	void BURGER_API WaitAll(void);
+	BURGER_INLINE eBackend GetBackend(void) const { return m_eBackend; }
+	BURGER_INLINE Word GetDepth(void) const { return m_uDepth; }
+	BURGER_INLINE Word GetQueuedCount(void) const { return m_uQueued; }
+	BURGER_INLINE Word GetInFlightCount(void) const { return m_uInFlight; }
+};
+}
+/* END */
+
+#endif
@@ -14,6 +14,8 @@
 #include "brfilemanager.h"
 #include "brfile.h"
 #include "brfileansihelpers.h"
+#include "brpathcache.h"
+#include "brglobalmemorymanager.h"
 #include "brdebug.h"
 #include "brglobals.h"
 #include <stdio.h>
@@ -109,6 +111,10 @@ void BURGER_API Burger::FileManager::Init(void)
 #endif
 	// Load the default prefixes
 	DefaultPrefixes();
+	// Linux file systems are case sensitive
+#if defined(BURGER_LINUX)
+	EnablePathCache(TRUE);
+#endif
 }
 
 /*! ************************************
@@ -130,6 +136,8 @@ void BURGER_API Burger::FileManager::Shutdown(void)
 {
 	// Release all of my prefixes
 	g_FileManager.ReleasePrefixes();
+	// Release the pathname cache
+	EnablePathCache(FALSE);
 	// Release any directories cached (MacOS)
 #if defined(BURGER_MAC)
 	Filename::PurgeDirectoryCache();
@@ -175,7 +183,7 @@ void BURGER_API Burger::FileManager::Shutdown(void)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 Word BURGER_API Burger::FileManager::GetVolumeName(Filename *pOutput,Word /* uVolumeNum */)
 {
@@ -251,7 +259,7 @@ Word BURGER_API Burger::FileManager::GetVolumeNumber(const char *pVolumeName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 void BURGER_API Burger::FileManager::DefaultPrefixes(void)
 {
@@ -457,7 +465,7 @@ Word BURGER_API Burger::FileManager::GetModificationTime(const char *pFileName,T
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::GetModificationTime(Filename * /* pFileName */,TimeDate_t * /* pOutput */)
 {
 	return TRUE;		// Error!
@@ -500,7 +508,7 @@ Word BURGER_API Burger::FileManager::GetCreationTime(const char *pFileName,TimeD
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::GetCreationTime(Filename * /* pFileName */,TimeDate_t * /* pOutput */)
 {
 	return TRUE;		// Error!
@@ -544,7 +552,7 @@ Word BURGER_API Burger::FileManager::DoesFileExist(const char *pFileName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::DoesFileExist(Filename *pFileName)
 {
 #if defined(BURGER_DS)
@@ -934,7 +942,7 @@ Word BURGER_API Burger::FileManager::CreateDirectoryPath(const char *pFileName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::CreateDirectoryPath(Filename * /* pFileName */ )
 {
 	return File::NOT_IMPLEMENTED;		// Always error out
@@ -1035,7 +1043,7 @@ Word BURGER_API Burger::FileManager::DeleteFile(const char *pFileName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::DeleteFile(Filename *pFileName)
 {
 #if defined(BURGER_DS)
@@ -1089,7 +1097,7 @@ Word BURGER_API Burger::FileManager::RenameFile(const char *pNewName,const char
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::RenameFile(Filename *pNewName,Filename *pOldName)
 {
 #if defined(BURGER_DS)
@@ -1149,7 +1157,7 @@ Word BURGER_API Burger::FileManager::ChangeOSDirectory(const char *pDirName)
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MSDOS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::ChangeOSDirectory(Filename * /* pDirName */)
 {
 	return File::NOT_IMPLEMENTED;	// Error!
@@ -1206,7 +1214,7 @@ FILE * BURGER_API Burger::FileManager::OpenFile(const char *pFileName,const char
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 FILE * BURGER_API Burger::FileManager::OpenFile(Filename *pFileName,const char *pType)
 {
 #if defined(BURGER_DS)
@@ -1252,7 +1260,7 @@ Word BURGER_API Burger::FileManager::CopyFile(const char *pDestName,const char *
 	
 ***************************************/
 
-#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360)) || defined(DOXYGEN)
+#if (!defined(BURGER_WINDOWS) && !defined(BURGER_MACOS) && !defined(BURGER_IOS) && !defined(BURGER_XBOX360) && !defined(BURGER_LINUX)) || defined(DOXYGEN)
 Word BURGER_API Burger::FileManager::CopyFile(Filename *pDestName,Filename *pSourceName)
 {
 #if defined(BURGER_DS)
@@ -1503,6 +1511,47 @@ void * BURGER_API Burger::FileManager::LoadFile(Filename *pFileName,WordPtr *pLe
 #endif
 }
 
+/*! ************************************
+
+	\brief Turn the case insensitive pathname cache on or off
+
+	On file systems that are case sensitive, Filename::GetNative()
+	uses a PathCache to find files whose names don't match
+	the case of the requested Burgerlib pathname, and
+	DoesFileExist() answers from the cache without touching the
+	file system. It's enabled by Init() on platforms that
+	need it.
+
+	\note This is not thread safe, call it only when no other
+	threads are accessing files.
+
+	\param bEnable \ref TRUE to create the cache, \ref FALSE to dispose of it
+	\sa GetPathCache(void) or PathCache
+
+***************************************/
+
+void BURGER_API Burger::FileManager::EnablePathCache(Word bEnable)
+{
+	PathCache *pCache = g_FileManager.m_pPathCache;
+	if (bEnable) {
+		if (!pCache) {
+			g_FileManager.m_pPathCache = New<PathCache>();
+		}
+	} else if (pCache) {
+		g_FileManager.m_pPathCache = NULL;
+		Delete(pCache);
+	}
+}
+
+/*! ************************************
+
+	\fn Burger::FileManager::GetPathCache(void)
+	\brief Return the case insensitive pathname cache
+
+	\return Pointer to the PathCache or \ref NULL if it's not enabled
+	\sa EnablePathCache(Word)
+
+***************************************/
 
 /*! ************************************
 
@@ -36,6 +36,7 @@
 
 /* BEGIN */
 namespace Burger {
+class PathCache;
 struct FileManager {
 public:
 	enum {
@@ -99,6 +100,8 @@ static Word BURGER_API SaveTextFile(const char *pFileName,const void *pData,Word
 static Word BURGER_API SaveTextFile(Filename *pFileName,const void *pData,WordPtr uLength);
 static void * BURGER_API LoadFile(const char *pFileName,WordPtr *pLength);
 static void * BURGER_API LoadFile(Filename *pFileName,WordPtr *pLength);
+static void BURGER_API EnablePathCache(Word bEnable);
+static BURGER_INLINE PathCache *GetPathCache(void) { return g_FileManager.m_pPathCache; }
 #if (defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 static BURGER_INLINE const char *GetBootName(void) { return g_FileManager.m_pBootName; }
 static BURGER_INLINE Word GetBootNameSize(void) { return g_FileManager.m_uBootNameSize; }
@@ -106,6 +109,7 @@ static BURGER_INLINE Word GetBootNameSize(void) { return g_FileManager.m_uBootNa
 private:
 	void ReleasePrefixes(void);
 	const char *m_pPrefix[PREFIXMAX];	///< Array of prefix strings
+	PathCache *m_pPathCache;			///< Case insensitive pathname cache, \ref NULL if disabled
 #if defined(BURGER_MSDOS) || defined(DOXYGEN)
 	Word8 m_bAllowed;					///< True if MSDOS has long filename support (MSDOS Only)
 #endif
@@ -20,6 +20,7 @@
 #include "brfloatingpoint.h"
 #include "brfixedpoint.h"
 #include "brutf8.h"
+#include "brprofiler.h"
 
 #if defined(BURGER_MSVC)
 #pragma warning(disable:4355)		// "this" pointer used in initializer
@@ -4191,6 +4192,7 @@ Word BURGER_API Burger::FileXML::Init(Filename *pFilename)
 
 Word BURGER_API Burger::FileXML::Init(InputMemoryStream *pInput)
 {
+	BURGER_PROFILE_ZONE("FileXML::Init");
 	// Purge any data in the file record
 	Shutdown();
 
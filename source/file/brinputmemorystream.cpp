@@ -16,6 +16,8 @@
 #include "brendian.h"
 #include "brstringfunctions.h"
 #include "brfilemanager.h"
+#include "brfile.h"
+#include "brfilename.h"
 #include "brpalette.h"
 
 /*! ************************************
@@ -36,6 +38,13 @@
 	Multibyte data such as \ref Word32 will be assumed to be in Little
 	Endian format.
 
+	Large files don't have to be copied into memory before parsing.
+	OpenMapped() will map the file into the address space on platforms
+	that support it, so pages are read in by the operating system as they
+	are parsed. OpenWindow() only keeps a fixed size window of the file
+	in memory and refills it from the file as the data is consumed. In
+	window mode, GetPtr() is only valid for the bytes returned by Prefetch().
+
 	\sa Burger::OutputMemoryStream
 
 ***************************************/
@@ -53,6 +62,10 @@ Burger::InputMemoryStream::InputMemoryStream() :
 	m_pEndOfBuffer(NULL),
 	m_pData(NULL),
 	m_uBufferSize(0),
+	m_pFile(NULL),
+	m_uWindowMark(0),
+	m_uWindowSize(0),
+	m_uMappedSize(0),
 	m_bDontFree(FALSE)
 {
 }
@@ -72,7 +85,15 @@ Burger::InputMemoryStream::InputMemoryStream() :
 ***************************************/
 
 Burger::InputMemoryStream::InputMemoryStream(const char *pFilename) :
-	m_pData(NULL)
+	m_pWork(NULL),
+	m_pEndOfBuffer(NULL),
+	m_pData(NULL),
+	m_uBufferSize(0),
+	m_pFile(NULL),
+	m_uWindowMark(0),
+	m_uWindowSize(0),
+	m_uMappedSize(0),
+	m_bDontFree(FALSE)
 {
 	Open(pFilename);
 }
@@ -94,7 +115,15 @@ Burger::InputMemoryStream::InputMemoryStream(const char *pFilename) :
 ***************************************/
 
 Burger::InputMemoryStream::InputMemoryStream(const void *pBuffer,WordPtr uBufferSize,Word bDontFree) :
-	m_pData(NULL)
+	m_pWork(NULL),
+	m_pEndOfBuffer(NULL),
+	m_pData(NULL),
+	m_uBufferSize(0),
+	m_pFile(NULL),
+	m_uWindowMark(0),
+	m_uWindowSize(0),
+	m_uMappedSize(0),
+	m_bDontFree(FALSE)
 {
 	Open(pBuffer,uBufferSize,bDontFree);
 }
@@ -122,18 +151,33 @@ Burger::InputMemoryStream::~InputMemoryStream()
 	call, this class will have empty buffers and
 	all calls to receive data will return nothing
 
+	Memory mapped files are unmapped and the file
+	used for window mode is closed.
+
 ***************************************/
 
 void BURGER_API Burger::InputMemoryStream::Clear(void)
 {
+	// Close the file used by the window
+	File *pFile = m_pFile;
+	if (pFile) {
+		Delete(pFile);
+		m_pFile = NULL;
+	}
+	// Was the file mapped into memory?
+	if (m_uMappedSize) {
+		UnmapFile(m_pData,m_uMappedSize);
 	// Can the buffer be freed?
-	if (m_pData && !m_bDontFree) {
+	} else if (m_pData && !m_bDontFree) {
 		Free(m_pData);
 	}
 	m_pWork = NULL;
 	m_pEndOfBuffer = NULL;
 	m_pData = NULL;
 	m_uBufferSize = 0;
+	m_uWindowMark = 0;
+	m_uWindowSize = 0;
+	m_uMappedSize = 0;
 	m_bDontFree = FALSE;
 }
 
@@ -152,6 +196,15 @@ void BURGER_API Burger::InputMemoryStream::Clear(void)
 
 void BURGER_API Burger::InputMemoryStream::SkipForward(WordPtr uOffset)
 {
+	// Is the data coming from a file?
+	if (m_pFile) {
+		WordPtr uRemaining = BytesRemaining();
+		if (uOffset>uRemaining) {
+			uOffset = uRemaining;
+		}
+		SetWindowMark(GetMark()+uOffset);
+		return;
+	}
 	// Get the current work pointer
 	const Word8 *pWork = m_pWork;
 	// Calculate the remaining number of bytes
@@ -181,6 +234,15 @@ void BURGER_API Burger::InputMemoryStream::SkipForward(WordPtr uOffset)
 
 void BURGER_API Burger::InputMemoryStream::SkipBack(WordPtr uOffset)
 {
+	// Is the data coming from a file?
+	if (m_pFile) {
+		WordPtr uMark = GetMark();
+		if (uOffset>uMark) {
+			uOffset = uMark;
+		}
+		SetWindowMark(uMark-uOffset);
+		return;
+	}
 	// Get the current work pointer
 	const Word8 *pWork = m_pWork;
 	// Calculate the number of bytes it can reverse
@@ -215,8 +277,12 @@ void BURGER_API Burger::InputMemoryStream::SetMark(WordPtr uOffset)
 	if (uOffset>m_uBufferSize) {
 		uOffset = m_uBufferSize;
 	}
-	// Can the buffer be freed?
-	m_pWork = m_pData+uOffset;
+	// Is the data coming from a file?
+	if (m_pFile) {
+		SetWindowMark(uOffset);
+	} else {
+		m_pWork = m_pData+uOffset;
+	}
 }
 
 /*! ************************************
@@ -226,8 +292,11 @@ void BURGER_API Burger::InputMemoryStream::SetMark(WordPtr uOffset)
 
 	Return the current read pointer to the input byte stream.
 
+	\note If the stream was opened with OpenWindow(), only the
+	number of bytes returned by Prefetch(WordPtr) are valid.
+
 	\return Current read pointer to the input byte stream.
-	\sa GetMark(void) const
+	\sa GetMark(void) const or Prefetch(WordPtr)
 
 ***************************************/
 
@@ -281,6 +350,53 @@ void BURGER_API Burger::InputMemoryStream::SetMark(WordPtr uOffset)
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word Burger::InputMemoryStream::IsWindowed(void) const
+	\brief Return \ref TRUE if the stream is reading from a file window
+
+	\return \ref TRUE if the stream was opened with OpenWindow(const char *,WordPtr).
+	\sa Prefetch(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::InputMemoryStream::IsMapped(void) const
+	\brief Return \ref TRUE if the stream is a memory mapped file
+
+	\return \ref TRUE if OpenMapped(const char *,eAccessHint) mapped the file into memory.
+
+***************************************/
+
+/*! ************************************
+
+	\brief Make data at the read pointer available
+
+	In window mode, slide the window forward so at least
+	uCount bytes (If the file has that many) are in memory
+	starting at GetPtr(). The amount of contiguous data can't
+	be larger than the size of the window.
+
+	For streams that are entirely in memory, nothing is
+	moved.
+
+	\param uCount Number of bytes requested
+	\return Number of bytes that can be read from GetPtr(), no more than uCount.
+	\sa GetPtr(void) const or OpenWindow(const char *,WordPtr)
+
+***************************************/
+
+WordPtr BURGER_API Burger::InputMemoryStream::Prefetch(WordPtr uCount)
+{
+	Preload(uCount);
+	WordPtr uResult = static_cast<WordPtr>(m_pEndOfBuffer-m_pWork);
+	if (uResult>uCount) {
+		uResult = uCount;
+	}
+	return uResult;
+}
+
 /*! ************************************
 
 	\brief Load data from a file
@@ -304,6 +420,8 @@ Word BURGER_API Burger::InputMemoryStream::Open(const char *pFilename)
 		m_pData = static_cast<Word8 *>(pInput);
 		return 0;
 	}
+	// Make sure the stream is empty
+	m_uBufferSize = 0;
 	return 10;
 }
 
@@ -330,6 +448,8 @@ Word BURGER_API Burger::InputMemoryStream::Open(Filename *pFilename)
 		m_pData = static_cast<Word8 *>(pInput);
 		return 0;
 	}
+	// Make sure the stream is empty
+	m_uBufferSize = 0;
 	return 10;
 }
 
@@ -360,6 +480,235 @@ void BURGER_API Burger::InputMemoryStream::Open(const void *pBuffer,WordPtr uBuf
 	m_bDontFree = bDontFree;
 }
 
+/*! ************************************
+
+	\brief Map a file into memory for streaming
+
+	Instead of allocating a buffer and reading the entire file
+	before parsing, map the file into the address space. The
+	operating system will read in the pages as they are
+	accessed, using the access hint to determine how much
+	to read ahead.
+
+	On platforms that don't support memory mapped files, or if
+	the mapping failed, the file is loaded into memory with Open(const char *).
+
+	\note The file must not be truncated by another process while
+	it's mapped.
+
+	\param pFilename Burgerlib format filename
+	\param eHint How the data will be accessed
+	\return Error code with zero being no error, non-zero is an error condition
+	\sa OpenWindow(const char *,WordPtr) or Open(const char *)
+
+***************************************/
+
+Word BURGER_API Burger::InputMemoryStream::OpenMapped(const char *pFilename,eAccessHint eHint)
+{
+	Filename MyFilename(pFilename);
+	return OpenMapped(&MyFilename,eHint);
+}
+
+/*! ************************************
+
+	\brief Map a file into memory for streaming
+
+	Instead of allocating a buffer and reading the entire file
+	before parsing, map the file into the address space. The
+	operating system will read in the pages as they are
+	accessed, using the access hint to determine how much
+	to read ahead.
+
+	On platforms that don't support memory mapped files, or if
+	the mapping failed, the file is loaded into memory with Open(Filename *).
+
+	\param pFilename Pointer to a Filename instance
+	\param eHint How the data will be accessed
+	\return Error code with zero being no error, non-zero is an error condition
+	\sa OpenWindow(Filename *,WordPtr) or Open(Filename *)
+
+***************************************/
+
+Word BURGER_API Burger::InputMemoryStream::OpenMapped(Filename *pFilename,eAccessHint eHint)
+{
+	Clear();
+
+	WordPtr uSize;
+	const Word8 *pData = MapFile(pFilename,&uSize,eHint);
+	if (pData) {
+		m_pWork = pData;
+		m_pEndOfBuffer = pData+uSize;
+		m_pData = pData;
+		m_uBufferSize = uSize;
+		m_uMappedSize = uSize;
+		m_bDontFree = TRUE;
+		return 0;
+	}
+	// Do it the old fashioned way
+	return Open(pFilename);
+}
+
+/*! ************************************
+
+	\brief Stream a file through a fixed size window
+
+	Open the file and read in only the first uWindowSize
+	bytes. As data is consumed, the window is refilled from the file,
+	so files of any size can be parsed with a fixed amount
+	of memory. GetSize(void) const and GetMark(void) const
+	return values relative to the entire file.
+
+	\param pFilename Burgerlib format filename
+	\param uWindowSize Size of the window in bytes, can't be less than \ref MINWINDOWSIZE
+	\return Error code with zero being no error, non-zero is an error condition
+	\sa OpenMapped(const char *,eAccessHint) or Prefetch(WordPtr)
+
+***************************************/
+
+Word BURGER_API Burger::InputMemoryStream::OpenWindow(const char *pFilename,WordPtr uWindowSize)
+{
+	Filename MyFilename(pFilename);
+	return OpenWindow(&MyFilename,uWindowSize);
+}
+
+/*! ************************************
+
+	\brief Stream a file through a fixed size window
+
+	Open the file and read in only the first uWindowSize
+	bytes. As data is consumed, the window is refilled from the file,
+	so files of any size can be parsed with a fixed amount
+	of memory. GetSize(void) const and GetMark(void) const
+	return values relative to the entire file.
+
+	\param pFilename Pointer to a Filename instance
+	\param uWindowSize Size of the window in bytes, can't be less than \ref MINWINDOWSIZE
+	\return Error code with zero being no error, non-zero is an error condition
+	\sa OpenMapped(Filename *,eAccessHint) or Prefetch(WordPtr)
+
+***************************************/
+
+Word BURGER_API Burger::InputMemoryStream::OpenWindow(Filename *pFilename,WordPtr uWindowSize)
+{
+	Clear();
+
+	if (uWindowSize<MINWINDOWSIZE) {
+		uWindowSize = MINWINDOWSIZE;
+	}
+	File *pFile = File::New(pFilename,File::READONLY);
+	if (pFile) {
+		const Word8 *pWindow = static_cast<const Word8 *>(Alloc(uWindowSize));
+		if (pWindow) {
+			m_pWork = pWindow;
+			m_pEndOfBuffer = pWindow;
+			m_pData = pWindow;
+			m_uBufferSize = pFile->GetSize();
+			m_pFile = pFile;
+			m_uWindowSize = uWindowSize;
+			// Read in the first window
+			Fill();
+			return 0;
+		}
+		Delete(pFile);
+	}
+	return 10;
+}
+
+/*! ************************************
+
+	\brief Slide the window to the read pointer and fill it
+
+	Move the unread data in the window to the start of the
+	window buffer and read as much of the file that will fit
+	after it. If the file can't be read, the stream
+	is truncated at the failure point.
+
+	\note This is only called in window mode.
+
+***************************************/
+
+void BURGER_API Burger::InputMemoryStream::Fill(void)
+{
+	Word8 *pWindow = const_cast<Word8 *>(m_pData);
+	const Word8 *pWork = m_pWork;
+	WordPtr uKeep = static_cast<WordPtr>(m_pEndOfBuffer-pWork);
+	WordPtr uMark = static_cast<WordPtr>(pWork-pWindow)+m_uWindowMark;
+
+	// Slide the unread data to the start of the window
+	if (uKeep && (pWork!=pWindow)) {
+		MemoryMove(pWindow,pWork,uKeep);
+	}
+	m_uWindowMark = uMark;
+
+	// Read in as much as will fit
+	WordPtr uFileMark = uMark+uKeep;
+	WordPtr uRead = m_uWindowSize-uKeep;
+	WordPtr uFileRemaining = m_uBufferSize-uFileMark;
+	if (uRead>uFileRemaining) {
+		uRead = uFileRemaining;
+	}
+	if (uRead) {
+		WordPtr uActual = m_pFile->ReadAt(uFileMark,pWindow+uKeep,uRead);
+		// Read error? Treat it as the end of the data
+		if (uActual!=uRead) {
+			m_uBufferSize = uFileMark+uActual;
+			uRead = uActual;
+		}
+	}
+	m_pWork = pWindow;
+	m_pEndOfBuffer = pWindow+uKeep+uRead;
+}
+
+/*! ************************************
+
+	\brief Refill the window while scanning
+
+	Used by functions that scan the input with local copies of
+	the read and end pointers. All data before *ppWork is
+	consumed and the window is refilled.
+
+	\note This is only called in window mode.
+
+	\param ppWork Pointer to the local read pointer to update
+	\param ppEndOfBuffer Pointer to the local end pointer to update
+	\return \ref TRUE if there is more data to read
+
+***************************************/
+
+Word BURGER_API Burger::InputMemoryStream::Refill(const Word8 **ppWork,const Word8 **ppEndOfBuffer)
+{
+	m_pWork = ppWork[0];
+	Fill();
+	ppWork[0] = m_pWork;
+	ppEndOfBuffer[0] = m_pEndOfBuffer;
+	return m_pWork<m_pEndOfBuffer;
+}
+
+/*! ************************************
+
+	\brief Move the read pointer in window mode
+
+	If the new location is inside of the window,
+	just move the read pointer, otherwise empty
+	the window so it will be refilled from the new
+	location on the next read.
+
+	\param uOffset Offset into the file, already clamped to the size of the file
+
+***************************************/
+
+void BURGER_API Burger::InputMemoryStream::SetWindowMark(WordPtr uOffset)
+{
+	WordPtr uWindowMark = m_uWindowMark;
+	if ((uOffset>=uWindowMark) && ((uOffset-uWindowMark)<=static_cast<WordPtr>(m_pEndOfBuffer-m_pData))) {
+		m_pWork = m_pData+(uOffset-uWindowMark);
+	} else {
+		m_uWindowMark = uOffset;
+		m_pWork = m_pData;
+		m_pEndOfBuffer = m_pData;
+	}
+}
+
 /*! ************************************
 
 	\brief Parse a UTF-8 "C" string from the data stream
@@ -384,7 +733,7 @@ void BURGER_API Burger::InputMemoryStream::GetString(char *pOutput,WordPtr uOutp
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	// Is there any input?
-	if (pWork<pEndOfBuffer) {
+	if ((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer))) {
 		// Is there output?
 		if (uOutputSize) {
 			// Reduce the buffer by 1
@@ -399,7 +748,7 @@ void BURGER_API Burger::InputMemoryStream::GetString(char *pOutput,WordPtr uOutp
 			// Is this a Carriage Return?
 			if (uTemp==13) {
 				// Is it followed by a Line Feed?
-				if ((pWork<pEndOfBuffer) && pWork[0]==10) {
+				if (((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer))) && pWork[0]==10) {
 					// Discard the Line Feed!
 					++pWork;
 				}
@@ -419,7 +768,7 @@ void BURGER_API Burger::InputMemoryStream::GetString(char *pOutput,WordPtr uOutp
 				++pOutput;
 			}
 			// Scan for more data
-		} while (pWork<pEndOfBuffer);
+		} while ((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer)));
 
 		// Did I underrun?
 		if (uOutputSize) {
@@ -451,7 +800,7 @@ void BURGER_API Burger::InputMemoryStream::GetCString(char *pOutput,WordPtr uOut
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	// Is there any input?
-	if (pWork<pEndOfBuffer) {
+	if ((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer))) {
 		// Is there output?
 		if (uOutputSize) {
 			// Reduce the buffer by 1
@@ -477,7 +826,7 @@ void BURGER_API Burger::InputMemoryStream::GetCString(char *pOutput,WordPtr uOut
 				++pOutput;
 			}
 			// Scan for more data
-		} while (pWork<pEndOfBuffer);
+		} while ((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer)));
 
 		// Did I underrun?
 		if (uOutputSize) {
@@ -506,6 +855,7 @@ void BURGER_API Burger::InputMemoryStream::GetCString(char *pOutput,WordPtr uOut
 
 void BURGER_API Burger::InputMemoryStream::GetPString(char *pOutput,WordPtr uOutputSize)
 {
+	Preload(256);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	// Is there any input?
@@ -561,6 +911,7 @@ void BURGER_API Burger::InputMemoryStream::GetPString(char *pOutput,WordPtr uOut
 
 Word8 BURGER_API Burger::InputMemoryStream::GetByte(void)
 {
+	Preload(1);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word8 uTemp = 0;
@@ -584,6 +935,7 @@ Word8 BURGER_API Burger::InputMemoryStream::GetByte(void)
 
 Word16 BURGER_API Burger::InputMemoryStream::GetShort(void)
 {
+	Preload(2);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word16 uTemp = 0;
@@ -611,6 +963,7 @@ Word16 BURGER_API Burger::InputMemoryStream::GetShort(void)
 
 Word16 BURGER_API Burger::InputMemoryStream::GetBigShort(void)
 {
+	Preload(2);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word16 uTemp = 0;
@@ -638,6 +991,7 @@ Word16 BURGER_API Burger::InputMemoryStream::GetBigShort(void)
 
 Word32 BURGER_API Burger::InputMemoryStream::GetWord32(void)
 {
+	Preload(4);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word32 uTemp = 0;
@@ -665,6 +1019,7 @@ Word32 BURGER_API Burger::InputMemoryStream::GetWord32(void)
 
 Word32 BURGER_API Burger::InputMemoryStream::GetBigWord32(void)
 {
+	Preload(4);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word32 uTemp = 0;
@@ -692,6 +1047,7 @@ Word32 BURGER_API Burger::InputMemoryStream::GetBigWord32(void)
 
 float BURGER_API Burger::InputMemoryStream::GetFloat(void)
 {
+	Preload(4);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	float fTemp = 0.0f;
@@ -719,6 +1075,7 @@ float BURGER_API Burger::InputMemoryStream::GetFloat(void)
 
 float BURGER_API Burger::InputMemoryStream::GetBigFloat(void)
 {
+	Preload(4);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	float fTemp = 0.0f;
@@ -746,6 +1103,7 @@ float BURGER_API Burger::InputMemoryStream::GetBigFloat(void)
 
 double BURGER_API Burger::InputMemoryStream::GetDouble(void)
 {
+	Preload(8);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	double dTemp = 0.0;
@@ -773,6 +1131,7 @@ double BURGER_API Burger::InputMemoryStream::GetDouble(void)
 
 double BURGER_API Burger::InputMemoryStream::GetBigDouble(void)
 {
+	Preload(8);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	double dTemp = 0.0;
@@ -803,6 +1162,31 @@ WordPtr BURGER_API Burger::InputMemoryStream::Get(void *pOutput,WordPtr uOutputS
 {
 	WordPtr uResult = 0;
 	if (pOutput && uOutputSize) {
+		// Window mode and the data isn't all in the window?
+		if (m_pFile && (static_cast<WordPtr>(m_pEndOfBuffer-m_pWork)<uOutputSize)) {
+			WordPtr uRemaining = BytesRemaining();
+			if (uRemaining<uOutputSize) {
+				uOutputSize = uRemaining;
+			}
+			// Copy what's in the window
+			WordPtr uBuffered = static_cast<WordPtr>(m_pEndOfBuffer-m_pWork);
+			MemoryCopy(pOutput,m_pWork,uBuffered);
+			WordPtr uMark = GetMark()+uBuffered;
+			pOutput = static_cast<Word8 *>(pOutput)+uBuffered;
+			uOutputSize -= uBuffered;
+			uResult = uBuffered;
+			// Large reads go directly from the file
+			if (uOutputSize>=m_uWindowSize) {
+				WordPtr uActual = m_pFile->ReadAt(uMark,pOutput,uOutputSize);
+				if (uActual!=uOutputSize) {
+					m_uBufferSize = uMark+uActual;
+				}
+				SetWindowMark(uMark+uActual);
+				return uResult+uActual;
+			}
+			m_pWork = m_pEndOfBuffer;
+			Fill();
+		}
 		const Word8 *pWork = m_pWork;
 		WordPtr uRemaining = static_cast<WordPtr>(m_pEndOfBuffer-pWork);
 		if (uRemaining<uOutputSize) {
@@ -811,7 +1195,7 @@ WordPtr BURGER_API Burger::InputMemoryStream::Get(void *pOutput,WordPtr uOutputS
 		MemoryCopy(pOutput,pWork,uOutputSize);
 		pWork+=uOutputSize;
 		m_pWork = pWork;
-		uResult = uOutputSize;
+		uResult += uOutputSize;
 	}
 	return uResult;
 }
@@ -832,6 +1216,7 @@ WordPtr BURGER_API Burger::InputMemoryStream::Get(void *pOutput,WordPtr uOutputS
 
 Word BURGER_API Burger::InputMemoryStream::Get(RGBWord8_t *pOutput)
 {
+	Preload(3);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word uResult = TRUE;		// Error!
@@ -870,6 +1255,7 @@ Word BURGER_API Burger::InputMemoryStream::Get(RGBWord8_t *pOutput)
 
 Word BURGER_API Burger::InputMemoryStream::Get(RGBAWord8_t *pOutput)
 {
+	Preload(4);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word uResult = TRUE;		// Error!
@@ -910,6 +1296,7 @@ Word BURGER_API Burger::InputMemoryStream::Get(RGBAWord8_t *pOutput)
 
 Word BURGER_API Burger::InputMemoryStream::Get(Vector2D_t *pOutput)
 {
+	Preload(8);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word uResult = TRUE;		// Error!
@@ -945,6 +1332,7 @@ Word BURGER_API Burger::InputMemoryStream::Get(Vector2D_t *pOutput)
 
 Word BURGER_API Burger::InputMemoryStream::Get(Vector3D_t *pOutput)
 {
+	Preload(12);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word uResult = TRUE;		// Error!
@@ -982,6 +1370,7 @@ Word BURGER_API Burger::InputMemoryStream::Get(Vector3D_t *pOutput)
 
 Word BURGER_API Burger::InputMemoryStream::Get(Vector4D_t *pOutput)
 {
+	Preload(16);
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	Word uResult = TRUE;		// Error!
@@ -1021,14 +1410,14 @@ void BURGER_API Burger::InputMemoryStream::ParseBeyondWhiteSpace(void)
 	const Word8 *pEndOfBuffer = m_pEndOfBuffer;
 	const Word8 *pWork = m_pWork;
 	// Is there any input?
-	if (pWork<pEndOfBuffer) {
+	if ((pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer))) {
 		do {
 			Word uTemp = pWork[0];
 			if ((uTemp!=' ') &&
 				(uTemp!='\t')) {
 				break;
 			}
-		} while (++pWork<pEndOfBuffer);
+		} while ((++pWork<pEndOfBuffer) || (m_pFile && Refill(&pWork,&pEndOfBuffer)));
 		m_pWork = pWork;
 	}
 }
@@ -1053,6 +1442,10 @@ Word BURGER_API Burger::InputMemoryStream::IsStringMatch(const char *pInput)
 	if (pInput) {
 		Word uInput = reinterpret_cast<const Word8 *>(pInput)[0];
 		if (uInput) {
+			// Make sure the entire string is in the window
+			if (m_pFile) {
+				Preload(StringLength(pInput));
+			}
 			// No match
 			uResult = FALSE;
 			const Word8 *pEndOfBuffer = m_pEndOfBuffer;
@@ -1104,6 +1497,10 @@ Word BURGER_API Burger::InputMemoryStream::IsStringMatchCase(const char *pInput)
 	if (pInput) {
 		Word uInput = reinterpret_cast<const Word8 *>(pInput)[0];
 		if (uInput) {
+			// Make sure the entire string is in the window
+			if (m_pFile) {
+				Preload(StringLength(pInput));
+			}
 			// No match
 			uResult = FALSE;
 			const Word8 *pEndOfBuffer = m_pEndOfBuffer;
@@ -1161,6 +1558,8 @@ Word BURGER_API Burger::InputMemoryStream::IsDataMatch(const Word8 *pInput,WordP
 	// Assume a match on a NULL string
 	Word uResult = TRUE;
 	if (uLength) {
+		// Make sure the entire block is in the window
+		Preload(uLength);
 		// No match
 		uResult = FALSE;
 		const Word8 *pEndOfBuffer = m_pEndOfBuffer;
@@ -1187,4 +1586,39 @@ Word BURGER_API Burger::InputMemoryStream::IsDataMatch(const Word8 *pInput,WordP
 		}
 	}
 	return uResult;
-}
\ No newline at end of file
+}
+
+/*! ************************************
+
+	\brief Map a file into memory
+
+	Platform specific function to map an entire file into
+	memory for read only access.
+
+	\param pFilename Pointer to a Filename instance
+	\param pSize Pointer to receive the size of the mapped file
+	\param eHint How the data will be accessed
+	\return Pointer to the mapped file or \ref NULL if the file couldn't be mapped
+
+***************************************/
+
+#if !defined(BURGER_LINUX) || defined(DOXYGEN)
+const Word8 * BURGER_API Burger::InputMemoryStream::MapFile(Filename * /* pFilename */,WordPtr *pSize,eAccessHint /* eHint */)
+{
+	pSize[0] = 0;
+	return NULL;
+}
+
+/*! ************************************
+
+	\brief Release a memory mapped file
+
+	\param pData Pointer returned by MapFile()
+	\param uSize Size of the mapped file
+
+***************************************/
+
+void BURGER_API Burger::InputMemoryStream::UnmapFile(const Word8 * /* pData */,WordPtr /* uSize */)
+{
+}
+#endif
@@ -33,16 +33,39 @@
 /* BEGIN */
 namespace Burger {
 class Filename;
+class File;
 struct RGBAWord8_t;
 struct RGBWord8_t;
 
 class InputMemoryStream {
+public:
+	enum eAccessHint {
+		ACCESS_NORMAL,			///< No special handling of the mapped file
+		ACCESS_SEQUENTIAL,		///< Data will be read from start to finish, read ahead aggressively
+		ACCESS_RANDOM,			///< Data will be read in random order, disable read ahead
+		ACCESS_PRELOAD			///< Start reading the entire file into memory immediately
+	};
+	enum {
+		DEFAULTWINDOWSIZE=0x40000,	///< Default size in bytes of the window for OpenWindow()
+		MINWINDOWSIZE=0x1000		///< Smallest window allowed by OpenWindow()
+	};
+private:
 	const Word8 *m_pWork;			///< Pointer to the input
 	const Word8 *m_pEndOfBuffer;	///< Pointer to the end of the buffer
 	const Word8 *m_pData;			///< Pointer to the first data buffer
 	WordPtr m_uBufferSize;			///< Size of the buffer
+	File *m_pFile;					///< File to refill the window from (Window mode only)
+	WordPtr m_uWindowMark;			///< File offset of m_pData (Window mode only)
+	WordPtr m_uWindowSize;			///< Size of the window buffer (Window mode only)
+	WordPtr m_uMappedSize;			///< Size of the memory mapped file, zero if not mapped
 	Word m_bDontFree;				///< \ref TRUE if the memory isn't released on Clear()
 	BURGER_DISABLECOPYCONSTRUCTORS(InputMemoryStream);
+	static const Word8 * BURGER_API MapFile(Filename *pFilename,WordPtr *pSize,eAccessHint eHint);
+	static void BURGER_API UnmapFile(const Word8 *pData,WordPtr uSize);
+	void BURGER_API Fill(void);
+	Word BURGER_API Refill(const Word8 **ppWork,const Word8 **ppEndOfBuffer);
+	void BURGER_API SetWindowMark(WordPtr uOffset);
+	BURGER_INLINE void Preload(WordPtr uCount) { if ((static_cast<WordPtr>(m_pEndOfBuffer-m_pWork)<uCount) && m_pFile) { Fill(); } }
 public:
 	InputMemoryStream();
 	InputMemoryStream(const char *pFilename);
@@ -51,15 +74,22 @@ public:
 	Word BURGER_API Open(const char *pFilename);
 	Word BURGER_API Open(Filename *pFilename);
 	void BURGER_API Open(const void *pBuffer,WordPtr uBufferSize,Word bDontFree=FALSE);
+	Word BURGER_API OpenMapped(const char *pFilename,eAccessHint eHint=ACCESS_SEQUENTIAL);
+	Word BURGER_API OpenMapped(Filename *pFilename,eAccessHint eHint=ACCESS_SEQUENTIAL);
+	Word BURGER_API OpenWindow(const char *pFilename,WordPtr uWindowSize=DEFAULTWINDOWSIZE);
+	Word BURGER_API OpenWindow(Filename *pFilename,WordPtr uWindowSize=DEFAULTWINDOWSIZE);
 	void BURGER_API Clear(void);
 	void BURGER_API SkipForward(WordPtr uOffset);
 	void BURGER_API SkipBack(WordPtr uOffset);
 	void BURGER_API SetMark(WordPtr uOffset);
 	BURGER_INLINE const Word8 * GetPtr(void) const { return m_pWork; }
-	BURGER_INLINE WordPtr GetMark(void) const { return static_cast<WordPtr>(m_pWork-m_pData); }
+	BURGER_INLINE WordPtr GetMark(void) const { return static_cast<WordPtr>(m_pWork-m_pData)+m_uWindowMark; }
 	BURGER_INLINE WordPtr GetSize(void) const { return m_uBufferSize; }
-	BURGER_INLINE Word IsEmpty(void) const { return m_pWork>=m_pEndOfBuffer; }
-	BURGER_INLINE WordPtr BytesRemaining(void) const { return static_cast<WordPtr>(m_pEndOfBuffer-m_pWork); }
+	BURGER_INLINE Word IsEmpty(void) const { return GetMark()>=m_uBufferSize; }
+	BURGER_INLINE WordPtr BytesRemaining(void) const { return m_uBufferSize-GetMark(); }
+	BURGER_INLINE Word IsWindowed(void) const { return m_pFile!=NULL; }
+	BURGER_INLINE Word IsMapped(void) const { return m_uMappedSize!=0; }
+	WordPtr BURGER_API Prefetch(WordPtr uCount);
 	void BURGER_API GetString(char *pOutput,WordPtr uOutputSize);
 	void BURGER_API GetCString(char *pOutput,WordPtr uOutputSize);
 	void BURGER_API GetPString(char *pOutput,WordPtr uOutputSize);
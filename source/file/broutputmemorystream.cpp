@@ -36,6 +36,12 @@
 	stored in little endian format so files created
 	this way will be cross platform.
 
+	For very large output, SetWriteThrough() binds the stream to
+	an open File. Chunks are written to the file as they fill up and only
+	a small number of them are kept in memory, so memory use doesn't
+	grow with the size of the output. Call Flush() to write out the
+	rest of the data when done.
+
 	\sa Burger::InputMemoryStream
 
 ***************************************/
@@ -51,7 +57,14 @@
 Burger::OutputMemoryStream::OutputMemoryStream() :
 	m_pData(NULL),
 	m_pWork(NULL),
-	m_uIndex(CHUNKSIZE)
+	m_uIndex(CHUNKSIZE),
+	m_pFile(NULL),
+	m_pSpare(NULL),
+	m_uFileMark(0),
+	m_uFlushed(0),
+	m_uChunkCount(0),
+	m_uResidentChunks(DEFAULTRESIDENTCHUNKS),
+	m_uError(0)
 {
 }
 
@@ -78,6 +91,10 @@ Burger::OutputMemoryStream::~OutputMemoryStream()
 	call, this class can be recycled to create a
 	new output stream
 
+	\note In write through mode, data that hasn't been
+	written is discarded and the stream is no longer bound to the File.
+	Call Flush() first to write it out.
+
 ***************************************/
 
 void BURGER_API Burger::OutputMemoryStream::Clear(void)
@@ -92,8 +109,159 @@ void BURGER_API Burger::OutputMemoryStream::Clear(void)
 		} while (pNext);
 		m_pData = NULL;
 	}
+	Free(m_pSpare);
+	m_pSpare = NULL;
 	m_pWork = NULL;
 	m_uIndex = CHUNKSIZE;
+	m_pFile = NULL;
+	m_uFileMark = 0;
+	m_uFlushed = 0;
+	m_uChunkCount = 0;
+	m_uResidentChunks = DEFAULTRESIDENTCHUNKS;
+	m_uError = 0;
+}
+
+/*! ************************************
+
+	\brief Write the stream into a file as it's created
+
+	Reset the stream and bind it to an open File. Once
+	more than uResidentChunks chunks of data are in memory,
+	the oldest half of them are written to the file with a single vectored
+	write and their memory is reused. The data is written with
+	File::WriteAt(Word64,const File::IOVector_t *,WordPtr) starting at the file's
+	current mark, and the file's mark is not changed.
+
+	Overwrite() still works on the entire stream. Data that's in memory is
+	changed in place and data that was already written is changed
+	in the file.
+
+	Save(), SaveFile(), Flatten() and Compare() can't be used once
+	data was written to the file.
+
+	\note The File is not owned by the stream, it must stay open until
+	Flush() is called and then it can be closed by the caller.
+
+	\param pFile Pointer to an open File with write access
+	\param uResidentChunks Number of chunks to keep in memory, minimum of 2
+	\return Zero if no error, non-zero if the file isn't open
+	\sa Flush(void) or Clear(void)
+
+***************************************/
+
+Word BURGER_API Burger::OutputMemoryStream::SetWriteThrough(File *pFile,WordPtr uResidentChunks)
+{
+	Clear();
+	if (!pFile || !pFile->IsOpened()) {
+		return 10;
+	}
+	if (uResidentChunks<2) {
+		uResidentChunks = 2;
+	}
+	m_pFile = pFile;
+	m_uFileMark = pFile->GetMark();
+	m_uResidentChunks = uResidentChunks;
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Write all data in memory to the file
+
+	In write through mode, write every chunk still in memory
+	to the file. All chunks except the one being filled are
+	released. More data can be appended after calling this function.
+
+	If the stream is not in write through mode, nothing is done.
+
+	\return Zero if no error, non-zero if any write to the file failed
+	\sa SetWriteThrough(File *,WordPtr)
+
+***************************************/
+
+Word BURGER_API Burger::OutputMemoryStream::Flush(void)
+{
+	Word uResult = m_uError;
+	if (!uResult && m_pFile && m_pData) {
+		uResult = WriteChunks(m_uChunkCount,m_uIndex);
+		if (!uResult) {
+			ReleaseChunks(m_uChunkCount-1);
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Write the oldest chunks to the file
+
+	Write uCount chunks starting with the first chunk in
+	memory to the file with vectored writes.
+
+	\param uCount Number of chunks to write
+	\param uLastLength Number of valid bytes in the last chunk
+	\return Zero if no error, non-zero if the write failed
+
+***************************************/
+
+Word BURGER_API Burger::OutputMemoryStream::WriteChunks(WordPtr uCount,WordPtr uLastLength)
+{
+	File::IOVector_t Vectors[MAXVECTORS];
+	Word8 *pData = m_pData;
+	Word64 uMark = m_uFileMark+m_uFlushed;
+	do {
+		// Gather the chunks for a single write
+		WordPtr uBatch = 0;
+		WordPtr uTotal = 0;
+		do {
+			WordPtr uLength = CHUNKSIZE;
+			if (uCount==1) {
+				uLength = uLastLength;
+			}
+			Vectors[uBatch].m_pBuffer = pData;
+			Vectors[uBatch].m_uLength = uLength;
+			uTotal += uLength;
+			pData = reinterpret_cast<Word8**>(pData+CHUNKSIZE)[0];
+			++uBatch;
+		} while (--uCount && (uBatch<MAXVECTORS));
+		if (m_pFile->WriteAt(uMark,Vectors,uBatch)!=uTotal) {
+			// Remember the error for Flush()
+			m_uError = 10;
+			return 10;
+		}
+		uMark += uTotal;
+	} while (uCount);
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Release chunks that were written to the file
+
+	Remove the first uCount chunks from the linked list. The
+	first one is kept for reuse by Append(Word8).
+
+	\param uCount Number of full chunks to release, can be zero
+
+***************************************/
+
+void BURGER_API Burger::OutputMemoryStream::ReleaseChunks(WordPtr uCount)
+{
+	if (uCount) {
+		m_uFlushed += uCount*CHUNKSIZE;
+		m_uChunkCount -= uCount;
+		Word8 *pData = m_pData;
+		do {
+			Word8 *pNext = reinterpret_cast<Word8**>(pData+CHUNKSIZE)[0];
+			if (!m_pSpare) {
+				m_pSpare = pData;
+			} else {
+				Free(pData);
+			}
+			pData = pNext;
+		} while (--uCount);
+		m_pData = pData;
+	}
 }
 
 /*! ************************************
@@ -113,8 +281,8 @@ WordPtr BURGER_API Burger::OutputMemoryStream::GetSize(void) const
 	WordPtr uSize = 0;
 	Word8 *pData = m_pData;
 	if (pData) {
-		// Start with the size from the last chunk
-		uSize = m_uIndex;
+		// Start with the size from the last chunk and what was written to the file
+		uSize = m_uIndex+m_uFlushed;
 		pData = reinterpret_cast<Word8**>(pData+CHUNKSIZE)[0];
 		if (pData) {
 			do {
@@ -164,6 +332,10 @@ Word BURGER_API Burger::OutputMemoryStream::IsEmpty(void) const
 
 Word BURGER_API Burger::OutputMemoryStream::SaveFile(const char *pFilename) const
 {
+	// Was some of the data already written in write through mode?
+	if (m_uFlushed) {
+		return 10;
+	}
 	// Try to open the output file
 	File FileRef;
 	Word uResult = FileRef.Open(pFilename,File::WRITEONLY);
@@ -208,6 +380,10 @@ Word BURGER_API Burger::OutputMemoryStream::SaveFile(const char *pFilename) cons
 
 Word BURGER_API Burger::OutputMemoryStream::SaveFile(Filename *pFilename) const
 {
+	// Was some of the data already written in write through mode?
+	if (m_uFlushed) {
+		return 10;
+	}
 	// Try to open the output file
 	File FileRef;
 	Word uResult = FileRef.Open(pFilename,File::WRITEONLY);
@@ -252,6 +428,10 @@ Word BURGER_API Burger::OutputMemoryStream::Save(Burger::String *pOutput) const
 {
 	// SetBufferSize() retains the text, disable it by clearing first
 	pOutput->Clear();
+	// Was some of the data already written in write through mode?
+	if (m_uFlushed) {
+		return 10;
+	}
 	WordPtr uSize = GetSize();
 	pOutput->SetBufferSize(uSize);
 	// Assume success
@@ -293,7 +473,7 @@ Word BURGER_API Burger::OutputMemoryStream::Save(Burger::String *pOutput) const
 Word BURGER_API Burger::OutputMemoryStream::Flatten(void *pOutput,WordPtr uLength) const
 {
 	WordPtr uSize = GetSize();
-	if (uSize!=uLength) {
+	if ((uSize!=uLength) || m_uFlushed) {
 		return TRUE;
 	}
 	// Assume success
@@ -330,7 +510,11 @@ Word BURGER_API Burger::OutputMemoryStream::Flatten(void *pOutput,WordPtr uLengt
 void * BURGER_API Burger::OutputMemoryStream::Flatten(WordPtr *pLength) const
 {
 	WordPtr uSize = GetSize();
-	void *pResult = Alloc(uSize);
+	void *pResult = NULL;
+	// Only if all the data is in memory
+	if (!m_uFlushed) {
+		pResult = Alloc(uSize);
+	}
 	if (!pResult) {
 		uSize = 0;
 	} else {
@@ -490,11 +674,26 @@ Word BURGER_API Burger::OutputMemoryStream::Append(Word8 uByte)
 		return 0;
 	}
 
+	// In write through mode, are too many chunks in memory?
+	if (m_pFile && (m_uChunkCount>=m_uResidentChunks)) {
+		// Write out the oldest half of them
+		WordPtr uCount = m_uChunkCount>>1;
+		if (WriteChunks(uCount,CHUNKSIZE)) {
+			return 10;
+		}
+		ReleaseChunks(uCount);
+	}
 	// Looks like another buffer is needed
-	Word8 *pNewData = static_cast<Word8*>(Alloc(CHUNKSIZE+sizeof(Word8*)));
-	if (!pNewData) {
-		return 10;
+	Word8 *pNewData = m_pSpare;
+	if (pNewData) {
+		m_pSpare = NULL;
+	} else {
+		pNewData = static_cast<Word8*>(Alloc(CHUNKSIZE+sizeof(Word8*)));
+		if (!pNewData) {
+			return 10;
+		}
 	}
+	++m_uChunkCount;
 	// Initialize the buffer with the next link (NULL)
 	// and insert the byte to save
 	m_uIndex = 1;
@@ -767,6 +966,10 @@ Word BURGER_API Burger::OutputMemoryStream::Compare(const void *pInput,WordPtr u
 	// Assume failure
 	Word uResult = TRUE;
 	const Word8 *pData = m_pData;
+	// Was some of the data already written in write through mode?
+	if (m_uFlushed) {
+		return uResult;
+	}
 	// Checking for empty?
 	if (!uLength) {
 		if (!pData) {
@@ -818,6 +1021,9 @@ Word BURGER_API Burger::OutputMemoryStream::Compare(const void *pInput,WordPtr u
 	stream and return zero if no error and non-zero
 	if there is an attempted buffer overrun.
 
+	In write through mode, data that was already written to the
+	file is replaced in the file.
+
 	\param pInput Pointer to the buffer to match
 	\param uLength Size of the buffer to match
 	\param uOffset Offset into the data to begin the overwrite
@@ -831,6 +1037,25 @@ Word BURGER_API Burger::OutputMemoryStream::Overwrite(const void *pInput,WordPtr
 	Word uResult = 0;
 	// Checking for empty?
 	if (uLength) {
+		// Was the start of the data already written to the file?
+		WordPtr uFlushed = m_uFlushed;
+		if (uOffset<uFlushed) {
+			WordPtr uChunk = uFlushed-uOffset;
+			if (uLength<uChunk) {
+				uChunk = uLength;
+			}
+			if (m_pFile->WriteAt(m_uFileMark+uOffset,pInput,uChunk)!=uChunk) {
+				return 1;
+			}
+			pInput = static_cast<const Word8 *>(pInput)+uChunk;
+			uLength -= uChunk;
+			if (!uLength) {
+				return 0;
+			}
+			uOffset = uFlushed;
+		}
+		// Convert to an offset into the data in memory
+		uOffset -= uFlushed;
 		// Now assume failure
 		uResult = 1;
 		Word8 *pData = m_pData;
@@ -877,4 +1102,4 @@ Word BURGER_API Burger::OutputMemoryStream::Overwrite(const void *pInput,WordPtr
 	}
 	// Return the error code
 	return uResult;
-}
\ No newline at end of file
+}
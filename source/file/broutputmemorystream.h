@@ -28,18 +28,38 @@
 
 /* BEGIN */
 namespace Burger {
+class File;
 class OutputMemoryStream {
+public:
+	enum {
+		DEFAULTRESIDENTCHUNKS=8		///< Default number of chunks kept in memory in write through mode
+	};
+private:
 	enum {
-		CHUNKSIZE = 0x40000-static_cast<int>(sizeof(Word8 *))	///< Size of each data chunk
+		CHUNKSIZE = 0x40000-static_cast<int>(sizeof(Word8 *)),	///< Size of each data chunk
+		MAXVECTORS = 32				///< Maximum number of chunks written with one call
 	};
 	Word8 *m_pData;		///< Pointer to the first data buffer
 	Word8 *m_pWork;		///< Pointer to the current buffer
 	WordPtr m_uIndex;	///< Current file mark
+	File *m_pFile;		///< File to write to in write through mode
+	Word8 *m_pSpare;	///< Written chunk saved for reuse (Write through mode only)
+	Word64 m_uFileMark;	///< Offset in m_pFile where the stream starts
+	WordPtr m_uFlushed;	///< Number of bytes written to m_pFile and released from memory
+	WordPtr m_uChunkCount;	///< Number of chunks in the linked list
+	WordPtr m_uResidentChunks;	///< Number of chunks kept in memory before writing to m_pFile
+	Word m_uError;		///< Non-zero if writing to m_pFile failed
 	BURGER_DISABLECOPYCONSTRUCTORS(OutputMemoryStream);
+	Word BURGER_API WriteChunks(WordPtr uCount,WordPtr uLastLength);
+	void BURGER_API ReleaseChunks(WordPtr uCount);
 public:
 	OutputMemoryStream();
 	~OutputMemoryStream();
 	void BURGER_API Clear(void);
+	Word BURGER_API SetWriteThrough(File *pFile,WordPtr uResidentChunks=DEFAULTRESIDENTCHUNKS);
+	Word BURGER_API Flush(void);
+	BURGER_INLINE File *GetWriteThroughFile(void) const { return m_pFile; }
+	BURGER_INLINE WordPtr GetFlushedSize(void) const { return m_uFlushed; }
 	WordPtr BURGER_API GetSize(void) const;
 	Word BURGER_API IsEmpty(void) const;
 	Word BURGER_API SaveFile(const char *pFilename) const;
@@ -0,0 +1,651 @@
+/***************************************
+
+	Case insensitive pathname cache
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brpathcache.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brtick.h"
+#include <stdlib.h>
+
+/*! ************************************
+
+	\class Burger::PathCache
+	\brief Cache to map case insensitive pathnames to native pathnames
+
+	Burgerlib pathnames are case insensitive, however the file systems on
+	Linux are not, so "Data:Level1.map" has to be matched against each
+	directory in the path to find that the file on disk is "data/LEVEL1.MAP".
+	Doing so with directory scans on every open is very slow, so this class
+	remembers both the pathnames that have been resolved and the listings of
+	the directories that were scanned to resolve them.
+
+	A pathname that was resolved is returned from the cache without
+	touching the file system until it's older than the revalidation time.
+	After that, or if the requested pathname doesn't exist, the file system
+	is checked again, with directory listings only read again if the
+	modification time of the directory has changed. The memory used
+	by the cache is bounded, and when it's exceeded, the cache is emptied.
+
+	FileManager creates a global instance on platforms that need it and
+	Filename::GetNative() uses it automatically.
+
+	\note All of the pathnames passed to this class are native
+	pathnames, not Burgerlib pathnames.
+
+	\sa FileManager::GetPathCache(void) or Filename::GetNative(void)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Create an empty cache
+
+	\sa Purge(void)
+
+***************************************/
+
+Burger::PathCache::PathCache() :
+	m_Resolved(),
+	m_Directories(),
+	m_uMemoryLimit(DEFAULTMEMORYLIMIT),
+	m_uResolvedMemory(0),
+	m_uDirectoryMemory(0),
+	m_uRevalidateTime(DEFAULTREVALIDATETIME),
+	m_uGeneration(0),
+	m_uHitCount(0),
+	m_uMissCount(0)
+{
+}
+
+/*! ************************************
+
+	\brief Release all cached data
+
+	\sa Purge(void)
+
+***************************************/
+
+Burger::PathCache::~PathCache()
+{
+	ReleaseAll();
+}
+
+/*! ************************************
+
+	\brief Find the native pathname with the case used by the file system
+
+	If the pathname exists as is, it's returned unchanged. Otherwise,
+	each directory in the path is scanned for a name that matches
+	without case sensitivity, preferring an exact match. If a part of the
+	path isn't found, the rest of the path is returned as is, so
+	a file that is about to be created will be created in the existing
+	directory.
+
+	Only pathnames that exist are cached. This function is thread safe.
+
+	\param pOutput Pointer to a String to receive the native pathname
+	\param pNative Pointer to a "C" string of a native pathname
+	\return \ref TRUE if the file or directory exists, \ref FALSE if not
+	\sa Invalidate(const char *)
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::Resolve(String *pOutput,const char *pNative)
+{
+	Word32 uNow = Tick::ReadMilliseconds();
+	String Key(pNative);
+	m_Lock.Lock();
+	const Resolved_t *pResolved = m_Resolved.GetData(Key);
+	if (pResolved) {
+		// Still valid?
+		if ((pResolved->m_uGeneration==m_uGeneration) &&
+			((uNow-pResolved->m_uValidatedTime)<m_uRevalidateTime)) {
+			++m_uHitCount;
+			pOutput[0] = pResolved->m_Resolved;
+			m_Lock.Unlock();
+			return TRUE;
+		}
+		// Discard it and look it up again
+		m_uResolvedMemory -= GetResolvedSize(&Key,pResolved);
+		m_Resolved.erase(Key);
+	}
+	++m_uMissCount;
+
+	Resolved_t NewEntry;
+	Word bExists = DoesPathExist(pNative);
+	if (bExists) {
+		NewEntry.m_Resolved = pNative;
+	} else {
+		bExists = ResolveCase(&NewEntry.m_Resolved,pNative,uNow);
+	}
+	// Only cache files that exist so new files are found immediately
+	if (bExists) {
+		// Note: Scanning directories may have changed the generation
+		NewEntry.m_uValidatedTime = uNow;
+		NewEntry.m_uGeneration = m_uGeneration;
+		WordPtr uSize = GetResolvedSize(&Key,&NewEntry);
+		if ((m_uResolvedMemory+m_uDirectoryMemory+uSize)>m_uMemoryLimit) {
+			ReleaseAll();
+		}
+		m_uResolvedMemory += uSize;
+		m_Resolved.add(Key,NewEntry);
+	}
+	m_Lock.Unlock();
+	pOutput[0] = NewEntry.m_Resolved;
+	return bExists;
+}
+
+/*! ************************************
+
+	\brief Discard cached data for a pathname
+
+	Call this after a file or directory is created, deleted or
+	renamed, so the change is seen before the revalidation time
+	has elapsed. The directory containing the pathname will be
+	scanned again.
+
+	\param pNative Pointer to a "C" string of a native pathname
+	\sa Purge(void)
+
+***************************************/
+
+void BURGER_API Burger::PathCache::Invalidate(const char *pNative)
+{
+	String Key(pNative);
+	m_Lock.Lock();
+	const Resolved_t *pResolved = m_Resolved.GetData(Key);
+	if (pResolved) {
+		m_uResolvedMemory -= GetResolvedSize(&Key,pResolved);
+		m_Resolved.erase(Key);
+	}
+
+	// Find the parent directory
+	WordPtr uLength = Key.GetLength();
+	const char *pPath = Key.GetPtr();
+	// Ignore a trailing slash
+	if (uLength && (pPath[uLength-1]=='/')) {
+		--uLength;
+	}
+	while (uLength && (pPath[uLength-1]!='/')) {
+		--uLength;
+	}
+	String DirName;
+	if (!uLength) {
+		DirName = ".";
+	} else if (uLength==1) {
+		DirName = "/";
+	} else {
+		DirName.Set(pPath,uLength-1);
+	}
+	ReleaseDirectory(&DirName);
+	// All of the pathnames that went through this directory are suspect
+	++m_uGeneration;
+	m_Lock.Unlock();
+}
+
+/*! ************************************
+
+	\brief Discard all cached data
+
+	\sa Invalidate(const char *)
+
+***************************************/
+
+void BURGER_API Burger::PathCache::Purge(void)
+{
+	m_Lock.Lock();
+	ReleaseAll();
+	m_Lock.Unlock();
+}
+
+/*! ************************************
+
+	\brief Set the maximum amount of memory to use
+
+	If the limit is exceeded, the cache is emptied and
+	filled again as pathnames are looked up. A single directory
+	listing larger than the limit is still cached until the next
+	pathname is added.
+
+	\param uMemoryLimit Maximum number of bytes to use
+	\sa GetMemoryUsed(void) const
+
+***************************************/
+
+void BURGER_API Burger::PathCache::SetMemoryLimit(WordPtr uMemoryLimit)
+{
+	m_Lock.Lock();
+	m_uMemoryLimit = uMemoryLimit;
+	if ((m_uResolvedMemory+m_uDirectoryMemory)>uMemoryLimit) {
+		ReleaseAll();
+	}
+	m_Lock.Unlock();
+}
+
+/*! ************************************
+
+	\fn WordPtr Burger::PathCache::GetMemoryLimit(void) const
+	\brief Return the maximum amount of memory to use
+
+	\return Maximum number of bytes to use
+	\sa SetMemoryLimit(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::PathCache::GetMemoryUsed(void) const
+	\brief Return the approximate amount of memory in use
+
+	\return Number of bytes used by cached data
+	\sa SetMemoryLimit(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::PathCache::SetRevalidateTime(Word32 uMilliseconds)
+	\brief Set the time cached data is trusted
+
+	Cached data older than this is checked against the file system.
+	Zero means it's checked every time.
+
+	\param uMilliseconds Number of milliseconds to trust cached data
+	\sa GetRevalidateTime(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::PathCache::GetRevalidateTime(void) const
+	\brief Get the time cached data is trusted
+
+	\return Number of milliseconds cached data is trusted
+	\sa SetRevalidateTime(Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::PathCache::GetHitCount(void) const
+	\brief Return the number of lookups that didn't touch the file system
+
+	\return Number of calls to Resolve() that used cached data
+	\sa GetMissCount(void) const or ResetCounters(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::PathCache::GetMissCount(void) const
+	\brief Return the number of lookups that checked the file system
+
+	\return Number of calls to Resolve() that checked the file system
+	\sa GetHitCount(void) const or ResetCounters(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::PathCache::ResetCounters(void)
+	\brief Set the hit and miss counters to zero
+
+	\sa GetHitCount(void) const or GetMissCount(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\brief Used to sort filenames without case sensitivity
+
+	Called by qsort()
+	\param pFirst Pointer to the first const char * to compare
+	\param pSecond Pointer to the second const char * to compare
+	\return Result of a call to StringCaseCompare(const char *,const char *) for sorting
+
+***************************************/
+
+int BURGER_ANSIAPI Burger::PathCache::QSortNames(const void *pFirst,const void *pSecond)
+{
+	return StringCaseCompare(static_cast<const char * const *>(pFirst)[0],static_cast<const char * const *>(pSecond)[0]);
+}
+
+/*! ************************************
+
+	\brief Create a directory listing
+
+	Allocate a single block of memory with the header, an array
+	of pointers to the names sorted without case sensitivity and
+	a copy of the names.
+
+	\param pText Pointer to the names, each one zero terminated
+	\param uTextSize Number of bytes in pText
+	\param uCount Number of names in pText
+	\param uStamp Modification time of the directory
+	\return Pointer to the listing or \ref NULL if out of memory
+
+***************************************/
+
+Burger::PathCache::Directory_t * BURGER_API Burger::PathCache::NewDirectory(const char *pText,WordPtr uTextSize,WordPtr uCount,Word64 uStamp)
+{
+	WordPtr uMemory = sizeof(Directory_t)+(uCount*sizeof(const char *))+uTextSize;
+	Directory_t *pDirectory = static_cast<Directory_t *>(Alloc(uMemory));
+	if (pDirectory) {
+		pDirectory->m_uStamp = uStamp;
+		pDirectory->m_uValidatedTime = 0;
+		pDirectory->m_uCount = uCount;
+		pDirectory->m_uMemory = uMemory;
+		char *pOutput = reinterpret_cast<char *>(&pDirectory->m_pNames[uCount+1]);
+		MemoryCopy(pOutput,pText,uTextSize);
+		WordPtr i = 0;
+		while (i<uCount) {
+			pDirectory->m_pNames[i] = pOutput;
+			pOutput += StringLength(pOutput)+1;
+			++i;
+		}
+		if (uCount>1) {
+			qsort(pDirectory->m_pNames,uCount,sizeof(const char *),QSortNames);
+		}
+	}
+	return pDirectory;
+}
+
+/*! ************************************
+
+	\brief Find a name in a directory listing
+
+	Use a binary search to find the names that match without case
+	sensitivity and return the one that matches exactly, or the
+	first one if none match exactly.
+
+	\param pDirectory Pointer to the directory listing
+	\param pName Pointer to the "C" string to find
+	\return Pointer to the name in the directory or \ref NULL if not found
+
+***************************************/
+
+const char * BURGER_API Burger::PathCache::FindName(const Directory_t *pDirectory,const char *pName)
+{
+	// Find the first name that's not less than pName
+	const char * const *ppNames = pDirectory->m_pNames;
+	WordPtr uLow = 0;
+	WordPtr uHigh = pDirectory->m_uCount;
+	while (uLow<uHigh) {
+		WordPtr uMiddle = (uLow+uHigh)>>1U;
+		if (StringCaseCompare(ppNames[uMiddle],pName)<0) {
+			uLow = uMiddle+1;
+		} else {
+			uHigh = uMiddle;
+		}
+	}
+	const char *pResult = NULL;
+	WordPtr uCount = pDirectory->m_uCount;
+	while ((uLow<uCount) && !StringCaseCompare(ppNames[uLow],pName)) {
+		if (!pResult) {
+			pResult = ppNames[uLow];
+		}
+		// Exact match wins
+		if (!StringCompare(ppNames[uLow],pName)) {
+			pResult = ppNames[uLow];
+			break;
+		}
+		++uLow;
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Estimate the memory used by a resolved pathname
+
+	\param pKey Pointer to the requested pathname
+	\param pResolved Pointer to the resolved record
+	\return Approximate number of bytes used
+
+***************************************/
+
+WordPtr BURGER_API Burger::PathCache::GetResolvedSize(const String *pKey,const Resolved_t *pResolved)
+{
+	// Key, value and hash table overhead, including the
+	// strings too long for the String internal buffer
+	WordPtr uSize = sizeof(String)+sizeof(Resolved_t)+(sizeof(WordPtr)*2);
+	if (pKey->GetLength()>=String::BUFFERSIZE) {
+		uSize += pKey->GetLength()+1;
+	}
+	if (pResolved->m_Resolved.GetLength()>=String::BUFFERSIZE) {
+		uSize += pResolved->m_Resolved.GetLength()+1;
+	}
+	return uSize;
+}
+
+/*! ************************************
+
+	\brief Get the listing of a directory
+
+	If the listing is cached and hasn't been checked for longer
+	than the revalidation time, or if bForce is set, the directory's
+	modification time is compared to the time when the listing was read.
+	If it changed, the directory is read again.
+
+	\note m_Lock must be held
+
+	\param pNative Pointer to a "C" string of the native directory name
+	\param uNow Current time in milliseconds
+	\param bForce \ref TRUE to check the modification time of a cached listing
+	\return Pointer to the listing or \ref NULL if the directory can't be read
+
+***************************************/
+
+Burger::PathCache::Directory_t * BURGER_API Burger::PathCache::GetDirectory(const char *pNative,Word32 uNow,Word bForce)
+{
+	String Key(pNative);
+	Directory_t * const *ppDirectory = m_Directories.GetData(Key);
+	if (ppDirectory) {
+		Directory_t *pDirectory = ppDirectory[0];
+		if (!bForce && ((uNow-pDirectory->m_uValidatedTime)<m_uRevalidateTime)) {
+			return pDirectory;
+		}
+		Word64 uStamp;
+		if (!GetStamp(pNative,&uStamp) && (uStamp==pDirectory->m_uStamp)) {
+			pDirectory->m_uValidatedTime = uNow;
+			return pDirectory;
+		}
+		// It changed, so anything resolved through it is suspect
+		ReleaseDirectory(&Key);
+		++m_uGeneration;
+	}
+	Directory_t *pDirectory = ReadDirectory(pNative);
+	if (pDirectory) {
+		pDirectory->m_uValidatedTime = uNow;
+		if ((m_uResolvedMemory+m_uDirectoryMemory+pDirectory->m_uMemory)>m_uMemoryLimit) {
+			ReleaseAll();
+		}
+		m_uDirectoryMemory += pDirectory->m_uMemory;
+		m_Directories.add(Key,pDirectory);
+	}
+	return pDirectory;
+}
+
+/*! ************************************
+
+	\brief Match each part of a pathname without case sensitivity
+
+	Since names are only considered a match if they are
+	the same length, the output is the same length as the input.
+
+	\note m_Lock must be held
+
+	\param pOutput Pointer to a String to receive the native pathname
+	\param pNative Pointer to a "C" string of the native pathname
+	\param uNow Current time in milliseconds
+	\return \ref TRUE if every part of the pathname was found
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::ResolveCase(String *pOutput,const char *pNative,Word32 uNow)
+{
+	pOutput[0] = pNative;
+	char *pBuffer = pOutput->GetPtr();
+	char *pWork = pBuffer;
+	// Skip the root
+	if (pWork[0]=='/') {
+		++pWork;
+	}
+	Word bFound = TRUE;
+	while (pWork[0]) {
+		char *pEnd = pWork;
+		while (pEnd[0] && (pEnd[0]!='/')) {
+			++pEnd;
+		}
+		WordPtr uLength = static_cast<WordPtr>(pEnd-pWork);
+		// Skip "//", "." and ".."
+		if (uLength && !((pWork[0]=='.') && ((uLength==1) || ((uLength==2) && (pWork[1]=='.'))))) {
+			// Isolate the name of the parent directory and the name to find
+			char cEnd = pEnd[0];
+			pEnd[0] = 0;
+			const char *pDirName;
+			char cParent = 0;
+			if (pWork==pBuffer) {
+				pDirName = ".";
+			} else if (pWork==(pBuffer+1)) {
+				pDirName = "/";
+			} else {
+				cParent = pWork[-1];
+				pWork[-1] = 0;
+				pDirName = pBuffer;
+			}
+			const char *pName = NULL;
+			Directory_t *pDirectory = GetDirectory(pDirName,uNow,FALSE);
+			if (pDirectory) {
+				pName = FindName(pDirectory,pWork);
+				// Not found? Make sure the listing is current
+				if (!pName) {
+					pDirectory = GetDirectory(pDirName,uNow,TRUE);
+					if (pDirectory) {
+						pName = FindName(pDirectory,pWork);
+					}
+				}
+			}
+			// Restore the pathname
+			if (cParent) {
+				pWork[-1] = cParent;
+			}
+			pEnd[0] = cEnd;
+			if (!pName) {
+				bFound = FALSE;
+				break;
+			}
+			MemoryCopy(pWork,pName,uLength);
+		}
+		pWork = pEnd;
+		if (pWork[0]) {
+			++pWork;
+		}
+	}
+	return bFound;
+}
+
+/*! ************************************
+
+	\brief Dispose of a directory listing
+
+	\note m_Lock must be held
+
+	\param pKey Pointer to the native directory name
+
+***************************************/
+
+void BURGER_API Burger::PathCache::ReleaseDirectory(const String *pKey)
+{
+	Directory_t * const *ppDirectory = m_Directories.GetData(pKey[0]);
+	if (ppDirectory) {
+		Directory_t *pDirectory = ppDirectory[0];
+		m_uDirectoryMemory -= pDirectory->m_uMemory;
+		Free(pDirectory);
+		m_Directories.erase(pKey[0]);
+	}
+}
+
+/*! ************************************
+
+	\brief Dispose of all cached data
+
+	\note m_Lock must be held
+
+***************************************/
+
+void BURGER_API Burger::PathCache::ReleaseAll(void)
+{
+	HashMapString<Directory_t *>::iterator it = m_Directories.begin();
+	while (it!=m_Directories.end()) {
+		Free(it->second);
+		++it;
+	}
+	m_Directories.Clear();
+	m_Resolved.Clear();
+	m_uResolvedMemory = 0;
+	m_uDirectoryMemory = 0;
+	++m_uGeneration;
+}
+
+#if !defined(BURGER_LINUX) || defined(DOXYGEN)
+
+/*! ************************************
+
+	\brief Read the names in a directory
+
+	Read the directory and create a listing with NewDirectory().
+
+	\note On file systems that aren't case sensitive, this returns \ref NULL
+
+	\param pNative Pointer to a "C" string of the native directory name
+	\return Pointer to a new listing or \ref NULL on error
+
+***************************************/
+
+Burger::PathCache::Directory_t * BURGER_API Burger::PathCache::ReadDirectory(const char * /* pNative */)
+{
+	return NULL;
+}
+
+/*! ************************************
+
+	\brief Get the modification time of a directory
+
+	\param pNative Pointer to a "C" string of the native directory name
+	\param pStamp Pointer to receive the modification time
+	\return Zero if no error, non-zero if the directory can't be found
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::GetStamp(const char * /* pNative */,Word64 *pStamp)
+{
+	pStamp[0] = 0;
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Test if a native pathname exists
+
+	\param pNative Pointer to a "C" string of the native pathname
+	\return \ref TRUE if it exists, \ref FALSE if not
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::DoesPathExist(const char * /* pNative */)
+{
+	return TRUE;
+}
+
+#endif
@@ -0,0 +1,94 @@
+/***************************************
+
+	Case insensitive pathname cache
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRPATHCACHE_H__
+#define __BRPATHCACHE_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRSTRING_H__
+#include "brstring.h"
+#endif
+
+#ifndef __BRHASHMAP_H__
+#include "brhashmap.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class PathCache {
+	BURGER_DISABLECOPYCONSTRUCTORS(PathCache);
+public:
+	enum {
+		DEFAULTMEMORYLIMIT=0x100000,	///< Default memory limit in bytes
+		DEFAULTREVALIDATETIME=1000		///< Default milliseconds before cached data is checked against the file system
+	};
+private:
+	struct Directory_t {
+		Word64 m_uStamp;			///< Modification time of the directory when it was read
+		Word32 m_uValidatedTime;	///< Tick::ReadMilliseconds() when m_uStamp was last checked
+		WordPtr m_uCount;			///< Number of names in the directory
+		WordPtr m_uMemory;			///< Size of this allocation in bytes
+		const char *m_pNames[1];	///< Names sorted without case sensitivity (Variable length, followed by the text)
+	};
+	struct Resolved_t {
+		String m_Resolved;			///< Native pathname with the case used by the file system
+		Word32 m_uValidatedTime;	///< Tick::ReadMilliseconds() when the path was resolved
+		Word32 m_uGeneration;		///< Value of m_uGeneration when the path was resolved
+	};
+	HashMapString<Resolved_t> m_Resolved;		///< Pathnames that were found, keyed by the requested pathname
+	HashMapString<Directory_t *> m_Directories;	///< Directory listings, keyed by the native directory name
+	CriticalSection m_Lock;			///< Lock for multithreaded access
+	WordPtr m_uMemoryLimit;			///< Maximum amount of memory to use
+	WordPtr m_uResolvedMemory;		///< Approximate memory used by m_Resolved
+	WordPtr m_uDirectoryMemory;		///< Memory used by the directory listings
+	Word32 m_uRevalidateTime;		///< Milliseconds before cached data must be checked
+	Word32 m_uGeneration;			///< Incremented when a directory changes to invalidate m_Resolved
+	Word32 m_uHitCount;				///< Number of calls to Resolve() that used cached data
+	Word32 m_uMissCount;			///< Number of calls to Resolve() that checked the file system
+	static int BURGER_ANSIAPI QSortNames(const void *pFirst,const void *pSecond);
+	static Directory_t * BURGER_API NewDirectory(const char *pText,WordPtr uTextSize,WordPtr uCount,Word64 uStamp);
+	static const char * BURGER_API FindName(const Directory_t *pDirectory,const char *pName);
+	static WordPtr BURGER_API GetResolvedSize(const String *pKey,const Resolved_t *pResolved);
+	static Directory_t * BURGER_API ReadDirectory(const char *pNative);
+	static Word BURGER_API GetStamp(const char *pNative,Word64 *pStamp);
+	static Word BURGER_API DoesPathExist(const char *pNative);
+	Directory_t * BURGER_API GetDirectory(const char *pNative,Word32 uNow,Word bForce);
+	Word BURGER_API ResolveCase(String *pOutput,const char *pNative,Word32 uNow);
+	void BURGER_API ReleaseDirectory(const String *pKey);
+	void BURGER_API ReleaseAll(void);
+public:
+	PathCache();
+	~PathCache();
+	Word BURGER_API Resolve(String *pOutput,const char *pNative);
+	void BURGER_API Invalidate(const char *pNative);
+	void BURGER_API Purge(void);
+	void BURGER_API SetMemoryLimit(WordPtr uMemoryLimit);
+	BURGER_INLINE WordPtr GetMemoryLimit(void) const { return m_uMemoryLimit; }
+	BURGER_INLINE WordPtr GetMemoryUsed(void) const { return m_uResolvedMemory+m_uDirectoryMemory; }
+	BURGER_INLINE void SetRevalidateTime(Word32 uMilliseconds) { m_uRevalidateTime = uMilliseconds; }
+	BURGER_INLINE Word32 GetRevalidateTime(void) const { return m_uRevalidateTime; }
+	BURGER_INLINE Word32 GetHitCount(void) const { return m_uHitCount; }
+	BURGER_INLINE Word32 GetMissCount(void) const { return m_uMissCount; }
+	BURGER_INLINE void ResetCounters(void) { m_uHitCount = 0; m_uMissCount = 0; }
+};
+}
+/* END */
+
+#endif
@@ -19,6 +19,7 @@
 #include "brfile.h"
 #include "brfileansihelpers.h"
 #include "brglobals.h"
+#include "brprofiler.h"
 #include <stdlib.h>
 
 /*! ************************************
@@ -34,6 +35,12 @@
 	where the data is coming from and how it's cached in memory
 	for performance
 
+	Two file formats are supported. The original 'BRGR' format stores
+	32 bit offsets and up to 3 codecs. The 'BRG2' format stores 64 bit
+	offsets, page aligned data, an MD5 hash for each resource, up to
+	\ref MAXCODECS codecs and a minimal perfect hash of the resource
+	names so looking up a name doesn't require a sorted list.
+
 ***************************************/
 
 /*! ************************************
@@ -43,6 +50,35 @@
 	
 ***************************************/
 
+/*! ************************************
+
+	\struct Burger::RezFile::RootHeaderV2_t
+	\brief Data image for the start of a version 2 Rez file
+
+	All values are stored little endian. The directory
+	immediately follows the header and contains, in order,
+	m_uCodecCount 4 character codec signatures,
+	m_uEntryCount FileRezEntryV2_t records sorted by resource number,
+	m_uBucketCount 32 bit bucket seeds and m_uNameCount 32 bit
+	resource numbers for the name hash and finally m_uTextSize bytes
+	of name text. The name text starts with a zero so a name
+	offset of zero means the resource has no name.
+
+	\sa Burger::RezFile::HashName(const char *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::RezFile::FileRezEntryV2_t
+	\brief Data image of a version 2 resource entry
+
+	m_uFlags has the index into the codec table in the low 4 bits,
+	zero means the data is stored without compression, and
+	\ref REZV2FIXED if the data is loaded into fixed memory.
+
+***************************************/
+
 /*! ************************************
 
 	\struct Burger::RezFile::FileRezEntry_t
@@ -79,6 +115,7 @@
 ***************************************/
 
 const char Burger::RezFile::g_RezFileSignature[] = {'B','R','G','R'};
+const char Burger::RezFile::g_RezFileSignatureV2[] = {'B','R','G','2'};
 
 /***************************************
 
@@ -327,6 +364,202 @@ Word Burger::RezFile::FindName(const char *pRezName,Burger::RezFile::FilenameToR
 	return FALSE;
 }
 
+/*! ************************************
+
+	\brief Find a resource number with the name hash
+
+	Using the minimal perfect hash loaded from a version 2
+	rez file, locate the only resource that could have
+	this name and verify it's a match. 
+
+	\param pRezName Pointer to a "C" string of the requested filename
+	\return RezFile::INVALIDREZNUM if not found or the resource number
+	\sa Burger::RezFile::HashName(const char *,Word32)
+
+***************************************/
+
+Word Burger::RezFile::FindNameHash(const char *pRezName) const
+{
+	// If the filename has a prefix "20:FileName.txt"
+	// Then remove the prefix so it can also match
+
+	Word uFirst = reinterpret_cast<const Word8 *>(pRezName)[0];
+	if ((uFirst>='0') && (uFirst<('9'+1))) {
+		const char *pAuxName = StringCharacter(pRezName,':');
+		if (pAuxName) {
+			pRezName = pAuxName+1;
+		}
+	}
+
+	// The bucket selects the seed that hashes to a unique slot
+	const Word32 *pNameHash = m_pNameHash;
+	Word32 uSeed = pNameHash[HashName(pRezName,m_uNameHashSeed)%m_uNameHashBuckets];
+	Word uRezNum = pNameHash[m_uNameHashBuckets+(HashName(pRezName,uSeed)%m_uNameHashSlots)];
+
+	// Any name can land in a slot, so check for a match
+	const RezEntry_t *pEntry = Find(uRezNum);
+	if (pEntry && pEntry->m_pRezName && !StringCaseCompare(pEntry->m_pRezName,pRezName)) {
+		return uRezNum;
+	}
+	return INVALIDREZNUM;
+}
+
+/*! ************************************
+
+	\brief Release the name hash
+
+	When names are added or removed, the name hash loaded
+	from a version 2 rez file is no longer valid, so it's
+	discarded and the sorted list of names is used instead.
+
+	\sa Burger::RezFile::ProcessRezNames(void) const
+
+***************************************/
+
+void Burger::RezFile::ReleaseNameHash(void)
+{
+	Free(m_pNameHash);
+	m_pNameHash = NULL;
+	m_uNameHashBuckets = 0;
+	m_uNameHashSlots = 0;
+	m_uNameHashSeed = 0;
+}
+
+/*! ************************************
+
+	\brief Return the decompressor for a codec index
+
+	Version 2 rez files name their codecs, so the logged
+	decompressor with the matching signature is used. If
+	none match or it's a version 1 file, the decompressor logged
+	with the same index is returned.
+
+	\param uCodec Codec index (1-\ref MAXCODECS)
+	\return \ref NULL if no decompressor is available or a pointer to a Decompress class
+
+***************************************/
+
+Burger::Decompress *Burger::RezFile::GetDecompressor(Word uCodec) const
+{
+	if (--uCodec>=MAXCODECS) {
+		return NULL;
+	}
+	Word32 uSignature = m_CodecSignatures[uCodec];
+	if (uSignature) {
+		Word i = 0;
+		do {
+			Decompress *pDecompressor = m_Decompressors[i];
+			if (pDecompressor && (pDecompressor->GetSignature()==uSignature)) {
+				return pDecompressor;
+			}
+		} while (++i<MAXCODECS);
+	}
+	return m_Decompressors[uCodec];
+}
+
+/*! ************************************
+
+	\brief Add an unreferenced resource to the cache list
+
+	The resource is placed at the most recently used end
+	of the list. Only resources with data in memory and
+	a reference count of zero are in the list, so
+	resources in use are never evicted.
+
+	\param uRezNum Resource number of the entry
+	\param pEntry Pointer to the resource entry
+	\sa CacheUnlink(RezEntry_t *)
+
+***************************************/
+
+void Burger::RezFile::CacheLink(Word uRezNum,RezEntry_t *pEntry)
+{
+	// The links are resource numbers so they survive
+	// the group array being rebuilt by AddName() and Remove()
+	Word32 uHead = m_uCacheHead;
+	pEntry->m_uPrevious = static_cast<Word32>(INVALIDREZNUM);
+	pEntry->m_uNext = uHead;
+	if (uHead!=static_cast<Word32>(INVALIDREZNUM)) {
+		Find(uHead)->m_uPrevious = static_cast<Word32>(uRezNum);
+	} else {
+		m_uCacheTail = static_cast<Word32>(uRezNum);
+	}
+	m_uCacheHead = static_cast<Word32>(uRezNum);
+}
+
+/*! ************************************
+
+	\brief Remove a resource from the cache list
+
+	\param pEntry Pointer to a resource entry that's in the cache list
+	\sa CacheLink(Word,RezEntry_t *)
+
+***************************************/
+
+void Burger::RezFile::CacheUnlink(RezEntry_t *pEntry)
+{
+	Word32 uPrevious = pEntry->m_uPrevious;
+	Word32 uNext = pEntry->m_uNext;
+	if (uPrevious!=static_cast<Word32>(INVALIDREZNUM)) {
+		Find(uPrevious)->m_uNext = uNext;
+	} else {
+		m_uCacheHead = uNext;
+	}
+	if (uNext!=static_cast<Word32>(INVALIDREZNUM)) {
+		Find(uNext)->m_uPrevious = uPrevious;
+	} else {
+		m_uCacheTail = uPrevious;
+	}
+}
+
+/*! ************************************
+
+	\brief Remove a resource's data from the cache accounting
+
+	Call this before the data handle is released or given
+	away. The reference count must not have been cleared yet.
+
+	\param pEntry Pointer to a resource entry with data in memory
+
+***************************************/
+
+void Burger::RezFile::CacheRemove(RezEntry_t *pEntry)
+{
+	if (!(pEntry->m_uFlags&ENTRYFLAGSREFCOUNT)) {
+		CacheUnlink(pEntry);
+	}
+	m_uCacheUsed -= pEntry->m_uLength;
+}
+
+/*! ************************************
+
+	\brief Release resources until the cache is within budget
+
+	Unreferenced resources are released starting with the
+	least recently used until the memory used is no more than
+	the budget. Resources that are in use are never released, so
+	the cache can exceed the budget if they alone are larger.
+
+	\sa SetCacheBudget(WordPtr)
+
+***************************************/
+
+void Burger::RezFile::CacheTrim(void)
+{
+	WordPtr uBudget = m_uCacheBudget;
+	if (uBudget) {
+		Word32 uRezNum;
+		while ((m_uCacheUsed>uBudget) && ((uRezNum = m_uCacheTail)!=static_cast<Word32>(INVALIDREZNUM))) {
+			RezEntry_t *pEntry = Find(uRezNum);
+			CacheRemove(pEntry);
+			void **ppData = pEntry->m_ppData;
+			pEntry->m_ppData = NULL;
+			m_pMemoryManager->FreeHandle(ppData);
+			++m_uCacheEvictionCount;
+		}
+	}
+}
+
 /*! ************************************
 
 	\brief Create the in memory rez file dictionary from a file image
@@ -458,6 +691,7 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 							// Is the data compressed?
 							if (uFileOffset&REZOFFSETDECOMPMASK) {
 								uFlags |= ((uFileOffset&REZOFFSETDECOMPMASK)>>(REZOFFSETDECOMPSHIFT-ENTRYFLAGSDECOMPSHIFT));
+								uFlags |= ((uFileOffset&REZOFFSETDECOMPMASK)>>REZOFFSETDECOMPSHIFT)<<ENTRYFLAGSCODECSHIFT;
 								uFileOffset&=(~REZOFFSETDECOMPMASK);
 								uLength = 0;
 							}
@@ -499,7 +733,9 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 							if (uNameOffset&ENTRYFLAGSNAMEOFFSETMASK) {
 								pEntry->m_pRezName = pAdjusted+(uNameOffset&ENTRYFLAGSNAMEOFFSETMASK);
 							}
-							pEntry->m_uFlags=uNameOffset&(~ENTRYFLAGSNAMEOFFSETMASK);
+							uNameOffset &= (~ENTRYFLAGSNAMEOFFSETMASK);
+							// Convert the decompressor index to the same bits used by version 2 files
+							pEntry->m_uFlags = uNameOffset|(((uNameOffset&ENTRYFLAGSDECOMPMASK)>>ENTRYFLAGSDECOMPSHIFT)<<ENTRYFLAGSCODECSHIFT);
 							++pEntry;
 						} while (--uNewCount);
 					}
@@ -518,6 +754,225 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 	return NULL;
 }
 
+/*! ************************************
+
+	\brief Create the in memory rez file dictionary from a version 2 directory
+
+	The directory is validated before it's used, the resource numbers
+	must be in ascending order, names must reside in the name text and
+	all codec indexes must be in the codec table. Unnamed entries have
+	a name offset of zero, which is valid even if there is no name text.
+
+	\param pData Pointer to the directory that follows the RootHeaderV2_t
+	\param pHeader Pointer to the header with native endian values
+	\param uStartOffset Number of bytes the header was from the start of file (For data index offset adjustments)
+	\param pGroupCount Pointer to receive the number of groups created
+
+	\return A newly allocated Burger::RezFile::RezGroup_t * or \ref NULL on error
+
+***************************************/
+
+Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeaderV2(const Word8 *pData,const RootHeaderV2_t *pHeader,Word32 uStartOffset,Word32 *pGroupCount)
+{
+	Word uEntryCount = pHeader->m_uEntryCount;
+	WordPtr uTextSize = pHeader->m_uTextSize;
+	const Word8 *pEntries = pData+(pHeader->m_uCodecCount*4);
+	const char *pText = reinterpret_cast<const char *>(pEntries+(uEntryCount*FILEREZENTRYV2SIZE)+
+		((pHeader->m_uBucketCount+pHeader->m_uNameCount)*sizeof(Word32)));
+
+	// The name text must start and end with a zero
+	if (!uEntryCount || (uTextSize && (pText[0] || pText[uTextSize-1]))) {
+		return NULL;
+	}
+
+	// First pass, validate the entries and count the groups
+
+	Word uGroupCount = 0;
+	Word uNameCount = 0;
+	Word uPrevious = 0;
+	const Word8 *pWork = pEntries;
+	Word i = uEntryCount;
+	do {
+		const FileRezEntryV2_t *pFileEntry = reinterpret_cast<const FileRezEntryV2_t *>(pWork);
+		Word uRezNum = LittleEndian::Load(&pFileEntry->m_uRezNum);
+		Word uNameOffset = LittleEndian::Load(&pFileEntry->m_uNameOffset);
+		if ((uRezNum==INVALIDREZNUM) ||
+			((i!=uEntryCount) && (uRezNum<=uPrevious)) ||
+			(uNameOffset && (uNameOffset>=uTextSize)) ||
+			((LittleEndian::Load(&pFileEntry->m_uFlags)&REZV2CODECMASK)>pHeader->m_uCodecCount)) {
+			return NULL;
+		}
+		// Start a new group if not contiguous
+		if ((i==uEntryCount) || (uRezNum!=(uPrevious+1))) {
+			++uGroupCount;
+		}
+		if (uNameOffset) {
+			++uNameCount;
+		}
+		uPrevious = uRezNum;
+		pWork += FILEREZENTRYV2SIZE;
+	} while (--i);
+
+	// The name hash must have an entry for every name
+	if (uNameCount!=pHeader->m_uNameCount) {
+		return NULL;
+	}
+
+	// Now that the size is known, create the dictionary
+
+	WordPtr uNewLength = (uGroupCount*(sizeof(RezGroup_t)-sizeof(RezEntry_t)))+(uEntryCount*sizeof(RezEntry_t));
+	RezGroup_t *pResult = static_cast<RezGroup_t *>(Alloc(uNewLength+uTextSize));
+	if (pResult) {
+		char *pNewText = reinterpret_cast<char *>(pResult)+uNewLength;
+		MemoryCopy(pNewText,pText,uTextSize);
+
+		RezGroup_t *pGroup = pResult;
+		RezEntry_t *pEntry = pResult->m_Array;
+		pWork = pEntries;
+		i = uEntryCount;
+		do {
+			const FileRezEntryV2_t *pFileEntry = reinterpret_cast<const FileRezEntryV2_t *>(pWork);
+			Word uRezNum = LittleEndian::Load(&pFileEntry->m_uRezNum);
+			// Start a new group?
+			if ((i==uEntryCount) || (uRezNum!=(uPrevious+1))) {
+				if (i!=uEntryCount) {
+					pGroup = reinterpret_cast<RezGroup_t *>(pEntry);
+					pEntry = pGroup->m_Array;
+				}
+				pGroup->m_uBaseRezNum = uRezNum;
+				pGroup->m_uCount = 0;
+			}
+			++pGroup->m_uCount;
+			uPrevious = uRezNum;
+
+			pEntry->m_ppData = NULL;
+			pEntry->m_pRezName = NULL;
+			Word uNameOffset = LittleEndian::Load(&pFileEntry->m_uNameOffset);
+			if (uNameOffset) {
+				pEntry->m_pRezName = pNewText+uNameOffset;
+			}
+			// Adjust the file offset from the start of the file image
+			pEntry->m_uFileOffset = LittleEndian::LoadAny(&pFileEntry->m_uFileOffset)+uStartOffset;
+			pEntry->m_uLength = LittleEndian::Load(&pFileEntry->m_uLength);
+			pEntry->m_uCompressedLength = LittleEndian::Load(&pFileEntry->m_uCompressedLength);
+			Word32 uFileFlags = LittleEndian::Load(&pFileEntry->m_uFlags);
+			Word32 uFlags = ((uFileFlags&REZV2CODECMASK)<<ENTRYFLAGSCODECSHIFT)|ENTRYFLAGSHASHVALID;
+			if (uFileFlags&REZV2FIXED) {
+				uFlags |= ENTRYFLAGSHIGHMEMORY;
+			}
+			pEntry->m_uFlags = uFlags;
+			MemoryCopy(&pEntry->m_Hash,&pFileEntry->m_Hash,sizeof(MD5_t));
+			++pEntry;
+			pWork += FILEREZENTRYV2SIZE;
+		} while (--i);
+		pGroupCount[0] = uGroupCount;
+	}
+	return pResult;
+}
+
+/*! ************************************
+
+	\brief Open a version 2 resource file
+
+	The file is already open and the signature was verified.
+	Load the directory, create the resource dictionary and
+	retain the name hash so there's no need to sort the names.
+
+	\param uStartOffset Offset from the start of the file where the rezfile image resides.
+	\return \ref FALSE if no error occurred, \ref TRUE if the file is damaged or out of memory
+
+***************************************/
+
+Word Burger::RezFile::InitV2(Word32 uStartOffset)
+{
+	// Read in the header and convert it into native endian
+	RootHeaderV2_t MyHeader;
+	if (m_File.ReadAt(uStartOffset,&MyHeader,ROOTHEADERV2SIZE)!=ROOTHEADERV2SIZE) {
+		return TRUE;
+	}
+	MyHeader.m_uHeaderSize = LittleEndian::Load(&MyHeader.m_uHeaderSize);
+	MyHeader.m_uEntryCount = LittleEndian::Load(&MyHeader.m_uEntryCount);
+	MyHeader.m_uNameCount = LittleEndian::Load(&MyHeader.m_uNameCount);
+	MyHeader.m_uCodecCount = LittleEndian::Load(&MyHeader.m_uCodecCount);
+	MyHeader.m_uBucketCount = LittleEndian::Load(&MyHeader.m_uBucketCount);
+	MyHeader.m_uHashSeed = LittleEndian::Load(&MyHeader.m_uHashSeed);
+	MyHeader.m_uPageSize = LittleEndian::Load(&MyHeader.m_uPageSize);
+	MyHeader.m_uTextSize = LittleEndian::Load(&MyHeader.m_uTextSize);
+	MyHeader.m_uDirectorySize = LittleEndian::Load(&MyHeader.m_uDirectorySize);
+
+	// Sanity check the header before allocating memory
+	Word32 uEntryCount = MyHeader.m_uEntryCount;
+	if ((MyHeader.m_uHeaderSize<ROOTHEADERV2SIZE) ||
+		(MyHeader.m_uCodecCount>MAXCODECS) ||
+		(uEntryCount>(0x7FFFFFFFU/FILEREZENTRYV2SIZE)) ||
+		(MyHeader.m_uNameCount>uEntryCount) ||
+		(MyHeader.m_uBucketCount>uEntryCount) ||
+		((MyHeader.m_uNameCount!=0)!=(MyHeader.m_uBucketCount!=0)) ||
+		(MyHeader.m_uPageSize&(MyHeader.m_uPageSize-1))) {
+		return TRUE;
+	}
+	Word64 uDirectorySize = (static_cast<Word64>(MyHeader.m_uCodecCount)*4)+
+		(static_cast<Word64>(uEntryCount)*FILEREZENTRYV2SIZE)+
+		((static_cast<Word64>(MyHeader.m_uBucketCount)+MyHeader.m_uNameCount)*sizeof(Word32))+
+		MyHeader.m_uTextSize;
+	if (uDirectorySize!=MyHeader.m_uDirectorySize) {
+		return TRUE;
+	}
+
+	// An empty file is valid
+	if (!uEntryCount) {
+		m_bExternalFileEnabled = TRUE;
+		return FALSE;
+	}
+
+	Word uResult = TRUE;
+	Word8 *pData = static_cast<Word8 *>(Alloc(MyHeader.m_uDirectorySize));
+	if (pData) {
+		if (m_File.ReadAt(static_cast<Word64>(uStartOffset)+MyHeader.m_uHeaderSize,pData,MyHeader.m_uDirectorySize)==MyHeader.m_uDirectorySize) {
+			Word32 uGroupCount;
+			RezGroup_t *pRezGroup = ParseRezFileHeaderV2(pData,&MyHeader,uStartOffset,&uGroupCount);
+			if (pRezGroup) {
+				// Copy the name hash tables
+				Word32 *pNameHash = NULL;
+				WordPtr uHashCount = MyHeader.m_uBucketCount+MyHeader.m_uNameCount;
+				if (uHashCount) {
+					pNameHash = static_cast<Word32 *>(Alloc(uHashCount*sizeof(Word32)));
+					if (!pNameHash) {
+						Free(pRezGroup);
+						pRezGroup = NULL;
+					} else {
+						const Word32 *pInput = reinterpret_cast<const Word32 *>(pData+(MyHeader.m_uCodecCount*4)+(uEntryCount*FILEREZENTRYV2SIZE));
+						WordPtr j = 0;
+						do {
+							pNameHash[j] = LittleEndian::Load(&pInput[j]);
+						} while (++j<uHashCount);
+					}
+				}
+				if (pRezGroup) {
+					// Save the codec signatures in native endian to match Decompress::GetSignature()
+					Word i = 0;
+					if (MyHeader.m_uCodecCount) {
+						do {
+							MemoryCopy(&m_CodecSignatures[i],pData+(i*4),4);
+						} while (++i<MyHeader.m_uCodecCount);
+					}
+					m_uGroupCount = uGroupCount;
+					m_pGroups = pRezGroup;
+					m_pNameHash = pNameHash;
+					m_uNameHashBuckets = MyHeader.m_uBucketCount;
+					m_uNameHashSlots = MyHeader.m_uNameCount;
+					m_uNameHashSeed = MyHeader.m_uHashSeed;
+					m_bExternalFileEnabled = TRUE;
+					// The sorted name list is created on demand
+					uResult = FALSE;
+				}
+			}
+		}
+		Free(pData);
+	}
+	return uResult;
+}
+
 /*! ************************************
 
 	\brief Create a hash table for all of the filenames
@@ -531,7 +986,7 @@ Burger::RezFile::RezGroup_t * BURGER_API Burger::RezFile::ParseRezFileHeader(con
 
 ***************************************/
 
-void Burger::RezFile::ProcessRezNames(void)
+void Burger::RezFile::ProcessRezNames(void) const
 {
 	// Firstly, determine the number of entries that have filenames
 
@@ -651,6 +1106,8 @@ void Burger::RezFile::FixupFilenames(char *pText)
 		} while (--uCount);
 		pNewGroup = reinterpret_cast<RezGroup_t *>(pNewEntry);
 	} while (--uGroupCount);
+	// The name hash from the file no longer matches
+	ReleaseNameHash();
 	// Sort the names
 	ProcessRezNames();
 }
@@ -674,11 +1131,23 @@ Burger::RezFile::RezFile(Burger::MemoryManagerHandle *pMemoryManager) :
 	m_uRezNameCount(0),
 	m_pGroups(NULL),
 	m_pRezNames(NULL),
+	m_pNameHash(NULL),
+	m_uNameHashBuckets(0),
+	m_uNameHashSlots(0),
+	m_uNameHashSeed(0),
+	m_uCacheBudget(0),
+	m_uCacheUsed(0),
+	m_uCacheHead(static_cast<Word32>(INVALIDREZNUM)),
+	m_uCacheTail(static_cast<Word32>(INVALIDREZNUM)),
+	m_uCacheHitCount(0),
+	m_uCacheMissCount(0),
+	m_uCacheEvictionCount(0),
 	m_bExternalFileEnabled(TRUE)
 {
 	Word i=0;
 	do {
 		m_Decompressors[i] = NULL;
+		m_CodecSignatures[i] = 0;
 	} while (++i<MAXCODECS);
 }
 
@@ -778,8 +1247,13 @@ Word Burger::RezFile::Init(const char *pFileName,Word32 uStartOffset)
 			RootHeader_t MyHeader;
 			// Read in the header
 			if (m_File.Read(&MyHeader,ROOTHEADERSIZE)==ROOTHEADERSIZE) {
+				// Is this the version 2 format?
+				if (!MemoryCompare(MyHeader.m_Name,g_RezFileSignatureV2,4)) {
+					if (!InitV2(uStartOffset)) {
+						return FALSE;
+					}
 				// Check the signature
-				if (!MemoryCompare(MyHeader.m_Name,g_RezFileSignature,4)) {
+				} else if (!MemoryCompare(MyHeader.m_Name,g_RezFileSignature,4)) {
 					// Assume new data format
 					Word uSwapFlag = 0;
 					// Hack test to see if this is an old format file
@@ -872,10 +1346,18 @@ void Burger::RezFile::Shutdown(void)
 	Free(m_pGroups);
 	// Release the name list
 	Free(m_pRezNames);
+	ReleaseNameHash();
 	m_pGroups = NULL;
 	m_pRezNames = NULL;
 	m_uRezNameCount = 0;
 	m_uGroupCount = 0;
+	m_uCacheUsed = 0;
+	m_uCacheHead = static_cast<Word32>(INVALIDREZNUM);
+	m_uCacheTail = static_cast<Word32>(INVALIDREZNUM);
+	Word i=0;
+	do {
+		m_CodecSignatures[i] = 0;
+	} while (++i<MAXCODECS);
 }
 
 /*! ************************************
@@ -913,6 +1395,7 @@ void Burger::RezFile::PurgeCache(void)
 						// Not referenced right now
 						if (!(pEntry->m_uFlags&ENTRYFLAGSREFCOUNT)) {
 							// Dispose of it.
+							m_uCacheUsed -= pEntry->m_uLength;
 							m_pMemoryManager->FreeHandle(ppData);
 							pEntry->m_ppData = NULL;
 						}
@@ -926,8 +1409,100 @@ void Burger::RezFile::PurgeCache(void)
 			// Count down
 		} while (--uGroupCount);
 	}
+	// Every unreferenced resource is gone, so the cache list is empty
+	m_uCacheHead = static_cast<Word32>(INVALIDREZNUM);
+	m_uCacheTail = static_cast<Word32>(INVALIDREZNUM);
+}
+
+/*! ************************************
+
+	\brief Set the memory budget for cached resources
+
+	When resources are released, they remain in memory so
+	they can be reused without reading them from the disk again.
+	Setting a budget limits the total bytes of resource data kept
+	in memory. Unreferenced resources are released, least recently
+	used first, whenever the total exceeds the budget. Resources
+	that are in use are never released by the budget.
+
+	The default is zero, which means there is no limit and
+	memory is only recovered by the handle based memory
+	manager purging released resources under pressure.
+
+	\param uBudget Maximum number of bytes of resource data to keep in memory, zero for no limit
+	\sa GetCacheBudget(void) const, GetCacheUsed(void) const or PurgeCache(void)
+
+***************************************/
+
+void Burger::RezFile::SetCacheBudget(WordPtr uBudget)
+{
+	m_uCacheBudget = uBudget;
+	CacheTrim();
 }
 
+/*! ************************************
+
+	\fn WordPtr Burger::RezFile::GetCacheBudget(void) const
+	\brief Return the memory budget for cached resources
+
+	\return Maximum number of bytes of resource data to keep in memory, zero for no limit
+	\sa SetCacheBudget(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::RezFile::GetCacheUsed(void) const
+	\brief Return the bytes of resource data in memory
+
+	This includes resources in use and released resources
+	kept in the cache. Resources purged by the handle based memory
+	manager are counted until the rez file notices they are gone.
+
+	\return Number of bytes of resource data loaded
+	\sa SetCacheBudget(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RezFile::GetCacheHitCount(void) const
+	\brief Return the number of loads that used data already in memory
+
+	\return Number of cache hits since the last call to ResetCacheCounters()
+	\sa GetCacheMissCount(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RezFile::GetCacheMissCount(void) const
+	\brief Return the number of loads that had to read data
+
+	\return Number of cache misses since the last call to ResetCacheCounters()
+	\sa GetCacheHitCount(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::RezFile::GetCacheEvictionCount(void) const
+	\brief Return the number of resources released to stay within the budget
+
+	\return Number of evictions since the last call to ResetCacheCounters()
+	\sa SetCacheBudget(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::RezFile::ResetCacheCounters(void)
+	\brief Set the hit, miss and eviction counters to zero
+
+	\sa GetCacheHitCount(void) const, GetCacheMissCount(void) const or GetCacheEvictionCount(void) const
+
+***************************************/
+
 /*! ************************************
 
 	\brief Enable or disable reading external files
@@ -962,7 +1537,17 @@ Word Burger::RezFile::SetExternalFlag(Word bEnable)
 /*! ************************************
 
 	\brief Log a resource decompressor
-	\param uCompressID Compressor ID (1-3)
+
+	Version 1 rez files use the decompressor logged with the matching
+	ID. Version 2 rez files look for the logged decompressor
+	with the signature named in the file and if it's not
+	found, use the decompressor logged with the matching ID.
+
+	Burger::DecompressLZ4 is the fastest decompressor for data
+	that's loaded often, Burger::DecompressLZSS and
+	Burger::DecompressDeflate compress better.
+
+	\param uCompressID Compressor ID (1-\ref MAXCODECS)
 	\param pProc Pointer to a decompression codec
 
 ***************************************/
@@ -977,7 +1562,7 @@ void Burger::RezFile::LogDecompressor(Word uCompressID,Burger::Decompress *pProc
 #if defined(_DEBUG)
 	else {
 		if (Globals::AreWarningsEnabled()) {
-			Debug::Message("RezFile::LogDecompressor() : uCompressID is not 1-3, it's %u\n",uCompressID+1);
+			Debug::Message("RezFile::LogDecompressor() : uCompressID is not 1-%u, it's %u\n",static_cast<Word>(MAXCODECS),uCompressID+1);
 		}
 	}
 #endif
@@ -988,7 +1573,9 @@ void Burger::RezFile::LogDecompressor(Word uCompressID,Burger::Decompress *pProc
 	\brief Given a resource name, return the resource number
 	
 	Scan the entries for the filename and
-	return the resource entry number
+	return the resource entry number. If the name hash
+	from a version 2 rez file is present, it's used instead
+	of a binary search.
 
 	\param pRezName Pointer to a "C" string with the filename to locate in the rez file
 	\return RezFile::INVALIDREZNUM on error or a valid resource number if the resource was found.
@@ -998,6 +1585,11 @@ void Burger::RezFile::LogDecompressor(Word uCompressID,Burger::Decompress *pProc
 
 Word Burger::RezFile::GetRezNum(const char *pRezName) const
 {
+	// Use the name hash if available
+	if (m_pNameHash) {
+		return FindNameHash(pRezName);
+	}
+
 	FilenameToRezNum_t *pRezNameEntry;		// Pointer to the master name list
 	
 	if (FindName(pRezName,&pRezNameEntry)) {
@@ -1247,6 +1839,7 @@ void Burger::RezFile::Remove(Word uRezNum)
 	pEntry->m_pRezName = NULL;			// Garbage collect the filename
 	void **ppData = pEntry->m_ppData;
 	if (ppData) {		// Was there memory?
+		CacheRemove(pEntry);
 		pEntry->m_ppData = NULL;		// Mark as GONE
 		Word32 uOffset = pEntry->m_uFlags;
 		pEntry->m_uFlags = uOffset&(~ENTRYFLAGSREFCOUNT);	/* No references */
@@ -1265,6 +1858,7 @@ void Burger::RezFile::Remove(Word uRezNum)
 	if (uGroupCount==1 && pGroupToDelete->m_uCount==1) {
 		Free(pGroupToDelete);
 		Free(m_pRezNames);
+		ReleaseNameHash();
 		m_pGroups = NULL;
 		m_pRezNames = NULL;
 		m_uRezNameCount = 0;
@@ -1364,23 +1958,104 @@ void Burger::RezFile::Remove(const char *pRezName)
 
 /*! ************************************
 
-	\fn const Burger::RezFile::FilenameToRezNum_t *Burger::RezFile::GetNameArray(void) const
 	\brief Get the pointer to the list of filenames managed by
 	the RezFile. 
 
+	Version 2 rez files don't need the sorted list for lookups,
+	so it's created on the first call.
+
 	\note This pointer is valid as long as no filenames are added or removed.
 	\sa Burger::RezFile::GetNameArraySize(void) const
 
 ***************************************/
 
+const Burger::RezFile::FilenameToRezNum_t *Burger::RezFile::GetNameArray(void) const
+{
+	if (!m_pRezNames && m_uGroupCount) {
+		ProcessRezNames();
+	}
+	return m_pRezNames;
+}
+
 /*! ************************************
 
-	\fn Word Burger::RezFile::GetNameArraySize(void) const
 	\brief Return the number of elements returned by Burger::RezFile::GetNameArray(void) const
 	\sa Burger::RezFile::GetNameArray(void) const
 
 ***************************************/
 
+Word Burger::RezFile::GetNameArraySize(void) const
+{
+	if (!m_pRezNames && m_uGroupCount) {
+		ProcessRezNames();
+	}
+	return m_uRezNameCount;
+}
+
+/*! ************************************
+
+	\brief Return the hash of a resource's data
+
+	Version 2 rez files store the MD5 hash of each resource
+	before compression. Version 1 rez files and resources
+	added at runtime don't have a hash.
+
+	\param uRezNum Resource number
+	\param pOutput Pointer to a MD5_t to receive the hash
+	\return \ref FALSE if the hash was found, \ref TRUE if there is no hash
+		for this resource (pOutput is zeroed)
+
+***************************************/
+
+Word Burger::RezFile::GetHash(Word uRezNum,MD5_t *pOutput) const
+{
+	const RezEntry_t *pEntry = Find(uRezNum);
+	if (pEntry && (pEntry->m_uFlags&ENTRYFLAGSHASHVALID)) {
+		pOutput[0] = pEntry->m_Hash;
+		return FALSE;
+	}
+	MemoryClear(pOutput,sizeof(MD5_t));
+	return TRUE;
+}
+
+/*! ************************************
+
+	\brief Hash a resource name
+
+	Create a 32 bit hash of a resource name without case
+	sensitivity, only the letters A-Z are converted to lower case
+	to match StringCaseCompare(const char *,const char *).
+	This is the hash used to create the minimal perfect
+	hash stored in version 2 rez files. Tools that create
+	rez files must use this function.
+
+	\param pRezName Pointer to a "C" string of the resource name
+	\param uSeed Seed value to create a unique hash
+	\return 32 bit hash value
+
+***************************************/
+
+Word32 BURGER_API Burger::RezFile::HashName(const char *pRezName,Word32 uSeed)
+{
+	// FNV-1a with the seed mixed into the basis
+	Word32 uHash = 0x811C9DC5U^uSeed;
+	Word uTemp;
+	while ((uTemp = reinterpret_cast<const Word8 *>(pRezName)[0])!=0) {
+		++pRezName;
+		if ((uTemp>='A') && (uTemp<('Z'+1))) {
+			uTemp += 32;
+		}
+		uHash = (uHash^uTemp)*0x01000193U;
+	}
+	// Avalanche so all bits are usable for the modulo
+	uHash ^= uHash>>16;
+	uHash *= 0x85EBCA6BU;
+	uHash ^= uHash>>13;
+	uHash *= 0xC2B2AE35U;
+	uHash ^= uHash>>16;
+	return uHash;
+}
+
 /*! ************************************
 
 	\brief Return the lowest valid resource number
@@ -1550,6 +2225,7 @@ Word Burger::RezFile::GetIDFromPointer(const void *pRez,Word *pRezNum,char *pBuf
 
 void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 {		
+	BURGER_PROFILE_ZONE("RezFile::Load");
 	if (pLoadedFlag) {
 		pLoadedFlag[0] = FALSE;		// Assume cached or failed
 	}
@@ -1561,16 +2237,23 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 	void **ppData = pEntry->m_ppData;	// Get the current handle
 	if (ppData) {						// Valid handle?
 		if (ppData[0]) {				// Handle not purged? */
+			++m_uCacheHitCount;
+			// Referenced resources are not in the cache list
+			if (!(pEntry->m_uFlags&ENTRYFLAGSREFCOUNT)) {
+				CacheUnlink(pEntry);
+			}
 			// Increment the reference count
 			pEntry->m_uFlags=pEntry->m_uFlags+ENTRYFLAGSREFADD;
 			m_pMemoryManager->SetPurgeFlag(ppData,FALSE);	// Can't purge
 			return ppData;				// Return the handle
 		}
+		CacheRemove(pEntry);
 		pEntry->m_ppData = NULL;	// Mark as gone!
 		m_pMemoryManager->FreeHandle(ppData);		// Release the memory
 		ppData = NULL;				// Set to zero for future error checking
 	}
 
+	++m_uCacheMissCount;
 	Word32 uFileNameOffset = pEntry->m_uFlags;			// Filename offset
  	pEntry->m_uFlags=uFileNameOffset+ENTRYFLAGSREFADD;	// Increase the reference count
 	Word uHandleFlags = 0;								// ID the handle as the resource manager
@@ -1612,6 +2295,8 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 					pLoadedFlag[0] = TRUE;		// Data is new
 				}
 				pEntry->m_ppData = ppData;		// Save the handle
+				m_uCacheUsed += pEntry->m_uLength;
+				CacheTrim();
 #if defined(_DEBUG)
 				if (Globals::GetTraceFlag()&Globals::TRACE_REZLOAD) {	// Should I print it?
 					Debug::Message("Loaded resource %u from external file %s\n",uRezNum,pFileName);
@@ -1623,18 +2308,17 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 	}
 
 	// Let's load it in from the .REZ file
-	Word32 uFileOffset = pEntry->m_uFileOffset;			
+	Word64 uFileOffset = pEntry->m_uFileOffset;			
 	if (!m_File.IsOpened() || !uFileOffset) {						// No resource file found?
 		pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);	// Kill the ref count
 		return NULL;
 	}
-	m_File.SetMark(uFileOffset);						// Seek into the file
 
 	Word32 DataLength = pEntry->m_uLength;				// Preload the length
 	Word32 PackedLength = pEntry->m_uCompressedLength;
-	if (uFileNameOffset&ENTRYFLAGSDECOMPMASK) {			// Is this compressed?
+	if (uFileNameOffset&ENTRYFLAGSCODECMASK) {			// Is this compressed?
 		// Get the compressor
-		Decompress *pDecompressor = m_Decompressors[((uFileNameOffset>>ENTRYFLAGSDECOMPSHIFT)&3)-1];
+		Decompress *pDecompressor = GetDecompressor((uFileNameOffset&ENTRYFLAGSCODECMASK)>>ENTRYFLAGSCODECSHIFT);
 		if (!pDecompressor) {		// Is there a compressor logged?
 			pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);	// Kill the ref count
 			return NULL;
@@ -1642,10 +2326,17 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 
 		// The old format had the data length in the compressed data
 		if (!DataLength) {
-			DataLength = m_File.ReadLittleWord32();		// Get the length
+			Word32 uLengthPrefix;
+			if (m_File.ReadAt(uFileOffset,&uLengthPrefix,4)!=4) {
+				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);	// Kill the ref count
+				return NULL;
+			}
+			DataLength = LittleEndian::Load(&uLengthPrefix);	// Get the length
 			pEntry->m_uLength = DataLength;
-			pEntry->m_uFileOffset += 4;
-			pEntry->m_uCompressedLength -= 4;
+			uFileOffset += 4;
+			pEntry->m_uFileOffset = uFileOffset;
+			PackedLength -= 4;
+			pEntry->m_uCompressedLength = PackedLength;
 		}
 
 		ppData = m_pMemoryManager->AllocHandle(DataLength,uHandleFlags);	// Get dest buffer
@@ -1654,8 +2345,14 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 			return NULL;
 		}
 		m_pMemoryManager->SetID(ppData,uRezNum);		// Set the ID to the handle
-		Word32 BufferSize = (PackedLength<MAXBUFFER) ? PackedLength : MAXBUFFER;
+		// Read the packed data in one pass if possible so block based
+		// decompressors like LZ4 can decode straight into the output
+		Word32 BufferSize = PackedLength;
 		Word8 *PackedPtr = static_cast<Word8 *>(Alloc(BufferSize));	// Get Buffer
+		if (!PackedPtr && (BufferSize>MAXBUFFER)) {
+			BufferSize = MAXBUFFER;		// Fall back to reading in chunks
+			PackedPtr = static_cast<Word8 *>(Alloc(BufferSize));
+		}
 		if (!PackedPtr) {				// No compressed data buffer?
 			m_pMemoryManager->FreeHandle(ppData);
 			pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
@@ -1667,12 +2364,14 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 		Word8 *pOutput = (Word8 *)m_pMemoryManager->Lock(ppData);
 		do {		/* Loop for decompression */
 			WordPtr ChunkSize = (BufferSize<PackedSize) ? BufferSize : PackedSize;
-			if (m_File.Read(PackedPtr,ChunkSize)!=ChunkSize) {
+			if (m_File.ReadAt(uFileOffset,PackedPtr,ChunkSize)!=ChunkSize) {
+				Free(PackedPtr);
 				m_pMemoryManager->FreeHandle(ppData);
 				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
 				return NULL;
 			}
 			if (pDecompressor->Process(pOutput,PackedHeader,PackedPtr,ChunkSize)==Decompress::DECOMPRESS_BADINPUT) {
+				Free(PackedPtr);
 				m_pMemoryManager->FreeHandle(ppData);
 				pEntry->m_uFlags &= (~ENTRYFLAGSREFCOUNT);		// Kill the ref count
 				return NULL;
@@ -1680,6 +2379,7 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 			PackedHeader -= pDecompressor->GetProcessedOutputSize();
 			pOutput += pDecompressor->GetProcessedOutputSize();
 			PackedSize -= ChunkSize;
+			uFileOffset += ChunkSize;
 		} while (PackedSize);
 		pDecompressor->Reset();		// Force a shutdown
 		Free(PackedPtr);	/* Release the temp buffer */
@@ -1688,6 +2388,8 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 			pLoadedFlag[0] = TRUE;		/* Data is new */
 		}
 		pEntry->m_ppData = ppData;		/* Save the handle */
+		m_uCacheUsed += DataLength;
+		CacheTrim();
 #if defined(_DEBUG)
 		if (Globals::GetTraceFlag()&Globals::TRACE_REZLOAD) {	/* Should I print it? */
 			if (pEntry->m_pRezName) {
@@ -1705,12 +2407,14 @@ void ** Burger::RezFile::LoadHandle(Word uRezNum,Word *pLoadedFlag)
 	ppData = m_pMemoryManager->AllocHandle(DataLength,uHandleFlags);	// Get the memory
 	if (ppData) {		/* Memory ok? */
 		m_pMemoryManager->SetID(ppData,uRezNum);		// Set the ID to the handle
-		if (m_File.Read(m_pMemoryManager->Lock(ppData),DataLength)==DataLength) {	/* Read it in */
+		if (m_File.ReadAt(uFileOffset,m_pMemoryManager->Lock(ppData),DataLength)==DataLength) {	/* Read it in */
 			m_pMemoryManager->Unlock(ppData);
 			if (pLoadedFlag) {
 				pLoadedFlag[0] = TRUE;		/* Data is new */
 			}
 			pEntry->m_ppData = ppData;		/* Save the handle */
+			m_uCacheUsed += DataLength;
+			CacheTrim();
 #if defined(_DEBUG)
 			if (Globals::GetTraceFlag()&Globals::TRACE_REZLOAD) {	/* Should I print it? */
 				if (pEntry->m_pRezName) {
@@ -1878,6 +2582,8 @@ void Burger::RezFile::Release(Word uRezNum)
 				if (ppData) {							// Is there a handle?
 					m_pMemoryManager->Unlock(ppData);				// Unlock it
 					m_pMemoryManager->SetPurgeFlag(ppData,TRUE);	// Mark as purgable
+					CacheLink(uRezNum,pEntry);						// Most recently used
+					CacheTrim();
 				}
 			}
 		}
@@ -1915,6 +2621,8 @@ void Burger::RezFile::Release(const char *pRezName)
 					if (ppData) {			/* Is there a handle? */
 						m_pMemoryManager->Unlock(ppData);		/* Unlock it */
 						m_pMemoryManager->SetPurgeFlag(ppData,TRUE);	/* Mark as purgable */
+						CacheLink(uRezNum,pEntry);				/* Most recently used */
+						CacheTrim();
 					}
 				}
 			}
@@ -1938,6 +2646,7 @@ void Burger::RezFile::Kill(Word uRezNum)
 	if (pEntry) {
 		void **ppData = pEntry->m_ppData;
 		if (ppData) {		/* Is there a handle? */
+			CacheRemove(pEntry);
 			pEntry->m_ppData = NULL;		/* Mark as GONE */
 			Word32 uOffset = pEntry->m_uFlags;
 			pEntry->m_uFlags = uOffset&(~ENTRYFLAGSREFCOUNT);	/* No references */
@@ -1969,6 +2678,7 @@ void Burger::RezFile::Kill(const char *pRezName)
 		if (pEntry) {
 			void **ppData = pEntry->m_ppData;
 			if (ppData) {		/* Is there a handle? */
+				CacheRemove(pEntry);
 				pEntry->m_ppData = NULL;		/* Mark as GONE */
 				Word32 uOffset = pEntry->m_uFlags;
 				pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
@@ -1997,6 +2707,9 @@ void Burger::RezFile::Detach(Word uRezNum)
 {
 	RezEntry_t *pEntry = Find(uRezNum);
 	if (pEntry) {		/* Scan for the resource */
+		if (pEntry->m_ppData) {
+			CacheRemove(pEntry);		/* The application owns the memory now */
+		}
 		pEntry->m_ppData = NULL;		/* Mark as GONE */
 		Word32 uOffset = pEntry->m_uFlags;
 		pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
@@ -2024,6 +2737,9 @@ void Burger::RezFile::Detach(const char *pRezName)
 	if (uRezNum!=INVALIDREZNUM) {
 		RezEntry_t *pEntry = Find(uRezNum);
 		if (pEntry) {		/* Scan for the resource */
+			if (pEntry->m_ppData) {
+				CacheRemove(pEntry);		/* The application owns the memory now */
+			}
 			pEntry->m_ppData = NULL;		/* Mark as GONE */
 			Word32 uOffset = pEntry->m_uFlags;
 			pEntry->m_uFlags = uOffset & (~ENTRYFLAGSREFCOUNT);	/* No references */
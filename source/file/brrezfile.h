@@ -30,15 +30,26 @@
 #include "brdecompress.h"
 #endif
 
+#ifndef __BRMD5_H__
+#include "brmd5.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 class RezFile {
 	BURGER_DISABLECOPYCONSTRUCTORS(RezFile);
 public:
 	static const char g_RezFileSignature[4];		///< 'BRGR'
+	static const char g_RezFileSignatureV2[4];		///< 'BRG2'
 	enum {
-		MAXCODECS=3,			///< Maximum number of compression codecs available
-		ROOTHEADERSIZE = static_cast<int>(sizeof(Word32)*2)+(MAXCODECS*4)+4,	///< Size of RootHeader_t on disk
+		MAXCODECS=15,			///< Maximum number of compression codecs available
+		MAXCODECSV1=3,			///< Number of compression codecs in a version 1 rez file
+		ROOTHEADERSIZE = static_cast<int>(sizeof(Word32)*2)+(MAXCODECSV1*4)+4,	///< Size of RootHeader_t on disk
+		ROOTHEADERV2SIZE = static_cast<int>(sizeof(Word32)*10),	///< Size of RootHeaderV2_t on disk
+		FILEREZENTRYV2SIZE = 48,	///< Size of FileRezEntryV2_t on disk
+		// Defines for the bits in FileRezEntryV2_t::m_uFlags on disk
+		REZV2CODECMASK=0x0000000F,	///< Index into the codec table, zero if stored
+		REZV2FIXED=0x00000010,		///< True if load in fixed memory
 		// Defines for the bits in m_uFileOffset on disk
 		ENTRYFLAGSNAMEOFFSETMASK=0x0007FFFF,	///< Filename offset
 		ENTRYFLAGSDECOMPMASK=0x00180000,	///< Mask for decompressors (2 bits)
@@ -54,7 +65,31 @@ public:
 		char m_Name[4];			///< 'BRGR' 
 		Word32 m_uGroupCount;	///< Number of entries
 		Word32 m_uMemSize;		///< Amount of memory the entries take up
-		char m_CodecID[MAXCODECS][4];	///< Compression codecs used
+		char m_CodecID[MAXCODECSV1][4];	///< Compression codecs used
+	};
+
+	struct RootHeaderV2_t {
+		char m_Name[4];			///< 'BRG2'
+		Word32 m_uHeaderSize;	///< Size of this header in bytes
+		Word32 m_uEntryCount;	///< Number of FileRezEntryV2_t entries in the directory
+		Word32 m_uNameCount;	///< Number of entries with names (Size of the name hash slot table)
+		Word32 m_uCodecCount;	///< Number of entries in the codec table
+		Word32 m_uBucketCount;	///< Number of buckets in the name hash
+		Word32 m_uHashSeed;		///< Seed used by HashName() to select the name hash bucket
+		Word32 m_uPageSize;		///< Alignment in bytes of all resource data in the file
+		Word32 m_uTextSize;		///< Size of the name text in bytes
+		Word32 m_uDirectorySize;	///< Size of the directory that follows this header
+	};
+
+	struct FileRezEntryV2_t {
+		Word64 m_uFileOffset;	///< Offset from the start of the rez file to the data
+		Word32 m_uRezNum;		///< Resource number (Entries are sorted by this value)
+		Word32 m_uLength;		///< Size of the data uncompressed
+		Word32 m_uCompressedLength;	///< Size of the data in the rez file
+		Word32 m_uNameOffset;	///< Offset into the name text, zero if there is no name
+		Word32 m_uFlags;		///< REZV2CODECMASK and REZV2FIXED
+		Word32 m_uReserved;		///< Always zero
+		MD5_t m_Hash;			///< MD5 hash of the uncompressed data
 	};
 
 	struct FileRezEntry_t {
@@ -72,7 +107,7 @@ public:
 
 private:
 	enum {
-		MAXBUFFER = 65536,					///< Size of decompression buffer
+		MAXBUFFER = 65536,					///< Size of decompression buffer if the packed data can't be read at once
 		// Flags on for data records in the Rez File
 		REZOFFSETFIXED=0x80000000,			///< True if load in fixed memory
 		REZOFFSETDECOMPMASK=0x60000000,		///< Mask for decompressors
@@ -81,6 +116,9 @@ private:
 		// Defines for the bits in m_uFileOffset on disk
 		ENTRYFLAGSTESTED=0x00000001,		///< True if the filename was checked
 		ENTRYFLAGSFILEFOUND=0x0000002,		///< True if a file was found
+		ENTRYFLAGSHASHVALID=0x0000004,		///< True if m_Hash is valid
+		ENTRYFLAGSCODECMASK=0x00000F00,		///< Index of the decompressor, zero if not compressed
+		ENTRYFLAGSCODECSHIFT=8,				///< Bits to shift for the decompressor index
 		// Used by the rez file parser
 		SWAPENDIAN=0x01,					///< Manually swap endian
 		OLDFORMAT=0x02						///< Parsing an old rez file format
@@ -89,10 +127,13 @@ private:
 	struct RezEntry_t {
 		void **m_ppData;		///< Handle to data in memory
 		const char *m_pRezName;	///< Pointer to the resource name, or \ref NULL if none
-		Word32 m_uFileOffset;	///< Offset into the rez file
+		Word64 m_uFileOffset;	///< Offset into the rez file
 		Word32 m_uLength;		///< Length of the data when decompressed in memory
 		Word32 m_uFlags;		///< Offset to the filename, Flags and Refcount
 		Word32 m_uCompressedLength;	///< Length of the data compressed
+		Word32 m_uPrevious;		///< Resource number of the more recently used entry in the cache list
+		Word32 m_uNext;			///< Resource number of the less recently used entry in the cache list
+		MD5_t m_Hash;			///< Hash of the uncompressed data (Version 2 files only)
 	};
 
 	struct RezGroup_t {
@@ -110,9 +151,21 @@ private:
 	Burger::File m_File;				///< Open file reference
 	Burger::MemoryManagerHandle *m_pMemoryManager;	///< Pointer to the handle based memory manager to use
 	Word32 m_uGroupCount;				///< Number of resource groups
-	Word32 m_uRezNameCount;				///< Number of resource names in m_pRezNames
+	mutable Word32 m_uRezNameCount;		///< Number of resource names in m_pRezNames
 	RezGroup_t *m_pGroups;				///< Array of resource groups
-	FilenameToRezNum_t *m_pRezNames;	///< Pointer to sorted resource names if present
+	mutable FilenameToRezNum_t *m_pRezNames;	///< Pointer to sorted resource names if present
+	Word32 *m_pNameHash;				///< Perfect hash of the names from a version 2 file, bucket seeds followed by resource numbers
+	Word32 m_uNameHashBuckets;			///< Number of buckets in m_pNameHash
+	Word32 m_uNameHashSlots;			///< Number of resource numbers in m_pNameHash
+	Word32 m_uNameHashSeed;				///< Seed for selecting a bucket in m_pNameHash
+	Word32 m_CodecSignatures[MAXCODECS];	///< Codec signatures from a version 2 file, zero for version 1
+	WordPtr m_uCacheBudget;				///< Maximum bytes of resource data to keep in memory, zero for no limit
+	WordPtr m_uCacheUsed;				///< Bytes of resource data in memory
+	Word32 m_uCacheHead;				///< Most recently used unreferenced resource
+	Word32 m_uCacheTail;				///< Least recently used unreferenced resource
+	Word32 m_uCacheHitCount;			///< Number of loads that used data in memory
+	Word32 m_uCacheMissCount;			///< Number of loads that read data
+	Word32 m_uCacheEvictionCount;		///< Number of resources released to stay within m_uCacheBudget
 	Word m_bExternalFileEnabled;		///< \ref TRUE if external file access is enabled
 
 	static int BURGER_ANSIAPI QSortNames(const void *pFirst,const void *pSecond);
@@ -121,7 +174,16 @@ private:
 	RezEntry_t *Find(Word uRezNum) const;
 	Word FindName(const char *pRezName,FilenameToRezNum_t **ppOutput) const;
 	static RezGroup_t * BURGER_API ParseRezFileHeader(const Word8 *pData,const RootHeader_t *pHeader,Word uSwapFlag,Word32 uStartOffset);
-	void ProcessRezNames(void);
+	static RezGroup_t * BURGER_API ParseRezFileHeaderV2(const Word8 *pData,const RootHeaderV2_t *pHeader,Word32 uStartOffset,Word32 *pGroupCount);
+	Word InitV2(Word32 uStartOffset);
+	Word FindNameHash(const char *pRezName) const;
+	void ReleaseNameHash(void);
+	Decompress *GetDecompressor(Word uCodec) const;
+	void CacheLink(Word uRezNum,RezEntry_t *pEntry);
+	void CacheUnlink(RezEntry_t *pEntry);
+	void CacheRemove(RezEntry_t *pEntry);
+	void CacheTrim(void);
+	void ProcessRezNames(void) const;
 	void FixupFilenames(char *pText);
 public:
 	RezFile(Burger::MemoryManagerHandle *pMemoryManager);
@@ -130,6 +192,13 @@ public:
 	Word Init(const char *pFileName,Word32 uStartOffset=0);
 	void Shutdown(void);
 	void PurgeCache(void);
+	void SetCacheBudget(WordPtr uBudget);
+	BURGER_INLINE WordPtr GetCacheBudget(void) const { return m_uCacheBudget; }
+	BURGER_INLINE WordPtr GetCacheUsed(void) const { return m_uCacheUsed; }
+	BURGER_INLINE Word32 GetCacheHitCount(void) const { return m_uCacheHitCount; }
+	BURGER_INLINE Word32 GetCacheMissCount(void) const { return m_uCacheMissCount; }
+	BURGER_INLINE Word32 GetCacheEvictionCount(void) const { return m_uCacheEvictionCount; }
+	BURGER_INLINE void ResetCacheCounters(void) { m_uCacheHitCount = 0; m_uCacheMissCount = 0; m_uCacheEvictionCount = 0; }
 	Word SetExternalFlag(Word bEnable);
 	Word BURGER_INLINE GetExternalFlag(void) const { return m_bExternalFileEnabled; }
 	void LogDecompressor(Word uCompressID,Burger::Decompress *pProc);
@@ -138,8 +207,10 @@ public:
 	Word AddName(const char *pRezName);
 	void Remove(Word uRezNum);
 	void Remove(const char *pRezName);
-	BURGER_INLINE const FilenameToRezNum_t * GetNameArray(void) const { return m_pRezNames; }
-	BURGER_INLINE Word GetNameArraySize(void) const { return m_uRezNameCount; }
+	const FilenameToRezNum_t * GetNameArray(void) const;
+	Word GetNameArraySize(void) const;
+	Word GetHash(Word uRezNum,MD5_t *pOutput) const;
+	static Word32 BURGER_API HashName(const char *pRezName,Word32 uSeed);
 	Word GetLowestRezNum(void) const;
 	Word GetHighestRezNum(void) const;
 	Word GetIDFromHandle(const void **ppRez,Word *pRezNum,char *pBuffer,WordPtr uBufferSize) const;
@@ -0,0 +1,1104 @@
+/***************************************
+
+	Rez file archive builder
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brrezfilebuilder.h"
+#include "brfile.h"
+#include "broutputmemorystream.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include <stdlib.h>
+
+/*! ************************************
+
+	\class Burger::RezFileBuilder
+	\brief Create version 2 rez files
+
+	Resources are added from memory or from files with a resource
+	number and an optional name. When the rez file is saved, the
+	files are loaded and all the resources are compressed with
+	multiple threads.
+
+	Each resource is compressed with every codec added with AddCodec()
+	and the smallest result is kept if it's no larger than
+	GetRatio() percent of the original size, otherwise
+	the resource is stored without compression. Resources with
+	identical data are only compressed and written once.
+
+	The output only depends on the resources and the settings,
+	not on the number of threads or the order they finished,
+	so the same input always creates the same rez file.
+
+	\code
+	static Burger::Compress * BURGER_API NewLZSS(void)
+	{
+		return Burger::New<Burger::CompressLZSS>();
+	}
+
+	Burger::RezFileBuilder Builder;
+	Builder.AddCodec(NewLZSS);
+	Builder.AddFile(1,"title.png","9:art:title.png");
+	Builder.AddBuffer(2,"level1.dat",pLevel,uLevelSize);
+	Builder.Save("9:game.rez");
+	\endcode
+
+	\sa Burger::RezFile
+
+***************************************/
+
+/*! ************************************
+
+	\typedef Burger::RezFileBuilder::CompressProc
+	\brief Function to create a compressor
+
+	Each thread creates its own compressors, so a new instance
+	must be returned on every call. The compressor is released
+	with Burger::Delete().
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::RezFileBuilder::Entry_t
+	\brief Description of a resource to write
+
+***************************************/
+
+/*! ************************************
+
+	\brief Initialize the builder
+
+	There are no codecs, so until one is added, all
+	resources are stored without compression.
+
+***************************************/
+
+Burger::RezFileBuilder::RezFileBuilder() :
+	m_pEntries(NULL),
+	m_uEntryCount(0),
+	m_uEntryMax(0),
+	m_uCodecCount(0),
+	m_uPageSize(DEFAULTPAGESIZE),
+	m_uRatio(DEFAULTRATIO),
+	m_uMaxThreads(0),
+	m_uPhase(PHASE_LOAD),
+	m_uNextEntry(0),
+	m_uDuplicateCount(0),
+	m_uError(File::OKAY)
+{
+	Word i = 0;
+	do {
+		m_Codecs[i] = NULL;
+		m_CodecSignatures[i] = 0;
+	} while (++i<RezFile::MAXCODECS);
+}
+
+/*! ************************************
+
+	\brief Release all resources
+
+	\sa Clear(void)
+
+***************************************/
+
+Burger::RezFileBuilder::~RezFileBuilder()
+{
+	Clear();
+}
+
+/*! ************************************
+
+	\brief Remove all the resources
+
+	The codecs and settings are retained.
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::Clear(void)
+{
+	Word uCount = m_uEntryCount;
+	if (uCount) {
+		Entry_t *pEntry = m_pEntries;
+		do {
+			StringDelete(pEntry->m_pRezName);
+			StringDelete(pEntry->m_pFileName);
+			Free(pEntry->m_pData);
+			Free(pEntry->m_pPayload);
+			++pEntry;
+		} while (--uCount);
+	}
+	Free(m_pEntries);
+	m_pEntries = NULL;
+	m_uEntryCount = 0;
+	m_uEntryMax = 0;
+	m_uDuplicateCount = 0;
+}
+
+/*! ************************************
+
+	\brief Add a compression codec
+
+	The order codecs are added determines their index in the
+	rez file, so to create identical rez files, add them
+	in the same order. The compressor's signature is stored
+	in the rez file so RezFile can find the matching
+	decompressor.
+
+	\param pProc Function that creates a new compressor
+	\return File::OKAY if successful, File::OUTOFRANGE if there are too many codecs or the codec couldn't be created
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::AddCodec(CompressProc pProc)
+{
+	Word uCount = m_uCodecCount;
+	if (pProc && (uCount<RezFile::MAXCODECS)) {
+		// Create one to get the signature
+		Compress *pCompress = pProc();
+		if (pCompress) {
+			m_CodecSignatures[uCount] = pCompress->GetSignature();
+			Delete(pCompress);
+			m_Codecs[uCount] = pProc;
+			m_uCodecCount = uCount+1;
+			return File::OKAY;
+		}
+	}
+	return File::OUTOFRANGE;
+}
+
+/*! ************************************
+
+	\brief Add a resource from memory
+
+	The data is copied, so the buffer can be released
+	after this call.
+
+	\param uRezNum Resource number, RezFile::INVALIDREZNUM to assign one when saved
+	\param pRezName Pointer to a "C" string of the resource name or \ref NULL for none
+	\param pInput Pointer to the data
+	\param uLength Size of the data in bytes
+	\param uFlags \ref FLAG_FIXED and/or \ref FLAG_STORE
+	\return File::OKAY if successful, File::OUTOFRANGE if out of memory or the data is too large
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::AddBuffer(Word uRezNum,const char *pRezName,const void *pInput,WordPtr uLength,Word uFlags)
+{
+	// Lengths are stored as 32 bits
+	if (uLength>0xFFFFFFFFU) {
+		return File::OUTOFRANGE;
+	}
+	Word8 *pData = NULL;
+	if (uLength) {
+		pData = static_cast<Word8 *>(AllocCopy(pInput,uLength));
+		if (!pData) {
+			return File::OUTOFRANGE;
+		}
+	}
+	Entry_t *pEntry = NewEntry(uRezNum,pRezName,uFlags);
+	if (!pEntry) {
+		Free(pData);
+		return File::OUTOFRANGE;
+	}
+	pEntry->m_pData = pData;
+	pEntry->m_uLength = uLength;
+	return File::OKAY;
+}
+
+/*! ************************************
+
+	\brief Add a resource from a file
+
+	The file is not loaded until Save() is called.
+
+	\param uRezNum Resource number, RezFile::INVALIDREZNUM to assign one when saved
+	\param pRezName Pointer to a "C" string of the resource name or \ref NULL for none
+	\param pFileName Pointer to a "C" string of the file to load in BurgerLib format
+	\param uFlags \ref FLAG_FIXED and/or \ref FLAG_STORE
+	\return File::OKAY if successful, File::OUTOFRANGE if out of memory
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::AddFile(Word uRezNum,const char *pRezName,const char *pFileName,Word uFlags)
+{
+	char *pCopy = StringDuplicate(pFileName);
+	if (!pCopy) {
+		return File::OUTOFRANGE;
+	}
+	Entry_t *pEntry = NewEntry(uRezNum,pRezName,uFlags);
+	if (!pEntry) {
+		StringDelete(pCopy);
+		return File::OUTOFRANGE;
+	}
+	pEntry->m_pFileName = pCopy;
+	return File::OKAY;
+}
+
+/*! ************************************
+
+	\brief Create a rez file
+
+	Load all the files, compress the data and write
+	the rez file. Resource numbers and names must be unique,
+	names are compared without case sensitivity.
+
+	\param pFileName Pointer to a "C" string of the rez file to create in BurgerLib format
+	\return File::OKAY if successful, File::FILENOTFOUND if a resource file couldn't be loaded,
+		File::OUTOFRANGE if there are duplicate numbers or names or out of memory,
+		File::IOERROR if the rez file couldn't be written
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::Save(const char *pFileName)
+{
+	m_uDuplicateCount = 0;
+	m_uError = File::OKAY;
+	Word uCount = m_uEntryCount;
+	Entry_t **ppSorted = NULL;
+	if (uCount) {
+		ppSorted = static_cast<Entry_t **>(Alloc(uCount*sizeof(Entry_t *)));
+		if (!ppSorted) {
+			return File::OUTOFRANGE;
+		}
+	}
+	Word uResult = SortEntries(ppSorted);
+	if (!uResult && uCount) {
+		// Load and hash the data, then find duplicates
+		// so they won't be compressed
+		RunThreads(PHASE_LOAD);
+		Entry_t *pEntry = m_pEntries;
+		do {
+			if (pEntry->m_uError) {
+				uResult = pEntry->m_uError;
+				break;
+			}
+			++pEntry;
+		} while (--uCount);
+		if (!uResult) {
+			FindDuplicates(ppSorted);
+			RunThreads(PHASE_COMPRESS);
+			uResult = m_uError;
+		}
+	}
+	Free(ppSorted);
+	if (!uResult) {
+		File Output;
+		uResult = Output.Open(pFileName,File::WRITEONLY);
+		if (!uResult) {
+			uResult = WriteFile(&Output);
+			if (Output.Close() && !uResult) {
+				uResult = File::IOERROR;
+			}
+		}
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Set the alignment of resource data in the file
+
+	Aligning the data to the page size of the storage
+	device allows direct or memory mapped reads.
+
+	\param uPageSize Power of two from 1 to \ref MAXPAGESIZE, invalid values are ignored
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::SetPageSize(Word uPageSize)
+{
+	if (uPageSize && (uPageSize<=MAXPAGESIZE) && !(uPageSize&(uPageSize-1))) {
+		m_uPageSize = uPageSize;
+	}
+}
+
+/*! ************************************
+
+	\fn Word Burger::RezFileBuilder::GetPageSize(void) const
+	\brief Return the alignment of resource data in the file
+
+	\return Alignment in bytes
+	\sa SetPageSize(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::RezFileBuilder::SetRatio(Word uPercent)
+	\brief Set the compression threshold
+
+	Compressed data is only used if it's no larger than
+	this percentage of the original size. Zero
+	disables compression.
+
+	\param uPercent Percentage from 0 to 100
+	\sa GetRatio(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFileBuilder::GetRatio(void) const
+	\brief Return the compression threshold
+
+	\return Percentage from 0 to 100
+	\sa SetRatio(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::RezFileBuilder::SetMaxThreads(Word uMaxThreads)
+	\brief Set the number of threads to use
+
+	\param uMaxThreads Maximum number of threads, zero for Thread::GetProcessorCount()
+	\sa GetMaxThreads(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFileBuilder::GetMaxThreads(void) const
+	\brief Return the number of threads to use
+
+	\return Maximum number of threads, zero for Thread::GetProcessorCount()
+	\sa SetMaxThreads(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFileBuilder::GetEntryCount(void) const
+	\brief Return the number of resources added
+
+	\return Number of resources
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::RezFileBuilder::GetDuplicateCount(void) const
+	\brief Return the number of duplicates found by the last call to Save()
+
+	\return Number of resources that share their data with another resource
+
+***************************************/
+
+/*! ************************************
+
+	\brief Sort resources by resource number
+	\param pFirst Pointer to the first Entry_t
+	\param pSecond Pointer to the second Entry_t
+	\return Negative, zero or positive for qsort()
+
+***************************************/
+
+int BURGER_ANSIAPI Burger::RezFileBuilder::QSortRezNums(const void *pFirst,const void *pSecond)
+{
+	Word uFirst = static_cast<const Entry_t *>(pFirst)->m_uRezNum;
+	Word uSecond = static_cast<const Entry_t *>(pSecond)->m_uRezNum;
+	if (uFirst<uSecond) {
+		return -1;
+	}
+	return (uFirst>uSecond) ? 1 : 0;
+}
+
+/*! ************************************
+
+	\brief Sort resources by name
+	\param pFirst Pointer to the first Entry_t pointer
+	\param pSecond Pointer to the second Entry_t pointer
+	\return Result of StringCaseCompare(const char *,const char *)
+
+***************************************/
+
+int BURGER_ANSIAPI Burger::RezFileBuilder::QSortNames(const void *pFirst,const void *pSecond)
+{
+	return StringCaseCompare(static_cast<Entry_t * const *>(pFirst)[0]->m_pRezName,
+		static_cast<Entry_t * const *>(pSecond)[0]->m_pRezName);
+}
+
+/*! ************************************
+
+	\brief Sort resources by hash
+
+	Resources with the same hash are sorted by
+	resource number so the first of any duplicates is the
+	one with the lowest resource number.
+
+	\param pFirst Pointer to the first Entry_t pointer
+	\param pSecond Pointer to the second Entry_t pointer
+	\return Negative, zero or positive for qsort()
+
+***************************************/
+
+int BURGER_ANSIAPI Burger::RezFileBuilder::QSortHashes(const void *pFirst,const void *pSecond)
+{
+	const Entry_t *pEntry1 = static_cast<Entry_t * const *>(pFirst)[0];
+	const Entry_t *pEntry2 = static_cast<Entry_t * const *>(pSecond)[0];
+	int iResult = MemoryCompare(&pEntry1->m_Hash,&pEntry2->m_Hash,sizeof(MD5_t));
+	if (!iResult) {
+		iResult = (pEntry1->m_uRezNum<pEntry2->m_uRezNum) ? -1 : 1;
+	}
+	return iResult;
+}
+
+/*! ************************************
+
+	\brief Add an empty entry
+
+	\param uRezNum Resource number
+	\param pRezName Pointer to a "C" string of the resource name or \ref NULL
+	\param uFlags Flags for the entry
+	\return Pointer to the new entry or \ref NULL if out of memory
+
+***************************************/
+
+Burger::RezFileBuilder::Entry_t * BURGER_API Burger::RezFileBuilder::NewEntry(Word uRezNum,const char *pRezName,Word uFlags)
+{
+	char *pName = NULL;
+	if (pRezName && pRezName[0]) {
+		pName = StringDuplicate(pRezName);
+		if (!pName) {
+			return NULL;
+		}
+	}
+	Word uCount = m_uEntryCount;
+	Entry_t *pEntries = m_pEntries;
+	if (uCount>=m_uEntryMax) {
+		Word uNewMax = (m_uEntryMax*2)+64;
+		pEntries = static_cast<Entry_t *>(Realloc(pEntries,uNewMax*sizeof(Entry_t)));
+		if (!pEntries) {
+			StringDelete(pName);
+			return NULL;
+		}
+		m_pEntries = pEntries;
+		m_uEntryMax = uNewMax;
+	}
+	Entry_t *pEntry = &pEntries[uCount];
+	MemoryClear(pEntry,sizeof(Entry_t));
+	pEntry->m_pRezName = pName;
+	pEntry->m_uRezNum = uRezNum;
+	pEntry->m_uFlags = uFlags;
+	m_uEntryCount = uCount+1;
+	return pEntry;
+}
+
+/*! ************************************
+
+	\brief Perform the work for a phase with multiple threads
+
+	The calling thread and up to GetMaxThreads()-1 worker
+	threads process the entries and this function returns
+	once all of them are done.
+
+	\param uPhase \ref PHASE_LOAD or \ref PHASE_COMPRESS
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::RunThreads(Word uPhase)
+{
+	m_uPhase = uPhase;
+	m_uNextEntry = 0;
+	Word uMaxThreads = m_uMaxThreads;
+	if (!uMaxThreads) {
+		uMaxThreads = Thread::GetProcessorCount();
+	}
+	if (uMaxThreads>MAXTHREADS) {
+		uMaxThreads = MAXTHREADS;
+	}
+	// No point in having more threads than entries
+	if (uMaxThreads>m_uEntryCount) {
+		uMaxThreads = m_uEntryCount ? m_uEntryCount : 1;
+	}
+	ParallelRun(WorkerThread,this,uMaxThreads);
+}
+
+/*! ************************************
+
+	\brief Entry point for the worker threads
+
+	This is called on the thread that called RunThreads()
+	as well.
+
+	\param pThis Pointer to the RezFileBuilder
+	\return Zero
+
+***************************************/
+
+WordPtr BURGER_API Burger::RezFileBuilder::WorkerThread(void *pThis)
+{
+	static_cast<RezFileBuilder *>(pThis)->WorkAll();
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Process entries until they are all done
+
+	Each thread creates its own compressors since they
+	can't be shared. If one can't be created, the save
+	fails instead of choosing a different codec, so the
+	output doesn't depend on which thread processed
+	which entry.
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::WorkAll(void)
+{
+	Compress *Compressors[RezFile::MAXCODECS];
+	Word uCodecCount = 0;
+	if (m_uPhase==PHASE_COMPRESS) {
+		uCodecCount = m_uCodecCount;
+		Word i = 0;
+		while (i<uCodecCount) {
+			Compress *pCompress = m_Codecs[i]();
+			Compressors[i] = pCompress;
+			if (!pCompress) {
+				m_Lock.Lock();
+				m_uError = File::OUTOFRANGE;
+				m_Lock.Unlock();
+			}
+			++i;
+		}
+	}
+
+	for (;;) {
+		m_Lock.Lock();
+		Word uIndex = m_uNextEntry;
+		if (uIndex<m_uEntryCount) {
+			m_uNextEntry = uIndex+1;
+		}
+		Word uError = m_uError;
+		m_Lock.Unlock();
+		if ((uIndex>=m_uEntryCount) || uError) {
+			break;
+		}
+		if (m_uPhase==PHASE_LOAD) {
+			LoadEntry(&m_pEntries[uIndex]);
+		} else {
+			CompressEntry(&m_pEntries[uIndex],Compressors);
+		}
+	}
+
+	Word i = 0;
+	while (i<uCodecCount) {
+		Delete(Compressors[i]);
+		++i;
+	}
+}
+
+/*! ************************************
+
+	\brief Load the data for an entry and hash it
+
+	\param pEntry Pointer to the entry to process
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::LoadEntry(Entry_t *pEntry)
+{
+	// Load the file if it wasn't loaded by a previous save
+	if (pEntry->m_pFileName && !pEntry->m_pData) {
+		File Input;
+		if (Input.Open(pEntry->m_pFileName,File::READONLY)) {
+			pEntry->m_uError = File::FILENOTFOUND;
+			return;
+		}
+		WordPtr uLength = Input.GetSize();
+		if (uLength>0xFFFFFFFFU) {
+			pEntry->m_uError = File::OUTOFRANGE;
+			return;
+		}
+		if (uLength) {
+			Word8 *pData = static_cast<Word8 *>(Alloc(uLength));
+			if (!pData) {
+				pEntry->m_uError = File::OUTOFRANGE;
+				return;
+			}
+			if (Input.Read(pData,uLength)!=uLength) {
+				Free(pData);
+				pEntry->m_uError = File::IOERROR;
+				return;
+			}
+			pEntry->m_pData = pData;
+		}
+		pEntry->m_uLength = uLength;
+	}
+	Hash(&pEntry->m_Hash,pEntry->m_pData,pEntry->m_uLength);
+}
+
+/*! ************************************
+
+	\brief Compress the data for an entry
+
+	Try every codec and keep the smallest result. Ties
+	go to the codec added first.
+
+	\param pEntry Pointer to the entry to process
+	\param ppCompressors Pointer to this thread's compressors
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::CompressEntry(Entry_t *pEntry,Compress **ppCompressors)
+{
+	// Discard the result of a previous save
+	Free(pEntry->m_pPayload);
+	pEntry->m_pPayload = NULL;
+	pEntry->m_uCodec = 0;
+	WordPtr uLength = pEntry->m_uLength;
+	pEntry->m_uPayloadLength = uLength;
+
+	// Duplicates use the data from the original
+	if ((&m_pEntries[pEntry->m_uDuplicate]!=pEntry) || (pEntry->m_uFlags&FLAG_STORE) || !uLength) {
+		return;
+	}
+
+	// The data must fit in this many bytes to be worth compressing
+	WordPtr uLimit = static_cast<WordPtr>((static_cast<Word64>(uLength)*m_uRatio)/100U);
+	WordPtr uBest = uLimit+1;
+	Word8 *pBest = NULL;
+	Word uBestCodec = 0;
+	Word uCodecCount = m_uCodecCount;
+	Word i = 0;
+	while (i<uCodecCount) {
+		Compress *pCompress = ppCompressors[i];
+		++i;
+		if (pCompress->Init() ||
+			pCompress->Process(pEntry->m_pData,uLength) ||
+			pCompress->Finalize()) {
+			continue;
+		}
+		WordPtr uSize = pCompress->GetOutputSize();
+		if (uSize<uBest) {
+			WordPtr uFlattened;
+			Word8 *pData = static_cast<Word8 *>(pCompress->GetOutput()->Flatten(&uFlattened));
+			if (pData) {
+				Free(pBest);
+				pBest = pData;
+				uBest = uSize;
+				uBestCodec = i;
+			}
+		}
+	}
+	if (pBest) {
+		pEntry->m_pPayload = pBest;
+		pEntry->m_uPayloadLength = uBest;
+		pEntry->m_uCodec = uBestCodec;
+	}
+}
+
+/*! ************************************
+
+	\brief Sort the entries and check for duplicate numbers and names
+
+	Entries without a resource number are given numbers
+	following the highest resource number in the order they
+	were added.
+
+	\param ppSorted Scratch buffer with room for an Entry_t pointer for each entry
+	\return File::OKAY or File::OUTOFRANGE if a resource number or name is used twice
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::SortEntries(Entry_t **ppSorted)
+{
+	Word uCount = m_uEntryCount;
+	if (!uCount) {
+		return File::OKAY;
+	}
+	// Assign the missing resource numbers
+	Entry_t *pEntries = m_pEntries;
+	Word uNext = 0;
+	Word i = 0;
+	do {
+		Word uRezNum = pEntries[i].m_uRezNum;
+		if ((uRezNum!=RezFile::INVALIDREZNUM) && (uRezNum>=uNext)) {
+			uNext = uRezNum+1;
+		}
+	} while (++i<uCount);
+	i = 0;
+	do {
+		if (pEntries[i].m_uRezNum==RezFile::INVALIDREZNUM) {
+			// Out of numbers?
+			if (uNext==RezFile::INVALIDREZNUM) {
+				return File::OUTOFRANGE;
+			}
+			pEntries[i].m_uRezNum = uNext;
+			++uNext;
+		}
+	} while (++i<uCount);
+
+	qsort(pEntries,uCount,sizeof(Entry_t),QSortRezNums);
+
+	// Check for duplicate numbers and gather the names
+	Word uNameCount = 0;
+	i = 0;
+	do {
+		if (i && (pEntries[i].m_uRezNum==pEntries[i-1].m_uRezNum)) {
+			return File::OUTOFRANGE;
+		}
+		if (pEntries[i].m_pRezName) {
+			ppSorted[uNameCount] = &pEntries[i];
+			++uNameCount;
+		}
+		pEntries[i].m_uDuplicate = i;
+		pEntries[i].m_uError = File::OKAY;
+	} while (++i<uCount);
+
+	// Names must be unique so the name hash can only find one resource
+	if (uNameCount>1) {
+		qsort(ppSorted,uNameCount,sizeof(Entry_t *),QSortNames);
+		i = 1;
+		do {
+			if (!StringCaseCompare(ppSorted[i-1]->m_pRezName,ppSorted[i]->m_pRezName)) {
+				return File::OUTOFRANGE;
+			}
+		} while (++i<uNameCount);
+	}
+	return File::OKAY;
+}
+
+/*! ************************************
+
+	\brief Find entries with identical data
+
+	Entries are sorted by hash and the data of entries with the
+	same hash is compared, in case of a collision. Each duplicate
+	refers to the entry with the lowest resource number.
+
+	\param ppSorted Scratch buffer with room for an Entry_t pointer for each entry
+
+***************************************/
+
+void BURGER_API Burger::RezFileBuilder::FindDuplicates(Entry_t **ppSorted)
+{
+	Word uCount = m_uEntryCount;
+	Entry_t *pEntries = m_pEntries;
+	Word i = 0;
+	do {
+		ppSorted[i] = &pEntries[i];
+	} while (++i<uCount);
+	qsort(ppSorted,uCount,sizeof(Entry_t *),QSortHashes);
+
+	Word uDuplicates = 0;
+	i = 1;
+	while (i<uCount) {
+		Entry_t *pFirst = ppSorted[i-1];
+		Entry_t *pEntry = ppSorted[i];
+		// Point to the original of the previous entry
+		Entry_t *pOriginal = &pEntries[pFirst->m_uDuplicate];
+		if (!MemoryCompare(&pOriginal->m_Hash,&pEntry->m_Hash,sizeof(MD5_t)) &&
+			(pOriginal->m_uLength==pEntry->m_uLength) &&
+			((pOriginal->m_uFlags&FLAG_STORE)==(pEntry->m_uFlags&FLAG_STORE)) &&
+			!MemoryCompare(pOriginal->m_pData,pEntry->m_pData,pEntry->m_uLength)) {
+			pEntry->m_uDuplicate = pFirst->m_uDuplicate;
+			++uDuplicates;
+		}
+		++i;
+	}
+	m_uDuplicateCount = uDuplicates;
+}
+
+/*! ************************************
+
+	\brief Create the minimal perfect hash of the names
+
+	Names are placed in buckets with RezFile::HashName() using uSeed.
+	Starting with the largest buckets, a seed is found for
+	each bucket that maps all its names to unused slots
+	with RezFile::HashName().
+
+	\param pOutput Pointer to the bucket seeds followed by the slots
+	\param pScratch Pointer to a buffer of (uBucketCount+1)+(uNameCount*2) \ref Word entries followed by uNameCount bytes
+	\param uNameCount Number of names
+	\param uBucketCount Number of buckets
+	\param uSeed Seed for selecting the buckets
+	\return \ref FALSE if successful, \ref TRUE if a bucket couldn't be placed with this seed
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::CreateNameHash(Word32 *pOutput,Word *pScratch,Word uNameCount,Word uBucketCount,Word32 uSeed) const
+{
+	Word *pStarts = pScratch;
+	Word *pMembers = pStarts+uBucketCount+1;
+	Word *pSlots = pMembers+uNameCount;
+	Word8 *pUsed = reinterpret_cast<Word8 *>(pSlots+uNameCount);
+	Word32 *pRezNums = pOutput+uBucketCount;
+	const Entry_t *pEntries = m_pEntries;
+	Word uCount = m_uEntryCount;
+
+	// Sort the names into buckets
+	MemoryClear(pStarts,(uBucketCount+1)*sizeof(Word));
+	Word i = 0;
+	do {
+		if (pEntries[i].m_pRezName) {
+			++pStarts[(RezFile::HashName(pEntries[i].m_pRezName,uSeed)%uBucketCount)+1];
+		}
+	} while (++i<uCount);
+	Word uMaxSize = 0;
+	i = 0;
+	do {
+		Word uSize = pStarts[i+1];
+		if (uSize>uMaxSize) {
+			uMaxSize = uSize;
+		}
+		pStarts[i+1] = uSize+pStarts[i];
+	} while (++i<uBucketCount);
+	MemoryCopy(pSlots,pStarts,uBucketCount*sizeof(Word));
+	i = 0;
+	do {
+		if (pEntries[i].m_pRezName) {
+			Word uBucket = RezFile::HashName(pEntries[i].m_pRezName,uSeed)%uBucketCount;
+			pMembers[pSlots[uBucket]] = i;
+			++pSlots[uBucket];
+		}
+	} while (++i<uCount);
+
+	// Place the largest buckets first while there are plenty of free slots
+	MemoryClear(pUsed,uNameCount);
+	MemoryClear(pOutput,uBucketCount*sizeof(Word32));
+	Word32 uLimit = static_cast<Word32>(uNameCount*16)+65536U;
+	Word uSize = uMaxSize;
+	do {
+		Word uBucket = 0;
+		do {
+			const Word *pBucket = &pMembers[pStarts[uBucket]];
+			if ((pStarts[uBucket+1]-pStarts[uBucket])!=uSize) {
+				continue;
+			}
+			Word32 uBucketSeed = 0;
+			Word uPlaced;
+			do {
+				if (++uBucketSeed>uLimit) {
+					return TRUE;
+				}
+				uPlaced = 0;
+				do {
+					Word uSlot = RezFile::HashName(pEntries[pBucket[uPlaced]].m_pRezName,uBucketSeed)%uNameCount;
+					if (pUsed[uSlot]) {
+						break;
+					}
+					// Names in the same bucket can't share a slot
+					Word j = 0;
+					while (j<uPlaced) {
+						if (pSlots[j]==uSlot) {
+							break;
+						}
+						++j;
+					}
+					if (j<uPlaced) {
+						break;
+					}
+					pSlots[uPlaced] = uSlot;
+				} while (++uPlaced<uSize);
+			} while (uPlaced<uSize);
+			pOutput[uBucket] = uBucketSeed;
+			uPlaced = 0;
+			do {
+				Word uSlot = pSlots[uPlaced];
+				pUsed[uSlot] = TRUE;
+				pRezNums[uSlot] = pEntries[pBucket[uPlaced]].m_uRezNum;
+			} while (++uPlaced<uSize);
+		} while (++uBucket<uBucketCount);
+	} while (--uSize);
+	return FALSE;
+}
+
+/*! ************************************
+
+	\brief Write the rez file
+
+	The header and directory are created in memory and
+	then written with the resource data in a single vectored
+	write. Duplicates share the data of their original.
+
+	\param pFile Pointer to an open file
+	\return File::OKAY if successful, File::OUTOFRANGE if out of memory, File::IOERROR on a write error
+
+***************************************/
+
+Word BURGER_API Burger::RezFileBuilder::WriteFile(File *pFile)
+{
+	Word uCount = m_uEntryCount;
+	Entry_t *pEntries = m_pEntries;
+
+	// Get the size of the names
+	Word uNameCount = 0;
+	WordPtr uTextSize = 0;
+	Word uUniqueCount = 0;
+	Word i = 0;
+	while (i<uCount) {
+		if (pEntries[i].m_pRezName) {
+			++uNameCount;
+			uTextSize += StringLength(pEntries[i].m_pRezName)+1;
+		}
+		if (pEntries[i].m_uDuplicate==i) {
+			++uUniqueCount;
+		}
+		++i;
+	}
+	// The text starts with a zero so no name has an offset of zero
+	if (uTextSize) {
+		++uTextSize;
+	}
+	Word uBucketCount = (uNameCount+(BUCKETSIZE-1))/BUCKETSIZE;
+	WordPtr uDirectorySize = (m_uCodecCount*4)+(uCount*RezFile::FILEREZENTRYV2SIZE)+
+		((uBucketCount+uNameCount)*sizeof(Word32))+uTextSize;
+	if ((uDirectorySize+RezFile::ROOTHEADERV2SIZE)>0x7FFFFFFFU) {
+		return File::OUTOFRANGE;
+	}
+
+	// Lay out the data
+	Word64 uPageMask = m_uPageSize-1;
+	Word64 uMark = (RezFile::ROOTHEADERV2SIZE+uDirectorySize+uPageMask)&(~uPageMask);
+	i = 0;
+	while (i<uCount) {
+		Entry_t *pEntry = &pEntries[i];
+		if (pEntry->m_uDuplicate==i) {
+			pEntry->m_uFileOffset = uMark;
+			uMark = (uMark+pEntry->m_uPayloadLength+uPageMask)&(~uPageMask);
+		} else {
+			// The original has a lower number, so it's already placed
+			pEntry->m_uFileOffset = pEntries[pEntry->m_uDuplicate].m_uFileOffset;
+		}
+		++i;
+	}
+
+	// Create the name hash, trying other seeds if needed
+	Word32 *pNameHash = NULL;
+	Word32 uSeed = 0;
+	if (uNameCount) {
+		pNameHash = static_cast<Word32 *>(Alloc((uBucketCount+uNameCount)*sizeof(Word32)));
+		Word *pScratch = static_cast<Word *>(Alloc(((uBucketCount+1+(uNameCount*2))*sizeof(Word))+uNameCount));
+		Word uFailed = TRUE;
+		if (pNameHash && pScratch) {
+			do {
+				uFailed = CreateNameHash(pNameHash,pScratch,uNameCount,uBucketCount,uSeed);
+			} while (uFailed && (++uSeed<256));
+		}
+		Free(pScratch);
+		if (uFailed) {
+			Free(pNameHash);
+			return File::OUTOFRANGE;
+		}
+	}
+
+	// Create the header and directory
+	OutputMemoryStream Directory;
+	Word uError = Directory.Append(RezFile::g_RezFileSignatureV2,4);
+	uError |= Directory.Append(static_cast<Word32>(RezFile::ROOTHEADERV2SIZE));
+	uError |= Directory.Append(static_cast<Word32>(uCount));
+	uError |= Directory.Append(static_cast<Word32>(uNameCount));
+	uError |= Directory.Append(static_cast<Word32>(m_uCodecCount));
+	uError |= Directory.Append(static_cast<Word32>(uBucketCount));
+	uError |= Directory.Append(uSeed);
+	uError |= Directory.Append(static_cast<Word32>(m_uPageSize));
+	uError |= Directory.Append(static_cast<Word32>(uTextSize));
+	uError |= Directory.Append(static_cast<Word32>(uDirectorySize));
+	i = 0;
+	while (i<m_uCodecCount) {
+		// Signatures are 4 characters in memory order
+		uError |= Directory.Append(&m_CodecSignatures[i],4);
+		++i;
+	}
+	WordPtr uNameOffset = 1;
+	i = 0;
+	while (i<uCount) {
+		const Entry_t *pEntry = &pEntries[i];
+		uError |= Directory.Append(pEntry->m_uFileOffset);
+		uError |= Directory.Append(static_cast<Word32>(pEntry->m_uRezNum));
+		uError |= Directory.Append(static_cast<Word32>(pEntry->m_uLength));
+		// Duplicates share the compressed data
+		const Entry_t *pOriginal = &pEntries[pEntry->m_uDuplicate];
+		uError |= Directory.Append(static_cast<Word32>(pOriginal->m_uPayloadLength));
+		Word32 uOffset = 0;
+		if (pEntry->m_pRezName) {
+			uOffset = static_cast<Word32>(uNameOffset);
+			uNameOffset += StringLength(pEntry->m_pRezName)+1;
+		}
+		uError |= Directory.Append(uOffset);
+		Word32 uFlags = static_cast<Word32>(pOriginal->m_uCodec);
+		if (pEntry->m_uFlags&FLAG_FIXED) {
+			uFlags |= RezFile::REZV2FIXED;
+		}
+		uError |= Directory.Append(uFlags);
+		uError |= Directory.Append(static_cast<Word32>(0));
+		uError |= Directory.Append(&pEntry->m_Hash,sizeof(MD5_t));
+		++i;
+	}
+	i = 0;
+	while (i<(uBucketCount+uNameCount)) {
+		uError |= Directory.Append(pNameHash[i]);
+		++i;
+	}
+	Free(pNameHash);
+	if (uTextSize) {
+		uError |= Directory.Append(static_cast<Word8>(0));
+		i = 0;
+		while (i<uCount) {
+			const char *pName = pEntries[i].m_pRezName;
+			if (pName) {
+				uError |= Directory.Append(pName,StringLength(pName)+1);
+			}
+			++i;
+		}
+	}
+	if (uError) {
+		return File::OUTOFRANGE;
+	}
+
+	// Write everything with one call, padding each block to a page
+	WordPtr uDirectoryLength;
+	void *pDirectory = Directory.Flatten(&uDirectoryLength);
+	Word8 *pPadding = static_cast<Word8 *>(AllocClear(m_uPageSize));
+	File::IOVector_t *pVectors = static_cast<File::IOVector_t *>(Alloc((uUniqueCount+1)*2*sizeof(File::IOVector_t)));
+	uError = File::OUTOFRANGE;
+	if (pDirectory && pPadding && pVectors) {
+		File::IOVector_t *pVector = pVectors;
+		pVector->m_pBuffer = pDirectory;
+		pVector->m_uLength = uDirectoryLength;
+		++pVector;
+		Word64 uWritten = uDirectoryLength;
+		i = 0;
+		while (i<uCount) {
+			const Entry_t *pEntry = &pEntries[i];
+			if (pEntry->m_uDuplicate==i) {
+				// Pad up to the data
+				WordPtr uPad = static_cast<WordPtr>(pEntry->m_uFileOffset-uWritten);
+				if (uPad) {
+					pVector->m_pBuffer = pPadding;
+					pVector->m_uLength = uPad;
+					++pVector;
+				}
+				const Word8 *pPayload = pEntry->m_pPayload;
+				if (!pPayload) {
+					pPayload = pEntry->m_pData;
+				}
+				pVector->m_pBuffer = pPayload;
+				pVector->m_uLength = pEntry->m_uPayloadLength;
+				++pVector;
+				uWritten = pEntry->m_uFileOffset+pEntry->m_uPayloadLength;
+			}
+			++i;
+		}
+		WordPtr uVectorCount = static_cast<WordPtr>(pVector-pVectors);
+		uError = File::OKAY;
+		if (pFile->WriteAt(0,pVectors,uVectorCount)!=uWritten) {
+			uError = File::IOERROR;
+		}
+	}
+	Free(pVectors);
+	Free(pPadding);
+	Free(pDirectory);
+	return uError;
+}
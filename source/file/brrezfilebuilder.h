@@ -0,0 +1,119 @@
+/***************************************
+
+	Rez file archive builder
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRREZFILEBUILDER_H__
+#define __BRREZFILEBUILDER_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRREZFILE_H__
+#include "brrezfile.h"
+#endif
+
+#ifndef __BRCOMPRESS_H__
+#include "brcompress.h"
+#endif
+
+#ifndef __BRMD5_H__
+#include "brmd5.h"
+#endif
+
+#ifndef __BRCRITICALSECTION_H__
+#include "brcriticalsection.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class RezFileBuilder {
+	BURGER_DISABLECOPYCONSTRUCTORS(RezFileBuilder);
+public:
+	typedef Compress *(BURGER_API *CompressProc)(void);	///< Function to create a compressor, released with Delete()
+	enum {
+		MAXTHREADS=16,				///< Maximum number of threads used for compression
+		DEFAULTPAGESIZE=4096,		///< Default alignment of the resource data in the file
+		MAXPAGESIZE=65536,			///< Largest alignment allowed
+		DEFAULTRATIO=90,			///< Default percentage of the original size compressed data must fit in
+		BUCKETSIZE=4,				///< Average number of names in each name hash bucket
+		FLAG_FIXED=0x01,			///< Load the resource into fixed memory
+		FLAG_STORE=0x02				///< Never compress this resource
+	};
+private:
+	enum {
+		PHASE_LOAD,					///< Load the files and hash the data
+		PHASE_COMPRESS				///< Compress the data
+	};
+	struct Entry_t {
+		char *m_pRezName;			///< Resource name or \ref NULL
+		char *m_pFileName;			///< File to load the data from or \ref NULL
+		Word8 *m_pData;				///< Uncompressed data
+		Word8 *m_pPayload;			///< Compressed data or \ref NULL if stored
+		WordPtr m_uLength;			///< Size of m_pData in bytes
+		WordPtr m_uPayloadLength;	///< Size of the data written to the file
+		Word64 m_uFileOffset;		///< Location of the data in the file
+		Word m_uRezNum;				///< Resource number
+		Word m_uFlags;				///< \ref FLAG_FIXED and \ref FLAG_STORE
+		Word m_uCodec;				///< Index into the codec table, zero if stored
+		Word m_uDuplicate;			///< Index of the entry whose data is written for this entry
+		Word m_uError;				///< Error code from the worker thread
+		MD5_t m_Hash;				///< Hash of the uncompressed data
+	};
+	Entry_t *m_pEntries;			///< Array of resources to write
+	Word m_uEntryCount;				///< Number of valid entries in m_pEntries
+	Word m_uEntryMax;				///< Number of entries allocated in m_pEntries
+	Word m_uCodecCount;				///< Number of codecs registered
+	Word m_uPageSize;				///< Alignment for resource data
+	Word m_uRatio;					///< Percentage of the original size compressed data must fit in
+	Word m_uMaxThreads;				///< Maximum number of threads, zero for Thread::GetProcessorCount()
+	Word m_uPhase;					///< Work performed by the threads
+	Word m_uNextEntry;				///< Next entry for a thread to process (Guarded by m_Lock)
+	Word m_uDuplicateCount;			///< Number of entries that share data with another entry
+	Word m_uError;					///< Error code from the threads (Guarded by m_Lock)
+	CompressProc m_Codecs[RezFile::MAXCODECS];	///< Functions to create the compressors
+	Word32 m_CodecSignatures[RezFile::MAXCODECS];	///< Signatures of the compressors
+	CriticalSection m_Lock;			///< Lock for m_uNextEntry
+	static WordPtr BURGER_API WorkerThread(void *pThis);
+	static int BURGER_ANSIAPI QSortRezNums(const void *pFirst,const void *pSecond);
+	static int BURGER_ANSIAPI QSortNames(const void *pFirst,const void *pSecond);
+	static int BURGER_ANSIAPI QSortHashes(const void *pFirst,const void *pSecond);
+	Entry_t * BURGER_API NewEntry(Word uRezNum,const char *pRezName,Word uFlags);
+	void BURGER_API RunThreads(Word uPhase);
+	void BURGER_API WorkAll(void);
+	void BURGER_API LoadEntry(Entry_t *pEntry);
+	void BURGER_API CompressEntry(Entry_t *pEntry,Compress **ppCompressors);
+	Word BURGER_API SortEntries(Entry_t **ppSorted);
+	void BURGER_API FindDuplicates(Entry_t **ppSorted);
+	Word BURGER_API CreateNameHash(Word32 *pOutput,Word *pScratch,Word uNameCount,Word uBucketCount,Word32 uSeed) const;
+	Word BURGER_API WriteFile(File *pFile);
+public:
+	RezFileBuilder();
+	~RezFileBuilder();
+	void BURGER_API Clear(void);
+	Word BURGER_API AddCodec(CompressProc pProc);
+	Word BURGER_API AddBuffer(Word uRezNum,const char *pRezName,const void *pInput,WordPtr uLength,Word uFlags=0);
+	Word BURGER_API AddFile(Word uRezNum,const char *pRezName,const char *pFileName,Word uFlags=0);
+	Word BURGER_API Save(const char *pFileName);
+	void BURGER_API SetPageSize(Word uPageSize);
+	BURGER_INLINE Word GetPageSize(void) const { return m_uPageSize; }
+	BURGER_INLINE void SetRatio(Word uPercent) { m_uRatio = (uPercent<100) ? uPercent : 100; }
+	BURGER_INLINE Word GetRatio(void) const { return m_uRatio; }
+	BURGER_INLINE void SetMaxThreads(Word uMaxThreads) { m_uMaxThreads = uMaxThreads; }
+	BURGER_INLINE Word GetMaxThreads(void) const { return m_uMaxThreads; }
+	BURGER_INLINE Word GetEntryCount(void) const { return m_uEntryCount; }
+	BURGER_INLINE Word GetDuplicateCount(void) const { return m_uDuplicateCount; }
+};
+}
+/* END */
+
+#endif
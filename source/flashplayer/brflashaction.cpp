@@ -13,7 +13,7 @@
 
 #include "brflashaction.h"
 
-BURGER_CREATE_STATICRTTI_PARENT(Burger::Flash::SharedBuffer,Burger::ReferenceCounter);
+BURGER_CREATE_STATICRTTI_PARENT(Burger::Flash::SharedBuffer,Burger::AtomicReferenceCounter);
 
 /*! ************************************
 
@@ -22,9 +22,10 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::Flash::SharedBuffer,Burger::ReferenceCou
 
 	A shared buffer that's reference counted so multiple
 	action script items can manager a single copy
-	of this buffer
+	of this buffer. The reference count is atomic so
+	the buffer can be shared with worker threads.
 
-	\sa ReferenceCounter
+	\sa AtomicReferenceCounter
 
 ***************************************/
 
@@ -39,7 +40,7 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::Flash::SharedBuffer,Burger::ReferenceCou
 ***************************************/
 
 Burger::Flash::SharedBuffer::SharedBuffer() :
-	ReferenceCounter(),
+	AtomicReferenceCounter(),
 	m_Buffer()
 {
 	m_Buffer.push_back(1);
@@ -28,7 +28,7 @@
 
 /* BEGIN */
 namespace Burger { namespace Flash {
-class SharedBuffer : public ReferenceCounter {
+class SharedBuffer : public AtomicReferenceCounter {
 	SimpleArray<Word8> m_Buffer;		///< Internal data buffer
 	BURGER_RTTI_IN_CLASS();
 public:
@@ -15,6 +15,8 @@
 #include "brutf8.h"
 #include "brendian.h"
 #include "brpalette.h"
+#include "brutf32.h"
+#include "brglobalmemorymanager.h"
 
 // The data is stored in little endian format
 
@@ -40,10 +42,38 @@ struct Font4BitImage_t {
 
 	Use the font creation tool in MakeRez to create font data for this class
 
-	This font type is optimized for software rendering
+	This font type is optimized for software rendering. The first time
+	text is drawn, every glyph is expanded into the pixel format
+	of the Renderer with the current colors, along with a list of the runs
+	of visible pixels on each line. Text is drawn by copying these runs
+	into the frame buffer. The cache is rebuilt only when a color,
+	the transparency mode, the font or the renderer's depth changes.
 
 ***************************************/
 
+/***************************************
+
+	Return the size in bytes of a pixel the glyph cache
+	supports for a renderer's bit depth, or zero if
+	the depth is not supported.
+
+***************************************/
+
+static Word BURGER_API GlyphPixelSize(Word uDepth)
+{
+	Word uResult;
+	if (uDepth<9) {
+		uResult = 1;
+	} else if (uDepth<17) {
+		uResult = 2;
+	} else if (uDepth==32) {
+		uResult = 4;
+	} else {
+		uResult = 0;
+	}
+	return uResult;
+}
+
 /*! ************************************
 
 	\brief Constructor.
@@ -61,9 +91,12 @@ Burger::Font4Bit::Font4Bit(Renderer *pRenderer) :
 	m_ppData(NULL),
 	m_uPixelOffset(0),
 	m_uRezNum(0),
-	m_uInvisibleColor(0)
+	m_uInvisibleColor(0),
+	m_pGlyphCache(NULL),
+	m_uGlyphCacheDepth(0)
 {
 	MemoryClear(m_ColorTable.Words,sizeof(m_ColorTable.Words));
+	MemoryClear(m_WidthTable,sizeof(m_WidthTable));
 }
 
 /*! ************************************
@@ -100,24 +133,81 @@ Burger::Font4Bit::~Font4Bit()
 Word Burger::Font4Bit::GetPixelWidth(const char *pInput,WordPtr uLength)
 {
 	Word uResult = 0;				// Assume no width
-	if (pInput && uLength) {
-		void **pHandle = m_ppData;	// Init tables
-		if (pHandle) {				// Data? And valid font?
-			// Pointer to the table
-			const Word8 *pWidths = static_cast<const Font4BitImage_t *>(pHandle[0])->m_Widths;
-			Word uCount = m_uCount;
+	if (pInput && uLength && m_ppData) {
+		// The table was created when the font was installed, characters
+		// not in the font have a width of zero
+		const Word8 *pWidths = m_WidthTable;
+		do {
+			uResult+=pWidths[reinterpret_cast<const Word8 *>(pInput)[0]];
+			++pInput;
+		} while (--uLength);
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Draws a string of UTF8 text onto the screen.
+
+	Render a string of text from the X/Y origin using the glyph cache.
+	The vertical clipping is performed once for the entire string
+	and characters that are outside of the clip rect are skipped
+	without any drawing.
+
+	If the glyph cache can't be created, every character is drawn
+	with DrawChar(Word).
+
+	\param pInput Pointer to a UTF8 string. If \ref NULL or an empty string, perform nothing
+	\param uLength Length of the string in bytes
+	\sa DrawChar(Word) or GetPixelWidth(const char *,WordPtr)
+
+***************************************/
+
+void Burger::Font4Bit::Draw(const char *pInput,WordPtr uLength)
+{
+	if (uLength && m_ppData) {
+		// Draw anything queued up so the text is on top
+		m_pRenderer->FlushCommands();
+		Word uPixelSize = UpdateGlyphCache();
+		if (!uPixelSize) {
+			Font::Draw(pInput,uLength);
+		} else {
+			// Clip the string vertically
+			const Rect_t *pClip = m_pRenderer->GetClip();
+			int iTop = m_iY;
+			int iBottom = iTop+static_cast<int>(m_uHeight);
+			if (iTop<pClip->m_iTop) {
+				iTop = pClip->m_iTop;
+			}
+			if (iBottom>pClip->m_iBottom) {
+				iBottom = pClip->m_iBottom;
+			}
+			Word bVisible = iTop<iBottom;
+			const Word8 *pWidths = static_cast<const Font4BitImage_t *>(m_ppData[0])->m_Widths;
 			Word uFirst = m_uFirst;
+			Word uCount = m_uCount;
+			int iX = m_iX;
+			const char *pEnd = pInput+uLength;
 			do {
-				// Get the char
-				Word uTemp = reinterpret_cast<const Word8 *>(pInput)[0]-uFirst;
-				if (uTemp<uCount) {					// Valid?
-					uResult+=pWidths[uTemp];		// Add to the width
+				Word32 uChar = UTF32::FromUTF8(pInput);
+				// Bad string?
+				if (uChar == static_cast<Word32>(UTF32::BAD)) {
+					break;
 				}
-				++pInput;
-			} while (--uLength);
+				uChar -= uFirst;
+				if (uChar<uCount) {
+					int iNextX = iX+static_cast<int>(pWidths[uChar]);
+					// Only draw the characters that are in the clip rect
+					if (bVisible && (iX<pClip->m_iRight) && (iNextX>pClip->m_iLeft)) {
+						DrawGlyph(uChar,iX,iTop,iBottom,pClip,uPixelSize);
+					}
+					iX = iNextX;
+				}
+				pInput = UTF8::NextToken(pInput);
+			} while (pInput<pEnd);
+			m_iX = iX;
 		}
 	}
-	return uResult;
 }
 
 /***************************************
@@ -138,8 +228,33 @@ void Burger::Font4Bit::DrawChar(Word uLetter)
 	if (uLetter>=m_uCount) {	// Can't draw this character?
 		return;					// Exit now
 	}
+	// Draw anything queued up so the text is on top
+	m_pRenderer->FlushCommands();
 	const Font4BitImage_t *pFont = static_cast<const Font4BitImage_t *>(m_ppData[0]);
 
+	// Use the glyph cache if possible
+	Word uPixelSize = UpdateGlyphCache();
+	if (uPixelSize) {
+		int iX = m_iX;
+		int iNextX = iX+static_cast<int>(pFont->m_Widths[uLetter]);
+		m_iX = iNextX;
+		const Rect_t *pClip = m_pRenderer->GetClip();
+		if ((iX<pClip->m_iRight) && (iNextX>pClip->m_iLeft)) {
+			int iTop = m_iY;
+			int iBottom = iTop+static_cast<int>(m_uHeight);
+			if (iTop<pClip->m_iTop) {
+				iTop = pClip->m_iTop;
+			}
+			if (iBottom>pClip->m_iBottom) {
+				iBottom = pClip->m_iBottom;
+			}
+			if (iTop<iBottom) {
+				DrawGlyph(uLetter,iX,iTop,iBottom,pClip,uPixelSize);
+			}
+		}
+		return;
+	}
+
 	// Bounds check the X coord
 	// Width of the font strike
 	Word uCharacterWidth = pFont->m_Widths[uLetter];
@@ -350,6 +465,191 @@ void Burger::Font4Bit::DrawChar(Word uLetter)
 	}
 }
 
+/*! ************************************
+
+	\brief Create the glyph cache if needed
+
+	If the glyph cache is out of date, expand every glyph in the font
+	into the pixel format of the current Renderer using the current color table.
+	For each line of each glyph, a list of the runs of visible pixels is
+	also created so drawing is reduced to a few memory copies.
+
+	The cache memory is laid out with two Word32 offsets per glyph to the
+	pixels and the runs, followed by all of the pixels, followed by
+	all of the runs. Each line of runs starts with a count, followed by
+	the starting pixel and length of each run.
+
+	\return Size in bytes of each cached pixel or zero if the cache couldn't be created
+	\sa DrawGlyph(Word,int,int,int,const Rect_t *,Word)
+
+***************************************/
+
+Word Burger::Font4Bit::UpdateGlyphCache(void)
+{
+	Word uDepth = m_pRenderer->GetDepth();
+	Word uPixelSize = GlyphPixelSize(uDepth);
+	if (m_uGlyphCacheDepth!=uDepth) {
+		Free(m_pGlyphCache);
+		m_pGlyphCache = NULL;
+		Word uCount = m_uCount;
+		if (uPixelSize && m_ppData && uCount) {
+			const Font4BitImage_t *pFont = static_cast<const Font4BitImage_t *>(m_ppData[0]);
+			const Word8 *pWidths = pFont->m_Widths;
+			Word uHeight = m_uHeight;
+
+			// Determine the size of the cache, assume the worst case for runs
+			WordPtr uPixelBytes = 0;
+			WordPtr uRunBytes = 0;
+			Word i = 0;
+			do {
+				Word uWidth = pWidths[i];
+				uPixelBytes += ((uWidth*uHeight*uPixelSize)+3U)&(~3U);
+				uRunBytes += uHeight*(1+(((uWidth+1)>>1U)*2));
+			} while (++i<uCount);
+			WordPtr uPixelStart = uCount*(sizeof(Word32)*2);
+			Word8 *pCache = static_cast<Word8 *>(Alloc(uPixelStart+uPixelBytes+uRunBytes));
+			if (pCache) {
+				m_pGlyphCache = pCache;
+				Word32 *pOffsets = reinterpret_cast<Word32 *>(pCache);
+				Word8 *pPixels = pCache+uPixelStart;
+				Word8 *pRuns = pPixels+uPixelBytes;
+				const Word8 *pFontIndexes = &pWidths[uCount];
+				Word uInvisibleColor = m_uInvisibleColor;
+				i = 0;
+				do {
+					pOffsets[0] = static_cast<Word32>(pPixels-pCache);
+					pOffsets[1] = static_cast<Word32>(pRuns-pCache);
+					pOffsets+=2;
+					Word uWidth = pWidths[i];
+					if (uHeight) {
+						const Word8 *pStrike = pFontIndexes+LittleEndian::LoadAny(&reinterpret_cast<const Word16 *>(pFontIndexes)[i]);
+						Word uByteWidth = (uWidth+1)>>1U;
+						Word8 *pWork = pPixels;
+						Word y = uHeight;
+						do {
+							// Expand the pixels and record the visible runs
+							Word8 *pRunCount = pRuns;
+							++pRuns;
+							Word uRunCount = 0;
+							Word uRunStart = 0;
+							Word bInRun = FALSE;
+							Word x = 0;
+							while (x<uWidth) {
+								Word uStrike = pStrike[x>>1U];
+								if (x&1U) {
+									uStrike &= 0x0FU;
+								} else {
+									uStrike >>= 4U;
+								}
+								switch (uPixelSize) {
+								case 1:
+									pWork[0] = m_ColorTable.Bytes[uStrike];
+									break;
+								case 2:
+									reinterpret_cast<Word16 *>(pWork)[0] = m_ColorTable.Shorts[uStrike];
+									break;
+								default:
+									reinterpret_cast<Word32 *>(pWork)[0] = m_ColorTable.Words[uStrike];
+									break;
+								}
+								pWork += uPixelSize;
+								if (uStrike!=uInvisibleColor) {
+									if (!bInRun) {
+										uRunStart = x;
+										bInRun = TRUE;
+									}
+								} else if (bInRun) {
+									pRuns[0] = static_cast<Word8>(uRunStart);
+									pRuns[1] = static_cast<Word8>(x-uRunStart);
+									pRuns+=2;
+									++uRunCount;
+									bInRun = FALSE;
+								}
+								++x;
+							}
+							if (bInRun) {
+								pRuns[0] = static_cast<Word8>(uRunStart);
+								pRuns[1] = static_cast<Word8>(x-uRunStart);
+								pRuns+=2;
+								++uRunCount;
+							}
+							pRunCount[0] = static_cast<Word8>(uRunCount);
+							pStrike += uByteWidth;
+						} while (--y);
+					}
+					pPixels += ((uWidth*uHeight*uPixelSize)+3U)&(~3U);
+				} while (++i<uCount);
+				m_uGlyphCacheDepth = uDepth;
+			}
+		}
+	}
+	return m_pGlyphCache ? uPixelSize : 0;
+}
+
+/*! ************************************
+
+	\brief Draw a glyph from the glyph cache
+
+	Draw the runs of visible pixels for a glyph, clipped
+	horizontally to the clip rect. The vertical clipping has already
+	been performed by the caller.
+
+	\param uIndex Index of the glyph (Character code minus the first character)
+	\param iX X coordinate to draw the glyph
+	\param iTop First line on the screen to draw
+	\param iBottom Line on the screen to stop drawing at
+	\param pClip Pointer to the clip rect
+	\param uPixelSize Size in bytes of each pixel
+	\sa UpdateGlyphCache()
+
+***************************************/
+
+void Burger::Font4Bit::DrawGlyph(Word uIndex,int iX,int iTop,int iBottom,const Rect_t *pClip,Word uPixelSize)
+{
+	const Word32 *pOffsets = &reinterpret_cast<const Word32 *>(m_pGlyphCache)[uIndex*2];
+	const Word8 *pPixels = m_pGlyphCache+pOffsets[0];
+	const Word8 *pRuns = m_pGlyphCache+pOffsets[1];
+	WordPtr uGlyphStride = static_cast<const Font4BitImage_t *>(m_ppData[0])->m_Widths[uIndex]*uPixelSize;
+
+	// Skip the lines that are clipped off the top
+	Word uSkip = static_cast<Word>(iTop-m_iY);
+	if (uSkip) {
+		pPixels += uGlyphStride*uSkip;
+		do {
+			pRuns += 1+(pRuns[0]*2);
+		} while (--uSkip);
+	}
+
+	// Clip rect in glyph coordinates
+	int iClipLeft = pClip->m_iLeft-iX;
+	int iClipRight = pClip->m_iRight-iX;
+	WordPtr uStride = m_pRenderer->GetStride();
+	Word8 *pDest = static_cast<Word8 *>(m_pRenderer->GetFrameBuffer())+(uStride*static_cast<WordPtr>(iTop));
+	Word uLines = static_cast<Word>(iBottom-iTop);
+	do {
+		Word uRunCount = pRuns[0];
+		++pRuns;
+		if (uRunCount) {
+			do {
+				int iStart = pRuns[0];
+				int iEnd = iStart+static_cast<int>(pRuns[1]);
+				pRuns+=2;
+				if (iStart<iClipLeft) {
+					iStart = iClipLeft;
+				}
+				if (iEnd>iClipRight) {
+					iEnd = iClipRight;
+				}
+				if (iStart<iEnd) {
+					MemoryCopy(pDest+(static_cast<WordPtr>(iX+iStart)*uPixelSize),pPixels+(static_cast<WordPtr>(iStart)*uPixelSize),static_cast<WordPtr>(iEnd-iStart)*uPixelSize);
+				}
+			} while (--uRunCount);
+		}
+		pDest += uStride;
+		pPixels += uGlyphStride;
+	} while (--uLines);
+}
+
 /*! ************************************
 
 	\brief Initialize a font structure
@@ -397,6 +697,10 @@ void Burger::Font4Bit::Shutdown(void)
 		m_uFirst = 0;
 		m_uCount = 0;
 	}
+	Free(m_pGlyphCache);
+	m_pGlyphCache = NULL;
+	m_uGlyphCacheDepth = 0;
+	MemoryClear(m_WidthTable,sizeof(m_WidthTable));
 }
 
 /*! ************************************
@@ -438,12 +742,16 @@ void Burger::Font4Bit::RestoreState(const State_t *pInput)
 	}
 	m_uInvisibleColor=pInput->m_uInvisibleColor;
 	MemoryCopy(m_ColorTable.Words,pInput->m_ColorTable,sizeof(m_ColorTable.Words));
+	m_uGlyphCacheDepth = 0;		// Rebuild the glyph cache
 }
 
 /*! ************************************
 
 	\brief Set a color for a font
 
+	If the color is different than the current color, the glyph
+	cache will be rebuilt the next time text is drawn.
+
 	\param uColorIndex Index into the color table, maximum value is 15
 	\param uColor Color in the current color mode to draw with
 
@@ -454,15 +762,24 @@ void Burger::Font4Bit::SetColor(Word uColorIndex,Word uColor)
 	if (uColorIndex<16) {
 		switch (m_pRenderer->GetDepth()) {		// Color mode?
 		case 8:
-			m_ColorTable.Bytes[uColorIndex] = static_cast<Word8>(uColor);	// Set the color
+			if (m_ColorTable.Bytes[uColorIndex]!=static_cast<Word8>(uColor)) {
+				m_ColorTable.Bytes[uColorIndex] = static_cast<Word8>(uColor);	// Set the color
+				m_uGlyphCacheDepth = 0;
+			}
 			break;
 		case 15:
 		case 16:
-			m_ColorTable.Shorts[uColorIndex] = static_cast<Word16>(uColor);	// Set as 16 bit
+			if (m_ColorTable.Shorts[uColorIndex]!=static_cast<Word16>(uColor)) {
+				m_ColorTable.Shorts[uColorIndex] = static_cast<Word16>(uColor);	// Set as 16 bit
+				m_uGlyphCacheDepth = 0;
+			}
 			break;
 		case 24:
 		case 32:
-			m_ColorTable.Words[uColorIndex] = static_cast<Word32>(uColor);	// Set as true color
+			if (m_ColorTable.Words[uColorIndex]!=static_cast<Word32>(uColor)) {
+				m_ColorTable.Words[uColorIndex] = static_cast<Word32>(uColor);	// Set as true color
+				m_uGlyphCacheDepth = 0;
+			}
 			break;
 		}
 	}
@@ -473,6 +790,8 @@ void Burger::Font4Bit::SetColor(Word uColorIndex,Word uColor)
 	\fn Burger::Font4Bit::UseZero()
 	\brief Make color index #0 visible
 
+	The glyph cache will be rebuilt the next time text is drawn.
+
 ***************************************/
 
 /*! ************************************
@@ -480,6 +799,8 @@ void Burger::Font4Bit::SetColor(Word uColorIndex,Word uColor)
 	\fn Burger::Font4Bit::UseMask()
 	\brief Make color index #0 transparent
 
+	The glyph cache will be rebuilt the next time text is drawn.
+
 ***************************************/
 
 /*! ************************************
@@ -509,6 +830,12 @@ void Burger::Font4Bit::InstallToPalette(Burger::RezFile *pRezFile,Word uRezNum,c
 				m_uFirst = LittleEndian::Load(&pFontImage->m_usFirst);
 				m_uPixelOffset = m_uCount+BURGER_OFFSETOF(Font4BitImage_t,m_Widths);
 				m_uRezNum = uRezNum;		// Set the new font
+				// Create the width table for the 8 bit character codes
+				Word i = m_uFirst;
+				while ((i<256) && ((i-m_uFirst)<m_uCount)) {
+					m_WidthTable[i] = pFontImage->m_Widths[i-m_uFirst];
+					++i;
+				}
 				m_pRezFile = pRezFile;
 				if (pPalette) {				// Normal mode?
 					const Word8 *pFontIndexes = &pFontImage->m_Widths[m_uCount];
@@ -53,6 +53,7 @@ public:
 	};
 	Font4Bit(Renderer *pRenderer=NULL);
 	virtual ~Font4Bit();
+	virtual void Draw(const char *pInput,WordPtr uLength);
 	virtual Word GetPixelWidth(const char *pInput,WordPtr uLength);
 	virtual void DrawChar(Word uLetter);
 	void Init(RezFile *pRezFile,Word uRezNum,const Word8 *pPalette,Renderer *pRenderer=NULL);
@@ -60,12 +61,14 @@ public:
 	void SaveState(State_t *pOutput);
 	void RestoreState(const State_t *pInput);
 	void SetColor(Word uColorIndex,Word uColor);
-	BURGER_INLINE void UseZero(void) { m_uInvisibleColor = 0x7FFF; }
-	BURGER_INLINE void UseMask(void) { m_uInvisibleColor = 0; }
+	BURGER_INLINE void UseZero(void) { m_uInvisibleColor = 0x7FFF; m_uGlyphCacheDepth = 0; }
+	BURGER_INLINE void UseMask(void) { m_uInvisibleColor = 0; m_uGlyphCacheDepth = 0; }
 	void InstallToPalette(RezFile *pRezFile,Word uRezNum,const Word8 *pPalette);
 	void SetColorRGBListToPalette(const RGBColorList_t *pRGBList,const Word8 *pPalette);
 	void SetToPalette(const Word8 *pPalette);
 protected:
+	Word UpdateGlyphCache(void);
+	void DrawGlyph(Word uIndex,int iX,int iTop,int iBottom,const Rect_t *pClip,Word uPixelSize);
 	union {
 		Word8 Bytes[16];	///< Color of font for 8 bit rendering
 		Word16 Shorts[16];	///< Color of font for 16 bit rendering
@@ -76,6 +79,9 @@ protected:
 	WordPtr m_uPixelOffset;	///< Offset to the pixel array
 	Word m_uRezNum;			///< Resource ID of the last font loaded
 	Word m_uInvisibleColor;	///< Color to ignore for drawing
+	Word8 *m_pGlyphCache;	///< Glyphs expanded to the renderer's pixel format
+	Word m_uGlyphCacheDepth;	///< Bit depth of the glyph cache, zero if the cache is invalid
+	Word8 m_WidthTable[256];	///< Width in pixels of each 8 bit character code
 };
 }
 /* END */
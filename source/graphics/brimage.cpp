@@ -13,6 +13,14 @@
 
 #include "brimage.h"
 #include "brglobalmemorymanager.h"
+#include "brcriticalsection.h"
+#include "brfloatingpoint.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
 
 /*! ************************************
 
@@ -1325,4 +1333,912 @@ Word Burger::Image::HorizontalFlip(void)
 		}
 	}
 	return 0;
-}
\ No newline at end of file
+}
+
+/*! ************************************
+
+	\enum Burger::Image::eFilter
+	\brief Resampling filter type
+	
+	An enumeration to select the filter used by Resize(const Image *,Word,Word,eFilter)
+	and GenerateMipMaps(eFilter). The box filters are the fastest, the
+	windowed sinc filters retain the most detail when shrinking an image.
+
+***************************************/
+
+//
+// Number of output scan lines processed as a single unit of work
+//
+
+static const Word g_uResampleBandSize = 32;
+
+//
+// Don't bother spawning threads for images with fewer pixels than this
+//
+
+static const Word g_uResampleParallelPixels = 128*128;
+
+//
+// Span of input pixels that contribute to a single output pixel
+//
+
+struct ResampleContribution_t {
+	Word m_uStart;			// First input pixel
+	Word m_uCount;			// Number of input pixels
+	WordPtr m_uWeights;		// Index into the weight array
+};
+
+//
+// Shared state for the resampler worker threads
+//
+
+struct ResampleState_t {
+	const Word8 *m_pInput;			// Source pixels
+	Word8 *m_pOutput;				// Destination pixels
+	WordPtr m_uInputStride;			// Source bytes per scan line
+	WordPtr m_uOutputStride;		// Destination bytes per scan line
+	Word m_uInputWidth;				// Source width in pixels
+	Word m_uInputHeight;			// Source height in pixels
+	Word m_uOutputWidth;			// Destination width in pixels
+	Word m_uOutputHeight;			// Destination height in pixels
+	Burger::Image::ePixelTypes m_eType;	// Pixel type of both images
+	const ResampleContribution_t *m_pXContributions;	// Horizontal filter spans
+	const ResampleContribution_t *m_pYContributions;	// Vertical filter spans
+	const float *m_pXWeights;		// Horizontal filter weights
+	const float *m_pYWeights;		// Vertical filter weights
+	const Word8 *m_pToGamma;		// Linear to sRGB table (NULL if not gamma correct)
+	volatile Word m_uError;			// Set to non-zero if a worker thread failed
+	float m_ToColor[256];			// Byte to float for red, green and blue
+	float m_ToAlpha[256];			// Byte to float for alpha
+};
+
+//
+// Size of the linear to sRGB conversion table
+//
+
+static const Word g_uGammaTableSize = 4096;
+
+/***************************************
+
+	Return the value of the filter kernel at a distance
+	from the center of the filter
+
+***************************************/
+
+static double BURGER_API ResampleSinc(double dInput)
+{
+	if (dInput==0.0) {
+		return 1.0;
+	}
+	dInput = dInput*Burger::g_dPi;
+	return Burger::Sin(dInput)/dInput;
+}
+
+static double BURGER_API ResampleBesselI0(double dInput)
+{
+	// Power series, converges quickly for the ranges used
+	double dSum = 1.0;
+	double dTerm = 1.0;
+	double dHalf = dInput*0.5;
+	Word i = 1;
+	do {
+		double dTemp = dHalf/static_cast<double>(i);
+		dTerm = dTerm*dTemp*dTemp;
+		dSum += dTerm;
+	} while (++i<25);
+	return dSum;
+}
+
+static double BURGER_API ResampleKernel(Burger::Image::eFilter eFilterType,double dInput)
+{
+	double dResult = 0.0;
+	double dAbs = (dInput<0.0) ? -dInput : dInput;
+	switch (eFilterType) {
+	default:
+	case Burger::Image::FILTER_BOX:
+	case Burger::Image::FILTER_BOXGAMMA:
+		// Half open to prevent a pixel from being counted twice
+		if ((dInput>=-0.5) && (dInput<0.5)) {
+			dResult = 1.0;
+		}
+		break;
+	case Burger::Image::FILTER_KAISER:
+		if (dAbs<3.0) {
+			// Kaiser window with an alpha of 4
+			const double dAlpha = 4.0;
+			double dRatio = dAbs*(1.0/3.0);
+			dResult = ResampleSinc(dInput)*ResampleBesselI0(dAlpha*Burger::Sqrt(1.0-(dRatio*dRatio)))/ResampleBesselI0(dAlpha);
+		}
+		break;
+	case Burger::Image::FILTER_LANCZOS:
+		if (dAbs<3.0) {
+			dResult = ResampleSinc(dInput)*ResampleSinc(dInput*(1.0/3.0));
+		}
+		break;
+	}
+	return dResult;
+}
+
+/***************************************
+
+	Create the list of input pixels and their weights for each
+	output pixel on a single axis.
+
+	Returns NULL if out of memory. Free the returned
+	pointer when done.
+
+***************************************/
+
+static ResampleContribution_t * BURGER_API ResampleCreateContributions(Word uInput,Word uOutput,Burger::Image::eFilter eFilterType,float **ppWeights)
+{
+	double dScale = static_cast<double>(uOutput)/static_cast<double>(uInput);
+	double dSupport;
+	switch (eFilterType) {
+	default:
+	case Burger::Image::FILTER_BOX:
+	case Burger::Image::FILTER_BOXGAMMA:
+		dSupport = 0.5;
+		break;
+	case Burger::Image::FILTER_KAISER:
+	case Burger::Image::FILTER_LANCZOS:
+		dSupport = 3.0;
+		break;
+	}
+	// When shrinking, widen the filter to cover all the input pixels
+	double dFilterScale = 1.0;
+	if (dScale<1.0) {
+		dSupport = dSupport/dScale;
+		dFilterScale = dScale;
+	}
+	Word uMaxTaps = static_cast<Word>(dSupport*2.0)+3;
+
+	// Allocate the spans and the weights in one shot
+	WordPtr uSpanSize = sizeof(ResampleContribution_t)*uOutput;
+	uSpanSize = (uSpanSize+15)&(~static_cast<WordPtr>(15));
+	ResampleContribution_t *pResult = static_cast<ResampleContribution_t *>(Burger::Alloc(uSpanSize+(sizeof(float)*uMaxTaps*uOutput)));
+	if (pResult) {
+		float *pWeights = reinterpret_cast<float *>(reinterpret_cast<Word8 *>(pResult)+uSpanSize);
+		ppWeights[0] = pWeights;
+		WordPtr uWeightIndex = 0;
+		Word i = 0;
+		do {
+			// Center of the output pixel in input pixel space
+			double dCenter = ((static_cast<double>(i)+0.5)/dScale)-0.5;
+			Int iFirst = static_cast<Int>(Burger::Floor(dCenter-dSupport));
+			Int iLast = static_cast<Int>(Burger::Ceil(dCenter+dSupport));
+			if (iFirst<0) {
+				iFirst = 0;
+			}
+			if (iLast>=static_cast<Int>(uInput)) {
+				iLast = static_cast<Int>(uInput)-1;
+			}
+			// Weigh every pixel in range
+			double dTotal = 0.0;
+			Word uCount = 0;
+			Int iStart = iFirst;
+			Int j = iFirst;
+			while (j<=iLast) {
+				double dWeight = ResampleKernel(eFilterType,(static_cast<double>(j)-dCenter)*dFilterScale);
+				if (dWeight!=0.0) {
+					if (!uCount) {
+						iStart = j;
+					}
+					// Zeros in the middle of the span are kept
+					uCount = static_cast<Word>(j-iStart)+1;
+					dTotal += dWeight;
+				}
+				++j;
+			}
+			// Failsafe for a filter that landed between the pixels
+			if (!uCount) {
+				iStart = static_cast<Int>(dCenter+0.5);
+				if (iStart<0) {
+					iStart = 0;
+				} else if (iStart>=static_cast<Int>(uInput)) {
+					iStart = static_cast<Int>(uInput)-1;
+				}
+				uCount = 1;
+				pWeights[uWeightIndex] = 1.0f;
+			} else {
+				// Normalize the weights so the sum is 1.0
+				double dReciprocal = (dTotal!=0.0) ? (1.0/dTotal) : 1.0;
+				Word k = 0;
+				do {
+					pWeights[uWeightIndex+k] = static_cast<float>(ResampleKernel(eFilterType,(static_cast<double>(iStart+static_cast<Int>(k))-dCenter)*dFilterScale)*dReciprocal);
+				} while (++k<uCount);
+			}
+			pResult[i].m_uStart = static_cast<Word>(iStart);
+			pResult[i].m_uCount = uCount;
+			pResult[i].m_uWeights = uWeightIndex;
+			uWeightIndex += uCount;
+		} while (++i<uOutput);
+	}
+	return pResult;
+}
+
+/***************************************
+
+	Convert a scan line of pixels into an array of floats,
+	4 per pixel in the order of red, green, blue and alpha
+
+***************************************/
+
+static void BURGER_API ResampleLoadRow(float *pOutput,const Word8 *pInput,Word uWidth,const ResampleState_t *pState)
+{
+	const float *pToColor = pState->m_ToColor;
+	switch (pState->m_eType) {
+	case Burger::Image::PIXELTYPE8888:
+		{
+			const float *pToAlpha = pState->m_ToAlpha;
+			do {
+				pOutput[0] = pToColor[pInput[0]];
+				pOutput[1] = pToColor[pInput[1]];
+				pOutput[2] = pToColor[pInput[2]];
+				pOutput[3] = pToAlpha[pInput[3]];
+				pInput+=4;
+				pOutput+=4;
+			} while (--uWidth);
+		}
+		break;
+	case Burger::Image::PIXELTYPE888:
+		do {
+			pOutput[0] = pToColor[pInput[0]];
+			pOutput[1] = pToColor[pInput[1]];
+			pOutput[2] = pToColor[pInput[2]];
+			pOutput[3] = 1.0f;
+			pInput+=3;
+			pOutput+=4;
+		} while (--uWidth);
+		break;
+	default:
+	case Burger::Image::PIXELTYPE565:
+		do {
+			Word uColor = reinterpret_cast<const Word16 *>(pInput)[0];
+			// Expand the bits so 0x1F becomes 0xFF
+			Word uRed = (uColor>>11)&0x1FU;
+			Word uGreen = (uColor>>5)&0x3FU;
+			Word uBlue = uColor&0x1FU;
+			pOutput[0] = pToColor[(uRed<<3U)|(uRed>>2U)];
+			pOutput[1] = pToColor[(uGreen<<2U)|(uGreen>>4U)];
+			pOutput[2] = pToColor[(uBlue<<3U)|(uBlue>>2U)];
+			pOutput[3] = 1.0f;
+			pInput+=2;
+			pOutput+=4;
+		} while (--uWidth);
+		break;
+	}
+}
+
+/***************************************
+
+	Convert a single color component in the range of
+	0.0f to 1.0f into a byte
+
+***************************************/
+
+static BURGER_INLINE Word ResampleToByte(float fInput)
+{
+	if (fInput<=0.0f) {
+		return 0;
+	}
+	if (fInput>=1.0f) {
+		return 255;
+	}
+	return static_cast<Word>((fInput*255.0f)+0.5f);
+}
+
+static BURGER_INLINE Word ResampleToGamma(float fInput,const Word8 *pToGamma)
+{
+	if (fInput<=0.0f) {
+		return pToGamma[0];
+	}
+	if (fInput>=1.0f) {
+		return pToGamma[g_uGammaTableSize-1];
+	}
+	return pToGamma[static_cast<Word>((fInput*static_cast<float>(g_uGammaTableSize-1))+0.5f)];
+}
+
+/***************************************
+
+	Convert an array of floats back into a scan line
+	of pixels
+
+***************************************/
+
+static void BURGER_API ResampleStoreRow(Word8 *pOutput,const float *pInput,Word uWidth,const ResampleState_t *pState)
+{
+	const Word8 *pToGamma = pState->m_pToGamma;
+	switch (pState->m_eType) {
+	case Burger::Image::PIXELTYPE8888:
+		if (!pToGamma) {
+#if defined(BURGER_SSE2)
+			// Clamp, scale and pack a pixel at a time
+			__m128 vZero = _mm_setzero_ps();
+			__m128 vOne = _mm_set1_ps(1.0f);
+			__m128 v255 = _mm_set1_ps(255.0f);
+			__m128 vHalf = _mm_set1_ps(0.5f);
+			do {
+				__m128 vColor = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pInput),vZero),vOne);
+				__m128i vInt = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(vColor,v255),vHalf));
+				vInt = _mm_packs_epi32(vInt,vInt);
+				vInt = _mm_packus_epi16(vInt,vInt);
+				reinterpret_cast<Word32 *>(pOutput)[0] = static_cast<Word32>(_mm_cvtsi128_si32(vInt));
+				pInput+=4;
+				pOutput+=4;
+			} while (--uWidth);
+#else
+			do {
+				pOutput[0] = static_cast<Word8>(ResampleToByte(pInput[0]));
+				pOutput[1] = static_cast<Word8>(ResampleToByte(pInput[1]));
+				pOutput[2] = static_cast<Word8>(ResampleToByte(pInput[2]));
+				pOutput[3] = static_cast<Word8>(ResampleToByte(pInput[3]));
+				pInput+=4;
+				pOutput+=4;
+			} while (--uWidth);
+#endif
+		} else {
+			do {
+				pOutput[0] = static_cast<Word8>(ResampleToGamma(pInput[0],pToGamma));
+				pOutput[1] = static_cast<Word8>(ResampleToGamma(pInput[1],pToGamma));
+				pOutput[2] = static_cast<Word8>(ResampleToGamma(pInput[2],pToGamma));
+				pOutput[3] = static_cast<Word8>(ResampleToByte(pInput[3]));
+				pInput+=4;
+				pOutput+=4;
+			} while (--uWidth);
+		}
+		break;
+	case Burger::Image::PIXELTYPE888:
+		do {
+			if (!pToGamma) {
+				pOutput[0] = static_cast<Word8>(ResampleToByte(pInput[0]));
+				pOutput[1] = static_cast<Word8>(ResampleToByte(pInput[1]));
+				pOutput[2] = static_cast<Word8>(ResampleToByte(pInput[2]));
+			} else {
+				pOutput[0] = static_cast<Word8>(ResampleToGamma(pInput[0],pToGamma));
+				pOutput[1] = static_cast<Word8>(ResampleToGamma(pInput[1],pToGamma));
+				pOutput[2] = static_cast<Word8>(ResampleToGamma(pInput[2],pToGamma));
+			}
+			pInput+=4;
+			pOutput+=3;
+		} while (--uWidth);
+		break;
+	default:
+	case Burger::Image::PIXELTYPE565:
+		do {
+			Word uRed;
+			Word uGreen;
+			Word uBlue;
+			if (!pToGamma) {
+				uRed = ResampleToByte(pInput[0]);
+				uGreen = ResampleToByte(pInput[1]);
+				uBlue = ResampleToByte(pInput[2]);
+			} else {
+				uRed = ResampleToGamma(pInput[0],pToGamma);
+				uGreen = ResampleToGamma(pInput[1],pToGamma);
+				uBlue = ResampleToGamma(pInput[2],pToGamma);
+			}
+			// Round down to 5/6 bits
+			uRed = ((uRed*31U)+127U)/255U;
+			uGreen = ((uGreen*63U)+127U)/255U;
+			uBlue = ((uBlue*31U)+127U)/255U;
+			reinterpret_cast<Word16 *>(pOutput)[0] = static_cast<Word16>((uRed<<11U)|(uGreen<<5U)|uBlue);
+			pInput+=4;
+			pOutput+=2;
+		} while (--uWidth);
+		break;
+	}
+}
+
+/***************************************
+
+	Apply the horizontal filter to a scan line of float pixels
+
+***************************************/
+
+static void BURGER_API ResampleHorizontal(float *pOutput,const float *pInput,Word uWidth,const ResampleContribution_t *pContributions,const float *pWeights)
+{
+	do {
+		const float *pWork = pInput+(pContributions->m_uStart*4);
+		const float *pWeight = pWeights+pContributions->m_uWeights;
+		Word uCount = pContributions->m_uCount;
+#if defined(BURGER_SSE2)
+		__m128 vSum = _mm_setzero_ps();
+		do {
+			vSum = _mm_add_ps(vSum,_mm_mul_ps(_mm_loadu_ps(pWork),_mm_set1_ps(pWeight[0])));
+			pWork+=4;
+			++pWeight;
+		} while (--uCount);
+		_mm_storeu_ps(pOutput,vSum);
+#elif defined(BURGER_NEON)
+		float32x4_t vSum = vdupq_n_f32(0.0f);
+		do {
+			vSum = vmlaq_n_f32(vSum,vld1q_f32(pWork),pWeight[0]);
+			pWork+=4;
+			++pWeight;
+		} while (--uCount);
+		vst1q_f32(pOutput,vSum);
+#else
+		float fRed = 0.0f;
+		float fGreen = 0.0f;
+		float fBlue = 0.0f;
+		float fAlpha = 0.0f;
+		do {
+			float fWeight = pWeight[0];
+			fRed += pWork[0]*fWeight;
+			fGreen += pWork[1]*fWeight;
+			fBlue += pWork[2]*fWeight;
+			fAlpha += pWork[3]*fWeight;
+			pWork+=4;
+			++pWeight;
+		} while (--uCount);
+		pOutput[0] = fRed;
+		pOutput[1] = fGreen;
+		pOutput[2] = fBlue;
+		pOutput[3] = fAlpha;
+#endif
+		pOutput+=4;
+		++pContributions;
+	} while (--uWidth);
+}
+
+/***************************************
+
+	Multiply a scan line of floats by a weight and either
+	store or add the result to the output scan line.
+
+	uCount is the number of floats, always a multiple of 4
+
+***************************************/
+
+static void BURGER_API ResampleVertical(float *pOutput,const float *pInput,float fWeight,WordPtr uCount,Word bAdd)
+{
+#if defined(BURGER_SSE2)
+	__m128 vWeight = _mm_set1_ps(fWeight);
+	if (bAdd) {
+		do {
+			_mm_storeu_ps(pOutput,_mm_add_ps(_mm_loadu_ps(pOutput),_mm_mul_ps(_mm_loadu_ps(pInput),vWeight)));
+			pInput+=4;
+			pOutput+=4;
+		} while ((uCount-=4)!=0);
+	} else {
+		do {
+			_mm_storeu_ps(pOutput,_mm_mul_ps(_mm_loadu_ps(pInput),vWeight));
+			pInput+=4;
+			pOutput+=4;
+		} while ((uCount-=4)!=0);
+	}
+#elif defined(BURGER_NEON)
+	if (bAdd) {
+		do {
+			vst1q_f32(pOutput,vmlaq_n_f32(vld1q_f32(pOutput),vld1q_f32(pInput),fWeight));
+			pInput+=4;
+			pOutput+=4;
+		} while ((uCount-=4)!=0);
+	} else {
+		do {
+			vst1q_f32(pOutput,vmulq_n_f32(vld1q_f32(pInput),fWeight));
+			pInput+=4;
+			pOutput+=4;
+		} while ((uCount-=4)!=0);
+	}
+#else
+	if (bAdd) {
+		do {
+			pOutput[0] += pInput[0]*fWeight;
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	} else {
+		do {
+			pOutput[0] = pInput[0]*fWeight;
+			++pInput;
+			++pOutput;
+		} while (--uCount);
+	}
+#endif
+}
+
+/***************************************
+
+	Resample a band of output scan lines.
+
+	The horizontal pass is applied to all the input scan lines
+	that the band needs and then the vertical pass creates the
+	output.
+
+***************************************/
+
+static void BURGER_API ResampleBand(void *pData,Word uBand)
+{
+	ResampleState_t *pState = static_cast<ResampleState_t *>(pData);
+	Word uY = uBand*g_uResampleBandSize;
+	Word uYEnd = uY+g_uResampleBandSize;
+	if (uYEnd>pState->m_uOutputHeight) {
+		uYEnd = pState->m_uOutputHeight;
+	}
+
+	// Which input scan lines are needed for this band?
+	// Spans only move forward, so check the first and last
+	const ResampleContribution_t *pYContributions = pState->m_pYContributions;
+	Word uFirstRow = pYContributions[uY].m_uStart;
+	Word uLastRow = pYContributions[uYEnd-1].m_uStart+pYContributions[uYEnd-1].m_uCount;
+	Word uRows = uLastRow-uFirstRow;
+
+	// Buffers for the input line, the filtered input lines and the output line
+	WordPtr uOutputFloats = static_cast<WordPtr>(pState->m_uOutputWidth)*4;
+	float *pBuffer = static_cast<float *>(Burger::Alloc(sizeof(float)*((static_cast<WordPtr>(pState->m_uInputWidth)*4)+(uOutputFloats*(uRows+1)))));
+	if (!pBuffer) {
+		pState->m_uError = 10;
+		return;
+	}
+	float *pOutputRow = pBuffer+(static_cast<WordPtr>(pState->m_uInputWidth)*4);
+	float *pRows = pOutputRow+uOutputFloats;
+
+	// Horizontal pass
+	const Word8 *pInput = pState->m_pInput+(uFirstRow*pState->m_uInputStride);
+	float *pRowWork = pRows;
+	Word i = uRows;
+	do {
+		ResampleLoadRow(pBuffer,pInput,pState->m_uInputWidth,pState);
+		ResampleHorizontal(pRowWork,pBuffer,pState->m_uOutputWidth,pState->m_pXContributions,pState->m_pXWeights);
+		pInput += pState->m_uInputStride;
+		pRowWork += uOutputFloats;
+	} while (--i);
+
+	// Vertical pass
+	Word8 *pOutput = pState->m_pOutput+(uY*pState->m_uOutputStride);
+	do {
+		const ResampleContribution_t *pContribution = &pYContributions[uY];
+		const float *pWeights = pState->m_pYWeights+pContribution->m_uWeights;
+		const float *pSource = pRows+((pContribution->m_uStart-uFirstRow)*uOutputFloats);
+		Word uCount = pContribution->m_uCount;
+		Word bAdd = FALSE;
+		do {
+			ResampleVertical(pOutputRow,pSource,pWeights[0],uOutputFloats,bAdd);
+			bAdd = TRUE;
+			pSource += uOutputFloats;
+			++pWeights;
+		} while (--uCount);
+		ResampleStoreRow(pOutput,pOutputRow,pState->m_uOutputWidth,pState);
+		pOutput += pState->m_uOutputStride;
+	} while (++uY<uYEnd);
+	Burger::Free(pBuffer);
+}
+
+/***************************************
+
+	Resample a raw image into another of the same pixel type
+
+***************************************/
+
+static Word BURGER_API ResampleImage(Word8 *pOutput,WordPtr uOutputStride,Word uOutputWidth,Word uOutputHeight,
+	const Word8 *pInput,WordPtr uInputStride,Word uInputWidth,Word uInputHeight,
+	Burger::Image::ePixelTypes eType,Burger::Image::eFilter eFilterType)
+{
+	ResampleState_t *pState = static_cast<ResampleState_t *>(Burger::Alloc(sizeof(ResampleState_t)));
+	if (!pState) {
+		return 10;
+	}
+	Word uResult = 10;
+	float *pXWeights;
+	float *pYWeights;
+	ResampleContribution_t *pXContributions = ResampleCreateContributions(uInputWidth,uOutputWidth,eFilterType,&pXWeights);
+	ResampleContribution_t *pYContributions = ResampleCreateContributions(uInputHeight,uOutputHeight,eFilterType,&pYWeights);
+	Word8 *pToGamma = NULL;
+	if (eFilterType==Burger::Image::FILTER_BOXGAMMA) {
+		pToGamma = static_cast<Word8 *>(Burger::Alloc(g_uGammaTableSize));
+	}
+	if (pXContributions && pYContributions && ((eFilterType!=Burger::Image::FILTER_BOXGAMMA) || pToGamma)) {
+		pState->m_pInput = pInput;
+		pState->m_pOutput = pOutput;
+		pState->m_uInputStride = uInputStride;
+		pState->m_uOutputStride = uOutputStride;
+		pState->m_uInputWidth = uInputWidth;
+		pState->m_uInputHeight = uInputHeight;
+		pState->m_uOutputWidth = uOutputWidth;
+		pState->m_uOutputHeight = uOutputHeight;
+		pState->m_eType = eType;
+		pState->m_pXContributions = pXContributions;
+		pState->m_pYContributions = pYContributions;
+		pState->m_pXWeights = pXWeights;
+		pState->m_pYWeights = pYWeights;
+		pState->m_pToGamma = pToGamma;
+		pState->m_uError = 0;
+
+		// Create the byte to float lookups
+		Word i = 0;
+		do {
+			float fValue = static_cast<float>(i)*(1.0f/255.0f);
+			pState->m_ToAlpha[i] = fValue;
+			if (pToGamma) {
+				// sRGB to linear
+				double dValue = static_cast<double>(i)*(1.0/255.0);
+				if (dValue<=0.04045) {
+					dValue = dValue*(1.0/12.92);
+				} else {
+					dValue = Burger::Exp(Burger::Log((dValue+0.055)*(1.0/1.055))*2.4);
+				}
+				fValue = static_cast<float>(dValue);
+			}
+			pState->m_ToColor[i] = fValue;
+		} while (++i<256);
+
+		// Linear back to sRGB
+		if (pToGamma) {
+			i = 0;
+			do {
+				double dValue = static_cast<double>(i)/static_cast<double>(g_uGammaTableSize-1);
+				if (dValue<=0.0031308) {
+					dValue = dValue*12.92;
+				} else {
+					dValue = (1.055*Burger::Exp(Burger::Log(dValue)*(1.0/2.4)))-0.055;
+				}
+				pToGamma[i] = static_cast<Word8>(ResampleToByte(static_cast<float>(dValue)));
+			} while (++i<g_uGammaTableSize);
+		}
+
+		// Process the bands, using multiple threads if it's worth it
+		Word uBands = (uOutputHeight+(g_uResampleBandSize-1))/g_uResampleBandSize;
+		Word uThreads = 1;
+		if ((uOutputWidth*uOutputHeight)>=g_uResampleParallelPixels) {
+			uThreads = 0;
+		}
+		Burger::ParallelFor(ResampleBand,pState,uBands,uThreads);
+		uResult = pState->m_uError;
+	}
+	Burger::Free(pToGamma);
+	Burger::Free(pYContributions);
+	Burger::Free(pXContributions);
+	Burger::Free(pState);
+	return uResult;
+}
+
+/***************************************
+
+	Shrink an image by half using a 2x2 box filter with
+	integer math.
+
+***************************************/
+
+struct BoxState_t {
+	const Word8 *m_pInput;			// Source pixels
+	Word8 *m_pOutput;				// Destination pixels
+	WordPtr m_uInputStride;			// Source bytes per scan line
+	WordPtr m_uOutputStride;		// Destination bytes per scan line
+	Word m_uOutputWidth;			// Destination width in pixels
+	Word m_uOutputHeight;			// Destination height in pixels
+	Burger::Image::ePixelTypes m_eType;	// Pixel type of both images
+};
+
+static void BURGER_API BoxBand(void *pData,Word uBand)
+{
+	const BoxState_t *pState = static_cast<const BoxState_t *>(pData);
+	Word uY = uBand*g_uResampleBandSize;
+	Word uYEnd = uY+g_uResampleBandSize;
+	if (uYEnd>pState->m_uOutputHeight) {
+		uYEnd = pState->m_uOutputHeight;
+	}
+	WordPtr uInputStride = pState->m_uInputStride;
+	const Word8 *pInput = pState->m_pInput+((uY*2)*uInputStride);
+	Word8 *pOutput = pState->m_pOutput+(uY*pState->m_uOutputStride);
+	do {
+		const Word8 *pTop = pInput;
+		const Word8 *pBottom = pInput+uInputStride;
+		Word8 *pWork = pOutput;
+		Word uWidth = pState->m_uOutputWidth;
+		switch (pState->m_eType) {
+		case Burger::Image::PIXELTYPE8888:
+#if defined(BURGER_SSE2)
+			// Process 2 output pixels per pass
+			if (uWidth>=2) {
+				__m128i vZero = _mm_setzero_si128();
+				__m128i vTwo = _mm_set1_epi16(2);
+				do {
+					__m128i vTop = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pTop));
+					__m128i vBottom = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pBottom));
+					// Add the two lines in 16 bit precision
+					__m128i vLow = _mm_add_epi16(_mm_unpacklo_epi8(vTop,vZero),_mm_unpacklo_epi8(vBottom,vZero));
+					__m128i vHigh = _mm_add_epi16(_mm_unpackhi_epi8(vTop,vZero),_mm_unpackhi_epi8(vBottom,vZero));
+					// Add the left and right pixels
+					vLow = _mm_add_epi16(vLow,_mm_srli_si128(vLow,8));
+					vHigh = _mm_add_epi16(vHigh,_mm_srli_si128(vHigh,8));
+					__m128i vSum = _mm_unpacklo_epi64(vLow,vHigh);
+					vSum = _mm_srli_epi16(_mm_add_epi16(vSum,vTwo),2);
+					_mm_storel_epi64(reinterpret_cast<__m128i *>(pWork),_mm_packus_epi16(vSum,vSum));
+					pTop+=16;
+					pBottom+=16;
+					pWork+=8;
+					uWidth-=2;
+				} while (uWidth>=2);
+			}
+			if (uWidth)
+#elif defined(BURGER_NEON)
+			// Process 2 output pixels per pass
+			while (uWidth>=2) {
+				uint16x8_t vSum = vaddl_u8(vld1_u8(pTop),vld1_u8(pBottom));
+				uint16x8_t vSum2 = vaddl_u8(vld1_u8(pTop+8),vld1_u8(pBottom+8));
+				uint16x4_t vLeft = vadd_u16(vget_low_u16(vSum),vget_high_u16(vSum));
+				uint16x4_t vRight = vadd_u16(vget_low_u16(vSum2),vget_high_u16(vSum2));
+				vst1_u8(pWork,vrshrn_n_u16(vcombine_u16(vLeft,vRight),2));
+				pTop+=16;
+				pBottom+=16;
+				pWork+=8;
+				uWidth-=2;
+			}
+			if (uWidth)
+#endif
+			{
+				do {
+					pWork[0] = static_cast<Word8>((pTop[0]+pTop[4]+pBottom[0]+pBottom[4]+2U)>>2U);
+					pWork[1] = static_cast<Word8>((pTop[1]+pTop[5]+pBottom[1]+pBottom[5]+2U)>>2U);
+					pWork[2] = static_cast<Word8>((pTop[2]+pTop[6]+pBottom[2]+pBottom[6]+2U)>>2U);
+					pWork[3] = static_cast<Word8>((pTop[3]+pTop[7]+pBottom[3]+pBottom[7]+2U)>>2U);
+					pTop+=8;
+					pBottom+=8;
+					pWork+=4;
+				} while (--uWidth);
+			}
+			break;
+		case Burger::Image::PIXELTYPE888:
+			do {
+				pWork[0] = static_cast<Word8>((pTop[0]+pTop[3]+pBottom[0]+pBottom[3]+2U)>>2U);
+				pWork[1] = static_cast<Word8>((pTop[1]+pTop[4]+pBottom[1]+pBottom[4]+2U)>>2U);
+				pWork[2] = static_cast<Word8>((pTop[2]+pTop[5]+pBottom[2]+pBottom[5]+2U)>>2U);
+				pTop+=6;
+				pBottom+=6;
+				pWork+=3;
+			} while (--uWidth);
+			break;
+		default:
+		case Burger::Image::PIXELTYPE565:
+			do {
+				Word uA = reinterpret_cast<const Word16 *>(pTop)[0];
+				Word uB = reinterpret_cast<const Word16 *>(pTop)[1];
+				Word uC = reinterpret_cast<const Word16 *>(pBottom)[0];
+				Word uD = reinterpret_cast<const Word16 *>(pBottom)[1];
+				// Average each bit field
+				Word uRed = (((uA>>11U)&0x1FU)+((uB>>11U)&0x1FU)+((uC>>11U)&0x1FU)+((uD>>11U)&0x1FU)+2U)>>2U;
+				Word uGreen = (((uA>>5U)&0x3FU)+((uB>>5U)&0x3FU)+((uC>>5U)&0x3FU)+((uD>>5U)&0x3FU)+2U)>>2U;
+				Word uBlue = ((uA&0x1FU)+(uB&0x1FU)+(uC&0x1FU)+(uD&0x1FU)+2U)>>2U;
+				reinterpret_cast<Word16 *>(pWork)[0] = static_cast<Word16>((uRed<<11U)|(uGreen<<5U)|uBlue);
+				pTop+=4;
+				pBottom+=4;
+				pWork+=2;
+			} while (--uWidth);
+			break;
+		}
+		pInput += uInputStride*2;
+		pOutput += pState->m_uOutputStride;
+	} while (++uY<uYEnd);
+}
+
+/*! ************************************
+
+	\brief Test if a pixel type can be resampled
+
+	Resize(const Image *,Word,Word,eFilter) and GenerateMipMaps(eFilter)
+	only support the pixel types of \ref PIXELTYPE8888, \ref PIXELTYPE888
+	and \ref PIXELTYPE565.
+
+	\param eType Pixel type to test
+	\return \ref TRUE if the pixel type is supported, \ref FALSE if not
+	\sa Resize(const Image *,Word,Word,eFilter) or GenerateMipMaps(eFilter)
+
+***************************************/
+
+Word BURGER_API Burger::Image::IsResizable(ePixelTypes eType)
+{
+	return (eType==PIXELTYPE8888) || (eType==PIXELTYPE888) || (eType==PIXELTYPE565);
+}
+
+/*! ************************************
+
+	\brief Fill in the mip maps from the largest image
+
+	For an Image that was created with mip maps, use the top level
+	image to create each of the smaller images. Each mip map is
+	created from the mip map above it, so only the top level needs to
+	contain valid data.
+
+	\ref FILTER_BOX uses an exact integer average of each 2x2 pixel
+	block. \ref FILTER_BOXGAMMA averages in linear light, which prevents
+	fine high contrast detail from turning darker in the smaller mip maps.
+	The windowed sinc filters are slower, but retain more detail.
+
+	Large mip maps are split into bands of scan lines that are
+	processed across all available CPU cores.
+
+	\note Only \ref PIXELTYPE8888, \ref PIXELTYPE888 and \ref PIXELTYPE565 are supported.
+
+	\param eFilterType Filter to use for shrinking each level
+	\return Zero on success, non-zero if the pixel type is not supported or on out of memory
+	\sa Resize(const Image *,Word,Word,eFilter), IsResizable(ePixelTypes) or GetMipMapCount(void) const
+
+***************************************/
+
+Word Burger::Image::GenerateMipMaps(eFilter eFilterType)
+{
+	if (!m_pImage || !IsResizable(m_eType)) {
+		return 10;
+	}
+	Word uResult = 0;
+	Word uMipMaps = GetMipMapCount();
+	Word uLevel = 1;
+	while (uLevel<uMipMaps) {
+		Word uInputWidth = GetWidth(uLevel-1);
+		Word uInputHeight = GetHeight(uLevel-1);
+		Word uOutputWidth = GetWidth(uLevel);
+		Word uOutputHeight = GetHeight(uLevel);
+		// Degenerate level? Stop here.
+		if (!uOutputWidth || !uOutputHeight) {
+			break;
+		}
+		const Word8 *pInput = GetImage(uLevel-1);
+		Word8 *pOutput = const_cast<Word8 *>(GetImage(uLevel));
+		if (eFilterType==FILTER_BOX) {
+			// Use the fast integer path
+			BoxState_t State;
+			State.m_pInput = pInput;
+			State.m_pOutput = pOutput;
+			State.m_uInputStride = GetStride(uLevel-1);
+			State.m_uOutputStride = GetStride(uLevel);
+			State.m_uOutputWidth = uOutputWidth;
+			State.m_uOutputHeight = uOutputHeight;
+			State.m_eType = m_eType;
+			Word uThreads = 1;
+			if ((uOutputWidth*uOutputHeight)>=g_uResampleParallelPixels) {
+				uThreads = 0;
+			}
+			ParallelFor(BoxBand,&State,(uOutputHeight+(g_uResampleBandSize-1))/g_uResampleBandSize,uThreads);
+		} else {
+			uResult = ResampleImage(pOutput,GetStride(uLevel),uOutputWidth,uOutputHeight,
+				pInput,GetStride(uLevel-1),uInputWidth,uInputHeight,m_eType,eFilterType);
+			if (uResult) {
+				break;
+			}
+		}
+		++uLevel;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Create a resized copy of an image
+
+	Allocate a new image buffer of the requested size with the same pixel type
+	of the source image and resample the source image into it. Both
+	shrinking and enlarging is supported, and the scale factors of
+	each axis are independent.
+
+	The filter is applied as two separable passes, horizontal then
+	vertical, with the inner loops using SIMD if available. Large
+	images are processed across all available CPU cores.
+
+	\note Only \ref PIXELTYPE8888, \ref PIXELTYPE888 and \ref PIXELTYPE565 are supported.
+	Only the top level of the source image is used and no mip maps are created
+	in the new image. pInput cannot point to this Image.
+
+	\param pInput Pointer to a valid image to resize
+	\param uWidth Width of the new image in pixels
+	\param uHeight Height of the new image in pixels
+	\param eFilterType Filter to use for resampling
+	\return Zero on success, non-zero if the pixel type is not supported or on out of memory
+	\sa GenerateMipMaps(eFilter) or IsResizable(ePixelTypes)
+
+***************************************/
+
+Word Burger::Image::Resize(const Image *pInput,Word uWidth,Word uHeight,eFilter eFilterType)
+{
+	// Sanity checks
+	if ((pInput==this) || !pInput->m_pImage || !pInput->m_uWidth ||
+		!pInput->m_uHeight || !uWidth || !uHeight || !IsResizable(pInput->m_eType)) {
+		return 10;
+	}
+	Word uResult = Init(uWidth,uHeight,pInput->m_eType);
+	if (!uResult) {
+		uResult = ResampleImage(m_pImage,m_uStride,uWidth,uHeight,
+			pInput->m_pImage,pInput->m_uStride,pInput->m_uWidth,pInput->m_uHeight,m_eType,eFilterType);
+	}
+	return uResult;
+}
@@ -50,6 +50,12 @@ public:
 		PIXELTYPE1010102=31,		///< 32 bits per pixel in bytes of R:10, G:10, B:10 and A:2 in that order
 		PIXELTYPE8888=32			///< 32 bits per pixel in bytes of R:8, G:8, B:8 and A:8 in that order
 	};
+	enum eFilter {
+		FILTER_BOX,					///< Average of all covered pixels (2x2 for mip maps)
+		FILTER_BOXGAMMA,			///< Box filter performed in linear light, assumes sRGB color data
+		FILTER_KAISER,				///< Kaiser windowed sinc filter with a radius of 3 pixels
+		FILTER_LANCZOS				///< Lanczos filter with a radius of 3 pixels
+	};
 protected:
 	Word8 *m_pImage;		///< Pointer to pixel array
 	Word m_uStride;			///< Number of bytes per scan line (Likely not the same value as m_uWidth)
@@ -95,6 +101,9 @@ public:
 	void ClearBitmap(void);
 	Word VerticleFlip(void);
 	Word HorizontalFlip(void);
+	Word GenerateMipMaps(eFilter eFilterType=FILTER_BOX);
+	Word Resize(const Image *pInput,Word uWidth,Word uHeight,eFilter eFilterType=FILTER_LANCZOS);
+	static Word BURGER_API IsResizable(ePixelTypes eType);
 };
 }
 /* END */
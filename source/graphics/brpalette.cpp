@@ -13,6 +13,13 @@
 
 #include "brpalette.h"
 #include "brrenderer.h"
+#include "brglobalmemorymanager.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
 
 /*! ************************************
 
@@ -841,6 +848,156 @@ void BURGER_API Burger::Palette::Make8BitLookupTable(Word *pOutput,Burger::RezFi
 	}
 }
 
+//
+// Palette converted into separate arrays of red, green and blue
+// so the distances of several colors can be calculated at once
+// Padding entries are set to a color that's too far away to ever match
+//
+
+struct PaletteSearch_t {
+	Int16 m_Red[256+8];		// Red components
+	Int16 m_Green[256+8];	// Green components
+	Int16 m_Blue[256+8];	// Blue components
+	Word m_uCount;			// Number of valid colors
+};
+
+static void BURGER_API PaletteSearchInit(PaletteSearch_t *pOutput,const Word8 *pPalette,Word uCount)
+{
+	pOutput->m_uCount = uCount;
+	Word i = 0;
+	if (uCount) {
+		do {
+			pOutput->m_Red[i] = static_cast<Int16>(pPalette[0]);
+			pOutput->m_Green[i] = static_cast<Int16>(pPalette[1]);
+			pOutput->m_Blue[i] = static_cast<Int16>(pPalette[2]);
+			pPalette+=3;
+		} while (++i<uCount);
+	}
+	// Pad to a multiple of 8
+	do {
+		pOutput->m_Red[i] = 1024;
+		pOutput->m_Green[i] = 1024;
+		pOutput->m_Blue[i] = 1024;
+	} while (++i&7);
+}
+
+//
+// Return the index of the closest color, identical results
+// to Palette::FindColorIndex(), including which index is returned
+// if two colors are equally close.
+//
+
+static Word BURGER_API PaletteSearchFind(const PaletteSearch_t *pInput,Word uRed,Word uGreen,Word uBlue)
+{
+	Word uCount = pInput->m_uCount;
+	if (!uCount) {
+		return 0;
+	}
+#if defined(BURGER_SSE2)
+	__m128i vRed = _mm_set1_epi16(static_cast<short>(uRed));
+	__m128i vGreen = _mm_set1_epi16(static_cast<short>(uGreen));
+	__m128i vBlue = _mm_set1_epi16(static_cast<short>(uBlue));
+	__m128i vZero = _mm_setzero_si128();
+	__m128i vBest = _mm_set1_epi32(0x7FFFFFFF);
+	__m128i vBestIndex = vZero;
+	__m128i vIndex = _mm_setr_epi32(0,1,2,3);
+	__m128i vFour = _mm_set1_epi32(4);
+	Word i = 0;
+	do {
+		__m128i vDeltaRed = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&pInput->m_Red[i])),vRed);
+		__m128i vDeltaGreen = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&pInput->m_Green[i])),vGreen);
+		__m128i vDeltaBlue = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&pInput->m_Blue[i])),vBlue);
+		// Red*Red+Green*Green and Blue*Blue for 4 colors at a time
+		__m128i vTemp = _mm_unpacklo_epi16(vDeltaRed,vDeltaGreen);
+		__m128i vTemp2 = _mm_unpacklo_epi16(vDeltaBlue,vZero);
+		__m128i vDistance = _mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2));
+		__m128i vMask = _mm_cmplt_epi32(vDistance,vBest);
+		vBest = _mm_or_si128(_mm_and_si128(vMask,vDistance),_mm_andnot_si128(vMask,vBest));
+		vBestIndex = _mm_or_si128(_mm_and_si128(vMask,vIndex),_mm_andnot_si128(vMask,vBestIndex));
+		vIndex = _mm_add_epi32(vIndex,vFour);
+		vTemp = _mm_unpackhi_epi16(vDeltaRed,vDeltaGreen);
+		vTemp2 = _mm_unpackhi_epi16(vDeltaBlue,vZero);
+		vDistance = _mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2));
+		vMask = _mm_cmplt_epi32(vDistance,vBest);
+		vBest = _mm_or_si128(_mm_and_si128(vMask,vDistance),_mm_andnot_si128(vMask,vBest));
+		vBestIndex = _mm_or_si128(_mm_and_si128(vMask,vIndex),_mm_andnot_si128(vMask,vBestIndex));
+		vIndex = _mm_add_epi32(vIndex,vFour);
+		i+=8;
+	} while (i<uCount);
+	// Each lane has the closest match for its slice, find the best
+	// lane with the lowest index to break ties
+	Word32 Best[4];
+	Word32 BestIndex[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(Best),vBest);
+	_mm_storeu_si128(reinterpret_cast<__m128i *>(BestIndex),vBestIndex);
+	Word uResult = BestIndex[0];
+	Word32 uClosestDist = Best[0];
+	i = 1;
+	do {
+		if ((Best[i]<uClosestDist) || ((Best[i]==uClosestDist) && (BestIndex[i]<uResult))) {
+			uClosestDist = Best[i];
+			uResult = BestIndex[i];
+		}
+	} while (++i<4);
+	return uResult;
+#elif defined(BURGER_NEON)
+	int16x4_t vRed = vdup_n_s16(static_cast<int16_t>(uRed));
+	int16x4_t vGreen = vdup_n_s16(static_cast<int16_t>(uGreen));
+	int16x4_t vBlue = vdup_n_s16(static_cast<int16_t>(uBlue));
+	int32x4_t vBest = vdupq_n_s32(0x7FFFFFFF);
+	uint32x4_t vBestIndex = vdupq_n_u32(0);
+	static const Word32 IndexStart[4] = {0,1,2,3};
+	uint32x4_t vIndex = vld1q_u32(IndexStart);
+	uint32x4_t vFour = vdupq_n_u32(4);
+	Word i = 0;
+	do {
+		int16x4_t vDeltaRed = vsub_s16(vld1_s16(&pInput->m_Red[i]),vRed);
+		int16x4_t vDeltaGreen = vsub_s16(vld1_s16(&pInput->m_Green[i]),vGreen);
+		int16x4_t vDeltaBlue = vsub_s16(vld1_s16(&pInput->m_Blue[i]),vBlue);
+		int32x4_t vDistance = vmlal_s16(vmlal_s16(vmull_s16(vDeltaRed,vDeltaRed),vDeltaGreen,vDeltaGreen),vDeltaBlue,vDeltaBlue);
+		uint32x4_t vMask = vcltq_s32(vDistance,vBest);
+		vBest = vbslq_s32(vMask,vDistance,vBest);
+		vBestIndex = vbslq_u32(vMask,vIndex,vBestIndex);
+		vIndex = vaddq_u32(vIndex,vFour);
+		i+=4;
+	} while (i<uCount);
+	Int32 Best[4];
+	Word32 BestIndex[4];
+	vst1q_s32(Best,vBest);
+	vst1q_u32(BestIndex,vBestIndex);
+	Word uResult = BestIndex[0];
+	Int32 iClosestDist = Best[0];
+	i = 1;
+	do {
+		if ((Best[i]<iClosestDist) || ((Best[i]==iClosestDist) && (BestIndex[i]<uResult))) {
+			iClosestDist = Best[i];
+			uResult = BestIndex[i];
+		}
+	} while (++i<4);
+	return uResult;
+#else
+	Word uClosestIndex = 0;
+	Word32 uClosestDist = BURGER_MAXUINT;
+	uRed=uRed+255;
+	uGreen=uGreen+255;
+	uBlue=uBlue+255;
+	Word i = 0;
+	do {
+		Word uNewDelta = Burger::Renderer::ByteSquareTable[uRed-pInput->m_Red[i]]+
+			Burger::Renderer::ByteSquareTable[uGreen-pInput->m_Green[i]]+
+			Burger::Renderer::ByteSquareTable[uBlue-pInput->m_Blue[i]];
+		if (uNewDelta < uClosestDist) {
+			uClosestIndex = i;
+			if (!uNewDelta) {
+				break;
+			}
+			uClosestDist = uNewDelta;
+		}
+	} while (++i<uCount);
+	return uClosestIndex;
+#endif
+}
+
 /*! ************************************
 
 	\brief Create an 8 bit remap table
@@ -851,6 +1008,9 @@ void BURGER_API Burger::Palette::Make8BitLookupTable(Word *pOutput,Burger::RezFi
 	The returned data will allow you to quickly color map a 256 color
 	image onto any palette.
 
+	The destination palette is converted only once and is searched
+	with SIMD instructions on platforms that support it.
+
 	\param pOutput Pointer to an array of 256 bytes
 	\param pNewPalette Pointer to a palette of 256 colors (768 bytes) to map to
 	\param pOldPalette Pointer to the palette of the shape (768 bytes) to map from
@@ -860,10 +1020,11 @@ void BURGER_API Burger::Palette::Make8BitLookupTable(Word *pOutput,Burger::RezFi
 
 void BURGER_API Burger::Palette::MakeRemapLookup(Word8 *pOutput,const Word8 *pNewPalette,const Word8 *pOldPalette)
 {
-	pNewPalette+=3;
+	PaletteSearch_t Search;
+	PaletteSearchInit(&Search,pNewPalette+3,254);
 	Word i = 256;
 	do {
-		pOutput[0] = static_cast<Word8>(FindColorIndex(pNewPalette,pOldPalette[0],pOldPalette[1],pOldPalette[2],254)+1);
+		pOutput[0] = static_cast<Word8>(PaletteSearchFind(&Search,pOldPalette[0],pOldPalette[1],pOldPalette[2])+1);
 		++pOutput;
 		pOldPalette += 3;
 	} while (--i);		// All 256 colors done?
@@ -891,13 +1052,14 @@ void BURGER_API Burger::Palette::MakeRemapLookup(Word8 *pOutput,const Word8 *pNe
 
 void BURGER_API Burger::Palette::MakeRemapLookupMasked(Word8 *pOutput,const Word8 *pNewPalette,const Word8 *pOldPalette)
 {
-	pNewPalette+=3;
+	PaletteSearch_t Search;
+	PaletteSearchInit(&Search,pNewPalette+3,254);
 	pOldPalette+=3;		// Skip the first color
 	Word i = 255;
 	pOutput[0] = 0;
 	++pOutput;
 	do {
-		pOutput[0] = static_cast<Word8>(FindColorIndex(pNewPalette,pOldPalette[0],pOldPalette[1],pOldPalette[2],254)+1);
+		pOutput[0] = static_cast<Word8>(PaletteSearchFind(&Search,pOldPalette[0],pOldPalette[1],pOldPalette[2])+1);
 		++pOutput;
 		pOldPalette += 3;
 	} while (--i);		// All 256 colors done?
@@ -1086,4 +1248,732 @@ void BURGER_API Burger::CopyPalette(RGBAWord8_t *pOutput,const RGBWord8_t *pInpu
 	\param uEntries Number of color entries in the palette
 	\sa Burger::CopyPalette(RGBAWord8_t *,const RGBWord8_t *,Word)
 
-***************************************/
\ No newline at end of file
+***************************************/
+/*! ************************************
+
+	\enum Burger::Palette::eDither
+	\brief Dithering modes for converting true color images
+
+	When a true color image is converted to an 8 bit image,
+	dithering can be applied to hide the banding caused
+	by having fewer colors.
+
+	\sa Quantize() or RemapImage()
+
+***************************************/
+
+//
+// Number of bits per color component in the quantizer histogram
+//
+
+static const Word g_uQuantizeBits = 5;
+static const Word g_uQuantizeSize = 1U<<g_uQuantizeBits;
+
+//
+// Color totals for a single histogram entry
+//
+
+struct QuantizeBin_t {
+	Word64 m_uCount;		// Number of pixels of this color
+	Word64 m_uRed;			// Sum of all red values
+	Word64 m_uGreen;		// Sum of all green values
+	Word64 m_uBlue;			// Sum of all blue values
+};
+
+//
+// Box in histogram space for median cut
+//
+
+struct QuantizeBox_t {
+	Word m_uMin[3];			// Lowest histogram index for red, green and blue (Inclusive)
+	Word m_uMax[3];			// Highest histogram index for red, green and blue (Inclusive)
+	Word64 m_uPopulation;	// Number of pixels in the box
+};
+
+/***************************************
+
+	Return the histogram entry for a color
+
+***************************************/
+
+static BURGER_INLINE QuantizeBin_t *QuantizeGetBin(QuantizeBin_t *pHistogram,Word uRed,Word uGreen,Word uBlue)
+{
+	return &pHistogram[(((uRed<<g_uQuantizeBits)+uGreen)<<g_uQuantizeBits)+uBlue];
+}
+
+/***************************************
+
+	Shrink a median cut box so it tightly encloses
+	all the used colors in the histogram
+
+***************************************/
+
+static void BURGER_API QuantizeShrinkBox(QuantizeBox_t *pBox,QuantizeBin_t *pHistogram)
+{
+	Word uMin[3] = {g_uQuantizeSize,g_uQuantizeSize,g_uQuantizeSize};
+	Word uMax[3] = {0,0,0};
+	Word64 uPopulation = 0;
+	Word uRed = pBox->m_uMin[0];
+	do {
+		Word uGreen = pBox->m_uMin[1];
+		do {
+			const QuantizeBin_t *pBin = QuantizeGetBin(pHistogram,uRed,uGreen,pBox->m_uMin[2]);
+			Word uBlue = pBox->m_uMin[2];
+			do {
+				if (pBin->m_uCount) {
+					uPopulation += pBin->m_uCount;
+					if (uRed<uMin[0]) {
+						uMin[0] = uRed;
+					}
+					if (uRed>uMax[0]) {
+						uMax[0] = uRed;
+					}
+					if (uGreen<uMin[1]) {
+						uMin[1] = uGreen;
+					}
+					if (uGreen>uMax[1]) {
+						uMax[1] = uGreen;
+					}
+					if (uBlue<uMin[2]) {
+						uMin[2] = uBlue;
+					}
+					if (uBlue>uMax[2]) {
+						uMax[2] = uBlue;
+					}
+				}
+				++pBin;
+			} while (++uBlue<=pBox->m_uMax[2]);
+		} while (++uGreen<=pBox->m_uMax[1]);
+	} while (++uRed<=pBox->m_uMax[0]);
+	pBox->m_uPopulation = uPopulation;
+	if (uPopulation) {
+		pBox->m_uMin[0] = uMin[0];
+		pBox->m_uMin[1] = uMin[1];
+		pBox->m_uMin[2] = uMin[2];
+		pBox->m_uMax[0] = uMax[0];
+		pBox->m_uMax[1] = uMax[1];
+		pBox->m_uMax[2] = uMax[2];
+	}
+}
+
+/***************************************
+
+	Split a median cut box at the median of its longest axis
+
+***************************************/
+
+static void BURGER_API QuantizeSplitBox(QuantizeBox_t *pBox,QuantizeBox_t *pNewBox,QuantizeBin_t *pHistogram)
+{
+	// Find the longest axis
+	Word uAxis = 1;		// Favor green on a tie since the eye is most sensitive to it
+	Word uLength = pBox->m_uMax[1]-pBox->m_uMin[1];
+	if ((pBox->m_uMax[0]-pBox->m_uMin[0])>uLength) {
+		uAxis = 0;
+		uLength = pBox->m_uMax[0]-pBox->m_uMin[0];
+	}
+	if ((pBox->m_uMax[2]-pBox->m_uMin[2])>uLength) {
+		uAxis = 2;
+	}
+
+	// Total the population of every slice along the axis
+	Word64 Slices[g_uQuantizeSize];
+	Burger::MemoryClear(Slices,sizeof(Slices));
+	Word uRed = pBox->m_uMin[0];
+	do {
+		Word uGreen = pBox->m_uMin[1];
+		do {
+			const QuantizeBin_t *pBin = QuantizeGetBin(pHistogram,uRed,uGreen,pBox->m_uMin[2]);
+			Word uBlue = pBox->m_uMin[2];
+			do {
+				Word uIndex = (uAxis==0) ? uRed : ((uAxis==1) ? uGreen : uBlue);
+				Slices[uIndex] += pBin->m_uCount;
+				++pBin;
+			} while (++uBlue<=pBox->m_uMax[2]);
+		} while (++uGreen<=pBox->m_uMax[1]);
+	} while (++uRed<=pBox->m_uMax[0]);
+
+	// Find the median, the last slice must go into the new box
+	Word64 uHalf = pBox->m_uPopulation>>1U;
+	Word64 uTotal = 0;
+	Word uSplit = pBox->m_uMin[uAxis];
+	Word uLast = pBox->m_uMax[uAxis]-1;
+	do {
+		uTotal += Slices[uSplit];
+		if (uTotal>=uHalf) {
+			break;
+		}
+	} while (++uSplit<uLast);
+
+	// Create the two boxes
+	pNewBox[0] = pBox[0];
+	pBox->m_uMax[uAxis] = uSplit;
+	pNewBox->m_uMin[uAxis] = uSplit+1;
+	QuantizeShrinkBox(pBox,pHistogram);
+	QuantizeShrinkBox(pNewBox,pHistogram);
+}
+
+/*! ************************************
+
+	\brief Convert a true color image into an 8 bit image
+
+	Using the median cut algorithm, create a palette that best
+	represents the colors in the true color image and then
+	create an 8 bit image with optional dithering using the
+	new palette.
+
+	Unused palette entries are set to black. The alpha value of every
+	palette entry is set to 255 and the alpha channel of the source image is ignored.
+
+	\note Only \ref Image::PIXELTYPE8888 and \ref Image::PIXELTYPE888 source images are supported.
+
+	\param pOutput Pointer to the Image to receive the \ref Image::PIXELTYPE8BIT image
+	\param pPalette Pointer to a 256 entry palette to receive the new colors
+	\param pInput Pointer to the true color image to convert
+	\param uColors Maximum number of colors to use in the new palette (1-256)
+	\param eDitherType Type of dithering to apply to the new image
+	\return Zero on success, non-zero on unsupported pixel type or out of memory
+	\sa RemapImage() or InverseColorTable
+
+***************************************/
+
+Word BURGER_API Burger::Palette::Quantize(Image *pOutput,RGBAWord8_t *pPalette,const Image *pInput,Word uColors,eDither eDitherType)
+{
+	Image::ePixelTypes eType = pInput->GetType();
+	if ((pOutput==pInput) || !uColors || (uColors>256) ||
+		((eType!=Image::PIXELTYPE8888) && (eType!=Image::PIXELTYPE888))) {
+		return 10;
+	}
+	QuantizeBin_t *pHistogram = static_cast<QuantizeBin_t *>(AllocClear(sizeof(QuantizeBin_t)*g_uQuantizeSize*g_uQuantizeSize*g_uQuantizeSize));
+	if (!pHistogram) {
+		return 10;
+	}
+
+	// Create the histogram
+	Word uWidth = pInput->GetWidth();
+	Word uHeight = pInput->GetHeight();
+	Word uPixelSize = (eType==Image::PIXELTYPE8888) ? 4U : 3U;
+	const Word8 *pLine = pInput->GetImage();
+	Word y = 0;
+	if (uWidth) {
+		while (y<uHeight) {
+			const Word8 *pWork = pLine;
+			Word x = uWidth;
+			do {
+				Word uRed = pWork[0];
+				Word uGreen = pWork[1];
+				Word uBlue = pWork[2];
+				QuantizeBin_t *pBin = QuantizeGetBin(pHistogram,uRed>>(8-g_uQuantizeBits),uGreen>>(8-g_uQuantizeBits),uBlue>>(8-g_uQuantizeBits));
+				++pBin->m_uCount;
+				pBin->m_uRed += uRed;
+				pBin->m_uGreen += uGreen;
+				pBin->m_uBlue += uBlue;
+				pWork += uPixelSize;
+			} while (--x);
+			pLine += pInput->GetStride();
+			++y;
+		}
+	}
+
+	// Median cut, start with a box that covers everything
+	QuantizeBox_t Boxes[256];
+	Boxes[0].m_uMin[0] = 0;
+	Boxes[0].m_uMin[1] = 0;
+	Boxes[0].m_uMin[2] = 0;
+	Boxes[0].m_uMax[0] = g_uQuantizeSize-1;
+	Boxes[0].m_uMax[1] = g_uQuantizeSize-1;
+	Boxes[0].m_uMax[2] = g_uQuantizeSize-1;
+	QuantizeShrinkBox(&Boxes[0],pHistogram);
+	Word uBoxCount = 1;
+	if (Boxes[0].m_uPopulation) {
+		while (uBoxCount<uColors) {
+			// Split the box with the most pixels spread over the largest range
+			Word uBest = BURGER_MAXUINT;
+			Word64 uBestScore = 0;
+			Word i = 0;
+			do {
+				const QuantizeBox_t *pBox = &Boxes[i];
+				Word uLength = pBox->m_uMax[0]-pBox->m_uMin[0];
+				if ((pBox->m_uMax[1]-pBox->m_uMin[1])>uLength) {
+					uLength = pBox->m_uMax[1]-pBox->m_uMin[1];
+				}
+				if ((pBox->m_uMax[2]-pBox->m_uMin[2])>uLength) {
+					uLength = pBox->m_uMax[2]-pBox->m_uMin[2];
+				}
+				// Boxes of a single color can't be split
+				if (uLength) {
+					Word64 uScore = pBox->m_uPopulation*uLength;
+					if (uScore>uBestScore) {
+						uBestScore = uScore;
+						uBest = i;
+					}
+				}
+			} while (++i<uBoxCount);
+			if (uBest==BURGER_MAXUINT) {
+				break;
+			}
+			QuantizeSplitBox(&Boxes[uBest],&Boxes[uBoxCount],pHistogram);
+			++uBoxCount;
+		}
+	}
+
+	// Create the palette from the average color of each box
+	MemoryClear(pPalette,sizeof(RGBAWord8_t)*256);
+	Word i = 0;
+	do {
+		const QuantizeBox_t *pBox = &Boxes[i];
+		Word64 uRed = 0;
+		Word64 uGreen = 0;
+		Word64 uBlue = 0;
+		Word uR = pBox->m_uMin[0];
+		if (pBox->m_uPopulation) {
+			do {
+				Word uG = pBox->m_uMin[1];
+				do {
+					const QuantizeBin_t *pBin = QuantizeGetBin(pHistogram,uR,uG,pBox->m_uMin[2]);
+					Word uB = pBox->m_uMin[2];
+					do {
+						uRed += pBin->m_uRed;
+						uGreen += pBin->m_uGreen;
+						uBlue += pBin->m_uBlue;
+						++pBin;
+					} while (++uB<=pBox->m_uMax[2]);
+				} while (++uG<=pBox->m_uMax[1]);
+			} while (++uR<=pBox->m_uMax[0]);
+			Word64 uHalf = pBox->m_uPopulation>>1U;
+			pPalette[i].m_uRed = static_cast<Word8>((uRed+uHalf)/pBox->m_uPopulation);
+			pPalette[i].m_uGreen = static_cast<Word8>((uGreen+uHalf)/pBox->m_uPopulation);
+			pPalette[i].m_uBlue = static_cast<Word8>((uBlue+uHalf)/pBox->m_uPopulation);
+		}
+		pPalette[i].m_uAlpha = 255;
+	} while (++i<uBoxCount);
+	// Unused entries are black, but still opaque
+	while (i<256) {
+		pPalette[i].m_uAlpha = 255;
+		++i;
+	}
+	Free(pHistogram);
+
+	// Convert the image
+	return RemapImage(pOutput,pInput,pPalette,uBoxCount,eDitherType);
+}
+
+/*! ************************************
+
+	\brief Convert a true color image into an 8 bit image using a supplied palette
+
+	Create an 8 bit image by finding the closest palette color
+	for every pixel in the true color image. If dithering is requested,
+	\ref DITHER_ORDERED will add a 4x4 Bayer pattern to each pixel before
+	the lookup and \ref DITHER_ERRORDIFFUSION will spread the difference
+	between the pixel and the chosen color to the neighboring pixels
+	with the Floyd-Steinberg weights in a serpentine order.
+
+	The color lookups use an InverseColorTable so the cost per pixel
+	does not depend on the number of colors in the palette.
+
+	\note Only \ref Image::PIXELTYPE8888 and \ref Image::PIXELTYPE888 source images are supported.
+
+	\param pOutput Pointer to the Image to receive the \ref Image::PIXELTYPE8BIT image
+	\param pInput Pointer to the true color image to convert
+	\param pPalette Pointer to the palette to map to
+	\param uColors Number of colors in the palette (1-256)
+	\param eDitherType Type of dithering to apply to the new image
+	\return Zero on success, non-zero on unsupported pixel type or out of memory
+	\sa Quantize() or InverseColorTable
+
+***************************************/
+
+Word BURGER_API Burger::Palette::RemapImage(Image *pOutput,const Image *pInput,const RGBAWord8_t *pPalette,Word uColors,eDither eDitherType)
+{
+	Image::ePixelTypes eType = pInput->GetType();
+	if ((pOutput==pInput) || !uColors || (uColors>256) ||
+		((eType!=Image::PIXELTYPE8888) && (eType!=Image::PIXELTYPE888))) {
+		return 10;
+	}
+	Word uWidth = pInput->GetWidth();
+	Word uHeight = pInput->GetHeight();
+	InverseColorTable *pTable = New<InverseColorTable>();
+	if (!pTable) {
+		return 10;
+	}
+	Word uResult = pTable->Init(pPalette,uColors);
+	if (!uResult) {
+		uResult = pOutput->Init(uWidth,uHeight,Image::PIXELTYPE8BIT);
+	}
+	Int *pErrors = NULL;
+	if (!uResult && uWidth && uHeight && (eDitherType==DITHER_ERRORDIFFUSION)) {
+		// Two scan lines of errors with a pixel of padding on each side
+		pErrors = static_cast<Int *>(AllocClear(sizeof(Int)*3*2*(uWidth+2)));
+		if (!pErrors) {
+			uResult = 10;
+		}
+	}
+	if (!uResult && uWidth && uHeight) {
+		Word uPixelSize = (eType==Image::PIXELTYPE8888) ? 4U : 3U;
+		const Word8 *pInputLine = pInput->GetImage();
+		Word8 *pOutputLine = pOutput->GetImage();
+		Word y = 0;
+		do {
+			const Word8 *pWork = pInputLine;
+			Word8 *pDest = pOutputLine;
+			switch (eDitherType) {
+			default:
+			case DITHER_NONE:
+				{
+					Word x = uWidth;
+					do {
+						pDest[0] = static_cast<Word8>(pTable->FindColorIndex(pWork[0],pWork[1],pWork[2]));
+						pWork += uPixelSize;
+						++pDest;
+					} while (--x);
+				}
+				break;
+			case DITHER_ORDERED:
+				{
+					// 4x4 Bayer matrix, centered around zero
+					static const Int OrderedTable[4][4] = {
+						{-15,  1,-11,  5},
+						{  9, -7, 13, -3},
+						{ -9,  7,-13,  3},
+						{ 15, -1, 11, -5}
+					};
+					const Int *pRow = OrderedTable[y&3];
+					Word x = 0;
+					do {
+						Int iOffset = pRow[x&3];
+						Int iRed = static_cast<Int>(pWork[0])+iOffset;
+						Int iGreen = static_cast<Int>(pWork[1])+iOffset;
+						Int iBlue = static_cast<Int>(pWork[2])+iOffset;
+						iRed = (iRed<0) ? 0 : ((iRed>255) ? 255 : iRed);
+						iGreen = (iGreen<0) ? 0 : ((iGreen>255) ? 255 : iGreen);
+						iBlue = (iBlue<0) ? 0 : ((iBlue>255) ? 255 : iBlue);
+						pDest[0] = static_cast<Word8>(pTable->FindColorIndex(static_cast<Word>(iRed),static_cast<Word>(iGreen),static_cast<Word>(iBlue)));
+						pWork += uPixelSize;
+						++pDest;
+					} while (++x<uWidth);
+				}
+				break;
+			case DITHER_ERRORDIFFUSION:
+				{
+					// Swap between the two error lines on each scan line
+					Int *pCurrent = pErrors+((y&1) ? (3*(uWidth+2)) : 0);
+					Int *pNext = pErrors+((y&1) ? 0 : (3*(uWidth+2)));
+					MemoryClear(pNext,sizeof(Int)*3*(uWidth+2));
+					// Serpentine, go right to left on odd lines
+					IntPtr iStep = 1;
+					Word x = 0;
+					if (y&1) {
+						iStep = -1;
+						x = uWidth-1;
+					}
+					Word i = uWidth;
+					do {
+						const Word8 *pPixel = pWork+(x*uPixelSize);
+						Int *pError = pCurrent+((x+1)*3);
+						Int *pBelow = pNext+((x+1)*3);
+						Word uIndex = 0;
+						Int Values[3];
+						Word j = 0;
+						do {
+							// Errors are in 1/16ths
+							Int iValue = static_cast<Int>(pPixel[j])+((pError[j]+8)>>4);
+							Values[j] = (iValue<0) ? 0 : ((iValue>255) ? 255 : iValue);
+						} while (++j<3);
+						uIndex = pTable->FindColorIndex(static_cast<Word>(Values[0]),static_cast<Word>(Values[1]),static_cast<Word>(Values[2]));
+						pDest[x] = static_cast<Word8>(uIndex);
+						const Word8 *pColor = &pPalette[uIndex].m_uRed;
+						j = 0;
+						do {
+							Int iError = Values[j]-static_cast<Int>(pColor[j]);
+							pError[(iStep*3)+static_cast<IntPtr>(j)] += iError*7;
+							pBelow[(-iStep*3)+static_cast<IntPtr>(j)] += iError*3;
+							pBelow[j] += iError*5;
+							pBelow[(iStep*3)+static_cast<IntPtr>(j)] += iError;
+						} while (++j<3);
+						x = static_cast<Word>(static_cast<IntPtr>(x)+iStep);
+					} while (--i);
+				}
+				break;
+			}
+			pInputLine += pInput->GetStride();
+			pOutputLine += pOutput->GetStride();
+		} while (++y<uHeight);
+	}
+	Free(pErrors);
+	Delete(pTable);
+	return uResult;
+}
+
+/*! ************************************
+
+	\class Burger::InverseColorTable
+	\brief Fast closest color lookup for a palette
+
+	Palette::FindColorIndex() checks every color in a palette for every
+	lookup, which is too slow for converting whole images. This class
+	divides the RGB color cube into 4096 cells and for each cell, only
+	the palette colors that could possibly be the closest match for any color
+	within that cell are kept. A lookup only checks the few colors
+	associated with the cell the color is in.
+
+	The results are identical to Palette::FindColorIndex(), including
+	returning the lowest index when two colors are equally close.
+
+	\sa Palette::FindColorIndex() or Palette::RemapImage()
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor
+
+	Create an empty table. FindColorIndex() will return zero until
+	Init() is called.
+
+	\sa Init(const Word8 *,Word)
+
+***************************************/
+
+Burger::InverseColorTable::InverseColorTable() :
+	m_pCandidates(NULL),
+	m_uCount(0)
+{
+}
+
+/*! ************************************
+
+	\brief Default destructor
+
+	Release all memory
+
+	\sa Shutdown()
+
+***************************************/
+
+Burger::InverseColorTable::~InverseColorTable()
+{
+	Shutdown();
+}
+
+/*! ************************************
+
+	\brief Create the lookup table for a palette
+
+	Make a copy of the palette and create the list of possible
+	closest colors for each cell in the color cube.
+
+	\param pPalette Pointer to an array of RGB triplets
+	\param uCount Number of colors in the palette (1-256)
+	\return Zero on success, non-zero on bad input or out of memory
+	\sa Init(const RGBAWord8_t *,Word) or FindColorIndex()
+
+***************************************/
+
+Word Burger::InverseColorTable::Init(const Word8 *pPalette,Word uCount)
+{
+	Shutdown();
+	if (!uCount || (uCount>256)) {
+		return 10;
+	}
+	// Worst case is every color is a candidate for every cell
+	Word8 *pCandidates = static_cast<Word8 *>(Alloc(uCount*CELLCOUNT));
+	if (!pCandidates) {
+		return 10;
+	}
+	MemoryCopy(m_Palette,pPalette,uCount*3);
+	m_uCount = uCount;
+
+	PaletteSearch_t Search;
+	PaletteSearchInit(&Search,pPalette,uCount);
+	Int32 MinDistances[256+8];
+	Int32 MaxDistances[256+8];
+
+	Word32 uOffset = 0;
+	Word uCell = 0;
+	do {
+		// Bounds of this cell
+		Int iRedLow = static_cast<Int>((uCell>>(CELLBITS*2))<<CELLSHIFT);
+		Int iGreenLow = static_cast<Int>(((uCell>>CELLBITS)&((1<<CELLBITS)-1))<<CELLSHIFT);
+		Int iBlueLow = static_cast<Int>((uCell&((1<<CELLBITS)-1))<<CELLSHIFT);
+		const Int iSize = (1<<CELLSHIFT)-1;
+
+		// For each color, get the nearest and farthest distance to any point in the cell
+#if defined(BURGER_SSE2)
+		__m128i vZero = _mm_setzero_si128();
+		__m128i vRedLow = _mm_set1_epi16(static_cast<short>(iRedLow));
+		__m128i vRedHigh = _mm_set1_epi16(static_cast<short>(iRedLow+iSize));
+		__m128i vGreenLow = _mm_set1_epi16(static_cast<short>(iGreenLow));
+		__m128i vGreenHigh = _mm_set1_epi16(static_cast<short>(iGreenLow+iSize));
+		__m128i vBlueLow = _mm_set1_epi16(static_cast<short>(iBlueLow));
+		__m128i vBlueHigh = _mm_set1_epi16(static_cast<short>(iBlueLow+iSize));
+		Word i = 0;
+		do {
+			__m128i vRed = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Search.m_Red[i]));
+			__m128i vGreen = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Search.m_Green[i]));
+			__m128i vBlue = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&Search.m_Blue[i]));
+			__m128i vMinRed = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(vRedLow,vRed),_mm_sub_epi16(vRed,vRedHigh)),vZero);
+			__m128i vMinGreen = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(vGreenLow,vGreen),_mm_sub_epi16(vGreen,vGreenHigh)),vZero);
+			__m128i vMinBlue = _mm_max_epi16(_mm_max_epi16(_mm_sub_epi16(vBlueLow,vBlue),_mm_sub_epi16(vBlue,vBlueHigh)),vZero);
+			__m128i vMaxRed = _mm_max_epi16(_mm_sub_epi16(vRed,vRedLow),_mm_sub_epi16(vRedHigh,vRed));
+			__m128i vMaxGreen = _mm_max_epi16(_mm_sub_epi16(vGreen,vGreenLow),_mm_sub_epi16(vGreenHigh,vGreen));
+			__m128i vMaxBlue = _mm_max_epi16(_mm_sub_epi16(vBlue,vBlueLow),_mm_sub_epi16(vBlueHigh,vBlue));
+			__m128i vTemp = _mm_unpacklo_epi16(vMinRed,vMinGreen);
+			__m128i vTemp2 = _mm_unpacklo_epi16(vMinBlue,vZero);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&MinDistances[i]),_mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2)));
+			vTemp = _mm_unpackhi_epi16(vMinRed,vMinGreen);
+			vTemp2 = _mm_unpackhi_epi16(vMinBlue,vZero);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&MinDistances[i+4]),_mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2)));
+			vTemp = _mm_unpacklo_epi16(vMaxRed,vMaxGreen);
+			vTemp2 = _mm_unpacklo_epi16(vMaxBlue,vZero);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&MaxDistances[i]),_mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2)));
+			vTemp = _mm_unpackhi_epi16(vMaxRed,vMaxGreen);
+			vTemp2 = _mm_unpackhi_epi16(vMaxBlue,vZero);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(&MaxDistances[i+4]),_mm_add_epi32(_mm_madd_epi16(vTemp,vTemp),_mm_madd_epi16(vTemp2,vTemp2)));
+			i+=8;
+		} while (i<uCount);
+#else
+		Word i = 0;
+		do {
+			Int iRed = Search.m_Red[i];
+			Int iGreen = Search.m_Green[i];
+			Int iBlue = Search.m_Blue[i];
+			Int iMinRed = (iRed<iRedLow) ? (iRedLow-iRed) : ((iRed>(iRedLow+iSize)) ? (iRed-(iRedLow+iSize)) : 0);
+			Int iMinGreen = (iGreen<iGreenLow) ? (iGreenLow-iGreen) : ((iGreen>(iGreenLow+iSize)) ? (iGreen-(iGreenLow+iSize)) : 0);
+			Int iMinBlue = (iBlue<iBlueLow) ? (iBlueLow-iBlue) : ((iBlue>(iBlueLow+iSize)) ? (iBlue-(iBlueLow+iSize)) : 0);
+			Int iMaxRed = ((iRed-iRedLow)>(iRedLow+iSize-iRed)) ? (iRed-iRedLow) : (iRedLow+iSize-iRed);
+			Int iMaxGreen = ((iGreen-iGreenLow)>(iGreenLow+iSize-iGreen)) ? (iGreen-iGreenLow) : (iGreenLow+iSize-iGreen);
+			Int iMaxBlue = ((iBlue-iBlueLow)>(iBlueLow+iSize-iBlue)) ? (iBlue-iBlueLow) : (iBlueLow+iSize-iBlue);
+			MinDistances[i] = (iMinRed*iMinRed)+(iMinGreen*iMinGreen)+(iMinBlue*iMinBlue);
+			MaxDistances[i] = (iMaxRed*iMaxRed)+(iMaxGreen*iMaxGreen)+(iMaxBlue*iMaxBlue);
+		} while (++i<uCount);
+#endif
+		// Any color that can be closer than the best worst case is a candidate
+		Int32 iThreshold = MaxDistances[0];
+		i = 1;
+		if (uCount>1) {
+			do {
+				if (MaxDistances[i]<iThreshold) {
+					iThreshold = MaxDistances[i];
+				}
+			} while (++i<uCount);
+		}
+		m_CellIndexes[uCell] = uOffset;
+		i = 0;
+		do {
+			if (MinDistances[i]<=iThreshold) {
+				pCandidates[uOffset] = static_cast<Word8>(i);
+				++uOffset;
+			}
+		} while (++i<uCount);
+	} while (++uCell<CELLCOUNT);
+	m_CellIndexes[CELLCOUNT] = uOffset;
+
+	// Release the unused memory
+	m_pCandidates = static_cast<Word8 *>(Realloc(pCandidates,uOffset));
+	if (!m_pCandidates) {
+		m_pCandidates = pCandidates;
+	}
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Create the lookup table for a palette
+
+	Make a copy of the palette and create the list of possible
+	closest colors for each cell in the color cube. The alpha value
+	of each color is ignored.
+
+	\param pPalette Pointer to an array of RGBAWord8_t colors
+	\param uCount Number of colors in the palette (1-256)
+	\return Zero on success, non-zero on bad input or out of memory
+	\sa Init(const Word8 *,Word) or FindColorIndex()
+
+***************************************/
+
+Word Burger::InverseColorTable::Init(const RGBAWord8_t *pPalette,Word uCount)
+{
+	if (!uCount || (uCount>256)) {
+		Shutdown();
+		return 10;
+	}
+	Word8 Palette[256*3];
+	CopyPalette(reinterpret_cast<RGBWord8_t *>(Palette),pPalette,uCount);
+	return Init(Palette,uCount);
+}
+
+/*! ************************************
+
+	\brief Release the lookup table
+
+	Release all allocated memory. FindColorIndex() will return zero until
+	Init() is called again.
+
+	\sa Init(const Word8 *,Word)
+
+***************************************/
+
+void Burger::InverseColorTable::Shutdown(void)
+{
+	Free(m_pCandidates);
+	m_pCandidates = NULL;
+	m_uCount = 0;
+}
+
+/*! ************************************
+
+	\fn Word Burger::InverseColorTable::GetCount(void) const
+	\brief Return the number of colors in the palette
+
+	\return Number of colors in the palette, zero if not initialized
+	\sa Init(const Word8 *,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Lookup a color in the palette
+
+	Given an 8 bit red, green and blue value,
+	return the palette index that is the closest match.
+
+	\param uRed Red value (0-255)
+	\param uGreen Green value (0-255)
+	\param uBlue Blue value (0-255)
+	\return Color index that is the closest match. (0-(GetCount()-1))
+	\sa Palette::FindColorIndex()
+
+***************************************/
+
+Word Burger::InverseColorTable::FindColorIndex(Word uRed,Word uGreen,Word uBlue) const
+{
+	Word uClosestIndex = 0;
+	if (m_pCandidates) {
+		Word uCell = ((((uRed>>CELLSHIFT)<<CELLBITS)+(uGreen>>CELLSHIFT))<<CELLBITS)+(uBlue>>CELLSHIFT);
+		const Word8 *pCandidates = m_pCandidates+m_CellIndexes[uCell];
+		Word uCount = m_CellIndexes[uCell+1]-m_CellIndexes[uCell];
+		uClosestIndex = pCandidates[0];
+		if (uCount>1) {
+			Word32 uClosestDist = BURGER_MAXUINT;
+			uRed=uRed+255;
+			uGreen=uGreen+255;
+			uBlue=uBlue+255;
+			do {
+				Word uIndex = pCandidates[0];
+				const Word8 *pColor = &m_Palette[uIndex*3];
+				Word uNewDelta = Renderer::ByteSquareTable[uRed-pColor[0]]+
+					Renderer::ByteSquareTable[uGreen-pColor[1]]+
+					Renderer::ByteSquareTable[uBlue-pColor[2]];
+				if (uNewDelta < uClosestDist) {
+					uClosestIndex = uIndex;
+					if (!uNewDelta) {
+						break;
+					}
+					uClosestDist = uNewDelta;
+				}
+				++pCandidates;
+			} while (--uCount);
+		}
+	}
+	return uClosestIndex;
+}
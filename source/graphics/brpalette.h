@@ -22,6 +22,10 @@
 #include "brdisplay.h"
 #endif
 
+#ifndef __BRIMAGE_H__
+#include "brimage.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 struct RGBWord8_t {
@@ -131,6 +135,11 @@ public:
 		Word8 m_uCount;			///< Number of entries
 		RGBWord8_t Colors[1];	///< Actual data to set
 	};
+	enum eDither {
+		DITHER_NONE,			///< Map each pixel to the closest color
+		DITHER_ORDERED,			///< Apply a 4x4 Bayer matrix before mapping each pixel
+		DITHER_ERRORDIFFUSION	///< Diffuse the color error using the Floyd-Steinberg algorithm
+	};
 
 	static void BURGER_API FromRGB15(RGBWord8_t *pOutput,Word uInput);
 	static void BURGER_API FromRGB15(RGBAWord8_t *pOutput,Word uInput);
@@ -151,6 +160,30 @@ public:
 	static void BURGER_API MakeRemapLookupMasked(Word8 *pOutput,const Word8 *pNewPalette,const Word8 *pOldPalette);
 	static void BURGER_API MakeColorMasks(Word8 *pOutput,Word uMaskIndex);
 	static void BURGER_API MakeFadeLookup(Word8 *pOutput,const Word8 *pInput,Word uRedAdjust,Word uGreenAdjust,Word uBlueAdjust);
+	static Word BURGER_API Quantize(Image *pOutput,RGBAWord8_t *pPalette,const Image *pInput,Word uColors=256,eDither eDitherType=DITHER_NONE);
+	static Word BURGER_API RemapImage(Image *pOutput,const Image *pInput,const RGBAWord8_t *pPalette,Word uColors=256,eDither eDitherType=DITHER_NONE);
+};
+class InverseColorTable {
+	BURGER_DISABLECOPYCONSTRUCTORS(InverseColorTable);
+public:
+	enum {
+		CELLBITS=4,									///< Number of upper bits of each color component used to select a cell
+		CELLSHIFT=8-CELLBITS,						///< Shift to convert a color component into a cell index
+		CELLCOUNT=1<<(CELLBITS*3)					///< Number of cells in the table
+	};
+private:
+	Word8 *m_pCandidates;				///< Palette indexes that can be the closest match for each cell
+	Word m_uCount;						///< Number of colors in the palette
+	Word32 m_CellIndexes[CELLCOUNT+1];	///< Index into m_pCandidates for each cell
+	Word8 m_Palette[256*3];				///< Copy of the palette in RGB triplets
+public:
+	InverseColorTable();
+	~InverseColorTable();
+	Word Init(const Word8 *pPalette,Word uCount=256);
+	Word Init(const RGBAWord8_t *pPalette,Word uCount=256);
+	void Shutdown(void);
+	BURGER_INLINE Word GetCount(void) const { return m_uCount; }
+	Word FindColorIndex(Word uRed,Word uGreen,Word uBlue) const;
 };
 BURGER_INLINE void CopyPalette(RGBWord8_t *pOutput,const RGBWord8_t *pInput,Word uEntries=256) { MemoryCopy(pOutput,pInput,uEntries*sizeof(RGBWord8_t)); }
 extern void BURGER_API CopyPalette(RGBWord8_t *pOutput,const RGBAWord8_t *pInput,Word uEntries=256);
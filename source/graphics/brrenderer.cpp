@@ -13,6 +13,8 @@
 
 #include "brrenderer.h"
 #include "brshape8bit.h"
+#include "brcriticalsection.h"
+#include "brglobalmemorymanager.h"
 
 /*! ************************************
 
@@ -183,6 +185,27 @@ const Word8 BURGER_ALIGN(Burger::Renderer::RGB6ToRGB8Table[64],16) = {
 	0xC3,0xC7,0xCB,0xCF,0xD3,0xD7,0xDB,0xDF,
 	0xE3,0xE7,0xEB,0xEF,0xF3,0xF7,0xFB,0xFF};
 
+/*! ************************************
+
+	\enum Burger::Renderer::eCommand
+	\brief Draw commands recorded in deferred mode
+
+	\sa Renderer::DrawCommand_t or Renderer::SetDeferred(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::Renderer::DrawCommand_t
+	\brief A single recorded draw command
+
+	When deferred rendering is active, each draw call is
+	clipped and stored in this structure until the end of the scene.
+
+	\sa Renderer::eCommand or Renderer::SetDeferred(Word)
+
+***************************************/
+
 /*! ************************************
 
 	\brief Default constructor.
@@ -198,7 +221,15 @@ Burger::Renderer::Renderer(void) :
 	m_uWidth(0),
 	m_uHeight(0),
 	m_uDepth(0),
-	m_uFlags(0)
+	m_uFlags(0),
+	m_pCommands(NULL),
+	m_pTileCommands(NULL),
+	m_pTileStarts(NULL),
+	m_uCommandCount(0),
+	m_uCommandBufferSize(0),
+	m_uTileCommandBufferSize(0),
+	m_uTileStartsSize(0),
+	m_bDeferred(FALSE)
 {
 	m_Clip.Clear();
 }
@@ -251,12 +282,23 @@ Word Burger::Renderer::Init(Word uWidth,Word uHeight,Word uDepth,Word uFlags)
 
 	\brief Shut down a renderer
 
-	Release all resources allocated by the renderer
+	Release all resources allocated by the renderer. Any
+	recorded draw commands are discarded.
 
 ***************************************/
 
 void Burger::Renderer::Shutdown(void)
 {
+	Free(m_pCommands);
+	m_pCommands = NULL;
+	Free(m_pTileCommands);
+	m_pTileCommands = NULL;
+	Free(m_pTileStarts);
+	m_pTileStarts = NULL;
+	m_uCommandCount = 0;
+	m_uCommandBufferSize = 0;
+	m_uTileCommandBufferSize = 0;
+	m_uTileStartsSize = 0;
 }
 
 /*! ************************************
@@ -267,10 +309,16 @@ void Burger::Renderer::Shutdown(void)
 	internal states for the underlying API or hardware. This function 
 	will perform these actions
 
+	If deferred rendering is active, any commands left over from
+	a previous frame are discarded.
+
+	\sa SetDeferred(Word)
+
 ***************************************/
 
 void Burger::Renderer::BeginScene(void)
 {
+	m_uCommandCount = 0;
 }
 
 /*! ************************************
@@ -282,10 +330,16 @@ void Burger::Renderer::BeginScene(void)
 	events to the hardware. This function will perform these
 	actions.
 
+	If deferred rendering is active, all of the recorded draw
+	commands are rendered.
+
+	\sa FlushCommands()
+
 ***************************************/
 
 void Burger::Renderer::EndScene(void)
 {
+	FlushCommands();
 }
 
 /*! ************************************
@@ -406,6 +460,336 @@ void Burger::Renderer::UpdateClip(void)
 {
 }
 
+/*! ************************************
+
+	\brief Record a draw command for deferred rendering
+
+	Software renderers call this function from their draw functions
+	when deferred rendering is active. The command is clipped to the
+	current clip rect and the frame buffer and appended to the command
+	list. Commands that are completely clipped are discarded.
+
+	If memory for the command can't be allocated, all recorded
+	commands are rendered and this command is drawn immediately
+	so the output is unchanged.
+
+	\param eType Type of draw command
+	\param iX X coordinate of the command
+	\param iY Y coordinate of the command
+	\param uWidth Width of the command in pixels
+	\param uHeight Height of the command in pixels
+	\param uStride Bytes per scan line of pPixels
+	\param pPixels Pointer to the source pixels for 8 bit pixel commands
+	\param uColorIndex Color index for pixel and rect commands
+	\sa SetDeferred(Word) or FlushCommands()
+
+***************************************/
+
+void Burger::Renderer::RecordCommand(eCommand eType,int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels,Word uColorIndex)
+{
+	// Clip to the clip rect and the frame buffer
+	int iLeft = (iX<m_Clip.m_iLeft) ? m_Clip.m_iLeft : iX;
+	int iTop = (iY<m_Clip.m_iTop) ? m_Clip.m_iTop : iY;
+	int iRight = iX+static_cast<int>(uWidth);
+	int iBottom = iY+static_cast<int>(uHeight);
+	if (iRight>m_Clip.m_iRight) {
+		iRight = m_Clip.m_iRight;
+	}
+	if (iBottom>m_Clip.m_iBottom) {
+		iBottom = m_Clip.m_iBottom;
+	}
+	if (iLeft<0) {
+		iLeft = 0;
+	}
+	if (iTop<0) {
+		iTop = 0;
+	}
+	if (iRight>static_cast<int>(m_uWidth)) {
+		iRight = static_cast<int>(m_uWidth);
+	}
+	if (iBottom>static_cast<int>(m_uHeight)) {
+		iBottom = static_cast<int>(m_uHeight);
+	}
+	if ((iLeft<iRight) && (iTop<iBottom)) {
+		Word uCount = m_uCommandCount;
+		if (uCount>=m_uCommandBufferSize) {
+			// Grow the buffer with some slop
+			Word uNewSize = uCount+(uCount>>1U)+256U;
+			DrawCommand_t *pNew = static_cast<DrawCommand_t *>(Alloc(sizeof(DrawCommand_t)*uNewSize));
+			if (!pNew) {
+				// Out of memory, draw what's been recorded and then this command
+				FlushCommands();
+				m_bDeferred = FALSE;
+				switch (eType) {
+				case COMMAND_8BITPIXELS:
+					Draw8BitPixels(iX,iY,uWidth,uHeight,uStride,pPixels);
+					break;
+				case COMMAND_8BITPIXELSMASKED:
+					Draw8BitPixelsMasked(iX,iY,uWidth,uHeight,uStride,pPixels);
+					break;
+				case COMMAND_PIXEL:
+					DrawPixel(iX,iY,uColorIndex);
+					break;
+				default:
+					DrawRect(iX,iY,uWidth,uHeight,uColorIndex);
+					break;
+				}
+				m_bDeferred = TRUE;
+				return;
+			}
+			MemoryCopy(pNew,m_pCommands,sizeof(DrawCommand_t)*uCount);
+			Free(m_pCommands);
+			m_pCommands = pNew;
+			m_uCommandBufferSize = uNewSize;
+		}
+		DrawCommand_t *pCommand = &m_pCommands[uCount];
+		pCommand->m_pPixels = pPixels;
+		pCommand->m_uStride = uStride;
+		pCommand->m_Bounds.m_iLeft = iLeft;
+		pCommand->m_Bounds.m_iTop = iTop;
+		pCommand->m_Bounds.m_iRight = iRight;
+		pCommand->m_Bounds.m_iBottom = iBottom;
+		pCommand->m_iX = iX;
+		pCommand->m_iY = iY;
+		pCommand->m_uColorIndex = uColorIndex;
+		pCommand->m_eCommand = eType;
+		m_uCommandCount = uCount+1;
+	}
+}
+
+/***************************************
+
+	Draw all the commands that touch a single tile.
+	This is called from worker threads, so only the
+	frame buffer area covered by the tile is modified.
+
+***************************************/
+
+void BURGER_API Burger::Renderer::RasterizeTile(void *pData,Word uTile)
+{
+	Renderer *pThis = static_cast<Renderer *>(pData);
+	Word32 uIndex = pThis->m_pTileStarts[uTile];
+	Word32 uEnd = pThis->m_pTileStarts[uTile+1];
+	if (uIndex<uEnd) {
+		// Get the bounds of the tile
+		Word uTilesWide = (pThis->m_uWidth+(TILESIZE-1))>>TILESHIFT;
+		int iTileLeft = static_cast<int>((uTile%uTilesWide)<<TILESHIFT);
+		int iTileTop = static_cast<int>((uTile/uTilesWide)<<TILESHIFT);
+		int iTileRight = iTileLeft+TILESIZE;
+		int iTileBottom = iTileTop+TILESIZE;
+		const Word32 *pIndexes = pThis->m_pTileCommands;
+		do {
+			const DrawCommand_t *pCommand = &pThis->m_pCommands[pIndexes[uIndex]];
+			// Clip the command to the tile
+			int iLeft = (pCommand->m_Bounds.m_iLeft<iTileLeft) ? iTileLeft : pCommand->m_Bounds.m_iLeft;
+			int iTop = (pCommand->m_Bounds.m_iTop<iTileTop) ? iTileTop : pCommand->m_Bounds.m_iTop;
+			int iRight = (pCommand->m_Bounds.m_iRight>iTileRight) ? iTileRight : pCommand->m_Bounds.m_iRight;
+			int iBottom = (pCommand->m_Bounds.m_iBottom>iTileBottom) ? iTileBottom : pCommand->m_Bounds.m_iBottom;
+			Word uWidth = static_cast<Word>(iRight-iLeft);
+			Word uHeight = static_cast<Word>(iBottom-iTop);
+			switch (pCommand->m_eCommand) {
+			case COMMAND_8BITPIXELS:
+				pThis->Draw8BitPixels(iLeft,iTop,uWidth,uHeight,pCommand->m_uStride,
+					pCommand->m_pPixels+((static_cast<WordPtr>(iTop-pCommand->m_iY)*pCommand->m_uStride)+static_cast<WordPtr>(iLeft-pCommand->m_iX)));
+				break;
+			case COMMAND_8BITPIXELSMASKED:
+				pThis->Draw8BitPixelsMasked(iLeft,iTop,uWidth,uHeight,pCommand->m_uStride,
+					pCommand->m_pPixels+((static_cast<WordPtr>(iTop-pCommand->m_iY)*pCommand->m_uStride)+static_cast<WordPtr>(iLeft-pCommand->m_iX)));
+				break;
+			case COMMAND_PIXEL:
+				pThis->DrawPixel(iLeft,iTop,pCommand->m_uColorIndex);
+				break;
+			default:
+				pThis->DrawRect(iLeft,iTop,uWidth,uHeight,pCommand->m_uColorIndex);
+				break;
+			}
+		} while (++uIndex<uEnd);
+	}
+}
+
+/*! ************************************
+
+	\brief Enable or disable deferred rendering
+
+	When deferred rendering is enabled, calls to Draw8BitPixels(),
+	Draw8BitPixelsMasked(), DrawPixel() and DrawRect() on a software
+	renderer are recorded into a command list instead of being drawn.
+	The commands are sorted into tiles of \ref TILESIZE by \ref TILESIZE
+	pixels and the tiles are drawn in parallel by EndScene() or
+	FlushCommands(). Commands are drawn in the order they were issued
+	within each tile, so the final image is identical to drawing
+	immediately.
+
+	\note Pixel data passed to the 8 bit drawing functions must remain
+	valid until the commands are flushed.
+
+	Disabling deferred rendering will draw any commands that were
+	recorded.
+
+	\param bDeferred \ref TRUE to record draw commands, \ref FALSE to draw immediately
+	\sa IsDeferred() const or FlushCommands()
+
+***************************************/
+
+void Burger::Renderer::SetDeferred(Word bDeferred)
+{
+	if (!bDeferred) {
+		FlushCommands();
+	}
+	m_bDeferred = bDeferred;
+}
+
+/*! ************************************
+
+	\fn Word Burger::Renderer::IsDeferred(void) const
+	\brief Return \ref TRUE if deferred rendering is active
+
+	\return \ref TRUE if draw commands are recorded, \ref FALSE if they are drawn immediately
+	\sa SetDeferred(Word)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::Renderer::GetCommandCount(void) const
+	\brief Return the number of recorded draw commands
+
+	\return Number of draw commands waiting to be drawn
+	\sa FlushCommands()
+
+***************************************/
+
+/*! ************************************
+
+	\brief Draw all recorded draw commands
+
+	Sort the recorded commands into screen tiles and draw each
+	tile on a worker thread. Once complete, the command list is
+	empty.
+
+	If deferred rendering isn't active, or nothing was recorded,
+	this function does nothing.
+
+	\sa SetDeferred(Word) or EndScene()
+
+***************************************/
+
+void Burger::Renderer::FlushCommands(void)
+{
+	Word uCount = m_uCommandCount;
+	if (uCount) {
+		m_uCommandCount = 0;
+		Word uTilesWide = (m_uWidth+(TILESIZE-1))>>TILESHIFT;
+		Word uTileCount = uTilesWide*((m_uHeight+(TILESIZE-1))>>TILESHIFT);
+
+		// Make sure there's a start index for every tile
+		if (m_uTileStartsSize<(uTileCount+1)) {
+			Free(m_pTileStarts);
+			m_uTileStartsSize = 0;
+			m_pTileStarts = static_cast<Word32 *>(Alloc(sizeof(Word32)*(uTileCount+1)));
+			if (m_pTileStarts) {
+				m_uTileStartsSize = uTileCount+1;
+			}
+		}
+		Word32 *pTileStarts = m_pTileStarts;
+		if (pTileStarts) {
+			MemoryClear(pTileStarts,sizeof(Word32)*(uTileCount+1));
+
+			// Count the number of commands in each tile
+			const DrawCommand_t *pCommand = m_pCommands;
+			Word i = uCount;
+			do {
+				Word uLeft = static_cast<Word>(pCommand->m_Bounds.m_iLeft)>>TILESHIFT;
+				Word uRight = static_cast<Word>(pCommand->m_Bounds.m_iRight-1)>>TILESHIFT;
+				Word uTop = static_cast<Word>(pCommand->m_Bounds.m_iTop)>>TILESHIFT;
+				Word uBottom = static_cast<Word>(pCommand->m_Bounds.m_iBottom-1)>>TILESHIFT;
+				do {
+					Word uX = uLeft;
+					do {
+						++pTileStarts[(uTop*uTilesWide)+uX];
+					} while (++uX<=uRight);
+				} while (++uTop<=uBottom);
+				++pCommand;
+			} while (--i);
+
+			// Convert the counts into the end index of each tile
+			Word32 uTotal = 0;
+			i = 0;
+			do {
+				uTotal += pTileStarts[i];
+				pTileStarts[i] = uTotal;
+			} while (++i<uTileCount);
+			pTileStarts[uTileCount] = uTotal;
+
+			if (m_uTileCommandBufferSize<uTotal) {
+				Free(m_pTileCommands);
+				Word uNewSize = static_cast<Word>(uTotal+(uTotal>>1U));
+				m_pTileCommands = static_cast<Word32 *>(Alloc(sizeof(Word32)*uNewSize));
+				m_uTileCommandBufferSize = m_pTileCommands ? uNewSize : 0;
+			}
+			Word32 *pTileCommands = m_pTileCommands;
+			if (pTileCommands) {
+				// Insert the commands from last to first so each tile
+				// is in draw order and the tile indexes end at the start
+				// of each tile
+				i = uCount;
+				do {
+					--i;
+					pCommand = &m_pCommands[i];
+					Word uLeft = static_cast<Word>(pCommand->m_Bounds.m_iLeft)>>TILESHIFT;
+					Word uRight = static_cast<Word>(pCommand->m_Bounds.m_iRight-1)>>TILESHIFT;
+					Word uTop = static_cast<Word>(pCommand->m_Bounds.m_iTop)>>TILESHIFT;
+					Word uBottom = static_cast<Word>(pCommand->m_Bounds.m_iBottom-1)>>TILESHIFT;
+					do {
+						Word uX = uLeft;
+						do {
+							pTileCommands[--pTileStarts[(uTop*uTilesWide)+uX]] = static_cast<Word32>(i);
+						} while (++uX<=uRight);
+					} while (++uTop<=uBottom);
+				} while (i);
+
+				// Commands were clipped when recorded, so draw the
+				// tiles with clipping to the entire frame buffer.
+				// The clip rect is not changed while the tiles are drawn so
+				// it can be shared by all the threads.
+				Rect_t SavedClip = m_Clip;
+				Word bDeferred = m_bDeferred;
+				m_Clip.Set(0,0,static_cast<int>(m_uWidth),static_cast<int>(m_uHeight));
+				m_bDeferred = FALSE;
+				ParallelFor(RasterizeTile,this,uTileCount);
+				m_bDeferred = bDeferred;
+				m_Clip = SavedClip;
+				return;
+			}
+		}
+		// Out of memory, draw the commands on this thread without tiles
+		Rect_t SavedClip = m_Clip;
+		Word bDeferred = m_bDeferred;
+		m_bDeferred = FALSE;
+		const DrawCommand_t *pCommand = m_pCommands;
+		do {
+			m_Clip = pCommand->m_Bounds;
+			switch (pCommand->m_eCommand) {
+			case COMMAND_8BITPIXELS:
+				Draw8BitPixels(pCommand->m_iX,pCommand->m_iY,static_cast<Word>(pCommand->m_Bounds.m_iRight-pCommand->m_iX),static_cast<Word>(pCommand->m_Bounds.m_iBottom-pCommand->m_iY),pCommand->m_uStride,pCommand->m_pPixels);
+				break;
+			case COMMAND_8BITPIXELSMASKED:
+				Draw8BitPixelsMasked(pCommand->m_iX,pCommand->m_iY,static_cast<Word>(pCommand->m_Bounds.m_iRight-pCommand->m_iX),static_cast<Word>(pCommand->m_Bounds.m_iBottom-pCommand->m_iY),pCommand->m_uStride,pCommand->m_pPixels);
+				break;
+			case COMMAND_PIXEL:
+				DrawPixel(pCommand->m_iX,pCommand->m_iY,pCommand->m_uColorIndex);
+				break;
+			default:
+				DrawRect(pCommand->m_iX,pCommand->m_iY,static_cast<Word>(pCommand->m_Bounds.m_iRight-pCommand->m_iX),static_cast<Word>(pCommand->m_Bounds.m_iBottom-pCommand->m_iY),pCommand->m_uColorIndex);
+				break;
+			}
+			++pCommand;
+		} while (--uCount);
+		m_bDeferred = bDeferred;
+		m_Clip = SavedClip;
+	}
+}
+
 /*! ************************************
 
 	\fn Burger::Renderer::GetDisplay(void) const
@@ -647,6 +1031,8 @@ void Burger::Renderer::DrawShape8Bit(int iX,int iY,RezFile *pRezFile,Word uRezNu
 	const Shape8Bit_t *pShape = Shape8Bit_t::Load(pRezFile,uRezNum);
 	if (pShape) {
 		pShape->Draw(this,iX,iY);
+		// The shape may be purged once released
+		FlushCommands();
 		pRezFile->Release(uRezNum);
 	}
 }
@@ -673,6 +1059,8 @@ void Burger::Renderer::DrawShape8BitCentered(RezFile *pRezFile,Word uRezNum)
 		// Center Y
 		int iY = static_cast<int>((m_uHeight-pShape->GetHeight())/2U);
 		pShape->Draw(this,iX,iY);
+		// The shape may be purged once released
+		FlushCommands();
 		pRezFile->Release(uRezNum);
 	}
 }
@@ -697,6 +1085,8 @@ void Burger::Renderer::DrawShape8BitMasked(int iX,int iY,RezFile *pRezFile,Word
 	const Shape8Bit_t *pShape = Shape8Bit_t::Load(pRezFile,uRezNum);
 	if (pShape) {
 		pShape->DrawMasked(this,iX,iY);
+		// The shape may be purged once released
+		FlushCommands();
 		pRezFile->Release(uRezNum);
 	}
 }
@@ -723,6 +1113,8 @@ void Burger::Renderer::DrawShape8BitMaskedCentered(RezFile *pRezFile,Word uRezNu
 		// Center Y
 		int iY = static_cast<int>((m_uHeight-pShape->GetHeight())/2U);
 		pShape->DrawMasked(this,iX,iY);
+		// The shape may be purged once released
+		FlushCommands();
 		pRezFile->Release(uRezNum);
 	}
 }
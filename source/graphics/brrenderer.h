@@ -34,6 +34,25 @@
 namespace Burger {
 class Renderer {
 public:
+	enum {
+		TILESHIFT=6,				///< Log2 of the width and height of a tile for deferred rendering
+		TILESIZE=1<<TILESHIFT		///< Width and height in pixels of a tile for deferred rendering
+	};
+	enum eCommand {
+		COMMAND_8BITPIXELS,			///< Draw8BitPixels()
+		COMMAND_8BITPIXELSMASKED,	///< Draw8BitPixelsMasked()
+		COMMAND_PIXEL,				///< DrawPixel()
+		COMMAND_RECT				///< DrawRect()
+	};
+	struct DrawCommand_t {
+		const Word8 *m_pPixels;		///< Source pixels for 8 bit pixel commands
+		WordPtr m_uStride;			///< Bytes per scan line of the source pixels
+		Rect_t m_Bounds;			///< Destination bounds already clipped to the clip rect
+		int m_iX;					///< Unclipped X coordinate, used to locate the source pixels
+		int m_iY;					///< Unclipped Y coordinate, used to locate the source pixels
+		Word m_uColorIndex;			///< Color for pixel and rect commands
+		eCommand m_eCommand;		///< Type of draw command
+	};
 	static const Word ByteSquareTable[255+256];					///< Table of squares from -255 to 255
 	static const Word8 BURGER_ALIGN(RGB2ToRGB3Table[4],4);		///< Table to convert 2 bit color to 3 bit color
 	static const Word8 BURGER_ALIGN(RGB2ToRGB4Table[4],4);		///< Table to convert 2 bit color to 4 bit color
@@ -63,6 +82,7 @@ public:
 	virtual void Clear(Word uColorIndex);
 protected:
 	virtual void UpdateClip(void);
+	void RecordCommand(eCommand eType,int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels,Word uColorIndex);
 	Rect_t m_Clip;			///< Bounds rectangle for clipping
 	Display *m_pDisplay;	///< Attached display
 	void *m_pFrameBuffer;	///< Pointer to the software frame buffer (If supported)
@@ -71,6 +91,15 @@ protected:
 	Word m_uHeight;			///< Height in pixels of the display buffer
 	Word m_uDepth;			///< Depth in bits of the display buffer
 	Word m_uFlags;			///< Flags for describing available features
+	DrawCommand_t *m_pCommands;	///< Draw commands recorded in deferred mode
+	Word32 *m_pTileCommands;	///< Indexes to m_pCommands sorted by tile
+	Word32 *m_pTileStarts;		///< Start of each tile's commands in m_pTileCommands
+	Word m_uCommandCount;		///< Number of recorded draw commands
+	Word m_uCommandBufferSize;	///< Number of entries allocated in m_pCommands
+	Word m_uTileCommandBufferSize;	///< Number of entries allocated in m_pTileCommands
+	Word m_uTileStartsSize;		///< Number of entries allocated in m_pTileStarts
+	Word m_bDeferred;			///< \ref TRUE if draw commands are recorded instead of drawn
+	static void BURGER_API RasterizeTile(void *pData,Word uTile);
 public:
 	BURGER_INLINE Display *GetDisplay(void) const { return m_pDisplay; }
 	BURGER_INLINE void SetDisplay(Display *pDisplay) { m_pDisplay = pDisplay; }
@@ -90,6 +119,10 @@ public:
 	void DrawShape8BitCentered(RezFile *pRezFile,Word uRezNum);
 	void DrawShape8BitMasked(int iX,int iY,RezFile *pRezFile,Word uRezNum);
 	void DrawShape8BitMaskedCentered(RezFile *pRezFile,Word uRezNum);
+	void SetDeferred(Word bDeferred);
+	BURGER_INLINE Word IsDeferred(void) const { return m_bDeferred; }
+	BURGER_INLINE Word GetCommandCount(void) const { return m_uCommandCount; }
+	void FlushCommands(void);
 };
 }
 /* END */
@@ -12,6 +12,13 @@
 ***************************************/
 
 #include "brrenderersoftware16.h"
+#include "brpalette.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
 
 /*! ************************************
 
@@ -30,14 +37,481 @@
 
 	\brief Default constructor.
 	
-	Initializes all of the shared variables
+	Initializes all of the shared variables and sets the
+	color lookup table to a grey scale ramp.
 	
 ***************************************/
 
 Burger::RendererSoftware16::RendererSoftware16(void) :
 	Renderer()
 {
+	Word i = 0;
+	do {
+		RGBWord8_t Color;
+		Color.m_uRed = static_cast<Word8>(i);
+		Color.m_uGreen = static_cast<Word8>(i);
+		Color.m_uBlue = static_cast<Word8>(i);
+		m_ColorLookup[i] = static_cast<Word16>(Palette::ToRGB16(&Color));
+	} while (++i<256);
+}
+
+
+
+
+#if defined(BURGER_SSE2) || defined(BURGER_NEON) || defined(DOXYGEN)
+
+/***************************************
+
+	SIMD span functions. All of them require the
+	span to be at least 8 pixels wide so the tail
+	of each scan line can be handled by backing up and
+	processing the last 8 pixels again. This is safe
+	because copying, masking and filling the same pixels
+	twice yields the same result.
+
+	Converting the 8 bit indexes is a table lookup, so
+	the vectors are assembled one lane at a time. The
+	SIMD registers are used to blend masked pixels
+	without branches and to skip over runs of transparent
+	pixels.
+
+***************************************/
+
+//
+// Convert 8 bit pixels to 16 bit pixels
+//
+
+static void BURGER_API CopySpans16(Word16 *pDest,WordPtr uDestStride,const Word8 *pSource,WordPtr uSourceStride,Word uWidth,Word uHeight,const Word16 *pLookup)
+{
+	do {
+		Word16 *pWork = pDest;
+		const Word8 *pInput = pSource;
+		Word uCount = uWidth;
+		for (;;) {
+			if (uCount<8) {
+				if (!uCount) {
+					break;
+				}
+				// Back up for the final 8 pixels
+				pWork -= 8-uCount;
+				pInput -= 8-uCount;
+				uCount = 8;
+			}
+#if defined(BURGER_SSE2)
+			__m128i vColor = _mm_cvtsi32_si128(pLookup[pInput[0]]);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[1]],1);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[2]],2);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[3]],3);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[4]],4);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[5]],5);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[6]],6);
+			vColor = _mm_insert_epi16(vColor,pLookup[pInput[7]],7);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			uint16x8_t vColor = vdupq_n_u16(pLookup[pInput[0]]);
+			vColor = vsetq_lane_u16(pLookup[pInput[1]],vColor,1);
+			vColor = vsetq_lane_u16(pLookup[pInput[2]],vColor,2);
+			vColor = vsetq_lane_u16(pLookup[pInput[3]],vColor,3);
+			vColor = vsetq_lane_u16(pLookup[pInput[4]],vColor,4);
+			vColor = vsetq_lane_u16(pLookup[pInput[5]],vColor,5);
+			vColor = vsetq_lane_u16(pLookup[pInput[6]],vColor,6);
+			vColor = vsetq_lane_u16(pLookup[pInput[7]],vColor,7);
+			vst1q_u16(pWork,vColor);
+#endif
+			pWork+=8;
+			pInput+=8;
+			uCount-=8;
+		}
+		pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+		pSource += uSourceStride;
+	} while (--uHeight);
+}
+
+//
+// Convert 8 bit pixels to 16 bit pixels, skipping all pixels that are zero
+//
+
+static void BURGER_API MaskedSpans16(Word16 *pDest,WordPtr uDestStride,const Word8 *pSource,WordPtr uSourceStride,Word uWidth,Word uHeight,const Word16 *pLookup)
+{
+#if defined(BURGER_SSE2)
+	__m128i vZero = _mm_setzero_si128();
+#endif
+	do {
+		Word16 *pWork = pDest;
+		const Word8 *pInput = pSource;
+		Word uCount = uWidth;
+		for (;;) {
+			if (uCount<8) {
+				if (!uCount) {
+					break;
+				}
+				// Back up for the final 8 pixels
+				pWork -= 8-uCount;
+				pInput -= 8-uCount;
+				uCount = 8;
+			}
+#if defined(BURGER_SSE2)
+			__m128i vIndexes = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pInput)),vZero);
+			__m128i vMask = _mm_cmpeq_epi16(vIndexes,vZero);
+			// Skip runs of transparent pixels
+			if (_mm_movemask_epi8(vMask)!=0xFFFF) {
+				__m128i vColor = _mm_cvtsi32_si128(pLookup[pInput[0]]);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[1]],1);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[2]],2);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[3]],3);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[4]],4);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[5]],5);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[6]],6);
+				vColor = _mm_insert_epi16(vColor,pLookup[pInput[7]],7);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),_mm_or_si128(_mm_and_si128(vMask,_mm_loadu_si128(reinterpret_cast<const __m128i *>(pWork))),_mm_andnot_si128(vMask,vColor)));
+			}
+#else
+			uint16x8_t vMask = vceqq_u16(vmovl_u8(vld1_u8(pInput)),vdupq_n_u16(0));
+			// Skip runs of transparent pixels
+			uint32x2_t vTest = vreinterpret_u32_u16(vand_u16(vget_low_u16(vMask),vget_high_u16(vMask)));
+			if ((vget_lane_u32(vTest,0)&vget_lane_u32(vTest,1))!=0xFFFFFFFFU) {
+				uint16x8_t vColor = vdupq_n_u16(pLookup[pInput[0]]);
+				vColor = vsetq_lane_u16(pLookup[pInput[1]],vColor,1);
+				vColor = vsetq_lane_u16(pLookup[pInput[2]],vColor,2);
+				vColor = vsetq_lane_u16(pLookup[pInput[3]],vColor,3);
+				vColor = vsetq_lane_u16(pLookup[pInput[4]],vColor,4);
+				vColor = vsetq_lane_u16(pLookup[pInput[5]],vColor,5);
+				vColor = vsetq_lane_u16(pLookup[pInput[6]],vColor,6);
+				vColor = vsetq_lane_u16(pLookup[pInput[7]],vColor,7);
+				vst1q_u16(pWork,vbslq_u16(vMask,vld1q_u16(pWork),vColor));
+			}
+#endif
+			pWork+=8;
+			pInput+=8;
+			uCount-=8;
+		}
+		pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+		pSource += uSourceStride;
+	} while (--uHeight);
+}
+
+//
+// Fill a rectangle with a single 16 bit value
+//
+
+static void BURGER_API FillSpans16(Word16 *pDest,WordPtr uDestStride,Word uColor,Word uWidth,Word uHeight)
+{
+#if defined(BURGER_SSE2)
+	__m128i vColor = _mm_set1_epi16(static_cast<short>(uColor));
+#else
+	uint16x8_t vColor = vdupq_n_u16(static_cast<uint16_t>(uColor));
+#endif
+	do {
+		Word16 *pWork = pDest;
+		Word uCount = uWidth;
+		while (uCount>=8) {
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			vst1q_u16(pWork,vColor);
+#endif
+			pWork+=8;
+			uCount-=8;
+		}
+		if (uCount) {
+			pWork -= 8-uCount;
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			vst1q_u16(pWork,vColor);
+#endif
+		}
+		pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+	} while (--uHeight);
+}
+#endif
+
+/***************************************
+
+	Draw 8 bit data converted with the color lookup table
+	
+***************************************/
+
+void Burger::RendererSoftware16::Draw8BitPixels(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8* pPixels)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELS,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
+	// Clip the right side
+	int iDelta = m_Clip.m_iRight-iX;
+	if (iDelta>=1) {
+		if (static_cast<Word>(iDelta)<uWidth) {
+			uWidth = static_cast<Word>(iDelta);
+		}
+		// Clip the bottom
+		iDelta = m_Clip.m_iBottom-iY;
+		if (iDelta>=1) {
+			if (static_cast<Word>(iDelta)<uHeight) {
+				uHeight = static_cast<Word>(iDelta);
+			}
+			// Clip the top
+
+			iDelta = iY-static_cast<int>(m_Clip.m_iTop-uHeight);
+			if (iDelta>=1) {
+				if (static_cast<Word>(iDelta)<uHeight) {
+					iY = m_Clip.m_iTop;
+					pPixels = pPixels+(uStride*static_cast<Word>(uHeight-iDelta));
+					uHeight = static_cast<Word>(iDelta);
+				}
+
+				// Clip the left side
+
+				iDelta = iX-static_cast<int>(m_Clip.m_iLeft-uWidth);
+				if (iDelta>=1) {
+					if (static_cast<Word>(iDelta)<uWidth) {
+						iX = m_Clip.m_iLeft;
+						pPixels = pPixels+static_cast<Word>(uWidth-iDelta);
+						uWidth = static_cast<Word>(iDelta);
+					}
+
+					// Invalid shape?
+					if (uHeight && uWidth) {	
+						// Get base address
+						Word16 *pDest = reinterpret_cast<Word16 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*2)]);
+						const Word16 *pLookup = m_ColorLookup;
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide shapes
+						if (uWidth>=8) {
+							CopySpans16(pDest,m_uStride,pPixels,uStride,uWidth,uHeight,pLookup);
+						} else
+#endif
+						{
+							WordPtr uDestStride = m_uStride-(uWidth*2);
+							uStride -= uWidth;
+							do {
+								Word i = uWidth;
+								do {
+									pDest[0] = pLookup[pPixels[0]];
+									++pDest;
+									++pPixels;
+								} while (--i);
+								pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+								pPixels = pPixels+uStride;
+							} while (--uHeight);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/***************************************
+
+	Draw 8 bit data converted with the color lookup table
+	without drawing the zero values
+	
+***************************************/
+
+void Burger::RendererSoftware16::Draw8BitPixelsMasked(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELSMASKED,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
+	// Clip the right side
+	int iDelta = m_Clip.m_iRight-iX;
+	if (iDelta>=1) {
+		if (static_cast<Word>(iDelta)<uWidth) {
+			uWidth = static_cast<Word>(iDelta);
+		}
+		// Clip the bottom
+		iDelta = m_Clip.m_iBottom-iY;
+		if (iDelta>=1) {
+			if (static_cast<Word>(iDelta)<uHeight) {
+				uHeight = static_cast<Word>(iDelta);
+			}
+			// Clip the top
+
+			iDelta = iY-static_cast<int>(m_Clip.m_iTop-uHeight);
+			if (iDelta>=1) {
+				if (static_cast<Word>(iDelta)<uHeight) {
+					iY = m_Clip.m_iTop;
+					pPixels = pPixels+(uStride*static_cast<Word>(uHeight-iDelta));
+					uHeight = static_cast<Word>(iDelta);
+				}
+
+				// Clip the left side
+
+				iDelta = iX-static_cast<int>(m_Clip.m_iLeft-uWidth);
+				if (iDelta>=1) {
+					if (static_cast<Word>(iDelta)<uWidth) {
+						iX = m_Clip.m_iLeft;
+						pPixels = pPixels+static_cast<Word>(uWidth-iDelta);
+						uWidth = static_cast<Word>(iDelta);
+					}
+					if (uWidth && uHeight) {
+						// Get base address
+						Word16 *pDest = reinterpret_cast<Word16 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*2)]);
+						const Word16 *pLookup = m_ColorLookup;
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide shapes
+						if (uWidth>=8) {
+							MaskedSpans16(pDest,m_uStride,pPixels,uStride,uWidth,uHeight,pLookup);
+						} else
+#endif
+						{
+							WordPtr uDestStride = m_uStride-(uWidth*2);
+							uStride -= uWidth;
+							do {
+								Word i = uWidth;
+								do {
+									// Only draw non zero pixels!
+									Word uTemp = pPixels[0];
+									if (uTemp) {
+										pDest[0] = pLookup[uTemp];
+									}
+									++pDest;
+									++pPixels;
+								} while (--i);
+								pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+								pPixels = pPixels+uStride;
+							} while (--uHeight);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/***************************************
+
+	Draw a single pixel converted with the color lookup table
+	
+***************************************/
+
+void Burger::RendererSoftware16::DrawPixel(int iX,int iY,Word uColorIndex)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_PIXEL,iX,iY,1,1,0,NULL,uColorIndex);
+		return;
+	}
+	if ((iX>=m_Clip.m_iLeft) &&
+		(iY>=m_Clip.m_iTop) &&
+		(iX<m_Clip.m_iRight) &&
+		(iY<m_Clip.m_iBottom)) {	// Plot the pixel
+		reinterpret_cast<Word16 *>(&static_cast<Word8 *>(m_pFrameBuffer)[m_uStride*iY])[iX] = m_ColorLookup[uColorIndex&0xFFU];
+	}
 }
 
+/***************************************
+
+	Draw a color rectangle using the color lookup table
 
+***************************************/
+
+void Burger::RendererSoftware16::DrawRect(int iX,int iY,Word uWidth,Word uHeight,Word uColorIndex)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_RECT,iX,iY,uWidth,uHeight,0,NULL,uColorIndex);
+		return;
+	}
+	// Clip the right side
+	int iDelta = m_Clip.m_iRight-iX;
+	if (iDelta>=1) {
+		if (static_cast<Word>(iDelta)<uWidth) {
+			uWidth = static_cast<Word>(iDelta);
+		}
+		// Clip the bottom
+		iDelta = m_Clip.m_iBottom-iY;
+		if (iDelta>=1) {
+			if (static_cast<Word>(iDelta)<uHeight) {
+				uHeight = static_cast<Word>(iDelta);
+			}
+			// Clip the top
 
+			iDelta = iY-static_cast<int>(m_Clip.m_iTop-uHeight);
+			if (iDelta>=1) {
+				if (static_cast<Word>(iDelta)<uHeight) {
+					iY = m_Clip.m_iTop;
+					uHeight = static_cast<Word>(iDelta);
+				}
+
+				// Clip the left side
+
+				iDelta = iX-static_cast<int>(m_Clip.m_iLeft-uWidth);
+				if (iDelta>=1) {
+					if (static_cast<Word>(iDelta)<uWidth) {
+						iX = m_Clip.m_iLeft;
+						uWidth = static_cast<Word>(iDelta);
+					}
+					if (uWidth && uHeight) {
+						// Get the screen pointer
+						Word16 *pDest = reinterpret_cast<Word16 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*2)]);
+						Word uColor = m_ColorLookup[uColorIndex&0xFFU];
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide rectangles
+						if (uWidth>=8) {
+							FillSpans16(pDest,m_uStride,uColor,uWidth,uHeight);
+						} else
+#endif
+						{
+							WordPtr uDestStride = m_uStride-(uWidth*2);
+							do {
+								Word i = uWidth;
+								do {
+									pDest[0] = static_cast<Word16>(uColor);
+									++pDest;
+								} while (--i);
+								// Next line down
+								pDest = reinterpret_cast<Word16 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+								// All done?
+							} while (--uHeight);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Set the colors used to convert 8 bit pixels
+
+	All 8 bit color indexes passed to this renderer are converted to 16 bit
+	pixels through a lookup table. Update the entries in the
+	table with an array of RGB triplets. If the renderer was initialized
+	with a depth of 15, the pixels are R:5 G:5 B:5, otherwise R:5 G:6 B:5.
+
+	\param pPalette Pointer to an array of RGB triplets (uCount*3 bytes)
+	\param uStart First color index to update (0-255)
+	\param uCount Number of colors to update
+	\sa GetColorLookup() const
+
+***************************************/
+
+void Burger::RendererSoftware16::SetPalette(const Word8 *pPalette,Word uStart,Word uCount)
+{
+	if (uStart<256) {
+		if (uCount>(256-uStart)) {
+			uCount = 256-uStart;
+		}
+		if (uCount) {
+			Word16 *pOutput = &m_ColorLookup[uStart];
+			do {
+				const RGBWord8_t *pColor = reinterpret_cast<const RGBWord8_t *>(pPalette);
+				pOutput[0] = static_cast<Word16>((m_uDepth==15) ? Palette::ToRGB15(pColor) : Palette::ToRGB16(pColor));
+				++pOutput;
+				pPalette+=3;
+			} while (--uCount);
+		}
+	}
+}
+
+/*! ************************************
+
+	\fn const Word16 *Burger::RendererSoftware16::GetColorLookup(void) const
+	\brief Get the 8 bit to 16 bit color lookup table
+
+	\return Pointer to the 256 entry pixel lookup table
+	\sa SetPalette(const Word8 *,Word,Word)
+
+***************************************/
@@ -25,8 +25,16 @@
 /* BEGIN */
 namespace Burger {
 class RendererSoftware16 : public Renderer {
+protected:
+	Word16 m_ColorLookup[256];		///< 8 bit color index to native 16 bit pixel lookup table
 public:
 	RendererSoftware16(void);
+	virtual void Draw8BitPixels(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels);
+	virtual void Draw8BitPixelsMasked(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels);
+	virtual void DrawPixel(int iX,int iY,Word uColorIndex);
+	virtual void DrawRect(int iX,int iY,Word uWidth,Word uHeight,Word uColorIndex);
+	void SetPalette(const Word8 *pPalette,Word uStart=0,Word uCount=256);
+	BURGER_INLINE const Word16 *GetColorLookup(void) const { return m_ColorLookup; }
 };
 }
 /* END */
@@ -0,0 +1,694 @@
+/***************************************
+
+	32 bit software manager class
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brrenderersoftware32.h"
+
+#if defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
+/*! ************************************
+
+	\class Burger::RendererSoftware32
+	\brief 32 bit software renderer
+
+	This class contains functions to draw pixels in a 32 bit
+	buffer with bytes in the order of red, green, blue and alpha, the
+	same layout as Image::PIXELTYPE8888. It is 100% software driven, no
+	hardware assist is performed at all.
+
+	On top of the 8 bit drawing functions, which convert color indexes
+	with a lookup table, true color images and rectangles can be
+	drawn with alpha blending, additive blending or premultiplied alpha
+	compositing. This allows user interface and vector content to be
+	composited on machines without a GPU.
+
+	All blending is done with integer math where each
+	product is divided by 255 with rounding. The SIMD and scalar
+	versions produce identical results, BlendSpanReference() is
+	provided so the results can be verified.
+
+	\sa Renderer, RendererSoftware8 and RendererSoftware16
+
+***************************************/
+
+/*! ************************************
+
+	\enum Burger::RendererSoftware32::eBlendMode
+	\brief Pixel blending operations
+
+	Describes how each source pixel is combined with the
+	destination pixel. In the descriptions, Alpha is the source alpha
+	scaled to 0.0 to 1.0.
+
+	\sa BlendSpan(Word8 *,const Word8 *,Word,eBlendMode)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Default constructor.
+	
+	Initializes all of the shared variables and sets the
+	color lookup table to an opaque grey scale ramp.
+	
+***************************************/
+
+Burger::RendererSoftware32::RendererSoftware32(void) :
+	Renderer()
+{
+	Word i = 0;
+	do {
+		Word8 *pColor = reinterpret_cast<Word8 *>(&m_ColorLookup[i]);
+		pColor[0] = static_cast<Word8>(i);
+		pColor[1] = static_cast<Word8>(i);
+		pColor[2] = static_cast<Word8>(i);
+		pColor[3] = 255;
+	} while (++i<256);
+}
+
+/***************************************
+
+	Clip a shape to the clip rect and return how many
+	pixels were removed from the left and top. Returns
+	FALSE if nothing is visible.
+
+***************************************/
+
+static Word BURGER_API ClipShape(const Burger::Rect_t *pClip,int *pX,int *pY,Word *pWidth,Word *pHeight,Word *pSkipX,Word *pSkipY)
+{
+	Word bResult = FALSE;
+	int iX = pX[0];
+	int iY = pY[0];
+	Word uWidth = pWidth[0];
+	Word uHeight = pHeight[0];
+	Word uSkipX = 0;
+	Word uSkipY = 0;
+	// Clip the right side
+	int iDelta = pClip->m_iRight-iX;
+	if (iDelta>=1) {
+		if (static_cast<Word>(iDelta)<uWidth) {
+			uWidth = static_cast<Word>(iDelta);
+		}
+		// Clip the bottom
+		iDelta = pClip->m_iBottom-iY;
+		if (iDelta>=1) {
+			if (static_cast<Word>(iDelta)<uHeight) {
+				uHeight = static_cast<Word>(iDelta);
+			}
+			// Clip the top
+			iDelta = iY-static_cast<int>(pClip->m_iTop-uHeight);
+			if (iDelta>=1) {
+				if (static_cast<Word>(iDelta)<uHeight) {
+					iY = pClip->m_iTop;
+					uSkipY = static_cast<Word>(uHeight-iDelta);
+					uHeight = static_cast<Word>(iDelta);
+				}
+				// Clip the left side
+				iDelta = iX-static_cast<int>(pClip->m_iLeft-uWidth);
+				if (iDelta>=1) {
+					if (static_cast<Word>(iDelta)<uWidth) {
+						iX = pClip->m_iLeft;
+						uSkipX = static_cast<Word>(uWidth-iDelta);
+						uWidth = static_cast<Word>(iDelta);
+					}
+					if (uWidth && uHeight) {
+						pX[0] = iX;
+						pY[0] = iY;
+						pWidth[0] = uWidth;
+						pHeight[0] = uHeight;
+						pSkipX[0] = uSkipX;
+						pSkipY[0] = uSkipY;
+						bResult = TRUE;
+					}
+				}
+			}
+		}
+	}
+	return bResult;
+}
+
+/***************************************
+
+	Fill a rectangle with a single 32 bit value
+
+***************************************/
+
+static void BURGER_API FillSpans32(Word32 *pDest,WordPtr uDestStride,Word32 uColor,Word uWidth,Word uHeight)
+{
+#if defined(BURGER_SSE2)
+	__m128i vColor = _mm_set1_epi32(static_cast<int>(uColor));
+#elif defined(BURGER_NEON)
+	uint32x4_t vColor = vdupq_n_u32(uColor);
+#endif
+	do {
+		Word32 *pWork = pDest;
+		Word uCount = uWidth;
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+		while (uCount>=4) {
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			vst1q_u32(pWork,vColor);
+#endif
+			pWork+=4;
+			uCount-=4;
+		}
+#endif
+		while (uCount) {
+			pWork[0] = uColor;
+			++pWork;
+			--uCount;
+		}
+		pDest = reinterpret_cast<Word32 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+	} while (--uHeight);
+}
+
+/***************************************
+
+	Divide a 16 bit value by 255 with rounding.
+	Exact for all products of two bytes.
+
+***************************************/
+
+static BURGER_INLINE Word Divide255(Word uInput)
+{
+	uInput += 128U;
+	return (uInput+(uInput>>8U))>>8U;
+}
+
+/*! ************************************
+
+	\brief Blend a span of 32 bit pixels with scalar code
+
+	This is the reference implementation of all the blending
+	modes. It's used to finish spans that are too short for the
+	SIMD code and to verify that the SIMD code is correct.
+
+	\param pDest Pointer to the destination pixels (R,G,B,A bytes)
+	\param pSource Pointer to the source pixels (R,G,B,A bytes)
+	\param uCount Number of pixels to blend
+	\param eMode Blending operation
+	\sa BlendSpan(Word8 *,const Word8 *,Word,eBlendMode)
+
+***************************************/
+
+void BURGER_API Burger::RendererSoftware32::BlendSpanReference(Word8 *pDest,const Word8 *pSource,Word uCount,eBlendMode eMode)
+{
+	if (uCount) {
+		switch (eMode) {
+		default:
+		case BLEND_OPAQUE:
+			MemoryCopy(pDest,pSource,uCount*4);
+			break;
+		case BLEND_ALPHA:
+			do {
+				Word uAlpha = pSource[3];
+				Word uInverse = 255U-uAlpha;
+				pDest[0] = static_cast<Word8>(Divide255((pSource[0]*uAlpha)+(pDest[0]*uInverse)));
+				pDest[1] = static_cast<Word8>(Divide255((pSource[1]*uAlpha)+(pDest[1]*uInverse)));
+				pDest[2] = static_cast<Word8>(Divide255((pSource[2]*uAlpha)+(pDest[2]*uInverse)));
+				pDest[3] = static_cast<Word8>(Divide255((255U*uAlpha)+(pDest[3]*uInverse)));
+				pDest+=4;
+				pSource+=4;
+			} while (--uCount);
+			break;
+		case BLEND_ADDITIVE:
+			do {
+				Word uAlpha = pSource[3];
+				Word i = 0;
+				do {
+					Word uTemp = pDest[i]+Divide255(pSource[i]*uAlpha);
+					pDest[i] = static_cast<Word8>((uTemp>255U) ? 255U : uTemp);
+				} while (++i<3);
+				pDest+=4;
+				pSource+=4;
+			} while (--uCount);
+			break;
+		case BLEND_PREMULTIPLIED:
+			do {
+				Word uInverse = 255U-pSource[3];
+				Word i = 0;
+				do {
+					Word uTemp = pSource[i]+Divide255(pDest[i]*uInverse);
+					pDest[i] = static_cast<Word8>((uTemp>255U) ? 255U : uTemp);
+				} while (++i<4);
+				pDest+=4;
+				pSource+=4;
+			} while (--uCount);
+			break;
+		}
+	}
+}
+
+#if defined(BURGER_SSE2)
+
+/***************************************
+
+	Divide eight 16 bit values by 255 with rounding
+
+***************************************/
+
+static BURGER_INLINE __m128i Divide255SSE2(__m128i vInput)
+{
+	vInput = _mm_add_epi16(vInput,_mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(vInput,_mm_srli_epi16(vInput,8)),8);
+}
+
+/***************************************
+
+	Replicate the alpha of each pixel into all four
+	16 bit lanes of that pixel
+
+***************************************/
+
+static BURGER_INLINE __m128i SplatAlphaSSE2(__m128i vInput)
+{
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(vInput,_MM_SHUFFLE(3,3,3,3)),_MM_SHUFFLE(3,3,3,3));
+}
+
+#elif defined(BURGER_NEON)
+
+/***************************************
+
+	Divide eight 16 bit values by 255 with rounding and
+	return them as bytes
+
+***************************************/
+
+static BURGER_INLINE uint8x8_t Divide255NEON(uint16x8_t vInput)
+{
+	return vraddhn_u16(vInput,vrshrq_n_u16(vInput,8));
+}
+
+#endif
+
+/*! ************************************
+
+	\brief Blend a span of 32 bit pixels
+
+	Blend the source pixels onto the destination pixels using
+	SIMD instructions if available. The results are identical
+	to BlendSpanReference().
+
+	\param pDest Pointer to the destination pixels (R,G,B,A bytes)
+	\param pSource Pointer to the source pixels (R,G,B,A bytes)
+	\param uCount Number of pixels to blend
+	\param eMode Blending operation
+	\sa BlendSpanReference(Word8 *,const Word8 *,Word,eBlendMode)
+
+***************************************/
+
+void BURGER_API Burger::RendererSoftware32::BlendSpan(Word8 *pDest,const Word8 *pSource,Word uCount,eBlendMode eMode)
+{
+#if defined(BURGER_SSE2)
+	if (uCount>=4) {
+		__m128i vZero = _mm_setzero_si128();
+		__m128i v255 = _mm_set1_epi16(255);
+		// Lanes for red, green and blue, and the alpha lanes set to 255
+		__m128i vColorMask = _mm_set_epi16(0,-1,-1,-1,0,-1,-1,-1);
+		__m128i vAlphaFull = _mm_set_epi16(255,0,0,0,255,0,0,0);
+		switch (eMode) {
+		default:
+		case BLEND_OPAQUE:
+			do {
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),_mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource)));
+				pDest+=16;
+				pSource+=16;
+				uCount-=4;
+			} while (uCount>=4);
+			break;
+		case BLEND_ALPHA:
+			do {
+				__m128i vSource = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+				__m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest));
+				// First two pixels
+				__m128i vSource16 = _mm_unpacklo_epi8(vSource,vZero);
+				__m128i vAlpha = SplatAlphaSSE2(vSource16);
+				vSource16 = _mm_or_si128(_mm_and_si128(vSource16,vColorMask),vAlphaFull);
+				__m128i vLow = Divide255SSE2(_mm_add_epi16(_mm_mullo_epi16(vSource16,vAlpha),_mm_mullo_epi16(_mm_unpacklo_epi8(vDest,vZero),_mm_sub_epi16(v255,vAlpha))));
+				// Second two pixels
+				vSource16 = _mm_unpackhi_epi8(vSource,vZero);
+				vAlpha = SplatAlphaSSE2(vSource16);
+				vSource16 = _mm_or_si128(_mm_and_si128(vSource16,vColorMask),vAlphaFull);
+				__m128i vHigh = Divide255SSE2(_mm_add_epi16(_mm_mullo_epi16(vSource16,vAlpha),_mm_mullo_epi16(_mm_unpackhi_epi8(vDest,vZero),_mm_sub_epi16(v255,vAlpha))));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),_mm_packus_epi16(vLow,vHigh));
+				pDest+=16;
+				pSource+=16;
+				uCount-=4;
+			} while (uCount>=4);
+			break;
+		case BLEND_ADDITIVE:
+			do {
+				__m128i vSource = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+				__m128i vSource16 = _mm_unpacklo_epi8(vSource,vZero);
+				__m128i vLow = _mm_and_si128(Divide255SSE2(_mm_mullo_epi16(vSource16,SplatAlphaSSE2(vSource16))),vColorMask);
+				vSource16 = _mm_unpackhi_epi8(vSource,vZero);
+				__m128i vHigh = _mm_and_si128(Divide255SSE2(_mm_mullo_epi16(vSource16,SplatAlphaSSE2(vSource16))),vColorMask);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),_mm_adds_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest)),_mm_packus_epi16(vLow,vHigh)));
+				pDest+=16;
+				pSource+=16;
+				uCount-=4;
+			} while (uCount>=4);
+			break;
+		case BLEND_PREMULTIPLIED:
+			do {
+				__m128i vSource = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSource));
+				__m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest));
+				__m128i vInverse = _mm_sub_epi16(v255,SplatAlphaSSE2(_mm_unpacklo_epi8(vSource,vZero)));
+				__m128i vLow = Divide255SSE2(_mm_mullo_epi16(_mm_unpacklo_epi8(vDest,vZero),vInverse));
+				vInverse = _mm_sub_epi16(v255,SplatAlphaSSE2(_mm_unpackhi_epi8(vSource,vZero)));
+				__m128i vHigh = Divide255SSE2(_mm_mullo_epi16(_mm_unpackhi_epi8(vDest,vZero),vInverse));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),_mm_adds_epu8(vSource,_mm_packus_epi16(vLow,vHigh)));
+				pDest+=16;
+				pSource+=16;
+				uCount-=4;
+			} while (uCount>=4);
+			break;
+		}
+	}
+#elif defined(BURGER_NEON)
+	if (uCount>=8) {
+		uint8x8_t v255 = vdup_n_u8(255);
+		switch (eMode) {
+		default:
+		case BLEND_OPAQUE:
+			do {
+				vst1q_u8(pDest,vld1q_u8(pSource));
+				vst1q_u8(pDest+16,vld1q_u8(pSource+16));
+				pDest+=32;
+				pSource+=32;
+				uCount-=8;
+			} while (uCount>=8);
+			break;
+		case BLEND_ALPHA:
+			do {
+				// Split into planes of red, green, blue and alpha
+				uint8x8x4_t vSource = vld4_u8(pSource);
+				uint8x8x4_t vDest = vld4_u8(pDest);
+				uint8x8_t vAlpha = vSource.val[3];
+				uint8x8_t vInverse = vmvn_u8(vAlpha);
+				vDest.val[0] = Divide255NEON(vmlal_u8(vmull_u8(vSource.val[0],vAlpha),vDest.val[0],vInverse));
+				vDest.val[1] = Divide255NEON(vmlal_u8(vmull_u8(vSource.val[1],vAlpha),vDest.val[1],vInverse));
+				vDest.val[2] = Divide255NEON(vmlal_u8(vmull_u8(vSource.val[2],vAlpha),vDest.val[2],vInverse));
+				vDest.val[3] = Divide255NEON(vmlal_u8(vmull_u8(v255,vAlpha),vDest.val[3],vInverse));
+				vst4_u8(pDest,vDest);
+				pDest+=32;
+				pSource+=32;
+				uCount-=8;
+			} while (uCount>=8);
+			break;
+		case BLEND_ADDITIVE:
+			do {
+				uint8x8x4_t vSource = vld4_u8(pSource);
+				uint8x8x4_t vDest = vld4_u8(pDest);
+				uint8x8_t vAlpha = vSource.val[3];
+				vDest.val[0] = vqadd_u8(vDest.val[0],Divide255NEON(vmull_u8(vSource.val[0],vAlpha)));
+				vDest.val[1] = vqadd_u8(vDest.val[1],Divide255NEON(vmull_u8(vSource.val[1],vAlpha)));
+				vDest.val[2] = vqadd_u8(vDest.val[2],Divide255NEON(vmull_u8(vSource.val[2],vAlpha)));
+				vst4_u8(pDest,vDest);
+				pDest+=32;
+				pSource+=32;
+				uCount-=8;
+			} while (uCount>=8);
+			break;
+		case BLEND_PREMULTIPLIED:
+			do {
+				uint8x8x4_t vSource = vld4_u8(pSource);
+				uint8x8x4_t vDest = vld4_u8(pDest);
+				uint8x8_t vInverse = vmvn_u8(vSource.val[3]);
+				vDest.val[0] = vqadd_u8(vSource.val[0],Divide255NEON(vmull_u8(vDest.val[0],vInverse)));
+				vDest.val[1] = vqadd_u8(vSource.val[1],Divide255NEON(vmull_u8(vDest.val[1],vInverse)));
+				vDest.val[2] = vqadd_u8(vSource.val[2],Divide255NEON(vmull_u8(vDest.val[2],vInverse)));
+				vDest.val[3] = vqadd_u8(vSource.val[3],Divide255NEON(vmull_u8(vDest.val[3],vInverse)));
+				vst4_u8(pDest,vDest);
+				pDest+=32;
+				pSource+=32;
+				uCount-=8;
+			} while (uCount>=8);
+			break;
+		}
+	}
+#endif
+	// Finish up with the scalar code
+	BlendSpanReference(pDest,pSource,uCount,eMode);
+}
+
+/***************************************
+
+	Draw 8 bit data converted with the color lookup table
+	
+***************************************/
+
+void Burger::RendererSoftware32::Draw8BitPixels(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8* pPixels)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELS,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
+	Word uSkipX;
+	Word uSkipY;
+	if (ClipShape(&m_Clip,&iX,&iY,&uWidth,&uHeight,&uSkipX,&uSkipY)) {
+		pPixels = pPixels+((uStride*uSkipY)+uSkipX);
+		Word32 *pDest = reinterpret_cast<Word32 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*4)]);
+		const Word32 *pLookup = m_ColorLookup;
+		WordPtr uDestStride = m_uStride-(uWidth*4);
+		uStride -= uWidth;
+		do {
+			Word i = uWidth;
+			do {
+				pDest[0] = pLookup[pPixels[0]];
+				++pDest;
+				++pPixels;
+			} while (--i);
+			pDest = reinterpret_cast<Word32 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+			pPixels = pPixels+uStride;
+		} while (--uHeight);
+	}
+}
+
+/***************************************
+
+	Draw 8 bit data converted with the color lookup table
+	without drawing the zero values
+	
+***************************************/
+
+void Burger::RendererSoftware32::Draw8BitPixelsMasked(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELSMASKED,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
+	Word uSkipX;
+	Word uSkipY;
+	if (ClipShape(&m_Clip,&iX,&iY,&uWidth,&uHeight,&uSkipX,&uSkipY)) {
+		pPixels = pPixels+((uStride*uSkipY)+uSkipX);
+		Word32 *pDest = reinterpret_cast<Word32 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*4)]);
+		const Word32 *pLookup = m_ColorLookup;
+		WordPtr uDestStride = m_uStride-(uWidth*4);
+		uStride -= uWidth;
+		do {
+			Word i = uWidth;
+			do {
+				// Only draw non zero pixels!
+				Word uTemp = pPixels[0];
+				if (uTemp) {
+					pDest[0] = pLookup[uTemp];
+				}
+				++pDest;
+				++pPixels;
+			} while (--i);
+			pDest = reinterpret_cast<Word32 *>(reinterpret_cast<Word8 *>(pDest)+uDestStride);
+			pPixels = pPixels+uStride;
+		} while (--uHeight);
+	}
+}
+
+/***************************************
+
+	Draw a single pixel converted with the color lookup table
+	
+***************************************/
+
+void Burger::RendererSoftware32::DrawPixel(int iX,int iY,Word uColorIndex)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_PIXEL,iX,iY,1,1,0,NULL,uColorIndex);
+		return;
+	}
+	if ((iX>=m_Clip.m_iLeft) &&
+		(iY>=m_Clip.m_iTop) &&
+		(iX<m_Clip.m_iRight) &&
+		(iY<m_Clip.m_iBottom)) {	// Plot the pixel
+		reinterpret_cast<Word32 *>(&static_cast<Word8 *>(m_pFrameBuffer)[m_uStride*iY])[iX] = m_ColorLookup[uColorIndex&0xFFU];
+	}
+}
+
+/***************************************
+
+	Draw a color rectangle using the color lookup table
+
+***************************************/
+
+void Burger::RendererSoftware32::DrawRect(int iX,int iY,Word uWidth,Word uHeight,Word uColorIndex)
+{
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_RECT,iX,iY,uWidth,uHeight,0,NULL,uColorIndex);
+		return;
+	}
+	Word uSkipX;
+	Word uSkipY;
+	if (ClipShape(&m_Clip,&iX,&iY,&uWidth,&uHeight,&uSkipX,&uSkipY)) {
+		Word32 *pDest = reinterpret_cast<Word32 *>(&static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*4)]);
+		FillSpans32(pDest,m_uStride,m_ColorLookup[uColorIndex&0xFFU],uWidth,uHeight);
+	}
+}
+
+/*! ************************************
+
+	\brief Draw a true color image
+
+	Draw an Image::PIXELTYPE8888 image clipped to the current clip rect
+	using the requested blending operation. Only the top mip map level is drawn.
+
+	\note Images of any other pixel type are ignored. In deferred mode,
+	all recorded commands are drawn first.
+
+	\param iX X coordinate to draw the image
+	\param iY Y coordinate to draw the image
+	\param pImage Pointer to the image to draw
+	\param eMode Blending operation
+	\sa DrawRect(int,int,Word,Word,const RGBAWord8_t *,eBlendMode)
+
+***************************************/
+
+void Burger::RendererSoftware32::DrawImage(int iX,int iY,const Image *pImage,eBlendMode eMode)
+{
+	// Blended drawing is not recorded, so draw everything before it first
+	FlushCommands();
+	if (pImage->GetType()==Image::PIXELTYPE8888) {
+		Word uWidth = pImage->GetWidth();
+		Word uHeight = pImage->GetHeight();
+		Word uSkipX;
+		Word uSkipY;
+		if (ClipShape(&m_Clip,&iX,&iY,&uWidth,&uHeight,&uSkipX,&uSkipY)) {
+			WordPtr uStride = pImage->GetStride();
+			const Word8 *pPixels = pImage->GetImage()+((uStride*uSkipY)+(uSkipX*4));
+			Word8 *pDest = &static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*4)];
+			do {
+				BlendSpan(pDest,pPixels,uWidth,eMode);
+				pDest += m_uStride;
+				pPixels += uStride;
+			} while (--uHeight);
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Draw a true color rectangle
+
+	Draw a solid rectangle clipped to the current clip rect
+	using the requested blending operation.
+
+	\note In deferred mode, all recorded commands are drawn first.
+
+	\param iX X coordinate of the leftmost line
+	\param iY Y coordinate of the topmost line
+	\param uWidth Width of the rectangle in pixels
+	\param uHeight Height of the rectangle in pixels
+	\param pColor Pointer to the color to draw
+	\param eMode Blending operation
+	\sa DrawImage(int,int,const Image *,eBlendMode)
+
+***************************************/
+
+void Burger::RendererSoftware32::DrawRect(int iX,int iY,Word uWidth,Word uHeight,const RGBAWord8_t *pColor,eBlendMode eMode)
+{
+	// Blended drawing is not recorded, so draw everything before it first
+	FlushCommands();
+	Word uSkipX;
+	Word uSkipY;
+	if (ClipShape(&m_Clip,&iX,&iY,&uWidth,&uHeight,&uSkipX,&uSkipY)) {
+		// Create a scan line of the color to use as the source
+		Word32 Colors[64];
+		Word i = 0;
+		do {
+			MemoryCopy(&Colors[i],pColor,4);
+		} while (++i<64);
+		Word8 *pDest = &static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+(iX*4)];
+		if (eMode==BLEND_OPAQUE) {
+			FillSpans32(reinterpret_cast<Word32 *>(pDest),m_uStride,Colors[0],uWidth,uHeight);
+		} else {
+			do {
+				Word8 *pWork = pDest;
+				Word uCount = uWidth;
+				do {
+					Word uChunk = (uCount>64) ? 64 : uCount;
+					BlendSpan(pWork,reinterpret_cast<const Word8 *>(Colors),uChunk,eMode);
+					pWork += uChunk*4;
+					uCount -= uChunk;
+				} while (uCount);
+				pDest += m_uStride;
+			} while (--uHeight);
+		}
+	}
+}
+
+/*! ************************************
+
+	\brief Set the colors used to convert 8 bit pixels
+
+	All 8 bit color indexes passed to this renderer are converted to 32 bit
+	pixels through a lookup table. Update the entries in the
+	table with an array of RGB triplets. The alpha of each entry is set to 255.
+
+	\param pPalette Pointer to an array of RGB triplets (uCount*3 bytes)
+	\param uStart First color index to update (0-255)
+	\param uCount Number of colors to update
+	\sa GetColorLookup() const
+
+***************************************/
+
+void Burger::RendererSoftware32::SetPalette(const Word8 *pPalette,Word uStart,Word uCount)
+{
+	if (uStart<256) {
+		if (uCount>(256-uStart)) {
+			uCount = 256-uStart;
+		}
+		if (uCount) {
+			Word8 *pOutput = reinterpret_cast<Word8 *>(&m_ColorLookup[uStart]);
+			do {
+				pOutput[0] = pPalette[0];
+				pOutput[1] = pPalette[1];
+				pOutput[2] = pPalette[2];
+				pOutput[3] = 255;
+				pOutput+=4;
+				pPalette+=3;
+			} while (--uCount);
+		}
+	}
+}
+
+/*! ************************************
+
+	\fn const Word32 *Burger::RendererSoftware32::GetColorLookup(void) const
+	\brief Get the 8 bit to 32 bit color lookup table
+
+	\return Pointer to the 256 entry pixel lookup table
+	\sa SetPalette(const Word8 *,Word,Word)
+
+***************************************/
@@ -0,0 +1,61 @@
+/***************************************
+
+	32 bit software manager class
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRRENDERERSOFTWARE32_H__
+#define __BRRENDERERSOFTWARE32_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRRENDERER_H__
+#include "brrenderer.h"
+#endif
+
+#ifndef __BRIMAGE_H__
+#include "brimage.h"
+#endif
+
+#ifndef __BRPALETTE_H__
+#include "brpalette.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class RendererSoftware32 : public Renderer {
+public:
+	enum eBlendMode {
+		BLEND_OPAQUE,			///< Replace the destination pixels
+		BLEND_ALPHA,			///< Blend with the source alpha, (Source*Alpha)+(Dest*(1-Alpha))
+		BLEND_ADDITIVE,			///< Add the source color scaled by source alpha, destination alpha is unchanged
+		BLEND_PREMULTIPLIED		///< Source is premultiplied by alpha, Source+(Dest*(1-Alpha))
+	};
+protected:
+	Word32 m_ColorLookup[256];		///< 8 bit color index to native 32 bit pixel lookup table
+public:
+	RendererSoftware32(void);
+	virtual void Draw8BitPixels(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels);
+	virtual void Draw8BitPixelsMasked(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels);
+	virtual void DrawPixel(int iX,int iY,Word uColorIndex);
+	virtual void DrawRect(int iX,int iY,Word uWidth,Word uHeight,Word uColorIndex);
+	void DrawImage(int iX,int iY,const Image *pImage,eBlendMode eMode=BLEND_OPAQUE);
+	void DrawRect(int iX,int iY,Word uWidth,Word uHeight,const RGBAWord8_t *pColor,eBlendMode eMode=BLEND_OPAQUE);
+	void SetPalette(const Word8 *pPalette,Word uStart=0,Word uCount=256);
+	BURGER_INLINE const Word32 *GetColorLookup(void) const { return m_ColorLookup; }
+	static void BURGER_API BlendSpan(Word8 *pDest,const Word8 *pSource,Word uCount,eBlendMode eMode);
+	static void BURGER_API BlendSpanReference(Word8 *pDest,const Word8 *pSource,Word uCount,eBlendMode eMode);
+};
+}
+/* END */
+
+#endif
@@ -13,6 +13,14 @@
 
 #include "brrenderersoftware8.h"
 
+#if defined(BURGER_AVX2)
+#include <immintrin.h>
+#elif defined(BURGER_SSE2)
+#include <emmintrin.h>
+#elif defined(BURGER_NEON)
+#include <arm_neon.h>
+#endif
+
 /*! ************************************
 
 	\class Burger::RendererSoftware8
@@ -39,6 +47,159 @@ Burger::RendererSoftware8::RendererSoftware8(void) :
 {
 }
 
+#if defined(BURGER_SSE2) || defined(BURGER_NEON) || defined(DOXYGEN)
+
+/***************************************
+
+	SIMD span functions. All of them require the
+	span to be at least 16 pixels wide so the tail
+	of each scan line can be handled by backing up and
+	processing the last 16 pixels again. This is safe
+	because copying, masking and filling the same pixels
+	twice yields the same result.
+
+***************************************/
+
+//
+// Copy 8 bit pixels
+//
+
+static void BURGER_API CopySpans8(Word8 *pDest,WordPtr uDestStride,const Word8 *pSource,WordPtr uSourceStride,Word uWidth,Word uHeight)
+{
+	do {
+		Word8 *pWork = pDest;
+		const Word8 *pInput = pSource;
+		Word uCount = uWidth;
+#if defined(BURGER_AVX2)
+		while (uCount>=32) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pWork),_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pInput)));
+			pWork+=32;
+			pInput+=32;
+			uCount-=32;
+		}
+#endif
+		while (uCount>=16) {
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)));
+#else
+			vst1q_u8(pWork,vld1q_u8(pInput));
+#endif
+			pWork+=16;
+			pInput+=16;
+			uCount-=16;
+		}
+		if (uCount) {
+			pWork -= 16-uCount;
+			pInput -= 16-uCount;
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),_mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput)));
+#else
+			vst1q_u8(pWork,vld1q_u8(pInput));
+#endif
+		}
+		pDest += uDestStride;
+		pSource += uSourceStride;
+	} while (--uHeight);
+}
+
+//
+// Copy 8 bit pixels, skipping all pixels that are zero
+//
+
+static void BURGER_API MaskedSpans8(Word8 *pDest,WordPtr uDestStride,const Word8 *pSource,WordPtr uSourceStride,Word uWidth,Word uHeight)
+{
+#if defined(BURGER_AVX2)
+	__m256i vZero32 = _mm256_setzero_si256();
+#endif
+#if defined(BURGER_SSE2)
+	__m128i vZero = _mm_setzero_si128();
+#endif
+	do {
+		Word8 *pWork = pDest;
+		const Word8 *pInput = pSource;
+		Word uCount = uWidth;
+#if defined(BURGER_AVX2)
+		while (uCount>=32) {
+			__m256i vSource = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pInput));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pWork),_mm256_blendv_epi8(vSource,_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pWork)),_mm256_cmpeq_epi8(vSource,vZero32)));
+			pWork+=32;
+			pInput+=32;
+			uCount-=32;
+		}
+#endif
+		for (;;) {
+			if (uCount<16) {
+				if (!uCount) {
+					break;
+				}
+				// Back up for the final 16 pixels
+				pWork -= 16-uCount;
+				pInput -= 16-uCount;
+				uCount = 16;
+			}
+#if defined(BURGER_SSE2)
+			__m128i vSource = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pInput));
+			__m128i vMask = _mm_cmpeq_epi8(vSource,vZero);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),_mm_or_si128(_mm_and_si128(vMask,_mm_loadu_si128(reinterpret_cast<const __m128i *>(pWork))),_mm_andnot_si128(vMask,vSource)));
+#else
+			uint8x16_t vSource = vld1q_u8(pInput);
+			vst1q_u8(pWork,vbslq_u8(vceqq_u8(vSource,vdupq_n_u8(0)),vld1q_u8(pWork),vSource));
+#endif
+			pWork+=16;
+			pInput+=16;
+			uCount-=16;
+		}
+		pDest += uDestStride;
+		pSource += uSourceStride;
+	} while (--uHeight);
+}
+
+//
+// Fill a rectangle with a single 8 bit value
+//
+
+static void BURGER_API FillSpans8(Word8 *pDest,WordPtr uDestStride,Word uColorIndex,Word uWidth,Word uHeight)
+{
+#if defined(BURGER_AVX2)
+	__m256i vColor32 = _mm256_set1_epi8(static_cast<char>(uColorIndex));
+#endif
+#if defined(BURGER_SSE2)
+	__m128i vColor = _mm_set1_epi8(static_cast<char>(uColorIndex));
+#else
+	uint8x16_t vColor = vdupq_n_u8(static_cast<uint8_t>(uColorIndex));
+#endif
+	do {
+		Word8 *pWork = pDest;
+		Word uCount = uWidth;
+#if defined(BURGER_AVX2)
+		while (uCount>=32) {
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pWork),vColor32);
+			pWork+=32;
+			uCount-=32;
+		}
+#endif
+		while (uCount>=16) {
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			vst1q_u8(pWork,vColor);
+#endif
+			pWork+=16;
+			uCount-=16;
+		}
+		if (uCount) {
+			pWork -= 16-uCount;
+#if defined(BURGER_SSE2)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pWork),vColor);
+#else
+			vst1q_u8(pWork,vColor);
+#endif
+		}
+		pDest += uDestStride;
+	} while (--uHeight);
+}
+#endif
+
 /***************************************
 
 	Draw 8 bit data as is
@@ -47,6 +208,10 @@ Burger::RendererSoftware8::RendererSoftware8(void) :
 
 void Burger::RendererSoftware8::Draw8BitPixels(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8* pPixels)
 {
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELS,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
 	// Clip the right side
 	int iDelta = m_Clip.m_iRight-iX;
 	if (iDelta>=1) {
@@ -88,6 +253,12 @@ void Burger::RendererSoftware8::Draw8BitPixels(int iX,int iY,Word uWidth,Word uH
 						WordPtr uOffset = m_uStride;
 						// Count in longs
 						Word uLongWidth = uWidth>>2;
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide shapes
+						if (uWidth>=16) {
+							CopySpans8(pDest,uOffset,pPixels,uStride,uWidth,uHeight);
+						} else
+#endif
 						if (!uLongWidth) {
 						// Blit 1,2 or 3 byte wide shapes
 
@@ -186,6 +357,10 @@ void Burger::RendererSoftware8::Draw8BitPixels(int iX,int iY,Word uWidth,Word uH
 
 void Burger::RendererSoftware8::Draw8BitPixelsMasked(int iX,int iY,Word uWidth,Word uHeight,WordPtr uStride,const Word8 *pPixels)
 {
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_8BITPIXELSMASKED,iX,iY,uWidth,uHeight,uStride,pPixels,0);
+		return;
+	}
 	// Clip the right side
 	int iDelta = m_Clip.m_iRight-iX;
 	if (iDelta>=1) {
@@ -224,6 +399,12 @@ void Burger::RendererSoftware8::Draw8BitPixelsMasked(int iX,int iY,Word uWidth,W
 						WordPtr uDestStride = m_uStride-uWidth;
 						uStride -= uWidth;
 						Word uLongWidth = uWidth>>2;
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide shapes
+						if (uWidth>=16) {
+							MaskedSpans8(pDest,m_uStride,pPixels,uStride+uWidth,uWidth,uHeight);
+						} else
+#endif
 						if (!uLongWidth) {
 							// 1-3 bytes wide
 							do {
@@ -301,10 +482,14 @@ void Burger::RendererSoftware8::Draw8BitPixelsMasked(int iX,int iY,Word uWidth,W
 
 void Burger::RendererSoftware8::DrawPixel(int iX,int iY,Word uColorIndex)
 {
-	if ((iX>=m_Clip.m_iRight) &&
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_PIXEL,iX,iY,1,1,0,NULL,uColorIndex);
+		return;
+	}
+	if ((iX>=m_Clip.m_iLeft) &&
 		(iY>=m_Clip.m_iTop) &&
-		(iX<m_Clip.m_iBottom) &&
-		(iY<m_Clip.m_iLeft)) {	// Plot the pixel
+		(iX<m_Clip.m_iRight) &&
+		(iY<m_Clip.m_iBottom)) {	// Plot the pixel
 		static_cast<Word8 *>(m_pFrameBuffer)[(m_uStride*iY)+iX] = static_cast<Word8>(uColorIndex);
 	}
 }
@@ -317,6 +502,10 @@ void Burger::RendererSoftware8::DrawPixel(int iX,int iY,Word uColorIndex)
 
 void Burger::RendererSoftware8::DrawRect(int iX,int iY,Word uWidth,Word uHeight,Word uColorIndex)
 {
+	if (m_bDeferred) {
+		RecordCommand(COMMAND_RECT,iX,iY,uWidth,uHeight,0,NULL,uColorIndex);
+		return;
+	}
 	// Clip the right side
 	int iDelta = m_Clip.m_iRight-iX;
 	if (iDelta>=1) {
@@ -352,6 +541,11 @@ void Burger::RendererSoftware8::DrawRect(int iX,int iY,Word uWidth,Word uHeight,
 						// Optimization for memory fill
 						if ((m_uStride==uWidth) && !iX) {
 							MemoryFill(pDest,static_cast<Word8>(uColorIndex),uWidth*uHeight);
+#if defined(BURGER_SSE2) || defined(BURGER_NEON)
+						// Use vector registers for the wide rectangles
+						} else if (uWidth>=16) {
+							FillSpans8(pDest,m_uStride,uColorIndex,uWidth,uHeight);
+#endif
 						} else {
 							do {
 								// Fill memory
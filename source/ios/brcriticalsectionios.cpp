@@ -21,6 +21,7 @@
 #include <errno.h>
 #include <sys/time.h>
 #include <signal.h>
+#include <unistd.h>
 #include <mach/semaphore.h>
 #include <mach/mach_init.h>
 #include <mach/mach_traps.h>
@@ -467,4 +468,19 @@ void BURGER_API Burger::Thread::Run(void *pThis)
 	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
 }
 
+/***************************************
+
+	Return the number of CPU cores available
+	
+***************************************/
+
+Word BURGER_API Burger::Thread::GetProcessorCount(void)
+{
+	long iResult = sysconf(_SC_NPROCESSORS_ONLN);
+	if (iResult<1) {
+		iResult = 1;
+	}
+	return static_cast<Word>(iResult);
+}
+
 #endif
\ No newline at end of file
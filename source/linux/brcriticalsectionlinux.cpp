@@ -0,0 +1,465 @@
+/***************************************
+
+	Class to handle critical sections, Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brcriticalsection.h"
+
+#if defined(BURGER_LINUX)
+#include "bratomic.h"
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+/***************************************
+
+	Convert a timeout in milliseconds into the absolute
+	time POSIX uses for timed waits
+
+***************************************/
+
+static void GetTimeout(timespec *pOutput,Word uMilliseconds)
+{
+	clock_gettime(CLOCK_REALTIME,pOutput);
+	Word uSeconds = uMilliseconds/1000U;
+	// Get the remainder in NANOseconds
+	long lNanoseconds = static_cast<long>(uMilliseconds-(uSeconds*1000U))*1000000L;
+	lNanoseconds += pOutput->tv_nsec;
+	// Handle wrap around
+	if (lNanoseconds>=1000000000L) {
+		lNanoseconds-=1000000000L;
+		++uSeconds;
+	}
+	pOutput->tv_sec += static_cast<time_t>(uSeconds);
+	pOutput->tv_nsec = lNanoseconds;
+}
+
+/***************************************
+
+	Initialize the mutex
+
+***************************************/
+
+Burger::CriticalSection::CriticalSection()
+{
+	pthread_mutex_init(&m_Lock,NULL);
+}
+
+Burger::CriticalSection::~CriticalSection()
+{
+	pthread_mutex_destroy(&m_Lock);
+}
+
+/***************************************
+
+	Lock the Mutex
+
+***************************************/
+
+void Burger::CriticalSection::Lock()
+{
+	pthread_mutex_lock(&m_Lock);
+}
+
+/***************************************
+
+	Try to lock the Mutex
+
+***************************************/
+
+Word Burger::CriticalSection::TryLock()
+{
+	return pthread_mutex_trylock(&m_Lock)!=EBUSY;
+}
+
+/***************************************
+
+	Unlock the Mutex
+
+***************************************/
+
+void Burger::CriticalSection::Unlock()
+{
+	pthread_mutex_unlock(&m_Lock);
+}
+
+/***************************************
+
+	Initialize the semaphore
+
+***************************************/
+
+Burger::Semaphore::Semaphore(Word32 uCount) :
+	m_bInitialized(FALSE),
+	m_uCount(uCount)
+{
+	// Initialize the semaphore
+	if (!sem_init(&m_Semaphore,0,uCount)) {
+		m_bInitialized = TRUE;
+	}
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Burger::Semaphore::~Semaphore()
+{
+	if (m_bInitialized) {
+		sem_destroy(&m_Semaphore);
+		m_bInitialized = FALSE;
+	}
+	m_uCount = 0;
+}
+
+/***************************************
+
+	Attempt to acquire the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::TryAcquire(Word uMilliseconds)
+{
+	// Assume failure
+	Word uResult = 10;
+	if (m_bInitialized) {
+		// No wait?
+		if (!uMilliseconds) {
+			// Use the fast function
+			if (!sem_trywait(&m_Semaphore)) {
+				// Got it!
+				uResult = 0;
+			} else {
+				uResult = 1;
+			}
+		} else if (uMilliseconds==BURGER_MAXUINT) {
+			// Halt until acquired
+			int iSemResult;
+			do {
+				iSemResult = sem_wait(&m_Semaphore);
+				// If the error was because of a system interrupt, try again
+			} while ((iSemResult==-1) && (errno==EINTR));
+			if (!iSemResult) {
+				uResult = 0;
+			}
+		} else {
+			// Posix doesn't use relative time. It uses
+			// literal time.
+			timespec TimeSpecTimeOut;
+			GetTimeout(&TimeSpecTimeOut,uMilliseconds);
+
+			// Wait for the semaphore
+			int iTest;
+			do {
+				iTest = sem_timedwait(&m_Semaphore,&TimeSpecTimeOut);
+				// Loop only on interrupts
+			} while ((iTest==-1) && (errno==EINTR));
+			// Success?
+			if (!iTest) {
+				uResult = 0;
+			} else if (errno==ETIMEDOUT) {
+				uResult = 1;
+			}
+		}
+		// If the lock was acquired, decrement the count
+		if (!uResult) {
+			AtomicPreDecrement(&m_uCount);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Release the semaphore
+
+***************************************/
+
+Word BURGER_API Burger::Semaphore::Release(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		// Release the count immediately, because it's
+		// possible that another thread, waiting for this semaphore,
+		// can execute before the call to sem_post()
+		// returns
+		AtomicPreIncrement(&m_uCount);
+		if (sem_post(&m_Semaphore)) {
+			// Error!!! Undo the AtomicPreIncrement()
+			AtomicPreDecrement(&m_uCount);
+		} else {
+			// A-Okay!
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Initialize the condition variable
+
+***************************************/
+
+Burger::ConditionVariable::ConditionVariable() :
+	m_bInitialized(FALSE)
+{
+	if (!pthread_cond_init(&m_ConditionVariable,NULL)) {
+		m_bInitialized = TRUE;
+	}
+}
+
+/***************************************
+
+	Release the resources
+
+***************************************/
+
+Burger::ConditionVariable::~ConditionVariable()
+{
+	if (m_bInitialized) {
+		pthread_cond_destroy(&m_ConditionVariable);
+		m_bInitialized = FALSE;
+	}
+}
+
+/***************************************
+
+	Signal a waiting thread
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Signal(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_signal(&m_ConditionVariable)) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Signal all waiting threads
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Broadcast(void)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (!pthread_cond_broadcast(&m_ConditionVariable)) {
+			uResult = 0;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait for a signal (With timeout)
+
+***************************************/
+
+Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSection,Word uMilliseconds)
+{
+	Word uResult = 10;
+	if (m_bInitialized) {
+		if (uMilliseconds==BURGER_MAXUINT) {
+			if (!pthread_cond_wait(&m_ConditionVariable,&pCriticalSection->m_Lock)) {
+				uResult = 0;
+			}
+		} else {
+			// Determine the time in the future to timeout at
+			timespec StopTimeHere;
+			GetTimeout(&StopTimeHere,uMilliseconds);
+			int iResult;
+			do {
+				// Wait for the signal and possibly time out
+				iResult = pthread_cond_timedwait(&m_ConditionVariable,&pCriticalSection->m_Lock,&StopTimeHere);
+				// Interrupted?
+			} while (iResult==EINTR);
+
+			// W00t! We're good!
+			if (!iResult) {
+				uResult = 0;
+
+			// Time out?
+			} else if (iResult==ETIMEDOUT) {
+				uResult = 1;
+			}
+			// Otherwise, leave uResult as an error
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	This code fragment calls the Run function that has
+	permission to access the members
+
+***************************************/
+
+static void *Dispatcher(void *pThis)
+{
+	Burger::Thread::Run(pThis);
+	return NULL;
+}
+
+/***************************************
+
+	Initialize a thread to a dormant state
+
+***************************************/
+
+Burger::Thread::Thread() :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_ThreadHandle(),
+	m_bThreadStarted(FALSE),
+	m_uResult(BURGER_MAXUINT)
+{
+}
+
+/***************************************
+
+	Initialize a thread and begin execution
+
+***************************************/
+
+Burger::Thread::Thread(FunctionPtr pThread,void *pData) :
+	m_pFunction(NULL),
+	m_pData(NULL),
+	m_pSemaphore(NULL),
+	m_ThreadHandle(),
+	m_bThreadStarted(FALSE),
+	m_uResult(BURGER_MAXUINT)
+{
+	Start(pThread,pData);
+}
+
+/***************************************
+
+	Release resources
+
+***************************************/
+
+Burger::Thread::~Thread()
+{
+	Kill();
+}
+
+/***************************************
+
+	Launch a new thread if one isn't already started
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Start(FunctionPtr pFunction,void *pData)
+{
+	Word uResult = 10;
+	if (!m_bThreadStarted) {
+		m_pFunction = pFunction;
+		m_pData = pData;
+		// Use this temporary semaphore to force synchronization
+		Semaphore Temp(0);
+		m_pSemaphore = &Temp;
+		pthread_attr_t Attributes;
+		if (!pthread_attr_init(&Attributes)) {
+			pthread_attr_setdetachstate(&Attributes,PTHREAD_CREATE_JOINABLE);
+			if (!pthread_create(&m_ThreadHandle,&Attributes,Dispatcher,this)) {
+				m_bThreadStarted = TRUE;
+				// Wait until the thread has started
+				Temp.Acquire();
+				// All good!
+				uResult = 0;
+			}
+			pthread_attr_destroy(&Attributes);
+		}
+		// Kill the dangling pointer
+		m_pSemaphore = NULL;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Wait until the thread has completed execution
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Wait(void)
+{
+	Word uResult = 10;
+	if (m_bThreadStarted) {
+		// Wait until the thread completes execution
+		pthread_join(m_ThreadHandle,NULL);
+		// Allow restarting
+		m_bThreadStarted = FALSE;
+		uResult = 0;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Invoke the nuclear option to kill a thread
+	NOT RECOMMENDED!
+
+***************************************/
+
+Word BURGER_API Burger::Thread::Kill(void)
+{
+	Word uResult = 0;
+	if (m_bThreadStarted) {
+		pthread_cancel(m_ThreadHandle);
+		pthread_join(m_ThreadHandle,NULL);
+		m_bThreadStarted = FALSE;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Synchronize and then execute the thread and save
+	the result if any
+
+***************************************/
+
+void BURGER_API Burger::Thread::Run(void *pThis)
+{
+	Thread *pThread = static_cast<Thread *>(pThis);
+	pThread->m_pSemaphore->Release();
+	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
+}
+
+/***************************************
+
+	Return the number of CPU cores available
+
+***************************************/
+
+Word BURGER_API Burger::Thread::GetProcessorCount(void)
+{
+	long iResult = sysconf(_SC_NPROCESSORS_ONLN);
+	if (iResult<1) {
+		iResult = 1;
+	}
+	return static_cast<Word>(iResult);
+}
+
+#endif
@@ -0,0 +1,203 @@
+/***************************************
+
+	Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brdirectorysearch.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+#include "brfile.h"
+#include "brstringfunctions.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+//
+// Record returned by the getdents64() system call. glibc
+// only started exposing this in 2.30, so it's declared here
+// and the call is made through syscall()
+//
+
+struct LinuxDirent64_t {
+	Word64 d_ino;			// Inode number
+	Int64 d_off;			// Offset to the next record
+	unsigned short d_reclen;	// Length of this record
+	unsigned char d_type;	// File type
+	char d_name[1];			// Zero terminated filename (Variable length)
+};
+
+/***************************************
+
+	Using a Burgerlib path, open a directory to scan it
+	for filenames
+
+***************************************/
+
+Word Burger::DirectorySearch::Open(Burger::Filename *pDirName)
+{
+	// Make sure there's nothing pending
+	Close();
+	Word uResult = File::FILENOTFOUND;
+	// Open the directory for reading
+	int fp = open(pDirName->GetNative(),O_RDONLY|O_DIRECTORY|O_CLOEXEC,0);
+	if (fp!=-1) {
+		m_iDirectory = fp;
+		m_uBufferIndex = 0;
+		m_uBufferSize = 0;
+		uResult = File::OKAY;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Return a directory entry
+
+	Entries are read from the kernel in batches of
+	up to 4K so most calls are satisfied without
+	a system call to read the directory
+
+***************************************/
+
+Word Burger::DirectorySearch::GetNextEntry(void)
+{
+	// Assume no more entries
+	Word uResult = File::OUTOFRANGE;
+	int fp = m_iDirectory;
+	if (fp!=-1) {
+		for (;;) {
+			// Out of cached entries?
+			if (m_uBufferIndex>=m_uBufferSize) {
+				long iRead = syscall(SYS_getdents64,fp,m_Buffer,sizeof(m_Buffer));
+				// End of the directory or an error
+				if (iRead<=0) {
+					break;
+				}
+				m_uBufferSize = static_cast<Word>(iRead);
+				m_uBufferIndex = 0;
+			}
+			const LinuxDirent64_t *pEntry = reinterpret_cast<const LinuxDirent64_t *>(reinterpret_cast<const Word8 *>(m_Buffer)+m_uBufferIndex);
+			m_uBufferIndex += pEntry->d_reclen;
+
+			// Skip the "." and ".." entries
+			const char *pName = pEntry->d_name;
+			if ((pName[0]=='.') && (!pName[1] || ((pName[1]=='.') && !pName[2]))) {
+				continue;
+			}
+
+			// Get the file information, follow symbolic links, but
+			// if it's a broken link, use the link itself
+#if defined(STATX_BTIME)
+			// statx() returns the size, dates and creation time
+			// with a single call
+			struct statx MyStat;
+			if ((statx(fp,pName,0,STATX_BASIC_STATS|STATX_BTIME,&MyStat)==-1) &&
+				(statx(fp,pName,AT_SYMLINK_NOFOLLOW,STATX_BASIC_STATS|STATX_BTIME,&MyStat)==-1)) {
+				// Deleted before it could be examined?
+				continue;
+			}
+			Word uMode = MyStat.stx_mode;
+			Word64 uFileSize = MyStat.stx_size;
+			timespec ModificationTime;
+			ModificationTime.tv_sec = static_cast<time_t>(MyStat.stx_mtime.tv_sec);
+			ModificationTime.tv_nsec = static_cast<long>(MyStat.stx_mtime.tv_nsec);
+#else
+			struct stat MyStat;
+			if ((fstatat(fp,pName,&MyStat,0)==-1) &&
+				(fstatat(fp,pName,&MyStat,AT_SYMLINK_NOFOLLOW)==-1)) {
+				// Deleted before it could be examined?
+				continue;
+			}
+			Word uMode = MyStat.st_mode;
+			Word64 uFileSize = static_cast<Word64>(MyStat.st_size);
+			timespec ModificationTime = MyStat.st_mtim;
+#endif
+
+			// Grab the filename
+			StringCopy(m_Name,sizeof(m_Name),pName);
+
+			// Is it a symbolic link? Only file systems that don't
+			// record the type in the directory need an extra call
+			if (pEntry->d_type==DT_UNKNOWN) {
+				struct stat LinkStat;
+				m_bLink = (fstatat(fp,pName,&LinkStat,AT_SYMLINK_NOFOLLOW)!=-1) && S_ISLNK(LinkStat.st_mode);
+			} else {
+				m_bLink = (pEntry->d_type==DT_LNK);
+			}
+
+			// Is this a directory?
+			if (S_ISDIR(uMode)) {
+				m_bDir = TRUE;
+				m_uFileSize = 0;
+			} else {
+				m_bDir = FALSE;
+			// Get the file size (clamp on 32 bit systems)
+#if defined(BURGER_64BITCPU)
+				m_uFileSize = static_cast<WordPtr>(uFileSize);
+#else
+				if (uFileSize>=0xFFFFFFFFULL) {
+					m_uFileSize = 0xFFFFFFFFUL;
+				} else {
+					m_uFileSize = static_cast<WordPtr>(uFileSize);
+				}
+#endif
+			}
+
+			// Get the file dates
+			m_ModificatonDate.Load(&ModificationTime);
+			m_CreationDate.Clear();
+#if defined(STATX_BTIME)
+			// Not all file systems record the creation time
+			if (MyStat.stx_mask&STATX_BTIME) {
+				timespec CreationTime;
+				CreationTime.tv_sec = static_cast<time_t>(MyStat.stx_btime.tv_sec);
+				CreationTime.tv_nsec = static_cast<long>(MyStat.stx_btime.tv_nsec);
+				m_CreationDate.Load(&CreationTime);
+			}
+#endif
+
+			// Not valid on Linux
+			m_bSystem = FALSE;
+
+			// Files that start with a period are hidden
+			m_bHidden = (m_Name[0]=='.');
+
+			// Is the file read only?
+			m_bLocked = (uMode&(S_IWUSR|S_IWGRP|S_IWOTH))==0;
+
+			// It's parsed!
+			uResult = File::OKAY;
+			break;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Release an opened directory
+
+***************************************/
+
+void Burger::DirectorySearch::Close(void)
+{
+	int fp = m_iDirectory;
+	if (fp!=-1) {
+		close(fp);
+		m_iDirectory = -1;
+	}
+	m_uBufferIndex = 0;
+	m_uBufferSize = 0;
+}
+
+#endif
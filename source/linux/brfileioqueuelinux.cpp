@@ -0,0 +1,322 @@
+/***************************************
+
+	Asynchronous file I/O queue, Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfileioqueue.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+#include "bratomic.h"
+#include "brstringfunctions.h"
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+//
+// io_uring was added in kernel 5.1. If the headers predate it,
+// the worker thread fallback is used
+//
+
+#if defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+
+/***************************************
+
+	Call io_uring_enter() to submit entries and/or
+	wait for completions. glibc has no wrapper, so
+	it's called through syscall()
+
+***************************************/
+
+static int EnterRing(int iRing,Word32 uSubmit,Word32 uWait)
+{
+	int iResult;
+	do {
+		iResult = static_cast<int>(syscall(__NR_io_uring_enter,iRing,uSubmit,uWait,uWait ? IORING_ENTER_GETEVENTS : 0U,NULL,0));
+		// Interrupted by a signal? Try again
+	} while ((iResult==-1) && (errno==EINTR));
+	return iResult;
+}
+
+/***************************************
+
+	Create an io_uring and map its rings into memory
+
+	The ring has at least as many submission entries as
+	there are requests, and the kernel makes the completion
+	ring twice that size, so neither ring can overflow.
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::InitKernelQueue(void)
+{
+	io_uring_params Params;
+	MemoryClear(&Params,sizeof(Params));
+	int iRing = static_cast<int>(syscall(__NR_io_uring_setup,m_uDepth,&Params));
+	if (iRing==-1) {
+		// Kernel is too old or io_uring is disabled
+		return File::NOT_IMPLEMENTED;
+	}
+
+	WordPtr uSubmissionRingSize = Params.sq_off.array+(Params.sq_entries*sizeof(Word32));
+	WordPtr uCompletionRingSize = Params.cq_off.cqes+(Params.cq_entries*sizeof(io_uring_cqe));
+	// Newer kernels map both rings with a single call
+	Word bSingleMap = (Params.features&IORING_FEAT_SINGLE_MMAP)!=0;
+	if (bSingleMap) {
+		if (uCompletionRingSize>uSubmissionRingSize) {
+			uSubmissionRingSize = uCompletionRingSize;
+		}
+		uCompletionRingSize = uSubmissionRingSize;
+	}
+
+	void *pSubmissionRing = mmap(NULL,uSubmissionRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_SQ_RING);
+	if (pSubmissionRing!=MAP_FAILED) {
+		void *pCompletionRing = pSubmissionRing;
+		if (!bSingleMap) {
+			pCompletionRing = mmap(NULL,uCompletionRingSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_CQ_RING);
+		}
+		if (pCompletionRing!=MAP_FAILED) {
+			WordPtr uSubmissionEntriesSize = Params.sq_entries*sizeof(io_uring_sqe);
+			void *pSubmissionEntries = mmap(NULL,uSubmissionEntriesSize,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,iRing,IORING_OFF_SQES);
+			if (pSubmissionEntries!=MAP_FAILED) {
+				m_iRing = iRing;
+				m_pSubmissionRing = pSubmissionRing;
+				m_uSubmissionRingSize = uSubmissionRingSize;
+				m_pCompletionRing = pCompletionRing;
+				m_uCompletionRingSize = uCompletionRingSize;
+				m_pSubmissionEntries = pSubmissionEntries;
+				m_uSubmissionEntriesSize = uSubmissionEntriesSize;
+
+				// Cache the pointers to the ring variables
+				Word8 *pSQ = static_cast<Word8 *>(pSubmissionRing);
+				m_pSubmissionHead = reinterpret_cast<volatile Word32 *>(pSQ+Params.sq_off.head);
+				m_pSubmissionTail = reinterpret_cast<volatile Word32 *>(pSQ+Params.sq_off.tail);
+				m_pSubmissionArray = reinterpret_cast<Word32 *>(pSQ+Params.sq_off.array);
+				m_uSubmissionMask = reinterpret_cast<const Word32 *>(pSQ+Params.sq_off.ring_mask)[0];
+				Word8 *pCQ = static_cast<Word8 *>(pCompletionRing);
+				m_pCompletionHead = reinterpret_cast<volatile Word32 *>(pCQ+Params.cq_off.head);
+				m_pCompletionTail = reinterpret_cast<volatile Word32 *>(pCQ+Params.cq_off.tail);
+				m_uCompletionMask = reinterpret_cast<const Word32 *>(pCQ+Params.cq_off.ring_mask)[0];
+				m_pCompletionEntries = pCQ+Params.cq_off.cqes;
+				return File::OKAY;
+			}
+			if (!bSingleMap) {
+				munmap(pCompletionRing,uCompletionRingSize);
+			}
+		}
+		munmap(pSubmissionRing,uSubmissionRingSize);
+	}
+	close(iRing);
+	return File::NOT_IMPLEMENTED;
+}
+
+/***************************************
+
+	Unmap the rings and close the io_uring
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::ShutdownKernelQueue(void)
+{
+	if (m_iRing!=-1) {
+		munmap(m_pSubmissionEntries,m_uSubmissionEntriesSize);
+		if (m_pCompletionRing!=m_pSubmissionRing) {
+			munmap(m_pCompletionRing,m_uCompletionRingSize);
+		}
+		munmap(m_pSubmissionRing,m_uSubmissionRingSize);
+		close(m_iRing);
+		m_iRing = -1;
+	}
+	m_pSubmissionRing = NULL;
+	m_uSubmissionRingSize = 0;
+	m_pCompletionRing = NULL;
+	m_uCompletionRingSize = 0;
+	m_pSubmissionEntries = NULL;
+	m_uSubmissionEntriesSize = 0;
+	m_pSubmissionHead = NULL;
+	m_pSubmissionTail = NULL;
+	m_pSubmissionArray = NULL;
+	m_uSubmissionMask = 0;
+	m_uCompletionMask = 0;
+	m_pCompletionHead = NULL;
+	m_pCompletionTail = NULL;
+	m_pCompletionEntries = NULL;
+}
+
+/***************************************
+
+	Fill in a submission entry for each request and
+	hand them all to the kernel with a single system call
+
+	Vectored reads and writes are used since they were
+	supported by the first release of io_uring
+
+***************************************/
+
+void BURGER_API Burger::FileIOQueue::SubmitKernelQueue(Request_t *pList)
+{
+	// Only this thread writes the tail
+	Word32 uTail = m_pSubmissionTail[0];
+	io_uring_sqe *pEntries = static_cast<io_uring_sqe *>(m_pSubmissionEntries);
+	do {
+		Word32 uIndex = uTail&m_uSubmissionMask;
+		io_uring_sqe *pEntry = &pEntries[uIndex];
+		MemoryClear(pEntry,sizeof(io_uring_sqe));
+
+		// Pick up where a partial transfer left off
+		WordPtr uTransferred = pList->m_uTransferred;
+		pList->m_IOVector.iov_base = pList->m_pBuffer+uTransferred;
+		pList->m_IOVector.iov_len = pList->m_uSize-uTransferred;
+		pEntry->opcode = static_cast<Word8>(pList->m_bWrite ? IORING_OP_WRITEV : IORING_OP_READV);
+		pEntry->fd = static_cast<int>(reinterpret_cast<WordPtr>(pList->m_pFile->m_pFile));
+		pEntry->addr = reinterpret_cast<WordPtr>(&pList->m_IOVector);
+		pEntry->len = 1;
+		pEntry->off = pList->m_uOffset+uTransferred;
+		pEntry->user_data = reinterpret_cast<WordPtr>(pList);
+		m_pSubmissionArray[uIndex] = uIndex;
+		++uTail;
+		pList = pList->m_pNext;
+	} while (pList);
+
+	// Publish the entries and let the kernel at them
+	AtomicStore(m_pSubmissionTail,uTail,MEMORYORDER_RELEASE);
+	EnterRing(m_iRing,uTail-AtomicLoad(m_pSubmissionHead,MEMORYORDER_ACQUIRE),0);
+}
+
+/***************************************
+
+	Read the completion ring
+
+	Partial transfers and interrupted transfers are
+	submitted again for the remainder, so only requests that
+	are finished are returned. When told to wait, this
+	doesn't return until a request is finished, even if
+	the kernel stops accepting calls.
+
+***************************************/
+
+Burger::FileIOQueue::Request_t * BURGER_API Burger::FileIOQueue::ReapKernelQueue(Word bWait)
+{
+	Request_t *pDone = NULL;
+	Request_t **ppDone = &pDone;
+	const io_uring_cqe *pEntries = static_cast<const io_uring_cqe *>(m_pCompletionEntries);
+	for (;;) {
+		Request_t *pRetry = NULL;
+		Request_t **ppRetry = &pRetry;
+
+		// Only this thread writes the head
+		Word32 uHead = m_pCompletionHead[0];
+		Word32 uTail = AtomicLoad(m_pCompletionTail,MEMORYORDER_ACQUIRE);
+		if (uHead!=uTail) {
+			do {
+				const io_uring_cqe *pEntry = &pEntries[uHead&m_uCompletionMask];
+				Request_t *pRequest = reinterpret_cast<Request_t *>(static_cast<WordPtr>(pEntry->user_data));
+				int iResult = pEntry->res;
+				++uHead;
+				if (iResult>=0) {
+					pRequest->m_uTransferred += static_cast<WordPtr>(iResult);
+					if (pRequest->m_uTransferred>=pRequest->m_uSize) {
+						pRequest->m_uError = File::OKAY;
+					} else if (iResult) {
+						// Partial transfer, get the rest
+						ppRetry[0] = pRequest;
+						ppRetry = &pRequest->m_pNext;
+						continue;
+					} else {
+						// End of file is fine for reads
+						pRequest->m_uError = pRequest->m_bWrite ? static_cast<Word>(File::WRITEERROR) : static_cast<Word>(File::OKAY);
+					}
+				} else if ((iResult==-EINTR) || (iResult==-EAGAIN)) {
+					ppRetry[0] = pRequest;
+					ppRetry = &pRequest->m_pNext;
+					continue;
+				} else {
+					pRequest->m_uError = pRequest->m_bWrite ? static_cast<Word>(File::WRITEERROR) : static_cast<Word>(File::IOERROR);
+				}
+				ppDone[0] = pRequest;
+				ppDone = &pRequest->m_pNext;
+			} while (uHead!=uTail);
+			// Release the entries back to the kernel
+			AtomicStore(m_pCompletionHead,uHead,MEMORYORDER_RELEASE);
+		}
+		if (pRetry) {
+			ppRetry[0] = NULL;
+			SubmitKernelQueue(pRetry);
+		}
+		if (pDone || !bWait) {
+			break;
+		}
+		// Sleep until something completes, pushing along any
+		// entries the kernel didn't accept earlier
+		Word32 uSubmit = m_pSubmissionTail[0]-AtomicLoad(m_pSubmissionHead,MEMORYORDER_ACQUIRE);
+		if ((EnterRing(m_iRing,uSubmit,1)==-1) && (errno!=EAGAIN) && (errno!=EBUSY)) {
+
+			// The kernel refused the call. Entries it never took
+			// will not be performed, so fail them. The entries it
+			// has are still using their buffers, so don't return
+			// until they complete or the caller may release the
+			// buffers or the rings out from under the kernel.
+
+			Word32 uSubmitHead = AtomicLoad(m_pSubmissionHead,MEMORYORDER_ACQUIRE);
+			Word32 uSubmitTail = m_pSubmissionTail[0];
+			if (uSubmitHead!=uSubmitTail) {
+				const io_uring_sqe *pSubmitted = static_cast<const io_uring_sqe *>(m_pSubmissionEntries);
+				do {
+					Request_t *pRequest = reinterpret_cast<Request_t *>(static_cast<WordPtr>(pSubmitted[m_pSubmissionArray[uSubmitHead&m_uSubmissionMask]].user_data));
+					pRequest->m_uError = pRequest->m_bWrite ? static_cast<Word>(File::WRITEERROR) : static_cast<Word>(File::IOERROR);
+					ppDone[0] = pRequest;
+					ppDone = &pRequest->m_pNext;
+				} while (++uSubmitHead!=uSubmitTail);
+				// Take the entries back
+				AtomicStore(m_pSubmissionTail,uSubmitHead,MEMORYORDER_RELEASE);
+				break;
+			}
+			// Give the kernel time to post completions
+			timespec SleepTime;
+			SleepTime.tv_sec = 0;
+			SleepTime.tv_nsec = 1000000;
+			nanosleep(&SleepTime,NULL);
+		}
+	}
+	ppDone[0] = NULL;
+	return pDone;
+}
+
+#else
+
+/***************************************
+
+	The system headers don't support io_uring
+
+***************************************/
+
+Word BURGER_API Burger::FileIOQueue::InitKernelQueue(void)
+{
+	return File::NOT_IMPLEMENTED;
+}
+
+void BURGER_API Burger::FileIOQueue::ShutdownKernelQueue(void)
+{
+}
+
+void BURGER_API Burger::FileIOQueue::SubmitKernelQueue(Request_t * /* pList */)
+{
+}
+
+Burger::FileIOQueue::Request_t * BURGER_API Burger::FileIOQueue::ReapKernelQueue(Word /* bWait */)
+{
+	return NULL;
+}
+
+#endif
+#endif
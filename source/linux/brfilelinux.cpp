@@ -0,0 +1,547 @@
+/***************************************
+
+	Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfile.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+
+/***************************************
+
+	Linux version of Burger::File
+	Copyright Rebecca Ann Heineman
+
+	The file is accessed with the POSIX calls directly
+	so there is no stdio buffering between the
+	caller's buffer and the kernel's page cache.
+
+***************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+/***************************************
+
+	\brief Open a file using a Burger::Filename
+
+	Close any previously opened file and open a new file.
+
+	\note Files opened for read only access are tagged with
+	POSIX_FADV_SEQUENTIAL so the kernel will read ahead more
+	aggressively, since most reads are whole file loads.
+
+	\param pFileName Pointer to a Burger::Filename object
+	\param eAccess Enumeration on permissions requested on the opened file
+	\return File::OKAY if no error, error code if not.
+	\sa Open(const char *, eFileAccess) and File(const char *,eFileAccess)
+
+***************************************/
+
+Word Burger::File::Open(Filename *pFileName,eFileAccess eAccess)
+{
+	Close();
+	eAccess = static_cast<eFileAccess>(eAccess&3);
+
+	static const int g_Permissions[4] = { O_RDONLY|O_CLOEXEC,O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,O_WRONLY|O_CREAT|O_CLOEXEC,O_RDWR|O_CREAT|O_CLOEXEC };
+	int fp = open(pFileName->GetNative(),g_Permissions[eAccess],0666);
+	Word uResult = FILENOTFOUND;
+	if (fp!=-1) {
+		m_pFile = reinterpret_cast<void *>(static_cast<WordPtr>(fp));
+		uResult = OKAY;
+		if (eAccess==READONLY) {
+			// Only a hint, errors are ignored
+			posix_fadvise(fp,0,0,POSIX_FADV_SEQUENTIAL);
+		} else if (eAccess==APPEND) {
+			uResult = SetMarkAtEOF();
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Close any open file
+
+	Close any previously opened file
+
+	\return File::OKAY if no error, error code if not.
+	\sa Open(const char *, eFileAccess) and Open(Filename *,eFileAccess)
+
+***************************************/
+
+Word Burger::File::Close(void)
+{
+	Word uResult = OKAY;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		int eClose = close(fp);
+		if (eClose==-1) {
+			uResult = IOERROR;
+		}
+		m_pFile = NULL;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Return the size of a file in bytes
+
+	If a file is open, query the operating system for the size of the file
+	in bytes.
+
+	\note The return value is 32 bits wide on a 32 bit operating system, 64 bits
+	wide on 64 bit operating systems
+	\return 0 if error or an empty file. Non-zero is the size of the file in bytes.
+	\sa Open(const char *, eFileAccess) and Open(Filename *,eFileAccess)
+
+***************************************/
+
+WordPtr Burger::File::GetSize(void)
+{
+	WordPtr uSize = 0;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		int eError = fstat(fp,&MyStat);
+		if (eError!=-1) {
+#if defined(BURGER_64BITCPU)
+			uSize = static_cast<WordPtr>(MyStat.st_size);
+#else
+			if (static_cast<Word64>(MyStat.st_size)<=static_cast<Word64>(0xFFFFFFFFU)) {
+				uSize = static_cast<WordPtr>(MyStat.st_size);
+			} else {
+				uSize = 0xFFFFFFFFU;
+			}
+#endif
+		}
+	}
+	return uSize;
+}
+
+/***************************************
+
+	\brief Read data from an open file
+
+	If a file is open, perform a read operation. This function will fail
+	if the file was not opened for read access.
+
+	\note The kernel may return less data than requested on a single
+	call, so this will loop until the request is filled, the end of
+	the file is reached or an error occurs.
+
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa Write(const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::Read(void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pOutput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			do {
+				ssize_t iRead = read(fp,static_cast<Word8 *>(pOutput)+uResult,uSize-uResult);
+				if (iRead<=0) {
+					// Interrupted by a signal? Try again
+					if ((iRead==-1) && (errno==EINTR)) {
+						continue;
+					}
+					// End of file or an error
+					break;
+				}
+				uResult += static_cast<WordPtr>(iRead);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write data into an open file
+
+	If a file is open, perform a write operation. This function will fail
+	if the file was not opened for write access.
+
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa Read(void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::Write(const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			do {
+				ssize_t iWrite = write(fp,static_cast<const Word8 *>(pInput)+uResult,uSize-uResult);
+				if (iWrite<=0) {
+					if ((iWrite==-1) && (errno==EINTR)) {
+						continue;
+					}
+					// Disk full or an error
+					break;
+				}
+				uResult += static_cast<WordPtr>(iWrite);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Read data from an open file at a specific offset
+
+	The data is read with pread(), so the shared file mark
+	is neither used nor changed and multiple threads can read
+	from the same file at once.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::ReadAt(Word64 uOffset,void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pOutput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			do {
+				ssize_t iRead = pread(fp,static_cast<Word8 *>(pOutput)+uResult,uSize-uResult,static_cast<off_t>(uOffset+uResult));
+				if (iRead<=0) {
+					if ((iRead==-1) && (errno==EINTR)) {
+						continue;
+					}
+					break;
+				}
+				uResult += static_cast<WordPtr>(iRead);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write data into an open file at a specific offset
+
+	The data is written with pwrite(), so the shared file mark
+	is neither used nor changed.
+
+	\note Files opened with File::APPEND still write at the offset
+	requested, the mark is only placed at the end of the file on open.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa ReadAt(Word64,void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::WriteAt(Word64 uOffset,const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			do {
+				ssize_t iWrite = pwrite(fp,static_cast<const Word8 *>(pInput)+uResult,uSize-uResult,static_cast<off_t>(uOffset+uResult));
+				if (iWrite<=0) {
+					if ((iWrite==-1) && (errno==EINTR)) {
+						continue;
+					}
+					break;
+				}
+				uResult += static_cast<WordPtr>(iWrite);
+			} while (uResult<uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write several buffers into an open file at a specific offset
+
+	The buffers are written with pwritev() in batches, so
+	a long list of chunks costs a single system call per batch.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pVectors Pointer to an array of buffer descriptions
+	\param uCount Number of entries in pVectors
+	\return Number of bytes written (Can be less than what was requested due to write errors)
+	\sa WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::WriteAt(Word64 uOffset,const IOVector_t *pVectors,WordPtr uCount)
+{
+	WordPtr uResult = 0;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp && uCount) {
+		struct iovec Vectors[32];
+		// Bytes of the first vector that were already written
+		WordPtr uSkip = 0;
+		do {
+			WordPtr uBatch = 0;
+			WordPtr uTotal = 0;
+			do {
+				const Word8 *pBuffer = static_cast<const Word8 *>(pVectors[uBatch].m_pBuffer);
+				WordPtr uLength = pVectors[uBatch].m_uLength;
+				if (!uBatch) {
+					pBuffer += uSkip;
+					uLength -= uSkip;
+				}
+				Vectors[uBatch].iov_base = const_cast<Word8 *>(pBuffer);
+				Vectors[uBatch].iov_len = uLength;
+				uTotal += uLength;
+			} while ((++uBatch<uCount) && (uBatch<BURGER_ARRAYSIZE(Vectors)));
+			ssize_t iWrite = pwritev(fp,Vectors,static_cast<int>(uBatch),static_cast<off_t>(uOffset+uResult));
+			if (iWrite==-1) {
+				if (errno==EINTR) {
+					continue;
+				}
+				break;
+			}
+			// Nothing written? Only okay if the buffers were empty
+			if (!iWrite && uTotal) {
+				break;
+			}
+			uResult += static_cast<WordPtr>(iWrite);
+			// Remove the buffers that were completely written
+			WordPtr uWritten = static_cast<WordPtr>(iWrite)+uSkip;
+			while (uCount && (uWritten>=pVectors[0].m_uLength)) {
+				uWritten -= pVectors[0].m_uLength;
+				++pVectors;
+				--uCount;
+			}
+			uSkip = uWritten;
+		} while (uCount);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the current file mark
+
+	If a file is open, query the operating system for the location
+	of the file mark for future reads or writes.
+
+	\return Current file mark or zero if an error occured
+	\sa Write(const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::GetMark(void)
+{
+	WordPtr uMark = 0;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		off_t lCurrentMark = lseek(fp,0,SEEK_CUR);
+		if (lCurrentMark!=-1) {
+			uMark = static_cast<WordPtr>(lCurrentMark);
+		}
+	}
+	return uMark;
+}
+
+/***************************************
+
+	\brief Set the current file mark
+
+	If a file is open, set the read/write mark at the location passed.
+
+	\param uMark Value to set the new file mark to.
+	\return File::OKAY if successful, File::INVALID_MARK if not.
+	\sa GetMark() or SetMarkAtEOF()
+
+***************************************/
+
+Word Burger::File::SetMark(WordPtr uMark)
+{
+	Word uResult = INVALID_MARK;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		off_t lCurrentMark = lseek(fp,static_cast<off_t>(uMark),SEEK_SET);
+		if (lCurrentMark!=-1) {
+			uResult = OKAY;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the current file mark at the end of the file
+
+	If a file is open, set the read/write mark to the end of the file.
+
+	\return File::OKAY if successful, File::INVALID_MARK if not.
+	\sa GetMark() or SetMark()
+
+***************************************/
+
+Word Burger::File::SetMarkAtEOF(void)
+{
+	Word uResult = INVALID_MARK;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		off_t lCurrentMark = lseek(fp,0,SEEK_END);
+		if (lCurrentMark!=-1) {
+			uResult = OKAY;
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the time the file was last modified
+
+	If a file is open, query the operating system for the last time
+	the file was modified.
+
+	\param pOutput Pointer to a Burger::TimeDate_t to receive the file modification time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa GetCreationTime() or SetModificationTime()
+
+***************************************/
+
+Word Burger::File::GetModificationTime(TimeDate_t *pOutput)
+{
+	Word uResult = FILENOTFOUND;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		struct stat MyStat;
+		int eError = fstat(fp,&MyStat);
+		if (eError!=-1) {
+			// If it succeeded, the file must exist
+			pOutput->Load(&MyStat.st_mtim);
+			uResult = OKAY;
+		}
+	}
+	if (uResult!=OKAY) {
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Get the time the file was created
+
+	If a file is open, query the operating system for the time
+	the file was created.
+
+	\note Linux only records the creation time on some file systems
+	and it's only available through statx() with kernel 4.11 or higher.
+	File::NOT_IMPLEMENTED is returned if the time is not available.
+
+	\param pOutput Pointer to a Burger::TimeDate_t to receive the file creation time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa GetModificationTime() or SetCreationTime()
+
+***************************************/
+
+Word Burger::File::GetCreationTime(TimeDate_t *pOutput)
+{
+	Word uResult = NOT_IMPLEMENTED;
+#if defined(STATX_BTIME)
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (!fp) {
+		uResult = FILENOTFOUND;
+	} else {
+		struct statx MyStat;
+		int eError = statx(fp,"",AT_EMPTY_PATH,STATX_BTIME,&MyStat);
+		if ((eError!=-1) && (MyStat.stx_mask&STATX_BTIME)) {
+			timespec CreationTime;
+			CreationTime.tv_sec = static_cast<time_t>(MyStat.stx_btime.tv_sec);
+			CreationTime.tv_nsec = static_cast<long>(MyStat.stx_btime.tv_nsec);
+			pOutput->Load(&CreationTime);
+			uResult = OKAY;
+		}
+	}
+#endif
+	if (uResult!=OKAY) {
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the time the file was last modified
+
+	If a file is open, call the operating system to set the file
+	modification time to the passed value.
+
+	\param pInput Pointer to a Burger::TimeDate_t to use for the new file modification time
+	\return File::OKAY if successful, File::NOT_IMPLEMENTED if not available or other codes for errors
+	\sa SetCreationTime() or GetModificationTime()
+
+***************************************/
+
+Word Burger::File::SetModificationTime(const TimeDate_t *pInput)
+{
+	Word uResult = FILENOTFOUND;
+	int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+	if (fp) {
+		timespec Array[2];
+		if (!pInput->Store(&Array[1])) {
+			// Leave the access time alone
+			Array[0].tv_sec = 0;
+			Array[0].tv_nsec = UTIME_OMIT;
+			int eError = futimens(fp,Array);
+			if (eError!=-1) {
+				uResult = OKAY;
+			}
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Set the time the file was created
+
+	Linux does not allow the creation time of a file
+	to be changed.
+
+	\param pInput Pointer to a Burger::TimeDate_t to use for the new file creation time
+	\return File::NOT_IMPLEMENTED
+	\sa SetModificationTime() or GetCreationTime()
+
+***************************************/
+
+Word Burger::File::SetCreationTime(const TimeDate_t * /* pInput */)
+{
+	return NOT_IMPLEMENTED;
+}
+
+#endif
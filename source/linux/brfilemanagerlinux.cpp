@@ -0,0 +1,456 @@
+/***************************************
+
+	Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfilemanager.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+#include "brfile.h"
+#include "brdirectorysearch.h"
+#include "brpathcache.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brstring.h"
+#include <stdlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pwd.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	Given a drive number, return in generic format
+	the drive's name.
+
+	Linux has a single directory tree, so the
+	directories found in the root directory are
+	enumerated as volumes. A volume name of ":home:"
+	maps to "/home"
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetVolumeName(Burger::Filename *pOutput,Word uVolumeNum)
+{
+	Word uResult = File::OUTOFRANGE;
+	DirectorySearch MyDir;
+	if (!MyDir.Open(":")) {
+		Word uEntry = 0;
+		while (!MyDir.GetNextEntry()) {
+			// Only directories are volumes
+			if (MyDir.m_bDir) {
+				if (uEntry==uVolumeNum) {
+					// Insert a starting and ending colon
+					char NameBuffer[sizeof(MyDir.m_Name)+3];
+					NameBuffer[0] = ':';
+					WordPtr uIndex = StringLength(MyDir.m_Name);
+					MemoryCopy(NameBuffer+1,MyDir.m_Name,uIndex);
+					NameBuffer[uIndex+1] = ':';
+					NameBuffer[uIndex+2] = 0;
+					pOutput->Set(NameBuffer);
+					// Exit okay!
+					uResult = File::OKAY;
+					break;
+				}
+				++uEntry;
+			}
+		}
+	}
+
+	// Clear on error
+	if (uResult!=File::OKAY) {
+		// Kill the string since I have an error
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Set the initial default prefixs for a power up state
+	*: = Boot volume (The root directory)
+	$: = System folder (/etc)
+	@: = Prefs folder ($XDG_CONFIG_HOME or ~/.config)
+	8: = Default directory
+	9: = Application directory
+
+***************************************/
+
+void BURGER_API Burger::FileManager::DefaultPrefixes(void)
+{
+	// The root of the directory tree is the boot volume
+	SetPrefix(PREFIXBOOT,":");
+
+	Filename MyFilename;
+	char *pTemp = getcwd(NULL,0);
+	if (pTemp) {
+		MyFilename.SetFromNative(pTemp);
+		SetPrefix(PREFIXCURRENT,&MyFilename);		// Set the standard work prefix
+		free(pTemp);
+	}
+
+	// Where is the executable?
+	char NameBuffer[2048];
+	ssize_t iLength = readlink("/proc/self/exe",NameBuffer,sizeof(NameBuffer)-1);
+	if (iLength>0) {
+		NameBuffer[iLength] = 0;
+		MyFilename.SetFromNative(NameBuffer);
+		MyFilename.DirName();
+		SetPrefix(PREFIXAPPLICATION,&MyFilename);
+	}
+
+	// System configuration files
+	MyFilename.SetFromNative("/etc");
+	SetPrefix(PREFIXSYSTEM,&MyFilename);
+
+	// Follow the XDG base directory specification for preferences
+	const char *pConfig = getenv("XDG_CONFIG_HOME");
+	if (pConfig && (pConfig[0]=='/')) {
+		MyFilename.SetFromNative(pConfig);
+		SetPrefix(PREFIXPREFS,&MyFilename);
+	} else {
+		const char *pHome = getenv("HOME");
+		if (!pHome || (pHome[0]!='/')) {
+			// No environment? Ask the password database
+			const struct passwd *pPassword = getpwuid(getuid());
+			pHome = pPassword ? pPassword->pw_dir : NULL;
+		}
+		if (pHome) {
+			String ConfigName(pHome,"/.config");
+			MyFilename.SetFromNative(ConfigName.GetPtr());
+			SetPrefix(PREFIXPREFS,&MyFilename);
+		}
+	}
+}
+
+/***************************************
+
+	This routine will get the time and date
+	from a file.
+	Note, this routine is Operating system specfic!!!
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetModificationTime(Burger::Filename *pFileName,Burger::TimeDate_t *pOutput)
+{
+	Word uResult;
+	struct stat MyStat;
+	int eError = stat(pFileName->GetNative(),&MyStat);
+	if (eError==-1) {
+		pOutput->Clear();
+		uResult = File::FILENOTFOUND;
+	} else {
+		// Get the file date
+		pOutput->Load(&MyStat.st_mtim);
+		uResult = File::OKAY;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	This routine will get the time and date
+	from a file.
+	Note, this routine is Operating system specfic!!!
+
+	Linux only records the creation time on some
+	file systems and it requires statx()
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::GetCreationTime(Burger::Filename *pFileName,Burger::TimeDate_t *pOutput)
+{
+	Word uResult = File::NOT_IMPLEMENTED;
+#if defined(STATX_BTIME)
+	struct statx MyStat;
+	int eError = statx(AT_FDCWD,pFileName->GetNative(),0,STATX_BTIME,&MyStat);
+	if (eError==-1) {
+		uResult = File::FILENOTFOUND;
+	} else if (MyStat.stx_mask&STATX_BTIME) {
+		timespec CreationTime;
+		CreationTime.tv_sec = static_cast<time_t>(MyStat.stx_btime.tv_sec);
+		CreationTime.tv_nsec = static_cast<long>(MyStat.stx_btime.tv_nsec);
+		pOutput->Load(&CreationTime);
+		uResult = File::OKAY;
+	}
+#else
+	pFileName = NULL;
+#endif
+	if (uResult!=File::OKAY) {
+		pOutput->Clear();
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Determine if a file exists.
+	I will return TRUE if the specified path
+	is a path to a file that exists, if it doesn't exist
+	I return FALSE.
+	Note : I do not check if the file havs any data in it.
+	Just the existance of the file.
+
+	If the pathname cache is enabled, a file that was
+	found recently is reported without touching the file system.
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::DoesFileExist(Burger::Filename *pFileName)
+{
+	const char *pNative = pFileName->GetNative();
+	PathCache *pCache = GetPathCache();
+	if (pCache) {
+		String Resolved;
+		return pCache->Resolve(&Resolved,pNative);
+	}
+	Word uResult = FALSE;
+	struct stat MyStat;
+	int eError = stat(pNative,&MyStat);
+	if (eError>=0) {
+		// If it succeeded, the file must exist
+		uResult = TRUE;
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Create a directory path using an operating system native name
+	Return FALSE if successful, or TRUE if an error
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::CreateDirectoryPath(Burger::Filename *pFileName)
+{
+	// Assume an eror condition
+	Word uResult = File::IOERROR;
+	// Get the full path
+	const char *pPath = pFileName->GetNative();
+
+	// Already here?
+
+	struct stat MyStat;
+	int eError = stat(pPath,&MyStat);
+	if (eError==0) {
+		// Ensure it's a directory for sanity's sake
+		if (S_ISDIR(MyStat.st_mode)) {
+			// There already is a directory here by this name.
+			// Exit okay!
+			uResult = File::OKAY;
+		}
+
+	} else {
+		// No folder here...
+		// Let's try the easy way
+		eError = mkdir(pPath,0777);
+		if (eError==0) {
+			// That was easy!
+			uResult = File::OKAY;
+
+		} else {
+
+			// Check the pathname
+			if (pPath[0]) {
+
+				// This is more complex, parse each
+				// segment of the folder to see if it
+				// either already exists, and if not,
+				// create it.
+
+				// Skip the leading '/'
+				char *pWork = const_cast<char *>(pPath)+1;
+				// Is there a mid fragment?
+				char *pEnd = StringCharacter(pWork,'/');
+				if (pEnd) {
+
+					// Let's iterate! Assume success unless
+					// an error occurs in this loop.
+
+					uResult = File::OKAY;
+					do {
+						// Terminate at the fragment
+						pEnd[0] = 0;
+						// Create the directory (Maybe)
+						eError = mkdir(pPath,0777);
+						// Restore the pathname
+						pEnd[0] = '/';
+						// Error and it's not because it's already present
+						if (eError!=0 && errno != EEXIST) {
+							// Uh, oh... Perhaps not enough permissions?
+							uResult = File::IOERROR;
+							break;
+						}
+						// Skip past this fragment
+						pWork = pEnd+1;
+						// Get to the next fragement
+						pEnd = StringCharacter(pWork,'/');
+						// All done?
+					} while (pEnd);
+
+					// Create the final directory
+					if (uResult==File::OKAY) {
+						eError = mkdir(pPath,0777);
+						if (eError!=0 && errno != EEXIST) {
+							uResult = File::IOERROR;
+						}
+					}
+				}
+			}
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Change a directory using long filenames
+	This only accepts Native OS filenames
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::ChangeOSDirectory(Burger::Filename *pDirName)
+{
+	if (!chdir(pDirName->GetNative())) {
+		return FALSE;
+	}
+	return static_cast<Word>(-1);	// Error!
+}
+
+/***************************************
+
+	Open a file using a native path
+
+***************************************/
+
+FILE * BURGER_API Burger::FileManager::OpenFile(Burger::Filename *pFileName,const char *pType)
+{
+	return fopen(pFileName->GetNative(),pType);
+}
+
+/***************************************
+
+	Copy a file using native pathnames
+
+	The data is moved with pread() and pwrite()
+	in 1 megabyte chunks so neither file's mark
+	is touched and the stdio buffers are bypassed
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::CopyFile(Burger::Filename *pDestName,Burger::Filename *pSourceName)
+{
+	Word uResult = File::FILENOTFOUND;
+	int iSource = open(pSourceName->GetNative(),O_RDONLY|O_CLOEXEC);
+	if (iSource!=-1) {
+		struct stat MyStat;
+		if (fstat(iSource,&MyStat)!=-1) {
+			// Tell the kernel to read ahead, since the file is read in order
+			posix_fadvise(iSource,0,0,POSIX_FADV_SEQUENTIAL);
+			uResult = File::IOERROR;
+			int iDest = open(pDestName->GetNative(),O_WRONLY|O_CREAT|O_TRUNC|O_CLOEXEC,MyStat.st_mode&0777);
+			if (iDest!=-1) {
+				Word64 uLength = static_cast<Word64>(MyStat.st_size);
+				WordPtr uMaxChunk = (uLength<0x100000U) ? static_cast<WordPtr>(uLength) : 0x100000U;
+				Word8 *pBuffer = NULL;
+				if (uMaxChunk) {
+					pBuffer = static_cast<Word8 *>(Alloc(uMaxChunk));
+				}
+				if (pBuffer || !uLength) {
+					off_t uOffset = 0;
+					while (uLength) {
+						WordPtr uChunk = uMaxChunk;
+						if (uChunk>uLength) {
+							uChunk = static_cast<WordPtr>(uLength);	// Only copy the remainder
+						}
+						ssize_t iRead = pread(iSource,pBuffer,uChunk,uOffset);
+						if (iRead<=0) {
+							if ((iRead==-1) && (errno==EINTR)) {
+								continue;
+							}
+							break;
+						}
+						// Write out everything that was read
+						ssize_t iWritten = 0;
+						do {
+							ssize_t iWrite = pwrite(iDest,pBuffer+iWritten,static_cast<size_t>(iRead-iWritten),uOffset+iWritten);
+							if (iWrite<=0) {
+								if ((iWrite==-1) && (errno==EINTR)) {
+									continue;
+								}
+								break;
+							}
+							iWritten += iWrite;
+						} while (iWritten<iRead);
+						if (iWritten!=iRead) {
+							break;
+						}
+						uOffset += iRead;
+						uLength -= static_cast<Word64>(iRead);
+					}
+					if (!uLength) {
+						uResult = File::OKAY;	// No error (So far)
+					}
+					Free(pBuffer);
+				}
+				if (close(iDest)) {		// Did the file have an error in closing?
+					uResult = File::IOERROR;
+				}
+			}
+		}
+		close(iSource);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Delete a file using native file system
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::DeleteFile(Burger::Filename *pFileName)
+{
+	const char *pNative = pFileName->GetNative();
+	if (!remove(pNative)) {
+		// Forget that it existed
+		PathCache *pCache = GetPathCache();
+		if (pCache) {
+			pCache->Invalidate(pNative);
+		}
+		return FALSE;
+	}
+	return TRUE;		/* Oh oh... */
+}
+
+/***************************************
+
+	Rename a file using native pathnames
+
+***************************************/
+
+Word BURGER_API Burger::FileManager::RenameFile(Burger::Filename *pNewName,Burger::Filename *pOldName)
+{
+	const char *pOldNative = pOldName->GetNative();
+	const char *pNewNative = pNewName->GetNative();
+	if (!rename(pOldNative,pNewNative)) {
+		PathCache *pCache = GetPathCache();
+		if (pCache) {
+			pCache->Invalidate(pOldNative);
+			pCache->Invalidate(pNewNative);
+		}
+		return FALSE;
+	}
+	return TRUE;		/* Oh oh... */
+}
+
+#endif
@@ -0,0 +1,181 @@
+/***************************************
+
+	Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brfilename.h"
+
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+#include "brfilemanager.h"
+#include "brpathcache.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+/***************************************
+
+	Expand a filename into Linux format.
+
+	Using the rules for a Burgerlib type pathname, expand a path
+	into a FULL pathname native to the Linux file system.
+
+	Linux has a single directory tree, so the "volume" at the
+	start of a fully qualified Burgerlib pathname is the directory
+	in the root of the tree with that name.
+
+	Directory delimiters are colons only.
+	If the path starts with a colon, then it is a full pathname starting with a volume name.
+	If the path starts with a "$:","*:" or "@:" then use special prefix numbers 32-34
+	If the path starts with 0: through 31: then use prefix 0-31.
+	Otherwise prepend the pathname with the contents of prefix 8 ("Default")
+
+	All returned pathnames will NOT have a trailing "/", they will
+	take the form of /foo/bar/file.txt or similar
+
+	Since Linux file systems are case sensitive, the pathname is
+	passed through the FileManager's PathCache to match the case
+	of the names on disk.
+
+	Examples:<br>
+	":home:user:foo.txt" = "/home/user/foo.txt"<br>
+	"*:etc:hosts" = "/etc/hosts"<br>
+	"@:game:data.dat" = "/home/<Current user>/.config/game/data.dat"
+
+***************************************/
+
+const char *Burger::Filename::GetNative(void)
+{
+	Expand();		// Resolve prefixes
+
+	const Word8 *pFullPathName = reinterpret_cast<const Word8 *>(m_pFilename);
+	WordPtr uOutputLength = StringLength(reinterpret_cast<const char *>(pFullPathName))+10;
+	char *pOutput = m_NativeFilename;
+	if (uOutputLength>=sizeof(m_NativeFilename)) {
+		pOutput = static_cast<char *>(Alloc(uOutputLength));
+		if (!pOutput) {
+			m_NativeFilename[0] = 0;
+			return m_NativeFilename;
+		}
+	}
+	m_pNativeFilename = pOutput;
+
+	// Convert the path, colons to slashes
+	// The leading colon of a fully qualified name becomes the root slash
+
+	Word uTemp = pFullPathName[0];
+	if (uTemp) {
+		do {
+			++pFullPathName;
+			if (uTemp==':') {
+				uTemp = '/';		// Unix style
+			}
+			pOutput[0] = static_cast<char>(uTemp);
+			++pOutput;
+			uTemp = pFullPathName[0];
+		} while (uTemp);
+
+		// A trailing slash assumes more to follow, get rid of it
+		--pOutput;
+		if ((pOutput==m_pNativeFilename) ||		// Only a '/'? (Skip the check then)
+			(reinterpret_cast<Word8*>(pOutput)[0]!='/')) {
+			++pOutput;		// Remove trailing slash
+		}
+	}
+	pOutput[0] = 0;			// Terminate the "C" string
+
+	// Match the case of the files on disk
+	PathCache *pCache = FileManager::GetPathCache();
+	if (pCache) {
+		String Resolved;
+		pCache->Resolve(&Resolved,m_pNativeFilename);
+		// Only the case changes, so the length is the same
+		MemoryCopy(m_pNativeFilename,Resolved.GetPtr(),Resolved.GetLength());
+	}
+	return m_pNativeFilename;
+}
+
+/***************************************
+
+	Convert a Linux filename into BurgerLib format.
+
+	Using the rules for a Burgerlib type pathname, expand a path
+	from a Linux filename into BurgerLib.
+
+	The pathname will have an ending colon.
+
+	Examples:<br>
+	"/foo/bar.txt" = ":foo:bar.txt:"<br>
+	"./foo/bar.txt" = "8:foo:bar.txt:"<br>
+	"bar.txt" = "8:bar.txt:"
+
+***************************************/
+
+void Burger::Filename::SetFromNative(const char *pInput)
+{
+	Clear();	// Clear out the previous string
+
+	// Determine the length of the prefix
+	WordPtr uInputLength = StringLength(pInput);
+	const char *pBaseName;
+	WordPtr uBaseNameLength;
+	if (reinterpret_cast<const Word8 *>(pInput)[0]!='/') {		// Must I prefix with the current directory?
+		if ((uInputLength>=2) && !MemoryCompare("./",pInput,2)) {		// Dispose of "current directory"
+			pInput+=2;
+			uInputLength-=2;
+		}
+		pBaseName = "8:";
+		uBaseNameLength = 2;
+	} else {
+		// The leading slash will be converted into the leading colon
+		pBaseName = NULL;
+		uBaseNameLength = 0;
+	}
+
+	WordPtr uOutputLength = uBaseNameLength+uInputLength+10;
+	char *pOutput = m_Filename;
+	if (uOutputLength>=sizeof(m_Filename)) {
+		pOutput = static_cast<char *>(Alloc(uOutputLength));
+		if (!pOutput) {
+			return;
+		}
+	}
+	m_pFilename = pOutput;
+
+	if (uBaseNameLength) {
+		MemoryCopy(pOutput,pBaseName,uBaseNameLength);
+		pOutput+=uBaseNameLength;
+	}
+
+	// Now, just copy the rest of the path
+
+	Word uTemp = reinterpret_cast<const Word8*>(pInput)[0];
+	if (uTemp) {				// Any more?
+		do {
+			++pInput;			// Accept char
+			if (uTemp=='/') {
+				uTemp = ':';
+			}
+			pOutput[0] = static_cast<char>(uTemp);	// Save char
+			++pOutput;
+			uTemp = reinterpret_cast<const Word8*>(pInput)[0];	// Next char
+		} while (uTemp);		// Still more?
+	}
+
+	// The wrap up...
+	// Make sure it's appended with a colon
+
+	if ((pOutput==m_pFilename) || (reinterpret_cast<const Word8*>(pOutput)[-1]!=':')) {
+		pOutput[0] = ':';
+		++pOutput;
+	}
+	pOutput[0] = 0;			// End the string with zero
+}
+
+#endif
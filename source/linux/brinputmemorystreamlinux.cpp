@@ -0,0 +1,70 @@
+/***************************************
+
+	Simple data stream class for input, Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brinputmemorystream.h"
+
+#if defined(BURGER_LINUX)
+#include "brfilename.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	Map a file into memory
+
+	The file descriptor is closed once the mapping
+	is created, the mapping keeps its own reference
+	to the file.
+
+***************************************/
+
+const Word8 * BURGER_API Burger::InputMemoryStream::MapFile(Filename *pFilename,WordPtr *pSize,eAccessHint eHint)
+{
+	pSize[0] = 0;
+	int fp = open(pFilename->GetNative(),O_RDONLY|O_CLOEXEC,0);
+	if (fp==-1) {
+		return NULL;
+	}
+	const Word8 *pResult = NULL;
+	struct stat MyStat;
+	// Empty files can't be mapped and only regular files have a size
+	if ((fstat(fp,&MyStat)!=-1) && S_ISREG(MyStat.st_mode) && (MyStat.st_size>0) &&
+		(static_cast<Word64>(MyStat.st_size)==static_cast<WordPtr>(MyStat.st_size))) {
+		WordPtr uSize = static_cast<WordPtr>(MyStat.st_size);
+		void *pMap = mmap(NULL,uSize,PROT_READ,MAP_PRIVATE,fp,0);
+		if (pMap!=MAP_FAILED) {
+			static const int g_Advice[4] = { MADV_NORMAL,MADV_SEQUENTIAL,MADV_RANDOM,MADV_WILLNEED };
+			// It's only a hint, so errors are ignored
+			madvise(pMap,uSize,g_Advice[eHint&3]);
+			pResult = static_cast<const Word8 *>(pMap);
+			pSize[0] = uSize;
+		}
+	}
+	close(fp);
+	return pResult;
+}
+
+/***************************************
+
+	Release a memory mapped file
+
+***************************************/
+
+void BURGER_API Burger::InputMemoryStream::UnmapFile(const Word8 *pData,WordPtr uSize)
+{
+	munmap(const_cast<Word8 *>(pData),uSize);
+}
+
+#endif
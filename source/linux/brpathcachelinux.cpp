@@ -0,0 +1,128 @@
+/***************************************
+
+	Case insensitive pathname cache, Linux version
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brpathcache.h"
+
+#if defined(BURGER_LINUX)
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/***************************************
+
+	Convert the modification time into a single value
+
+***************************************/
+
+static Word64 GetStampFromStat(const struct stat *pStat)
+{
+	return (static_cast<Word64>(pStat->st_mtim.tv_sec)*1000000000ULL)+static_cast<Word64>(pStat->st_mtim.tv_nsec);
+}
+
+/***************************************
+
+	Read all of the names in a directory
+
+	The modification time is read before the names, so
+	if the directory changes while it's being read, the
+	listing will be read again when it's revalidated.
+
+***************************************/
+
+Burger::PathCache::Directory_t * BURGER_API Burger::PathCache::ReadDirectory(const char *pNative)
+{
+	int iDirectory = open(pNative,O_RDONLY|O_DIRECTORY|O_CLOEXEC,0);
+	if (iDirectory==-1) {
+		return NULL;
+	}
+	struct stat MyStat;
+	if (fstat(iDirectory,&MyStat)==-1) {
+		close(iDirectory);
+		return NULL;
+	}
+	// The DIR owns the file descriptor now
+	DIR *pDir = fdopendir(iDirectory);
+	if (!pDir) {
+		close(iDirectory);
+		return NULL;
+	}
+
+	// Collect the names into a single buffer
+	char *pText = NULL;
+	WordPtr uTextSize = 0;
+	WordPtr uTextMax = 0;
+	WordPtr uCount = 0;
+	Word bError = FALSE;
+	struct dirent *pEntry;
+	while ((pEntry = readdir(pDir))!=NULL) {
+		const char *pName = pEntry->d_name;
+		// Skip the "." and ".." entries
+		if ((pName[0]=='.') && (!pName[1] || ((pName[1]=='.') && !pName[2]))) {
+			continue;
+		}
+		WordPtr uLength = StringLength(pName)+1;
+		if ((uTextSize+uLength)>uTextMax) {
+			uTextMax = (uTextMax*2)+uLength+1024;
+			char *pNew = static_cast<char *>(Realloc(pText,uTextMax));
+			if (!pNew) {
+				bError = TRUE;
+				break;
+			}
+			pText = pNew;
+		}
+		MemoryCopy(pText+uTextSize,pName,uLength);
+		uTextSize += uLength;
+		++uCount;
+	}
+	closedir(pDir);
+
+	Directory_t *pResult = NULL;
+	if (!bError) {
+		pResult = NewDirectory(pText,uTextSize,uCount,GetStampFromStat(&MyStat));
+	}
+	Free(pText);
+	return pResult;
+}
+
+/***************************************
+
+	Get the modification time of a directory
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::GetStamp(const char *pNative,Word64 *pStamp)
+{
+	struct stat MyStat;
+	if (stat(pNative,&MyStat)==-1) {
+		pStamp[0] = 0;
+		return TRUE;
+	}
+	pStamp[0] = GetStampFromStat(&MyStat);
+	return FALSE;
+}
+
+/***************************************
+
+	Test if a native pathname exists
+
+***************************************/
+
+Word BURGER_API Burger::PathCache::DoesPathExist(const char *pNative)
+{
+	return !access(pNative,F_OK);
+}
+
+#endif
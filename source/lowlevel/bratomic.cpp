@@ -12,6 +12,7 @@
 ***************************************/
 
 #include "bratomic.h"
+#include "brtick.h"
 
 /*! ************************************
 
@@ -115,7 +116,7 @@
 
 /*! ************************************
 
-	\fn Word32 Burger::AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter)
+	\fn Word Burger::AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter)
 	\brief Atomically set a 32 bit value from a variable in memory if it matches a requested value
 
 	For multi-CPU machines, this function will atomically test a value
@@ -130,6 +131,38 @@
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word32 Burger::AtomicGet(volatile Word32 *pInput)
+	\brief Atomically load a 32 bit variable from memory with acquire semantics
+
+	For multi-CPU machines, this function will read a value from memory
+	and ensure that no loads or stores that follow it in program order
+	are performed before it. Pair it with AtomicSet(volatile Word32 *,Word32)
+	to safely pass data written by one thread to another without
+	the cost of a locked instruction.
+
+	\param pInput Pointer to a 32 bit aligned memory location to read
+	\return Value that was stored in the variable
+	\sa AtomicSet(volatile Word32 *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicSet(volatile Word32 *pOutput,Word32 uInput)
+	\brief Atomically store a 32 bit variable to memory with release semantics
+
+	For multi-CPU machines, this function will write a value to memory
+	and ensure that all loads and stores that precede it in program order
+	are visible to other CPUs before the new value is.
+
+	\param pOutput Pointer to a 32 bit aligned memory location to write to
+	\param uInput 32 bit value to store
+	\sa AtomicGet(volatile Word32 *)
+
+***************************************/
+
 /*! ************************************
 
 	\fn Word64 Burger::AtomicSwap(volatile Word64 *pOutput,Word64 uInput)
@@ -239,7 +272,7 @@
 
 /*! ************************************
 
-	\fn Word64 Burger::AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter)
+	\fn Word Burger::AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter)
 	\brief Atomically set a 64 bit value from a variable in memory if it matches a requested value
 
 	For multi-CPU machines, this function will atomically test a value
@@ -255,3 +288,626 @@
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word64 Burger::AtomicGet(volatile Word64 *pInput)
+	\brief Atomically load a 64 bit variable from memory with acquire semantics
+
+	For multi-CPU machines, this function will read a value from memory
+	and ensure that no loads or stores that follow it in program order
+	are performed before it. Pair it with AtomicSet(volatile Word64 *,Word64)
+	to safely pass data written by one thread to another without
+	the cost of a locked instruction.
+
+	\note This function is only available on systems with a 64 bit CPU
+	\param pInput Pointer to a 64 bit aligned memory location to read
+	\return Value that was stored in the variable
+	\sa AtomicSet(volatile Word64 *,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicSet(volatile Word64 *pOutput,Word64 uInput)
+	\brief Atomically store a 64 bit variable to memory with release semantics
+
+	For multi-CPU machines, this function will write a value to memory
+	and ensure that all loads and stores that precede it in program order
+	are visible to other CPUs before the new value is.
+
+	\note This function is only available on systems with a 64 bit CPU
+	\param pOutput Pointer to a 64 bit aligned memory location to write to
+	\param uInput 64 bit value to store
+	\sa AtomicGet(volatile Word64 *)
+
+***************************************/
+
+/*! ************************************
+
+	\enum Burger::eMemoryOrder
+	\brief Memory ordering for atomic operations
+
+	These values describe which loads and stores may be moved by the
+	compiler or CPU across an atomic operation. Weaker orders are faster
+	on CPUs that reorder memory accesses, such as PowerPC and ARM. The values
+	match the __ATOMIC_* constants used by GNU compilers so they can be passed
+	through without conversion.
+
+	\sa AtomicLoad(volatile Word32 *,eMemoryOrder) or Atomic
+
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_ATOMIC64
+	\brief Defined if 64 bit atomic operations are available
+
+	32 bit Windows and MSDOS targets don't have 64 bit atomic
+	functions. Test for this define before using the 64 bit versions or
+	an Atomic template of a 64 bit type.
+
+	\sa AtomicLoad(volatile Word64 *,eMemoryOrder)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicFence(eMemoryOrder eOrder)
+	\brief Issue a memory barrier
+
+	Prevent the compiler and CPU from moving loads and stores across
+	this point as described by eOrder. \ref MEMORYORDER_RELAXED does nothing.
+
+	\param eOrder Type of barrier to issue
+	\sa eMemoryOrder
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::AtomicLoad(volatile Word32 *pInput,eMemoryOrder eOrder)
+	\brief Atomically load a 32 bit value from memory
+
+	Read a value that another thread may be writing to at the same time.
+	eOrder should be \ref MEMORYORDER_RELAXED, \ref MEMORYORDER_ACQUIRE
+	or \ref MEMORYORDER_SEQCST.
+
+	\param pInput Pointer to a 32 bit aligned memory location to read
+	\param eOrder Memory ordering for the load
+	\return Value stored in memory
+	\sa AtomicStore(volatile Word32 *,Word32,eMemoryOrder) or AtomicGet(volatile Word32 *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicStore(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder)
+	\brief Atomically store a 32 bit value to memory
+
+	Write a value that another thread may be reading at the same time.
+	eOrder should be \ref MEMORYORDER_RELAXED, \ref MEMORYORDER_RELEASE
+	or \ref MEMORYORDER_SEQCST.
+
+	\param pOutput Pointer to a 32 bit aligned memory location to write to
+	\param uInput 32 bit value to store
+	\param eOrder Memory ordering for the store
+	\sa AtomicLoad(volatile Word32 *,eMemoryOrder) or AtomicSet(volatile Word32 *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::AtomicExchange(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder)
+	\brief Atomically swap a 32 bit value with memory ordering
+
+	\param pOutput Pointer to a 32 bit aligned memory location swap with
+	\param uInput 32 bit value to exchange with the memory location
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicSwap(volatile Word32 *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::AtomicFetchAdd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder)
+	\brief Atomically add a 32 bit value with memory ordering
+
+	A reference count increment only needs \ref MEMORYORDER_RELAXED,
+	while the decrement that may release the object needs
+	\ref MEMORYORDER_ACQREL.
+
+	\param pInput Pointer to a 32 bit aligned memory location to add to
+	\param uValue 32 bit value to add
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicAdd(volatile Word32 *,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::AtomicFetchOr(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder)
+	\brief Atomically logical OR a 32 bit value with memory ordering
+
+	Set bits in a shared flags variable and return the previous flags so the
+	caller can tell if it was the thread that changed them.
+
+	\param pInput Pointer to a 32 bit aligned memory location to modify
+	\param uValue 32 bit mask to apply with a logical OR
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicFetchAnd(volatile Word32 *,Word32,eMemoryOrder)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word32 Burger::AtomicFetchAnd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder)
+	\brief Atomically logical AND a 32 bit value with memory ordering
+
+	Clear bits in a shared flags variable and return the previous flags so the
+	caller can tell if it was the thread that changed them.
+
+	\param pInput Pointer to a 32 bit aligned memory location to modify
+	\param uValue 32 bit mask to apply with a logical AND
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicFetchOr(volatile Word32 *,Word32,eMemoryOrder)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::AtomicCompareExchange(volatile Word32 *pInput,Word32 *pExpected,Word32 uDesired,eMemoryOrder eOrder)
+	\brief Atomically replace a 32 bit value if it matches an expected value
+
+	If the value in memory matches the value pointed to by pExpected, it's
+	replaced with uDesired. Otherwise, the value found in memory is
+	stored in pExpected so a compare and swap loop doesn't need to reload it.
+
+	\note On some platforms the reloaded value is read after the failed
+	compare, so a loop must always retry instead of assuming the value
+	in pExpected is still in memory.
+
+	\param pInput Pointer to a 32 bit aligned memory location to modify
+	\param pExpected Pointer to the value expected in memory, updated on failure
+	\param uDesired 32 bit value to store on a match
+	\param eOrder Memory ordering for the operation
+	\return \ref TRUE if the value was stored, \ref FALSE if not
+	\sa AtomicSetIfMatch(volatile Word32 *,Word32,Word32)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::AtomicLoad(volatile Word64 *pInput,eMemoryOrder eOrder)
+	\brief Atomically load a 64 bit value from memory
+
+	Read a value that another thread may be writing to at the same time.
+	eOrder should be \ref MEMORYORDER_RELAXED, \ref MEMORYORDER_ACQUIRE
+	or \ref MEMORYORDER_SEQCST.
+
+	\param pInput Pointer to a 64 bit aligned memory location to read
+	\param eOrder Memory ordering for the load
+	\return Value stored in memory
+	\sa AtomicStore(volatile Word64 *,Word64,eMemoryOrder) or AtomicGet(volatile Word64 *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicStore(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder)
+	\brief Atomically store a 64 bit value to memory
+
+	Write a value that another thread may be reading at the same time.
+	eOrder should be \ref MEMORYORDER_RELAXED, \ref MEMORYORDER_RELEASE
+	or \ref MEMORYORDER_SEQCST.
+
+	\param pOutput Pointer to a 64 bit aligned memory location to write to
+	\param uInput 64 bit value to store
+	\param eOrder Memory ordering for the store
+	\sa AtomicLoad(volatile Word64 *,eMemoryOrder) or AtomicSet(volatile Word64 *,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::AtomicExchange(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder)
+	\brief Atomically swap a 64 bit value with memory ordering
+
+	\param pOutput Pointer to a 64 bit aligned memory location swap with
+	\param uInput 64 bit value to exchange with the memory location
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicSwap(volatile Word64 *,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::AtomicFetchAdd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder)
+	\brief Atomically add a 64 bit value with memory ordering
+
+	A reference count increment only needs \ref MEMORYORDER_RELAXED,
+	while the decrement that may release the object needs
+	\ref MEMORYORDER_ACQREL.
+
+	\param pInput Pointer to a 64 bit aligned memory location to add to
+	\param uValue 64 bit value to add
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicAdd(volatile Word64 *,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::AtomicFetchOr(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder)
+	\brief Atomically logical OR a 64 bit value with memory ordering
+
+	Set bits in a shared flags variable and return the previous flags so the
+	caller can tell if it was the thread that changed them.
+
+	\param pInput Pointer to a 64 bit aligned memory location to modify
+	\param uValue 64 bit mask to apply with a logical OR
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicFetchAnd(volatile Word64 *,Word64,eMemoryOrder)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::AtomicFetchAnd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder)
+	\brief Atomically logical AND a 64 bit value with memory ordering
+
+	Clear bits in a shared flags variable and return the previous flags so the
+	caller can tell if it was the thread that changed them.
+
+	\param pInput Pointer to a 64 bit aligned memory location to modify
+	\param uValue 64 bit mask to apply with a logical AND
+	\param eOrder Memory ordering for the operation
+	\return Value that was stored in the variable previously
+	\sa AtomicFetchOr(volatile Word64 *,Word64,eMemoryOrder)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::AtomicCompareExchange(volatile Word64 *pInput,Word64 *pExpected,Word64 uDesired,eMemoryOrder eOrder)
+	\brief Atomically replace a 64 bit value if it matches an expected value
+
+	If the value in memory matches the value pointed to by pExpected, it's
+	replaced with uDesired. Otherwise, the value found in memory is
+	stored in pExpected so a compare and swap loop doesn't need to reload it.
+
+	\note On some platforms the reloaded value is read after the failed
+	compare, so a loop must always retry instead of assuming the value
+	in pExpected is still in memory.
+
+	\param pInput Pointer to a 64 bit aligned memory location to modify
+	\param pExpected Pointer to the value expected in memory, updated on failure
+	\param uDesired 64 bit value to store on a match
+	\param eOrder Memory ordering for the operation
+	\return \ref TRUE if the value was stored, \ref FALSE if not
+	\sa AtomicSetIfMatch(volatile Word64 *,Word64,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::AtomicPair_t
+	\brief Two pointer sized values that can be swapped as a unit
+
+	Lock free linked lists suffer from the ABA problem, where a node is
+	removed and added back by other threads between the read of the
+	head pointer and the compare and swap. Pairing the pointer with a
+	counter that changes on every update makes the compare and swap fail
+	in that case.
+
+	The structure is aligned to twice the size of a pointer as
+	required by the CPU instructions.
+
+	\sa AtomicSetIfMatch(volatile AtomicPair_t *,AtomicPair_t *,const AtomicPair_t *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter)
+	\brief Atomically compare and swap two pointer sized values
+
+	If both values in memory match pBefore, they're replaced with
+	the contents of pAfter. If not, the values in memory are copied to pBefore.
+
+	This uses cmpxchg16b on AMD64 and casp on ARM64, and a 64 bit
+	compare and swap on CPUs with 32 bit pointers. The operation is
+	sequentially consistent.
+
+	\param pInput Pointer to the pair to modify
+	\param pBefore Pointer to the expected values, updated on failure
+	\param pAfter Pointer to the values to store on a match
+	\return \ref TRUE if the values were stored, \ref FALSE if not
+	\sa AtomicPair_t
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicPause(void)
+	\brief Tell the CPU the thread is spinning
+
+	Issue a pause on Intel, yield on ARM or a low thread priority hint on
+	PowerPC to give resources to the other hardware threads of the core
+	and to reduce power while waiting for a lock. It does nothing on
+	other CPUs.
+
+	\sa SpinLock
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::Atomic
+	\brief Type safe wrapper for atomic variables
+
+	Wrap a 32 or 64 bit type so all accesses are atomic, with an optional
+	memory ordering on each call. The default ordering is \ref MEMORYORDER_SEQCST.
+	The type is stored as an unsigned integer of the same size, so floats,
+	enums and pointers can be loaded, stored and swapped. The arithmetic
+	and logical functions should only be used with integer types.
+
+	\code
+	Burger::Atomic<Word32> g_uCount;
+	g_uCount.fetch_add(1,Burger::MEMORYORDER_RELAXED);
+	\endcode
+
+	\tparam T A type that is 4 or 8 bytes in size
+	\sa AtomicLoad(volatile Word32 *,eMemoryOrder) or SpinLock
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::AtomicStorage
+	\brief Select an unsigned integer the same size as a type
+
+	Used by Atomic to store the value.
+
+	\tparam uSize Size in bytes of the type, 4 or 8
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::Atomic::Atomic()
+	\brief Initialize to zero
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::Atomic::Atomic(T Input)
+	\brief Initialize to a value
+
+	\param Input Starting value
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::load(eMemoryOrder eOrder) const
+	\brief Atomically read the value
+
+	\param eOrder Memory ordering for the load
+	\return The current value
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Atomic::store(T Input,eMemoryOrder eOrder)
+	\brief Atomically set the value
+
+	\param Input New value
+	\param eOrder Memory ordering for the store
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::exchange(T Input,eMemoryOrder eOrder)
+	\brief Atomically swap the value
+
+	\param Input New value
+	\param eOrder Memory ordering for the operation
+	\return The previous value
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::Atomic::compare_exchange(T &rExpected,T Desired,eMemoryOrder eOrder)
+	\brief Atomically replace the value if it matches an expected value
+
+	If the value doesn't match, rExpected is updated with the value found.
+
+	\param rExpected Reference to the value expected, updated on failure
+	\param Desired Value to store on a match
+	\param eOrder Memory ordering for the operation
+	\return \ref TRUE if the value was stored, \ref FALSE if not
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::fetch_add(T Input,eMemoryOrder eOrder)
+	\brief Atomically add to the value
+
+	\param Input Value to add
+	\param eOrder Memory ordering for the operation
+	\return The previous value
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::fetch_sub(T Input,eMemoryOrder eOrder)
+	\brief Atomically subtract from the value
+
+	\param Input Value to subtract
+	\param eOrder Memory ordering for the operation
+	\return The previous value
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::fetch_or(T Input,eMemoryOrder eOrder)
+	\brief Atomically set bits in the value
+
+	\param Input Bits to set
+	\param eOrder Memory ordering for the operation
+	\return The previous value
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::fetch_and(T Input,eMemoryOrder eOrder)
+	\brief Atomically mask bits in the value
+
+	\param Input Mask to apply with a logical AND
+	\param eOrder Memory ordering for the operation
+	\return The previous value
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::Atomic::operator T() const
+	\brief Sequentially consistent read of the value
+	\return The current value
+
+***************************************/
+
+/*! ************************************
+
+	\fn T Burger::Atomic::operator=(T Input)
+	\brief Sequentially consistent store of the value
+
+	\param Input New value
+	\return Input
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::SpinLock
+	\brief A lightweight lock that waits by polling
+
+	For data that's only held for a few instructions, such as pushing
+	a pointer onto a list, a SpinLock is faster than a CriticalSection since
+	it never enters the operating system unless the lock is held for
+	a long time. Unlocked reads are used while waiting so the
+	cache line isn't passed between CPUs until the lock is released.
+
+	Don't use this class to protect slow operations such as file access,
+	use a CriticalSection instead.
+
+	\sa SpinLockLock or CriticalSection
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SpinLock::SpinLock()
+	\brief Initialize the lock as unlocked
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SpinLock::TryLock(void)
+	\brief Try to acquire the lock without waiting
+
+	\return \ref TRUE if the lock was acquired, \ref FALSE if another thread holds it
+	\sa Lock(void) or Unlock(void)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Acquire the lock
+
+	Poll until the lock is acquired. The time between polls starts with a
+	single AtomicPause() and doubles until it reaches \ref MAXBACKOFF,
+	then the thread yields its time slice so a lock owner that was
+	preempted can run.
+
+	\sa TryLock(void) or Unlock(void)
+
+***************************************/
+
+void BURGER_API Burger::SpinLock::Lock(void)
+{
+	Word uBackoff = 1;
+	while (!TryLock()) {
+		// Wait for the lock to appear free before trying again
+		do {
+			if (uBackoff<=MAXBACKOFF) {
+				Word uCount = uBackoff;
+				do {
+					AtomicPause();
+				} while (--uCount);
+				uBackoff<<=1U;
+			} else {
+				Sleep(SLEEP_YIELD);
+			}
+		} while (IsLocked());
+	}
+}
+
+/*! ************************************
+
+	\fn void Burger::SpinLock::Unlock(void)
+	\brief Release the lock
+
+	\sa Lock(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SpinLock::IsLocked(void) const
+	\brief Test if the lock is held
+
+	\return \ref TRUE if a thread holds the lock
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::SpinLockLock
+	\brief Class to acquire a SpinLock for the duration of a scope
+
+	\sa SpinLock
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SpinLockLock::SpinLockLock(SpinLock *pSpinLock)
+	\brief Acquire the SpinLock
+
+	\param pSpinLock Pointer to the SpinLock to hold
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SpinLockLock::~SpinLockLock()
+	\brief Release the SpinLock
+
+***************************************/
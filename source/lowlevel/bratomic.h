@@ -32,6 +32,14 @@
 
 /* BEGIN */
 namespace Burger {
+enum eMemoryOrder {
+	MEMORYORDER_RELAXED=0,		///< No ordering, only atomicity
+	MEMORYORDER_ACQUIRE=2,		///< Later loads and stores can't move before this operation
+	MEMORYORDER_RELEASE=3,		///< Earlier loads and stores can't move after this operation
+	MEMORYORDER_ACQREL=4,		///< Both \ref MEMORYORDER_ACQUIRE and \ref MEMORYORDER_RELEASE
+	MEMORYORDER_SEQCST=5		///< Acquire, release and a single total order with all other sequentially consistent operations
+};
+
 #if defined(BURGER_PS3)
 	BURGER_INLINE Word32 AtomicSwap(volatile Word32 *pOutput,Word32 uInput) { Word32 uTemp; do { uTemp = __builtin_lwarx(pOutput,0); } while(__builtin_stwcx(uInput,pOutput,0)==0); return uTemp; }
 	BURGER_INLINE Word32 AtomicPreIncrement(volatile Word32 *pInput) { Word32 uTemp; do { uTemp = __builtin_lwarx(pInput,0)+1; } while(__builtin_stwcx(uTemp,pInput,0)==0); return uTemp; }
@@ -41,15 +49,19 @@ namespace Burger {
 	BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { Word32 uTemp; do { uTemp = __builtin_lwarx(pInput,0); } while(__builtin_stwcx(uTemp+uValue,pInput,0)==0); return uTemp; }
 	BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { Word32 uTemp; do { uTemp = __builtin_lwarx(pInput,0); } while(__builtin_stwcx(uTemp-uValue,pInput,0)==0); return uTemp; }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { Word uResult; do { Word32 uTemp = __builtin_lwarx(pInput,0); uResult = (uTemp == uBefore); if (!uResult) break; } while(__builtin_stwcx(uAfter,pInput,0)==0); return uResult; }
-	BURGER_INLINE Word32 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pOutput,0); } while(__builtin_stdcx(uInput,pOutput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicPreIncrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0)+1; } while(__builtin_stdcx(uTemp,pInput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicPostIncrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp+1,pInput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicPreDecrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0)-1; } while(__builtin_stdcx(uTemp,pInput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicPostDecrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp-1,pInput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp+uValue,pInput,0)==0); return uTemp; }
-	BURGER_INLINE Word32 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp-uValue,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; __asm__ __volatile__("lwsync":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { __asm__ __volatile__("lwsync":::"memory"); pOutput[0] = uInput; }
+	BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pOutput,0); } while(__builtin_stdcx(uInput,pOutput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0)+1; } while(__builtin_stdcx(uTemp,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicPostIncrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp+1,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicPreDecrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0)-1; } while(__builtin_stdcx(uTemp,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicPostDecrement(volatile Word64 *pInput) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp-1,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp+uValue,pInput,0)==0); return uTemp; }
+	BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp; do { uTemp = __builtin_ldarx(pInput,0); } while(__builtin_stdcx(uTemp-uValue,pInput,0)==0); return uTemp; }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { Word uResult; do { Word64 uTemp = __builtin_ldarx(pInput,0); uResult = (uTemp == uBefore); if (!uResult) break; } while(__builtin_stdcx(uAfter,pInput,0)==0); return uResult; }
-#elif defined(BURGER_ANDROID) || defined(BURGER_PS4) || defined(BURGER_PSP2) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { Word64 uTemp = pInput[0]; __asm__ __volatile__("lwsync":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { __asm__ __volatile__("lwsync":::"memory"); pOutput[0] = uInput; }
+#elif defined(BURGER_ANDROID) || defined(BURGER_PS4) || defined(BURGER_PSP2) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
 	BURGER_INLINE Word32 AtomicSwap(volatile Word32 *pOutput,Word32 uInput) { Word32 uTemp; do { uTemp = pOutput[0]; } while(__sync_val_compare_and_swap(pOutput,uTemp,uInput)!=uTemp); return uTemp;}
 	BURGER_INLINE Word32 AtomicPreIncrement(volatile Word32 *pInput) { return __sync_add_and_fetch(pInput,1); }
 	BURGER_INLINE Word32 AtomicPostIncrement(volatile Word32 *pInput) { return __sync_fetch_and_add(pInput,1); }
@@ -61,7 +73,17 @@ namespace Burger {
 	BURGER_INLINE Word32 AtomicPostDecrement(volatile Word32 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 	BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 	BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-	BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+	BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
+#if defined(BURGER_X86) || defined(BURGER_AMD64)		// Intel doesn't reorder loads with loads or stores with stores
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; __asm__ __volatile__("":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { __asm__ __volatile__("":::"memory"); pOutput[0] = uInput; }
+#elif defined(BURGER_POWERPC)
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; __asm__ __volatile__("lwsync":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { __asm__ __volatile__("lwsync":::"memory"); pOutput[0] = uInput; }
+#else
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; __sync_synchronize(); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { __sync_synchronize(); pOutput[0] = uInput; }
+#endif
 	BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp; do { uTemp = pOutput[0]; } while(__sync_val_compare_and_swap(pOutput,uTemp,uInput)!=uTemp); return uTemp;}
 	BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { return __sync_add_and_fetch(pInput,1); }
 	BURGER_INLINE Word64 AtomicPostIncrement(volatile Word64 *pInput) { return __sync_fetch_and_add(pInput,1); }
@@ -69,7 +91,17 @@ namespace Burger {
 	BURGER_INLINE Word64 AtomicPostDecrement(volatile Word64 *pInput) { return __sync_fetch_and_sub(pInput,1); }
 	BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_add(pInput,uValue); }
 	BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { return __sync_fetch_and_sub(pInput,uValue); }
-	BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uAfter,uBefore); }
+	BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return __sync_bool_compare_and_swap(pInput,uBefore,uAfter); }
+#if defined(BURGER_AMD64)
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { Word64 uTemp = pInput[0]; __asm__ __volatile__("":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { __asm__ __volatile__("":::"memory"); pOutput[0] = uInput; }
+#elif defined(BURGER_POWERPC) && defined(BURGER_64BITCPU)
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { Word64 uTemp = pInput[0]; __asm__ __volatile__("lwsync":::"memory"); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { __asm__ __volatile__("lwsync":::"memory"); pOutput[0] = uInput; }
+#else	// 64 bit loads and stores may tear on 32 bit CPUs
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { return __sync_fetch_and_add(pInput,0); }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { AtomicSwap(pOutput,uInput); }
+#endif
 #elif defined(BURGER_XBOX360) || defined(BURGER_WINDOWS) || defined(BURGER_MSDOS)
 	BURGER_INLINE Word32 AtomicSwap(volatile Word32 *pOutput,Word32 uInput) { return static_cast<Word32>(_InterlockedExchange(reinterpret_cast<volatile long *>(pOutput),static_cast<long>(uInput)));}
 	BURGER_INLINE Word32 AtomicPreIncrement(volatile Word32 *pInput) { return static_cast<Word32>(_InterlockedIncrement(reinterpret_cast<volatile long *>(pInput))); }
@@ -79,15 +111,32 @@ namespace Burger {
 	BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { return static_cast<Word32>(_InterlockedExchangeAdd(reinterpret_cast<volatile long *>(pInput),static_cast<long>(uValue))); }
 	BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { return static_cast<Word32>(_InterlockedExchangeAdd(reinterpret_cast<volatile long *>(pInput),-static_cast<long>(uValue))); }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { return _InterlockedCompareExchange(reinterpret_cast<volatile long *>(pInput),static_cast<long>(uAfter),static_cast<long>(uBefore))==static_cast<long>(uBefore); }
+#if defined(BURGER_XBOX360)
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; __lwsync(); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { __lwsync(); pOutput[0] = uInput; }
+#elif defined(BURGER_MSVC)
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { Word32 uTemp = pInput[0]; _ReadWriteBarrier(); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { _ReadWriteBarrier(); pOutput[0] = uInput; }
+#else
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { return pInput[0]; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { pOutput[0] = uInput; }
+#endif
 #if defined(BURGER_64BITCPU)
 	BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { return _InterlockedExchange64(reinterpret_cast<volatile __int64 *>(pOutput),uInput); }
 	BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { return _InterlockedIncrement64(reinterpret_cast<volatile __int64 *>(pInput)); }
 	BURGER_INLINE Word64 AtomicPostIncrement(volatile Word64 *pInput) { return _InterlockedIncrement64(reinterpret_cast<volatile __int64 *>(pInput))-1; }
 	BURGER_INLINE Word64 AtomicPreDecrement(volatile Word64 *pInput) { return _InterlockedDecrement64(reinterpret_cast<volatile __int64 *>(pInput)); }
 	BURGER_INLINE Word64 AtomicPostDecrement(volatile Word64 *pInput) { return _InterlockedDecrement64(reinterpret_cast<volatile __int64 *>(pInput))+1; }
-	BURGER_INLINE Word64 AtomicAdd(volatile Word32 *pInput,Word64 uValue) { return _InterlockedExchangeAdd64(reinterpret_cast<volatile __int64 *>(pInput),uValue); }
+	BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { return _InterlockedExchangeAdd64(reinterpret_cast<volatile __int64 *>(pInput),uValue); }
 	BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { return _InterlockedExchangeAdd64(reinterpret_cast<volatile __int64 *>(pInput),0-uValue); }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { return _InterlockedCompareExchange64(reinterpret_cast<volatile __int64 *>(pInput),uAfter,uBefore)==static_cast<__int64>(uBefore); }
+#if defined(BURGER_XBOX360)
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { Word64 uTemp = pInput[0]; __lwsync(); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { __lwsync(); pOutput[0] = uInput; }
+#else
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { Word64 uTemp = pInput[0]; _ReadWriteBarrier(); return uTemp; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { _ReadWriteBarrier(); pOutput[0] = uInput; }
+#endif
 #endif
 #else
 	BURGER_INLINE Word32 AtomicSwap(volatile Word32 *pOutput,Word32 uInput) { Word32 uTemp = pOutput[0]; pOutput[0] = uInput; return uTemp; }
@@ -98,6 +147,8 @@ namespace Burger {
 	BURGER_INLINE Word32 AtomicAdd(volatile Word32 *pInput,Word32 uValue) { Word32 uTemp = pInput[0]; pInput[0] = uTemp+uValue; return uTemp; }
 	BURGER_INLINE Word32 AtomicSubtract(volatile Word32 *pInput,Word32 uValue) { Word32 uTemp = pInput[0]; pInput[0] = uTemp-uValue; return uTemp; }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word32 *pInput,Word32 uBefore,Word32 uAfter) { Word uTemp = pInput[0]==uBefore; if (uTemp) { pInput[0] = uAfter; } return uTemp; }
+	BURGER_INLINE Word32 AtomicGet(volatile Word32 *pInput) { return pInput[0]; }
+	BURGER_INLINE void AtomicSet(volatile Word32 *pOutput,Word32 uInput) { pOutput[0] = uInput; }
 #if defined(BURGER_64BITCPU) || defined(DOXYGEN)
 	BURGER_INLINE Word64 AtomicSwap(volatile Word64 *pOutput,Word64 uInput) { Word64 uTemp = pOutput[0]; pOutput[0] = uInput; return uTemp; }
 	BURGER_INLINE Word64 AtomicPreIncrement(volatile Word64 *pInput) { Word64 uTemp = pInput[0]+1; pInput[0] = uTemp; return uTemp; }
@@ -107,8 +158,183 @@ namespace Burger {
 	BURGER_INLINE Word64 AtomicAdd(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp = pInput[0]; pInput[0] = uTemp+uValue; return uTemp; }
 	BURGER_INLINE Word64 AtomicSubtract(volatile Word64 *pInput,Word64 uValue) { Word64 uTemp = pInput[0]; pInput[0] = uTemp-uValue; return uTemp; }
 	BURGER_INLINE Word AtomicSetIfMatch(volatile Word64 *pInput,Word64 uBefore,Word64 uAfter) { Word uTemp = pInput[0]==uBefore; if (uTemp) { pInput[0] = uAfter; } return uTemp; }
+	BURGER_INLINE Word64 AtomicGet(volatile Word64 *pInput) { return pInput[0]; }
+	BURGER_INLINE void AtomicSet(volatile Word64 *pOutput,Word64 uInput) { pOutput[0] = uInput; }
 #endif
 #endif
+
+#if defined(BURGER_64BITCPU) || defined(BURGER_PS3) || defined(BURGER_ANDROID) || defined(BURGER_PS4) || defined(BURGER_PSP2) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX) || defined(DOXYGEN)
+#define BURGER_ATOMIC64
+#endif
+
+struct AtomicPair_t {
+#if (defined(BURGER_64BITCPU) && !defined(BURGER_XBOX360) && !defined(BURGER_PS3)) || defined(DOXYGEN)
+	WordPtr BURGER_ALIGN(m_uLow,16);	///< First pointer sized value (Usually a pointer)
+#else
+	WordPtr BURGER_ALIGN(m_uLow,8);		///< First pointer sized value (Usually a pointer)
+#endif
+	WordPtr m_uHigh;					///< Second pointer sized value (Usually a counter to prevent ABA)
+};
+
+#if defined(__ATOMIC_ACQUIRE) && !defined(DOXYGEN)
+// The compiler has intrinsics that take memory orders, eMemoryOrder matches their values
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { __atomic_thread_fence(eOrder); }
+	BURGER_INLINE Word32 AtomicLoad(volatile Word32 *pInput,eMemoryOrder eOrder) { return __atomic_load_n(pInput,eOrder); }
+	BURGER_INLINE void AtomicStore(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder) { __atomic_store_n(pOutput,uInput,eOrder); }
+	BURGER_INLINE Word32 AtomicExchange(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder) { return __atomic_exchange_n(pOutput,uInput,eOrder); }
+	BURGER_INLINE Word32 AtomicFetchAdd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { return __atomic_fetch_add(pInput,uValue,eOrder); }
+	BURGER_INLINE Word32 AtomicFetchOr(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { return __atomic_fetch_or(pInput,uValue,eOrder); }
+	BURGER_INLINE Word32 AtomicFetchAnd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { return __atomic_fetch_and(pInput,uValue,eOrder); }
+	BURGER_INLINE Word AtomicCompareExchange(volatile Word32 *pInput,Word32 *pExpected,Word32 uDesired,eMemoryOrder eOrder) { return __atomic_compare_exchange_n(pInput,pExpected,uDesired,false,eOrder,(eOrder==MEMORYORDER_ACQREL) ? MEMORYORDER_ACQUIRE : ((eOrder==MEMORYORDER_RELEASE) ? MEMORYORDER_RELAXED : eOrder)); }
+	BURGER_INLINE Word64 AtomicLoad(volatile Word64 *pInput,eMemoryOrder eOrder) { return __atomic_load_n(pInput,eOrder); }
+	BURGER_INLINE void AtomicStore(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder) { __atomic_store_n(pOutput,uInput,eOrder); }
+	BURGER_INLINE Word64 AtomicExchange(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder) { return __atomic_exchange_n(pOutput,uInput,eOrder); }
+	BURGER_INLINE Word64 AtomicFetchAdd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { return __atomic_fetch_add(pInput,uValue,eOrder); }
+	BURGER_INLINE Word64 AtomicFetchOr(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { return __atomic_fetch_or(pInput,uValue,eOrder); }
+	BURGER_INLINE Word64 AtomicFetchAnd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { return __atomic_fetch_and(pInput,uValue,eOrder); }
+	BURGER_INLINE Word AtomicCompareExchange(volatile Word64 *pInput,Word64 *pExpected,Word64 uDesired,eMemoryOrder eOrder) { return __atomic_compare_exchange_n(pInput,pExpected,uDesired,false,eOrder,(eOrder==MEMORYORDER_ACQREL) ? MEMORYORDER_ACQUIRE : ((eOrder==MEMORYORDER_RELEASE) ? MEMORYORDER_RELAXED : eOrder)); }
+#else
+// Build the memory ordered functions from the functions above and explicit fences
+#if defined(BURGER_XBOX360)
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { if (eOrder==MEMORYORDER_SEQCST) { __sync(); } else if (eOrder!=MEMORYORDER_RELAXED) { __lwsync(); } }
+#elif defined(BURGER_POWERPC) && (defined(BURGER_PS3) || defined(BURGER_MACOSX))
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { if (eOrder==MEMORYORDER_SEQCST) { __asm__ __volatile__("sync":::"memory"); } else if (eOrder!=MEMORYORDER_RELAXED) { __asm__ __volatile__("lwsync":::"memory"); } }
+#elif (defined(BURGER_X86) || defined(BURGER_AMD64)) && defined(BURGER_MSVC)
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { if (eOrder==MEMORYORDER_SEQCST) { volatile Word32 uTemp = 0; AtomicSwap(&uTemp,0); } else { _ReadWriteBarrier(); } }
+#elif (defined(BURGER_X86) || defined(BURGER_AMD64)) && (defined(BURGER_ANDROID) || defined(BURGER_PS4) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX))
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { if (eOrder==MEMORYORDER_SEQCST) { __sync_synchronize(); } else { __asm__ __volatile__("":::"memory"); } }
+#elif defined(BURGER_ANDROID) || defined(BURGER_PSP2) || defined(BURGER_IOS) || defined(BURGER_LINUX)
+	BURGER_INLINE void AtomicFence(eMemoryOrder eOrder) { if (eOrder!=MEMORYORDER_RELAXED) { __sync_synchronize(); } }
+#else
+	BURGER_INLINE void AtomicFence(eMemoryOrder /* eOrder */) { }
+#endif
+
+// Only the PowerPC consoles have read-modify-write intrinsics without barriers
+#if defined(BURGER_PS3) || defined(BURGER_XBOX360)
+	BURGER_INLINE void AtomicFenceBefore(eMemoryOrder eOrder) { if (eOrder>=MEMORYORDER_RELEASE) { AtomicFence((eOrder==MEMORYORDER_SEQCST) ? MEMORYORDER_SEQCST : MEMORYORDER_RELEASE); } }
+	BURGER_INLINE void AtomicFenceAfter(eMemoryOrder eOrder) { if ((eOrder==MEMORYORDER_ACQUIRE) || (eOrder>=MEMORYORDER_ACQREL)) { AtomicFence(MEMORYORDER_ACQUIRE); } }
+#else
+	BURGER_INLINE void AtomicFenceBefore(eMemoryOrder /* eOrder */) { }
+	BURGER_INLINE void AtomicFenceAfter(eMemoryOrder /* eOrder */) { }
+#endif
+
+	BURGER_INLINE Word32 AtomicLoad(volatile Word32 *pInput,eMemoryOrder eOrder) {
+#if !(defined(BURGER_X86) || defined(BURGER_AMD64))
+		if (eOrder==MEMORYORDER_SEQCST) { AtomicFence(MEMORYORDER_SEQCST); }
+#endif
+		Word32 uTemp = pInput[0]; if (eOrder!=MEMORYORDER_RELAXED) { AtomicFence(MEMORYORDER_ACQUIRE); } return uTemp; }
+	BURGER_INLINE void AtomicStore(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder) {
+		if (eOrder==MEMORYORDER_SEQCST) { AtomicFenceBefore(eOrder); AtomicSwap(pOutput,uInput); AtomicFenceAfter(eOrder); }
+		else { if (eOrder!=MEMORYORDER_RELAXED) { AtomicFence(MEMORYORDER_RELEASE); } pOutput[0] = uInput; } }
+	BURGER_INLINE Word32 AtomicExchange(volatile Word32 *pOutput,Word32 uInput,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word32 uTemp = AtomicSwap(pOutput,uInput); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word32 AtomicFetchAdd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word32 uTemp = AtomicAdd(pInput,uValue); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word32 AtomicFetchOr(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word32 uTemp; do { uTemp = pInput[0]; } while (!AtomicSetIfMatch(pInput,uTemp,uTemp|uValue)); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word32 AtomicFetchAnd(volatile Word32 *pInput,Word32 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word32 uTemp; do { uTemp = pInput[0]; } while (!AtomicSetIfMatch(pInput,uTemp,uTemp&uValue)); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word AtomicCompareExchange(volatile Word32 *pInput,Word32 *pExpected,Word32 uDesired,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word uResult = AtomicSetIfMatch(pInput,pExpected[0],uDesired); if (!uResult) { pExpected[0] = pInput[0]; } AtomicFenceAfter(eOrder); return uResult; }
+#if defined(BURGER_ATOMIC64)
+	BURGER_INLINE Word64 AtomicLoad(volatile Word64 *pInput,eMemoryOrder eOrder) {
+#if !(defined(BURGER_X86) || defined(BURGER_AMD64))
+		if (eOrder==MEMORYORDER_SEQCST) { AtomicFence(MEMORYORDER_SEQCST); }
+#endif
+#if defined(BURGER_64BITCPU)
+		Word64 uTemp = pInput[0];
+#else	// 64 bit loads may tear on 32 bit CPUs
+		Word64 uTemp = AtomicAdd(pInput,0);
+#endif
+		if (eOrder!=MEMORYORDER_RELAXED) { AtomicFence(MEMORYORDER_ACQUIRE); } return uTemp; }
+	BURGER_INLINE void AtomicStore(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder) {
+#if defined(BURGER_64BITCPU)
+		if (eOrder==MEMORYORDER_SEQCST) { AtomicFenceBefore(eOrder); AtomicSwap(pOutput,uInput); AtomicFenceAfter(eOrder); }
+		else { if (eOrder!=MEMORYORDER_RELAXED) { AtomicFence(MEMORYORDER_RELEASE); } pOutput[0] = uInput; } }
+#else
+		AtomicFenceBefore(eOrder); AtomicSwap(pOutput,uInput); AtomicFenceAfter(eOrder); }
+#endif
+	BURGER_INLINE Word64 AtomicExchange(volatile Word64 *pOutput,Word64 uInput,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word64 uTemp = AtomicSwap(pOutput,uInput); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word64 AtomicFetchAdd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word64 uTemp = AtomicAdd(pInput,uValue); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word64 AtomicFetchOr(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word64 uTemp; do { uTemp = AtomicLoad(pInput,MEMORYORDER_RELAXED); } while (!AtomicSetIfMatch(pInput,uTemp,uTemp|uValue)); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word64 AtomicFetchAnd(volatile Word64 *pInput,Word64 uValue,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word64 uTemp; do { uTemp = AtomicLoad(pInput,MEMORYORDER_RELAXED); } while (!AtomicSetIfMatch(pInput,uTemp,uTemp&uValue)); AtomicFenceAfter(eOrder); return uTemp; }
+	BURGER_INLINE Word AtomicCompareExchange(volatile Word64 *pInput,Word64 *pExpected,Word64 uDesired,eMemoryOrder eOrder) { AtomicFenceBefore(eOrder); Word uResult = AtomicSetIfMatch(pInput,pExpected[0],uDesired); if (!uResult) { pExpected[0] = AtomicLoad(pInput,MEMORYORDER_RELAXED); } AtomicFenceAfter(eOrder); return uResult; }
+#endif
+#endif
+
+// Double pointer width compare and swap
+#if defined(BURGER_AMD64) && defined(BURGER_MSVC)
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { return _InterlockedCompareExchange128(reinterpret_cast<volatile __int64 *>(pInput),static_cast<__int64>(pAfter->m_uHigh),static_cast<__int64>(pAfter->m_uLow),reinterpret_cast<__int64 *>(pBefore))!=0; }
+#elif defined(BURGER_AMD64) && !defined(DOXYGEN)
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { Word8 uResult; __asm__ __volatile__("lock; cmpxchg16b %1\n\tsete %0":"=q"(uResult),"+m"(*pInput),"+a"(pBefore->m_uLow),"+d"(pBefore->m_uHigh):"b"(pAfter->m_uLow),"c"(pAfter->m_uHigh):"memory","cc"); return uResult; }
+#elif defined(BURGER_ARM64) && defined(__ATOMIC_ACQUIRE) && !defined(DOXYGEN)
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { union { AtomicPair_t m_Pair; unsigned __int128 m_uWide; } Before,After; Before.m_Pair = pBefore[0]; After.m_Pair = pAfter[0]; Word uResult = __atomic_compare_exchange_n(reinterpret_cast<volatile unsigned __int128 *>(pInput),&Before.m_uWide,After.m_uWide,false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST); pBefore[0] = Before.m_Pair; return uResult; }
+#elif (defined(BURGER_X86) || defined(BURGER_XBOX360)) && defined(BURGER_MSVC)
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { union { AtomicPair_t m_Pair; __int64 m_iWide; } Before,After; Before.m_Pair = pBefore[0]; After.m_Pair = pAfter[0]; __int64 iOld = _InterlockedCompareExchange64(reinterpret_cast<volatile __int64 *>(pInput),After.m_iWide,Before.m_iWide); Word uResult = (iOld==Before.m_iWide); Before.m_iWide = iOld; pBefore[0] = Before.m_Pair; return uResult; }
+#elif (defined(BURGER_ATOMIC64) && !defined(BURGER_64BITCPU)) || defined(BURGER_PS3)
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { union { AtomicPair_t m_Pair; Word64 m_uWide; } Before,After; Before.m_Pair = pBefore[0]; After.m_Pair = pAfter[0]; Word uResult = AtomicCompareExchange(reinterpret_cast<volatile Word64 *>(pInput),&Before.m_uWide,After.m_uWide,MEMORYORDER_SEQCST); pBefore[0] = Before.m_Pair; return uResult; }
+#else
+	BURGER_INLINE Word AtomicSetIfMatch(volatile AtomicPair_t *pInput,AtomicPair_t *pBefore,const AtomicPair_t *pAfter) { Word uResult = (pInput->m_uLow==pBefore->m_uLow) && (pInput->m_uHigh==pBefore->m_uHigh); if (uResult) { pInput->m_uLow = pAfter->m_uLow; pInput->m_uHigh = pAfter->m_uHigh; } else { pBefore->m_uLow = pInput->m_uLow; pBefore->m_uHigh = pInput->m_uHigh; } return uResult; }
+#endif
+
+// Hint to the CPU that this is a spin loop
+#if (defined(BURGER_X86) || defined(BURGER_AMD64)) && defined(BURGER_MSVC)
+	BURGER_INLINE void AtomicPause(void) { _mm_pause(); }
+#elif (defined(BURGER_X86) || defined(BURGER_AMD64)) && (defined(BURGER_GNUC) || defined(BURGER_LLVM))
+	BURGER_INLINE void AtomicPause(void) { __asm__ __volatile__("pause":::"memory"); }
+#elif (defined(BURGER_ARM) || defined(BURGER_ARM64)) && (defined(BURGER_GNUC) || defined(BURGER_LLVM))
+	BURGER_INLINE void AtomicPause(void) { __asm__ __volatile__("yield":::"memory"); }
+#elif defined(BURGER_POWERPC) && (defined(BURGER_PS3) || defined(BURGER_MACOSX))
+	BURGER_INLINE void AtomicPause(void) { __asm__ __volatile__("or 27,27,27":::"memory"); }
+#else
+	BURGER_INLINE void AtomicPause(void) { }
+#endif
+
+template<WordPtr uSize> struct AtomicStorage {};
+template<> struct AtomicStorage<4> { typedef Word32 Type; };
+#if defined(BURGER_ATOMIC64)
+template<> struct AtomicStorage<8> { typedef Word64 Type; };
+#endif
+
+template<class T>
+class Atomic {
+	BURGER_DISABLECOPYCONSTRUCTORS(Atomic);
+	typedef typename AtomicStorage<sizeof(T)>::Type Storage;
+	volatile Storage m_uValue;		///< Value as an unsigned integer of the same size as T
+	static BURGER_INLINE Storage ToStorage(T Input) { union { T m_Input; Storage m_uOutput; } Temp; Temp.m_Input = Input; return Temp.m_uOutput; }
+	static BURGER_INLINE T FromStorage(Storage uInput) { union { Storage m_uInput; T m_Output; } Temp; Temp.m_uInput = uInput; return Temp.m_Output; }
+	BURGER_INLINE volatile Storage *GetStorage(void) const { return const_cast<volatile Storage *>(&m_uValue); }
+public:
+	Atomic() : m_uValue(0) {}
+	Atomic(T Input) : m_uValue(ToStorage(Input)) {}
+	BURGER_INLINE T load(eMemoryOrder eOrder=MEMORYORDER_SEQCST) const { return FromStorage(AtomicLoad(GetStorage(),eOrder)); }
+	BURGER_INLINE void store(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { AtomicStore(GetStorage(),ToStorage(Input),eOrder); }
+	BURGER_INLINE T exchange(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { return FromStorage(AtomicExchange(GetStorage(),ToStorage(Input),eOrder)); }
+	BURGER_INLINE Word compare_exchange(T &rExpected,T Desired,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { Storage uExpected = ToStorage(rExpected); Word uResult = AtomicCompareExchange(GetStorage(),&uExpected,ToStorage(Desired),eOrder); rExpected = FromStorage(uExpected); return uResult; }
+	BURGER_INLINE T fetch_add(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { return FromStorage(AtomicFetchAdd(GetStorage(),ToStorage(Input),eOrder)); }
+	BURGER_INLINE T fetch_sub(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { return FromStorage(AtomicFetchAdd(GetStorage(),0-ToStorage(Input),eOrder)); }
+	BURGER_INLINE T fetch_or(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { return FromStorage(AtomicFetchOr(GetStorage(),ToStorage(Input),eOrder)); }
+	BURGER_INLINE T fetch_and(T Input,eMemoryOrder eOrder=MEMORYORDER_SEQCST) { return FromStorage(AtomicFetchAnd(GetStorage(),ToStorage(Input),eOrder)); }
+	BURGER_INLINE operator T() const { return load(); }
+	BURGER_INLINE T operator=(T Input) { store(Input); return Input; }
+};
+
+class SpinLock {
+	BURGER_DISABLECOPYCONSTRUCTORS(SpinLock);
+	volatile Word32 m_uLocked;		///< Non-zero if the lock is held
+public:
+	enum {
+		MAXBACKOFF=64				///< Largest number of AtomicPause() calls between polls before yielding the CPU
+	};
+	SpinLock() : m_uLocked(0) {}
+	BURGER_INLINE Word TryLock(void) { Word32 uExpected = 0; return !AtomicLoad(&m_uLocked,MEMORYORDER_RELAXED) && AtomicCompareExchange(&m_uLocked,&uExpected,1,MEMORYORDER_ACQUIRE); }
+	void BURGER_API Lock(void);
+	BURGER_INLINE void Unlock(void) { AtomicStore(&m_uLocked,0,MEMORYORDER_RELEASE); }
+	BURGER_INLINE Word IsLocked(void) const { return AtomicLoad(const_cast<volatile Word32 *>(&m_uLocked),MEMORYORDER_RELAXED)!=0; }
+};
+
+class SpinLockLock {
+	BURGER_DISABLECOPYCONSTRUCTORS(SpinLockLock);
+	SpinLock *m_pSpinLock;			///< Pointer to the lock that is held
+public:
+	SpinLockLock(SpinLock *pSpinLock) : m_pSpinLock(pSpinLock) { pSpinLock->Lock(); }
+	~SpinLockLock() { m_pSpinLock->Unlock(); }
+};
 }
 /* END */
 
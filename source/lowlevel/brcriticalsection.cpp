@@ -12,6 +12,7 @@
 ***************************************/
 
 #include "brcriticalsection.h"
+#include "bratomic.h"
 
 /*! ************************************
 
@@ -39,7 +40,7 @@
 
 #if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_PS3) || \
 	defined(BURGER_PS4) || defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || \
-	defined(BURGER_IOS)) || defined(DOXYGEN)
+	defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::CriticalSection::CriticalSection()
 {
 }
@@ -256,7 +257,7 @@ Burger::CriticalSectionStatic::~CriticalSectionStatic()
 ***************************************/
 
 #if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID) || \
-	defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+	defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 
 /*! ************************************
 
@@ -384,7 +385,7 @@ Word BURGER_API Burger::Semaphore::Release(void)
 
 ***************************************/
 
-#if !(defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::ConditionVariable::ConditionVariable() :
 	m_CriticalSection(),
 	m_WaitSemaphore(0),
@@ -560,7 +561,7 @@ Word BURGER_API Burger::ConditionVariable::Wait(CriticalSection *pCriticalSectio
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 Burger::Thread::Thread() :
 	m_pFunction(NULL),
 	m_pData(NULL),
@@ -729,4 +730,163 @@ void BURGER_API Burger::Thread::Run(void *pThis)
 
 ***************************************/
 
-#endif
\ No newline at end of file
+/*! ************************************
+
+	\brief Return the number of CPU cores available
+
+	Query the operating system for the number of hardware threads
+	that can run concurrently. This is used as a hint for how many
+	threads to spawn for splitting up work.
+
+	On platforms that don't support threads, this will return 1.
+
+	\return Number of hardware threads, always 1 or higher
+	\sa ParallelFor(ParallelProc,void *,Word,Word)
+
+***************************************/
+
+Word BURGER_API Burger::Thread::GetProcessorCount(void)
+{
+	return 1;
+}
+
+#endif
+
+/*! ************************************
+
+	\typedef Burger::ParallelProc
+	\brief Function prototype for a unit of work for ParallelFor()
+
+	The function is given the user supplied data pointer and the
+	index of the unit of work to perform. Units of work
+	are executed in no particular order and on any thread, so
+	the function must only modify data that is unique to the
+	index it was given.
+
+	\sa ParallelFor(ParallelProc,void *,Word,Word)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Perform a number of units of work across multiple threads
+
+	Calls the function pProc with the indexes of 0 through uCount-1
+	and returns only when all of the calls have completed. Worker
+	threads are spawned to share the load, with the calling thread
+	performing work as well. Indexes are handed out one at a time
+	so threads that finish early will take on more work.
+
+	On platforms that don't support threads, all of the work is
+	performed on the calling thread.
+
+	\code
+	static void BURGER_API DoARow(void *pData,Word uRow)
+	{
+		ProcessRow(static_cast<Image *>(pData),uRow);
+	}
+
+	// Process all the rows of an image using all the cores
+	Burger::ParallelFor(DoARow,pImage,pImage->GetHeight());
+	\endcode
+
+	\param pProc Pointer to the function to call for each unit of work
+	\param pData Pointer passed to each call to pProc
+	\param uCount Number of units of work to perform
+	\param uMaxThreads Maximum number of threads to use, zero means Thread::GetProcessorCount()
+	\sa Thread::GetProcessorCount(void) or ParallelRun(Thread::FunctionPtr,void *,Word)
+
+***************************************/
+
+struct ParallelState_t {
+	Burger::ParallelProc m_pProc;	// Function to call
+	void *m_pData;					// Data to pass to the function
+	Word32 m_uCount;				// Number of units of work to perform
+	volatile Word32 m_uNext;		// Next unit of work to perform
+};
+
+static WordPtr BURGER_API ParallelWorker(void *pThis)
+{
+	ParallelState_t *pState = static_cast<ParallelState_t *>(pThis);
+	Word32 uCount = pState->m_uCount;
+	Word32 uIndex;
+	// Grab a unit of work until there are none left
+	while ((uIndex = Burger::AtomicPostIncrement(&pState->m_uNext))<uCount) {
+		pState->m_pProc(pState->m_pData,uIndex);
+	}
+	return 0;
+}
+
+void BURGER_API Burger::ParallelFor(ParallelProc pProc,void *pData,Word uCount,Word uMaxThreads)
+{
+	if (uCount) {
+		if (!uMaxThreads) {
+			uMaxThreads = Thread::GetProcessorCount();
+		}
+		// No point in having more threads than work
+		if (uMaxThreads>uCount) {
+			uMaxThreads = uCount;
+		}
+		ParallelState_t State;
+		State.m_pProc = pProc;
+		State.m_pData = pData;
+		State.m_uCount = uCount;
+		State.m_uNext = 0;
+		ParallelRun(ParallelWorker,&State,uMaxThreads);
+	}
+}
+
+/*! ************************************
+
+	\brief Run a function on several threads at once
+
+	Calls pProc on the calling thread and on up to uMaxThreads-1
+	worker threads and returns only when all of the calls have
+	completed. Every call is passed the same data pointer, so the
+	function is expected to pull its work from a shared list until
+	it's empty. Use this instead of ParallelFor() when each thread
+	needs state of its own, such as a scratch buffer, that is
+	created once and used for every unit of work it performs.
+
+	On platforms that don't support threads, the worker calls
+	are performed one after another on the calling thread, so the
+	function must not wait on work being done by another thread.
+
+	\param pProc Pointer to the function each thread calls
+	\param pData Pointer passed to each call to pProc
+	\param uMaxThreads Maximum number of threads to use, zero means Thread::GetProcessorCount(), capped at \ref MAXPARALLELTHREADS
+	\sa ParallelFor(ParallelProc,void *,Word,Word)
+
+***************************************/
+
+void BURGER_API Burger::ParallelRun(Thread::FunctionPtr pProc,void *pData,Word uMaxThreads)
+{
+	if (!uMaxThreads) {
+		uMaxThreads = Thread::GetProcessorCount();
+	}
+	// The calling thread counts as one of the threads
+	Word uWorkers = 0;
+	if (uMaxThreads) {
+		uWorkers = uMaxThreads-1;
+		if (uWorkers>(MAXPARALLELTHREADS-1)) {
+			uWorkers = MAXPARALLELTHREADS-1;
+		}
+	}
+
+	// Fire up the helpers. If threads are not supported, Start()
+	// executes the function immediately, which is still correct.
+	Thread Workers[MAXPARALLELTHREADS-1];
+	Word i = 0;
+	while (i<uWorkers) {
+		Workers[i].Start(pProc,pData);
+		++i;
+	}
+	// Do some work myself
+	pProc(pData);
+	// Wait for the stragglers
+	i = 0;
+	while (i<uWorkers) {
+		Workers[i].Wait();
+		++i;
+	}
+}
\ No newline at end of file
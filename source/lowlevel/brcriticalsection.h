@@ -46,6 +46,11 @@
 #include "briostypes.h"
 #endif
 
+#if defined(BURGER_LINUX)
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
 /* BEGIN */
 namespace Burger {
 class CriticalSection {
@@ -59,9 +64,9 @@ class CriticalSection {
 #if defined(BURGER_PS4) || defined(DOXYGEN)
 	pthread_mutex *m_Lock;		///< Critical section for PS4 (PS4 only)
 #endif
-#if (defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if (defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	friend class ConditionVariable;
-	pthread_mutex_t m_Lock;		///< Critical section for Android/MacOSX/iOS (Android/MacOSX/iOS only)
+	pthread_mutex_t m_Lock;		///< Critical section for Android/MacOSX/iOS/Linux (Android/MacOSX/iOS/Linux only)
 #endif
 public:
 	CriticalSection();
@@ -94,8 +99,8 @@ class Semaphore {
 #if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360)) || defined(DOXYGEN)
 	void *m_pSemaphore;			///< Semaphore HANDLE (Windows only)
 #endif
-#if (defined(BURGER_ANDROID)) || defined(DOXYGEN)
-	sem_t m_Semaphore;			///< Semaphore instance (Android)
+#if (defined(BURGER_ANDROID) || defined(BURGER_LINUX)) || defined(DOXYGEN)
+	sem_t m_Semaphore;			///< Semaphore instance (Android/Linux)
 	Word m_bInitialized;		///< \ref TRUE if the semaphore instance successfully initialized
 #endif
 #if (defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
@@ -114,11 +119,11 @@ public:
 };
 
 class ConditionVariable {
-#if (defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
-	pthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/MacOSX/iOS only)
-	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/MacOSX/iOS only)
+#if (defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
+	pthread_cond_t m_ConditionVariable;	///< Condition variable instance (Android/MacOSX/iOS/Linux only)
+	Word m_bInitialized;			///< \ref TRUE if the Condition variable instance successfully initialized (Android/MacOSX/iOS/Linux only)
 #endif
-#if !(defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
+#if !(defined(BURGER_ANDROID) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)) || defined(DOXYGEN)
 	CriticalSection m_CriticalSection;	///< CriticalSection for this class (Non-specialized platforms)
 	Semaphore m_WaitSemaphore;		///< Binary semaphore for forcing thread to wait for a signal (Non-specialized platforms)
 	Semaphore m_SignalsSemaphore;	///< Binary semaphore for the number of pending signals (Non-specialized platforms)
@@ -146,6 +151,10 @@ private:
 #endif
 #if (defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	struct _opaque_pthread_t *m_pThreadHandle;	///< Pointer to the thread data (MacOSX/iOS only)
+#endif
+#if defined(BURGER_LINUX) || defined(DOXYGEN)
+	pthread_t m_ThreadHandle;		///< Thread ID of the thread (Linux only)
+	Word m_bThreadStarted;			///< \ref TRUE if m_ThreadHandle is valid (Linux only)
 #endif
 	WordPtr m_uResult;					///< Result code of the thread on exit
 public:
@@ -156,13 +165,23 @@ public:
 	Word BURGER_API Wait(void);
 	Word BURGER_API Kill(void);
 	static void BURGER_API Run(void *pThis);
+	static Word BURGER_API GetProcessorCount(void);
 	BURGER_INLINE WordPtr GetResult(void) const { return m_uResult; }
 #if (defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)) || defined(DOXYGEN)
 	BURGER_INLINE Word IsInitialized(void) const { return m_pThreadHandle!=NULL; }
+#elif defined(BURGER_LINUX)
+	BURGER_INLINE Word IsInitialized(void) const { return m_bThreadStarted; }
 #else
 	BURGER_INLINE Word IsInitialized(void) const { return FALSE; }
 #endif
 };
+
+enum {
+	MAXPARALLELTHREADS=16		///< Most threads ParallelFor() and ParallelRun() will use, including the calling thread
+};
+typedef void (BURGER_API *ParallelProc)(void *pData,Word uIndex);		///< Work function prototype for ParallelFor()
+extern void BURGER_API ParallelFor(ParallelProc pProc,void *pData,Word uCount,Word uMaxThreads=0);
+extern void BURGER_API ParallelRun(Thread::FunctionPtr pProc,void *pData,Word uMaxThreads=0);
 }
 /* END */
 
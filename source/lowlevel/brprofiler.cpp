@@ -0,0 +1,651 @@
+/***************************************
+
+	Hierarchical CPU profiler
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brprofiler.h"
+#include "brtick.h"
+#include "broutputmemorystream.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+
+//
+// Each thread remembers which buffer it was given. Platforms
+// without thread local storage don't have preemptive threads
+// so they share the first buffer.
+//
+
+#if defined(BURGER_MSVC)
+#define THREADLOCAL __declspec(thread)
+#elif defined(BURGER_GNUC) || defined(BURGER_LLVM)
+#define THREADLOCAL __thread
+#endif
+
+#if defined(THREADLOCAL)
+static THREADLOCAL Burger::Profiler::ThreadBuffer_t *s_pThreadBuffer;
+#endif
+
+volatile Word32 Burger::Profiler::s_uRecording;
+volatile Word32 Burger::Profiler::s_uThreadCount;
+Word32 Burger::Profiler::s_uEventMask;
+Word64 Burger::Profiler::s_uStartTime;
+Burger::Profiler::ThreadBuffer_t Burger::Profiler::s_Threads[MAXTHREADS];
+
+/*! ************************************
+
+	\class Burger::Profiler
+	\brief Record timed zones of code for performance analysis
+
+	Code is instrumented with named zones that record a begin and
+	an end event with a time stamp from Tick::ReadNanoseconds().
+	Each thread writes to its own ring buffer without any locks,
+	so recording costs only a few nanoseconds per event. If a
+	ring buffer fills, the oldest events are overwritten.
+
+	After recording, the events can be saved as a Chrome trace
+	for viewing in chrome://tracing, or as a flat summary of the
+	call count and time spent in each zone.
+
+	Zones are added with the \ref BURGER_PROFILE_ZONE macro, which
+	compiles to nothing unless \ref BURGER_PROFILER is defined.
+	When compiled in, zones only record while recording is
+	started, otherwise they cost a single load and branch.
+
+	\code
+	Burger::Profiler::Init();
+	Burger::Profiler::Start();
+	RunGame();
+	Burger::Profiler::Stop();
+	Burger::Profiler::SaveChromeTrace("9:trace.json");
+	Burger::Profiler::Shutdown();
+	\endcode
+
+	\note Names of zones are stored as pointers, so they must be
+	static strings.
+
+	\sa ProfileZone or \ref BURGER_PROFILE_ZONE
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::Profiler::Event_t
+	\brief A single recorded event
+
+	\sa Profiler
+
+***************************************/
+
+/*! ************************************
+
+	\struct Burger::Profiler::ThreadBuffer_t
+	\brief Ring buffer of events for a single thread
+
+	Only the thread that owns the buffer writes to it, so no locking
+	is needed. The write count is stored with release ordering so
+	another thread can read all the events before it.
+
+	\sa Profiler
+
+***************************************/
+
+/*! ************************************
+
+	\brief Get the ring buffer for the calling thread
+
+	The first call from a thread claims the next free buffer. If
+	all \ref MAXTHREADS buffers are in use, \ref NULL is returned and
+	events from the thread are discarded.
+
+	\return Pointer to the thread's buffer or \ref NULL if none are available
+
+***************************************/
+
+Burger::Profiler::ThreadBuffer_t * BURGER_API Burger::Profiler::GetThreadBuffer(void)
+{
+#if defined(THREADLOCAL)
+	ThreadBuffer_t *pBuffer = s_pThreadBuffer;
+	if (!pBuffer) {
+		// Claim a buffer, but don't count past the end of the array
+		Word32 uIndex = AtomicLoad(&s_uThreadCount,MEMORYORDER_RELAXED);
+		do {
+			if (uIndex>=MAXTHREADS) {
+				return NULL;
+			}
+		} while (!AtomicCompareExchange(&s_uThreadCount,&uIndex,uIndex+1,MEMORYORDER_ACQREL));
+		pBuffer = &s_Threads[uIndex];
+		pBuffer->m_uThreadIndex = uIndex;
+		s_pThreadBuffer = pBuffer;
+	}
+	return pBuffer;
+#else
+	AtomicStore(&s_uThreadCount,1,MEMORYORDER_RELAXED);
+	return &s_Threads[0];
+#endif
+}
+
+/*! ************************************
+
+	\brief Add an event to the calling thread's ring buffer
+
+	The buffer memory is allocated by the owning thread the first time
+	it records an event after Init(WordPtr).
+
+	\param pName Name of the zone
+	\param uType \ref EVENT_BEGIN or \ref EVENT_END
+	\sa Begin(const char *) or End(const char *)
+
+***************************************/
+
+void BURGER_API Burger::Profiler::Record(const char *pName,WordPtr uType)
+{
+	ThreadBuffer_t *pBuffer = GetThreadBuffer();
+	if (pBuffer) {
+		Event_t *pEvents = pBuffer->m_pEvents;
+		if (!pEvents) {
+			Word32 uMask = s_uEventMask;
+			if (!uMask) {
+				return;
+			}
+			pEvents = static_cast<Event_t *>(Alloc(sizeof(Event_t)*(uMask+1)));
+			if (!pEvents) {
+				return;
+			}
+			pBuffer->m_pEvents = pEvents;
+		}
+		Word32 uWrite = pBuffer->m_uWrite;
+		Event_t *pEvent = &pEvents[uWrite&s_uEventMask];
+		pEvent->m_uTime = Tick::ReadNanoseconds();
+		pEvent->m_pName = pName;
+		pEvent->m_uType = uType;
+		// Publish the event to a thread reading the buffer
+		AtomicStore(&pBuffer->m_uWrite,uWrite+1,MEMORYORDER_RELEASE);
+	}
+}
+
+/*! ************************************
+
+	\brief Set the size of the ring buffers
+
+	Any previously recorded events are discarded. The size is rounded
+	up to a power of 2. Each thread allocates its buffer when it records
+	its first event.
+
+	\note Call this function while no zones are active.
+
+	\param uEventsPerThread Number of events each thread can hold
+	\return Zero on success, non-zero if the size is too large
+	\sa Shutdown(void) or Start(void)
+
+***************************************/
+
+Word BURGER_API Burger::Profiler::Init(WordPtr uEventsPerThread)
+{
+	Shutdown();
+	if (uEventsPerThread>0x10000000U) {
+		return 10;
+	}
+	if (uEventsPerThread<2) {
+		uEventsPerThread = 2;
+	}
+	s_uEventMask = PowerOf2(static_cast<Word32>(uEventsPerThread))-1;
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Stop recording and release the ring buffers
+
+	\note Call this function while no zones are active.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::Profiler::Shutdown(void)
+{
+	Stop();
+	s_uEventMask = 0;
+	// Threads keep their assigned buffers so indexes are never shared
+	Word32 i = 0;
+	do {
+		ThreadBuffer_t *pBuffer = &s_Threads[i];
+		Free(pBuffer->m_pEvents);
+		pBuffer->m_pEvents = NULL;
+		pBuffer->m_uWrite = 0;
+	} while (++i<MAXTHREADS);
+}
+
+/*! ************************************
+
+	\brief Start recording events
+
+	Time stamps in exported traces are relative to the
+	time this function is called.
+
+	\sa Stop(void) or Init(WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::Profiler::Start(void)
+{
+	s_uStartTime = Tick::ReadNanoseconds();
+	AtomicStore(&s_uRecording,1,MEMORYORDER_RELEASE);
+}
+
+/*! ************************************
+
+	\fn void Burger::Profiler::Stop(void)
+	\brief Stop recording events
+
+	Zones that are entered after this call record nothing.
+
+	\sa Start(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::Profiler::IsRecording(void)
+	\brief Return \ref TRUE if events are being recorded
+
+	\return \ref TRUE if Start() was called without a Stop()
+
+***************************************/
+
+/*! ************************************
+
+	\brief Discard all recorded events
+
+	\note Call this function while no zones are active.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+void BURGER_API Burger::Profiler::Reset(void)
+{
+	Word32 i = 0;
+	do {
+		s_Threads[i].m_uWrite = 0;
+	} while (++i<MAXTHREADS);
+}
+
+/*! ************************************
+
+	\fn void Burger::Profiler::Begin(const char *pName)
+	\brief Record entering a zone
+
+	Every call must be matched with a call to End(const char *)
+	with the same name from the same thread.
+
+	\param pName Name of the zone, must be a static string
+	\sa End(const char *) or \ref BURGER_PROFILE_BEGIN
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Profiler::End(const char *pName)
+	\brief Record leaving a zone
+
+	\param pName Name of the zone passed to Begin(const char *)
+	\sa Begin(const char *) or \ref BURGER_PROFILE_END
+
+***************************************/
+
+/***************************************
+
+	Append a time in nanoseconds as microseconds with three decimal places
+
+***************************************/
+
+static void AppendMicroseconds(Burger::OutputMemoryStream *pOutput,Word64 uNanoseconds)
+{
+	pOutput->AppendAscii(uNanoseconds/1000U);
+	Word32 uFraction = static_cast<Word32>(uNanoseconds%1000U);
+	char Buffer[5];
+	Buffer[0] = '.';
+	Buffer[1] = static_cast<char>('0'+(uFraction/100U));
+	Buffer[2] = static_cast<char>('0'+((uFraction/10U)%10U));
+	Buffer[3] = static_cast<char>('0'+(uFraction%10U));
+	Buffer[4] = 0;
+	pOutput->Append(Buffer);
+}
+
+/***************************************
+
+	Append a zone name as a JSON string
+
+***************************************/
+
+static void AppendJSONString(Burger::OutputMemoryStream *pOutput,const char *pInput)
+{
+	pOutput->Append('"');
+	Word uTemp;
+	while ((uTemp = reinterpret_cast<const Word8 *>(pInput)[0])!=0) {
+		++pInput;
+		if ((uTemp=='"') || (uTemp=='\\')) {
+			pOutput->Append('\\');
+		} else if (uTemp<32U) {
+			// Control characters are not allowed
+			uTemp = ' ';
+		}
+		pOutput->Append(static_cast<Word8>(uTemp));
+	}
+	pOutput->Append('"');
+}
+
+/*! ************************************
+
+	\brief Save the recorded events as a Chrome trace
+
+	Write the events in the Chrome trace event JSON format, which can be
+	viewed with chrome://tracing or other trace viewers. Each thread
+	is shown as its own track.
+
+	\note Call Stop() first, events recorded during this call may be missed.
+
+	\param pOutput Stream to receive the JSON text
+	\return Zero on success, non-zero on a memory error
+	\sa SaveChromeTrace(const char *) or SaveSummary(OutputMemoryStream *)
+
+***************************************/
+
+Word BURGER_API Burger::Profiler::SaveChromeTrace(OutputMemoryStream *pOutput)
+{
+	pOutput->Append("{\"traceEvents\":[");
+	Word bComma = FALSE;
+	Word32 uThreadCount = AtomicLoad(&s_uThreadCount,MEMORYORDER_ACQUIRE);
+	Word32 i = 0;
+	while (i<uThreadCount) {
+		const ThreadBuffer_t *pBuffer = &s_Threads[i];
+		Word32 uWrite = AtomicLoad(const_cast<volatile Word32 *>(&pBuffer->m_uWrite),MEMORYORDER_ACQUIRE);
+		const Event_t *pEvents = pBuffer->m_pEvents;
+		if (uWrite && pEvents) {
+			// Only the newest events are still in the ring buffer
+			Word32 uCount = (uWrite>s_uEventMask) ? s_uEventMask+1 : uWrite;
+			Word32 uRead = uWrite-uCount;
+			do {
+				const Event_t *pEvent = &pEvents[uRead&s_uEventMask];
+				if (bComma) {
+					pOutput->Append(',');
+				}
+				bComma = TRUE;
+				pOutput->Append("\n{\"name\":");
+				AppendJSONString(pOutput,pEvent->m_pName);
+				pOutput->Append((pEvent->m_uType==EVENT_BEGIN) ? ",\"ph\":\"B\",\"ts\":" : ",\"ph\":\"E\",\"ts\":");
+				AppendMicroseconds(pOutput,(pEvent->m_uTime>s_uStartTime) ? pEvent->m_uTime-s_uStartTime : 0);
+				pOutput->Append(",\"pid\":1,\"tid\":");
+				pOutput->AppendAscii(pBuffer->m_uThreadIndex);
+				pOutput->Append('}');
+				++uRead;
+			} while (--uCount);
+		}
+		++i;
+	}
+	return pOutput->Append("\n]}\n");
+}
+
+/*! ************************************
+
+	\brief Save the recorded events to a Chrome trace file
+
+	\param pFilename Burgerlib formatted name of the file to create
+	\return Zero on success, non-zero on an error
+	\sa SaveChromeTrace(OutputMemoryStream *)
+
+***************************************/
+
+Word BURGER_API Burger::Profiler::SaveChromeTrace(const char *pFilename)
+{
+	OutputMemoryStream Output;
+	Word uResult = SaveChromeTrace(&Output);
+	if (!uResult) {
+		uResult = Output.SaveFile(pFilename);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Totals for a zone in the summary report
+
+***************************************/
+
+struct ProfileTotals_t {
+	const char *m_pName;	// Name of the zone
+	Word64 m_uCount;		// Number of times the zone was completed
+	Word64 m_uTotal;		// Total time including nested zones
+	Word64 m_uSelf;			// Total time excluding nested zones
+	Word64 m_uMax;			// Longest single call including nested zones
+};
+
+struct ProfileStack_t {
+	Word m_uZone;			// Index into the totals array
+	Word64 m_uBegin;		// Time the zone was entered
+	Word64 m_uChildren;		// Time spent in nested zones
+};
+
+/*! ************************************
+
+	\brief Save a flat summary of the recorded events
+
+	Matching begin and end events are paired and the number of calls,
+	total time, time excluding nested zones, average and maximum time of
+	each zone are written as tab separated text sorted by total time.
+	Zones with the same name are combined across all threads.
+
+	\note Call Stop() first, events recorded during this call may be missed.
+	Zones still active when recording stopped are not counted.
+
+	\param pOutput Stream to receive the text
+	\return Zero on success, non-zero on a memory error
+	\sa SaveChromeTrace(OutputMemoryStream *)
+
+***************************************/
+
+Word BURGER_API Burger::Profiler::SaveSummary(OutputMemoryStream *pOutput)
+{
+	ProfileTotals_t *pTotals = static_cast<ProfileTotals_t *>(Alloc(sizeof(ProfileTotals_t)*MAXZONES));
+	if (!pTotals) {
+		return 10;
+	}
+	Word uZoneCount = 0;
+	ProfileStack_t Stack[MAXDEPTH];
+
+	Word32 uThreadCount = AtomicLoad(&s_uThreadCount,MEMORYORDER_ACQUIRE);
+	Word32 i = 0;
+	while (i<uThreadCount) {
+		const ThreadBuffer_t *pBuffer = &s_Threads[i];
+		Word32 uWrite = AtomicLoad(const_cast<volatile Word32 *>(&pBuffer->m_uWrite),MEMORYORDER_ACQUIRE);
+		const Event_t *pEvents = pBuffer->m_pEvents;
+		if (uWrite && pEvents) {
+			Word32 uCount = (uWrite>s_uEventMask) ? s_uEventMask+1 : uWrite;
+			Word32 uRead = uWrite-uCount;
+			Word uDepth = 0;
+			do {
+				const Event_t *pEvent = &pEvents[uRead&s_uEventMask];
+				++uRead;
+				if (pEvent->m_uType==EVENT_BEGIN) {
+					// Find the totals for this name
+					Word uZone = 0;
+					while (uZone<uZoneCount) {
+						if ((pTotals[uZone].m_pName==pEvent->m_pName) ||
+							!StringCompare(pTotals[uZone].m_pName,pEvent->m_pName)) {
+							break;
+						}
+						++uZone;
+					}
+					if (uZone==uZoneCount) {
+						// If the table is full, the zone is tracked but not counted
+						if (uZoneCount>=MAXZONES) {
+							uZone = MAXZONES;
+						} else {
+							ProfileTotals_t *pNew = &pTotals[uZoneCount++];
+							pNew->m_pName = pEvent->m_pName;
+							pNew->m_uCount = 0;
+							pNew->m_uTotal = 0;
+							pNew->m_uSelf = 0;
+							pNew->m_uMax = 0;
+						}
+					}
+					if (uDepth<MAXDEPTH) {
+						Stack[uDepth].m_uZone = uZone;
+						Stack[uDepth].m_uBegin = pEvent->m_uTime;
+						Stack[uDepth].m_uChildren = 0;
+					}
+					++uDepth;
+				} else if (uDepth) {
+					// Ends without a begin were overwritten in the ring buffer
+					--uDepth;
+					if (uDepth<MAXDEPTH) {
+						Word64 uElapsed = pEvent->m_uTime-Stack[uDepth].m_uBegin;
+						if (Stack[uDepth].m_uZone<MAXZONES) {
+							ProfileTotals_t *pZone = &pTotals[Stack[uDepth].m_uZone];
+							++pZone->m_uCount;
+							pZone->m_uTotal += uElapsed;
+							pZone->m_uSelf += uElapsed-Stack[uDepth].m_uChildren;
+							if (uElapsed>pZone->m_uMax) {
+								pZone->m_uMax = uElapsed;
+							}
+						}
+						if (uDepth) {
+							Stack[uDepth-1].m_uChildren += uElapsed;
+						}
+					}
+				}
+			} while (--uCount);
+		}
+		++i;
+	}
+
+	// Sort by total time, largest first
+	Word j = 1;
+	while (j<uZoneCount) {
+		ProfileTotals_t Temp = pTotals[j];
+		Word k = j;
+		while (k && (pTotals[k-1].m_uTotal<Temp.m_uTotal)) {
+			pTotals[k] = pTotals[k-1];
+			--k;
+		}
+		pTotals[k] = Temp;
+		++j;
+	}
+
+	Word uResult = pOutput->Append("Zone\tCalls\tTotal us\tSelf us\tAverage us\tMax us\n");
+	j = 0;
+	while (j<uZoneCount) {
+		const ProfileTotals_t *pZone = &pTotals[j];
+		if (pZone->m_uCount) {
+			pOutput->Append(pZone->m_pName);
+			pOutput->Append('\t');
+			pOutput->AppendAscii(pZone->m_uCount);
+			pOutput->Append('\t');
+			AppendMicroseconds(pOutput,pZone->m_uTotal);
+			pOutput->Append('\t');
+			AppendMicroseconds(pOutput,pZone->m_uSelf);
+			pOutput->Append('\t');
+			AppendMicroseconds(pOutput,pZone->m_uTotal/pZone->m_uCount);
+			pOutput->Append('\t');
+			AppendMicroseconds(pOutput,pZone->m_uMax);
+			pOutput->Append('\n');
+		}
+		++j;
+	}
+	Free(pTotals);
+	return uResult;
+}
+
+/*! ************************************
+
+	\class Burger::ProfileZone
+	\brief Record a profiler zone for the lifetime of the object
+
+	The constructor calls Profiler::Begin(const char *) and the
+	destructor calls Profiler::End(const char *). Use the
+	\ref BURGER_PROFILE_ZONE macro instead so the zone can
+	be compiled out.
+
+	\sa Profiler or \ref BURGER_PROFILE_ZONE
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::ProfileZone::ProfileZone(const char *pName)
+	\brief Enter a zone
+
+	\param pName Name of the zone, must be a static string
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::ProfileZone::~ProfileZone()
+	\brief Leave the zone
+
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_PROFILER
+	\brief Define to compile in the profiler zones
+
+	If this is defined before brprofiler.h is included, the
+	\ref BURGER_PROFILE_ZONE, \ref BURGER_PROFILE_BEGIN and
+	\ref BURGER_PROFILE_END macros record events. Otherwise
+	they generate no code at all.
+
+	\sa Profiler
+
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_PROFILE_ZONE
+	\brief Profile the rest of the current scope
+
+	Create a ProfileZone on the stack that records the time
+	until the end of the scope.
+
+	\code
+	void Draw(void)
+	{
+		BURGER_PROFILE_ZONE("Draw");
+		DrawBackground();
+	}
+	\endcode
+
+	\param pName Name of the zone, must be a static string
+	\sa ProfileZone or \ref BURGER_PROFILER
+
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_PROFILE_BEGIN
+	\brief Call Profiler::Begin(const char *) if the profiler is compiled in
+
+	\param pName Name of the zone, must be a static string
+	\sa BURGER_PROFILE_END or \ref BURGER_PROFILER
+
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_PROFILE_END
+	\brief Call Profiler::End(const char *) if the profiler is compiled in
+
+	\param pName Name of the zone passed to \ref BURGER_PROFILE_BEGIN
+	\sa BURGER_PROFILE_BEGIN or \ref BURGER_PROFILER
+
+***************************************/
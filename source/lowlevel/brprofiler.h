@@ -0,0 +1,93 @@
+/***************************************
+
+	Hierarchical CPU profiler
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRPROFILER_H__
+#define __BRPROFILER_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class OutputMemoryStream;
+class Profiler {
+public:
+	enum {
+		MAXTHREADS=64,				///< Maximum number of threads that can record events
+		MAXDEPTH=64,				///< Maximum nesting of zones tracked by the summary report
+		MAXZONES=512,				///< Maximum number of unique zone names in the summary report
+		DEFAULTEVENTS=0x10000		///< Default number of events in each thread's ring buffer
+	};
+	enum eEventType {
+		EVENT_BEGIN=0,				///< A zone was entered
+		EVENT_END=1					///< A zone was exited
+	};
+	struct Event_t {
+		Word64 m_uTime;				///< Time of the event from Tick::ReadNanoseconds()
+		const char *m_pName;		///< Name of the zone, must be a static string
+		WordPtr m_uType;			///< \ref eEventType of the event
+	};
+	struct ThreadBuffer_t {
+		Event_t *m_pEvents;			///< Ring buffer of events
+		volatile Word32 m_uWrite;	///< Number of events ever written, only changed by the owning thread
+		Word32 m_uThreadIndex;		///< Index of this buffer, used as the thread id in exported traces
+	};
+private:
+	static volatile Word32 s_uRecording;		///< Non-zero if events are being recorded
+	static volatile Word32 s_uThreadCount;		///< Number of ThreadBuffer_t entries handed out
+	static Word32 s_uEventMask;					///< Number of events per thread minus one
+	static Word64 s_uStartTime;					///< Time Start() was called
+	static ThreadBuffer_t s_Threads[MAXTHREADS];	///< Buffer for each thread
+	static ThreadBuffer_t * BURGER_API GetThreadBuffer(void);
+	static void BURGER_API Record(const char *pName,WordPtr uType);
+public:
+	static Word BURGER_API Init(WordPtr uEventsPerThread=DEFAULTEVENTS);
+	static void BURGER_API Shutdown(void);
+	static void BURGER_API Start(void);
+	static BURGER_INLINE void Stop(void) { AtomicStore(&s_uRecording,0,MEMORYORDER_RELEASE); }
+	static BURGER_INLINE Word IsRecording(void) { return AtomicLoad(&s_uRecording,MEMORYORDER_RELAXED)!=0; }
+	static void BURGER_API Reset(void);
+	static BURGER_INLINE void Begin(const char *pName) { if (IsRecording()) { Record(pName,EVENT_BEGIN); } }
+	static BURGER_INLINE void End(const char *pName) { if (IsRecording()) { Record(pName,EVENT_END); } }
+	static Word BURGER_API SaveChromeTrace(OutputMemoryStream *pOutput);
+	static Word BURGER_API SaveChromeTrace(const char *pFilename);
+	static Word BURGER_API SaveSummary(OutputMemoryStream *pOutput);
+};
+
+class ProfileZone {
+	BURGER_DISABLECOPYCONSTRUCTORS(ProfileZone);
+	const char *m_pName;	///< Name of the zone
+public:
+	ProfileZone(const char *pName) : m_pName(pName) { Profiler::Begin(pName); }
+	~ProfileZone() { Profiler::End(m_pName); }
+};
+}
+#if defined(BURGER_PROFILER) || defined(DOXYGEN)
+#define BURGER_PROFILE_JOIN2(x,y) x##y
+#define BURGER_PROFILE_JOIN(x,y) BURGER_PROFILE_JOIN2(x,y)
+#define BURGER_PROFILE_ZONE(pName) Burger::ProfileZone BURGER_PROFILE_JOIN(ProfileZone,__LINE__)(pName)
+#define BURGER_PROFILE_BEGIN(pName) Burger::Profiler::Begin(pName)
+#define BURGER_PROFILE_END(pName) Burger::Profiler::End(pName)
+#else
+#define BURGER_PROFILE_ZONE(pName)
+#define BURGER_PROFILE_BEGIN(pName)
+#define BURGER_PROFILE_END(pName)
+#endif
+/* END */
+
+#endif
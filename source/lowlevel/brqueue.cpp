@@ -47,7 +47,7 @@
 	This class will put data into a singly linked list and insert
 	at the end and extract from the beginning.
 
-	\sa RunQueue
+	\sa RunQueue, SPSCQueue or MPMCQueue
 	
 ***************************************/
 
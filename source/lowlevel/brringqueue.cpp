@@ -0,0 +1,375 @@
+/***************************************
+
+	Lock free fixed size ring buffer queues
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brringqueue.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\class Burger::RingQueueBase
+	\brief Shared constants for the lock free ring buffer queues
+
+	The index variables of the queues are separated by \ref CACHELINESIZE
+	bytes of padding so the producer and consumer threads never write
+	to the same cache line while passing data.
+
+	\sa SPSCQueue or MPMCQueue
+
+***************************************/
+
+/*! ************************************
+
+	\brief Round up a requested queue size
+
+	The ring buffer queues index their entries with a mask, so the
+	number of entries is rounded up to the nearest power of 2.
+	There is a minimum of two entries.
+
+	\param uCapacity Requested number of entries
+	\return Number of entries to allocate, zero if larger than \ref MAXCAPACITY
+	\sa SPSCQueue::Init(WordPtr) or MPMCQueue::Init(WordPtr)
+
+***************************************/
+
+Word32 BURGER_API Burger::RingQueueBase::GetCapacity(WordPtr uCapacity)
+{
+	if (uCapacity>MAXCAPACITY) {
+		return 0;
+	}
+	if (uCapacity<2) {
+		uCapacity = 2;
+	}
+	return PowerOf2(static_cast<Word32>(uCapacity));
+}
+
+/*! ************************************
+
+	\class Burger::SPSCQueue
+	\brief A lock free first in first out queue for one producer and one consumer
+
+	Unlike Queue, this class never allocates memory after
+	Init(WordPtr) is called and it can be used to pass data
+	from one thread to another without a CriticalSection.
+
+	Only one thread can call push() and only one thread can call
+	pop() at any given time. Each side keeps a private copy of the
+	other side's index so the shared cache lines are only read when
+	the queue appears full or empty.
+
+	\code
+	Burger::SPSCQueue<Word32> Messages;
+	Messages.Init(256);
+
+	// Producer thread
+	if (!Messages.push(uMessage)) {
+		// Queue is full
+	}
+
+	// Consumer thread
+	Word32 Incoming[16];
+	WordPtr uCount = Messages.pop(Incoming,16);
+	\endcode
+
+	\tparam T Type of data to store, it must have a copy constructor and assignment operator
+	\sa MPMCQueue or Queue
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SPSCQueue::SPSCQueue()
+	\brief Initialize to defaults
+
+	Creates an empty queue with no storage. Init(WordPtr)
+	must be called before data can be added.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::SPSCQueue::~SPSCQueue()
+	\brief Dispose of all data remaining in the queue
+
+	\sa Shutdown(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SPSCQueue::Init(WordPtr uCapacity)
+	\brief Allocate the storage for the queue
+
+	Release any previous storage and allocate space
+	for at least uCapacity entries.
+
+	\note This function is not thread safe.
+
+	\param uCapacity Minimum number of entries the queue can hold
+	\return Zero on success, non-zero on memory allocation failure
+	\sa Shutdown(void) or RingQueueBase::GetCapacity(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::SPSCQueue::Shutdown(void)
+	\brief Dispose of all data and storage
+
+	\note This function is not thread safe.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SPSCQueue::push(const T &rData)
+	\brief Insert data at the end of the queue
+
+	Only call this function from the producer thread.
+
+	\param rData Reference to a data chunk to copy into the queue
+	\return \ref TRUE if the data was added, \ref FALSE if the queue is full
+	\sa push(const T *,WordPtr) or pop(T *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::SPSCQueue::push(const T *pInput,WordPtr uCount)
+	\brief Insert an array of data at the end of the queue
+
+	As many entries as will fit are added and they are made
+	visible to the consumer all at once.
+
+	Only call this function from the producer thread.
+
+	\param pInput Pointer to an array of data to copy into the queue
+	\param uCount Number of entries in the array
+	\return Number of entries that were added
+	\sa push(const T &) or pop(T *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SPSCQueue::pop(T *pOutput)
+	\brief Remove the first entry of the queue
+
+	Only call this function from the consumer thread.
+
+	\param pOutput Pointer to receive a copy of the data
+	\return \ref TRUE if data was retrieved, \ref FALSE if the queue is empty
+	\sa pop(T *,WordPtr) or push(const T &)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::SPSCQueue::pop(T *pOutput,WordPtr uCount)
+	\brief Remove up to uCount entries from the front of the queue
+
+	Only call this function from the consumer thread.
+
+	\param pOutput Pointer to an array to receive the data
+	\param uCount Maximum number of entries to retrieve
+	\return Number of entries that were retrieved
+	\sa pop(T *) or push(const T *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::SPSCQueue::size(void) const
+	\brief Get the number of entries in the queue
+
+	If the other thread is active, the value is only a snapshot.
+
+	\return The number of entries in the queue.
+	\sa empty(void) const or capacity(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::SPSCQueue::empty(void) const
+	\brief Returns \ref TRUE if the queue is empty
+
+	\return \ref TRUE if there is no data in the queue.
+	\sa size(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::SPSCQueue::capacity(void) const
+	\brief Get the maximum number of entries in the queue
+
+	\return The number of entries the queue can hold, zero if Init(WordPtr) wasn't called
+	\sa size(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::MPMCQueue
+	\brief A lock free first in first out queue for many producers and consumers
+
+	This class can be shared by any number of threads that
+	add or remove data at the same time. Each entry has a sequence
+	number that records which lap of the ring buffer it is ready for,
+	so a thread only needs a single compare and swap on the
+	shared index to claim an entry or a run of entries.
+
+	Calls never wait for another thread. If push() returns \ref FALSE
+	the queue was full, and if pop() returns \ref FALSE the queue
+	was empty or the oldest entry was still being written.
+
+	\tparam T Type of data to store, it must have a copy constructor and assignment operator
+	\sa SPSCQueue or Queue
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::MPMCQueue::MPMCQueue()
+	\brief Initialize to defaults
+
+	Creates an empty queue with no storage. Init(WordPtr)
+	must be called before data can be added.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::MPMCQueue::~MPMCQueue()
+	\brief Dispose of all data remaining in the queue
+
+	\sa Shutdown(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::MPMCQueue::Init(WordPtr uCapacity)
+	\brief Allocate the storage for the queue
+
+	Release any previous storage and allocate space
+	for at least uCapacity entries.
+
+	\note This function is not thread safe.
+
+	\param uCapacity Minimum number of entries the queue can hold
+	\return Zero on success, non-zero on memory allocation failure
+	\sa Shutdown(void) or RingQueueBase::GetCapacity(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::MPMCQueue::Shutdown(void)
+	\brief Dispose of all data and storage
+
+	\note This function is not thread safe.
+
+	\sa Init(WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::MPMCQueue::push(const T &rData)
+	\brief Insert data at the end of the queue
+
+	\param rData Reference to a data chunk to copy into the queue
+	\return \ref TRUE if the data was added, \ref FALSE if the queue is full
+	\sa push(const T *,WordPtr) or pop(T *)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::MPMCQueue::push(const T *pInput,WordPtr uCount)
+	\brief Insert an array of data at the end of the queue
+
+	The longest run of free entries, up to uCount, is claimed with
+	a single compare and swap and the data is stored in order.
+
+	\param pInput Pointer to an array of data to copy into the queue
+	\param uCount Number of entries in the array
+	\return Number of entries that were added
+	\sa push(const T &) or pop(T *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::MPMCQueue::pop(T *pOutput)
+	\brief Remove the first entry of the queue
+
+	\param pOutput Pointer to receive a copy of the data
+	\return \ref TRUE if data was retrieved, \ref FALSE if the queue is empty
+	\sa pop(T *,WordPtr) or push(const T &)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::MPMCQueue::pop(T *pOutput,WordPtr uCount)
+	\brief Remove up to uCount entries from the front of the queue
+
+	The longest run of completed entries, up to uCount, is claimed
+	with a single compare and swap and the data is copied in order.
+
+	\param pOutput Pointer to an array to receive the data
+	\param uCount Maximum number of entries to retrieve
+	\return Number of entries that were retrieved
+	\sa pop(T *) or push(const T *,WordPtr)
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::MPMCQueue::size(void) const
+	\brief Get the number of entries in the queue
+
+	If other threads are active, the value is only a snapshot.
+
+	\return The number of entries in the queue.
+	\sa empty(void) const or capacity(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::MPMCQueue::empty(void) const
+	\brief Returns \ref TRUE if the queue is empty
+
+	\return \ref TRUE if there is no data in the queue.
+	\sa size(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn WordPtr Burger::MPMCQueue::capacity(void) const
+	\brief Get the maximum number of entries in the queue
+
+	\return The number of entries the queue can hold, zero if Init(WordPtr) wasn't called
+	\sa size(void) const
+
+***************************************/
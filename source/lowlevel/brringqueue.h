@@ -0,0 +1,326 @@
+/***************************************
+
+	Lock free fixed size ring buffer queues
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRRINGQUEUE_H__
+#define __BRRINGQUEUE_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
+#ifndef __BRASSERT_H__
+#include "brassert.h"
+#endif
+
+#ifndef __BRGLOBALMEMORYMANAGER_H__
+#include "brglobalmemorymanager.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class RingQueueBase {
+public:
+	enum {
+#if defined(BURGER_POWERPC)
+		CACHELINESIZE=128,			///< Size in bytes of a CPU cache line
+#else
+		CACHELINESIZE=64,			///< Size in bytes of a CPU cache line
+#endif
+		MAXCAPACITY=0x40000000		///< Largest number of entries a queue can hold
+	};
+	static Word32 BURGER_API GetCapacity(WordPtr uCapacity);
+};
+
+template<class T>
+class SPSCQueue : public RingQueueBase {
+	BURGER_DISABLECOPYCONSTRUCTORS(SPSCQueue);
+	T *m_pBuffer;					///< Storage for the entries
+	Word32 m_uMask;					///< Number of entries minus one
+	Word8 m_Padding1[CACHELINESIZE];	///< Keep the consumer index off the shared cache line
+	volatile Word32 m_uHead;		///< Index of the next entry to read (Written by the consumer)
+	Word32 m_uTailCache;			///< Consumer's copy of m_uTail
+	Word8 m_Padding2[CACHELINESIZE];	///< Keep the producer index off the consumer's cache line
+	volatile Word32 m_uTail;		///< Index of the next entry to write (Written by the producer)
+	Word32 m_uHeadCache;			///< Producer's copy of m_uHead
+	Word8 m_Padding3[CACHELINESIZE];	///< Keep the producer index off the next object's cache line
+public:
+	SPSCQueue() : m_pBuffer(NULL),m_uMask(0),m_uHead(0),m_uTailCache(0),m_uTail(0),m_uHeadCache(0) {}
+	~SPSCQueue() { Shutdown(); }
+	Word Init(WordPtr uCapacity) {
+		Shutdown();
+		Word32 uSize = GetCapacity(uCapacity);
+		if (uSize) {
+			m_pBuffer = static_cast<T *>(Alloc(sizeof(T)*uSize));
+			if (m_pBuffer) {
+				m_uMask = uSize-1;
+				return 0;
+			}
+		}
+		return 10;
+	}
+	void Shutdown(void) {
+		if (m_pBuffer) {
+			Word32 uHead = m_uHead;
+			Word32 uTail = m_uTail;
+			while (uHead!=uTail) {
+				m_pBuffer[uHead&m_uMask].~T();
+				++uHead;
+			}
+			Free(m_pBuffer);
+			m_pBuffer = NULL;
+		}
+		m_uMask = 0;
+		m_uHead = 0;
+		m_uTailCache = 0;
+		m_uTail = 0;
+		m_uHeadCache = 0;
+	}
+	Word push(const T &rData) {
+		BURGER_ASSERT(m_pBuffer);
+		Word32 uTail = m_uTail;
+		if ((uTail-m_uHeadCache)>m_uMask) {
+			m_uHeadCache = AtomicGet(&m_uHead);
+			if ((uTail-m_uHeadCache)>m_uMask) {
+				return FALSE;
+			}
+		}
+		new (&m_pBuffer[uTail&m_uMask]) T(rData);
+		AtomicSet(&m_uTail,uTail+1);
+		return TRUE;
+	}
+	WordPtr push(const T *pInput,WordPtr uCount) {
+		BURGER_ASSERT(m_pBuffer);
+		Word32 uTail = m_uTail;
+		WordPtr uFree = (m_uMask+1)-(uTail-m_uHeadCache);
+		if (uFree<uCount) {
+			m_uHeadCache = AtomicGet(&m_uHead);
+			uFree = (m_uMask+1)-(uTail-m_uHeadCache);
+			if (uFree<uCount) {
+				uCount = uFree;
+			}
+		}
+		if (uCount) {
+			WordPtr i = uCount;
+			Word32 uIndex = uTail;
+			do {
+				new (&m_pBuffer[uIndex&m_uMask]) T(pInput[0]);
+				++pInput;
+				++uIndex;
+			} while (--i);
+			AtomicSet(&m_uTail,uIndex);
+		}
+		return uCount;
+	}
+	Word pop(T *pOutput) {
+		Word32 uHead = m_uHead;
+		if (uHead==m_uTailCache) {
+			m_uTailCache = AtomicGet(&m_uTail);
+			if (uHead==m_uTailCache) {
+				return FALSE;
+			}
+		}
+		T *pEntry = &m_pBuffer[uHead&m_uMask];
+		pOutput[0] = pEntry[0];
+		pEntry->~T();
+		AtomicSet(&m_uHead,uHead+1);
+		return TRUE;
+	}
+	WordPtr pop(T *pOutput,WordPtr uCount) {
+		Word32 uHead = m_uHead;
+		WordPtr uUsed = m_uTailCache-uHead;
+		if (uUsed<uCount) {
+			m_uTailCache = AtomicGet(&m_uTail);
+			uUsed = m_uTailCache-uHead;
+			if (uUsed<uCount) {
+				uCount = uUsed;
+			}
+		}
+		if (uCount) {
+			WordPtr i = uCount;
+			do {
+				T *pEntry = &m_pBuffer[uHead&m_uMask];
+				pOutput[0] = pEntry[0];
+				pEntry->~T();
+				++pOutput;
+				++uHead;
+			} while (--i);
+			AtomicSet(&m_uHead,uHead);
+		}
+		return uCount;
+	}
+	BURGER_INLINE WordPtr size(void) const { return static_cast<Word32>(m_uTail-m_uHead); }
+	BURGER_INLINE Word empty(void) const { return m_uTail==m_uHead; }
+	BURGER_INLINE WordPtr capacity(void) const { return m_pBuffer ? m_uMask+1 : 0; }
+};
+
+template<class T>
+class MPMCQueue : public RingQueueBase {
+	BURGER_DISABLECOPYCONSTRUCTORS(MPMCQueue);
+	T *m_pBuffer;					///< Storage for the entries
+	volatile Word32 *m_pSequences;	///< Sequence number for each entry
+	Word32 m_uMask;					///< Number of entries minus one
+	Word8 m_Padding1[CACHELINESIZE];	///< Keep the read index off the shared cache line
+	volatile Word32 m_uHead;		///< Index of the next entry to read (Shared by all consumers)
+	Word8 m_Padding2[CACHELINESIZE];	///< Keep the write index off the read index's cache line
+	volatile Word32 m_uTail;		///< Index of the next entry to write (Shared by all producers)
+	Word8 m_Padding3[CACHELINESIZE];	///< Keep the write index off the next object's cache line
+public:
+	MPMCQueue() : m_pBuffer(NULL),m_pSequences(NULL),m_uMask(0),m_uHead(0),m_uTail(0) {}
+	~MPMCQueue() { Shutdown(); }
+	Word Init(WordPtr uCapacity) {
+		Shutdown();
+		Word32 uSize = GetCapacity(uCapacity);
+		if (uSize) {
+			m_pBuffer = static_cast<T *>(Alloc(sizeof(T)*uSize));
+			m_pSequences = static_cast<volatile Word32 *>(Alloc(sizeof(Word32)*uSize));
+			if (m_pBuffer && m_pSequences) {
+				m_uMask = uSize-1;
+				Word32 i = 0;
+				do {
+					m_pSequences[i] = i;
+				} while (++i<uSize);
+				return 0;
+			}
+			Shutdown();
+		}
+		return 10;
+	}
+	void Shutdown(void) {
+		if (m_pBuffer && m_pSequences) {
+			Word32 uHead = m_uHead;
+			Word32 uTail = m_uTail;
+			while (uHead!=uTail) {
+				m_pBuffer[uHead&m_uMask].~T();
+				++uHead;
+			}
+		}
+		Free(m_pBuffer);
+		m_pBuffer = NULL;
+		Free(const_cast<Word32 *>(m_pSequences));
+		m_pSequences = NULL;
+		m_uMask = 0;
+		m_uHead = 0;
+		m_uTail = 0;
+	}
+	Word push(const T &rData) {
+		BURGER_ASSERT(m_pBuffer);
+		Word32 uTail = AtomicGet(&m_uTail);
+		for (;;) {
+			Int32 iDifference = static_cast<Int32>(AtomicGet(&m_pSequences[uTail&m_uMask])-uTail);
+			if (!iDifference) {
+				if (AtomicSetIfMatch(&m_uTail,uTail,uTail+1)) {
+					break;
+				}
+			} else if (iDifference<0) {
+				return FALSE;
+			}
+			uTail = AtomicGet(&m_uTail);
+		}
+		new (&m_pBuffer[uTail&m_uMask]) T(rData);
+		AtomicSet(&m_pSequences[uTail&m_uMask],uTail+1);
+		return TRUE;
+	}
+	WordPtr push(const T *pInput,WordPtr uCount) {
+		BURGER_ASSERT(m_pBuffer);
+		if (uCount>(m_uMask+1)) {
+			uCount = m_uMask+1;
+		}
+		Word32 uTail;
+		WordPtr uClaim;
+		do {
+			uTail = AtomicGet(&m_uTail);
+			// Count the run of entries that are free for this lap
+			uClaim = 0;
+			while (uClaim<uCount) {
+				Word32 uIndex = uTail+static_cast<Word32>(uClaim);
+				if (AtomicGet(&m_pSequences[uIndex&m_uMask])!=uIndex) {
+					break;
+				}
+				++uClaim;
+			}
+			if (!uClaim) {
+				return 0;
+			}
+		} while (!AtomicSetIfMatch(&m_uTail,uTail,uTail+static_cast<Word32>(uClaim)));
+		WordPtr i = uClaim;
+		do {
+			new (&m_pBuffer[uTail&m_uMask]) T(pInput[0]);
+			AtomicSet(&m_pSequences[uTail&m_uMask],uTail+1);
+			++pInput;
+			++uTail;
+		} while (--i);
+		return uClaim;
+	}
+	Word pop(T *pOutput) {
+		Word32 uHead = AtomicGet(&m_uHead);
+		for (;;) {
+			Int32 iDifference = static_cast<Int32>(AtomicGet(&m_pSequences[uHead&m_uMask])-(uHead+1));
+			if (!iDifference) {
+				if (AtomicSetIfMatch(&m_uHead,uHead,uHead+1)) {
+					break;
+				}
+			} else if (iDifference<0) {
+				return FALSE;
+			}
+			uHead = AtomicGet(&m_uHead);
+		}
+		T *pEntry = &m_pBuffer[uHead&m_uMask];
+		pOutput[0] = pEntry[0];
+		pEntry->~T();
+		AtomicSet(&m_pSequences[uHead&m_uMask],uHead+m_uMask+1);
+		return TRUE;
+	}
+	WordPtr pop(T *pOutput,WordPtr uCount) {
+		if (uCount>(m_uMask+1)) {
+			uCount = m_uMask+1;
+		}
+		Word32 uHead;
+		WordPtr uClaim;
+		do {
+			uHead = AtomicGet(&m_uHead);
+			// Count the run of entries that are filled for this lap
+			uClaim = 0;
+			while (uClaim<uCount) {
+				Word32 uIndex = uHead+static_cast<Word32>(uClaim);
+				if (AtomicGet(&m_pSequences[uIndex&m_uMask])!=(uIndex+1)) {
+					break;
+				}
+				++uClaim;
+			}
+			if (!uClaim) {
+				return 0;
+			}
+		} while (!AtomicSetIfMatch(&m_uHead,uHead,uHead+static_cast<Word32>(uClaim)));
+		WordPtr i = uClaim;
+		do {
+			T *pEntry = &m_pBuffer[uHead&m_uMask];
+			pOutput[0] = pEntry[0];
+			pEntry->~T();
+			AtomicSet(&m_pSequences[uHead&m_uMask],uHead+m_uMask+1);
+			++pOutput;
+			++uHead;
+		} while (--i);
+		return uClaim;
+	}
+	BURGER_INLINE WordPtr size(void) const { Int32 iSize = static_cast<Int32>(m_uTail-m_uHead); return (iSize>0) ? static_cast<WordPtr>(iSize) : 0; }
+	BURGER_INLINE Word empty(void) const { return size()==0; }
+	BURGER_INLINE WordPtr capacity(void) const { return m_pBuffer ? m_uMask+1 : 0; }
+};
+}
+/* END */
+
+#endif
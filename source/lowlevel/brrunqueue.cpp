@@ -13,6 +13,7 @@
 
 #include "brrunqueue.h"
 #include "brglobalmemorymanager.h"
+#include "brprofiler.h"
 
 /*! ************************************
 
@@ -96,6 +97,7 @@ Burger::RunQueue::~RunQueue()
 
 void Burger::RunQueue::Call(void)
 {
+	BURGER_PROFILE_ZONE("RunQueue::Call");
 	if (!m_Recurse) {
 		RunQueueEntry_t *pWork = m_pFirst;		// Get the master handle
 		if (pWork) { 							// Any in the list?
@@ -12,6 +12,7 @@
 ***************************************/
 
 #include "brsmartpointer.h"
+#include "brtick.h"
 
 /*! ************************************
 
@@ -83,7 +84,6 @@ Burger::ProxyReferenceCounter *Burger::ProxyReferenceCounter::New(void)
 
 /*! ************************************
 
-	\fn void Burger::ProxyReferenceCounter::ParentIsDead(void)
 	\brief Send a signal that the parent was deleted.
 
 	This function should only be called by the parent object
@@ -92,6 +92,58 @@ Burger::ProxyReferenceCounter *Burger::ProxyReferenceCounter::New(void)
 	WeakPointer object that reference it will be
 	able to know that the parent is gone.
 
+	If another thread is in the middle of WeakPointer::Lock(),
+	this function waits for it to finish so the parent's
+	memory isn't released while its reference count is being tested.
+
+	\sa BeginUpgrade(void)
+
+***************************************/
+
+void Burger::ProxyReferenceCounter::ParentIsDead(void)
+{
+	while (!AtomicSetIfMatch(&m_uState,0,1U)) {
+		Sleep(SLEEP_YIELD);
+	}
+}
+
+/*! ************************************
+
+	\brief Prevent the parent from being deleted
+
+	Before a WeakPointer can take ownership of the parent, it
+	must stop the parent's memory from being released while it
+	attempts to increase the reference count. If this function
+	returns \ref TRUE, the parent's destructor will not complete
+	until EndUpgrade() is called.
+
+	\return \ref TRUE if the parent is alive, \ref FALSE if it was deleted
+	\sa EndUpgrade(void) or WeakPointer::Lock(void) const
+
+***************************************/
+
+Word Burger::ProxyReferenceCounter::BeginUpgrade(void)
+{
+	Word32 uState;
+	do {
+		uState = AtomicGet(&m_uState);
+		if (uState&1U) {
+			return FALSE;
+		}
+	} while (!AtomicSetIfMatch(&m_uState,uState,uState+2U));
+	return TRUE;
+}
+
+/*! ************************************
+
+	\fn void Burger::ProxyReferenceCounter::EndUpgrade(void)
+	\brief Allow the parent to be deleted
+
+	Release the hold on the parent that was obtained by
+	a successful call to BeginUpgrade().
+
+	\sa BeginUpgrade(void)
+
 ***************************************/
 
 /*! ************************************
@@ -120,9 +172,6 @@ Burger::ProxyReferenceCounter *Burger::ProxyReferenceCounter::New(void)
 
 ***************************************/
 
-
-
-
 #if !defined(DOXYGEN)
 BURGER_CREATE_STATICRTTI_PARENT(Burger::ReferenceCounter,Burger::Base);
 #endif
@@ -138,7 +187,11 @@ BURGER_CREATE_STATICRTTI_PARENT(Burger::ReferenceCounter,Burger::Base);
 	of this object, the reference count will reach zero
 	and this object will immediately self-destruct.
 
-	\sa WeakPointer, ProxyReferenceCounter and SmartPointer
+	The reference count is not thread safe. If SmartPointer objects
+	to the same object are used on more than one thread, derive
+	from AtomicReferenceCounter instead.
+
+	\sa AtomicReferenceCounter, WeakPointer, ProxyReferenceCounter and SmartPointer
 
 ***************************************/
 
@@ -197,6 +250,155 @@ Burger::ReferenceCounter::~ReferenceCounter()
 
 ***************************************/
 
+/*! ************************************
+
+	\fn Word Burger::ReferenceCounter::TryAddRef(void)
+	\brief Increase the reference count by 1 if it's not zero
+
+	Used by WeakPointer::Lock() to take ownership of an object only
+	if some other SmartPointer still owns it.
+
+	\return \ref TRUE if ownership was taken, \ref FALSE if the reference count was zero
+	\sa AddRef()
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::ReferenceCounter::GetRefCount(void) const
+	\brief Return the current reference count
+
+	\return The number of owners of this object
+
+***************************************/
+
+#if !defined(DOXYGEN)
+BURGER_CREATE_STATICRTTI_PARENT(Burger::AtomicReferenceCounter,Burger::Base);
+#endif
+
+/*! ************************************
+
+	\class Burger::AtomicReferenceCounter
+	\brief Thread safe version of ReferenceCounter
+
+	This class has the same interface as ReferenceCounter, but
+	the reference count is changed with atomic operations so
+	SmartPointer objects that point to the same object can
+	be created and destroyed on different threads.
+
+	ReferenceCounter is faster, so derive from it for objects
+	that are only used by a single thread and derive from
+	this class for objects that are shared.
+
+	\code
+	class SharedJob : public Burger::AtomicReferenceCounter {
+		BURGER_ALLOW_WEAK_POINTERS();
+	public:
+		void Run(void);
+	};
+	\endcode
+
+	\sa ReferenceCounter, WeakPointer or SmartPointer
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::AtomicReferenceCounter::AtomicReferenceCounter()
+	\brief Sets the reference count to zero
+
+***************************************/
+
+/*! ************************************
+
+	\brief Destructor.
+
+	Does absolutely nothing
+
+***************************************/
+
+Burger::AtomicReferenceCounter::~AtomicReferenceCounter()
+{
+}
+
+/*! ************************************
+
+	\fn void Burger::AtomicReferenceCounter::AddRef(void)
+	\brief Atomically increase the reference count by 1
+
+	Take an ownership of this object by calling this function.
+	Call Release() to give up ownership. Once the
+	reference count reaches zero, the object will self destruct.
+
+	The caller already holds a reference, so the increment doesn't
+	need to be ordered with any other memory access.
+
+	\sa Release()
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::AtomicReferenceCounter::Release(void)
+	\brief Atomically decrease the reference count by 1
+
+	Give up ownership of this object by calling this function.
+	The thread that releases the last reference deletes the object.
+	The decrement has acquire and release ordering so all writes
+	to the object by other threads are visible to the destructor.
+
+	\sa AddRef()
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::AtomicReferenceCounter::TryAddRef(void)
+	\brief Atomically increase the reference count by 1 if it's not zero
+
+	Since another thread could be releasing the last reference,
+	the count is only increased with a compare and swap
+	from a non-zero value. Once the count reaches zero, this
+	function will never resurrect the object.
+
+	\return \ref TRUE if ownership was taken, \ref FALSE if the reference count was zero
+	\sa AddRef() or WeakPointer::Lock(void) const
+
+***************************************/
+
+Word Burger::AtomicReferenceCounter::TryAddRef(void)
+{
+	Word32 uCount;
+	do {
+		uCount = AtomicGet(&m_uRefCount);
+		if (!uCount) {
+			return FALSE;
+		}
+	} while (!AtomicSetIfMatch(&m_uRefCount,uCount,uCount+1));
+	return TRUE;
+}
+
+/*! ************************************
+
+	\fn Word Burger::AtomicReferenceCounter::GetRefCount(void) const
+	\brief Return the current reference count
+
+	If other threads are active, the value is only a snapshot.
+
+	\return The number of owners of this object
+
+***************************************/
+
+/*! ************************************
+
+	\var const Burger::StaticRTTI Burger::AtomicReferenceCounter::g_StaticRTTI
+	\brief The global description of the class
+
+	This record contains the name of this class and a
+	reference to the parent
+
+***************************************/
+
 
 
 
@@ -264,7 +466,7 @@ Burger::WeakPointerAnchor::~WeakPointerAnchor()
 
 	There will be only one shared ProxyReferenceCounter
 	object created for each instantiation of this sub
-	class.
+	class, even if several threads request it at once.
 
 	\return Pointer to a valid ProxyReferenceCounter object or \ref NULL on failure
 	\sa BURGER_ALLOW_WEAK_POINTERS()
@@ -276,8 +478,14 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 	ProxyReferenceCounter *pResult = m_pReferenceCounter;
 	if (pResult == NULL) {
 		pResult = ProxyReferenceCounter::New();
-		m_pReferenceCounter = pResult;
-		pResult->AddRef();
+		if (pResult) {
+			pResult->AddRef();
+			// If another thread created one first, use that one instead
+			if (!AtomicSetIfMatch(reinterpret_cast<volatile WordPtr *>(&m_pReferenceCounter),0,reinterpret_cast<WordPtr>(pResult))) {
+				pResult->Release();
+				pResult = m_pReferenceCounter;
+			}
+		}
 	}
 	return pResult;
 }
@@ -714,6 +922,26 @@ Burger::ProxyReferenceCounter* Burger::WeakPointerAnchor::GetProxyReferenceCount
 
 ***************************************/
 
+/*! ************************************
+
+	\fn SmartPointer<T> Burger::WeakPointer::Lock(void) const
+	\brief Safely award shared ownership of an object
+
+	Unlike the SmartPointer conversion operator, this function
+	is safe to use if the object could be released by another
+	thread at the same time. Ownership is only taken if the
+	object's reference count is not zero, using the object's
+	TryAddRef() function, and the object's destructor
+	is held off until the attempt is complete.
+
+	\note The WeakPointer itself must not be modified by
+	another thread while this is called.
+
+	\return A SmartPointer for the shared instance of a T class, \ref NULL if it was released
+	\sa AtomicReferenceCounter::TryAddRef() or ProxyReferenceCounter::BeginUpgrade()
+
+***************************************/
+
 /*! ************************************
 
 	\fn Word Burger::WeakPointer::operator==(const T* pData) const
@@ -34,19 +34,25 @@
 #include "brglobalmemorymanager.h"
 #endif
 
+#ifndef __BRATOMIC_H__
+#include "bratomic.h"
+#endif
+
 /* BEGIN */
 namespace Burger {
 class ProxyReferenceCounter {
 	BURGER_DISABLECOPYCONSTRUCTORS(ProxyReferenceCounter);
-	Word m_uRefCount;				///< Number of weak pointers that are using this object as an anchor
-	Word m_bParentAlive;			///< \ref TRUE if the parent object was deleted
-	ProxyReferenceCounter() : m_uRefCount(0),m_bParentAlive(TRUE) {}
+	volatile Word32 m_uRefCount;	///< Number of weak pointers that are using this object as an anchor
+	volatile Word32 m_uState;		///< Bit 0 is set if the parent was deleted, the rest is twice the number of upgrades in progress
+	ProxyReferenceCounter() : m_uRefCount(0),m_uState(0) {}
 public:
 	static ProxyReferenceCounter *New(void);
-	BURGER_INLINE Word IsParentAlive(void) const { return m_bParentAlive; }
-	BURGER_INLINE void ParentIsDead(void) { m_bParentAlive = FALSE; }
-	BURGER_INLINE void AddRef(void) { ++m_uRefCount; }
-	BURGER_INLINE void Release(void) { if (--m_uRefCount == 0) { Free(this); } }
+	BURGER_INLINE Word IsParentAlive(void) const { return !(m_uState&1U); }
+	void ParentIsDead(void);
+	Word BeginUpgrade(void);
+	BURGER_INLINE void EndUpgrade(void) { AtomicSubtract(&m_uState,2U); }
+	BURGER_INLINE void AddRef(void) { AtomicPreIncrement(&m_uRefCount); }
+	BURGER_INLINE void Release(void) { if (AtomicPreDecrement(&m_uRefCount) == 0) { Free(this); } }
 };
 
 class ReferenceCounter : public Base {
@@ -58,6 +64,21 @@ public:
 	virtual ~ReferenceCounter();
 	BURGER_INLINE void AddRef(void) { ++m_uRefCount; }
 	BURGER_INLINE void Release(void) { if (--m_uRefCount == 0) { Delete(this); } }
+	BURGER_INLINE Word TryAddRef(void) { if (!m_uRefCount) { return FALSE; } ++m_uRefCount; return TRUE; }
+	BURGER_INLINE Word GetRefCount(void) const { return m_uRefCount; }
+};
+
+class AtomicReferenceCounter : public Base {
+	BURGER_DISABLECOPYCONSTRUCTORS(AtomicReferenceCounter);
+	volatile Word32 m_uRefCount;		///< Number of smart pointers that are claiming ownership of this object
+	BURGER_RTTI_IN_CLASS();
+public:
+	AtomicReferenceCounter() : m_uRefCount(0) { }
+	virtual ~AtomicReferenceCounter();
+	BURGER_INLINE void AddRef(void) { AtomicFetchAdd(&m_uRefCount,1U,MEMORYORDER_RELAXED); }
+	BURGER_INLINE void Release(void) { if (AtomicFetchAdd(&m_uRefCount,0xFFFFFFFFU,MEMORYORDER_ACQREL) == 1U) { Delete(this); } }
+	Word TryAddRef(void);
+	BURGER_INLINE Word GetRefCount(void) const { return m_uRefCount; }
 };
 
 class WeakPointerAnchor {
@@ -174,6 +195,26 @@ public:
 	BURGER_INLINE T* operator->() const { return Dereference(); }
 	BURGER_INLINE T* GetPtr() const {	return Dereference(); }
 	BURGER_INLINE operator SmartPointer<T>() { return SmartPointer<T>(Dereference()); }
+	SmartPointer<T> Lock(void) const
+	{
+		SmartPointer<T> pResult;
+		T* pData = m_pData;
+		if (pData) {
+			// Block the parent's destructor while trying to take ownership
+			ProxyReferenceCounter *pProxy = m_pProxy.GetPtr();
+			Word bOwned = FALSE;
+			if (pProxy->BeginUpgrade()) {
+				bOwned = pData->TryAddRef();
+				pProxy->EndUpgrade();
+			}
+			if (bOwned) {
+				pResult = pData;
+				// Give up the reference from TryAddRef(), pResult has its own
+				pData->Release();
+			}
+		}
+		return pResult;
+	}
 	BURGER_INLINE Word operator==(const T* pData) const { return Dereference() == pData; }
 	BURGER_INLINE Word operator!=(const T* pData) const { return Dereference() != pData; }
 	BURGER_INLINE Word operator==(const T* pData) { return Dereference() == pData; }
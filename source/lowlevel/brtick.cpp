@@ -12,10 +12,26 @@
 ***************************************/
 
 #include "brtick.h"
+#include "bratomic.h"
 #if !defined(BURGER_WINDOWS) && !defined(BURGER_MAC) && !defined(BURGER_DS)
 #include <time.h>
 #endif
 
+//
+// Platforms with a 64 bit monotonic clock use it for
+// all of the timers instead of clock(), which
+// measures CPU time used by the application on
+// some operating systems
+//
+
+#if defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USEMACHTIME
+#include <mach/mach_time.h>
+#include <sched.h>
+#elif defined(BURGER_ANDROID) || defined(BURGER_LINUX)
+#define USEPOSIXTIME
+#endif
+
 Word32 Burger::Tick::s_LastTick;
 
 /*! ************************************
@@ -54,7 +70,9 @@ Word32 Burger::Tick::s_LastTick;
 
 Word32 BURGER_API Burger::Tick::Read(void)
 {
-#if CLOCKS_PER_SEC==TICKSPERSEC
+#if defined(USEMACHTIME) || defined(USEPOSIXTIME)
+	return static_cast<Word32>((ReadNanoseconds()*TICKSPERSEC)/NANOSECONDSPERSEC);
+#elif CLOCKS_PER_SEC==TICKSPERSEC
 	return clock();
 #else
 	return static_cast<Word32>((clock()*TICKSPERSEC)/CLOCKS_PER_SEC);
@@ -208,7 +226,9 @@ Word BURGER_API Burger::Tick::WaitEvent(Word uCount)
 
 Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
 {
-#if CLOCKS_PER_SEC==1000000
+#if defined(USEMACHTIME) || defined(USEPOSIXTIME)
+	return static_cast<Word32>(ReadNanoseconds()/1000U);
+#elif CLOCKS_PER_SEC==1000000
 	return static_cast<Word32>(clock());
 #else
 	return static_cast<Word32>((clock()*1000000)/CLOCKS_PER_SEC);
@@ -241,7 +261,9 @@ Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
 
 Word32 BURGER_API Burger::Tick::ReadMilliseconds(void)
 {
-#if CLOCKS_PER_SEC==1000
+#if defined(USEMACHTIME) || defined(USEPOSIXTIME)
+	return static_cast<Word32>(ReadNanoseconds()/1000000U);
+#elif CLOCKS_PER_SEC==1000
 	return static_cast<Word32>(clock());
 #else
 	return static_cast<Word32>((clock()*1000)/CLOCKS_PER_SEC);
@@ -250,6 +272,350 @@ Word32 BURGER_API Burger::Tick::ReadMilliseconds(void)
 
 #endif
 
+/*! ************************************
+
+	\brief Retrieve the 64 bit nanosecond timer
+
+	Return a monotonic time in nanoseconds. The value never goes
+	backwards and isn't affected by changes to the system clock,
+	so it's suitable for frame pacing and profiling. The starting
+	point of the timer is undefined, only use the difference of
+	two values.
+
+	At 64 bits, the timer will not wrap around for over 500 years.
+
+	\note The resolution depends on the hardware and it could be
+	much coarser than one nanosecond. On platforms without a high
+	resolution timer, it's derived from ReadMicroseconds() and is only
+	correct if this function is called at least once every 71 minutes.
+
+	\return 64 bit time value in nanoseconds
+	\sa ReadMicroseconds(), ReadCycles() or Stopwatch
+
+***************************************/
+
+#if !defined(BURGER_WINDOWS) && !defined(BURGER_XBOX360)
+
+#if !defined(USEMACHTIME) && !defined(USEPOSIXTIME)
+static Word32 s_uLastMicroseconds;		// Last value returned by ReadMicroseconds()
+static Word64 s_uMicrosecondsWrap;		// Upper 32 bits of the extended microsecond timer
+#endif
+
+Word64 BURGER_API Burger::Tick::ReadNanoseconds(void)
+{
+#if defined(USEMACHTIME)
+	// Convert mach time units to nanoseconds
+	static mach_timebase_info_data_t s_TimeBase;
+	if (!s_TimeBase.denom) {
+		mach_timebase_info(&s_TimeBase);
+	}
+	Word64 uTime = mach_absolute_time();
+	// Convert the quotient and remainder separately to avoid an overflow
+	if (s_TimeBase.numer==s_TimeBase.denom) {
+		return uTime;
+	}
+	Word64 uSeconds = uTime/s_TimeBase.denom;
+	Word64 uRemainder = uTime-(uSeconds*s_TimeBase.denom);
+	return (uSeconds*s_TimeBase.numer)+((uRemainder*s_TimeBase.numer)/s_TimeBase.denom);
+#elif defined(USEPOSIXTIME)
+	timespec Now;
+	clock_gettime(CLOCK_MONOTONIC,&Now);
+	return (static_cast<Word64>(Now.tv_sec)*NANOSECONDSPERSEC)+static_cast<Word64>(Now.tv_nsec);
+#else
+	// Extend the 32 bit microsecond timer to 64 bits
+	Word32 uMark = ReadMicroseconds();
+	if (uMark<s_uLastMicroseconds) {
+		s_uMicrosecondsWrap += 0x100000000ULL;
+	}
+	s_uLastMicroseconds = uMark;
+	return (s_uMicrosecondsWrap+uMark)*1000U;
+#endif
+}
+#endif
+
+/*! ************************************
+
+	\brief Read the CPU cycle counter
+
+	For timing very short sections of code, read the fastest
+	counter available. This is the time stamp counter on Intel
+	CPUs, the time base register on PowerPC and the virtual
+	counter on ARM64. Other CPUs return ReadNanoseconds().
+
+	The counter runs at the rate returned by GetCyclesPerSecond().
+
+	\note On Intel CPUs, threads that move between cores may see
+	slightly different values. Use ReadNanoseconds() when measuring
+	across threads.
+
+	\return 64 bit cycle count
+	\sa GetCyclesPerSecond() or ReadNanoseconds()
+
+***************************************/
+
+#if !defined(BURGER_XBOX360)
+Word64 BURGER_API Burger::Tick::ReadCycles(void)
+{
+#if (defined(BURGER_X86) || defined(BURGER_AMD64)) && defined(BURGER_MSVC)
+	return __rdtsc();
+#elif (defined(BURGER_X86) || defined(BURGER_AMD64)) && (defined(BURGER_GNUC) || defined(BURGER_LLVM))
+	Word32 uLow;
+	Word32 uHigh;
+	__asm__ __volatile__("rdtsc":"=a"(uLow),"=d"(uHigh));
+	return (static_cast<Word64>(uHigh)<<32U)+uLow;
+#elif defined(BURGER_POWERPC) && defined(BURGER_64BITCPU) && (defined(BURGER_PS3) || defined(BURGER_MACOSX))
+	Word64 uTime;
+	__asm__ __volatile__("mftb %0":"=r"(uTime));
+	return uTime;
+#elif defined(BURGER_POWERPC) && defined(BURGER_MACOSX)
+	// Read the upper half twice in case the lower half wrapped
+	Word32 uHigh;
+	Word32 uLow;
+	Word32 uTest;
+	do {
+		__asm__ __volatile__("mftbu %0":"=r"(uHigh));
+		__asm__ __volatile__("mftb %0":"=r"(uLow));
+		__asm__ __volatile__("mftbu %0":"=r"(uTest));
+	} while (uHigh!=uTest);
+	return (static_cast<Word64>(uHigh)<<32U)+uLow;
+#elif defined(BURGER_ARM64) && (defined(BURGER_GNUC) || defined(BURGER_LLVM))
+	Word64 uTime;
+	__asm__ __volatile__("mrs %0, cntvct_el0":"=r"(uTime));
+	return uTime;
+#else
+	return ReadNanoseconds();
+#endif
+}
+#endif
+
+/*! ************************************
+
+	\brief Get the rate of the CPU cycle counter
+
+	The first call measures ReadCycles() against ReadNanoseconds()
+	for about 20 milliseconds, so call this function during start up
+	to avoid the delay later. The result is cached.
+
+	\return Number of ReadCycles() units per second
+	\sa ReadCycles()
+
+***************************************/
+
+Word64 BURGER_API Burger::Tick::GetCyclesPerSecond(void)
+{
+	static volatile Word64 s_uCyclesPerSecond;
+	Word64 uResult = s_uCyclesPerSecond;
+	if (!uResult) {
+#if !(defined(BURGER_X86) || defined(BURGER_AMD64) || defined(BURGER_POWERPC) || defined(BURGER_ARM64))
+		uResult = NANOSECONDSPERSEC;
+#else
+		Word64 uStartTime = ReadNanoseconds();
+		Word64 uStartCycles = ReadCycles();
+		Word64 uElapsed;
+		do {
+			uElapsed = ReadNanoseconds()-uStartTime;
+		} while (uElapsed<20000000U);
+		Word64 uCycles = ReadCycles()-uStartCycles;
+		// Convert to cycles per second, scaling down to prevent overflow
+		uResult = ((uCycles*1000U)/(uElapsed/1000U))*1000U;
+		if (!uResult) {
+			uResult = 1;
+		}
+#endif
+		s_uCyclesPerSecond = uResult;
+	}
+	return uResult;
+}
+
+/*! ************************************
+
+	\brief Wait until a precise time
+
+	Sleep(Word32) only has millisecond granularity and the operating
+	system may wake the thread late, so this function sleeps until the
+	deadline is within uSpinNanoseconds and then yields the CPU until
+	the time arrives. This gives low jitter for frame deadlines
+	without burning a full core for the entire wait.
+
+	If uSpinNanoseconds is zero, the function only sleeps and may return late.
+	If the deadline has already passed, this function returns immediately.
+
+	\code
+	Word64 uDeadline = Burger::Tick::ReadNanoseconds();
+	for (;;) {
+		DrawFrame();
+		uDeadline += Burger::Tick::NANOSECONDSPERSEC/60U;
+		Burger::Tick::WaitUntil(uDeadline);
+	}
+	\endcode
+
+	\param uNanoseconds Value from ReadNanoseconds() to wait for
+	\param uSpinNanoseconds Time before the deadline to stop sleeping
+	\sa WaitNanoseconds(Word64,Word64) or ReadNanoseconds()
+
+***************************************/
+
+void BURGER_API Burger::Tick::WaitUntil(Word64 uNanoseconds,Word64 uSpinNanoseconds)
+{
+	for (;;) {
+		Word64 uNow = ReadNanoseconds();
+		if (uNow>=uNanoseconds) {
+			break;
+		}
+		Word64 uRemaining = uNanoseconds-uNow;
+		if (uRemaining>uSpinNanoseconds) {
+			// Sleep in whole milliseconds, leaving the spin time
+			Word64 uMilliseconds = (uRemaining-uSpinNanoseconds)/1000000U;
+			if (uMilliseconds) {
+				Sleep((uMilliseconds>=SLEEP_INFINITE) ? (SLEEP_INFINITE-1) : static_cast<Word32>(uMilliseconds));
+				continue;
+			}
+			if (!uSpinNanoseconds) {
+				// Less than a millisecond to go and no spinning allowed
+				Sleep(1);
+				break;
+			}
+		}
+		// Give up the time slice if another thread needs it, otherwise spin
+		if (uRemaining>=50000U) {
+			Sleep(SLEEP_YIELD);
+		} else {
+			AtomicPause();
+		}
+	}
+}
+
+/*! ************************************
+
+	\fn Burger::Tick::WaitNanoseconds(Word64 uNanoseconds,Word64 uSpinNanoseconds)
+	\brief Wait for a precise amount of time
+
+	Calls WaitUntil(Word64,Word64) with a deadline
+	uNanoseconds from now.
+
+	\param uNanoseconds Number of nanoseconds to wait
+	\param uSpinNanoseconds Time before the deadline to stop sleeping
+	\sa WaitUntil(Word64,Word64)
+
+***************************************/
+
+/*! ************************************
+
+	\class Burger::Stopwatch
+	\brief Measure elapsed time in nanoseconds
+
+	Time can be accumulated over several Start()/Stop()
+	pairs, and the elapsed time can be read while running.
+
+	\code
+	Burger::Stopwatch Timer;
+	Timer.Start();
+	DoWork();
+	Timer.Stop();
+	Message("Work took %g seconds",Timer.GetElapsedSeconds());
+	\endcode
+
+	\sa Tick::ReadNanoseconds()
+
+***************************************/
+
+/*! ************************************
+
+	\fn Burger::Stopwatch::Stopwatch()
+	\brief Create a stopped Stopwatch with no elapsed time
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Stopwatch::Start(void)
+	\brief Start accumulating time
+
+	Does nothing if already running.
+
+	\sa Stop(void) or Restart(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Stopwatch::Stop(void)
+	\brief Stop accumulating time
+
+	Add the time since Start() to the elapsed time.
+	Does nothing if not running.
+
+	\sa Start(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Stopwatch::Reset(void)
+	\brief Stop and set the elapsed time to zero
+
+	\sa Restart(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn void Burger::Stopwatch::Restart(void)
+	\brief Set the elapsed time to zero and start accumulating time
+
+	\sa Reset(void) or Start(void)
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word Burger::Stopwatch::IsRunning(void) const
+	\brief Return \ref TRUE if the Stopwatch is running
+
+	\return \ref TRUE if Start() was called without a Stop()
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::Stopwatch::GetElapsedNanoseconds(void) const
+	\brief Get the elapsed time in nanoseconds
+
+	\return Elapsed time, including the current run if it's running
+	\sa GetElapsedMicroseconds(void) const or GetElapsedSeconds(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::Stopwatch::GetElapsedMicroseconds(void) const
+	\brief Get the elapsed time in microseconds
+
+	\return Elapsed time, including the current run if it's running
+	\sa GetElapsedNanoseconds(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn Word64 Burger::Stopwatch::GetElapsedMilliseconds(void) const
+	\brief Get the elapsed time in milliseconds
+
+	\return Elapsed time, including the current run if it's running
+	\sa GetElapsedNanoseconds(void) const
+
+***************************************/
+
+/*! ************************************
+
+	\fn double Burger::Stopwatch::GetElapsedSeconds(void) const
+	\brief Get the elapsed time in seconds
+
+	\return Elapsed time, including the current run if it's running
+	\sa GetElapsedNanoseconds(void) const
+
+***************************************/
+
 /*! ************************************
 
 	\brief Sleep the current thread
@@ -269,7 +635,19 @@ Word32 BURGER_API Burger::Tick::ReadMilliseconds(void)
 
 ***************************************/
 
-#if !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID)) || defined(DOXYGEN)
+#if defined(USEMACHTIME) && !defined(DOXYGEN)
+void BURGER_API Burger::Sleep(Word32 uMilliseconds)
+{
+	if (uMilliseconds==SLEEP_YIELD) {
+		sched_yield();
+	} else {
+		timespec SleepTime;
+		SleepTime.tv_sec = uMilliseconds/1000U;
+		SleepTime.tv_nsec = (uMilliseconds-(SleepTime.tv_sec*1000U))*1000000U;
+		nanosleep(&SleepTime,NULL);
+	}
+}
+#elif !(defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_ANDROID)) || defined(DOXYGEN)
 void BURGER_API Burger::Sleep(Word32 /* uMilliseconds */)
 {
 }
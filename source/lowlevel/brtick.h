@@ -24,6 +24,8 @@ class Tick {
 	static Word32 s_LastTick;				///< Previously set tick value
 public:
 	static const Word TICKSPERSEC=60;		///< Number of ticks per second
+	static const Word64 NANOSECONDSPERSEC=1000000000ULL;	///< Number of nanoseconds per second
+	static const Word64 SPINNANOSECONDS=2000000ULL;		///< Default time before a deadline where WaitUntil() stops sleeping and starts spinning
 	static Word32 BURGER_API Read(void);
 	static BURGER_INLINE Word32 ResetLastTick(void) { Word32 uTick=Read(); s_LastTick=uTick; return uTick; }
 	static BURGER_INLINE Word32 GetLastTick(void) { return s_LastTick; }
@@ -32,6 +34,28 @@ public:
 	static Word BURGER_API WaitEvent(Word uCount=0);
 	static Word32 BURGER_API ReadMicroseconds(void);
 	static Word32 BURGER_API ReadMilliseconds(void);
+	static Word64 BURGER_API ReadNanoseconds(void);
+	static Word64 BURGER_API ReadCycles(void);
+	static Word64 BURGER_API GetCyclesPerSecond(void);
+	static void BURGER_API WaitUntil(Word64 uNanoseconds,Word64 uSpinNanoseconds=SPINNANOSECONDS);
+	static BURGER_INLINE void WaitNanoseconds(Word64 uNanoseconds,Word64 uSpinNanoseconds=SPINNANOSECONDS) { WaitUntil(ReadNanoseconds()+uNanoseconds,uSpinNanoseconds); }
+};
+
+class Stopwatch {
+	Word64 m_uStart;		///< Time mark when Start() was called
+	Word64 m_uElapsed;		///< Nanoseconds accumulated by previous Start()/Stop() pairs
+	Word m_bRunning;		///< \ref TRUE if Start() was called without Stop()
+public:
+	Stopwatch() : m_uStart(0),m_uElapsed(0),m_bRunning(FALSE) {}
+	BURGER_INLINE void Start(void) { if (!m_bRunning) { m_bRunning = TRUE; m_uStart = Tick::ReadNanoseconds(); } }
+	BURGER_INLINE void Stop(void) { if (m_bRunning) { m_uElapsed += Tick::ReadNanoseconds()-m_uStart; m_bRunning = FALSE; } }
+	BURGER_INLINE void Reset(void) { m_uElapsed = 0; m_bRunning = FALSE; }
+	BURGER_INLINE void Restart(void) { m_uElapsed = 0; m_bRunning = TRUE; m_uStart = Tick::ReadNanoseconds(); }
+	BURGER_INLINE Word IsRunning(void) const { return m_bRunning; }
+	BURGER_INLINE Word64 GetElapsedNanoseconds(void) const { return m_bRunning ? m_uElapsed+(Tick::ReadNanoseconds()-m_uStart) : m_uElapsed; }
+	BURGER_INLINE Word64 GetElapsedMicroseconds(void) const { return GetElapsedNanoseconds()/1000U; }
+	BURGER_INLINE Word64 GetElapsedMilliseconds(void) const { return GetElapsedNanoseconds()/1000000U; }
+	BURGER_INLINE double GetElapsedSeconds(void) const { return static_cast<double>(static_cast<Int64>(GetElapsedNanoseconds()))*(1.0/1000000000.0); }
 };
 enum {
 	SLEEP_YIELD=0,					///< Used by Sleep(Word32) to yield the current time quantum
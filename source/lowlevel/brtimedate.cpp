@@ -18,7 +18,7 @@
 #include <nitro/rtc/ARM9/api.h>
 #endif
 
-#if !defined(BURGER_MACOSX) && !defined(BURGER_IOS) && !defined(BURGER_PS4) && !defined(BURGER_ANDROID) && !defined(DOXYGEN)
+#if !defined(BURGER_MACOSX) && !defined(BURGER_IOS) && !defined(BURGER_PS4) && !defined(BURGER_ANDROID) && !defined(BURGER_LINUX) && !defined(DOXYGEN)
 struct timespec {
 	time_t tv_sec;	// seconds
 	Int32 tv_nsec;	// and nanoseconds
@@ -681,6 +681,45 @@
 
 
 
+/*! ************************************
+
+	\def BURGER_SSE2
+	\brief Define to determine if the target CPU supports SSE2 instructions.
+	
+	If this define exists, the SSE2 intrinsics found in emmintrin.h can
+	be used without a runtime check. All \ref BURGER_AMD64 targets have
+	this define, and \ref BURGER_X86 targets will have it if the
+	compiler was told to generate SSE2 code.
+	
+	\sa BURGER_AVX2, BURGER_NEON, BURGER_X86 or BURGER_AMD64
+	
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_AVX2
+	\brief Define to determine if the target CPU supports AVX2 instructions.
+	
+	If this define exists, the 256 bit integer intrinsics found in
+	immintrin.h can be used without a runtime check. It's only present
+	if the compiler was told to generate AVX2 code.
+	
+	\sa BURGER_SSE2 or BURGER_NEON
+	
+***************************************/
+
+/*! ************************************
+
+	\def BURGER_NEON
+	\brief Define to determine if the target CPU supports ARM NEON instructions.
+	
+	If this define exists, the intrinsics found in arm_neon.h can
+	be used without a runtime check.
+	
+	\sa BURGER_ARM, BURGER_SSE2 or BURGER_AVX2
+	
+***************************************/
+
 /*! ************************************
 
 	\def BURGER_LITTLEENDIAN
@@ -1058,6 +1097,18 @@
 	
 ***************************************/
 
+/*! ************************************
+
+	\def BURGER_LINUX
+	\brief Define to determine if code is being built for Linux.
+	
+	If this define exists, then you are creating code that runs on
+	Linux using the GNU C or Clang compilers.
+	
+	\sa BURGER_ANDROID, BURGER_MACOSX, BURGER_X86 or BURGER_AMD64
+	
+***************************************/
+
 /*! ************************************
 
 	\def BURGER_SHIELD
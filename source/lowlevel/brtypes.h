@@ -296,6 +296,36 @@ extern void* __alloca(unsigned x);
 #error Unknown CPU
 #endif
 
+// GNU C or Clang for Linux
+#elif defined(__GNUC__) && defined(__linux__)
+#define BURGER_GNUC
+#define BURGER_LINUX
+#define BURGER_ALIGN(x,s) (x) __attribute__((aligned(s)))
+#define BURGER_PREALIGN(s)
+#define BURGER_POSTALIGN(s) __attribute__((aligned(s)))
+#define BURGER_STRUCT_ALIGN
+#define BURGER_INLINE __inline__ __attribute__((always_inline))
+#define BURGER_LONGLONG long long
+#if defined(__i386__)
+#define BURGER_X86
+#define BURGER_LITTLEENDIAN
+#define BURGER_API __attribute__((regparm(3)))
+#define BURGER_ANSIAPI __attribute((cdecl))
+#elif defined(__x86_64__)
+#define BURGER_AMD64
+#define BURGER_LITTLEENDIAN
+#define BURGER_64BITCPU
+#elif defined(__aarch64__)
+#define BURGER_ARM64
+#define BURGER_LITTLEENDIAN
+#define BURGER_64BITCPU
+#elif defined(__arm__)
+#define BURGER_ARM
+#define BURGER_LITTLEENDIAN
+#else
+#error Unknown CPU
+#endif
+
 // Visual Studio 2003/2005/2008 for Win32
 #elif defined(_MSC_VER) && defined(_M_IX86)
 #define BURGER_MSVC
@@ -351,6 +381,18 @@ extern void* __alloca(unsigned x);
 #define BURGER_MACOS
 #endif
 
+#if defined(BURGER_AMD64) || (defined(BURGER_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP>=2))))
+#define BURGER_SSE2
+#endif
+
+#if defined(BURGER_SSE2) && defined(__AVX2__)
+#define BURGER_AVX2
+#endif
+
+#if !defined(BURGER_NEON) && (defined(BURGER_ARM) || defined(BURGER_ARM64)) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define BURGER_NEON
+#endif
+
 #if !defined(BURGER_API)
 #define BURGER_API
 #endif
@@ -525,6 +567,8 @@ BURGER_INLINE void* operator new(unsigned long int,void *x) {return x;}
 BURGER_INLINE void* operator new(unsigned long, void*x) {return x;}
 #elif defined(BURGER_ANDROID)
 BURGER_INLINE void* operator new(unsigned int, void*x) {return x;}
+#elif defined(BURGER_LINUX)
+BURGER_INLINE void* operator new(__SIZE_TYPE__, void*x) {return x;}
 #else
 BURGER_INLINE void* operator new(WordPtr, void*x) {return x;}
 #endif
@@ -42,14 +42,28 @@ long __cdecl _InterlockedDecrement(long volatile*);
 long _InterlockedExchangeAdd(long volatile*,long);
 long _InterlockedCompareExchange(long volatile*,long,long);
 #pragma intrinsic(_InterlockedExchange,_InterlockedIncrement,_InterlockedDecrement,_InterlockedExchangeAdd,_InterlockedCompareExchange)
+void _ReadWriteBarrier(void);
+#pragma intrinsic(_ReadWriteBarrier)
+__int64 _InterlockedCompareExchange64(__int64 volatile*,__int64,__int64);
+#pragma intrinsic(_InterlockedCompareExchange64)
+
+#if defined(BURGER_X86) || defined(BURGER_AMD64)
+void _mm_pause(void);
+unsigned __int64 __rdtsc(void);
+#pragma intrinsic(_mm_pause,__rdtsc)
+#endif
 
 #if defined(BURGER_64BITCPU)
 __int64 _InterlockedExchange64(__int64 volatile*,__int64);
 __int64 _InterlockedIncrement64(__int64 volatile*);
 __int64 _InterlockedDecrement64(__int64 volatile*);
 __int64 _InterlockedExchangeAdd64(__int64 volatile*,__int64);
-__int64 _InterlockedCompareExchange64(__int64 volatile*,__int64,__int64);
-#pragma intrinsic(_InterlockedExchange64,_InterlockedIncrement64,_InterlockedDecrement64,_InterlockedExchangeAdd64,_InterlockedCompareExchange64)
+#pragma intrinsic(_InterlockedExchange64,_InterlockedIncrement64,_InterlockedDecrement64,_InterlockedExchangeAdd64)
+#endif
+
+#if defined(BURGER_AMD64)
+unsigned char _InterlockedCompareExchange128(__int64 volatile*,__int64,__int64,__int64*);
+#pragma intrinsic(_InterlockedCompareExchange128)
 #endif
 }
 #endif
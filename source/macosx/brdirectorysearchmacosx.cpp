@@ -136,6 +136,9 @@ Word Burger::DirectorySearch::GetNextEntry(void)
 
 			// Is the file locked?
 			m_bLocked = (Entry.m_Flags&UF_IMMUTABLE)!=0;
+
+			// Links are not followed, so they are never directories
+			m_bLink = (Entry.objType==VLNK);
 	
 			// Get the mac specific file type and creator type
 			m_uFileType = reinterpret_cast<Word32 *>(Entry.finderInfo)[0];
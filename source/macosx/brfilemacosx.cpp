@@ -181,6 +181,66 @@ WordPtr Burger::File::Write(const void *pInput,WordPtr uSize)
 	return uResult;
 }
 
+/***************************************
+
+	\brief Read data from an open file at a specific offset
+
+	The data is read with pread(), so the shared file mark
+	is neither used nor changed.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::ReadAt(Word64 uOffset,void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pOutput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			ssize_t iRead = pread(fp,pOutput,uSize,static_cast<off_t>(uOffset));		// Read data
+			if (iRead>0) {
+				uResult = static_cast<WordPtr>(iRead);
+			}
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write data into an open file at a specific offset
+
+	The data is written with pwrite(), so the shared file mark
+	is neither used nor changed.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa ReadAt(Word64,void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::WriteAt(Word64 uOffset,const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput) {
+		int fp = static_cast<int>(reinterpret_cast<WordPtr>(m_pFile));
+		if (fp) {
+			ssize_t iWrite = pwrite(fp,pInput,uSize,static_cast<off_t>(uOffset));		// Write data
+			if (iWrite>0) {
+				uResult = static_cast<WordPtr>(iWrite);
+			}
+		}
+	}
+	return uResult;
+}
+
 
 /***************************************
 
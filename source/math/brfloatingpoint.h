@@ -119,6 +119,10 @@ extern "C" double sqrt(double);
 extern "C" float fabsf(float);
 extern "C" double fabs(double);
 #endif
+#elif defined(BURGER_LINUX)
+#ifndef _MATH_H
+#include <math.h>
+#endif
 #endif
 namespace Burger {
 	extern const Word64ToDouble g_dOne;			///< Constant for 1.0 in the double format.
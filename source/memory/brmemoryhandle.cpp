@@ -15,6 +15,7 @@
 #include "brdebug.h"
 #include "brstringfunctions.h"
 #include "brglobalmemorymanager.h"
+#include "brprofiler.h"
 
 /*! ************************************
 
@@ -1599,6 +1600,7 @@ Word BURGER_API Burger::MemoryManagerHandle::PurgeHandles(WordPtr uSize)
 
 void BURGER_API Burger::MemoryManagerHandle::CompactHandles(void)
 {
+	BURGER_PROFILE_ZONE("MemoryManagerHandle::CompactHandles");
 	m_Lock.Lock();
 	// Index to the active handle list
 	Handle_t *pHandle = m_LowestUsedMemory.m_pNextHandle;
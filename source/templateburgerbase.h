@@ -97,6 +97,7 @@
 #include "brutf16.h"
 #include "brutf32.h"
 #include "brqueue.h"
+#include "brringqueue.h"
 #include "brsmartpointer.h"
 #include "brsimplearray.h"
 #include "brarray.h"
@@ -132,15 +133,20 @@
 #include "brnumberstring.h"
 #include "brnumberstringhex.h"
 #include "brsimplestring.h"
+#include "brglobpattern.h"
 #include "brinputmemorystream.h"
 #include "broutputmemorystream.h"
 #include "brtimedate.h"
 #include "brtick.h"
+#include "brprofiler.h"
 #include "brfilename.h"
 #include "brfileansihelpers.h"
 #include "brfilemanager.h"
 #include "brfile.h"
+#include "brfileioqueue.h"
 #include "brdirectorysearch.h"
+#include "brdirectorywalker.h"
+#include "brpathcache.h"
 #include "brdosextender.h"
 #include "brautorepeat.h"
 #include "brrandommanager.h"
@@ -155,10 +161,12 @@
 #include "brcompress.h"
 #include "brcompresslbmrle.h"
 #include "brcompresslzss.h"
+#include "brcompresslz4.h"
 #include "brcompressdeflate.h"
 #include "brdecompress.h"
 #include "brdecompresslbmrle.h"
 #include "brdecompresslzss.h"
+#include "brdecompresslz4.h"
 #include "brdecompressdeflate.h"
 #include "brrezfile.h"
 #include "brgameapp.h"
@@ -172,7 +180,9 @@
 #include "brdisplaydirectx9software8.h"
 #include "brdisplaydib.h"
 #include "brdisplaydibsoftware8.h"
+#include "brimage.h"
 #include "brpalette.h"
+#include "brrenderersoftware32.h"
 #include "brwindowsapp.h"
 #include "brmacosxapp.h"
 #include "briosapp.h"
@@ -180,7 +190,10 @@
 #include "brdxt3.h"
 #include "brdxt5.h"
 #include "brmace.h"
-#include "brimage.h"
+#include "brulaw.h"
+#include "bralaw.h"
+#include "brmicrosoftadpcm.h"
+#include "brdviadpcm.h"
 #include "brfilebmp.h"
 #include "brfiledds.h"
 #include "brfilegif.h"
@@ -201,6 +214,7 @@
 #include "brkeyboard.h"
 #include "brjoypad.h"
 #include "brsound.h"
+#include "brsoundmixer.h"
 #include "brflashutils.h"
 #include "brflashaction.h"
 #include "brflashmanager.h"
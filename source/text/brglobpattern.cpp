@@ -0,0 +1,338 @@
+/***************************************
+
+	Compiled wildcard pattern matcher
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "brglobpattern.h"
+#include "brisolatin1.h"
+#include "brstringfunctions.h"
+
+/*! ************************************
+
+	\class Burger::GlobPattern
+	\brief Wildcard pattern compiled for fast matching
+
+	Burger::Wildcardcmp() walks the pattern each time it's called
+	and backtracks with recursion on every '*', so a pattern with
+	several stars can take time proportional to the product of the
+	string and pattern lengths. This class converts the pattern once
+	into a table driven state machine that tracks every possible
+	position in the pattern at the same time as bits in a 64 bit
+	integer. Matching a string is a table lookup, two shifts and
+	a few masks per character, with no backtracking, so it's safe
+	to use on thousands of filenames.
+
+	The following wildcards are supported.
+
+	* '*' matches zero or more characters
+	* '?' matches any single character
+	* "[abc]" matches any one of the characters in the brackets,
+	"[a-z]" matches a range and "[!abc]" or "[^abc]" matches
+	any character not in the brackets
+	* ';' separates alternate patterns, "*.png;*.tga" matches
+	a string that ends with either extension
+	* '\\' treats the next character as a literal
+
+	Letters are compared without case sensitivity using the ISOLatin1
+	tables, the same as Burger::Wildcardcmp(), unless
+	\ref FLAG_CASESENSITIVE is passed. Characters are bytes, so
+	a '?' matches a single byte of a UTF8 string.
+
+	\code
+	Burger::GlobPattern Pattern("*.png;*.tga");
+	if (Pattern.Match(pFilename)) {
+		LoadImage(pFilename);
+	}
+	\endcode
+
+	\sa Burger::Wildcardcmp(const char *,const char *)
+
+***************************************/
+
+/*! ************************************
+
+	\brief Create an empty pattern
+
+	The pattern doesn't match anything until
+	Compile() is called.
+
+	\sa Compile(const char *,Word)
+
+***************************************/
+
+Burger::GlobPattern::GlobPattern()
+{
+	Clear();
+}
+
+/*! ************************************
+
+	\brief Create a pattern and compile it
+
+	\param pPattern Pointer to a "C" string of the wildcard pattern
+	\param uFlags \ref FLAG_CASESENSITIVE or zero
+	\sa Compile(const char *,Word)
+
+***************************************/
+
+Burger::GlobPattern::GlobPattern(const char *pPattern,Word uFlags)
+{
+	Compile(pPattern,uFlags);
+}
+
+/*! ************************************
+
+	\brief Parse a bracket expression
+
+	Given a pointer to the character following a '[', mark
+	every character in the set. A ']' that immediately follows
+	the '[' or the '!' is a member of the set.
+
+	\param pOutput Pointer to a 256 byte array to receive the set
+	\param pInput Pointer to the character after the '['
+	\param pbNegate Pointer to receive \ref TRUE if the set was negated
+	\return Pointer to the character after the closing ']' or \ref NULL if there was no closing ']'
+
+***************************************/
+
+static const Word8 *ParseCharacterClass(Word8 *pOutput,const Word8 *pInput,Word *pbNegate)
+{
+	Word bNegate = FALSE;
+	Word uTemp = pInput[0];
+	if ((uTemp=='!') || (uTemp=='^')) {
+		bNegate = TRUE;
+		++pInput;
+	}
+	pbNegate[0] = bNegate;
+	const Word8 *pStart = pInput;
+	for (;;) {
+		uTemp = pInput[0];
+		if (!uTemp) {
+			// No closing bracket
+			return NULL;
+		}
+		++pInput;
+		if ((uTemp==']') && ((pInput-1)!=pStart)) {
+			break;
+		}
+		// Escaped character?
+		if ((uTemp=='\\') && pInput[0]) {
+			uTemp = pInput[0];
+			++pInput;
+		}
+		// Range?
+		Word uLast = uTemp;
+		if ((pInput[0]=='-') && pInput[1] && (pInput[1]!=']')) {
+			uLast = pInput[1];
+			pInput+=2;
+			if ((uLast=='\\') && pInput[0]) {
+				uLast = pInput[0];
+				++pInput;
+			}
+		}
+		while (uTemp<=uLast) {
+			pOutput[uTemp] = 1;
+			++uTemp;
+		}
+	}
+	return pInput;
+}
+
+/*! ************************************
+
+	\brief Compile a wildcard pattern
+
+	Convert the pattern into the state tables used by
+	Match(). Consecutive '*' characters are merged. Each
+	character, '?', bracket expression or run of '*' in the
+	pattern uses one state and each alternate pattern uses
+	one more, for a total of \ref MAXSTATES. If the pattern is
+	too long, it's rejected and Match() will always fail.
+
+	\param pPattern Pointer to a "C" string of the wildcard pattern
+	\param uFlags \ref FLAG_CASESENSITIVE or zero
+	\return Zero if no error, non-zero if the pattern is too long
+	\sa Match(const char *) const
+
+***************************************/
+
+Word BURGER_API Burger::GlobPattern::Compile(const char *pPattern,Word uFlags)
+{
+	Clear();
+	const Word8 *pWork = reinterpret_cast<const Word8 *>(pPattern);
+	Word bCaseSensitive = (uFlags&FLAG_CASESENSITIVE)!=0;
+	Word uState = 0;
+	Word64 uStartStates = 0;
+	Word64 uStarStates = 0;
+	Word64 uAcceptStates = 0;
+	Word8 Members[256];
+	Word8 Folded[256];
+
+	for (;;) {
+		// Start of an alternate pattern
+		uStartStates |= static_cast<Word64>(1U)<<uState;
+		Word bPreviousStar = FALSE;
+		Word uTemp;
+		while (((uTemp = pWork[0])!=0) && (uTemp!=';')) {
+			++pWork;
+			// Merge runs of stars
+			if (uTemp=='*') {
+				if (bPreviousStar) {
+					continue;
+				}
+				bPreviousStar = TRUE;
+			} else {
+				bPreviousStar = FALSE;
+			}
+			// Leave room for the accept state
+			if (uState>=(MAXSTATES-1)) {
+				Clear();
+				return 10;
+			}
+			Word64 uBit = static_cast<Word64>(1U)<<uState;
+			++uState;
+			if ((uTemp=='*') || (uTemp=='?')) {
+				// Any character but the terminating zero
+				if (uTemp=='*') {
+					uStarStates |= uBit;
+				}
+				Word i = 1;
+				do {
+					m_CharacterMasks[i] |= uBit;
+				} while (++i<256);
+				continue;
+			}
+
+			// Build the set of characters this state accepts
+			MemoryClear(Members,sizeof(Members));
+			Word bNegate = FALSE;
+			const Word8 *pNext = NULL;
+			if (uTemp=='[') {
+				pNext = ParseCharacterClass(Members,pWork,&bNegate);
+			}
+			if (pNext) {
+				pWork = pNext;
+			} else {
+				// Escaped character? Note: An unmatched '[' is a literal
+				if ((uTemp=='\\') && pWork[0]) {
+					uTemp = pWork[0];
+					++pWork;
+				}
+				Members[uTemp] = 1;
+			}
+			// Add the other cases of letters
+			if (!bCaseSensitive) {
+				MemoryClear(Folded,sizeof(Folded));
+				Word i = 0;
+				do {
+					if (Members[i]) {
+						Folded[ISOLatin1::UpperCaseTable[i]] = 1;
+					}
+				} while (++i<256);
+				i = 0;
+				do {
+					if (Folded[ISOLatin1::UpperCaseTable[i]]) {
+						Members[i] = 1;
+					}
+				} while (++i<256);
+			}
+			// The terminating zero never matches
+			Word i = 1;
+			do {
+				if (Members[i]!=bNegate) {
+					m_CharacterMasks[i] |= uBit;
+				}
+			} while (++i<256);
+		}
+
+		// The state after the last token is a match
+		uAcceptStates |= static_cast<Word64>(1U)<<uState;
+		++uState;
+		if (!uTemp) {
+			break;
+		}
+		// Skip the ';'
+		++pWork;
+		if (uState>=MAXSTATES) {
+			Clear();
+			return 10;
+		}
+	}
+	m_uStartStates = uStartStates;
+	m_uStarStates = uStarStates;
+	m_uAcceptStates = uAcceptStates;
+	m_bValid = TRUE;
+	return 0;
+}
+
+/*! ************************************
+
+	\brief Release the compiled pattern
+
+	After this call, Match() will always return \ref FALSE.
+
+***************************************/
+
+void BURGER_API Burger::GlobPattern::Clear(void)
+{
+	MemoryClear(m_CharacterMasks,sizeof(m_CharacterMasks));
+	m_uStartStates = 0;
+	m_uStarStates = 0;
+	m_uAcceptStates = 0;
+	m_bValid = FALSE;
+}
+
+/*! ************************************
+
+	\brief Test a string against the compiled pattern
+
+	Every possible position in the pattern is tracked as a bit,
+	so the string is scanned only once. The test stops early
+	if no position can match.
+
+	\note Unlike Burger::Wildcardcmp(), this returns \ref TRUE for a match.
+
+	\param pInput Pointer to a "C" string to test
+	\return \ref TRUE if the string matches the pattern, \ref FALSE if not
+	\sa Compile(const char *,Word)
+
+***************************************/
+
+Word BURGER_API Burger::GlobPattern::Match(const char *pInput) const
+{
+	Word64 uStarStates = m_uStarStates;
+	// A leading star can match nothing
+	Word64 uStates = m_uStartStates;
+	uStates |= (uStates&uStarStates)<<1U;
+	const Word8 *pWork = reinterpret_cast<const Word8 *>(pInput);
+	Word uTemp;
+	while ((uTemp = pWork[0])!=0) {
+		++pWork;
+		Word64 uActive = uStates&m_CharacterMasks[uTemp];
+		// Stars stay put, everything else advances
+		uStates = ((uActive&(~uStarStates))<<1U)|(uActive&uStarStates);
+		// A star can be skipped by matching nothing
+		uStates |= (uStates&uStarStates)<<1U;
+		if (!uStates) {
+			return FALSE;
+		}
+	}
+	return (uStates&m_uAcceptStates)!=0;
+}
+
+/*! ************************************
+
+	\fn Word Burger::GlobPattern::IsValid(void) const
+	\brief Return \ref TRUE if a pattern has been compiled
+
+	\return \ref TRUE if Compile() succeeded, \ref FALSE if not
+
+***************************************/
@@ -0,0 +1,46 @@
+/***************************************
+
+	Compiled wildcard pattern matcher
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#ifndef __BRGLOBPATTERN_H__
+#define __BRGLOBPATTERN_H__
+
+#ifndef __BRTYPES_H__
+#include "brtypes.h"
+#endif
+
+/* BEGIN */
+namespace Burger {
+class GlobPattern {
+public:
+	enum {
+		MAXSTATES=64,				///< Maximum number of states a pattern can compile to
+		FLAG_CASESENSITIVE=0x01		///< Compare letters with case sensitivity
+	};
+private:
+	Word64 m_CharacterMasks[256];	///< States that accept each input character
+	Word64 m_uStartStates;			///< States active before any input
+	Word64 m_uStarStates;			///< States that are a '*' and loop on themselves
+	Word64 m_uAcceptStates;			///< States that indicate a match
+	Word m_bValid;					///< \ref TRUE if a pattern was compiled
+public:
+	GlobPattern();
+	GlobPattern(const char *pPattern,Word uFlags=0);
+	Word BURGER_API Compile(const char *pPattern,Word uFlags=0);
+	void BURGER_API Clear(void);
+	Word BURGER_API Match(const char *pInput) const;
+	BURGER_INLINE Word IsValid(void) const { return m_bValid; }
+};
+}
+/* END */
+
+#endif
@@ -332,5 +332,22 @@ void BURGER_API Burger::Thread::Run(void *pThis)
 	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
 }
 
+/***************************************
+
+	Return the number of CPU cores available
+	
+***************************************/
+
+Word BURGER_API Burger::Thread::GetProcessorCount(void)
+{
+	SYSTEM_INFO Info;
+	GetSystemInfo(&Info);
+	Word uResult = Info.dwNumberOfProcessors;
+	if (!uResult) {
+		uResult = 1;
+	}
+	return uResult;
+}
+
 #endif
 
@@ -124,6 +124,8 @@ Word Burger::DirectorySearch::GetNextEntry(void)
 	if (uFlags & FILE_ATTRIBUTE_READONLY) {
 		m_bLocked = TRUE;
 	}
+	// Symbolic links and junctions
+	m_bLink = (uFlags & FILE_ATTRIBUTE_REPARSE_POINT)!=0;
 	m_CreationDate.Load(&((WIN32_FIND_DATAW *)m_MyFindW)->ftCreationTime);
 	m_ModificatonDate.Load(&((WIN32_FIND_DATAW *)m_MyFindW)->ftLastWriteTime);
 #if !defined(BURGER_64BITCPU)
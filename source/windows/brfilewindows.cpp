@@ -14,6 +14,7 @@
 #include "brfile.h"
 #if defined(BURGER_WINDOWS)
 #include "brstring16.h"
+#include "brstringfunctions.h"
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
 #endif
@@ -222,6 +223,108 @@ WordPtr Burger::File::Write(const void *pInput,WordPtr uSize)
 	return uResult;
 }
 
+/***************************************
+
+	\brief Read data from an open file at a specific offset
+
+	The offset is passed to ReadFile() in an OVERLAPPED structure,
+	so threads don't need to share the file mark to perform the read.
+
+	\note Since the file is opened for synchronous access, Windows
+	leaves the file mark after the last byte read.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pOutput Pointer to a buffer of data to read from a file
+	\param uSize Number of bytes to read
+	\return Number of bytes read (Can be less than what was requested due to EOF or read errors)
+	\sa WriteAt(Word64,const void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::ReadAt(Word64 uOffset,void *pOutput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pOutput) {
+		HANDLE fp = m_pFile;
+		if (fp) {
+			do {
+				// Size of the chunk must fit in a 32 bit value
+				DWORD uChunk = (uSize<0xFFFF0000UL) ? static_cast<DWORD>(uSize) : 0xFFFF0000UL;
+				OVERLAPPED Overlapped;
+				MemoryClear(&Overlapped,sizeof(Overlapped));
+				Overlapped.Offset = static_cast<DWORD>(uOffset);
+				Overlapped.OffsetHigh = static_cast<DWORD>(uOffset>>32U);
+				DWORD uRead;
+				BOOL bReadResult = ReadFile(fp,pOutput,uChunk,&uRead,&Overlapped);
+				if (!bReadResult) {
+					// Error or end of file
+					break;
+				}
+				pOutput = static_cast<Word8 *>(pOutput)+uRead;
+				uOffset += uRead;
+				uResult += uRead;
+				uSize -= uRead;
+				// Was the read smaller than the read request?
+				if (uRead!=uChunk) {
+					break;
+				}
+			} while (uSize);
+		}
+	}
+	return uResult;
+}
+
+/***************************************
+
+	\brief Write data into an open file at a specific offset
+
+	The offset is passed to WriteFile() in an OVERLAPPED structure,
+	so threads don't need to share the file mark to perform the write.
+
+	\note Since the file is opened for synchronous access, Windows
+	leaves the file mark after the last byte written.
+
+	\param uOffset Offset in bytes from the start of the file
+	\param pInput Pointer to a buffer of data to write to a file
+	\param uSize Number of bytes to write
+	\return Number of bytes written (Can be less than what was requested due to EOF or write errors)
+	\sa ReadAt(Word64,void *,WordPtr)
+
+***************************************/
+
+WordPtr Burger::File::WriteAt(Word64 uOffset,const void *pInput,WordPtr uSize)
+{
+	WordPtr uResult = 0;
+	if (uSize && pInput) {
+		HANDLE fp = m_pFile;
+		if (fp) {
+			do {
+				// Size of the chunk must fit in a 32 bit value
+				DWORD uChunk = (uSize<0xFFFF0000UL) ? static_cast<DWORD>(uSize) : 0xFFFF0000UL;
+				OVERLAPPED Overlapped;
+				MemoryClear(&Overlapped,sizeof(Overlapped));
+				Overlapped.Offset = static_cast<DWORD>(uOffset);
+				Overlapped.OffsetHigh = static_cast<DWORD>(uOffset>>32U);
+				DWORD uWrite;
+				BOOL bWriteResult = WriteFile(fp,pInput,uChunk,&uWrite,&Overlapped);
+				if (!bWriteResult) {
+					// Error! Abort!
+					break;
+				}
+				pInput = static_cast<const Word8 *>(pInput)+uWrite;
+				uOffset += uWrite;
+				uResult += uWrite;
+				uSize -= uWrite;
+				// Was the write smaller than the write request?
+				if (uWrite!=uChunk) {
+					break;
+				}
+			} while (uSize);
+		}
+	}
+	return uResult;
+}
+
 
 /***************************************
 
@@ -104,6 +104,32 @@ Word32 BURGER_API Burger::Tick::ReadMicroseconds(void)
 	return 0;		/* Just zap it! (Error) */
 }
 
+/***************************************
+
+	Read the time in nanosecond increments
+
+***************************************/
+
+static Word64 g_uFrequency;		/* Performance counter ticks per second */
+
+Word64 BURGER_API Burger::Tick::ReadNanoseconds(void)
+{
+	LARGE_INTEGER Temp;
+	if (!g_uFrequency) {
+		if (!QueryPerformanceFrequency(&Temp) || !Temp.QuadPart) {
+			// No high resolution timer, use the millisecond timer
+			return static_cast<Word64>(Globals::timeGetTime())*1000000U;
+		}
+		g_uFrequency = static_cast<Word64>(Temp.QuadPart);
+	}
+	QueryPerformanceCounter(&Temp);
+	// Convert seconds and the fraction separately to prevent an overflow
+	Word64 uCount = static_cast<Word64>(Temp.QuadPart);
+	Word64 uSeconds = uCount/g_uFrequency;
+	Word64 uFraction = uCount-(uSeconds*g_uFrequency);
+	return (uSeconds*NANOSECONDSPERSEC)+((uFraction*NANOSECONDSPERSEC)/g_uFrequency);
+}
+
 /***************************************
 
 	Read the time in millisecond increments
@@ -322,4 +322,16 @@ void BURGER_API Burger::Thread::Run(void *pThis)
 	pThread->m_uResult = pThread->m_pFunction(pThread->m_pData);
 }
 
+/***************************************
+
+	Return the number of CPU cores available
+	
+***************************************/
+
+Word BURGER_API Burger::Thread::GetProcessorCount(void)
+{
+	// 3 cores with 2 hardware threads each
+	return 6;
+}
+
 #endif
\ No newline at end of file
@@ -18,6 +18,40 @@
 #define NONET
 #include <xtl.h>
 
+/***************************************
+
+	Read the time in nanosecond increments
+
+***************************************/
+
+static Word64 g_uFrequency;		// Performance counter ticks per second
+
+Word64 BURGER_API Burger::Tick::ReadNanoseconds(void)
+{
+	LARGE_INTEGER Temp;
+	if (!g_uFrequency) {
+		QueryPerformanceFrequency(&Temp);
+		g_uFrequency = static_cast<Word64>(Temp.QuadPart);
+	}
+	QueryPerformanceCounter(&Temp);
+	// Convert seconds and the fraction separately to prevent an overflow
+	Word64 uCount = static_cast<Word64>(Temp.QuadPart);
+	Word64 uSeconds = uCount/g_uFrequency;
+	Word64 uFraction = uCount-(uSeconds*g_uFrequency);
+	return (uSeconds*NANOSECONDSPERSEC)+((uFraction*NANOSECONDSPERSEC)/g_uFrequency);
+}
+
+/***************************************
+
+	Read the time base register
+
+***************************************/
+
+Word64 BURGER_API Burger::Tick::ReadCycles(void)
+{
+	return __mftb();
+}
+
 /***************************************
 
 	Sleep the current thread
@@ -19,10 +19,23 @@
 #include "testbrhashes.h"
 #include "testbrstrings.h"
 #include "testbrcompression.h"
+#include "testbrfilemanager.h"
+#include "testbrfileioqueue.h"
+#include "testbrrezfile.h"
+#include "testbrstreams.h"
 #include "testbrtimedate.h"
 #include "testbrmatrix3d.h"
 #include "testbrmatrix4d.h"
 #include "testbrstaticrtti.h"
+#include "testbrimage.h"
+#include "testbrfont.h"
+#include "testbrpalette.h"
+#include "testbrrenderer.h"
+#include "testbrsound.h"
+#include "testbratomic.h"
+#include "testbrringqueue.h"
+#include "testbrsmartpointer.h"
+#include "testbrprofiler.h"
 #include "createtables.h"
 #include <stdarg.h>
 #include <stdlib.h>
@@ -224,5 +237,18 @@ int BURGER_ANSIAPI main(void)
 	iResult |= TestBrhashes();
 	iResult |= TestBrcompression();
 	iResult |= TestDateTime();
+	iResult |= TestBrfilemanager();
+	iResult |= TestBrfileioqueue();
+	iResult |= TestBrrezfile();
+	iResult |= TestBrstreams();
+	iResult |= TestBrimage();
+	iResult |= TestBrpalette();
+	iResult |= TestBrfont();
+	iResult |= TestBrrenderer();
+	iResult |= TestBrsound();
+	iResult |= TestBratomic();
+	iResult |= TestBrringqueue();
+	iResult |= TestBrsmartpointer();
+	iResult |= TestBrprofiler();
 	return iResult;
 }
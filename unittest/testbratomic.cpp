@@ -0,0 +1,486 @@
+/***************************************
+
+	Unit tests for the atomic memory functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbratomic.h"
+#include "common.h"
+#include "bratomic.h"
+#include "brcriticalsection.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded tests
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS) || defined(BURGER_LINUX)
+#define USETHREADS
+#endif
+
+/***************************************
+
+	Test the memory ordered functions from a single thread
+
+***************************************/
+
+static Word TestOrdered(void)
+{
+	Word uResult = FALSE;
+
+	volatile Word32 uValue32 = 0;
+	AtomicStore(&uValue32,0x12345678U,MEMORYORDER_RELEASE);
+	Word uFailure = AtomicLoad(&uValue32,MEMORYORDER_ACQUIRE)!=0x12345678U;
+	uResult |= uFailure;
+	ReportFailure("AtomicLoad(Word32) = %08X, expected 12345678",uFailure,uValue32);
+
+	Word32 uOld32 = AtomicExchange(&uValue32,0xF0F0F0F0U,MEMORYORDER_SEQCST);
+	uFailure = (uOld32!=0x12345678U) || (uValue32!=0xF0F0F0F0U);
+	uResult |= uFailure;
+	ReportFailure("AtomicExchange(Word32) returned %08X",uFailure,uOld32);
+
+	uOld32 = AtomicFetchAdd(&uValue32,0x10U,MEMORYORDER_RELAXED);
+	uFailure = (uOld32!=0xF0F0F0F0U) || (uValue32!=0xF0F0F100U);
+	uResult |= uFailure;
+	ReportFailure("AtomicFetchAdd(Word32) returned %08X",uFailure,uOld32);
+
+	uOld32 = AtomicFetchOr(&uValue32,0x0000000FU,MEMORYORDER_ACQREL);
+	uFailure = (uOld32!=0xF0F0F100U) || (uValue32!=0xF0F0F10FU);
+	uResult |= uFailure;
+	ReportFailure("AtomicFetchOr(Word32) returned %08X",uFailure,uOld32);
+
+	uOld32 = AtomicFetchAnd(&uValue32,0x00FF00FFU,MEMORYORDER_ACQREL);
+	uFailure = (uOld32!=0xF0F0F10FU) || (uValue32!=0x00F0000FU);
+	uResult |= uFailure;
+	ReportFailure("AtomicFetchAnd(Word32) returned %08X",uFailure,uOld32);
+
+	// A failed compare must return the value found
+	Word32 uExpected32 = 5;
+	uFailure = AtomicCompareExchange(&uValue32,&uExpected32,1U,MEMORYORDER_SEQCST)!=FALSE;
+	uFailure |= (uExpected32!=0x00F0000FU) || (uValue32!=0x00F0000FU);
+	uResult |= uFailure;
+	ReportFailure("AtomicCompareExchange(Word32) on a mismatch, expected = %08X",uFailure,uExpected32);
+	uFailure = AtomicCompareExchange(&uValue32,&uExpected32,1U,MEMORYORDER_ACQUIRE)==FALSE;
+	uFailure |= (uValue32!=1U);
+	uResult |= uFailure;
+	ReportFailure("AtomicCompareExchange(Word32) on a match",uFailure);
+
+#if defined(BURGER_ATOMIC64)
+	volatile Word64 uValue64 = 0;
+	AtomicStore(&uValue64,0x123456789ABCDEF0ULL,MEMORYORDER_SEQCST);
+	uFailure = AtomicLoad(&uValue64,MEMORYORDER_RELAXED)!=0x123456789ABCDEF0ULL;
+	uResult |= uFailure;
+	ReportFailure("AtomicLoad(Word64)",uFailure);
+
+	// Carry from the lower 32 bits
+	Word64 uOld64 = AtomicFetchAdd(&uValue64,0x0000000065432110ULL,MEMORYORDER_ACQREL);
+	uFailure = (uOld64!=0x123456789ABCDEF0ULL) || (uValue64!=0x1234567900000000ULL);
+	uResult |= uFailure;
+	ReportFailure("AtomicFetchAdd(Word64)",uFailure);
+
+	uOld64 = AtomicFetchOr(&uValue64,0x8000000000000001ULL,MEMORYORDER_RELAXED);
+	uOld64 = AtomicFetchAnd(&uValue64,0xFFFFFFFF0000000FULL,MEMORYORDER_RELAXED);
+	uFailure = (uOld64!=0x9234567900000001ULL) || (uValue64!=0x9234567900000001ULL);
+	uResult |= uFailure;
+	ReportFailure("AtomicFetchOr(Word64) and AtomicFetchAnd(Word64)",uFailure);
+
+	Word64 uExpected64 = 0;
+	uFailure = AtomicCompareExchange(&uValue64,&uExpected64,2U,MEMORYORDER_SEQCST)!=FALSE;
+	uFailure |= (uExpected64!=0x9234567900000001ULL);
+	uFailure |= AtomicCompareExchange(&uValue64,&uExpected64,2U,MEMORYORDER_SEQCST)==FALSE;
+	uFailure |= (AtomicExchange(&uValue64,3U,MEMORYORDER_RELEASE)!=2U) || (uValue64!=3U);
+	uResult |= uFailure;
+	ReportFailure("AtomicCompareExchange(Word64)",uFailure);
+#endif
+
+	// Double width compare and swap
+	AtomicPair_t Pair;
+	Pair.m_uLow = 1;
+	Pair.m_uHigh = 2;
+	AtomicPair_t Before;
+	Before.m_uLow = 1;
+	Before.m_uHigh = 3;
+	AtomicPair_t After;
+	After.m_uLow = 10;
+	After.m_uHigh = 20;
+	uFailure = AtomicSetIfMatch(&Pair,&Before,&After)!=FALSE;
+	uFailure |= (Before.m_uLow!=1) || (Before.m_uHigh!=2) || (Pair.m_uLow!=1) || (Pair.m_uHigh!=2);
+	uResult |= uFailure;
+	ReportFailure("AtomicSetIfMatch(AtomicPair_t) on a mismatch of the upper value",uFailure);
+	uFailure = AtomicSetIfMatch(&Pair,&Before,&After)==FALSE;
+	uFailure |= (Pair.m_uLow!=10) || (Pair.m_uHigh!=20);
+	uResult |= uFailure;
+	ReportFailure("AtomicSetIfMatch(AtomicPair_t) on a match",uFailure);
+	uFailure = (reinterpret_cast<WordPtr>(&Pair)&((sizeof(WordPtr)*2)-1))!=0;
+	uResult |= uFailure;
+	ReportFailure("AtomicPair_t is not aligned to %u bytes",uFailure,static_cast<Word>(sizeof(WordPtr)*2));
+	return uResult;
+}
+
+/***************************************
+
+	Test the Atomic template and SpinLock from a single thread
+
+***************************************/
+
+static Word TestTemplate(void)
+{
+	Word uResult = FALSE;
+
+	Atomic<Int32> iValue(-5);
+	Int32 iOld = iValue.fetch_sub(10);
+	Word uFailure = (iOld!=-5) || (iValue.load()!=-15);
+	iOld = iValue.fetch_add(20,MEMORYORDER_RELAXED);
+	uFailure |= (iOld!=-15) || (iValue!=5);
+	iValue = 0x70;
+	uFailure |= (iValue.fetch_or(0x0F)!=0x70) || (iValue.fetch_and(0x3C)!=0x7F) || (iValue.load(MEMORYORDER_ACQUIRE)!=0x3C);
+	uResult |= uFailure;
+	ReportFailure("Atomic<Int32> arithmetic",uFailure);
+
+	// Floats are stored as their bit pattern
+	Atomic<float> fValue(1.5f);
+	float fExpected = 2.0f;
+	uFailure = fValue.compare_exchange(fExpected,3.0f)!=FALSE;
+	uFailure |= (fExpected!=1.5f);
+	uFailure |= fValue.compare_exchange(fExpected,3.0f,MEMORYORDER_ACQREL)==FALSE;
+	uFailure |= (fValue.exchange(-1.0f)!=3.0f) || (fValue.load()!=-1.0f);
+	uResult |= uFailure;
+	ReportFailure("Atomic<float>",uFailure);
+
+	int iTemp[2];
+	Atomic<int *> pValue;
+	uFailure = pValue.load()!=NULL;
+	pValue.store(&iTemp[1],MEMORYORDER_RELEASE);
+	uFailure |= (pValue.exchange(&iTemp[0])!=&iTemp[1]) || (pValue!=&iTemp[0]);
+	uResult |= uFailure;
+	ReportFailure("Atomic<int *>",uFailure);
+
+	SpinLock Lock;
+	uFailure = Lock.IsLocked()!=FALSE;
+	uFailure |= Lock.TryLock()==FALSE;
+	uFailure |= Lock.IsLocked()==FALSE;
+	uFailure |= Lock.TryLock()!=FALSE;
+	Lock.Unlock();
+	uFailure |= Lock.IsLocked()!=FALSE;
+	{
+		SpinLockLock Hold(&Lock);
+		uFailure |= Lock.TryLock()!=FALSE;
+	}
+	uFailure |= Lock.TryLock()==FALSE;
+	Lock.Unlock();
+	uResult |= uFailure;
+	ReportFailure("SpinLock",uFailure);
+	return uResult;
+}
+
+#if defined(USETHREADS)
+
+//
+// Node for the lock free stack, the nodes are never
+// freed so a popped node can always be read
+//
+
+struct StackNode_t {
+	StackNode_t *m_pNext;	// Next node in the stack
+	Word32 m_uOwner;		// Thread that popped this node last
+};
+
+struct ThreadTest_t {
+	volatile Word32 *m_pStart;		// Set when all threads are to begin
+	volatile Word32 *m_pCounter;	// Counter incremented with compare and swap
+	volatile Word32 *m_pBits;		// Each thread sets its own bits
+	volatile AtomicPair_t *m_pStack;	// Lock free stack head and ABA counter
+	SpinLock *m_pLock;				// Lock for m_pLocked
+	Word32 *m_pLocked;				// Counter guarded by the SpinLock
+	Word32 m_uID;					// Thread number
+	Word32 m_uCount;				// Number of passes
+	Word m_uFailure;				// Set if a stack node was shared
+};
+
+//
+// Pop a node from the lock free stack
+//
+
+static StackNode_t *Pop(volatile AtomicPair_t *pStack)
+{
+	AtomicPair_t Before;
+	Before.m_uLow = pStack->m_uLow;
+	Before.m_uHigh = pStack->m_uHigh;
+	AtomicPair_t After;
+	StackNode_t *pNode;
+	do {
+		pNode = reinterpret_cast<StackNode_t *>(Before.m_uLow);
+		if (!pNode) {
+			break;
+		}
+		// The node may have been taken already, the counter
+		// will make the swap fail if it was
+		After.m_uLow = reinterpret_cast<WordPtr>(pNode->m_pNext);
+		After.m_uHigh = Before.m_uHigh+1;
+	} while (!AtomicSetIfMatch(pStack,&Before,&After));
+	return pNode;
+}
+
+static void Push(volatile AtomicPair_t *pStack,StackNode_t *pNode)
+{
+	AtomicPair_t Before;
+	Before.m_uLow = pStack->m_uLow;
+	Before.m_uHigh = pStack->m_uHigh;
+	AtomicPair_t After;
+	After.m_uLow = reinterpret_cast<WordPtr>(pNode);
+	do {
+		pNode->m_pNext = reinterpret_cast<StackNode_t *>(Before.m_uLow);
+		After.m_uHigh = Before.m_uHigh+1;
+	} while (!AtomicSetIfMatch(pStack,&Before,&After));
+}
+
+//
+// Every thread hammers the same variables
+//
+
+static WordPtr BURGER_API StressThread(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	while (!AtomicLoad(pTest->m_pStart,MEMORYORDER_ACQUIRE)) {
+		AtomicPause();
+	}
+	Word32 uBit = 1U<<pTest->m_uID;
+	Word32 i = pTest->m_uCount;
+	do {
+		// Increment with a compare and swap loop, no increments can be lost
+		Word32 uExpected = AtomicLoad(pTest->m_pCounter,MEMORYORDER_RELAXED);
+		while (!AtomicCompareExchange(pTest->m_pCounter,&uExpected,uExpected+1,MEMORYORDER_RELAXED)) {
+		}
+
+		// Toggle this thread's bit, it must not be touched by anyone else
+		Word32 uOld = AtomicFetchOr(pTest->m_pBits,uBit,MEMORYORDER_ACQREL);
+		if (uOld&uBit) {
+			pTest->m_uFailure = TRUE;
+		}
+		uOld = AtomicFetchAnd(pTest->m_pBits,~uBit,MEMORYORDER_ACQREL);
+		if (!(uOld&uBit)) {
+			pTest->m_uFailure = TRUE;
+		}
+
+		// Take a node, mark it and make sure no other thread took it too
+		StackNode_t *pNode = Pop(pTest->m_pStack);
+		if (pNode) {
+			AtomicStore(&pNode->m_uOwner,pTest->m_uID,MEMORYORDER_RELAXED);
+			AtomicPause();
+			if (AtomicLoad(&pNode->m_uOwner,MEMORYORDER_RELAXED)!=pTest->m_uID) {
+				pTest->m_uFailure = TRUE;
+			}
+			Push(pTest->m_pStack,pNode);
+		}
+
+		// Plain increment guarded by the SpinLock
+		pTest->m_pLock->Lock();
+		++pTest->m_pLocked[0];
+		pTest->m_pLock->Unlock();
+	} while (--i);
+	return 0;
+}
+
+//
+// Every thread bumps the same counters with the read-modify-write functions
+//
+
+struct CounterTest_t {
+	volatile Word32 *m_pStart;		// Set when all threads are to begin
+	volatile Word32 *m_pCounters;	// Four shared 32 bit counters
+#if defined(BURGER_ATOMIC64)
+	volatile Word64 *m_pCounter64;	// Shared 64 bit counter
+#endif
+	Word32 m_uCount;				// Number of passes
+};
+
+static WordPtr BURGER_API CounterThread(void *pData)
+{
+	CounterTest_t *pTest = static_cast<CounterTest_t *>(pData);
+	while (!AtomicGet(pTest->m_pStart)) {
+		AtomicPause();
+	}
+	volatile Word32 *pCounters = pTest->m_pCounters;
+	Word32 i = pTest->m_uCount;
+	do {
+		AtomicPreIncrement(&pCounters[0]);
+		AtomicPostIncrement(&pCounters[1]);
+		AtomicAdd(&pCounters[2],3);
+		Word32 uOld;
+		do {
+			uOld = AtomicGet(&pCounters[3]);
+		} while (!AtomicSetIfMatch(&pCounters[3],uOld,uOld+1));
+#if defined(BURGER_ATOMIC64)
+		AtomicAdd(pTest->m_pCounter64,0x100000001ULL);
+#endif
+	} while (--i);
+	return 0;
+}
+
+/***************************************
+
+	Increment shared counters from every CPU
+	at the same time, no increments can be lost
+
+***************************************/
+
+static Word TestCounters(void)
+{
+	const Word32 cPasses = 200000;
+	Word32 uThreads = Thread::GetProcessorCount();
+	if (uThreads<4) {
+		uThreads = 4;
+	} else if (uThreads>32) {
+		uThreads = 32;
+	}
+
+	volatile Word32 uStart = 0;
+	volatile Word32 Counters[4] = {0,0,0,0};
+#if defined(BURGER_ATOMIC64)
+	volatile Word64 uCounter64 = 0;
+#endif
+	CounterTest_t Tests[32];
+	Thread Threads[32];
+	Word32 i = 0;
+	do {
+		Tests[i].m_pStart = &uStart;
+		Tests[i].m_pCounters = Counters;
+#if defined(BURGER_ATOMIC64)
+		Tests[i].m_pCounter64 = &uCounter64;
+#endif
+		Tests[i].m_uCount = cPasses;
+		Threads[i].Start(CounterThread,&Tests[i]);
+	} while (++i<uThreads);
+	AtomicSet(&uStart,1);
+	i = 0;
+	do {
+		Threads[i].Wait();
+	} while (++i<uThreads);
+
+	Word32 uTotal = cPasses*uThreads;
+	Word uFailure = Counters[0]!=uTotal;
+	Word uResult = uFailure;
+	ReportFailure("AtomicPreIncrement() on %u threads = %u, expected %u",uFailure,uThreads,Counters[0],uTotal);
+	uFailure = Counters[1]!=uTotal;
+	uResult |= uFailure;
+	ReportFailure("AtomicPostIncrement() on %u threads = %u, expected %u",uFailure,uThreads,Counters[1],uTotal);
+	uFailure = Counters[2]!=(uTotal*3);
+	uResult |= uFailure;
+	ReportFailure("AtomicAdd() on %u threads = %u, expected %u",uFailure,uThreads,Counters[2],uTotal*3);
+	uFailure = Counters[3]!=uTotal;
+	uResult |= uFailure;
+	ReportFailure("AtomicSetIfMatch() on %u threads = %u, expected %u",uFailure,uThreads,Counters[3],uTotal);
+#if defined(BURGER_ATOMIC64)
+	Word64 uExpected64 = (static_cast<Word64>(uTotal)<<32U)+uTotal;
+	uFailure = uCounter64!=uExpected64;
+	uResult |= uFailure;
+	ReportFailure("AtomicAdd(Word64) on %u threads = %08X%08X, expected %08X%08X",uFailure,uThreads,
+		static_cast<Word32>(uCounter64>>32U),static_cast<Word32>(uCounter64),
+		static_cast<Word32>(uExpected64>>32U),static_cast<Word32>(uExpected64));
+#endif
+	return uResult;
+}
+
+/***************************************
+
+	Run the compare and swap stress test
+	on every CPU at the same time
+
+***************************************/
+
+static Word TestThreads(void)
+{
+	const Word32 cPasses = 100000;
+	const Word32 cNodes = 8;
+	Word32 uThreads = Thread::GetProcessorCount();
+	if (uThreads<4) {
+		uThreads = 4;
+	} else if (uThreads>32) {
+		uThreads = 32;
+	}
+
+	volatile Word32 uStart = 0;
+	volatile Word32 uCounter = 0;
+	volatile Word32 uBits = 0;
+	AtomicPair_t Stack;
+	Stack.m_uLow = 0;
+	Stack.m_uHigh = 0;
+	StackNode_t Nodes[cNodes];
+	Word32 i = 0;
+	do {
+		Nodes[i].m_uOwner = 0;
+		Push(&Stack,&Nodes[i]);
+	} while (++i<cNodes);
+	SpinLock Lock;
+	Word32 uLocked = 0;
+
+	ThreadTest_t Tests[32];
+	Thread Threads[32];
+	i = 0;
+	do {
+		Tests[i].m_pStart = &uStart;
+		Tests[i].m_pCounter = &uCounter;
+		Tests[i].m_pBits = &uBits;
+		Tests[i].m_pStack = &Stack;
+		Tests[i].m_pLock = &Lock;
+		Tests[i].m_pLocked = &uLocked;
+		Tests[i].m_uID = i;
+		Tests[i].m_uCount = cPasses;
+		Tests[i].m_uFailure = FALSE;
+		Threads[i].Start(StressThread,&Tests[i]);
+	} while (++i<uThreads);
+	AtomicStore(&uStart,1,MEMORYORDER_RELEASE);
+	Word uFailure = FALSE;
+	i = 0;
+	do {
+		Threads[i].Wait();
+		uFailure |= Tests[i].m_uFailure;
+	} while (++i<uThreads);
+
+	Word uResult = uFailure;
+	ReportFailure("Atomic stress test on %u threads found a shared bit or node",uFailure,uThreads);
+
+	Word32 uTotal = cPasses*uThreads;
+	uFailure = (uCounter!=uTotal) || (uLocked!=uTotal) || (uBits!=0);
+	uResult |= uFailure;
+	ReportFailure("Atomic stress test counters %u and %u, expected %u",uFailure,uCounter,uLocked,uTotal);
+
+	// Every node must be in the stack exactly once
+	i = 0;
+	StackNode_t *pNode = reinterpret_cast<StackNode_t *>(Stack.m_uLow);
+	while (pNode && (i<=cNodes)) {
+		++i;
+		pNode = pNode->m_pNext;
+	}
+	uFailure = (i!=cNodes);
+	uResult |= uFailure;
+	ReportFailure("Lock free stack has %u nodes, expected %u",uFailure,i,cNodes);
+	return uResult;
+}
+#endif
+
+/***************************************
+
+	Test the atomic functions
+
+***************************************/
+
+int BURGER_API TestBratomic(void)
+{
+	Message("Running Atomic tests");
+	Word uResult = TestOrdered();
+	uResult |= TestTemplate();
+#if defined(USETHREADS)
+	uResult |= TestCounters();
+	uResult |= TestThreads();
+#endif
+	return static_cast<int>(uResult);
+}
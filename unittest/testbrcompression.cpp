@@ -17,9 +17,16 @@
 #include "brdecompresslbmrle.h"
 #include "brcompresslzss.h"
 #include "brdecompresslzss.h"
+#include "brcompresslz4.h"
+#include "brdecompresslz4.h"
 #include "brcompressdeflate.h"
 #include "brdecompressdeflate.h"
+#include "brulaw.h"
+#include "bralaw.h"
+#include "brmicrosoftadpcm.h"
+#include "brdviadpcm.h"
 #include "brstringfunctions.h"
+#include "brendian.h"
 #include "brfixedpoint.h"
 #include "brnumberstringhex.h"
 #include "brmemoryansi.h"
@@ -800,6 +807,569 @@ static Word TestDeflateCompress(void)
 	return uFailure;
 }
 
+//
+// Create test data with repeats that are near and far apart
+//
+
+static void CreateRepeatingData(Word8 *pOutput,WordPtr uLength)
+{
+	Word32 uSeed = 0x12345678U;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		Word uMode = static_cast<Word>(uSeed>>28U);
+		if ((i>=70000) && (uMode<6)) {
+			pOutput[i] = pOutput[i-65535+(uMode&3)];
+		} else if ((i>=16) && (uMode<12)) {
+			pOutput[i] = pOutput[i-1-(uMode&7)];
+		} else {
+			pOutput[i] = static_cast<Word8>(uSeed>>16U);
+		}
+	} while (++i<uLength);
+}
+
+//
+// Create test data with runs of a single byte and runs of noise
+//
+
+static void CreateRunData(Word8 *pOutput,WordPtr uLength)
+{
+	Word32 uSeed = 0x87654321U;
+	while (uLength) {
+		uSeed = (uSeed*1103515245U)+12345U;
+		WordPtr uChunk = ((uSeed>>16U)&0xFFU)+1U;
+		if (uChunk>uLength) {
+			uChunk = uLength;
+		}
+		if (uSeed&0x80000000U) {
+			MemoryFill(pOutput,static_cast<Word8>(uSeed>>8U),uChunk);
+		} else {
+			WordPtr i = 0;
+			do {
+				uSeed = (uSeed*1103515245U)+12345U;
+				pOutput[i] = static_cast<Word8>(uSeed>>16U);
+			} while (++i<uChunk);
+		}
+		pOutput += uChunk;
+		uLength -= uChunk;
+	}
+}
+
+//
+// Decompress with the one pass decompressor and the state machine and
+// make sure the results match. Matches can reach 4096 bytes before the
+// output, so both buffers start with the same 4096 bytes of data.
+//
+
+static const WordPtr cOneShotPrefix = 4096;
+
+static Word CompareOneShot(Word bRLE,Word8 *pSimple,Word8 *pStream,WordPtr uOutputSize,const Word8 *pPacked,WordPtr uPackedSize)
+{
+	WordPtr i = 0;
+	do {
+		pSimple[i] = static_cast<Word8>(i*7U);
+	} while (++i<cOneShotPrefix);
+	MemoryFill(pSimple+cOneShotPrefix,0xD5,uOutputSize+80);
+	MemoryCopy(pStream,pSimple,cOneShotPrefix+uOutputSize+80);
+
+	Decompress::eError SimpleError;
+	Decompress::eError StreamError;
+	WordPtr uDecoded;
+	const char *pName;
+	if (bRLE) {
+		pName = "SimpleDecompressILBMRLE";
+		SimpleError = SimpleDecompressILBMRLE(pSimple+cOneShotPrefix,uOutputSize,pPacked,uPackedSize);
+		DecompressILBMRLE Stream;
+		StreamError = Stream.Process(pStream+cOneShotPrefix,uOutputSize,pPacked,uPackedSize);
+		uDecoded = Stream.GetProcessedOutputSize();
+	} else {
+		pName = "SimpleDecompressLZSS";
+		SimpleError = SimpleDecompressLZSS(pSimple+cOneShotPrefix,uOutputSize,pPacked,uPackedSize);
+		DecompressLZSS Stream;
+		StreamError = Stream.Process(pStream+cOneShotPrefix,uOutputSize,pPacked,uPackedSize);
+		uDecoded = Stream.GetProcessedOutputSize();
+	}
+	Word uFailure = FALSE;
+	if (SimpleError!=StreamError) {
+		ReportFailure("%s(%u,%u) = %d, expected %d",TRUE,pName,static_cast<Word>(uOutputSize),static_cast<Word>(uPackedSize),SimpleError,StreamError);
+		uFailure = TRUE;
+	}
+	if (MemoryCompare(pSimple,pStream,cOneShotPrefix+uDecoded)) {
+		ReportFailure("%s(%u,%u) data mismatch",TRUE,pName,static_cast<Word>(uOutputSize),static_cast<Word>(uPackedSize));
+		uFailure = TRUE;
+	}
+	const Word8 *pGuard = pSimple+cOneShotPrefix+uOutputSize;
+	i = 0;
+	do {
+		if (pGuard[i]!=0xD5) {
+			ReportFailure("%s(%u,%u) = Buffer overrun",TRUE,pName,static_cast<Word>(uOutputSize),static_cast<Word>(uPackedSize));
+			uFailure = TRUE;
+			break;
+		}
+	} while (++i<80);
+	return uFailure;
+}
+
+//
+// Test the one pass LZSS and RLE decompressors against the state machines
+//
+
+static Word TestOneShotDecompress(void)
+{
+	Word uFailure = FALSE;
+	const WordPtr uRawSize = 30000;
+	const WordPtr uBufferSize = cOneShotPrefix+uRawSize+200+80;
+	Word8 *pRaw = static_cast<Word8 *>(Alloc(uRawSize));
+	Word8 *pSimple = static_cast<Word8 *>(Alloc(uBufferSize));
+	Word8 *pStream = static_cast<Word8 *>(Alloc(uBufferSize));
+	if (!pRaw || !pSimple || !pStream) {
+		ReportFailure("TestOneShotDecompress() out of memory",TRUE);
+		Free(pStream);
+		Free(pSimple);
+		Free(pRaw);
+		return TRUE;
+	}
+
+	Word bRLE = FALSE;
+	do {
+		// Compressed data, then noise
+		Word uPass = 0;
+		do {
+			WordPtr uRawLength = uRawSize;
+			WordPtr uPackedSize;
+			Word8 *pPacked;
+			if (!uPass) {
+				Compress *pCompress;
+				if (bRLE) {
+					CreateRunData(pRaw,uRawSize);
+					pCompress = New<CompressILBMRLE>();
+				} else {
+					CreateRepeatingData(pRaw,uRawSize);
+					pCompress = New<CompressLZSS>();
+				}
+				pCompress->Process(pRaw,uRawSize);
+				pCompress->Finalize();
+				pPacked = static_cast<Word8 *>(pCompress->GetOutput()->Flatten(&uPackedSize));
+				Delete(pCompress);
+			} else {
+				uRawLength = 20000;
+				uPackedSize = 10000;
+				pPacked = static_cast<Word8 *>(Alloc(uPackedSize));
+				if (pPacked) {
+					Word32 uSeed = 0x5EED0000U+bRLE;
+					WordPtr i = 0;
+					do {
+						uSeed = (uSeed*1103515245U)+12345U;
+						pPacked[i] = static_cast<Word8>(uSeed>>16U);
+					} while (++i<uPackedSize);
+				}
+			}
+			if (!pPacked) {
+				ReportFailure("TestOneShotDecompress() out of memory",TRUE);
+				uFailure = TRUE;
+				break;
+			}
+
+			// Test exact, short and long output buffers and short input
+			const WordPtr OutputSizes[5] = {uRawLength,uRawLength-1,uRawLength/2,uRawLength+200,0};
+			const WordPtr InputSizes[4] = {uPackedSize,uPackedSize-1,uPackedSize/3,0};
+			Word uOutput = 0;
+			do {
+				Word uInput = 0;
+				do {
+					uFailure |= CompareOneShot(bRLE,pSimple,pStream,OutputSizes[uOutput],pPacked,InputSizes[uInput]);
+				} while (++uInput<BURGER_ARRAYSIZE(InputSizes));
+			} while (++uOutput<BURGER_ARRAYSIZE(OutputSizes));
+
+			// The valid data must decompress
+			if (!uPass) {
+				Decompress::eError Error;
+				if (bRLE) {
+					Error = SimpleDecompressILBMRLE(pSimple,uRawSize,pPacked,uPackedSize);
+				} else {
+					Error = SimpleDecompressLZSS(pSimple,uRawSize,pPacked,uPackedSize);
+				}
+				if ((Error!=Decompress::DECOMPRESS_OKAY) || MemoryCompare(pSimple,pRaw,uRawSize)) {
+					ReportFailure("TestOneShotDecompress(%u) = %d, data didn't decompress",TRUE,bRLE,Error);
+					uFailure = TRUE;
+				}
+			}
+			Free(pPacked);
+		} while (++uPass<2);
+	} while (++bRLE<2);
+	Free(pStream);
+	Free(pSimple);
+	Free(pRaw);
+	return uFailure;
+}
+
+//
+// Test the LZ4 compression and decompression
+//
+
+static Word TestLZ4(void)
+{
+	Word uFailure = FALSE;
+	Word8 Buffer[sizeof(RawData)+80];
+	MemoryFill(Buffer,0xD5,sizeof(Buffer));
+
+	// Test all the compression modes on small and multiple block data
+	const WordPtr uLargeSize = 200000;
+	Word8 *pLarge = static_cast<Word8 *>(Alloc(uLargeSize));
+	Word8 *pLargeBuffer = static_cast<Word8 *>(Alloc(uLargeSize+80));
+	if (!pLarge || !pLargeBuffer) {
+		ReportFailure("TestLZ4() out of memory",TRUE);
+		Free(pLargeBuffer);
+		Free(pLarge);
+		return TRUE;
+	}
+	CreateRepeatingData(pLarge,uLargeSize);
+	MemoryFill(pLargeBuffer,0xD5,uLargeSize+80);
+
+	CompressLZ4 Tester;
+	DecompressLZ4 Decompressor;
+	Word uMode = 0;
+	do {
+		Tester.SetHighCompression(uMode&1U);
+		Tester.SetIndependentBlocks(uMode>>1U);
+
+		// Small data with the input split at every point
+		WordPtr uSplit = 0;
+		do {
+			Tester.Init();
+			Compress::eError Error = Tester.Process(RawData,uSplit);
+			if (Error==Compress::COMPRESS_OKAY) {
+				Error = Tester.Process(RawData+uSplit,sizeof(RawData)-uSplit);
+			}
+			if (Error==Compress::COMPRESS_OKAY) {
+				Error = Tester.Finalize();
+			}
+			if (Error!=Compress::COMPRESS_OKAY) {
+				ReportFailure("CompressLZ4::Process(mode %u, uSplit %04X) = %d, expected Compress::COMPRESS_OKAY",TRUE,uMode,static_cast<Word32>(uSplit),Error);
+				uFailure = TRUE;
+			}
+			WordPtr uPackedSize;
+			Word8 *pPacked = static_cast<Word8 *>(Tester.GetOutput()->Flatten(&uPackedSize));
+			Decompress::eError DError = SimpleDecompressLZ4(Buffer,sizeof(RawData),pPacked,uPackedSize);
+			if (DError!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("SimpleDecompressLZ4(mode %u, uSplit %04X) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uMode,static_cast<Word32>(uSplit),DError);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(Buffer,RawData,sizeof(RawData),"SimpleDecompressLZ4(RawData)");
+			Free(pPacked);
+		} while (++uSplit<sizeof(RawData));
+
+		// Multiple blocks
+		Tester.Init();
+		Compress::eError Error = Tester.Process(pLarge,uLargeSize);
+		if (Error==Compress::COMPRESS_OKAY) {
+			Error = Tester.Finalize();
+		}
+		if (Error!=Compress::COMPRESS_OKAY) {
+			ReportFailure("CompressLZ4::Process(mode %u, pLarge) = %d, expected Compress::COMPRESS_OKAY",TRUE,uMode,Error);
+			uFailure = TRUE;
+		}
+		WordPtr uPackedSize;
+		Word8 *pPacked = static_cast<Word8 *>(Tester.GetOutput()->Flatten(&uPackedSize));
+		if (!pPacked || (uPackedSize>=uLargeSize)) {
+			ReportFailure("CompressLZ4::GetOutputSize(mode %u, pLarge) = %u, data wasn't compressed",TRUE,uMode,static_cast<Word>(uPackedSize));
+			uFailure = TRUE;
+		} else {
+			Decompress::eError DError = SimpleDecompressLZ4(pLargeBuffer,uLargeSize,pPacked,uPackedSize);
+			if (DError!=Decompress::DECOMPRESS_OKAY) {
+				ReportFailure("SimpleDecompressLZ4(mode %u, pLarge) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uMode,DError);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pLargeBuffer,pLarge,uLargeSize,"SimpleDecompressLZ4(pLarge)");
+
+			// Decompress with small, odd sized input and output chunks
+			Decompressor.Reset();
+			WordPtr uInputIndex = 0;
+			WordPtr uOutputIndex = 0;
+			Word uChunk = 0;
+			do {
+				WordPtr uInputChunk = (uChunk%997U)+1U;
+				WordPtr uOutputChunk = (uChunk%1499U)+1U;
+				++uChunk;
+				if (uInputChunk>(uPackedSize-uInputIndex)) {
+					uInputChunk = uPackedSize-uInputIndex;
+				}
+				if (uOutputChunk>(uLargeSize-uOutputIndex)) {
+					uOutputChunk = uLargeSize-uOutputIndex;
+				}
+				DError = Decompressor.Process(pLargeBuffer+uOutputIndex,uOutputChunk,pPacked+uInputIndex,uInputChunk);
+				uInputIndex += Decompressor.GetProcessedInputSize();
+				uOutputIndex += Decompressor.GetProcessedOutputSize();
+			} while ((DError==Decompress::DECOMPRESS_OUTPUTUNDERRUN) || (DError==Decompress::DECOMPRESS_OUTPUTOVERRUN));
+			if ((DError!=Decompress::DECOMPRESS_OKAY) || (uInputIndex!=uPackedSize) || (uOutputIndex!=uLargeSize)) {
+				ReportFailure("DecompressLZ4::Process(mode %u, chunks) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uMode,DError);
+				uFailure = TRUE;
+			}
+			uFailure |= ReportDecompress(pLargeBuffer,pLarge,uLargeSize,"DecompressLZ4::Process(pLarge)");
+
+			// Independent blocks can be decoded one at a time
+			if (uMode>>1U) {
+				const Word8 *pWork = pPacked+DecompressLZ4::FRAMEHEADERSIZE;
+				uOutputIndex = 0;
+				for (;;) {
+					Word32 uBlockSize = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pWork));
+					pWork += 4;
+					if (!uBlockSize) {
+						break;
+					}
+					if (uBlockSize&DecompressLZ4::BLOCKSTORED) {
+						uBlockSize &= DecompressLZ4::BLOCKSIZEMASK;
+						MemoryCopy(pLargeBuffer+uOutputIndex,pWork,uBlockSize);
+						uOutputIndex += uBlockSize;
+					} else {
+						Word32 uUnpackedSize = LittleEndian::LoadAny(reinterpret_cast<const Word32 *>(pWork));
+						pWork += 4;
+						DError = DecompressLZ4::DecodeBlock(pLargeBuffer+uOutputIndex,uUnpackedSize,pWork,uBlockSize);
+						if (DError!=Decompress::DECOMPRESS_OKAY) {
+							ReportFailure("DecompressLZ4::DecodeBlock(mode %u) = %d, expected Decompress::DECOMPRESS_OKAY",TRUE,uMode,DError);
+							uFailure = TRUE;
+						}
+						uOutputIndex += uUnpackedSize;
+					}
+					pWork += uBlockSize;
+				}
+				uFailure |= ReportDecompress(pLargeBuffer,pLarge,uLargeSize,"DecompressLZ4::DecodeBlock(pLarge)");
+			}
+		}
+		Free(pPacked);
+	} while (++uMode<4);
+
+	// Bad data must be rejected
+	static const Word8 BadVersion[] = {0x02,0x00,0x10,0x00,0x00,0x00,0x00,0x00};
+	static const Word8 BadOffset[] = {
+		0x01,0x01,0x10,0x00,				// Frame header
+		0x03,0x00,0x00,0x00,0x08,0x00,0x00,0x00,	// 3 bytes packed, 8 unpacked
+		0x04,0x10,0x00,						// Match 8 bytes back with no data
+		0x00,0x00,0x00,0x00
+	};
+	Decompress::eError DError = SimpleDecompressLZ4(Buffer,8,BadVersion,sizeof(BadVersion));
+	if (DError!=Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure("SimpleDecompressLZ4(BadVersion) = %d, expected Decompress::DECOMPRESS_BADINPUT",TRUE,DError);
+		uFailure = TRUE;
+	}
+	DError = SimpleDecompressLZ4(Buffer,8,BadOffset,sizeof(BadOffset));
+	if (DError!=Decompress::DECOMPRESS_BADINPUT) {
+		ReportFailure("SimpleDecompressLZ4(BadOffset) = %d, expected Decompress::DECOMPRESS_BADINPUT",TRUE,DError);
+		uFailure = TRUE;
+	}
+	Free(pLargeBuffer);
+	Free(pLarge);
+	return uFailure;
+}
+
+//
+// Test the u-Law and A-Law decoders
+//
+
+static Word TestLogDecompress(void)
+{
+	Word uFailure = FALSE;
+
+	// Spot check the tables against G.711
+	static const Word8 LawSamples[4] = {0x00,0x7F,0x80,0xFF};
+	static const Int16 ULawExpected[4] = {-32124,0,32124,0};
+	static const Int16 ALawExpected[4] = {-5504,-848,5504,848};
+	Word i = 0;
+	do {
+		Int16 iULaw = ULawToLinear(LawSamples[i]);
+		Int16 iALaw = ALawToLinear(LawSamples[i]);
+		Word uTest = (iULaw!=ULawExpected[i]) || (iALaw!=ALawExpected[i]);
+		ReportFailure("ULawToLinear/ALawToLinear(0x%02X) = %d,%d",uTest,LawSamples[i],iULaw,iALaw);
+		uFailure |= uTest;
+	} while (++i<4);
+
+	// Decode every value at odd alignments and lengths to exercise the SIMD code and
+	// make sure it matches the tables
+	Word8 Input[256+19];
+	Int16 Output[256+19];
+	i = 0;
+	do {
+		Input[i] = static_cast<Word8>(i*151U);
+	} while (++i<BURGER_ARRAYSIZE(Input));
+	Word uOffset = 0;
+	do {
+		WordPtr uLength = BURGER_ARRAYSIZE(Input)-uOffset;
+		ULawExpand(Input+uOffset,Output,uLength);
+		i = 0;
+		do {
+			if (Output[i]!=g_ULawToLinearTable[Input[i+uOffset]]) {
+				ReportFailure("ULawExpand() offset %u, sample %u",TRUE,uOffset,i);
+				uFailure = TRUE;
+				break;
+			}
+		} while (++i<uLength);
+		ALawExpand(Input+uOffset,Output,uLength);
+		i = 0;
+		do {
+			if (Output[i]!=g_ALawToLinearTable[Input[i+uOffset]]) {
+				ReportFailure("ALawExpand() offset %u, sample %u",TRUE,uOffset,i);
+				uFailure = TRUE;
+				break;
+			}
+		} while (++i<uLength);
+	} while (++uOffset<19);
+	return uFailure;
+}
+
+//
+// Compare decoded samples to the expected results
+//
+
+static Word ReportSamples(const Int16 *pOutput,const Int16 *pExpected,WordPtr uCount,const char *pFunction)
+{
+	WordPtr i = 0;
+	do {
+		if (pOutput[i]!=pExpected[i]) {
+			ReportFailure("%s sample %u = %d, expected %d",TRUE,pFunction,static_cast<Word>(i),pOutput[i],pExpected[i]);
+			return TRUE;
+		}
+	} while (++i<uCount);
+	return FALSE;
+}
+
+//
+// Microsoft ADPCM blocks and their decoded output
+//
+
+static const Word8 MSADPCMMono[] = {
+	0x01,0x10,0x00,0x64,0x00,0x32,0x00,
+	0x12,0xF8,0x77,0x07,0x9A,0xC3
+};
+
+static const Int16 MSADPCMMonoExpected[] = {
+	50,100,166,264,346,300,590,1685,2780,5604,4284,-5550,-26736,-32768
+};
+
+static const Word8 MSADPCMStereo[] = {
+	0x00,0x04,0x20,0x00,0x40,0x00,0x10,0x27,0xF0,0xD8,0x00,0x00,0x00,0x00,
+	0x7F,0x80,0x35,0xE9,0x11,0x6C
+};
+
+static const Int16 MSADPCMStereoExpected[] = {
+	0,0,10000,-10000,10224,-9439,9616,-8850,
+	10300,-8042,9892,-8107,10075,-7407,11059,-7641
+};
+
+//
+// DVI ADPCM blocks and their decoded output
+//
+
+static const Word8 DVIADPCMMono[] = {
+	0xE8,0x03,0x0A,0x00,
+	0x21,0x43,0x65,0x87,0xFF,0x0F,0x70,0x99
+};
+
+static const Int16 DVIADPCMMonoExpected[] = {
+	1000,1006,1016,1030,1045,1068,1108,1191,1179,1014,659,-106,3,102,1459,877,349
+};
+
+static const Word8 DVIADPCMStereo[] = {
+	0x00,0x00,0x28,0x00,0x18,0xFC,0x03,0x00,
+	0x77,0x77,0x77,0x77,0x88,0x99,0xAA,0x08,
+	0x01,0x23,0x45,0x67,0xF0,0xE1,0xD2,0xC3
+};
+
+static const Int16 DVIADPCMStereoExpected[] = {
+	0,-1000,631,-1001,1988,-1002,4898,-1005,11134,-1006,24506,-1009,
+	32767,-1012,32767,-1012,32767,-1012,32767,-1012,32767,-1023,32767,-1017,
+	32767,-1039,32767,-1024,32767,-1054,32767,-1025,32767,-1059
+};
+
+static const Word8 DVIADPCMStream[] = {
+	0x73,0x37,0x0F,0xF0,0x88,0x44,0x12,0x34
+};
+
+static const Int16 DVIADPCMStreamExpected[] = {
+	4,15,45,74,18,26,33,-68,-82,-95,14,146,234,282,414,537
+};
+
+//
+// Test the ADPCM decoders
+//
+
+static Word TestADPCMDecompress(void)
+{
+	Word uFailure = FALSE;
+	Int16 Output[64];
+
+	// Microsoft ADPCM
+	WordPtr uFrames = MicrosoftADPCMDecodeBlock(MSADPCMMono,Output,sizeof(MSADPCMMono),1);
+	Word uTest = uFrames!=BURGER_ARRAYSIZE(MSADPCMMonoExpected);
+	ReportFailure("MicrosoftADPCMDecodeBlock(mono) returned %u frames",uTest,static_cast<Word>(uFrames));
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,MSADPCMMonoExpected,BURGER_ARRAYSIZE(MSADPCMMonoExpected),"MicrosoftADPCMDecodeBlock(mono)");
+
+	MicrosoftADPCMState_t States[2];
+	uFrames = MicrosoftADPCMDecodeBlock(MSADPCMStereo,Output,sizeof(MSADPCMStereo),2,States);
+	uTest = (uFrames*2)!=BURGER_ARRAYSIZE(MSADPCMStereoExpected);
+	uTest |= (States[0].m_iSample1!=11059) || (States[1].m_iSample1!=-7641);
+	ReportFailure("MicrosoftADPCMDecodeBlock(stereo) returned %u frames",uTest,static_cast<Word>(uFrames));
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,MSADPCMStereoExpected,BURGER_ARRAYSIZE(MSADPCMStereoExpected),"MicrosoftADPCMDecodeBlock(stereo)");
+
+	// Two blocks where the last one is short
+	Word8 Blocks[sizeof(MSADPCMMono)*2];
+	MemoryCopy(Blocks,MSADPCMMono,sizeof(MSADPCMMono));
+	MemoryCopy(Blocks+sizeof(MSADPCMMono),MSADPCMMono,sizeof(MSADPCMMono));
+	uFrames = MicrosoftADPCMDecode(Blocks,Output,sizeof(MSADPCMMono)*2-2,sizeof(MSADPCMMono),1);
+	uTest = uFrames!=(BURGER_ARRAYSIZE(MSADPCMMonoExpected)*2-4);
+	ReportFailure("MicrosoftADPCMDecode() returned %u frames",uTest,static_cast<Word>(uFrames));
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,MSADPCMMonoExpected,BURGER_ARRAYSIZE(MSADPCMMonoExpected),"MicrosoftADPCMDecode() block 1");
+	uFailure |= ReportSamples(Output+BURGER_ARRAYSIZE(MSADPCMMonoExpected),MSADPCMMonoExpected,BURGER_ARRAYSIZE(MSADPCMMonoExpected)-4,"MicrosoftADPCMDecode() block 2");
+
+	// Invalid predictor
+	Blocks[0] = 7;
+	uTest = MicrosoftADPCMDecodeBlock(Blocks,Output,sizeof(MSADPCMMono),1)!=0;
+	ReportFailure("MicrosoftADPCMDecodeBlock() accepted a bad predictor",uTest);
+	uFailure |= uTest;
+
+	// DVI ADPCM
+	uFrames = DVIADPCMDecodeBlock(DVIADPCMMono,Output,sizeof(DVIADPCMMono),1);
+	uTest = uFrames!=BURGER_ARRAYSIZE(DVIADPCMMonoExpected);
+	ReportFailure("DVIADPCMDecodeBlock(mono) returned %u frames",uTest,static_cast<Word>(uFrames));
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,DVIADPCMMonoExpected,BURGER_ARRAYSIZE(DVIADPCMMonoExpected),"DVIADPCMDecodeBlock(mono)");
+
+	uFrames = DVIADPCMDecode(DVIADPCMStereo,Output,sizeof(DVIADPCMStereo),sizeof(DVIADPCMStereo),2);
+	uTest = (uFrames*2)!=BURGER_ARRAYSIZE(DVIADPCMStereoExpected);
+	ReportFailure("DVIADPCMDecode(stereo) returned %u frames",uTest,static_cast<Word>(uFrames));
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,DVIADPCMStereoExpected,BURGER_ARRAYSIZE(DVIADPCMStereoExpected),"DVIADPCMDecode(stereo)");
+
+	// Decode a headerless stream in pieces, the state must carry over
+	DVIADPCMState_t State;
+	State.m_iPredictor = 0;
+	State.m_iStepIndex = 0;
+	DVIADPCMExpand(DVIADPCMStream,Output,3,&State,NULL,1,1);
+	DVIADPCMExpand(DVIADPCMStream+3,Output+6,5,&State,NULL,1,1);
+	uTest = (State.m_iPredictor!=537) || (State.m_iStepIndex!=30);
+	ReportFailure("DVIADPCMExpand() ended with state %d,%d",uTest,State.m_iPredictor,State.m_iStepIndex);
+	uFailure |= uTest;
+	uFailure |= ReportSamples(Output,DVIADPCMStreamExpected,BURGER_ARRAYSIZE(DVIADPCMStreamExpected),"DVIADPCMExpand()");
+
+	// Decode the same stream as the second of two interleaved channels
+	Word8 Interleaved[sizeof(DVIADPCMStream)*2];
+	Word i = 0;
+	do {
+		Interleaved[i*2] = 0x00;
+		Interleaved[(i*2)+1] = DVIADPCMStream[i];
+	} while (++i<sizeof(DVIADPCMStream));
+	Int16 Stereo[BURGER_ARRAYSIZE(DVIADPCMStreamExpected)*2];
+	DVIADPCMExpand(Interleaved,Stereo,sizeof(DVIADPCMStream),NULL,NULL,2,2);
+	i = 0;
+	do {
+		Output[i] = Stereo[(i*2)+1];
+	} while (++i<BURGER_ARRAYSIZE(DVIADPCMStreamExpected));
+	uFailure |= ReportSamples(Output,DVIADPCMStreamExpected,BURGER_ARRAYSIZE(DVIADPCMStreamExpected),"DVIADPCMExpand(stereo)");
+	return uFailure;
+}
+
 //
 // Test compression code
 //
@@ -811,7 +1381,11 @@ int BURGER_API TestBrcompression(void)
 	uResult |= TestILBMCompress();
 	uResult |= TestLZSSDecompress();
 	uResult |= TestLZSSCompress();
+	uResult |= TestOneShotDecompress();
 	uResult |= TestDeflateDecompress();
 	uResult |= TestDeflateCompress();
+	uResult |= TestLZ4();
+	uResult |= TestLogDecompress();
+	uResult |= TestADPCMDecompress();
 	return static_cast<int>(uResult);
 }
@@ -0,0 +1,434 @@
+/***************************************
+
+	Unit tests for the asynchronous file I/O queue
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrfileioqueue.h"
+#include "common.h"
+#include "brfileioqueue.h"
+#include "brfilemanager.h"
+#include "brstringfunctions.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Scratch files for the queue tests
+//
+
+#define QUEUETESTFILE "9:testbrfileioqueue.bin"
+#define QUEUEOUTPUTFILE "9:testbrfileioqueue.out"
+
+//
+// Size of the test file, not a multiple of the chunk size
+// so the last read is short
+//
+
+#define QUEUETESTSIZE 0x9123
+
+//
+// Size of each read or write
+//
+
+#define QUEUECHUNKSIZE 0x400
+
+//
+// Number of requests in the queue, small so the tests run out
+//
+
+#define QUEUEDEPTH 8
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word Random(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return (g_uSeed>>16)%uRange;
+}
+
+//
+// Result of a single request
+//
+
+struct Completion_t {
+	Word m_uCalls;				///< Number of times the completion function was called
+	Word m_uError;				///< Error code passed to the completion function
+	WordPtr m_uTransferred;		///< Number of bytes passed to the completion function
+};
+
+static void BURGER_API RecordCompletion(void *pData,Word uError,WordPtr uTransferred)
+{
+	Completion_t *pCompletion = static_cast<Completion_t *>(pData);
+	++pCompletion->m_uCalls;
+	pCompletion->m_uError = uError;
+	pCompletion->m_uTransferred = uTransferred;
+}
+
+//
+// Read a file a chunk at a time, each completion queues the next read
+//
+
+struct Chain_t {
+	FileIOQueue *m_pQueue;		///< Queue to add the next read to
+	File *m_pFile;				///< File being read
+	Word8 *m_pBuffer;			///< Buffer for the whole file
+	WordPtr m_uOffset;			///< Offset of the read in progress
+	Word m_uCalls;				///< Number of completions
+	Word m_uFailures;			///< Number of errors
+};
+
+static void BURGER_API ChainCompletion(void *pData,Word uError,WordPtr uTransferred)
+{
+	Chain_t *pChain = static_cast<Chain_t *>(pData);
+	++pChain->m_uCalls;
+	if (uError) {
+		++pChain->m_uFailures;
+	} else if (uTransferred==QUEUECHUNKSIZE) {
+		// Not at the end of the file yet, get the next chunk
+		pChain->m_uOffset += QUEUECHUNKSIZE;
+		if (pChain->m_pQueue->ReadAsync(pChain->m_pFile,pChain->m_uOffset,pChain->m_pBuffer+pChain->m_uOffset,QUEUECHUNKSIZE,ChainCompletion,pChain)!=File::OKAY) {
+			++pChain->m_uFailures;
+		}
+	}
+}
+
+/***************************************
+
+	Test a batch of reads sent with a single Submit()
+
+***************************************/
+
+static Word TestBatch(FileIOQueue *pQueue,File *pFile,const Word8 *pData,const char *pName)
+{
+	Word8 Buffer[QUEUEDEPTH][QUEUECHUNKSIZE];
+	Completion_t Completions[QUEUEDEPTH];
+	MemoryClear(Completions,sizeof(Completions));
+	Word uFailure = 0;
+
+	// Random offsets, in any order
+	WordPtr Offsets[QUEUEDEPTH];
+	Word i = 0;
+	do {
+		Offsets[i] = Random(QUEUETESTSIZE-QUEUECHUNKSIZE);
+		Word uReturn = pQueue->ReadAsync(pFile,Offsets[i],Buffer[i],QUEUECHUNKSIZE,RecordCompletion,&Completions[i]);
+		Word uTest = uReturn!=File::OKAY;
+		uFailure |= uTest;
+		ReportFailure("%s FileIOQueue::ReadAsync() = %u",uTest,pName,uReturn);
+	} while (++i<QUEUEDEPTH);
+
+	// Nothing starts until Submit()
+	Word uQueued = pQueue->GetQueuedCount();
+	Word uTest = (uQueued!=QUEUEDEPTH) || pQueue->GetInFlightCount() || Completions[0].m_uCalls;
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::GetQueuedCount() = %u before Submit()",uTest,pName,uQueued);
+	Word uSubmitted = pQueue->Submit();
+	uTest = (uSubmitted!=QUEUEDEPTH) || pQueue->GetQueuedCount() || (pQueue->GetInFlightCount()!=QUEUEDEPTH);
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::Submit() = %u",uTest,pName,uSubmitted);
+
+	pQueue->WaitAll();
+	uTest = pQueue->GetInFlightCount()!=0;
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::WaitAll() left %u in flight",uTest,pName,pQueue->GetInFlightCount());
+	i = 0;
+	do {
+		uTest = (Completions[i].m_uCalls!=1) || Completions[i].m_uError ||
+			(Completions[i].m_uTransferred!=QUEUECHUNKSIZE) || MemoryCompare(Buffer[i],pData+Offsets[i],QUEUECHUNKSIZE);
+		uFailure |= uTest;
+		ReportFailure("%s batch read at %u, calls %u, error %u, read %u",uTest,pName,static_cast<Word>(Offsets[i]),Completions[i].m_uCalls,Completions[i].m_uError,static_cast<Word>(Completions[i].m_uTransferred));
+	} while (++i<QUEUEDEPTH);
+	return uFailure;
+}
+
+/***************************************
+
+	Queue more requests than the queue holds, the oldest
+	requests are finished to make room
+
+***************************************/
+
+static Word TestExhaustion(FileIOQueue *pQueue,File *pFile,const Word8 *pData,const char *pName)
+{
+	const Word uCount = QUEUEDEPTH*3;
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(uCount*QUEUECHUNKSIZE));
+	Completion_t Completions[QUEUEDEPTH*3];
+	MemoryClear(Completions,sizeof(Completions));
+	Word uFailure = 0;
+	Word i = 0;
+	do {
+		Word uReturn = pQueue->ReadAsync(pFile,i*QUEUECHUNKSIZE,pBuffer+(i*QUEUECHUNKSIZE),QUEUECHUNKSIZE,RecordCompletion,&Completions[i]);
+		Word uInUse = pQueue->GetQueuedCount()+pQueue->GetInFlightCount();
+		Word uTest = (uReturn!=File::OKAY) || (uInUse>QUEUEDEPTH);
+		uFailure |= uTest;
+		ReportFailure("%s FileIOQueue::ReadAsync() past the depth = %u, %u in use",uTest,pName,uReturn,uInUse);
+	} while (++i<uCount);
+
+	// The first requests had to finish to make room
+	Word uTest = Completions[0].m_uCalls!=1;
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::ReadAsync() didn't finish the oldest request",uTest,pName);
+
+	pQueue->WaitAll();
+	i = 0;
+	do {
+		uTest = (Completions[i].m_uCalls!=1) || Completions[i].m_uError || (Completions[i].m_uTransferred!=QUEUECHUNKSIZE);
+		uFailure |= uTest;
+		ReportFailure("%s read %u past the depth, calls %u, error %u, read %u",uTest,pName,i,Completions[i].m_uCalls,Completions[i].m_uError,static_cast<Word>(Completions[i].m_uTransferred));
+	} while (++i<uCount);
+	uTest = MemoryCompare(pBuffer,pData,uCount*QUEUECHUNKSIZE)!=0;
+	uFailure |= uTest;
+	ReportFailure("%s data read past the depth doesn't match",uTest,pName);
+	Free(pBuffer);
+	return uFailure;
+}
+
+/***************************************
+
+	Read the whole file with chains of requests queued
+	by the completion functions
+
+***************************************/
+
+static Word TestChained(FileIOQueue *pQueue,File *pFile,const Word8 *pData,const char *pName)
+{
+	// Two chains, so requests from both are in flight
+	Word8 *pBuffers[2];
+	Chain_t Chains[2];
+	Word i = 0;
+	do {
+		pBuffers[i] = static_cast<Word8 *>(AllocClear(QUEUETESTSIZE+QUEUECHUNKSIZE));
+		Chains[i].m_pQueue = pQueue;
+		Chains[i].m_pFile = pFile;
+		Chains[i].m_pBuffer = pBuffers[i];
+		Chains[i].m_uOffset = 0;
+		Chains[i].m_uCalls = 0;
+		Chains[i].m_uFailures = 0;
+		pQueue->ReadAsync(pFile,0,pBuffers[i],QUEUECHUNKSIZE,ChainCompletion,&Chains[i]);
+	} while (++i<2);
+	pQueue->WaitAll();
+
+	Word uFailure = 0;
+	const Word uExpected = (QUEUETESTSIZE/QUEUECHUNKSIZE)+1;
+	i = 0;
+	do {
+		Word uTest = (Chains[i].m_uCalls!=uExpected) || Chains[i].m_uFailures || MemoryCompare(pBuffers[i],pData,QUEUETESTSIZE);
+		uFailure |= uTest;
+		ReportFailure("%s chained reads, calls %u, failures %u",uTest,pName,Chains[i].m_uCalls,Chains[i].m_uFailures);
+		Free(pBuffers[i]);
+	} while (++i<2);
+	Word uTest = pQueue->GetInFlightCount() || pQueue->GetQueuedCount();
+	uFailure |= uTest;
+	ReportFailure("%s chained reads left requests behind",uTest,pName);
+	return uFailure;
+}
+
+/***************************************
+
+	Reads that run into the end of the file
+
+***************************************/
+
+static Word TestEndOfFile(FileIOQueue *pQueue,File *pFile,const Word8 *pData,const char *pName)
+{
+	Word8 Buffer[2][0x100];
+	Completion_t Completions[2];
+	MemoryClear(Completions,sizeof(Completions));
+
+	// Only 0x10 bytes are left, the other read is past the end
+	pQueue->ReadAsync(pFile,QUEUETESTSIZE-0x10,Buffer[0],sizeof(Buffer[0]),RecordCompletion,&Completions[0]);
+	pQueue->ReadAsync(pFile,QUEUETESTSIZE+0x10,Buffer[1],sizeof(Buffer[1]),RecordCompletion,&Completions[1]);
+	pQueue->WaitAll();
+
+	Word uTest = (Completions[0].m_uCalls!=1) || (Completions[0].m_uError!=File::OKAY) ||
+		(Completions[0].m_uTransferred!=0x10) || MemoryCompare(Buffer[0],pData+QUEUETESTSIZE-0x10,0x10);
+	Word uFailure = uTest;
+	ReportFailure("%s short read at the end, calls %u, error %u, read %u",uTest,pName,Completions[0].m_uCalls,Completions[0].m_uError,static_cast<Word>(Completions[0].m_uTransferred));
+	uTest = (Completions[1].m_uCalls!=1) || (Completions[1].m_uError!=File::OKAY) || Completions[1].m_uTransferred;
+	uFailure |= uTest;
+	ReportFailure("%s read past the end, calls %u, error %u, read %u",uTest,pName,Completions[1].m_uCalls,Completions[1].m_uError,static_cast<Word>(Completions[1].m_uTransferred));
+	return uFailure;
+}
+
+/***************************************
+
+	Write a file out of order and read it back
+
+***************************************/
+
+static Word TestRoundTrip(FileIOQueue *pQueue,const Word8 *pData,const char *pName)
+{
+	const Word uCount = (QUEUETESTSIZE/QUEUECHUNKSIZE)+1;
+	Completion_t Completions[(QUEUETESTSIZE/QUEUECHUNKSIZE)+1];
+	File FileRef;
+	Word uReturn = FileRef.Open(QUEUEOUTPUTFILE,File::WRITEONLY);
+	Word uTest = uReturn!=File::OKAY;
+	Word uFailure = uTest;
+	ReportFailure("%s File::Open(\"" QUEUEOUTPUTFILE "\",File::WRITEONLY) = %u",uTest,pName,uReturn);
+	if (!uTest) {
+		// Write the chunks backwards
+		MemoryClear(Completions,sizeof(Completions));
+		Word i = uCount;
+		do {
+			--i;
+			WordPtr uOffset = i*QUEUECHUNKSIZE;
+			WordPtr uSize = QUEUETESTSIZE-uOffset;
+			if (uSize>QUEUECHUNKSIZE) {
+				uSize = QUEUECHUNKSIZE;
+			}
+			uReturn = pQueue->WriteAsync(&FileRef,uOffset,pData+uOffset,uSize,RecordCompletion,&Completions[i]);
+			uTest = uReturn!=File::OKAY;
+			uFailure |= uTest;
+			ReportFailure("%s FileIOQueue::WriteAsync() = %u",uTest,pName,uReturn);
+		} while (i);
+		pQueue->WaitAll();
+		FileRef.Close();
+		i = 0;
+		do {
+			WordPtr uSize = QUEUETESTSIZE-(i*QUEUECHUNKSIZE);
+			if (uSize>QUEUECHUNKSIZE) {
+				uSize = QUEUECHUNKSIZE;
+			}
+			uTest = (Completions[i].m_uCalls!=1) || Completions[i].m_uError || (Completions[i].m_uTransferred!=uSize);
+			uFailure |= uTest;
+			ReportFailure("%s write %u, calls %u, error %u, wrote %u",uTest,pName,i,Completions[i].m_uCalls,Completions[i].m_uError,static_cast<Word>(Completions[i].m_uTransferred));
+		} while (++i<uCount);
+
+		// Read it back the same way
+		uReturn = FileRef.Open(QUEUEOUTPUTFILE,File::READONLY);
+		uTest = (uReturn!=File::OKAY) || (FileRef.GetSize()!=QUEUETESTSIZE);
+		uFailure |= uTest;
+		ReportFailure("%s File::Open(\"" QUEUEOUTPUTFILE "\",File::READONLY) = %u",uTest,pName,uReturn);
+		if (!uTest) {
+			Word8 *pBuffer = static_cast<Word8 *>(Alloc(uCount*QUEUECHUNKSIZE));
+			MemoryClear(Completions,sizeof(Completions));
+			i = uCount;
+			do {
+				--i;
+				pQueue->ReadAsync(&FileRef,i*QUEUECHUNKSIZE,pBuffer+(i*QUEUECHUNKSIZE),QUEUECHUNKSIZE,RecordCompletion,&Completions[i]);
+			} while (i);
+			pQueue->WaitAll();
+			FileRef.Close();
+			WordPtr uTotal = 0;
+			i = 0;
+			do {
+				uTotal += Completions[i].m_uTransferred;
+			} while (++i<uCount);
+			uTest = (uTotal!=QUEUETESTSIZE) || MemoryCompare(pBuffer,pData,QUEUETESTSIZE);
+			uFailure |= uTest;
+			ReportFailure("%s read back %u bytes written by FileIOQueue::WriteAsync()",uTest,pName,static_cast<Word>(uTotal));
+			Free(pBuffer);
+		}
+	}
+	FileManager::DeleteFile(QUEUEOUTPUTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Run all the tests with one way of performing the I/O
+
+***************************************/
+
+static Word TestBackend(const Word8 *pData,Word uFlags,const char *pName)
+{
+	FileIOQueue Queue;
+	File FileRef;
+
+	// Not initialized yet
+	Word uReturn = Queue.ReadAsync(&FileRef,0,NULL,0,NULL);
+	Word uTest = uReturn==File::OKAY;
+	Word uFailure = uTest;
+	ReportFailure("%s FileIOQueue::ReadAsync() before Init() = %u",uTest,pName,uReturn);
+
+	uReturn = Queue.Init(QUEUEDEPTH,uFlags,2);
+	FileIOQueue::eBackend eBackend = Queue.GetBackend();
+	uTest = (uReturn!=File::OKAY) || (Queue.GetDepth()!=QUEUEDEPTH);
+	if (uFlags&FileIOQueue::FLAG_NOTHREADS) {
+		uTest |= eBackend!=FileIOQueue::BACKEND_SYNCHRONOUS;
+	} else if (uFlags&FileIOQueue::FLAG_NOKERNEL) {
+#if defined(BURGER_LINUX)
+		uTest |= eBackend!=FileIOQueue::BACKEND_THREADS;
+#else
+		uTest |= (eBackend!=FileIOQueue::BACKEND_THREADS) && (eBackend!=FileIOQueue::BACKEND_SYNCHRONOUS);
+#endif
+	} else {
+#if defined(BURGER_LINUX)
+		// Kernels before 5.1 or with io_uring disabled use threads
+		if (eBackend!=FileIOQueue::BACKEND_KERNEL) {
+			Message("io_uring is not available, FileIOQueue is using %u",static_cast<Word>(eBackend));
+		}
+#endif
+		uTest |= eBackend==FileIOQueue::BACKEND_NONE;
+	}
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::Init() = %u, backend %u",uTest,pName,uReturn,static_cast<Word>(eBackend));
+	if (!uTest) {
+		// A closed file is rejected
+		uReturn = Queue.ReadAsync(&FileRef,0,NULL,0,NULL);
+		uTest = uReturn!=File::FILENOTFOUND;
+		uFailure |= uTest;
+		ReportFailure("%s FileIOQueue::ReadAsync() with a closed file = %u",uTest,pName,uReturn);
+
+		uReturn = FileRef.Open(QUEUETESTFILE,File::READONLY);
+		uTest = uReturn!=File::OKAY;
+		uFailure |= uTest;
+		ReportFailure("%s File::Open(\"" QUEUETESTFILE "\") = %u",uTest,pName,uReturn);
+		if (!uTest) {
+			g_uSeed = 0x1234;
+			uFailure |= TestBatch(&Queue,&FileRef,pData,pName);
+			uFailure |= TestExhaustion(&Queue,&FileRef,pData,pName);
+			uFailure |= TestChained(&Queue,&FileRef,pData,pName);
+			uFailure |= TestEndOfFile(&Queue,&FileRef,pData,pName);
+			FileRef.Close();
+		}
+		uFailure |= TestRoundTrip(&Queue,pData,pName);
+	}
+	Queue.Shutdown();
+	uTest = Queue.GetBackend()!=FileIOQueue::BACKEND_NONE;
+	uFailure |= uTest;
+	ReportFailure("%s FileIOQueue::Shutdown() didn't reset the backend",uTest,pName);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the FileIOQueue
+
+***************************************/
+
+int BURGER_API TestBrfileioqueue(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	FileManager::Init();
+	Message("Running FileIOQueue tests");
+
+	Word8 *pData = static_cast<Word8 *>(Alloc(QUEUETESTSIZE));
+	g_uSeed = 1;
+	Word i = 0;
+	do {
+		pData[i] = static_cast<Word8>(Random(256));
+	} while (++i<QUEUETESTSIZE);
+	Word uResult = FileManager::SaveFile(QUEUETESTFILE,pData,QUEUETESTSIZE)!=TRUE;
+	ReportFailure("FileManager::SaveFile(\"" QUEUETESTFILE "\") failed",uResult);
+	if (!uResult) {
+		uResult |= TestBackend(pData,0,"Default");
+		uResult |= TestBackend(pData,FileIOQueue::FLAG_NOKERNEL,"FLAG_NOKERNEL");
+		uResult |= TestBackend(pData,FileIOQueue::FLAG_NOKERNEL|FileIOQueue::FLAG_NOTHREADS,"FLAG_NOTHREADS");
+		FileManager::DeleteFile(QUEUETESTFILE);
+	}
+	Free(pData);
+	FileManager::Shutdown();
+	return static_cast<int>(uResult);
+}
@@ -1410,4 +1410,700 @@ Word FileManagerTest(Word uVerbose)
 	FileManager::Shutdown();
 	return uTotal;
 }
-#endif
\ No newline at end of file
+#endif
+
+#if defined(BURGER_LINUX)
+#include "brfilename.h"
+#include "brfilemanager.h"
+#include "brfile.h"
+#include "brdirectorysearch.h"
+#include "brstringfunctions.h"
+#include "brmemoryansi.h"
+#include "brpathcache.h"
+#include "brdirectorywalker.h"
+#include "brstring.h"
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace Burger;
+
+//
+// Scratch directory for the native file tests
+//
+
+#define LINUXTESTDIR "9:linuxfiletest:"
+
+static const char g_LinuxSample[] = "The quick brown fox jumps over the lazy dog.";
+
+//
+// Files created for the directory scan
+//
+
+static const char *g_LinuxFiles[3] = {
+	"alpha.txt",
+	"beta.dat",
+	".hidden"
+};
+
+/***************************************
+
+	Test File create, write, read and seek
+
+***************************************/
+
+static Word TestLinuxFile(void)
+{
+	// Create a new file
+	File FileRef;
+	Word uReturn = FileRef.Open(LINUXTESTDIR "file.bin",File::WRITEONLY);
+	Word uTest = uReturn!=File::OKAY;
+	Word uFailure = uTest;
+	ReportFailure("File::Open(\"" LINUXTESTDIR "file.bin\",File::WRITEONLY) = %u",uTest,uReturn);
+	if (!uTest) {
+		WordPtr uWritten = FileRef.Write(g_LinuxSample,sizeof(g_LinuxSample)-1);
+		uTest = uWritten!=(sizeof(g_LinuxSample)-1);
+		uFailure |= uTest;
+		ReportFailure("File::Write() = %u",uTest,static_cast<Word>(uWritten));
+		FileRef.Close();
+
+		// Read it back
+		uReturn = FileRef.Open(LINUXTESTDIR "file.bin",File::READONLY);
+		uTest = uReturn!=File::OKAY;
+		uFailure |= uTest;
+		ReportFailure("File::Open(\"" LINUXTESTDIR "file.bin\",File::READONLY) = %u",uTest,uReturn);
+		if (!uTest) {
+			WordPtr uSize = FileRef.GetSize();
+			uTest = uSize!=(sizeof(g_LinuxSample)-1);
+			uFailure |= uTest;
+			ReportFailure("File::GetSize() = %u",uTest,static_cast<Word>(uSize));
+
+			char Buffer[sizeof(g_LinuxSample)];
+			WordPtr uRead = FileRef.Read(Buffer,sizeof(g_LinuxSample)-1);
+			uTest = (uRead!=(sizeof(g_LinuxSample)-1)) || MemoryCompare(Buffer,g_LinuxSample,sizeof(g_LinuxSample)-1);
+			uFailure |= uTest;
+			ReportFailure("File::Read() = %u",uTest,static_cast<Word>(uRead));
+
+			// Reading at the end of file returns nothing
+			uRead = FileRef.Read(Buffer,1);
+			uTest = uRead!=0;
+			uFailure |= uTest;
+			ReportFailure("File::Read() at EOF = %u",uTest,static_cast<Word>(uRead));
+
+			// Seek into the middle and read
+			uReturn = FileRef.SetMark(16);
+			uTest = uReturn!=File::OKAY;
+			uFailure |= uTest;
+			ReportFailure("File::SetMark(16) = %u",uTest,uReturn);
+			WordPtr uMark = FileRef.GetMark();
+			uTest = uMark!=16;
+			uFailure |= uTest;
+			ReportFailure("File::GetMark() = %u",uTest,static_cast<Word>(uMark));
+			uRead = FileRef.Read(Buffer,3);
+			uTest = (uRead!=3) || MemoryCompare(Buffer,g_LinuxSample+16,3);
+			uFailure |= uTest;
+			ReportFailure("File::Read() after File::SetMark(16) = %u",uTest,static_cast<Word>(uRead));
+
+			// Seek to the end
+			uReturn = FileRef.SetMarkAtEOF();
+			uMark = FileRef.GetMark();
+			uTest = (uReturn!=File::OKAY) || (uMark!=(sizeof(g_LinuxSample)-1));
+			uFailure |= uTest;
+			ReportFailure("File::SetMarkAtEOF() = %u, mark %u",uTest,uReturn,static_cast<Word>(uMark));
+
+			// Positional reads don't move the mark
+			uRead = FileRef.ReadAt(4,Buffer,5);
+			uTest = (uRead!=5) || MemoryCompare(Buffer,g_LinuxSample+4,5) || (FileRef.GetMark()!=uMark);
+			uFailure |= uTest;
+			ReportFailure("File::ReadAt(4) = %u",uTest,static_cast<Word>(uRead));
+			FileRef.Close();
+		}
+
+		// Append to the file
+		uReturn = FileRef.Open(LINUXTESTDIR "file.bin",File::APPEND);
+		uTest = uReturn!=File::OKAY;
+		uFailure |= uTest;
+		ReportFailure("File::Open(\"" LINUXTESTDIR "file.bin\",File::APPEND) = %u",uTest,uReturn);
+		if (!uTest) {
+			FileRef.Write("!",1);
+			WordPtr uSize = FileRef.GetSize();
+			uTest = uSize!=sizeof(g_LinuxSample);
+			uFailure |= uTest;
+			ReportFailure("File::GetSize() after append = %u",uTest,static_cast<Word>(uSize));
+			FileRef.Close();
+		}
+	}
+
+	// Opening a missing file must fail
+	uReturn = FileRef.Open(LINUXTESTDIR "missing.bin",File::READONLY);
+	uTest = uReturn==File::OKAY;
+	uFailure |= uTest;
+	ReportFailure("File::Open(\"" LINUXTESTDIR "missing.bin\") = %u",uTest,uReturn);
+	if (uReturn==File::OKAY) {
+		FileRef.Close();
+	}
+	FileManager::DeleteFile(LINUXTESTDIR "file.bin");
+	return uFailure;
+}
+
+/***************************************
+
+	Test FileManager save, load, rename and delete
+
+***************************************/
+
+static Word TestLinuxFileManager(void)
+{
+	Word uReturn = FileManager::SaveFile(LINUXTESTDIR "sub:saved.txt",g_LinuxSample,sizeof(g_LinuxSample)-1);
+	Word uTest = uReturn!=TRUE;
+	Word uFailure = uTest;
+	ReportFailure("FileManager::SaveFile(\"" LINUXTESTDIR "sub:saved.txt\") = %u",uTest,uReturn);
+
+	uReturn = FileManager::DoesFileExist(LINUXTESTDIR "sub:saved.txt");
+	uTest = uReturn!=TRUE;
+	uFailure |= uTest;
+	ReportFailure("FileManager::DoesFileExist(\"" LINUXTESTDIR "sub:saved.txt\") = %u",uTest,uReturn);
+
+	WordPtr uLength = 0;
+	void *pData = FileManager::LoadFile(LINUXTESTDIR "sub:saved.txt",&uLength);
+	uTest = (!pData) || (uLength!=(sizeof(g_LinuxSample)-1)) || MemoryCompare(pData,g_LinuxSample,sizeof(g_LinuxSample)-1);
+	uFailure |= uTest;
+	ReportFailure("FileManager::LoadFile(\"" LINUXTESTDIR "sub:saved.txt\") = %u",uTest,static_cast<Word>(uLength));
+	Free(pData);
+
+	TimeDate_t MyTime;
+	uReturn = FileManager::GetModificationTime(LINUXTESTDIR "sub:saved.txt",&MyTime);
+	uTest = (uReturn!=File::OKAY) || (MyTime.m_uYear<2000);
+	uFailure |= uTest;
+	ReportFailure("FileManager::GetModificationTime(\"" LINUXTESTDIR "sub:saved.txt\") = %u",uTest,uReturn);
+
+	uReturn = FileManager::RenameFile(LINUXTESTDIR "sub:renamed.txt",LINUXTESTDIR "sub:saved.txt");
+	uTest = uReturn!=File::OKAY;
+	uFailure |= uTest;
+	ReportFailure("FileManager::RenameFile(\"" LINUXTESTDIR "sub:renamed.txt\") = %u",uTest,uReturn);
+	uTest = FileManager::DoesFileExist(LINUXTESTDIR "sub:saved.txt") || !FileManager::DoesFileExist(LINUXTESTDIR "sub:renamed.txt");
+	uFailure |= uTest;
+	ReportFailure("FileManager::RenameFile() didn't rename!",uTest);
+
+	uReturn = FileManager::DeleteFile(LINUXTESTDIR "sub:renamed.txt");
+	uTest = uReturn!=FALSE;
+	uFailure |= uTest;
+	ReportFailure("FileManager::DeleteFile(\"" LINUXTESTDIR "sub:renamed.txt\") = %u",uTest,uReturn);
+
+	// Second delete must fail
+	uReturn = FileManager::DeleteFile(LINUXTESTDIR "sub:renamed.txt");
+	uTest = uReturn==FALSE;
+	uFailure |= uTest;
+	ReportFailure("FileManager::DeleteFile(\"" LINUXTESTDIR "sub:renamed.txt\") (Should fail) = %u",uTest,uReturn);
+	FileManager::DeleteFile(LINUXTESTDIR "sub:");
+	return uFailure;
+}
+
+/***************************************
+
+	Test DirectorySearch enumeration
+
+***************************************/
+
+static Word TestLinuxDirectorySearch(void)
+{
+	Word i = 0;
+	do {
+		Filename MyName(LINUXTESTDIR);
+		MyName.Append(g_LinuxFiles[i]);
+		FileManager::SaveFile(&MyName,g_LinuxSample,i+1);
+	} while (++i<BURGER_ARRAYSIZE(g_LinuxFiles));
+	FileManager::CreateDirectoryPath(LINUXTESTDIR "folder:");
+
+	DirectorySearch MyDir;
+	Word uReturn = MyDir.Open(LINUXTESTDIR);
+	Word uTest = uReturn!=File::OKAY;
+	Word uFailure = uTest;
+	ReportFailure("DirectorySearch::Open(\"" LINUXTESTDIR "\") = %u",uTest,uReturn);
+
+	// Each file must be found once with the proper attributes
+	Word uFound = 0;
+	Word uFolders = 0;
+	Word uEntries = 0;
+	while (!MyDir.GetNextEntry()) {
+		++uEntries;
+		if (MyDir.m_bDir) {
+			uTest = StringCompare(MyDir.m_Name,"folder")!=0;
+			uFailure |= uTest;
+			ReportFailure("DirectorySearch::GetNextEntry() unexpected directory \"%s\"",uTest,MyDir.m_Name);
+			++uFolders;
+			continue;
+		}
+		i = 0;
+		do {
+			if (!StringCompare(MyDir.m_Name,g_LinuxFiles[i])) {
+				uTest = (uFound&(1U<<i)) || (MyDir.m_uFileSize!=(i+1)) || (MyDir.m_bHidden!=(i==2)) || MyDir.m_bLink;
+				uFailure |= uTest;
+				ReportFailure("DirectorySearch::GetNextEntry() \"%s\" size %u, hidden %u",uTest,MyDir.m_Name,static_cast<Word>(MyDir.m_uFileSize),MyDir.m_bHidden);
+				uFound |= 1U<<i;
+				break;
+			}
+		} while (++i<BURGER_ARRAYSIZE(g_LinuxFiles));
+	}
+	MyDir.Close();
+	uTest = (uFound!=7) || (uFolders!=1) || (uEntries!=4);
+	uFailure |= uTest;
+	ReportFailure("DirectorySearch::GetNextEntry() found %u entries, mask %u",uTest,uEntries,uFound);
+
+	// Filter by file extension
+	uEntries = 0;
+	if (!MyDir.Open(LINUXTESTDIR)) {
+		while (!MyDir.GetNextEntryExtension("txt")) {
+			uTest = StringCompare(MyDir.m_Name,"alpha.txt")!=0;
+			uFailure |= uTest;
+			ReportFailure("DirectorySearch::GetNextEntryExtension(\"txt\") = \"%s\"",uTest,MyDir.m_Name);
+			++uEntries;
+		}
+		MyDir.Close();
+	}
+	uTest = uEntries!=1;
+	uFailure |= uTest;
+	ReportFailure("DirectorySearch::GetNextEntryExtension(\"txt\") found %u entries",uTest,uEntries);
+
+	// A missing directory can't be opened
+	uReturn = MyDir.Open(LINUXTESTDIR "nothere:");
+	uTest = uReturn==File::OKAY;
+	uFailure |= uTest;
+	ReportFailure("DirectorySearch::Open(\"" LINUXTESTDIR "nothere:\") = %u",uTest,uReturn);
+	MyDir.Close();
+
+	i = 0;
+	do {
+		Filename MyName(LINUXTESTDIR);
+		MyName.Append(g_LinuxFiles[i]);
+		FileManager::DeleteFile(&MyName);
+	} while (++i<BURGER_ARRAYSIZE(g_LinuxFiles));
+	FileManager::DeleteFile(LINUXTESTDIR "folder:");
+	return uFailure;
+}
+
+/***************************************
+
+	Force the modification time of a directory to a
+	fixed time in the past so any change to it is seen
+
+***************************************/
+
+static void SetOldModificationTime(const char *pNative)
+{
+	struct timespec Times[2];
+	Times[0].tv_sec = 0;
+	Times[0].tv_nsec = UTIME_OMIT;
+	Times[1].tv_sec = 1000000000;
+	Times[1].tv_nsec = 0;
+	utimensat(AT_FDCWD,pNative,Times,0);
+}
+
+/***************************************
+
+	Resolve a pathname and test the case and the counters
+
+***************************************/
+
+static Word TestResolve(PathCache *pCache,const String *pDirName,const char *pName,const char *pExpected,Word32 uHits,Word32 uMisses)
+{
+	String Input(pDirName->GetPtr(),"/",pName);
+	String Output("unchanged");
+	Word bFound = pCache->Resolve(&Output,Input.GetPtr());
+	Word uTest;
+	if (pExpected) {
+		String Expected(pDirName->GetPtr(),"/",pExpected);
+		uTest = (!bFound) || (Output!=Expected);
+	} else {
+		uTest = bFound || (Output!=Input);
+	}
+	uTest |= (pCache->GetHitCount()!=uHits) || (pCache->GetMissCount()!=uMisses);
+	ReportFailure("PathCache::Resolve(\"%s\") = %u, \"%s\", hits %u, misses %u",uTest,pName,bFound,Output.GetPtr(),pCache->GetHitCount(),pCache->GetMissCount());
+	return uTest;
+}
+
+/***************************************
+
+	Test the case insensitive pathname cache
+
+***************************************/
+
+static Word TestLinuxPathCache(void)
+{
+	FileManager::SaveFile(LINUXTESTDIR "pcache:Data.TXT",g_LinuxSample,sizeof(g_LinuxSample)-1);
+	FileManager::SaveFile(LINUXTESTDIR "pcache:SubDir:Inner.Dat",g_LinuxSample,sizeof(g_LinuxSample)-1);
+	Filename DirName(LINUXTESTDIR "pcache:");
+	String NativeDir(DirName.GetNative());
+
+	PathCache MyCache;
+	MyCache.SetRevalidateTime(60000);
+	MyCache.ResetCounters();
+
+	// The first lookup reads the directory, the second is cached
+	Word uFailure = TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",0,1);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",1,1);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"subdir/INNER.DAT","SubDir/Inner.Dat",1,2);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"subdir/INNER.DAT","SubDir/Inner.Dat",2,2);
+
+	// An exact match is returned as is
+	uFailure |= TestResolve(&MyCache,&NativeDir,"Data.TXT","Data.TXT",2,3);
+
+	// Missing files are never cached, so they are always misses
+	uFailure |= TestResolve(&MyCache,&NativeDir,"missing.txt",NULL,2,4);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"missing.txt",NULL,2,5);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"nodir/data.txt",NULL,2,6);
+
+	// Rename the file so only the case changes. The cached entry
+	// is trusted until the revalidation time passes
+	String OldName(NativeDir.GetPtr(),"/Data.TXT");
+	String NewName(NativeDir.GetPtr(),"/DATA.txt");
+	SetOldModificationTime(NativeDir.GetPtr());
+	Word uTest = rename(OldName.GetPtr(),NewName.GetPtr())!=0;
+	uFailure |= uTest;
+	ReportFailure("rename(\"%s\",\"%s\") failed",uTest,OldName.GetPtr(),NewName.GetPtr());
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",3,6);
+
+	// Invalidating another file in the directory discards the
+	// listing and everything resolved through it
+	MyCache.Invalidate(OldName.GetPtr());
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","DATA.txt",3,7);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","DATA.txt",4,7);
+
+	// With no revalidation time, the directory modification time
+	// is checked on every lookup and a rename is seen
+	MyCache.SetRevalidateTime(0);
+	SetOldModificationTime(NativeDir.GetPtr());
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","DATA.txt",4,8);
+	uTest = rename(NewName.GetPtr(),OldName.GetPtr())!=0;
+	uFailure |= uTest;
+	ReportFailure("rename(\"%s\",\"%s\") failed",uTest,NewName.GetPtr(),OldName.GetPtr());
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",4,9);
+
+	// Memory use is bounded
+	WordPtr uUsed = MyCache.GetMemoryUsed();
+	uTest = !uUsed;
+	uFailure |= uTest;
+	ReportFailure("PathCache::GetMemoryUsed() = %u",uTest,static_cast<Word>(uUsed));
+	MyCache.SetMemoryLimit(1);
+	uUsed = MyCache.GetMemoryUsed();
+	uTest = uUsed!=0;
+	uFailure |= uTest;
+	ReportFailure("PathCache::SetMemoryLimit(1), GetMemoryUsed() = %u",uTest,static_cast<Word>(uUsed));
+	MyCache.SetMemoryLimit(0x100000);
+	MyCache.SetRevalidateTime(60000);
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",4,10);
+	MyCache.Purge();
+	uUsed = MyCache.GetMemoryUsed();
+	uTest = uUsed!=0;
+	uFailure |= uTest;
+	ReportFailure("PathCache::Purge(), GetMemoryUsed() = %u",uTest,static_cast<Word>(uUsed));
+	uFailure |= TestResolve(&MyCache,&NativeDir,"data.txt","Data.TXT",4,11);
+
+	FileManager::DeleteFile(LINUXTESTDIR "pcache:SubDir:Inner.Dat");
+	FileManager::DeleteFile(LINUXTESTDIR "pcache:SubDir:");
+	FileManager::DeleteFile(LINUXTESTDIR "pcache:Data.TXT");
+	FileManager::DeleteFile(LINUXTESTDIR "pcache:");
+	return uFailure;
+}
+
+/***************************************
+
+	Scratch tree for the DirectoryWalker tests
+
+***************************************/
+
+#define WALKERDIR LINUXTESTDIR "walker:"
+
+// Number of directories in the chain, deeper than DirectoryWalker::MAXDEPTH
+#define WALKERCHAIN 70
+
+enum {
+	WALK_HIDDEN=0x01,	// Only found with DirectoryWalker::FLAG_HIDDEN
+	WALK_DIR=0x02,		// Only found with DirectoryWalker::FLAG_DIRECTORIES
+	WALK_DEEP=0x04,		// Only found with DirectoryWalker::FLAG_RECURSE
+	WALK_TEXT=0x08		// Matches "*.txt"
+};
+
+struct WalkerEntry_t {
+	const char *m_pName;	// Pathname inside of WALKERDIR
+	Word m_uFlags;			// WALK_* flags
+};
+
+// Files and directories created, the links are added separately
+static const WalkerEntry_t g_WalkerEntries[] = {
+	{"a.txt",WALK_TEXT},
+	{"b.dat",0},
+	{".hidden.txt",WALK_HIDDEN|WALK_TEXT},
+	{"sub:",WALK_DIR},
+	{"sub:c.txt",WALK_DEEP|WALK_TEXT},
+	{"sub:e.dat",WALK_DEEP},
+	{"sub:.secret:",WALK_HIDDEN|WALK_DIR|WALK_DEEP},
+	{"sub:.secret:d.txt",WALK_HIDDEN|WALK_DEEP|WALK_TEXT}
+};
+
+// Symbolic links to directories, found as directories but never scanned
+static const char *g_WalkerLinks[2][2] = {
+	{"link","sub"},
+	{"loop","."}
+};
+
+#define WALKERMAXPATHS 256
+#define WALKERPATHSIZE 256
+
+struct WalkerList_t {
+	WordPtr m_uCount;		// Number of pathnames in the list
+	Word m_uFailure;		// Non zero if an entry was malformed or the list overflowed
+	char m_Paths[WALKERMAXPATHS][WALKERPATHSIZE];	// Pathnames
+};
+
+static WalkerList_t g_WalkerFound;
+static WalkerList_t g_WalkerExpected;
+
+/***************************************
+
+	Add a pathname to a list
+
+***************************************/
+
+static void AddWalkerList(WalkerList_t *pList,const char *pPath)
+{
+	WordPtr uCount = pList->m_uCount;
+	if ((uCount<WALKERMAXPATHS) && (StringLength(pPath)<WALKERPATHSIZE)) {
+		StringCopy(pList->m_Paths[uCount],WALKERPATHSIZE,pPath);
+		pList->m_uCount = uCount+1;
+	} else {
+		pList->m_uFailure = TRUE;
+	}
+}
+
+/***************************************
+
+	Record the entries passed by DirectoryWalker
+
+***************************************/
+
+static void BURGER_API RecordWalk(void *pData,const DirectoryWalker::Entry_t *pEntries,WordPtr uCount)
+{
+	WalkerList_t *pResult = static_cast<WalkerList_t *>(pData);
+	do {
+		const char *pPath = pEntries->m_pPath;
+		AddWalkerList(pResult,pPath);
+
+		// The depth is the number of directories below WALKERDIR
+		const char *pWork = pPath+(sizeof(WALKERDIR)-1);
+		Word uColons = 0;
+		char Temp;
+		while ((Temp = pWork[0])!=0) {
+			if (Temp==':') {
+				++uColons;
+			}
+			++pWork;
+		}
+		if (pEntries->m_bDir) {
+			--uColons;
+		}
+		Word uTest = StringCompare(pPath,WALKERDIR,sizeof(WALKERDIR)-1) ||
+			(pEntries->m_pName<pPath) || (pEntries->m_pName>=pWork) ||
+			(pEntries->m_uDepth!=uColons);
+		pResult->m_uFailure |= uTest;
+		ReportFailure("DirectoryWalker entry \"%s\" depth %u",uTest,pPath,pEntries->m_uDepth);
+		++pEntries;
+	} while (--uCount);
+}
+
+/***************************************
+
+	Add an expected pathname
+
+***************************************/
+
+static void AddWalkerPath(const char *pName,Word uEntryFlags,Word uFlags,Word bTextOnly)
+{
+	if ((!(uEntryFlags&WALK_HIDDEN) || (uFlags&DirectoryWalker::FLAG_HIDDEN)) &&
+		(!(uEntryFlags&WALK_DIR) || (uFlags&DirectoryWalker::FLAG_DIRECTORIES)) &&
+		(!(uEntryFlags&WALK_DEEP) || (uFlags&DirectoryWalker::FLAG_RECURSE)) &&
+		(!bTextOnly || (uEntryFlags&WALK_TEXT))) {
+		String Path(WALKERDIR,pName);
+		AddWalkerList(&g_WalkerExpected,Path);
+	}
+}
+
+/***************************************
+
+	Walk the scratch tree and compare the pathnames found
+	to the ones that should be found
+
+***************************************/
+
+static Word TestWalk(const char *pPattern,Word uFlags,Word uMaxThreads)
+{
+	// Build the list of pathnames that should be found
+	g_WalkerExpected.m_uCount = 0;
+	g_WalkerExpected.m_uFailure = FALSE;
+	Word bTextOnly = pPattern!=NULL;
+	WordPtr i = 0;
+	do {
+		AddWalkerPath(g_WalkerEntries[i].m_pName,g_WalkerEntries[i].m_uFlags,uFlags,bTextOnly);
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerEntries));
+	i = 0;
+	do {
+		String Name(g_WalkerLinks[i][0],":");
+		AddWalkerPath(Name,WALK_DIR,uFlags,bTextOnly);
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerLinks));
+
+	// Directories deeper than MAXDEPTH are found, but not scanned
+	String Chain("deep:");
+	Word uDepth = 1;
+	do {
+		AddWalkerPath(Chain,(uDepth==1) ? WALK_DIR : (WALK_DIR|WALK_DEEP),uFlags,bTextOnly);
+		if (uDepth<DirectoryWalker::MAXDEPTH) {
+			String File(Chain,"f.txt");
+			AddWalkerPath(File,WALK_DEEP|WALK_TEXT,uFlags,bTextOnly);
+		}
+		Chain.Append("d:",2);
+	} while (++uDepth<=DirectoryWalker::MAXDEPTH);
+
+	g_WalkerFound.m_uCount = 0;
+	g_WalkerFound.m_uFailure = FALSE;
+	DirectoryWalker Walker;
+	Word uReturn = Walker.Walk(WALKERDIR,pPattern,RecordWalk,&g_WalkerFound,uFlags,uMaxThreads);
+	Word uFailure = g_WalkerFound.m_uFailure|g_WalkerExpected.m_uFailure;
+	WordPtr uFound = g_WalkerFound.m_uCount;
+	WordPtr uExpected = g_WalkerExpected.m_uCount;
+	Word uTest = (uReturn!=File::OKAY) || (Walker.GetEntryCount()!=uFound);
+	uFailure |= uTest;
+	ReportFailure("DirectoryWalker::Walk(\"%s\",0x%X,%u) = %u, entries %u",uTest,pPattern ? pPattern : "NULL",uFlags,uMaxThreads,uReturn,Walker.GetEntryCount());
+
+	// Every pathname must be found exactly once
+	uTest = uFound!=uExpected;
+	uFailure |= uTest;
+	ReportFailure("DirectoryWalker::Walk(\"%s\",0x%X,%u) found %u entries, expected %u",uTest,pPattern ? pPattern : "NULL",uFlags,uMaxThreads,static_cast<Word>(uFound),static_cast<Word>(uExpected));
+	i = 0;
+	if (uExpected) {
+		do {
+			Word uMatches = 0;
+			WordPtr j = 0;
+			if (uFound) {
+				do {
+					if (!StringCompare(g_WalkerExpected.m_Paths[i],g_WalkerFound.m_Paths[j])) {
+						++uMatches;
+					}
+				} while (++j<uFound);
+			}
+			uTest = uMatches!=1;
+			uFailure |= uTest;
+			ReportFailure("DirectoryWalker::Walk(\"%s\",0x%X,%u) found \"%s\" %u times",uTest,pPattern ? pPattern : "NULL",uFlags,uMaxThreads,g_WalkerExpected.m_Paths[i],uMatches);
+		} while (++i<uExpected);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test DirectoryWalker with one and several threads
+
+***************************************/
+
+static Word TestLinuxDirectoryWalker(void)
+{
+	// Create the scratch tree
+	WordPtr i = 0;
+	do {
+		const char *pName = g_WalkerEntries[i].m_pName;
+		String Path(WALKERDIR,pName);
+		if (g_WalkerEntries[i].m_uFlags&WALK_DIR) {
+			FileManager::CreateDirectoryPath(Path);
+		} else {
+			FileManager::SaveFile(Path,g_LinuxSample,sizeof(g_LinuxSample)-1);
+		}
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerEntries));
+	String Chain(WALKERDIR "deep:");
+	Word uDepth = 0;
+	do {
+		FileManager::CreateDirectoryPath(Chain);
+		String File(Chain,"f.txt");
+		FileManager::SaveFile(File,g_LinuxSample,sizeof(g_LinuxSample)-1);
+		Chain.Append("d:",2);
+	} while (++uDepth<WALKERCHAIN);
+	Filename DirName(WALKERDIR);
+	String NativeDir(DirName.GetNative());
+	i = 0;
+	do {
+		String LinkName(NativeDir.GetPtr(),"/",g_WalkerLinks[i][0]);
+		symlink(g_WalkerLinks[i][1],LinkName);
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerLinks));
+
+	// Every combination of flags, with the pattern and without,
+	// with one thread and with several
+	static const Word g_WalkerFlags[5] = {
+		0,
+		DirectoryWalker::FLAG_RECURSE,
+		DirectoryWalker::FLAG_RECURSE|DirectoryWalker::FLAG_HIDDEN,
+		DirectoryWalker::FLAG_RECURSE|DirectoryWalker::FLAG_DIRECTORIES,
+		DirectoryWalker::FLAG_RECURSE|DirectoryWalker::FLAG_DIRECTORIES|DirectoryWalker::FLAG_HIDDEN
+	};
+	Word uFailure = FALSE;
+	i = 0;
+	do {
+		uFailure |= TestWalk(NULL,g_WalkerFlags[i],1);
+		uFailure |= TestWalk(NULL,g_WalkerFlags[i],4);
+		uFailure |= TestWalk("*.txt",g_WalkerFlags[i],1);
+		uFailure |= TestWalk("*.txt",g_WalkerFlags[i],4);
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerFlags));
+
+	// A missing directory is an error
+	g_WalkerFound.m_uCount = 0;
+	DirectoryWalker Walker;
+	Word uReturn = Walker.Walk(WALKERDIR "nothere:",NULL,RecordWalk,&g_WalkerFound);
+	Word uTest = (uReturn!=File::FILENOTFOUND) || g_WalkerFound.m_uCount;
+	uFailure |= uTest;
+	ReportFailure("DirectoryWalker::Walk(\"" WALKERDIR "nothere:\") = %u",uTest,uReturn);
+
+	// Dispose of the tree, deepest first
+	i = 0;
+	do {
+		String LinkName(NativeDir.GetPtr(),"/",g_WalkerLinks[i][0]);
+		unlink(LinkName);
+	} while (++i<BURGER_ARRAYSIZE(g_WalkerLinks));
+	do {
+		Chain = String(Chain.GetPtr(),0,Chain.GetLength()-2);
+		String File(Chain,"f.txt");
+		FileManager::DeleteFile(File);
+		FileManager::DeleteFile(Chain);
+	} while (--uDepth);
+	i = BURGER_ARRAYSIZE(g_WalkerEntries);
+	do {
+		--i;
+		String Path(WALKERDIR,g_WalkerEntries[i].m_pName);
+		FileManager::DeleteFile(Path);
+	} while (i);
+	FileManager::DeleteFile(WALKERDIR);
+	return uFailure;
+}
+#endif
+
+/***************************************
+
+	Test the native file system backend
+
+***************************************/
+
+int BURGER_API TestBrfilemanager(void)
+{
+	Word uResult = FALSE;
+#if defined(BURGER_LINUX)
+	MemoryManagerGlobalANSI Memory;
+	FileManager::Init();
+	Message("Running Linux File tests");
+	FileManager::CreateDirectoryPath(LINUXTESTDIR);
+	uResult = TestLinuxFile();
+	uResult |= TestLinuxFileManager();
+	uResult |= TestLinuxDirectorySearch();
+	uResult |= TestLinuxPathCache();
+	uResult |= TestLinuxDirectoryWalker();
+	FileManager::DeleteFile(LINUXTESTDIR);
+	FileManager::Shutdown();
+#endif
+	return static_cast<int>(uResult);
+}
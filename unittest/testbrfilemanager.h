@@ -19,5 +19,6 @@
 #endif
 
 extern Word FileManagerTest(Word uVerbose);
+extern int BURGER_API TestBrfilemanager(void);
 
 #endif
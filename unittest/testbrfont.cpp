@@ -0,0 +1,429 @@
+/***************************************
+
+	Unit tests for the fonts
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrfont.h"
+#include "common.h"
+#include "brfont4bit.h"
+#include "brrenderersoftware8.h"
+#include "brrenderersoftware16.h"
+#include "brrenderersoftware32.h"
+#include "brrezfile.h"
+#include "brfilemanager.h"
+#include "brmemoryhandle.h"
+#include "brmemoryansi.h"
+#include "brendian.h"
+#include "brstringfunctions.h"
+
+using namespace Burger;
+
+//
+// Scratch file for the font resource
+//
+
+#define FONTTESTFILE "9:testbrfont.rez"
+
+//
+// Size of the test frame buffer
+//
+
+static const Word cTestWidth = 71;
+static const Word cTestHeight = 29;
+
+//
+// Layout of the test font, characters 'A' through 'E'
+//
+
+static const Word cFontRezNum = 10;
+static const Word cFontFirst = 'A';
+static const Word cFontCount = 5;
+static const Word cFontHeight = 7;
+static const Word cFontMaxWidth = 8;
+static const Word8 g_FontWidths[cFontCount] = {3,4,6,1,7};
+
+//
+// Color index of every pixel of every glyph
+//
+
+static Word8 g_FontPixels[cFontCount][cFontHeight][cFontMaxWidth];
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word GetRandom(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return static_cast<Word>((g_uSeed>>16U)%uRange);
+}
+
+/***************************************
+
+	Create a Font4Bit resource image from g_FontPixels
+
+	\param pOutput Buffer to receive the font, 512 bytes is plenty
+	\return Size of the font in bytes
+
+***************************************/
+
+static WordPtr CreateFontData(Word8 *pOutput)
+{
+	// Fill in random glyphs, with a third of the pixels transparent
+	Word i = 0;
+	do {
+		Word y = 0;
+		do {
+			Word x = 0;
+			do {
+				Word uColor = GetRandom(16);
+				if (!GetRandom(3)) {
+					uColor = 0;
+				}
+				g_FontPixels[i][y][x] = static_cast<Word8>(uColor);
+			} while (++x<cFontMaxWidth);
+		} while (++y<cFontHeight);
+	} while (++i<cFontCount);
+
+	// Header, the data is little endian
+	pOutput[0] = static_cast<Word8>(cFontHeight);
+	pOutput[1] = 0;
+	pOutput[2] = static_cast<Word8>(cFontCount);
+	pOutput[3] = 0;
+	pOutput[4] = static_cast<Word8>(cFontFirst);
+	pOutput[5] = 0;
+	MemoryCopy(pOutput+6,g_FontWidths,cFontCount);
+
+	// Offsets are from the start of the offset table
+	Word8 *pIndexes = pOutput+6+cFontCount;
+	Word8 *pWork = pIndexes+((cFontCount+1)*2);
+	i = 0;
+	do {
+		WordPtr uOffset = static_cast<WordPtr>(pWork-pIndexes);
+		pIndexes[i*2] = static_cast<Word8>(uOffset);
+		pIndexes[(i*2)+1] = static_cast<Word8>(uOffset>>8U);
+		// Two pixels per byte, the left pixel is the high nibble
+		Word y = 0;
+		do {
+			Word x = 0;
+			do {
+				pWork[0] = static_cast<Word8>((g_FontPixels[i][y][x]<<4U)|g_FontPixels[i][y][x+1]);
+				++pWork;
+				x+=2;
+			} while (x<g_FontWidths[i]);
+		} while (++y<cFontHeight);
+	} while (++i<cFontCount);
+
+	// Default color list, one color
+	WordPtr uOffset = static_cast<WordPtr>(pWork-pIndexes);
+	pIndexes[cFontCount*2] = static_cast<Word8>(uOffset);
+	pIndexes[(cFontCount*2)+1] = static_cast<Word8>(uOffset>>8U);
+	pWork[0] = 1;
+	pWork[1] = 255;
+	pWork[2] = 255;
+	pWork[3] = 255;
+	pWork+=4;
+	return static_cast<WordPtr>(pWork-pOutput);
+}
+
+/***************************************
+
+	Draw a string one pixel at a time
+
+***************************************/
+
+struct FontReference_t {
+	Word8 *m_pBuffer;			// Reference frame buffer
+	Word m_uPixelSize;			// Bytes per pixel
+	Word m_uInvisibleColor;		// Color index that isn't drawn
+	int m_iClipLeft;			// Clip rect
+	int m_iClipTop;
+	int m_iClipRight;
+	int m_iClipBottom;
+	Word32 m_Colors[16];		// Color table
+};
+
+static int ReferenceDraw(const FontReference_t *pReference,int iX,int iY,const char *pInput,WordPtr uLength)
+{
+	do {
+		Word uLetter = reinterpret_cast<const Word8 *>(pInput)[0]-cFontFirst;
+		++pInput;
+		if (uLetter<cFontCount) {
+			Word uWidth = g_FontWidths[uLetter];
+			Word y = 0;
+			do {
+				int iPixelY = iY+static_cast<int>(y);
+				if ((iPixelY<pReference->m_iClipTop) || (iPixelY>=pReference->m_iClipBottom)) {
+					continue;
+				}
+				Word x = 0;
+				do {
+					int iPixelX = iX+static_cast<int>(x);
+					Word uColor = g_FontPixels[uLetter][y][x];
+					if ((iPixelX<pReference->m_iClipLeft) || (iPixelX>=pReference->m_iClipRight) ||
+						(uColor==pReference->m_uInvisibleColor)) {
+						continue;
+					}
+					Word8 *pDest = pReference->m_pBuffer+(((iPixelY*static_cast<int>(cTestWidth))+iPixelX)*static_cast<int>(pReference->m_uPixelSize));
+					switch (pReference->m_uPixelSize) {
+					case 1:
+						pDest[0] = static_cast<Word8>(pReference->m_Colors[uColor]);
+						break;
+					case 2:
+						reinterpret_cast<Word16 *>(pDest)[0] = static_cast<Word16>(pReference->m_Colors[uColor]);
+						break;
+					default:
+						reinterpret_cast<Word32 *>(pDest)[0] = pReference->m_Colors[uColor];
+						break;
+					}
+				} while (++x<uWidth);
+			} while (++y<cFontHeight);
+			iX += static_cast<int>(uWidth);
+		}
+	} while (--uLength);
+	return iX;
+}
+
+/***************************************
+
+	Draw random strings with Font4Bit and compare
+	against the reference. Colors, the transparency mode and
+	the clip rect are changed between strings so the
+	glyph cache must be rebuilt to stay correct.
+
+***************************************/
+
+static Word TestFont4BitDepth(RezFile *pRezFile,Word uDepth)
+{
+	Word uPixelSize = uDepth>>3U;
+	WordPtr uBufferSize = cTestWidth*cTestHeight*uPixelSize;
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(uBufferSize));
+	Word8 *pReferenceBuffer = static_cast<Word8 *>(Alloc(uBufferSize));
+	if (!pBuffer || !pReferenceBuffer) {
+		Free(pReferenceBuffer);
+		Free(pBuffer);
+		ReportFailure("Out of memory in TestFont4BitDepth()",TRUE);
+		return TRUE;
+	}
+	RendererSoftware8 Renderer8;
+	RendererSoftware16 Renderer16;
+	RendererSoftware32 Renderer32;
+	Renderer *pRenderer;
+	if (uDepth==8) {
+		pRenderer = &Renderer8;
+	} else if (uDepth==16) {
+		pRenderer = &Renderer16;
+	} else {
+		pRenderer = &Renderer32;
+	}
+	pRenderer->Init(cTestWidth,cTestHeight,uDepth,0);
+	pRenderer->SetFrameBuffer(pBuffer);
+	pRenderer->SetStride(cTestWidth*uPixelSize);
+
+	g_uSeed = 0x4F4E54U+uDepth;
+	Word i = 0;
+	do {
+		pBuffer[i] = static_cast<Word8>(GetRandom(256));
+	} while (++i<uBufferSize);
+	MemoryCopy(pReferenceBuffer,pBuffer,uBufferSize);
+
+	FontReference_t Reference;
+	Reference.m_pBuffer = pReferenceBuffer;
+	Reference.m_uPixelSize = uPixelSize;
+	Reference.m_uInvisibleColor = 0;
+	Reference.m_iClipLeft = 0;
+	Reference.m_iClipTop = 0;
+	Reference.m_iClipRight = static_cast<int>(cTestWidth);
+	Reference.m_iClipBottom = static_cast<int>(cTestHeight);
+
+	Font4Bit MyFont(pRenderer);
+	MyFont.Init(pRezFile,cFontRezNum,NULL);
+	Word uFailure = (MyFont.GetHeight()!=cFontHeight) || (MyFont.GetFirstChar()!=cFontFirst) || (MyFont.GetCount()!=cFontCount);
+	ReportFailure("Font4Bit::Init() %u bit height %u, first %u, count %u",uFailure,uDepth,MyFont.GetHeight(),MyFont.GetFirstChar(),MyFont.GetCount());
+	if (!uFailure) {
+		Word32 uColorMask = (uDepth==8) ? 0xFFU : ((uDepth==16) ? 0xFFFFU : 0xFFFFFFFFU);
+		i = 0;
+		do {
+			Word32 uColor = ((static_cast<Word32>(GetRandom(0x10000))<<16U)|GetRandom(0x10000))&uColorMask;
+			Reference.m_Colors[i] = uColor;
+			MyFont.SetColor(i,uColor);
+		} while (++i<16);
+
+		static const char g_Letters[] = "@ABCDEFG";
+		const char *pChange = "none";
+		i = 0;
+		do {
+			// Change the state between strings
+			switch (GetRandom(6)) {
+			case 0:
+				{
+					Word uIndex = GetRandom(16);
+					Word32 uColor = ((static_cast<Word32>(GetRandom(0x10000))<<16U)|GetRandom(0x10000))&uColorMask;
+					Reference.m_Colors[uIndex] = uColor;
+					MyFont.SetColor(uIndex,uColor);
+					pChange = "SetColor()";
+				}
+				break;
+			case 1:
+				if (Reference.m_uInvisibleColor) {
+					MyFont.UseMask();
+					Reference.m_uInvisibleColor = 0;
+					pChange = "UseMask()";
+				} else {
+					MyFont.UseZero();
+					Reference.m_uInvisibleColor = 0x7FFF;
+					pChange = "UseZero()";
+				}
+				break;
+			case 2:
+				Reference.m_iClipLeft = static_cast<int>(GetRandom(cTestWidth-1));
+				Reference.m_iClipRight = Reference.m_iClipLeft+1+static_cast<int>(GetRandom(cTestWidth-static_cast<Word>(Reference.m_iClipLeft)));
+				Reference.m_iClipTop = static_cast<int>(GetRandom(cTestHeight-1));
+				Reference.m_iClipBottom = Reference.m_iClipTop+1+static_cast<int>(GetRandom(cTestHeight-static_cast<Word>(Reference.m_iClipTop)));
+				pRenderer->SetClip(Reference.m_iClipLeft,Reference.m_iClipTop,Reference.m_iClipRight,Reference.m_iClipBottom);
+				pChange = "SetClip()";
+				break;
+			default:
+				pChange = "none";
+				break;
+			}
+
+			// Create a string with some characters that aren't in the font
+			char String[9];
+			WordPtr uLength = GetRandom(8)+1;
+			Word uWidth = 0;
+			WordPtr j = 0;
+			do {
+				char cLetter = g_Letters[GetRandom(sizeof(g_Letters)-1)];
+				String[j] = cLetter;
+				Word uLetter = static_cast<Word>(cLetter)-cFontFirst;
+				if (uLetter<cFontCount) {
+					uWidth += g_FontWidths[uLetter];
+				}
+			} while (++j<uLength);
+			String[uLength] = 0;
+			int iX = static_cast<int>(GetRandom(cTestWidth+40))-30;
+			int iY = static_cast<int>(GetRandom(cTestHeight+16))-10;
+
+			Word uPixelWidth = MyFont.GetPixelWidth(String,uLength);
+			Word uTest = uPixelWidth!=uWidth;
+			uFailure |= uTest;
+			ReportFailure("Font4Bit::GetPixelWidth(\"%s\") = %u, expected %u",uTest,String,uPixelWidth,uWidth);
+
+			// Draw the whole string or a character at a time
+			Word bPerChar = GetRandom(2);
+			MyFont.SetXY(iX,iY);
+			if (bPerChar) {
+				j = 0;
+				do {
+					MyFont.DrawChar(reinterpret_cast<const Word8 *>(String)[j]);
+				} while (++j<uLength);
+			} else {
+				MyFont.Draw(String,uLength);
+			}
+			int iEndX = ReferenceDraw(&Reference,iX,iY,String,uLength);
+			uTest = (MyFont.GetX()!=iEndX) || MemoryCompare(pBuffer,pReferenceBuffer,uBufferSize);
+			uFailure |= uTest;
+			ReportFailure("Font4Bit %u bit %s(\"%s\") at %d,%d after %s",uTest,uDepth,bPerChar ? "DrawChar" : "Draw",String,iX,iY,pChange);
+			if (uTest) {
+				// Resync to prevent cascading failures
+				MemoryCopy(pReferenceBuffer,pBuffer,uBufferSize);
+			}
+		} while (++i<500);
+		MyFont.Shutdown();
+	}
+	Free(pReferenceBuffer);
+	Free(pBuffer);
+	return uFailure;
+}
+
+/***************************************
+
+	Save the font data as a rez file with a
+	single uncompressed resource, cFontRezNum.
+	Return non-zero on error
+
+***************************************/
+
+static Word SaveFontRezFile(const Word8 *pFontData,WordPtr uFontSize)
+{
+	// Root header, one group and its only entry
+	Word32 Header[(RezFile::ROOTHEADERSIZE/4)+6];
+	MemoryCopy(&Header[0],RezFile::g_RezFileSignature,4);
+	Header[1] = 1;									// Group count
+	Header[2] = static_cast<Word32>(sizeof(Word32)*6);	// Size of the groups and entries
+	MemoryCopy(&Header[3],"LZSSDFLTRLE ",12);		// Version 1 codec names
+	Header[6] = cFontRezNum;						// Base resource number
+	Header[7] = 1;									// Entries in the group
+	Header[8] = static_cast<Word32>(sizeof(Header));	// File offset
+	Header[9] = static_cast<Word32>(uFontSize);		// Length
+	Header[10] = 0;									// No name, not compressed
+	Header[11] = static_cast<Word32>(uFontSize);	// Length in the file
+	LittleEndian::Fixup(&Header[1]);
+	LittleEndian::Fixup(&Header[2]);
+	Word i = 6;
+	do {
+		LittleEndian::Fixup(&Header[i]);
+	} while (++i<BURGER_ARRAYSIZE(Header));
+
+	Word8 Buffer[sizeof(Header)+512];
+	MemoryCopy(Buffer,Header,sizeof(Header));
+	MemoryCopy(Buffer+sizeof(Header),pFontData,uFontSize);
+	return !FileManager::SaveFile(FONTTESTFILE,Buffer,sizeof(Header)+uFontSize);
+}
+
+/***************************************
+
+	Test the Font4Bit glyph cache
+
+***************************************/
+
+static Word TestFont4Bit(MemoryManagerHandle *pHandles)
+{
+	Word8 FontData[512];
+	g_uSeed = 0x464F4E54U;
+	WordPtr uFontSize = CreateFontData(FontData);
+	Word uFailure = SaveFontRezFile(FontData,uFontSize);
+	ReportFailure("SaveFontRezFile(\"" FONTTESTFILE "\") = %u",uFailure,uFailure);
+	if (!uFailure) {
+		RezFile MyRez(pHandles);
+		uFailure = MyRez.Init(FONTTESTFILE);
+		ReportFailure("RezFile::Init(\"" FONTTESTFILE "\") = %u",uFailure,uFailure);
+		if (!uFailure) {
+			MyRez.SetExternalFlag(FALSE);
+			uFailure |= TestFont4BitDepth(&MyRez,8);
+			uFailure |= TestFont4BitDepth(&MyRez,16);
+			uFailure |= TestFont4BitDepth(&MyRez,32);
+			MyRez.Shutdown();
+		}
+	}
+	FileManager::DeleteFile(FONTTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the fonts
+
+***************************************/
+
+int BURGER_API TestBrfont(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	MemoryManagerGlobalHandle Handles(0x100000);
+	FileManager::Init();
+	Message("Running Font tests");
+	Word uResult = TestFont4Bit(&Handles);
+	FileManager::Shutdown();
+	return static_cast<int>(uResult);
+}
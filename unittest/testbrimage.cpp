@@ -0,0 +1,618 @@
+/***************************************
+
+	Unit tests for the Image class
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrimage.h"
+#include "common.h"
+#include "brimage.h"
+#include "brfloatingpoint.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryansi.h"
+#include "brstringfunctions.h"
+
+using namespace Burger;
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word GetRandom(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return static_cast<Word>((g_uSeed>>16U)%uRange);
+}
+
+//
+// Pixel types that can be resampled
+//
+
+static const Image::ePixelTypes g_ResizeTypes[3] = {
+	Image::PIXELTYPE8888,
+	Image::PIXELTYPE888,
+	Image::PIXELTYPE565
+};
+
+static const char *g_ResizeTypeNames[3] = {
+	"8888",
+	"888",
+	"565"
+};
+
+static const char *g_FilterNames[4] = {
+	"FILTER_BOX",
+	"FILTER_BOXGAMMA",
+	"FILTER_KAISER",
+	"FILTER_LANCZOS"
+};
+
+//
+// Most input pixels a single output pixel can use in the tests
+//
+
+static const Word cMaxTaps = 64;
+
+/***************************************
+
+	Fill every level of an image with random pixels
+
+***************************************/
+
+static void FillRandom(Image *pImage)
+{
+	Word i = 0;
+	Word uMipMaps = pImage->GetMipMapCount();
+	do {
+		Word8 *pWork = const_cast<Word8 *>(pImage->GetImage(i));
+		WordPtr uSize = pImage->GetImageSize(i);
+		do {
+			pWork[0] = static_cast<Word8>(GetRandom(256));
+			++pWork;
+		} while (--uSize);
+	} while (++i<uMipMaps);
+}
+
+/***************************************
+
+	Read a pixel as red, green, blue and alpha bytes,
+	565 pixels are expanded so 0x1F becomes 0xFF
+
+***************************************/
+
+static void ReadPixel(const Image *pImage,Word uMipMap,Word uX,Word uY,Word *pOutput)
+{
+	const Word8 *pInput = pImage->GetImage(uMipMap)+(uY*pImage->GetStride(uMipMap));
+	switch (pImage->GetType()) {
+	case Image::PIXELTYPE8888:
+		pInput += uX*4;
+		pOutput[0] = pInput[0];
+		pOutput[1] = pInput[1];
+		pOutput[2] = pInput[2];
+		pOutput[3] = pInput[3];
+		break;
+	case Image::PIXELTYPE888:
+		pInput += uX*3;
+		pOutput[0] = pInput[0];
+		pOutput[1] = pInput[1];
+		pOutput[2] = pInput[2];
+		pOutput[3] = 255;
+		break;
+	default:
+		{
+			Word uColor = reinterpret_cast<const Word16 *>(pInput)[uX];
+			Word uRed = (uColor>>11U)&0x1FU;
+			Word uGreen = (uColor>>5U)&0x3FU;
+			Word uBlue = uColor&0x1FU;
+			pOutput[0] = (uRed<<3U)|(uRed>>2U);
+			pOutput[1] = (uGreen<<2U)|(uGreen>>4U);
+			pOutput[2] = (uBlue<<3U)|(uBlue>>2U);
+			pOutput[3] = 255;
+		}
+		break;
+	}
+}
+
+/***************************************
+
+	Read a pixel without expanding 565 pixels, so the
+	values are in the same units the image stores them
+
+***************************************/
+
+static Word ReadFields(const Image *pImage,Word uMipMap,Word uX,Word uY,Word *pOutput)
+{
+	if (pImage->GetType()!=Image::PIXELTYPE565) {
+		ReadPixel(pImage,uMipMap,uX,uY,pOutput);
+		return (pImage->GetType()==Image::PIXELTYPE8888) ? 4U : 3U;
+	}
+	Word uColor = reinterpret_cast<const Word16 *>(pImage->GetImage(uMipMap)+(uY*pImage->GetStride(uMipMap)))[uX];
+	pOutput[0] = (uColor>>11U)&0x1FU;
+	pOutput[1] = (uColor>>5U)&0x3FU;
+	pOutput[2] = uColor&0x1FU;
+	return 3;
+}
+
+/***************************************
+
+	Scalar version of the resampling filters, computed in
+	double precision without any of the optimizations
+	in the Image class
+
+***************************************/
+
+static double ReferenceSinc(double dInput)
+{
+	if (dInput==0.0) {
+		return 1.0;
+	}
+	dInput = dInput*g_dPi;
+	return Sin(dInput)/dInput;
+}
+
+static double ReferenceBesselI0(double dInput)
+{
+	double dSum = 1.0;
+	double dTerm = 1.0;
+	Word i = 1;
+	do {
+		double dTemp = (dInput*0.5)/static_cast<double>(i);
+		dTerm = dTerm*dTemp*dTemp;
+		dSum += dTerm;
+	} while (++i<25);
+	return dSum;
+}
+
+static double ReferenceKernel(Image::eFilter eFilterType,double dInput)
+{
+	double dAbs = (dInput<0.0) ? -dInput : dInput;
+	if ((eFilterType==Image::FILTER_BOX) || (eFilterType==Image::FILTER_BOXGAMMA)) {
+		return ((dInput>=-0.5) && (dInput<0.5)) ? 1.0 : 0.0;
+	}
+	if (dAbs>=3.0) {
+		return 0.0;
+	}
+	if (eFilterType==Image::FILTER_KAISER) {
+		double dRatio = dAbs/3.0;
+		return ReferenceSinc(dInput)*ReferenceBesselI0(4.0*Sqrt(1.0-(dRatio*dRatio)))/ReferenceBesselI0(4.0);
+	}
+	return ReferenceSinc(dInput)*ReferenceSinc(dInput/3.0);
+}
+
+//
+// Find the input pixels and normalized weights for one output pixel
+//
+
+static Word ReferenceWeights(Word uInput,Word uOutput,Word uIndex,Image::eFilter eFilterType,Word *pStart,double *pWeights)
+{
+	double dScale = static_cast<double>(uOutput)/static_cast<double>(uInput);
+	double dSupport = ((eFilterType==Image::FILTER_BOX) || (eFilterType==Image::FILTER_BOXGAMMA)) ? 0.5 : 3.0;
+	double dFilterScale = 1.0;
+	if (dScale<1.0) {
+		dSupport = dSupport/dScale;
+		dFilterScale = dScale;
+	}
+	double dCenter = ((static_cast<double>(uIndex)+0.5)/dScale)-0.5;
+	Int iFirst = static_cast<Int>(Floor(dCenter-dSupport));
+	Int iLast = static_cast<Int>(Ceil(dCenter+dSupport));
+	if (iFirst<0) {
+		iFirst = 0;
+	}
+	if (iLast>=static_cast<Int>(uInput)) {
+		iLast = static_cast<Int>(uInput)-1;
+	}
+	Word uCount = static_cast<Word>(iLast-iFirst)+1;
+	double dTotal = 0.0;
+	Word i = 0;
+	do {
+		double dWeight = ReferenceKernel(eFilterType,(static_cast<double>(iFirst+static_cast<Int>(i))-dCenter)*dFilterScale);
+		pWeights[i] = dWeight;
+		dTotal += dWeight;
+	} while (++i<uCount);
+	if (dTotal==0.0) {
+		// Filter landed between pixels, use the nearest one
+		Int iNearest = static_cast<Int>(dCenter+0.5);
+		if (iNearest<0) {
+			iNearest = 0;
+		} else if (iNearest>=static_cast<Int>(uInput)) {
+			iNearest = static_cast<Int>(uInput)-1;
+		}
+		pStart[0] = static_cast<Word>(iNearest);
+		pWeights[0] = 1.0;
+		return 1;
+	}
+	i = 0;
+	do {
+		pWeights[i] = pWeights[i]/dTotal;
+	} while (++i<uCount);
+	pStart[0] = static_cast<Word>(iFirst);
+	return uCount;
+}
+
+//
+// Convert a 0.0 to 1.0 value into the units the pixel type stores
+//
+
+static Word ReferenceToByte(double dInput)
+{
+	if (dInput<=0.0) {
+		return 0;
+	}
+	if (dInput>=1.0) {
+		return 255;
+	}
+	return static_cast<Word>((dInput*255.0)+0.5);
+}
+
+/***************************************
+
+	Compare a resampled image against the scalar reference,
+	each color component must be within 1 of the reference
+
+***************************************/
+
+static Word CompareResample(const Image *pOutput,Word uOutputMip,const Image *pInput,Word uInputMip,Image::eFilter eFilterType,const char *pTest)
+{
+	Word uInputWidth = pInput->GetWidth(uInputMip);
+	Word uInputHeight = pInput->GetHeight(uInputMip);
+	Word uOutputWidth = pOutput->GetWidth(uOutputMip);
+	Word uOutputHeight = pOutput->GetHeight(uOutputMip);
+	double XWeights[cMaxTaps];
+	double YWeights[cMaxTaps];
+	Word uY = 0;
+	do {
+		Word uYStart;
+		Word uYCount = ReferenceWeights(uInputHeight,uOutputHeight,uY,eFilterType,&uYStart,YWeights);
+		Word uX = 0;
+		do {
+			Word uXStart;
+			Word uXCount = ReferenceWeights(uInputWidth,uOutputWidth,uX,eFilterType,&uXStart,XWeights);
+			double Sum[4] = {0.0,0.0,0.0,0.0};
+			Word j = 0;
+			do {
+				Word i = 0;
+				do {
+					Word Pixel[4];
+					ReadPixel(pInput,uInputMip,uXStart+i,uYStart+j,Pixel);
+					double dWeight = XWeights[i]*YWeights[j];
+					Word k = 0;
+					do {
+						Sum[k] += dWeight*(static_cast<double>(Pixel[k])/255.0);
+					} while (++k<4);
+				} while (++i<uXCount);
+			} while (++j<uYCount);
+
+			Word Expected[4];
+			Word k = 0;
+			do {
+				Expected[k] = ReferenceToByte(Sum[k]);
+			} while (++k<4);
+			if (pOutput->GetType()==Image::PIXELTYPE565) {
+				Expected[0] = ((Expected[0]*31U)+127U)/255U;
+				Expected[1] = ((Expected[1]*63U)+127U)/255U;
+				Expected[2] = ((Expected[2]*31U)+127U)/255U;
+			}
+			Word Actual[4];
+			Word uCount = ReadFields(pOutput,uOutputMip,uX,uY,Actual);
+			k = 0;
+			do {
+				Int iDelta = static_cast<Int>(Actual[k])-static_cast<Int>(Expected[k]);
+				if ((iDelta<-1) || (iDelta>1)) {
+					ReportFailure("%s %s %ux%u to %ux%u pixel %u,%u component %u = %u, expected %u",TRUE,
+						pTest,g_FilterNames[eFilterType],uInputWidth,uInputHeight,uOutputWidth,uOutputHeight,uX,uY,k,Actual[k],Expected[k]);
+					return TRUE;
+				}
+			} while (++k<uCount);
+		} while (++uX<uOutputWidth);
+	} while (++uY<uOutputHeight);
+	return FALSE;
+}
+
+/***************************************
+
+	Test the 2x2 box filter mip maps against an exact
+	integer average of each block
+
+***************************************/
+
+struct MipMapSize_t {
+	Word m_uWidth;		// Width of the top level
+	Word m_uHeight;		// Height of the top level
+	Word m_uMipMaps;	// Number of levels
+};
+
+static const MipMapSize_t g_MipMapSizes[] = {
+	{24,12,4},		// Odd widths use the scalar tail of the SIMD code
+	{64,2,2},
+	{256,256,3}		// Large enough to use multiple threads
+};
+
+static Word TestMipMapBox(void)
+{
+	Word uFailure = FALSE;
+	Word uType = 0;
+	do {
+		Word uSize = 0;
+		do {
+			const MipMapSize_t *pSize = &g_MipMapSizes[uSize];
+			Image MyImage;
+			Word uResult = MyImage.Init(pSize->m_uWidth,pSize->m_uHeight,g_ResizeTypes[uType],pSize->m_uMipMaps);
+			if (uResult) {
+				ReportFailure("Image::Init(%u,%u,%s,%u) = %u",TRUE,pSize->m_uWidth,pSize->m_uHeight,g_ResizeTypeNames[uType],pSize->m_uMipMaps,uResult);
+				uFailure = TRUE;
+				continue;
+			}
+			g_uSeed = uSize+(uType*16);
+			FillRandom(&MyImage);
+			uResult = MyImage.GenerateMipMaps(Image::FILTER_BOX);
+			Word uTest = uResult!=0;
+			uFailure |= uTest;
+			ReportFailure("Image::GenerateMipMaps(FILTER_BOX) %s = %u",uTest,g_ResizeTypeNames[uType],uResult);
+
+			Word uLevel = 1;
+			do {
+				Word uWidth = MyImage.GetWidth(uLevel);
+				Word uHeight = MyImage.GetHeight(uLevel);
+				uTest = FALSE;
+				Word uY = 0;
+				do {
+					Word uX = 0;
+					do {
+						Word A[4];
+						Word B[4];
+						Word C[4];
+						Word D[4];
+						Word Actual[4];
+						ReadFields(&MyImage,uLevel-1,uX*2,uY*2,A);
+						ReadFields(&MyImage,uLevel-1,(uX*2)+1,uY*2,B);
+						ReadFields(&MyImage,uLevel-1,uX*2,(uY*2)+1,C);
+						Word uCount = ReadFields(&MyImage,uLevel-1,(uX*2)+1,(uY*2)+1,D);
+						ReadFields(&MyImage,uLevel,uX,uY,Actual);
+						Word k = 0;
+						do {
+							Word uExpected = (A[k]+B[k]+C[k]+D[k]+2U)>>2U;
+							if (Actual[k]!=uExpected) {
+								uTest = TRUE;
+								ReportFailure("Image::GenerateMipMaps(FILTER_BOX) %s level %u pixel %u,%u component %u = %u, expected %u",uTest,
+									g_ResizeTypeNames[uType],uLevel,uX,uY,k,Actual[k],uExpected);
+								break;
+							}
+						} while (++k<uCount);
+					} while (!uTest && (++uX<uWidth));
+				} while (!uTest && (++uY<uHeight));
+				uFailure |= uTest;
+			} while (++uLevel<pSize->m_uMipMaps);
+		} while (++uSize<BURGER_ARRAYSIZE(g_MipMapSizes));
+	} while (++uType<BURGER_ARRAYSIZE(g_ResizeTypes));
+	return uFailure;
+}
+
+/***************************************
+
+	Test the windowed sinc mip maps against the
+	scalar resampler
+
+***************************************/
+
+static Word TestMipMapFiltered(void)
+{
+	Word uFailure = FALSE;
+	Word uType = 0;
+	do {
+		Word uFilter = Image::FILTER_KAISER;
+		do {
+			Image MyImage;
+			Word uResult = MyImage.Init(48,40,g_ResizeTypes[uType],4);
+			if (uResult) {
+				ReportFailure("Image::Init(48,40,%s,4) = %u",TRUE,g_ResizeTypeNames[uType],uResult);
+				uFailure = TRUE;
+				continue;
+			}
+			g_uSeed = 0x1234+uType;
+			FillRandom(&MyImage);
+			Image::eFilter eFilterType = static_cast<Image::eFilter>(uFilter);
+			uResult = MyImage.GenerateMipMaps(eFilterType);
+			Word uTest = uResult!=0;
+			uFailure |= uTest;
+			ReportFailure("Image::GenerateMipMaps(%s) %s = %u",uTest,g_FilterNames[uFilter],g_ResizeTypeNames[uType],uResult);
+			if (!uTest) {
+				Word uLevel = 1;
+				do {
+					uFailure |= CompareResample(&MyImage,uLevel,&MyImage,uLevel-1,eFilterType,"Image::GenerateMipMaps()");
+				} while (++uLevel<4);
+			}
+		} while (++uFilter<=Image::FILTER_LANCZOS);
+	} while (++uType<BURGER_ARRAYSIZE(g_ResizeTypes));
+	return uFailure;
+}
+
+/***************************************
+
+	Gamma correct mip maps of a black and white checkerboard
+	should be a lighter grey than a simple average
+
+***************************************/
+
+static Word TestMipMapGamma(void)
+{
+	Image MyImage;
+	Word uFailure = MyImage.Init(16,16,Image::PIXELTYPE8888,2);
+	ReportFailure("Image::Init(16,16,PIXELTYPE8888,2) = %u",uFailure,uFailure);
+	if (!uFailure) {
+		WordPtr uStride = MyImage.GetStride();
+		Word uY = 0;
+		do {
+			Word8 *pWork = MyImage.GetImage()+(uY*uStride);
+			Word uX = 0;
+			do {
+				Word8 uColor = static_cast<Word8>(((uX^uY)&1) ? 255 : 0);
+				pWork[0] = uColor;
+				pWork[1] = uColor;
+				pWork[2] = uColor;
+				pWork[3] = 255;
+				pWork+=4;
+			} while (++uX<16);
+		} while (++uY<16);
+
+		static const Image::eFilter s_Filters[2] = {Image::FILTER_BOX,Image::FILTER_BOXGAMMA};
+		// A simple average is 128, 50% linear light is 188 in sRGB
+		static const Word s_Expected[2] = {128,188};
+		Word i = 0;
+		do {
+			Word uResult = MyImage.GenerateMipMaps(s_Filters[i]);
+			Word uTest = uResult!=0;
+			uFailure |= uTest;
+			ReportFailure("Image::GenerateMipMaps(%s) checkerboard = %u",uTest,g_FilterNames[s_Filters[i]],uResult);
+			const Word8 *pWork = MyImage.GetImage(1);
+			WordPtr uCount = 8*8;
+			do {
+				Int iDelta = static_cast<Int>(pWork[0])-static_cast<Int>(s_Expected[i]);
+				uTest = (iDelta<-1) || (iDelta>1) || (pWork[0]!=pWork[1]) || (pWork[0]!=pWork[2]) || (pWork[3]!=255);
+				if (uTest) {
+					ReportFailure("Image::GenerateMipMaps(%s) checkerboard = %u,%u,%u,%u, expected %u",uTest,g_FilterNames[s_Filters[i]],pWork[0],pWork[1],pWork[2],pWork[3],s_Expected[i]);
+					uFailure = TRUE;
+					break;
+				}
+				pWork+=4;
+			} while (--uCount);
+		} while (++i<2);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test Image::Resize() against the scalar resampler
+
+***************************************/
+
+struct ResizeSize_t {
+	Word m_uInputWidth;		// Source width
+	Word m_uInputHeight;	// Source height
+	Word m_uOutputWidth;	// Destination width
+	Word m_uOutputHeight;	// Destination height
+};
+
+static const ResizeSize_t g_ResizeSizes[] = {
+	{67,45,23,31},			// Shrink on both axes
+	{19,13,50,41},			// Enlarge on both axes
+	{40,30,97,11},			// Enlarge one axis, shrink the other
+	{5,1,1,7},				// Degenerate sizes
+	{300,200,256,160}		// Large enough to use multiple threads
+};
+
+static Word TestResize(void)
+{
+	Word uFailure = FALSE;
+	Word uType = 0;
+	do {
+		Word uSize = 0;
+		do {
+			const ResizeSize_t *pSize = &g_ResizeSizes[uSize];
+			Image Input;
+			Word uResult = Input.Init(pSize->m_uInputWidth,pSize->m_uInputHeight,g_ResizeTypes[uType]);
+			if (uResult) {
+				ReportFailure("Image::Init(%u,%u,%s) = %u",TRUE,pSize->m_uInputWidth,pSize->m_uInputHeight,g_ResizeTypeNames[uType],uResult);
+				uFailure = TRUE;
+				continue;
+			}
+			g_uSeed = 0x5555+uSize+(uType*16);
+			FillRandom(&Input);
+			Word uFilter = Image::FILTER_BOX;
+			do {
+				// The gamma correct filter is tested with the mip maps
+				if (uFilter==Image::FILTER_BOXGAMMA) {
+					continue;
+				}
+				Image::eFilter eFilterType = static_cast<Image::eFilter>(uFilter);
+				Image Output;
+				uResult = Output.Resize(&Input,pSize->m_uOutputWidth,pSize->m_uOutputHeight,eFilterType);
+				Word uTest = (uResult!=0) || (Output.GetWidth()!=pSize->m_uOutputWidth) ||
+					(Output.GetHeight()!=pSize->m_uOutputHeight) || (Output.GetType()!=Input.GetType());
+				uFailure |= uTest;
+				ReportFailure("Image::Resize(%s,%u,%u,%s) = %u",uTest,g_ResizeTypeNames[uType],pSize->m_uOutputWidth,pSize->m_uOutputHeight,g_FilterNames[uFilter],uResult);
+				if (!uTest) {
+					uFailure |= CompareResample(&Output,0,&Input,0,eFilterType,"Image::Resize()");
+				}
+			} while (++uFilter<=Image::FILTER_LANCZOS);
+		} while (++uSize<BURGER_ARRAYSIZE(g_ResizeSizes));
+	} while (++uType<BURGER_ARRAYSIZE(g_ResizeTypes));
+	return uFailure;
+}
+
+/***************************************
+
+	Resizing to the same size must not change the image
+	and pixel types that can't be resampled are rejected
+
+***************************************/
+
+static Word TestResizeIdentity(void)
+{
+	Image Input;
+	Word uFailure = Input.Init(33,17,Image::PIXELTYPE8888);
+	ReportFailure("Image::Init(33,17,PIXELTYPE8888) = %u",uFailure,uFailure);
+	if (!uFailure) {
+		g_uSeed = 0xBEEF;
+		FillRandom(&Input);
+		Word uFilter = Image::FILTER_BOX;
+		do {
+			if (uFilter==Image::FILTER_BOXGAMMA) {
+				continue;
+			}
+			Image Output;
+			Word uResult = Output.Resize(&Input,33,17,static_cast<Image::eFilter>(uFilter));
+			Word uTest = uResult!=0;
+			if (!uTest) {
+				Word uY = 0;
+				do {
+					uTest |= MemoryCompare(Output.GetImage()+(uY*Output.GetStride()),Input.GetImage()+(uY*Input.GetStride()),33*4)!=0;
+				} while (++uY<17);
+			}
+			uFailure |= uTest;
+			ReportFailure("Image::Resize(33,17,%s) to the same size changed the image, result = %u",uTest,g_FilterNames[uFilter],uResult);
+		} while (++uFilter<=Image::FILTER_LANCZOS);
+	}
+
+	Image Indexed;
+	Word uResult = Indexed.Init(16,16,Image::PIXELTYPE8BIT,2);
+	if (!uResult) {
+		uResult = Indexed.GenerateMipMaps();
+		Word uTest = uResult==0;
+		uFailure |= uTest;
+		ReportFailure("Image::GenerateMipMaps() on PIXELTYPE8BIT = %u",uTest,uResult);
+		Image Output;
+		uResult = Output.Resize(&Indexed,8,8);
+		uTest = uResult==0;
+		uFailure |= uTest;
+		ReportFailure("Image::Resize() on PIXELTYPE8BIT = %u",uTest,uResult);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test the Image class
+
+***************************************/
+
+int BURGER_API TestBrimage(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Image tests");
+	Word uResult = TestMipMapBox();
+	uResult |= TestMipMapFiltered();
+	uResult |= TestMipMapGamma();
+	uResult |= TestResize();
+	uResult |= TestResizeIdentity();
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,498 @@
+/***************************************
+
+	Unit tests for the palette functions
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrpalette.h"
+#include "common.h"
+#include "brpalette.h"
+#include "brimage.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryansi.h"
+#include "brstringfunctions.h"
+
+using namespace Burger;
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word GetRandom(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return static_cast<Word>((g_uSeed>>16U)%uRange);
+}
+
+//
+// Fill a buffer with random bytes
+//
+
+static void FillRandom(Word8 *pOutput,WordPtr uSize)
+{
+	do {
+		pOutput[0] = static_cast<Word8>(GetRandom(256));
+		++pOutput;
+	} while (--uSize);
+}
+
+/***************************************
+
+	Check every color in a range of the color cube
+	against Palette::FindColorIndex()
+
+	Both Init() functions are tested, the table must
+	return the same index, including the lowest index
+	when colors are equally close
+
+***************************************/
+
+static Word CompareInverseTable(const Word8 *pPalette,Word uCount,const char *pName,Word uLow,Word uHigh,Word uStep)
+{
+	InverseColorTable *pTable = New<InverseColorTable>();
+	if (!pTable) {
+		ReportFailure("Out of memory in CompareInverseTable()",TRUE);
+		return TRUE;
+	}
+	RGBAWord8_t RGBAPalette[256];
+	CopyPalette(RGBAPalette,reinterpret_cast<const RGBWord8_t *>(pPalette),uCount);
+	Word uFailure = FALSE;
+	Word uPass = 0;
+	do {
+		Word uResult = uPass ? pTable->Init(RGBAPalette,uCount) : pTable->Init(pPalette,uCount);
+		Word uTest = (uResult!=0) || (pTable->GetCount()!=uCount);
+		uFailure |= uTest;
+		ReportFailure("InverseColorTable::Init() %s, pass %u = %u",uTest,pName,uPass,uResult);
+		if (!uTest) {
+			Word uRed = uLow;
+			do {
+				Word uGreen = uLow;
+				do {
+					Word uBlue = uLow;
+					do {
+						Word uExpected = Palette::FindColorIndex(pPalette,uRed,uGreen,uBlue,uCount);
+						Word uIndex = pTable->FindColorIndex(uRed,uGreen,uBlue);
+						if (uIndex!=uExpected) {
+							ReportFailure("InverseColorTable::FindColorIndex(%u,%u,%u) %s = %u, expected %u",TRUE,uRed,uGreen,uBlue,pName,uIndex,uExpected);
+							uFailure = TRUE;
+							// Don't flood the output
+							uRed = uHigh;
+							uGreen = uHigh;
+							break;
+						}
+					} while ((uBlue+=uStep)<=uHigh);
+				} while ((uGreen+=uStep)<=uHigh);
+			} while ((uRed+=uStep)<=uHigh);
+		}
+	} while (++uPass<2);
+	Delete(pTable);
+	return uFailure;
+}
+
+/***************************************
+
+	Test InverseColorTable with random palettes
+
+***************************************/
+
+static Word TestInverseRandom(void)
+{
+	Word8 MyPalette[256*3];
+	g_uSeed = 0x13579;
+	FillRandom(MyPalette,sizeof(MyPalette));
+	Word uFailure = CompareInverseTable(MyPalette,256,"256 random colors",0,255,5);
+	uFailure |= CompareInverseTable(MyPalette,17,"17 random colors",0,255,3);
+	uFailure |= CompareInverseTable(MyPalette,1,"1 color",0,255,15);
+
+	// All the colors crowded into one cell
+	Word i = 0;
+	do {
+		MyPalette[i] = static_cast<Word8>(0x80+GetRandom(16));
+	} while (++i<(40*3));
+	uFailure |= CompareInverseTable(MyPalette,40,"40 colors in one cell",0,255,5);
+	return uFailure;
+}
+
+/***************************************
+
+	Test InverseColorTable with a palette that creates
+	lots of ties
+
+	Colors are two apart on every axis so every odd
+	component is equally close to two colors. The lattice
+	is stored in reverse order and some colors are
+	duplicated later in the palette, the duplicates
+	must never be chosen.
+
+***************************************/
+
+static Word TestInverseTies(void)
+{
+	Word8 MyPalette[256*3];
+	Word uCount = 0;
+	Word uRed = 4;
+	do {
+		Word uGreen = 4;
+		do {
+			Word uBlue = 4;
+			do {
+				Word8 *pWork = &MyPalette[uCount*3];
+				// Values of 14 to 20 cross a cell boundary at 16
+				pWork[0] = static_cast<Word8>(12+(uRed*2));
+				pWork[1] = static_cast<Word8>(12+(uGreen*2));
+				pWork[2] = static_cast<Word8>(12+(uBlue*2));
+				++uCount;
+			} while (--uBlue);
+		} while (--uGreen);
+	} while (--uRed);
+
+	// Duplicates of earlier entries must never be chosen
+	Word i = 0;
+	do {
+		MemoryCopy(&MyPalette[uCount*3],&MyPalette[(i*5)*3],3);
+		++uCount;
+	} while (++i<12);
+	return CompareInverseTable(MyPalette,uCount,"ties",0,63,1);
+}
+
+/***************************************
+
+	RemapImage() without dithering must choose the same
+	colors as Palette::FindColorIndex()
+
+***************************************/
+
+static Word TestRemapImage(void)
+{
+	Word uFailure = FALSE;
+	RGBAWord8_t MyPalette[256];
+	Word8 RGBPalette[256*3];
+	g_uSeed = 0x2468;
+	FillRandom(&MyPalette[0].m_uRed,sizeof(MyPalette));
+	CopyPalette(reinterpret_cast<RGBWord8_t *>(RGBPalette),MyPalette,256);
+
+	static const Image::ePixelTypes s_Types[2] = {Image::PIXELTYPE8888,Image::PIXELTYPE888};
+	Word uType = 0;
+	do {
+		Image Input;
+		Word uResult = Input.Init(61,37,s_Types[uType]);
+		if (uResult) {
+			ReportFailure("Image::Init(61,37,%u) = %u",TRUE,s_Types[uType],uResult);
+			uFailure = TRUE;
+			continue;
+		}
+		FillRandom(Input.GetImage(),Input.GetImageSize(0));
+		Word uPixelSize = Input.GetBytesPerPixel();
+		static const Word s_Colors[3] = {50,256,2};
+		Word uColorTest = 0;
+		do {
+			Word uColors = s_Colors[uColorTest];
+			Image Output;
+			uResult = Palette::RemapImage(&Output,&Input,MyPalette,uColors);
+			Word uTest = (uResult!=0) || (Output.GetType()!=Image::PIXELTYPE8BIT) ||
+				(Output.GetWidth()!=61) || (Output.GetHeight()!=37);
+			uFailure |= uTest;
+			ReportFailure("Palette::RemapImage(%u bits per pixel, %u colors) = %u",uTest,uPixelSize*8,uColors,uResult);
+			if (!uTest) {
+				Word uY = 0;
+				do {
+					const Word8 *pInput = Input.GetImage()+(uY*Input.GetStride());
+					const Word8 *pOutput = Output.GetImage()+(uY*Output.GetStride());
+					Word uX = 0;
+					do {
+						Word uExpected = Palette::FindColorIndex(RGBPalette,pInput[0],pInput[1],pInput[2],uColors);
+						if (pOutput[uX]!=uExpected) {
+							ReportFailure("Palette::RemapImage(%u bits per pixel, %u colors) pixel %u,%u = %u, expected %u",TRUE,uPixelSize*8,uColors,uX,uY,pOutput[uX],uExpected);
+							uTest = TRUE;
+							break;
+						}
+						pInput += uPixelSize;
+					} while (++uX<61);
+				} while (!uTest && (++uY<37));
+				uFailure |= uTest;
+			}
+		} while (++uColorTest<BURGER_ARRAYSIZE(s_Colors));
+	} while (++uType<BURGER_ARRAYSIZE(s_Types));
+
+	// Unsupported input is rejected
+	Image Input;
+	Image Output;
+	Word uResult = Input.Init(8,8,Image::PIXELTYPE565);
+	if (!uResult) {
+		uResult = Palette::RemapImage(&Output,&Input,MyPalette);
+		Word uTest = uResult==0;
+		uFailure |= uTest;
+		ReportFailure("Palette::RemapImage() on PIXELTYPE565 = %u",uTest,uResult);
+	}
+	uResult = Input.Init(8,8,Image::PIXELTYPE888);
+	if (!uResult) {
+		static const Word s_BadColors[2] = {0,257};
+		Word i = 0;
+		do {
+			uResult = Palette::RemapImage(&Output,&Input,MyPalette,s_BadColors[i]);
+			Word uTest = uResult==0;
+			uFailure |= uTest;
+			ReportFailure("Palette::RemapImage() with %u colors = %u",uTest,s_BadColors[i],uResult);
+		} while (++i<2);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Check the palette entries that Quantize() doesn't use
+
+***************************************/
+
+static Word CheckUnusedColors(const RGBAWord8_t *pPalette,Word uUsed,const char *pName)
+{
+	Word uFailure = FALSE;
+	Word i = 0;
+	do {
+		const RGBAWord8_t *pColor = &pPalette[i];
+		Word uTest = (pColor->m_uAlpha!=255);
+		if (i>=uUsed) {
+			uTest |= (pColor->m_uRed!=0) || (pColor->m_uGreen!=0) || (pColor->m_uBlue!=0);
+		}
+		if (uTest) {
+			ReportFailure("Palette::Quantize() %s entry %u = %u,%u,%u,%u",uTest,pName,i,pColor->m_uRed,pColor->m_uGreen,pColor->m_uBlue,pColor->m_uAlpha);
+			uFailure = TRUE;
+			break;
+		}
+	} while (++i<256);
+	return uFailure;
+}
+
+/***************************************
+
+	An image with fewer colors than the palette has room for
+	must be quantized without losing any colors
+
+***************************************/
+
+static Word TestQuantizeExact(void)
+{
+	Image Input;
+	Word uFailure = Input.Init(40,20,Image::PIXELTYPE888);
+	ReportFailure("Image::Init(40,20,PIXELTYPE888) = %u",uFailure,uFailure);
+	if (!uFailure) {
+		// 20 colors that are all far enough apart to be in different histogram bins
+		Word8 Colors[20*3];
+		Word i = 0;
+		do {
+			Colors[i*3] = static_cast<Word8>(((i&3)*64)+9);
+			Colors[(i*3)+1] = static_cast<Word8>((((i>>2)&3)*64)+21);
+			Colors[(i*3)+2] = static_cast<Word8>((((i>>4)&1)*128)+100);
+		} while (++i<20);
+		g_uSeed = 0xACE;
+		Word uY = 0;
+		do {
+			Word8 *pWork = Input.GetImage()+(uY*Input.GetStride());
+			Word uX = 0;
+			do {
+				MemoryCopy(pWork,&Colors[GetRandom(20)*3],3);
+				pWork += 3;
+			} while (++uX<40);
+		} while (++uY<20);
+
+		RGBAWord8_t MyPalette[256];
+		Image Output;
+		Word uResult = Palette::Quantize(&Output,MyPalette,&Input);
+		Word uTest = (uResult!=0) || (Output.GetType()!=Image::PIXELTYPE8BIT);
+		uFailure |= uTest;
+		ReportFailure("Palette::Quantize() with 20 colors = %u",uTest,uResult);
+		if (!uTest) {
+			Word uUsed = 0;
+			uY = 0;
+			do {
+				const Word8 *pInput = Input.GetImage()+(uY*Input.GetStride());
+				const Word8 *pOutput = Output.GetImage()+(uY*Output.GetStride());
+				Word uX = 0;
+				do {
+					Word uIndex = pOutput[uX];
+					if (uIndex>=uUsed) {
+						uUsed = uIndex+1;
+					}
+					const RGBAWord8_t *pColor = &MyPalette[uIndex];
+					if ((pColor->m_uRed!=pInput[0]) || (pColor->m_uGreen!=pInput[1]) || (pColor->m_uBlue!=pInput[2])) {
+						ReportFailure("Palette::Quantize() pixel %u,%u = %u,%u,%u, expected %u,%u,%u",TRUE,uX,uY,
+							pColor->m_uRed,pColor->m_uGreen,pColor->m_uBlue,pInput[0],pInput[1],pInput[2]);
+						uTest = TRUE;
+						break;
+					}
+					pInput += 3;
+				} while (++uX<40);
+			} while (!uTest && (++uY<20));
+			uFailure |= uTest;
+			uTest = uUsed>20;
+			uFailure |= uTest;
+			ReportFailure("Palette::Quantize() used %u palette entries, expected 20",uTest,uUsed);
+			uFailure |= CheckUnusedColors(MyPalette,20,"20 colors");
+		}
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Quantize a gradient to a small number of colors
+
+***************************************/
+
+static Word TestQuantizeReduce(void)
+{
+	Image Input;
+	Word uFailure = Input.Init(64,64,Image::PIXELTYPE8888);
+	ReportFailure("Image::Init(64,64,PIXELTYPE8888) = %u",uFailure,uFailure);
+	if (!uFailure) {
+		Word uY = 0;
+		do {
+			Word8 *pWork = Input.GetImage()+(uY*Input.GetStride());
+			Word uX = 0;
+			do {
+				pWork[0] = static_cast<Word8>(uX*4);
+				pWork[1] = static_cast<Word8>(uY*4);
+				pWork[2] = static_cast<Word8>(128);
+				pWork[3] = static_cast<Word8>(uX);
+				pWork += 4;
+			} while (++uX<64);
+		} while (++uY<64);
+
+		static const Palette::eDither s_Dithers[3] = {Palette::DITHER_NONE,Palette::DITHER_ORDERED,Palette::DITHER_ERRORDIFFUSION};
+		Word i = 0;
+		do {
+			RGBAWord8_t MyPalette[256];
+			Image Output;
+			Word uResult = Palette::Quantize(&Output,MyPalette,&Input,16,s_Dithers[i]);
+			Word uTest = (uResult!=0) || (Output.GetType()!=Image::PIXELTYPE8BIT);
+			uFailure |= uTest;
+			ReportFailure("Palette::Quantize(16 colors, dither %u) = %u",uTest,i,uResult);
+			if (!uTest) {
+				uY = 0;
+				do {
+					const Word8 *pOutput = Output.GetImage()+(uY*Output.GetStride());
+					Word uX = 0;
+					do {
+						if (pOutput[uX]>=16) {
+							ReportFailure("Palette::Quantize(16 colors, dither %u) pixel %u,%u = %u",TRUE,i,uX,uY,pOutput[uX]);
+							uTest = TRUE;
+							break;
+						}
+					} while (++uX<64);
+				} while (!uTest && (++uY<64));
+				uFailure |= uTest;
+				uFailure |= CheckUnusedColors(MyPalette,16,"16 colors");
+			}
+		} while (++i<BURGER_ARRAYSIZE(s_Dithers));
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Dither a flat grey with a black and white palette,
+	the ratio of white pixels should match the brightness
+
+***************************************/
+
+static Word CountWhite(const Image *pImage)
+{
+	Word uWhite = 0;
+	Word uY = 0;
+	do {
+		const Word8 *pWork = pImage->GetImage()+(uY*pImage->GetStride());
+		Word uX = 0;
+		do {
+			uWhite += pWork[uX];
+		} while (++uX<pImage->GetWidth());
+	} while (++uY<pImage->GetHeight());
+	return uWhite;
+}
+
+static Word TestDither(void)
+{
+	RGBAWord8_t MyPalette[4];
+	MemoryClear(MyPalette,sizeof(MyPalette));
+	MyPalette[1].m_uRed = 255;
+	MyPalette[1].m_uGreen = 255;
+	MyPalette[1].m_uBlue = 255;
+	MyPalette[2].m_uRed = 200;
+	MyPalette[2].m_uGreen = 40;
+	MyPalette[2].m_uBlue = 90;
+
+	Image Input;
+	Word uFailure = Input.Init(64,64,Image::PIXELTYPE888);
+	ReportFailure("Image::Init(64,64,PIXELTYPE888) = %u",uFailure,uFailure);
+	if (!uFailure) {
+		// The ordered dither table is half positive, half negative
+		MemoryFill(Input.GetImage(),128,Input.GetImageSize(0));
+		Image Output;
+		Word uResult = Palette::RemapImage(&Output,&Input,MyPalette,2,Palette::DITHER_ORDERED);
+		Word uWhite = uResult ? 0 : CountWhite(&Output);
+		Word uTest = (uResult!=0) || (uWhite!=(64*64/2));
+		uFailure |= uTest;
+		ReportFailure("Palette::RemapImage(DITHER_ORDERED) grey 128 has %u white pixels, expected %u",uTest,uWhite,64*64/2);
+
+		// 64/255ths of the pixels should be white
+		MemoryFill(Input.GetImage(),64,Input.GetImageSize(0));
+		uResult = Palette::RemapImage(&Output,&Input,MyPalette,2,Palette::DITHER_ERRORDIFFUSION);
+		uWhite = uResult ? 0 : CountWhite(&Output);
+		Word uExpected = (64*64*64)/255;
+		uTest = (uResult!=0) || (uWhite<(uExpected-(uExpected/20))) || (uWhite>(uExpected+(uExpected/20)));
+		uFailure |= uTest;
+		ReportFailure("Palette::RemapImage(DITHER_ERRORDIFFUSION) grey 64 has %u white pixels, expected %u",uTest,uWhite,uExpected);
+
+		// An exact match has no error to spread
+		Word8 *pWork = Input.GetImage();
+		WordPtr uCount = Input.GetImageSize(0)/3;
+		do {
+			pWork[0] = MyPalette[2].m_uRed;
+			pWork[1] = MyPalette[2].m_uGreen;
+			pWork[2] = MyPalette[2].m_uBlue;
+			pWork += 3;
+		} while (--uCount);
+		uResult = Palette::RemapImage(&Output,&Input,MyPalette,4,Palette::DITHER_ERRORDIFFUSION);
+		uTest = uResult!=0;
+		if (!uTest) {
+			Word uY = 0;
+			do {
+				const Word8 *pOutput = Output.GetImage()+(uY*Output.GetStride());
+				Word uX = 0;
+				do {
+					uTest |= (pOutput[uX]!=2);
+				} while (++uX<64);
+			} while (++uY<64);
+		}
+		uFailure |= uTest;
+		ReportFailure("Palette::RemapImage(DITHER_ERRORDIFFUSION) of a palette color didn't return only that color",uTest);
+	}
+	return uFailure;
+}
+
+/***************************************
+
+	Test the palette functions
+
+***************************************/
+
+int BURGER_API TestBrpalette(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Palette tests");
+	Word uResult = TestInverseRandom();
+	uResult |= TestInverseTies();
+	uResult |= TestRemapImage();
+	uResult |= TestQuantizeExact();
+	uResult |= TestQuantizeReduce();
+	uResult |= TestDither();
+	return static_cast<int>(uResult);
+}
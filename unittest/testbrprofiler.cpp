@@ -0,0 +1,185 @@
+/***************************************
+
+	Unit tests for the profiler
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+// Compile in the zones for this file
+#define BURGER_PROFILER
+
+#include "testbrprofiler.h"
+#include "common.h"
+#include "brprofiler.h"
+#include "broutputmemorystream.h"
+#include "brglobalmemorymanager.h"
+#include "brstringfunctions.h"
+#include "brcriticalsection.h"
+#include "brtick.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded tests
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USETHREADS
+#endif
+
+static const char g_Outer[] = "Outer";
+static const char g_Inner[] = "Inner";
+
+//
+// Spend at least uNanoseconds in the current zone
+//
+
+static void Work(Word64 uNanoseconds)
+{
+	Word64 uMark = Tick::ReadNanoseconds();
+	while ((Tick::ReadNanoseconds()-uMark)<uNanoseconds) {
+	}
+}
+
+static void Nested(Word uCount)
+{
+	BURGER_PROFILE_ZONE(g_Outer);
+	Work(10000);
+	do {
+		BURGER_PROFILE_ZONE(g_Inner);
+		Work(20000);
+	} while (--uCount);
+}
+
+#if defined(USETHREADS)
+static WordPtr BURGER_API NestedThread(void * /* pData */)
+{
+	Nested(2);
+	return 0;
+}
+#endif
+
+//
+// Return the line of the summary for a zone
+//
+
+static Word TestSummaryLine(const char *pSummary,const char *pName,Word uCalls)
+{
+	char Search[64];
+	StringCopy(Search,"\n");
+	StringConcatenate(Search,pName);
+	StringConcatenate(Search,"\t");
+	const char *pLine = StringString(pSummary,Search);
+	if (!pLine) {
+		return TRUE;
+	}
+	pLine += StringLength(Search);
+	return AsciiToInteger(pLine)!=uCalls;
+}
+
+/***************************************
+
+	Record zones and check the exported data
+
+***************************************/
+
+int BURGER_API TestBrprofiler(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Profiler tests");
+
+	// Nothing is recorded when stopped
+	Word uFailure = Profiler::Init(1000)!=0;
+	Nested(1);
+	OutputMemoryStream Summary;
+	uFailure |= Profiler::SaveSummary(&Summary)!=0;
+	Summary.Append(static_cast<Word8>(0));
+	WordPtr uLength;
+	char *pText = static_cast<char *>(Summary.Flatten(&uLength));
+	uFailure |= (pText==NULL) || (StringString(pText,g_Outer)!=NULL);
+	Free(pText);
+	Word uResult = uFailure;
+	ReportFailure("Profiler recorded zones while stopped",uFailure);
+
+	// Record three outer zones with two inner zones each
+	Profiler::Start();
+	uFailure = !Profiler::IsRecording();
+	Nested(2);
+	Nested(2);
+	BURGER_PROFILE_BEGIN(g_Outer);
+	Nested(2);
+	BURGER_PROFILE_END(g_Outer);
+#if defined(USETHREADS)
+	Thread Other(NestedThread,NULL);
+	Other.Wait();
+#endif
+	Profiler::Stop();
+	uFailure |= Profiler::IsRecording()!=FALSE;
+	Nested(1);
+
+#if defined(USETHREADS)
+	const Word uOuterCount = 5;
+#else
+	const Word uOuterCount = 4;
+#endif
+	Summary.Clear();
+	uFailure |= Profiler::SaveSummary(&Summary)!=0;
+	Summary.Append(static_cast<Word8>(0));
+	pText = static_cast<char *>(Summary.Flatten(&uLength));
+	if (!pText) {
+		uFailure = TRUE;
+	} else {
+		uFailure |= TestSummaryLine(pText,g_Outer,uOuterCount);
+		uFailure |= TestSummaryLine(pText,g_Inner,(uOuterCount-1)*2);
+		// Inner must be listed after Outer since it has less total time
+		char *pOuter = StringString(pText,g_Outer);
+		char *pInner = StringString(pText,g_Inner);
+		uFailure |= !pOuter || !pInner || (pInner<pOuter);
+	}
+	uResult |= uFailure;
+	ReportFailure("Profiler::SaveSummary() gave \"%s\"",uFailure,pText ? pText : "NULL");
+	Free(pText);
+
+	// Check the Chrome trace has the events from each thread
+	OutputMemoryStream Trace;
+	uFailure = Profiler::SaveChromeTrace(&Trace)!=0;
+	Trace.Append(static_cast<Word8>(0));
+	pText = static_cast<char *>(Trace.Flatten(&uLength));
+	if (!pText) {
+		uFailure = TRUE;
+	} else {
+		uFailure |= StringCompare(pText,"{\"traceEvents\":[",16)!=0;
+		uFailure |= StringString(pText,"{\"name\":\"Outer\",\"ph\":\"B\",\"ts\":")==NULL;
+		uFailure |= StringString(pText,"\"ph\":\"E\"")==NULL;
+		uFailure |= StringString(pText,"\"tid\":0}")==NULL;
+#if defined(USETHREADS)
+		uFailure |= StringString(pText,"\"tid\":1}")==NULL;
+#endif
+	}
+	uResult |= uFailure;
+	ReportFailure("Profiler::SaveChromeTrace() is missing events",uFailure);
+	Free(pText);
+
+	// The ring buffer keeps only the newest events
+	Profiler::Init(4);
+	Profiler::Start();
+	Nested(3);
+	Profiler::Stop();
+	Summary.Clear();
+	Profiler::SaveSummary(&Summary);
+	Summary.Append(static_cast<Word8>(0));
+	pText = static_cast<char *>(Summary.Flatten(&uLength));
+	uFailure = !pText || TestSummaryLine(pText,g_Inner,1) || (StringString(pText,g_Outer)!=NULL);
+	uResult |= uFailure;
+	ReportFailure("Profiler ring buffer wrap around gave \"%s\"",uFailure,pText ? pText : "NULL");
+	Free(pText);
+	Profiler::Shutdown();
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,554 @@
+/***************************************
+
+	Unit tests for the software renderers
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrrenderer.h"
+#include "common.h"
+#include "brrenderersoftware8.h"
+#include "brrenderersoftware16.h"
+#include "brrenderersoftware32.h"
+#include "brglobalmemorymanager.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Size of the test frame buffer
+//
+
+static const Word cTestWidth = 97;
+static const Word cTestHeight = 61;
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word GetRandom(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return static_cast<Word>((g_uSeed>>16U)%uRange);
+}
+
+//
+// Create a sprite that has runs of zeros to test masking
+//
+
+static void CreateSprite(Word8 *pOutput,WordPtr uSize)
+{
+	do {
+		Word uColor = GetRandom(256);
+		// Make a third of the pixels transparent
+		if (GetRandom(3)==0) {
+			uColor = 0;
+		}
+		pOutput[0] = static_cast<Word8>(uColor);
+		++pOutput;
+	} while (--uSize);
+}
+
+//
+// Bounds of a sprite after clipping to the frame buffer
+//
+
+static Word ClipSprite(int iX,int iY,Word uWidth,Word uHeight,int *pLeft,int *pTop,int *pRight,int *pBottom)
+{
+	int iLeft = (iX<0) ? 0 : iX;
+	int iTop = (iY<0) ? 0 : iY;
+	int iRight = iX+static_cast<int>(uWidth);
+	int iBottom = iY+static_cast<int>(uHeight);
+	if (iRight>static_cast<int>(cTestWidth)) {
+		iRight = static_cast<int>(cTestWidth);
+	}
+	if (iBottom>static_cast<int>(cTestHeight)) {
+		iBottom = static_cast<int>(cTestHeight);
+	}
+	pLeft[0] = iLeft;
+	pTop[0] = iTop;
+	pRight[0] = iRight;
+	pBottom[0] = iBottom;
+	return (iLeft<iRight) && (iTop<iBottom);
+}
+
+/***************************************
+
+	Test the 8 bit renderer against simple
+	pixel at a time drawing
+
+***************************************/
+
+static Word TestSoftware8(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(cTestWidth*cTestHeight));
+	Word8 *pReference = static_cast<Word8 *>(Alloc(cTestWidth*cTestHeight));
+	Word8 *pSprite = static_cast<Word8 *>(Alloc(80*80));
+	if (pBuffer && pReference && pSprite) {
+		RendererSoftware8 Renderer;
+		Renderer.Init(cTestWidth,cTestHeight,8,0);
+		Renderer.SetFrameBuffer(pBuffer);
+		Renderer.SetStride(cTestWidth);
+		CreateSprite(pBuffer,cTestWidth*cTestHeight);
+		MemoryCopy(pReference,pBuffer,cTestWidth*cTestHeight);
+		g_uSeed = 0x12345678U;
+
+		Word i = 0;
+		do {
+			Word uWidth = GetRandom(79)+1;
+			Word uHeight = GetRandom(79)+1;
+			int iX = static_cast<int>(GetRandom(cTestWidth+80))-80;
+			int iY = static_cast<int>(GetRandom(cTestHeight+80))-80;
+			Word uType = GetRandom(3);
+			Word uColor = GetRandom(256);
+			CreateSprite(pSprite,80*80);
+
+			// Draw with the renderer
+			switch (uType) {
+			case 0:
+				Renderer.Draw8BitPixels(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			case 1:
+				Renderer.Draw8BitPixelsMasked(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			default:
+				Renderer.DrawRect(iX,iY,uWidth,uHeight,uColor);
+				break;
+			}
+
+			// Draw the reference
+			int iLeft,iTop,iRight,iBottom;
+			if (ClipSprite(iX,iY,uWidth,uHeight,&iLeft,&iTop,&iRight,&iBottom)) {
+				int y = iTop;
+				do {
+					int x = iLeft;
+					do {
+						Word uPixel;
+						if (uType==2) {
+							uPixel = uColor;
+						} else {
+							uPixel = pSprite[((y-iY)*80)+(x-iX)];
+							if ((uType==1) && !uPixel) {
+								continue;
+							}
+						}
+						pReference[(y*static_cast<int>(cTestWidth))+x] = static_cast<Word8>(uPixel);
+					} while (++x<iRight);
+				} while (++y<iBottom);
+			}
+			Word uTest = MemoryCompare(pBuffer,pReference,cTestWidth*cTestHeight)!=0;
+			uFailure |= uTest;
+			ReportFailure("RendererSoftware8 type %u at %d,%d size %u,%u",uTest,uType,iX,iY,uWidth,uHeight);
+			if (uTest) {
+				// Resync to prevent cascading failures
+				MemoryCopy(pReference,pBuffer,cTestWidth*cTestHeight);
+			}
+		} while (++i<1000);
+	}
+	Free(pSprite);
+	Free(pReference);
+	Free(pBuffer);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the 16 bit renderer against simple
+	pixel at a time drawing
+
+***************************************/
+
+static Word TestSoftware16(void)
+{
+	Word uFailure = FALSE;
+	Word16 *pBuffer = static_cast<Word16 *>(Alloc(cTestWidth*cTestHeight*2));
+	Word16 *pReference = static_cast<Word16 *>(Alloc(cTestWidth*cTestHeight*2));
+	Word8 *pSprite = static_cast<Word8 *>(Alloc(80*80));
+	Word8 *pPalette = static_cast<Word8 *>(Alloc(256*3));
+	if (pBuffer && pReference && pSprite && pPalette) {
+		RendererSoftware16 Renderer;
+		Renderer.Init(cTestWidth,cTestHeight,16,0);
+		Renderer.SetFrameBuffer(pBuffer);
+		Renderer.SetStride(cTestWidth*2);
+		g_uSeed = 0x87654321U;
+		CreateSprite(pPalette,256*3);
+		Renderer.SetPalette(pPalette);
+		const Word16 *pLookup = Renderer.GetColorLookup();
+		MemoryClear(pBuffer,cTestWidth*cTestHeight*2);
+		MemoryClear(pReference,cTestWidth*cTestHeight*2);
+
+		Word i = 0;
+		do {
+			Word uWidth = GetRandom(79)+1;
+			Word uHeight = GetRandom(79)+1;
+			int iX = static_cast<int>(GetRandom(cTestWidth+80))-80;
+			int iY = static_cast<int>(GetRandom(cTestHeight+80))-80;
+			Word uType = GetRandom(4);
+			Word uColor = GetRandom(256);
+			CreateSprite(pSprite,80*80);
+
+			// Draw with the renderer
+			switch (uType) {
+			case 0:
+				Renderer.Draw8BitPixels(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			case 1:
+				Renderer.Draw8BitPixelsMasked(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			case 2:
+				Renderer.DrawRect(iX,iY,uWidth,uHeight,uColor);
+				break;
+			default:
+				Renderer.DrawPixel(iX+static_cast<int>(uWidth),iY+static_cast<int>(uHeight),uColor);
+				break;
+			}
+
+			// Draw the reference
+			int iLeft,iTop,iRight,iBottom;
+			if (uType==3) {
+				iX = iX+static_cast<int>(uWidth);
+				iY = iY+static_cast<int>(uHeight);
+				uWidth = 1;
+				uHeight = 1;
+			}
+			if (ClipSprite(iX,iY,uWidth,uHeight,&iLeft,&iTop,&iRight,&iBottom)) {
+				int y = iTop;
+				do {
+					int x = iLeft;
+					do {
+						Word uPixel;
+						if (uType>=2) {
+							uPixel = uColor;
+						} else {
+							uPixel = pSprite[((y-iY)*80)+(x-iX)];
+							if ((uType==1) && !uPixel) {
+								continue;
+							}
+						}
+						pReference[(y*static_cast<int>(cTestWidth))+x] = pLookup[uPixel];
+					} while (++x<iRight);
+				} while (++y<iBottom);
+			}
+			Word uTest = MemoryCompare(pBuffer,pReference,cTestWidth*cTestHeight*2)!=0;
+			uFailure |= uTest;
+			ReportFailure("RendererSoftware16 type %u at %d,%d size %u,%u",uTest,uType,iX,iY,uWidth,uHeight);
+			if (uTest) {
+				// Resync to prevent cascading failures
+				MemoryCopy(pReference,pBuffer,cTestWidth*cTestHeight*2);
+			}
+		} while (++i<1000);
+	}
+	Free(pPalette);
+	Free(pSprite);
+	Free(pReference);
+	Free(pBuffer);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the 32 bit blending functions against the
+	reference versions
+
+***************************************/
+
+static Word TestBlendSpans(void)
+{
+	Word uFailure = FALSE;
+	Word8 Source[67*4];
+	Word8 Dest[67*4];
+	Word8 Reference[67*4];
+	g_uSeed = 0x13572468U;
+	Word uMode = RendererSoftware32::BLEND_OPAQUE;
+	do {
+		Word uLength = 0;
+		do {
+			CreateSprite(Source,sizeof(Source));
+			CreateSprite(Dest,sizeof(Dest));
+			// Force the extremes of alpha to be tested
+			Source[3] = 0;
+			Source[7] = 255;
+			MemoryCopy(Reference,Dest,sizeof(Dest));
+			// Use an unaligned start
+			Word uStart = uLength&3;
+			RendererSoftware32::BlendSpan(&Dest[uStart*4],&Source[uStart*4],uLength,static_cast<RendererSoftware32::eBlendMode>(uMode));
+			RendererSoftware32::BlendSpanReference(&Reference[uStart*4],&Source[uStart*4],uLength,static_cast<RendererSoftware32::eBlendMode>(uMode));
+			Word uTest = MemoryCompare(Dest,Reference,sizeof(Dest))!=0;
+			uFailure |= uTest;
+			ReportFailure("RendererSoftware32::BlendSpan(mode %u,length %u)",uTest,uMode,uLength);
+		} while (++uLength<(67-3));
+	} while (++uMode<=RendererSoftware32::BLEND_PREMULTIPLIED);
+
+	// Test the math with a few known values
+	static const Word8 s_Source[4*4] = {
+		255,128,0,128,	10,20,30,0,		200,100,50,255,		64,64,64,64
+	};
+	static const Word8 s_Dest[4*4] = {
+		0,128,255,255,	40,50,60,70,	1,2,3,4,			255,255,255,255
+	};
+	static const Word8 s_Alpha[4*4] = {
+		128,128,127,255,	40,50,60,70,	200,100,50,255,		207,207,207,255
+	};
+	static const Word8 s_Premultiplied[4*4] = {
+		255,192,127,255,	50,70,90,70,	200,100,50,255,		255,255,255,255
+	};
+	Word8 Temp[4*4];
+	MemoryCopy(Temp,s_Dest,sizeof(Temp));
+	RendererSoftware32::BlendSpanReference(Temp,s_Source,4,RendererSoftware32::BLEND_ALPHA);
+	Word uTest = MemoryCompare(Temp,s_Alpha,sizeof(Temp))!=0;
+	uFailure |= uTest;
+	ReportFailure("RendererSoftware32::BlendSpanReference(BLEND_ALPHA) bad result",uTest);
+	MemoryCopy(Temp,s_Dest,sizeof(Temp));
+	RendererSoftware32::BlendSpanReference(Temp,s_Source,4,RendererSoftware32::BLEND_PREMULTIPLIED);
+	uTest = MemoryCompare(Temp,s_Premultiplied,sizeof(Temp))!=0;
+	uFailure |= uTest;
+	ReportFailure("RendererSoftware32::BlendSpanReference(BLEND_PREMULTIPLIED) bad result",uTest);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the 32 bit software renderer against
+	reference pixel drawing
+
+***************************************/
+
+static Word TestSoftware32(void)
+{
+	Word uFailure = TestBlendSpans();
+	Word32 *pBuffer = static_cast<Word32 *>(Alloc(cTestWidth*cTestHeight*4));
+	Word32 *pReference = static_cast<Word32 *>(Alloc(cTestWidth*cTestHeight*4));
+	Word8 *pSprite = static_cast<Word8 *>(Alloc(80*80));
+	Word8 *pPalette = static_cast<Word8 *>(Alloc(256*3));
+	Image TrueColor;
+	if (pBuffer && pReference && pSprite && pPalette && !TrueColor.Init(80,80,Image::PIXELTYPE8888)) {
+		RendererSoftware32 Renderer;
+		Renderer.Init(cTestWidth,cTestHeight,32,0);
+		Renderer.SetFrameBuffer(pBuffer);
+		Renderer.SetStride(cTestWidth*4);
+		g_uSeed = 0x24681357U;
+		CreateSprite(pPalette,256*3);
+		Renderer.SetPalette(pPalette);
+		const Word32 *pLookup = Renderer.GetColorLookup();
+		MemoryClear(pBuffer,cTestWidth*cTestHeight*4);
+		MemoryClear(pReference,cTestWidth*cTestHeight*4);
+
+		Word i = 0;
+		do {
+			Word uWidth = GetRandom(79)+1;
+			Word uHeight = GetRandom(79)+1;
+			int iX = static_cast<int>(GetRandom(cTestWidth+80))-80;
+			int iY = static_cast<int>(GetRandom(cTestHeight+80))-80;
+			Word uType = GetRandom(6);
+			Word uColor = GetRandom(256);
+			RendererSoftware32::eBlendMode eMode = static_cast<RendererSoftware32::eBlendMode>(GetRandom(4));
+			RGBAWord8_t Color;
+			Color.m_uRed = static_cast<Word8>(GetRandom(256));
+			Color.m_uGreen = static_cast<Word8>(GetRandom(256));
+			Color.m_uBlue = static_cast<Word8>(GetRandom(256));
+			Color.m_uAlpha = static_cast<Word8>(GetRandom(256));
+			CreateSprite(pSprite,80*80);
+			CreateSprite(TrueColor.GetImage(),80*80*4);
+
+			// Draw with the renderer
+			switch (uType) {
+			case 0:
+				Renderer.Draw8BitPixels(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			case 1:
+				Renderer.Draw8BitPixelsMasked(iX,iY,uWidth,uHeight,80,pSprite);
+				break;
+			case 2:
+				Renderer.DrawRect(iX,iY,uWidth,uHeight,uColor);
+				break;
+			case 3:
+				Renderer.DrawPixel(iX+static_cast<int>(uWidth),iY+static_cast<int>(uHeight),uColor);
+				break;
+			case 4:
+				// Images are always drawn at full size
+				uWidth = 80;
+				uHeight = 80;
+				Renderer.DrawImage(iX,iY,&TrueColor,eMode);
+				break;
+			default:
+				Renderer.DrawRect(iX,iY,uWidth,uHeight,&Color,eMode);
+				break;
+			}
+
+			// Draw the reference
+			int iLeft,iTop,iRight,iBottom;
+			if (uType==3) {
+				iX = iX+static_cast<int>(uWidth);
+				iY = iY+static_cast<int>(uHeight);
+				uWidth = 1;
+				uHeight = 1;
+			}
+			if (ClipSprite(iX,iY,uWidth,uHeight,&iLeft,&iTop,&iRight,&iBottom)) {
+				int y = iTop;
+				do {
+					int x = iLeft;
+					do {
+						Word32 *pOutput = &pReference[(y*static_cast<int>(cTestWidth))+x];
+						if (uType==4) {
+							RendererSoftware32::BlendSpanReference(reinterpret_cast<Word8 *>(pOutput),TrueColor.GetImage()+((((y-iY)*80)+(x-iX))*4),1,eMode);
+						} else if (uType==5) {
+							RendererSoftware32::BlendSpanReference(reinterpret_cast<Word8 *>(pOutput),&Color.m_uRed,1,eMode);
+						} else {
+							Word uPixel;
+							if (uType>=2) {
+								uPixel = uColor;
+							} else {
+								uPixel = pSprite[((y-iY)*80)+(x-iX)];
+								if ((uType==1) && !uPixel) {
+									continue;
+								}
+							}
+							pOutput[0] = pLookup[uPixel];
+						}
+					} while (++x<iRight);
+				} while (++y<iBottom);
+			}
+			Word uTest = MemoryCompare(pBuffer,pReference,cTestWidth*cTestHeight*4)!=0;
+			uFailure |= uTest;
+			ReportFailure("RendererSoftware32 type %u mode %u at %d,%d size %u,%u",uTest,uType,static_cast<Word>(eMode),iX,iY,uWidth,uHeight);
+			if (uTest) {
+				// Resync to prevent cascading failures
+				MemoryCopy(pReference,pBuffer,cTestWidth*cTestHeight*4);
+			}
+		} while (++i<1000);
+	}
+	Free(pPalette);
+	Free(pSprite);
+	Free(pReference);
+	Free(pBuffer);
+	return uFailure;
+}
+
+/***************************************
+
+	Draw a sequence of random commands, used to
+	compare deferred and immediate rendering
+
+***************************************/
+
+static const Word cDeferredWidth = 203;
+static const Word cDeferredHeight = 157;
+
+static void DrawRandomCommands(Renderer *pRenderer,const Word8 *pSprites)
+{
+	g_uSeed = 0x31415926U;
+	Word i = 0;
+	do {
+		// Change the clip rect once in a while
+		if (!GetRandom(50)) {
+			if (GetRandom(2)) {
+				pRenderer->SetClip(0,0,static_cast<int>(cDeferredWidth),static_cast<int>(cDeferredHeight));
+			} else {
+				int iLeft = static_cast<int>(GetRandom(cDeferredWidth));
+				int iTop = static_cast<int>(GetRandom(cDeferredHeight));
+				pRenderer->SetClip(iLeft,iTop,iLeft+static_cast<int>(GetRandom(cDeferredWidth-iLeft)+1),
+					iTop+static_cast<int>(GetRandom(cDeferredHeight-iTop)+1));
+			}
+		}
+		Word uWidth = GetRandom(79)+1;
+		Word uHeight = GetRandom(79)+1;
+		int iX = static_cast<int>(GetRandom(cDeferredWidth+80))-80;
+		int iY = static_cast<int>(GetRandom(cDeferredHeight+80))-80;
+		const Word8 *pSprite = pSprites+(GetRandom(8)*(80*80));
+		Word uColor = GetRandom(256);
+		switch (GetRandom(4)) {
+		case 0:
+			pRenderer->Draw8BitPixels(iX,iY,uWidth,uHeight,80,pSprite);
+			break;
+		case 1:
+			pRenderer->Draw8BitPixelsMasked(iX,iY,uWidth,uHeight,80,pSprite);
+			break;
+		case 2:
+			pRenderer->DrawRect(iX,iY,uWidth,uHeight,uColor);
+			break;
+		default:
+			pRenderer->DrawPixel(iX+static_cast<int>(uWidth),iY+static_cast<int>(uHeight),uColor);
+			break;
+		}
+	} while (++i<2000);
+}
+
+/***************************************
+
+	Test that deferred rendering creates the
+	same image as immediate rendering
+
+***************************************/
+
+static Word TestDeferred(void)
+{
+	Word uFailure = FALSE;
+	Word8 *pImmediate = static_cast<Word8 *>(AllocClear(cDeferredWidth*cDeferredHeight*4));
+	Word8 *pDeferred = static_cast<Word8 *>(AllocClear(cDeferredWidth*cDeferredHeight*4));
+	Word8 *pSprites = static_cast<Word8 *>(Alloc(80*80*8));
+	if (pImmediate && pDeferred && pSprites) {
+		g_uSeed = 0x27182818U;
+		CreateSprite(pSprites,80*80*8);
+		RendererSoftware8 Renderer8;
+		RendererSoftware16 Renderer16;
+		RendererSoftware32 Renderer32;
+		Renderer *pRenderers[3] = {&Renderer8,&Renderer16,&Renderer32};
+		Word uDepth = 0;
+		do {
+			Renderer *pRenderer = pRenderers[uDepth];
+			Word uPixelSize = 1U<<uDepth;
+			WordPtr uSize = cDeferredWidth*cDeferredHeight*uPixelSize;
+			pRenderer->Init(cDeferredWidth,cDeferredHeight,8U<<uDepth,0);
+			pRenderer->SetStride(cDeferredWidth*uPixelSize);
+
+			// Draw immediately
+			pRenderer->SetFrameBuffer(pImmediate);
+			pRenderer->BeginScene();
+			DrawRandomCommands(pRenderer,pSprites);
+			pRenderer->EndScene();
+
+			// Draw the same commands deferred
+			pRenderer->SetClip(0,0,static_cast<int>(cDeferredWidth),static_cast<int>(cDeferredHeight));
+			pRenderer->SetFrameBuffer(pDeferred);
+			pRenderer->SetDeferred(TRUE);
+			pRenderer->BeginScene();
+			DrawRandomCommands(pRenderer,pSprites);
+			Word uTest = (pRenderer->GetCommandCount()==0) || (MemoryCompare(pDeferred,pImmediate,uSize)==0);
+			pRenderer->EndScene();
+			uTest |= (pRenderer->GetCommandCount()!=0) || (MemoryCompare(pDeferred,pImmediate,uSize)!=0);
+			pRenderer->SetDeferred(FALSE);
+			uFailure |= uTest;
+			ReportFailure("Renderer::SetDeferred() %u bit output doesn't match immediate rendering",uTest,8U<<uDepth);
+		} while (++uDepth<3);
+	}
+	Free(pSprites);
+	Free(pDeferred);
+	Free(pImmediate);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the software renderers
+
+***************************************/
+
+int BURGER_API TestBrrenderer(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Renderer tests");
+	Word uResult = TestSoftware8();
+	uResult |= TestSoftware16();
+	uResult |= TestSoftware32();
+	uResult |= TestDeferred();
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,599 @@
+/***************************************
+
+	Unit tests for the resource file manager
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrrezfile.h"
+#include "common.h"
+#include "brrezfile.h"
+#include "brrezfilebuilder.h"
+#include "brcompresslzss.h"
+#include "brdecompresslzss.h"
+#include "brfilemanager.h"
+#include "brmemoryhandle.h"
+#include "brmemoryansi.h"
+#include "brmd5.h"
+#include "brendian.h"
+#include "brstringfunctions.h"
+
+using namespace Burger;
+
+//
+// Scratch file for the rez files created by the tests
+//
+
+#define REZTESTFILE "9:testbrrezfile.rez"
+
+//
+// Names for the test resources, they are stored in
+// two groups of resource numbers
+//
+
+static const char *g_RezNames[12] = {
+	"title.png",
+	"level1.dat",
+	"level2.dat",
+	"level3.dat",
+	"Music.OGG",
+	"fonts:small.fnt",
+	"fonts:large.fnt",
+	"sounds:jump.wav",
+	"sounds:land.wav",
+	"sounds:die.wav",
+	"credits.txt",
+	"a"
+};
+
+//
+// Resource number for each entry in g_RezNames
+//
+
+static Word GetTestRezNum(Word uIndex)
+{
+	if (uIndex<6) {
+		return uIndex+1;
+	}
+	return uIndex+100;
+}
+
+//
+// Create compressible data that's unique to each resource
+//
+
+static void CreateRezData(Word8 *pOutput,WordPtr uLength,Word uIndex)
+{
+	Word32 uSeed = (uIndex*0x9E3779B9U)+1;
+	WordPtr i = 0;
+	do {
+		uSeed = (uSeed*1103515245U)+12345U;
+		// Runs of eight bytes give the compressor something to do
+		Word8 uValue = static_cast<Word8>(uSeed>>24U);
+		WordPtr uRun = 8;
+		do {
+			pOutput[i] = uValue;
+			if (++i>=uLength) {
+				break;
+			}
+		} while (--uRun);
+	} while (i<uLength);
+}
+
+static Compress * BURGER_API NewLZSS(void)
+{
+	return New<CompressLZSS>();
+}
+
+/***************************************
+
+	Create a version 2 rez file with the test resources
+	using RezFileBuilder, compressed with LZSS
+
+	\param uNamed \ref TRUE to give each resource a name
+	\param uLength Size of each resource in bytes
+	\return Zero if the file was saved
+
+***************************************/
+
+static Word CreateRezFile(Word uNamed,WordPtr uLength)
+{
+	Word8 *pBuffer = static_cast<Word8 *>(Alloc(uLength));
+	if (!pBuffer) {
+		return TRUE;
+	}
+	RezFileBuilder Builder;
+	Word uResult = Builder.AddCodec(NewLZSS);
+	Word i = 0;
+	do {
+		CreateRezData(pBuffer,uLength,i);
+		// Store every fourth resource so both load paths are tested
+		uResult |= Builder.AddBuffer(GetTestRezNum(i),uNamed ? g_RezNames[i] : NULL,pBuffer,uLength,(i&3) ? 0U : static_cast<Word>(RezFileBuilder::FLAG_STORE));
+	} while (++i<BURGER_ARRAYSIZE(g_RezNames));
+	Free(pBuffer);
+	if (!uResult) {
+		uResult = Builder.Save(REZTESTFILE);
+	}
+	return uResult;
+}
+
+/***************************************
+
+	Create a version 2 rez file with the test resources
+
+	The file is assembled here from the documented layout
+	so the reader doesn't depend on a tool to create it.
+	Every resource is stored without compression.
+
+	\param uNamed \ref TRUE to give each resource a name
+	\param uLength Size of each resource in bytes
+	\return Zero if the file was saved
+
+***************************************/
+
+static Word SaveRezFileV2(Word uNamed,WordPtr uLength)
+{
+	const Word cCount = BURGER_ARRAYSIZE(g_RezNames);
+	const Word cBuckets = 4;
+
+	// The name text starts with a zero, so an offset of zero means no name
+	Word32 NameOffsets[cCount];
+	WordPtr uTextSize = 0;
+	Word i = 0;
+	do {
+		NameOffsets[i] = 0;
+		if (uNamed) {
+			if (!uTextSize) {
+				uTextSize = 1;
+			}
+			NameOffsets[i] = static_cast<Word32>(uTextSize);
+			uTextSize += StringLength(g_RezNames[i])+1;
+		}
+	} while (++i<cCount);
+	Word uNameCount = uNamed ? cCount : 0;
+	Word uBucketCount = uNamed ? cBuckets : 0;
+	WordPtr uDirectorySize = (cCount*RezFile::FILEREZENTRYV2SIZE)+((uBucketCount+uNameCount)*sizeof(Word32))+uTextSize;
+	WordPtr uDataOffset = RezFile::ROOTHEADERV2SIZE+uDirectorySize;
+	WordPtr uFileSize = uDataOffset+(cCount*uLength);
+	Word8 *pFile = static_cast<Word8 *>(AllocClear(uFileSize));
+	if (!pFile) {
+		return TRUE;
+	}
+
+	RezFile::RootHeaderV2_t *pHeader = reinterpret_cast<RezFile::RootHeaderV2_t *>(pFile);
+	MemoryCopy(pHeader->m_Name,RezFile::g_RezFileSignatureV2,4);
+	pHeader->m_uHeaderSize = RezFile::ROOTHEADERV2SIZE;
+	pHeader->m_uEntryCount = cCount;
+	pHeader->m_uNameCount = uNameCount;
+	pHeader->m_uCodecCount = 0;
+	pHeader->m_uBucketCount = uBucketCount;
+	pHeader->m_uHashSeed = 0x52455A32U;
+	pHeader->m_uPageSize = 1;
+	pHeader->m_uTextSize = static_cast<Word32>(uTextSize);
+	pHeader->m_uDirectorySize = static_cast<Word32>(uDirectorySize);
+
+	// Entries in resource number order, the data follows the directory
+	RezFile::FileRezEntryV2_t *pEntry = reinterpret_cast<RezFile::FileRezEntryV2_t *>(pFile+RezFile::ROOTHEADERV2SIZE);
+	Word8 *pData = pFile+uDataOffset;
+	i = 0;
+	do {
+		CreateRezData(pData,uLength,i);
+		Hash(&pEntry->m_Hash,pData,uLength);
+		pEntry->m_uFileOffset = static_cast<Word64>(pData-pFile);
+		pEntry->m_uRezNum = GetTestRezNum(i);
+		pEntry->m_uLength = static_cast<Word32>(uLength);
+		pEntry->m_uCompressedLength = static_cast<Word32>(uLength);
+		pEntry->m_uNameOffset = NameOffsets[i];
+		LittleEndian::Fixup(&pEntry->m_uFileOffset);
+		LittleEndian::Fixup(&pEntry->m_uRezNum);
+		LittleEndian::Fixup(&pEntry->m_uLength);
+		LittleEndian::Fixup(&pEntry->m_uCompressedLength);
+		LittleEndian::Fixup(&pEntry->m_uNameOffset);
+		pData += uLength;
+		++pEntry;
+	} while (++i<cCount);
+
+	// Create the name hash, one bucket at a time find a seed
+	// that sends every name in the bucket to an unused slot
+	Word uResult = FALSE;
+	if (uNamed) {
+		Word32 *pBuckets = reinterpret_cast<Word32 *>(pEntry);
+		Word32 *pSlots = pBuckets+cBuckets;
+		Word uBucket = 0;
+		do {
+			Word32 uSeed = 0;
+			Word uTaken;
+			do {
+				uTaken = 0;
+				Word uMatch = TRUE;
+				i = 0;
+				do {
+					if ((RezFile::HashName(g_RezNames[i],pHeader->m_uHashSeed)%cBuckets)==uBucket) {
+						Word uSlot = RezFile::HashName(g_RezNames[i],uSeed)%cCount;
+						// Slots are marked by setting the resource number
+						if (pSlots[uSlot] || (uTaken&(1U<<uSlot))) {
+							uMatch = FALSE;
+							break;
+						}
+						uTaken |= 1U<<uSlot;
+					}
+				} while (++i<cCount);
+				if (uMatch) {
+					break;
+				}
+			} while (++uSeed<0x100000U);
+			if (uSeed>=0x100000U) {
+				uResult = TRUE;
+				break;
+			}
+			pBuckets[uBucket] = uSeed;
+			i = 0;
+			do {
+				if ((RezFile::HashName(g_RezNames[i],pHeader->m_uHashSeed)%cBuckets)==uBucket) {
+					pSlots[RezFile::HashName(g_RezNames[i],uSeed)%cCount] = GetTestRezNum(i);
+				}
+			} while (++i<cCount);
+		} while (++uBucket<cBuckets);
+
+		i = 0;
+		do {
+			LittleEndian::Fixup(&pBuckets[i]);
+		} while (++i<(cBuckets+cCount));
+
+		// Append the name text
+		char *pText = reinterpret_cast<char *>(pSlots+cCount);
+		i = 0;
+		do {
+			StringCopy(pText+NameOffsets[i],g_RezNames[i]);
+		} while (++i<cCount);
+	}
+
+	LittleEndian::Fixup(&pHeader->m_uHeaderSize);
+	LittleEndian::Fixup(&pHeader->m_uEntryCount);
+	LittleEndian::Fixup(&pHeader->m_uNameCount);
+	LittleEndian::Fixup(&pHeader->m_uBucketCount);
+	LittleEndian::Fixup(&pHeader->m_uHashSeed);
+	LittleEndian::Fixup(&pHeader->m_uPageSize);
+	LittleEndian::Fixup(&pHeader->m_uTextSize);
+	LittleEndian::Fixup(&pHeader->m_uDirectorySize);
+	if (!uResult) {
+		uResult = !FileManager::SaveFile(REZTESTFILE,pFile,uFileSize);
+	}
+	Free(pFile);
+	return uResult;
+}
+
+/***************************************
+
+	Open a rez file without names
+
+	The name text block is empty, entries with a name
+	offset of zero must be accepted
+
+***************************************/
+
+static Word TestRezUnnamed(MemoryManagerHandle *pHandles)
+{
+	Word uFailure = SaveRezFileV2(FALSE,1024);
+	ReportFailure("SaveRezFileV2(\"" REZTESTFILE "\") without names failed",uFailure);
+	if (!uFailure) {
+		RezFile MyRez(pHandles);
+		Word uReturn = MyRez.Init(REZTESTFILE);
+		Word uTest = uReturn!=FALSE;
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"" REZTESTFILE "\") without names = %u",uTest,uReturn);
+		if (!uReturn) {
+			Word uLowest = MyRez.GetLowestRezNum();
+			Word uHighest = MyRez.GetHighestRezNum();
+			uTest = (uLowest!=GetTestRezNum(0)) || (uHighest!=GetTestRezNum(BURGER_ARRAYSIZE(g_RezNames)-1));
+			uFailure |= uTest;
+			ReportFailure("RezFile resource numbers %u to %u",uTest,uLowest,uHighest);
+			const RezFile &rConstRez = MyRez;
+			Word uCount = rConstRez.GetNameArraySize();
+			uTest = (uCount!=0) || (rConstRez.GetNameArray()!=NULL);
+			uFailure |= uTest;
+			ReportFailure("RezFile::GetNameArraySize() without names = %u",uTest,uCount);
+			uReturn = MyRez.GetRezNum(g_RezNames[0]);
+			uTest = uReturn!=RezFile::INVALIDREZNUM;
+			uFailure |= uTest;
+			ReportFailure("RezFile::GetRezNum(\"%s\") without names = %u",uTest,g_RezNames[0],uReturn);
+			MyRez.Shutdown();
+		}
+	}
+	FileManager::DeleteFile(REZTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Look up every name with the perfect hash
+
+***************************************/
+
+static Word TestRezNameLookup(MemoryManagerHandle *pHandles)
+{
+	Word uFailure = SaveRezFileV2(TRUE,256);
+	ReportFailure("SaveRezFileV2(\"" REZTESTFILE "\") with names failed",uFailure);
+	if (!uFailure) {
+		RezFile MyRez(pHandles);
+		Word uReturn = MyRez.Init(REZTESTFILE);
+		Word uTest = uReturn!=FALSE;
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"" REZTESTFILE "\") with names = %u",uTest,uReturn);
+		if (!uReturn) {
+			Word i = 0;
+			do {
+				Word uRezNum = MyRez.GetRezNum(g_RezNames[i]);
+				uTest = uRezNum!=GetTestRezNum(i);
+				uFailure |= uTest;
+				ReportFailure("RezFile::GetRezNum(\"%s\") = %u, expected %u",uTest,g_RezNames[i],uRezNum,GetTestRezNum(i));
+
+				// The hash ignores case
+				char UpperName[64];
+				StringCopy(UpperName,sizeof(UpperName),g_RezNames[i]);
+				StringUppercase(UpperName);
+				uRezNum = MyRez.GetRezNum(UpperName);
+				uTest = uRezNum!=GetTestRezNum(i);
+				uFailure |= uTest;
+				ReportFailure("RezFile::GetRezNum(\"%s\") = %u, expected %u",uTest,UpperName,uRezNum,GetTestRezNum(i));
+			} while (++i<BURGER_ARRAYSIZE(g_RezNames));
+
+			// Names that aren't in the file
+			static const char *s_Misses[4] = {"notthere.dat","level4.dat","title.pn","b"};
+			i = 0;
+			do {
+				Word uRezNum = MyRez.GetRezNum(s_Misses[i]);
+				uTest = uRezNum!=RezFile::INVALIDREZNUM;
+				uFailure |= uTest;
+				ReportFailure("RezFile::GetRezNum(\"%s\") = %u, expected a miss",uTest,s_Misses[i],uRezNum);
+			} while (++i<BURGER_ARRAYSIZE(s_Misses));
+
+			// The sorted name list is created on demand by a const function
+			const RezFile &rConstRez = MyRez;
+			Word uCount = rConstRez.GetNameArraySize();
+			const RezFile::FilenameToRezNum_t *pNames = rConstRez.GetNameArray();
+			uTest = (uCount!=BURGER_ARRAYSIZE(g_RezNames)) || !pNames;
+			uFailure |= uTest;
+			ReportFailure("RezFile::GetNameArraySize() = %u",uTest,uCount);
+			if (!uTest) {
+				i = 1;
+				do {
+					uTest = StringCaseCompare(pNames[i-1].m_pRezName,pNames[i].m_pRezName)>=0;
+					uFailure |= uTest;
+					ReportFailure("RezFile::GetNameArray() \"%s\" is not before \"%s\"",uTest,pNames[i-1].m_pRezName,pNames[i].m_pRezName);
+				} while (++i<uCount);
+			}
+			MyRez.Shutdown();
+		}
+	}
+	FileManager::DeleteFile(REZTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Save the test resources with RezFileBuilder and
+	read them back with RezFile
+
+	\param pHandles Handle based memory manager for the RezFile
+	\param uNamed \ref TRUE to give each resource a name
+
+***************************************/
+
+static Word TestRezRoundTrip(MemoryManagerHandle *pHandles,Word uNamed)
+{
+	const WordPtr cLength = 5000;
+	const char *pType = uNamed ? "with names" : "without names";
+	Word8 *pExpected = static_cast<Word8 *>(Alloc(cLength*2));
+	if (!pExpected) {
+		ReportFailure("Out of memory in TestRezRoundTrip()",TRUE);
+		return TRUE;
+	}
+	Word8 *pRead = pExpected+cLength;
+	Word uFailure = CreateRezFile(uNamed,cLength);
+	ReportFailure("RezFileBuilder::Save(\"" REZTESTFILE "\") %s failed",uFailure,pType);
+	if (!uFailure) {
+		RezFile MyRez(pHandles);
+		Word uReturn = MyRez.Init(REZTESTFILE);
+		Word uTest = uReturn!=FALSE;
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"" REZTESTFILE "\") %s = %u",uTest,pType,uReturn);
+		if (!uReturn) {
+			// Decompress with the codec the builder used
+			DecompressLZSS LZSS;
+			MyRez.LogDecompressor(1,&LZSS);
+			MyRez.SetExternalFlag(FALSE);
+			Word i = 0;
+			do {
+				Word uRezNum = GetTestRezNum(i);
+				CreateRezData(pExpected,cLength,i);
+
+				// Load into memory
+				Word uLoaded = FALSE;
+				const Word8 *pData = static_cast<const Word8 *>(MyRez.Load(uRezNum,&uLoaded));
+				uTest = (!pData) || (!uLoaded) || MemoryCompare(pData,pExpected,cLength);
+				uFailure |= uTest;
+				ReportFailure("RezFile::Load(%u) %s returned bad data",uTest,uRezNum,pType);
+				if (pData) {
+					MyRez.Release(uRezNum);
+				}
+
+				// Read into a buffer
+				MemoryClear(pRead,cLength);
+				uReturn = MyRez.Read(uRezNum,pRead,cLength);
+				uTest = (uReturn!=FALSE) || MemoryCompare(pRead,pExpected,cLength);
+				uFailure |= uTest;
+				ReportFailure("RezFile::Read(%u) %s = %u",uTest,uRezNum,pType,uReturn);
+
+				// The builder stored a hash of the data
+				MD5_t Expected;
+				MD5_t Stored;
+				Hash(&Expected,pExpected,cLength);
+				uReturn = MyRez.GetHash(uRezNum,&Stored);
+				uTest = (uReturn!=FALSE) || MemoryCompare(&Expected,&Stored,sizeof(MD5_t));
+				uFailure |= uTest;
+				ReportFailure("RezFile::GetHash(%u) %s = %u",uTest,uRezNum,pType,uReturn);
+
+				// Only named resources have names
+				char NameBuffer[64];
+				uReturn = MyRez.GetName(uRezNum,NameBuffer,sizeof(NameBuffer));
+				if (uNamed) {
+					uTest = (uReturn!=FALSE) || StringCompare(NameBuffer,g_RezNames[i]);
+				} else {
+					uTest = uReturn==FALSE;
+				}
+				uFailure |= uTest;
+				ReportFailure("RezFile::GetName(%u) %s = %u",uTest,uRezNum,pType,uReturn);
+			} while (++i<BURGER_ARRAYSIZE(g_RezNames));
+
+			// Resources between the groups don't exist
+			uTest = MyRez.Load(GetTestRezNum(6)-1)!=NULL;
+			uFailure |= uTest;
+			ReportFailure("RezFile::Load(%u) %s found a missing resource",uTest,GetTestRezNum(6)-1,pType);
+			MyRez.Shutdown();
+		}
+	}
+	Free(pExpected);
+	FileManager::DeleteFile(REZTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Load more resources than the cache budget holds
+	and check that the least recently used ones were
+	released
+
+***************************************/
+
+static Word LoadAndRelease(RezFile *pRez,Word uIndex,Word uExpectLoad)
+{
+	Word uRezNum = GetTestRezNum(uIndex);
+	Word uLoaded = FALSE;
+	void *pData = pRez->Load(uRezNum,&uLoaded);
+	Word uTest = (!pData) || (uLoaded!=uExpectLoad);
+	ReportFailure("RezFile::Load(%u) with a budget, loaded = %u, expected %u",uTest,uRezNum,uLoaded,uExpectLoad);
+	if (pData) {
+		pRez->Release(uRezNum);
+		// A budget of zero is no limit
+		WordPtr uBudget = pRez->GetCacheBudget();
+		WordPtr uUsed = pRez->GetCacheUsed();
+		Word uOver = uBudget && (uUsed>uBudget);
+		uTest |= uOver;
+		ReportFailure("RezFile::Release(%u) left %u bytes in the cache, budget is %u",uOver,uRezNum,static_cast<Word>(uUsed),static_cast<Word>(uBudget));
+	}
+	return uTest;
+}
+
+static Word TestRezCacheBudget(MemoryManagerHandle *pHandles)
+{
+	const WordPtr cLength = 1000;
+	Word uFailure = CreateRezFile(FALSE,cLength);
+	ReportFailure("RezFileBuilder::Save(\"" REZTESTFILE "\") for the budget test failed",uFailure);
+	if (!uFailure) {
+		RezFile MyRez(pHandles);
+		Word uReturn = MyRez.Init(REZTESTFILE);
+		Word uTest = uReturn!=FALSE;
+		uFailure |= uTest;
+		ReportFailure("RezFile::Init(\"" REZTESTFILE "\") for the budget test = %u",uTest,uReturn);
+		if (!uReturn) {
+			DecompressLZSS LZSS;
+			MyRez.LogDecompressor(1,&LZSS);
+			MyRez.SetExternalFlag(FALSE);
+
+			// Room for three resources
+			MyRez.SetCacheBudget(cLength*3);
+			MyRez.ResetCacheCounters();
+
+			// Cycle eight resources through the cache, the first
+			// five must be released to stay within the budget
+			Word i = 0;
+			do {
+				uFailure |= LoadAndRelease(&MyRez,i,TRUE);
+			} while (++i<8);
+			Word32 uEvictions = MyRez.GetCacheEvictionCount();
+			WordPtr uUsed = MyRez.GetCacheUsed();
+			uTest = (uEvictions!=5) || (uUsed!=(cLength*3));
+			uFailure |= uTest;
+			ReportFailure("RezFile cache after 8 loads, evictions = %u, used = %u",uTest,static_cast<Word>(uEvictions),static_cast<Word>(uUsed));
+
+			// Resources 5, 6 and 7 are in memory, using 5 makes 6
+			// the least recently used so it's released when 0 is loaded
+			uFailure |= LoadAndRelease(&MyRez,5,FALSE);
+			uFailure |= LoadAndRelease(&MyRez,0,TRUE);
+			uFailure |= LoadAndRelease(&MyRez,7,FALSE);
+			uFailure |= LoadAndRelease(&MyRez,5,FALSE);
+			uFailure |= LoadAndRelease(&MyRez,6,TRUE);
+
+			Word32 uHits = MyRez.GetCacheHitCount();
+			Word32 uMisses = MyRez.GetCacheMissCount();
+			uEvictions = MyRez.GetCacheEvictionCount();
+			uTest = (uHits!=3) || (uMisses!=10) || (uEvictions!=7);
+			uFailure |= uTest;
+			ReportFailure("RezFile cache hits = %u, misses = %u, evictions = %u",uTest,static_cast<Word>(uHits),static_cast<Word>(uMisses),static_cast<Word>(uEvictions));
+
+			// Resources in use are never released, even over budget
+			i = 0;
+			do {
+				uTest = MyRez.Load(GetTestRezNum(i))==NULL;
+				uFailure |= uTest;
+				ReportFailure("RezFile::Load(%u) over the budget failed",uTest,GetTestRezNum(i));
+			} while (++i<5);
+			uUsed = MyRez.GetCacheUsed();
+			uTest = uUsed!=(cLength*5);
+			uFailure |= uTest;
+			ReportFailure("RezFile cache with 5 resources in use = %u",uTest,static_cast<Word>(uUsed));
+
+			// Releasing them brings the cache back within the budget
+			i = 0;
+			do {
+				MyRez.Release(GetTestRezNum(i));
+			} while (++i<5);
+			uUsed = MyRez.GetCacheUsed();
+			uTest = uUsed!=(cLength*3);
+			uFailure |= uTest;
+			ReportFailure("RezFile cache after releasing = %u",uTest,static_cast<Word>(uUsed));
+
+			// Removing the budget keeps everything
+			MyRez.SetCacheBudget(0);
+			i = 0;
+			do {
+				uFailure |= LoadAndRelease(&MyRez,i,i<2);
+			} while (++i<5);
+			uUsed = MyRez.GetCacheUsed();
+			uTest = uUsed!=(cLength*5);
+			uFailure |= uTest;
+			ReportFailure("RezFile cache without a budget = %u",uTest,static_cast<Word>(uUsed));
+			MyRez.Shutdown();
+		}
+	}
+	FileManager::DeleteFile(REZTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the rez file manager
+
+***************************************/
+
+int BURGER_API TestBrrezfile(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	MemoryManagerGlobalHandle Handles(0x400000);
+	FileManager::Init();
+	Message("Running RezFile tests");
+	Word uResult = TestRezUnnamed(&Handles);
+	uResult |= TestRezNameLookup(&Handles);
+	uResult |= TestRezRoundTrip(&Handles,FALSE);
+	uResult |= TestRezRoundTrip(&Handles,TRUE);
+	uResult |= TestRezCacheBudget(&Handles);
+	FileManager::Shutdown();
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,399 @@
+/***************************************
+
+	Unit tests for the lock free ring buffer queues
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrringqueue.h"
+#include "common.h"
+#include "brringqueue.h"
+#include "brqueue.h"
+#include "brcriticalsection.h"
+#include "brstringfunctions.h"
+#include "brtick.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded tests
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USETHREADS
+#endif
+
+//
+// Class that tracks how many copies are alive to
+// test that the queues construct and destroy entries
+//
+
+class Tracked {
+public:
+	static Word s_uAlive;
+	Word32 m_uValue;
+	Tracked() : m_uValue(0) { ++s_uAlive; }
+	Tracked(Word32 uValue) : m_uValue(uValue) { ++s_uAlive; }
+	Tracked(const Tracked &rInput) : m_uValue(rInput.m_uValue) { ++s_uAlive; }
+	~Tracked() { --s_uAlive; }
+	Tracked &operator=(const Tracked &rInput) { m_uValue = rInput.m_uValue; return *this; }
+};
+
+Word Tracked::s_uAlive;
+
+/***************************************
+
+	Test a queue from a single thread, this is a template
+	since both queue classes share the same interface
+
+***************************************/
+
+template<class Q>
+static Word TestSingleThread(Q *pQueue,const char *pName)
+{
+	Word uResult = FALSE;
+
+	// Capacity rounds up to a power of 2
+	Word uFailure = pQueue->Init(5)!=0;
+	uFailure |= pQueue->capacity()!=8;
+	uFailure |= !pQueue->empty();
+	uResult |= uFailure;
+	ReportFailure("%s::Init(5)",uFailure,pName);
+
+	// Fill it and make sure the overflow is rejected
+	Word32 i = 0;
+	do {
+		uFailure = !pQueue->push(Tracked(i+100));
+		uResult |= uFailure;
+		ReportFailure("%s::push(%u)",uFailure,pName,i);
+	} while (++i<8);
+	uFailure = pQueue->push(Tracked(999))!=FALSE;
+	uFailure |= pQueue->size()!=8;
+	uFailure |= Tracked::s_uAlive!=8;
+	uResult |= uFailure;
+	ReportFailure("%s::push() on a full queue",uFailure,pName);
+
+	// Empty it in order
+	Tracked Value;
+	i = 0;
+	do {
+		uFailure = !pQueue->pop(&Value);
+		uFailure |= Value.m_uValue!=(i+100);
+		uResult |= uFailure;
+		ReportFailure("%s::pop() returned %u, expected %u",uFailure,pName,Value.m_uValue,i+100);
+	} while (++i<8);
+	uFailure = pQueue->pop(&Value)!=FALSE;
+	uFailure |= !pQueue->empty();
+	uFailure |= Tracked::s_uAlive!=1;
+	uResult |= uFailure;
+	ReportFailure("%s::pop() on an empty queue",uFailure,pName);
+
+	// Run the indexes around the ring many times
+	Word32 uNext = 0;
+	Word32 uExpected = 0;
+	i = 0;
+	do {
+		Word32 j = 0;
+		do {
+			pQueue->push(Tracked(uNext));
+			++uNext;
+		} while (++j<5);
+		j = 0;
+		do {
+			uFailure = !pQueue->pop(&Value);
+			uFailure |= Value.m_uValue!=uExpected;
+			uResult |= uFailure;
+			ReportFailure("%s::pop() wrap returned %u, expected %u",uFailure,pName,Value.m_uValue,uExpected);
+			++uExpected;
+		} while (++j<5);
+	} while (++i<1000);
+
+	// Batches only transfer what fits
+	Tracked Batch[20];
+	i = 0;
+	do {
+		Batch[i].m_uValue = i;
+	} while (++i<20);
+	WordPtr uCount = pQueue->push(Batch,20);
+	uFailure = uCount!=8;
+	uResult |= uFailure;
+	ReportFailure("%s::push(Batch,20) returned %u, expected 8",uFailure,pName,static_cast<Word>(uCount));
+	uCount = pQueue->push(Batch,20);
+	uFailure = uCount!=0;
+	uResult |= uFailure;
+	ReportFailure("%s::push(Batch,20) on a full queue returned %u",uFailure,pName,static_cast<Word>(uCount));
+
+	Tracked Output[20];
+	uCount = pQueue->pop(Output,3);
+	uCount += pQueue->pop(Output+3,10);
+	uFailure = uCount!=8;
+	i = 0;
+	do {
+		uFailure |= Output[i].m_uValue!=i;
+	} while (++i<8);
+	uFailure |= pQueue->pop(Output,20)!=0;
+	uResult |= uFailure;
+	ReportFailure("%s::pop(Output,Count)",uFailure,pName);
+
+	// Shutdown must release entries still in the queue
+	pQueue->push(Batch,3);
+	Word uAlive = Tracked::s_uAlive;
+	pQueue->Shutdown();
+	uFailure = Tracked::s_uAlive!=(uAlive-3);
+	uFailure |= pQueue->capacity()!=0;
+	uResult |= uFailure;
+	ReportFailure("%s::Shutdown() didn't destroy the remaining entries",uFailure,pName);
+	return uResult;
+}
+
+#if defined(USETHREADS)
+
+//
+// Give up the CPU if a queue stays full or empty,
+// in case there are more threads than CPUs
+//
+
+static BURGER_INLINE void Backoff(Word *pSpins)
+{
+	if (++pSpins[0]>=64) {
+		pSpins[0] = 0;
+		Sleep(SLEEP_YIELD);
+	}
+}
+
+struct ThreadTest_t {
+	SPSCQueue<Word32> *m_pSPSC;		// Queue for single producer tests
+	MPMCQueue<Word32> *m_pMPMC;		// Queue for multiple producer tests
+	volatile Word32 *m_pConsumed;	// Number of entries consumed by all threads
+	Word32 m_uID;					// Producer number, stored in the upper 8 bits of each entry
+	Word32 m_uCount;				// Number of entries to produce, or total to consume
+	Word32 m_uProducers;			// Number of producer threads
+	Word32 m_uSum;					// Sum of all entries consumed
+	Word m_uFailure;				// Set if entries arrived out of order
+};
+
+//
+// Send 1 through m_uCount with a mix of single and batch pushes
+//
+
+static WordPtr BURGER_API SPSCProducer(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	Word32 uNext = 1;
+	Word uSpins = 0;
+	while (uNext<=pTest->m_uCount) {
+		if (uNext&32) {
+			Word32 Batch[7];
+			Word32 i = 0;
+			do {
+				Batch[i] = uNext+i;
+			} while (++i<7);
+			WordPtr uMax = (pTest->m_uCount+1)-uNext;
+			WordPtr uCount = pTest->m_pSPSC->push(Batch,(uMax<7) ? uMax : 7);
+			if (!uCount) {
+				Backoff(&uSpins);
+			}
+			uNext += static_cast<Word32>(uCount);
+		} else if (pTest->m_pSPSC->push(uNext)) {
+			++uNext;
+		} else {
+			Backoff(&uSpins);
+		}
+	}
+	return 0;
+}
+
+static WordPtr BURGER_API SPSCConsumer(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	Word32 uExpected = 1;
+	Word uSpins = 0;
+	while (uExpected<=pTest->m_uCount) {
+		Word32 Batch[5];
+		WordPtr uCount = pTest->m_pSPSC->pop(Batch,(uExpected&64) ? 5U : 1U);
+		if (!uCount) {
+			Backoff(&uSpins);
+		} else {
+			WordPtr i = 0;
+			do {
+				if (Batch[i]!=uExpected) {
+					pTest->m_uFailure = TRUE;
+				}
+				pTest->m_uSum += Batch[i];
+				++uExpected;
+			} while (++i<uCount);
+		}
+	}
+	return 0;
+}
+
+//
+// Send 1 through m_uCount tagged with the producer number
+//
+
+static WordPtr BURGER_API MPMCProducer(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	Word32 uTag = pTest->m_uID<<24U;
+	Word32 uNext = 1;
+	Word uSpins = 0;
+	while (uNext<=pTest->m_uCount) {
+		if (uNext&16) {
+			Word32 Batch[3];
+			Word32 i = 0;
+			do {
+				Batch[i] = uTag|(uNext+i);
+			} while (++i<3);
+			WordPtr uMax = (pTest->m_uCount+1)-uNext;
+			WordPtr uCount = pTest->m_pMPMC->push(Batch,(uMax<3) ? uMax : 3);
+			if (!uCount) {
+				Backoff(&uSpins);
+			}
+			uNext += static_cast<Word32>(uCount);
+		} else if (pTest->m_pMPMC->push(uTag|uNext)) {
+			++uNext;
+		} else {
+			Backoff(&uSpins);
+		}
+	}
+	return 0;
+}
+
+//
+// Entries from each producer must arrive in increasing order
+//
+
+static WordPtr BURGER_API MPMCConsumer(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	Word32 Last[8];
+	Word32 i = 0;
+	do {
+		Last[i] = 0;
+	} while (++i<8);
+	Word uSpins = 0;
+	Word32 uPass = 0;
+	while (AtomicGet(pTest->m_pConsumed)<pTest->m_uCount) {
+		Word32 Batch[4];
+		WordPtr uCount = pTest->m_pMPMC->pop(Batch,(++uPass&1) ? 4U : 1U);
+		if (!uCount) {
+			Backoff(&uSpins);
+		} else {
+			WordPtr j = 0;
+			do {
+				Word32 uValue = Batch[j];
+				Word32 uID = uValue>>24U;
+				uValue &= 0xFFFFFFU;
+				if ((uID>=pTest->m_uProducers) || (uValue<=Last[uID])) {
+					pTest->m_uFailure = TRUE;
+				} else {
+					Last[uID] = uValue;
+				}
+				pTest->m_uSum += uValue;
+			} while (++j<uCount);
+			AtomicAdd(pTest->m_pConsumed,static_cast<Word32>(uCount));
+		}
+	}
+	return 0;
+}
+
+/***************************************
+
+	Pass data between threads and verify
+	nothing is lost, duplicated or reordered
+
+***************************************/
+
+static Word TestThreads(void)
+{
+	Word uResult = FALSE;
+	const Word32 cCount = 200000;
+
+	// One producer, one consumer
+	SPSCQueue<Word32> SPSC;
+	SPSC.Init(64);
+	ThreadTest_t Producer;
+	MemoryClear(&Producer,sizeof(Producer));
+	Producer.m_pSPSC = &SPSC;
+	Producer.m_uCount = cCount;
+	ThreadTest_t Consumer = Producer;
+	Thread ProducerThread;
+	Thread ConsumerThread;
+	ConsumerThread.Start(SPSCConsumer,&Consumer);
+	ProducerThread.Start(SPSCProducer,&Producer);
+	ProducerThread.Wait();
+	ConsumerThread.Wait();
+	Word32 uSum = (cCount/2U)*(cCount+1U);
+	Word uFailure = Consumer.m_uFailure || (Consumer.m_uSum!=uSum) || !SPSC.empty();
+	uResult |= uFailure;
+	ReportFailure("SPSCQueue between two threads, sum %08X, expected %08X",uFailure,Consumer.m_uSum,uSum);
+
+	// Four producers, four consumers fighting over a small queue
+	const Word32 cThreads = 4;
+	const Word32 cPerThread = 50000;
+	MPMCQueue<Word32> MPMC;
+	MPMC.Init(32);
+	volatile Word32 uConsumed = 0;
+	ThreadTest_t Tests[cThreads*2];
+	Thread Threads[cThreads*2];
+	Word32 i = 0;
+	do {
+		MemoryClear(&Tests[i],sizeof(Tests[i]));
+		Tests[i].m_pMPMC = &MPMC;
+		Tests[i].m_pConsumed = &uConsumed;
+		Tests[i].m_uID = i;
+		Tests[i].m_uProducers = cThreads;
+		Tests[i].m_uCount = (i<cThreads) ? cPerThread : cPerThread*cThreads;
+		Threads[i].Start((i<cThreads) ? MPMCProducer : MPMCConsumer,&Tests[i]);
+	} while (++i<(cThreads*2));
+	uSum = 0;
+	uFailure = FALSE;
+	i = 0;
+	do {
+		Threads[i].Wait();
+		if (i>=cThreads) {
+			uSum += Tests[i].m_uSum;
+			uFailure |= Tests[i].m_uFailure;
+		}
+	} while (++i<(cThreads*2));
+	Word32 uExpected = (cPerThread/2U)*(cPerThread+1U)*cThreads;
+	uFailure |= (uSum!=uExpected) || (uConsumed!=(cPerThread*cThreads)) || !MPMC.empty();
+	uResult |= uFailure;
+	ReportFailure("MPMCQueue between %u threads, sum %08X, expected %08X",uFailure,cThreads*2,uSum,uExpected);
+	return uResult;
+}
+#endif
+
+/***************************************
+
+	Test the ring buffer queues
+
+***************************************/
+
+int BURGER_API TestBrringqueue(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Ring Queue tests");
+	Tracked::s_uAlive = 0;
+	Word uResult;
+	{
+		SPSCQueue<Tracked> SPSC;
+		uResult = TestSingleThread(&SPSC,"SPSCQueue");
+		MPMCQueue<Tracked> MPMC;
+		uResult |= TestSingleThread(&MPMC,"MPMCQueue");
+	}
+	Word uFailure = Tracked::s_uAlive!=0;
+	uResult |= uFailure;
+	ReportFailure("Ring queues leaked %u entries",uFailure,Tracked::s_uAlive);
+#if defined(USETHREADS)
+	uResult |= TestThreads();
+#endif
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,242 @@
+/***************************************
+
+	Unit tests for the smart pointer classes
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrsmartpointer.h"
+#include "common.h"
+#include "brsmartpointer.h"
+#include "brcriticalsection.h"
+#include "brtick.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Only platforms with preemptive threads can run the multi-threaded tests
+//
+
+#if defined(BURGER_WINDOWS) || defined(BURGER_XBOX360) || defined(BURGER_MACOSX) || defined(BURGER_IOS)
+#define USETHREADS
+#endif
+
+//
+// Number of objects of either type that were deleted
+//
+
+static volatile Word32 g_uDeleted;
+
+class SingleObject : public ReferenceCounter {
+	BURGER_ALLOW_WEAK_POINTERS();
+public:
+	Word m_uValue;
+	SingleObject() : m_uValue(0) {}
+	~SingleObject() { AtomicPreIncrement(&g_uDeleted); }
+};
+
+class SharedObject : public AtomicReferenceCounter {
+	BURGER_ALLOW_WEAK_POINTERS();
+public:
+	Word m_uValue;
+	SharedObject() : m_uValue(0) {}
+	~SharedObject() { AtomicPreIncrement(&g_uDeleted); }
+};
+
+/***************************************
+
+	Test ownership and weak pointers, this is a template
+	since both reference counters share the same interface
+
+***************************************/
+
+template<class T>
+static Word TestOwnership(const char *pName)
+{
+	Word uResult = FALSE;
+	g_uDeleted = 0;
+
+	T *pObject = New<T>();
+	WeakPointer<T> pWeak;
+	{
+		SmartPointer<T> pFirst(pObject);
+		Word uFailure = pObject->GetRefCount()!=1;
+		uResult |= uFailure;
+		ReportFailure("%s SmartPointer(T *) count is %u, expected 1",uFailure,pName,pObject->GetRefCount());
+		{
+			SmartPointer<T> pSecond(pFirst);
+			SmartPointer<T> pThird;
+			pThird = pSecond;
+			uFailure = pObject->GetRefCount()!=3;
+			uResult |= uFailure;
+			ReportFailure("%s SmartPointer copies count is %u, expected 3",uFailure,pName,pObject->GetRefCount());
+		}
+		uFailure = (pObject->GetRefCount()!=1) || g_uDeleted;
+		uResult |= uFailure;
+		ReportFailure("%s ~SmartPointer() count is %u, expected 1",uFailure,pName,pObject->GetRefCount());
+
+		// Upgrading a weak pointer while an owner exists succeeds
+		pWeak = pFirst;
+		SmartPointer<T> pLocked = pWeak.Lock();
+		uFailure = (pLocked.GetPtr()!=pObject) || (pObject->GetRefCount()!=2);
+		uResult |= uFailure;
+		ReportFailure("%s WeakPointer::Lock() with an owner",uFailure,pName);
+	}
+
+	// The last owner is gone, so the weak pointer can't be upgraded
+	Word uFailure = g_uDeleted!=1;
+	uFailure |= pWeak.GetPtr()!=NULL;
+	uFailure |= pWeak.Lock().GetPtr()!=NULL;
+	uResult |= uFailure;
+	ReportFailure("%s WeakPointer::Lock() after deletion",uFailure,pName);
+
+	// TryAddRef() won't resurrect an unowned object
+	pObject = New<T>();
+	uFailure = pObject->TryAddRef()!=FALSE;
+	pObject->AddRef();
+	uFailure |= pObject->TryAddRef()!=TRUE;
+	uFailure |= pObject->GetRefCount()!=2;
+	uResult |= uFailure;
+	ReportFailure("%s TryAddRef()",uFailure,pName);
+	pObject->Release();
+	pObject->Release();
+	uFailure = g_uDeleted!=2;
+	uResult |= uFailure;
+	ReportFailure("%s Release() didn't delete the object",uFailure,pName);
+	return uResult;
+}
+
+#if defined(USETHREADS)
+
+struct ThreadTest_t {
+	SmartPointer<SharedObject> *m_pShared;	// Object every thread copies
+	WeakPointer<SharedObject> m_Weak;		// Private weak pointer to the object
+	volatile Word32 *m_pStart;				// Set when all threads are to begin
+	Word32 m_uCount;						// Number of iterations
+	Word32 m_uLocked;						// Number of successful WeakPointer::Lock() calls
+};
+
+//
+// Copy and destroy SmartPointers to one object as fast as possible
+//
+
+static WordPtr BURGER_API CopyThread(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	while (!AtomicGet(pTest->m_pStart)) {
+	}
+	Word32 uCount = pTest->m_uCount;
+	do {
+		SmartPointer<SharedObject> pCopy(pTest->m_pShared[0]);
+		SmartPointer<SharedObject> pCopy2;
+		pCopy2 = pCopy;
+	} while (--uCount);
+	return 0;
+}
+
+//
+// Upgrade a private copy of a weak pointer until the object is gone
+//
+
+static WordPtr BURGER_API LockThread(void *pData)
+{
+	ThreadTest_t *pTest = static_cast<ThreadTest_t *>(pData);
+	while (!AtomicGet(pTest->m_pStart)) {
+	}
+	for (;;) {
+		SmartPointer<SharedObject> pLocked = pTest->m_Weak.Lock();
+		if (!pLocked.GetPtr()) {
+			break;
+		}
+		++pLocked->m_uValue;
+		++pTest->m_uLocked;
+	}
+	return 0;
+}
+
+/***************************************
+
+	Hammer AtomicReferenceCounter from several threads
+
+***************************************/
+
+static Word TestThreads(void)
+{
+	Word uResult = FALSE;
+	const Word32 cThreads = 4;
+	ThreadTest_t Tests[cThreads];
+	Thread Threads[cThreads];
+	g_uDeleted = 0;
+
+	// Copies on all threads must leave the count unchanged
+	SharedObject *pObject = New<SharedObject>();
+	SmartPointer<SharedObject> pShared(pObject);
+	volatile Word32 uStart = 0;
+	Word32 i = 0;
+	do {
+		Tests[i].m_pShared = &pShared;
+		Tests[i].m_pStart = &uStart;
+		Tests[i].m_uCount = 200000;
+		Tests[i].m_uLocked = 0;
+		Threads[i].Start(CopyThread,&Tests[i]);
+	} while (++i<cThreads);
+	AtomicSet(&uStart,1);
+	i = 0;
+	do {
+		Threads[i].Wait();
+	} while (++i<cThreads);
+	Word uFailure = (pObject->GetRefCount()!=1) || g_uDeleted;
+	uResult |= uFailure;
+	ReportFailure("AtomicReferenceCounter count is %u after copies on %u threads",uFailure,pObject->GetRefCount(),cThreads);
+
+	// Release the last owner while other threads are upgrading weak pointers
+	WeakPointer<SharedObject> pWeak(pShared);
+	uStart = 0;
+	i = 0;
+	do {
+		Tests[i].m_Weak = pShared;
+		Threads[i].Start(LockThread,&Tests[i]);
+	} while (++i<cThreads);
+	AtomicSet(&uStart,1);
+	Sleep(10);
+	pShared = NULL;
+	Word32 uLocked = 0;
+	i = 0;
+	do {
+		Threads[i].Wait();
+		uLocked += Tests[i].m_uLocked;
+	} while (++i<cThreads);
+	uFailure = (g_uDeleted!=1) || pWeak.Lock().GetPtr();
+	uResult |= uFailure;
+	ReportFailure("WeakPointer::Lock() racing the last Release(), %u deletions",uFailure,g_uDeleted);
+	if (!uFailure) {
+		Message("WeakPointer::Lock() succeeded %u times before the object was released",uLocked);
+	}
+	return uResult;
+}
+#endif
+
+/***************************************
+
+	Test the smart pointers
+
+***************************************/
+
+int BURGER_API TestBrsmartpointer(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running SmartPointer tests");
+	Word uResult = TestOwnership<SingleObject>("ReferenceCounter");
+	uResult |= TestOwnership<SharedObject>("AtomicReferenceCounter");
+#if defined(USETHREADS)
+	uResult |= TestThreads();
+#endif
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,336 @@
+/***************************************
+
+	Unit tests for the software sound mixer
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrsound.h"
+#include "common.h"
+#include "brsoundmixer.h"
+#include "brstringfunctions.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Number of samples in the test sounds
+//
+
+static const Word cTestSamples = 1000;
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word GetRandom(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return static_cast<Word>((g_uSeed>>16U)%uRange);
+}
+
+//
+// Fill a buffer with random little endian 16 bit samples
+//
+
+static void FillSamples(Word8 *pOutput,Word uCount)
+{
+	do {
+		Word uSample = GetRandom(65536);
+		pOutput[0] = static_cast<Word8>(uSample);
+		pOutput[1] = static_cast<Word8>(uSample>>8U);
+		pOutput += 2;
+	} while (--uCount);
+}
+
+//
+// Absolute value of a float
+//
+
+static float Absolute(float fInput)
+{
+	return (fInput<0.0f) ? -fInput : fInput;
+}
+
+//
+// Completion function that counts calls
+//
+
+static void BURGER_API CountCompletion(void *pData)
+{
+	++static_cast<Word *>(pData)[0];
+}
+
+/***************************************
+
+	Test the sample conversion functions
+
+***************************************/
+
+static Word TestConvert(void)
+{
+	Word uResult = FALSE;
+
+	// Test little and big endian shorts with more samples than a SIMD register
+	static const Word8 LittleShorts[19*2] = {
+		0x00,0x80, 0x00,0x40, 0x00,0x00, 0xFF,0x7F, 0x00,0xC0, 0x01,0x00, 0xFF,0xFF, 0x00,0x20,
+		0x00,0xE0, 0x00,0x10, 0x00,0xF0, 0x34,0x12, 0xCC,0xED, 0x00,0x80, 0xFF,0x7F, 0x00,0x00,
+		0x00,0x01, 0x00,0xFF, 0x80,0x00
+	};
+	float Output[19];
+	SoundMixer::ConvertToFloat(Output,LittleShorts,19,Sound::TYPELSHORT);
+	Word8 BigShorts[19*2];
+	Word i = 0;
+	do {
+		Int16 iSample = static_cast<Int16>(LittleShorts[i*2]|(LittleShorts[(i*2)+1]<<8U));
+		Word uFailure = Output[i]!=(static_cast<float>(iSample)/32768.0f);
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::ConvertToFloat(TYPELSHORT) sample %u",uFailure,i);
+		BigShorts[i*2] = LittleShorts[(i*2)+1];
+		BigShorts[(i*2)+1] = LittleShorts[i*2];
+	} while (++i<19);
+	float Output2[19];
+	SoundMixer::ConvertToFloat(Output2,BigShorts,19,Sound::TYPEBSHORT);
+	Word uFailure = MemoryCompare(Output,Output2,sizeof(Output))!=0;
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::ConvertToFloat(TYPEBSHORT) doesn't match TYPELSHORT",uFailure);
+
+	// Test 8 bit samples
+	static const Word8 Bytes[4] = {0x00,0x80,0xFF,0x40};
+	static const float UnsignedFloats[4] = {-1.0f,0.0f,127.0f/128.0f,-0.5f};
+	static const float SignedFloats[4] = {0.0f,-1.0f,-1.0f/128.0f,0.5f};
+	SoundMixer::ConvertToFloat(Output,Bytes,4,Sound::TYPEBYTE);
+	uFailure = MemoryCompare(Output,UnsignedFloats,sizeof(UnsignedFloats))!=0;
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::ConvertToFloat(TYPEBYTE)",uFailure);
+	SoundMixer::ConvertToFloat(Output,Bytes,4,Sound::TYPECHAR);
+	uFailure = MemoryCompare(Output,SignedFloats,sizeof(SignedFloats))!=0;
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::ConvertToFloat(TYPECHAR)",uFailure);
+
+	// Test the conversion for *.WAV files, including clamping, rounding and NaN
+	union {
+		Word32 m_uBits;
+		float m_fValue;
+	} NaN;
+	NaN.m_uBits = 0x7FC00000U;
+	const float Floats[19] = {
+		1.0f,-1.0f,2.0f,-2.0f,0.5f,-0.5f,0.0f,NaN.m_fValue,
+		1.0f/32767.0f,-1.0f/32767.0f,0.25f,-0.25f,1000.0f,-1000.0f,0.99999f,
+		NaN.m_fValue,0.75f,-0.75f,1.25f/32767.0f
+	};
+	static const Int16 Shorts[19] = {
+		32767,-32767,32767,-32767,16384,-16384,0,-32767,
+		1,-1,8192,-8192,32767,-32767,32767,
+		-32767,24575,-24575,1
+	};
+	Int16 ShortOutput[19];
+	SoundSinkWaveFile::ConvertToInt16(ShortOutput,Floats,19);
+	i = 0;
+	do {
+		uFailure = ShortOutput[i]!=Shorts[i];
+		uResult |= uFailure;
+		ReportFailure("SoundSinkWaveFile::ConvertToInt16() sample %u = %d, expected %d",uFailure,i,ShortOutput[i],Shorts[i]);
+	} while (++i<19);
+	return uResult;
+}
+
+/***************************************
+
+	Test that voices are mixed sample accurately
+
+***************************************/
+
+static Word TestMixing(void)
+{
+	Word uResult = FALSE;
+	Word8 Samples[cTestSamples*2];
+	float Converted[cTestSamples];
+	g_uSeed = 0x12345678U;
+	FillSamples(Samples,cTestSamples);
+	SoundMixer::ConvertToFloat(Converted,Samples,cTestSamples,Sound::TYPELSHORT);
+
+	SoundMixer Mixer;
+	float Output[1200*2];
+	Mixer.Init(NULL,22050,2);
+
+	// Play a sound at the output rate at full volume, it should fade
+	// in and then be an exact copy
+	Word uCompletions = 0;
+	SoundMixer::VoiceInit_t Init;
+	Init.m_pSamples = Samples;
+	Init.m_uLength = sizeof(Samples);
+	Init.m_uLoopStart = 0;
+	Init.m_uLoopEnd = 0;
+	Init.m_pCompletion = CountCompletion;
+	Init.m_pCompletionData = &uCompletions;
+	Init.m_eDataType = Sound::TYPELSHORT;
+	Init.m_uSampleRate = 22050;
+	Init.m_uVolume = 255;
+	Init.m_uPan = 0x8000;
+	Word uVoiceID = Mixer.Play(&Init);
+	Word uFailure = !uVoiceID || !Mixer.IsVoicePlaying(uVoiceID);
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::Play() didn't start a voice",uFailure);
+
+	// Mix in odd sized pieces to test block boundaries
+	Mixer.Mix(Output,77);
+	Mixer.Mix(Output+(77*2),1200-77);
+	Word i = 0;
+	do {
+		float fExpected = (i<cTestSamples) ? Converted[i] : 0.0f;
+		if (i<SoundMixer::RAMPLENGTH) {
+			// While fading in, the volume never exceeds the source
+			uFailure = (Output[i*2]!=Output[(i*2)+1]) || (Absolute(Output[i*2])>Absolute(fExpected));
+		} else {
+			uFailure = (Output[i*2]!=fExpected) || (Output[(i*2)+1]!=fExpected);
+		}
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::Mix() unity gain frame %u",uFailure,i);
+	} while (++i<1200);
+	uFailure = (uCompletions!=1) || Mixer.IsVoicePlaying(uVoiceID) || Mixer.GetActiveVoiceCount();
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::Mix() completion function called %u times",uFailure,uCompletions);
+
+	// Play a loop, the first pass plays all samples and then
+	// the loop repeats forever
+	const Word cLoopStart = 300;
+	const Word cLoopEnd = 700;
+	Init.m_uLoopStart = cLoopStart;
+	Init.m_uLoopEnd = cLoopEnd;
+	Init.m_pCompletion = NULL;
+	uVoiceID = Mixer.Play(&Init);
+	Mixer.Mix(Output,1200);
+	Mixer.Mix(Output,1200);
+	i = 0;
+	do {
+		Word uFrame = i+1200;
+		Word uSample = cLoopStart+((uFrame-cLoopStart)%(cLoopEnd-cLoopStart));
+		uFailure = (Output[i*2]!=Converted[uSample]) || (Output[(i*2)+1]!=Converted[uSample]);
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::Mix() loop frame %u",uFailure,uFrame);
+	} while (++i<1200);
+
+	// Stopping fades out and then releases the voice
+	uFailure = Mixer.StopVoice(uVoiceID) || Mixer.IsVoicePlaying(uVoiceID) || (Mixer.GetActiveVoiceCount()!=1);
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::StopVoice() failed",uFailure);
+	float fPrevious = 2.0f;
+	Mixer.Mix(Output,SoundMixer::RAMPLENGTH);
+	i = 0;
+	do {
+		// Compare the gain against the source sample
+		Word uSample = cLoopStart+((i+1200+1200-cLoopStart)%(cLoopEnd-cLoopStart));
+		if (Converted[uSample]!=0.0f) {
+			float fGain = Output[i*2]/Converted[uSample];
+			uFailure = (fGain>fPrevious) || (fGain<-0.0001f);
+			uResult |= uFailure;
+			ReportFailure("SoundMixer::StopVoice() fade out frame %u",uFailure,i);
+			fPrevious = fGain+0.0001f;
+		}
+	} while (++i<SoundMixer::RAMPLENGTH);
+	uFailure = Mixer.GetActiveVoiceCount() || !Mixer.StopVoice(uVoiceID);
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::StopVoice() didn't release the voice",uFailure);
+
+	// Two voices panned hard left and right are mixed into separate channels,
+	// a third in the center is in both
+	Word8 Samples2[cTestSamples*2];
+	float Converted2[cTestSamples];
+	FillSamples(Samples2,cTestSamples);
+	SoundMixer::ConvertToFloat(Converted2,Samples2,cTestSamples,Sound::TYPELSHORT);
+	Init.m_uLoopStart = 0;
+	Init.m_uLoopEnd = 0;
+	Init.m_uPan = 0;
+	Mixer.Play(&Init);
+	Init.m_pSamples = Samples2;
+	Init.m_uPan = 0xFFFF;
+	Mixer.Play(&Init);
+	Init.m_uPan = 0x8000;
+	Init.m_uVolume = 0;
+	Word uQuiet = Mixer.Play(&Init);
+	Mixer.Mix(Output,200);
+	i = SoundMixer::RAMPLENGTH;
+	do {
+		uFailure = (Output[i*2]!=Converted[i]) || (Output[(i*2)+1]!=Converted2[i]);
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::Mix() panning frame %u",uFailure,i);
+	} while (++i<200);
+
+	// Raise the volume of the center voice, it ramps in without a click
+	Mixer.SetVoiceVolume(uQuiet,255);
+	Mixer.Mix(Output,200);
+	i = 0;
+	do {
+		// Remove the left voice to leave the center voice
+		float fCenter = Output[i*2]-Converted[i+200];
+		if (i<SoundMixer::RAMPLENGTH) {
+			uFailure = Absolute(fCenter)>(Absolute(Converted2[i+200])+0.00001f);
+		} else {
+			uFailure = Absolute(fCenter-Converted2[i+200])>0.00001f;
+		}
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::SetVoiceVolume() frame %u",uFailure,i+200);
+	} while (++i<200);
+	Mixer.StopAll();
+	Mixer.Mix(Output,SoundMixer::RAMPLENGTH);
+	uFailure = Mixer.GetActiveVoiceCount()!=0;
+	uResult |= uFailure;
+	ReportFailure("SoundMixer::StopAll() didn't release the voices",uFailure);
+
+	// Play at half the output rate, every other frame is interpolated
+	Init.m_pSamples = Samples;
+	Init.m_uSampleRate = 11025;
+	Init.m_uVolume = 255;
+	Init.m_uPan = 0x8000;
+	Mixer.Play(&Init);
+	Mixer.Mix(Output,1200);
+	i = SoundMixer::RAMPLENGTH;
+	do {
+		Word uSample = i>>1U;
+		float fExpected = Converted[uSample];
+		if (i&1U) {
+			fExpected = (fExpected+Converted[uSample+1])*0.5f;
+		}
+		uFailure = Absolute(Output[i*2]-fExpected)>0.00001f;
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::Mix() resampling frame %u",uFailure,i);
+	} while (++i<1200);
+
+	// Mono output is the average of the stereo gains
+	Mixer.Init(NULL,22050,1);
+	Init.m_uSampleRate = 22050;
+	Init.m_uPan = 0;
+	Mixer.Play(&Init);
+	Mixer.Mix(Output,200);
+	i = SoundMixer::RAMPLENGTH;
+	do {
+		uFailure = Output[i]!=(Converted[i]*0.5f);
+		uResult |= uFailure;
+		ReportFailure("SoundMixer::Mix() mono frame %u",uFailure,i);
+	} while (++i<200);
+	return uResult;
+}
+
+/***************************************
+
+	Test the software mixer
+
+***************************************/
+
+int BURGER_API TestBrsound(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	Message("Running Sound tests");
+	Word uResult = TestConvert();
+	uResult |= TestMixing();
+	return static_cast<int>(uResult);
+}
@@ -0,0 +1,507 @@
+/***************************************
+
+	Unit tests for the memory stream classes
+
+	Copyright 1995-2014 by Rebecca Ann Heineman becky@burgerbecky.com
+
+	It is released under an MIT Open Source license. Please see LICENSE
+	for license details. Yes, you can use it in a
+	commercial title without paying anything, just give me a credit.
+	Please? It's not like I'm asking you for money!
+
+***************************************/
+
+#include "testbrstreams.h"
+#include "common.h"
+#include "brinputmemorystream.h"
+#include "broutputmemorystream.h"
+#include "brfile.h"
+#include "brstring.h"
+#include "brfilemanager.h"
+#include "brstringfunctions.h"
+#include "brmemoryansi.h"
+
+using namespace Burger;
+
+//
+// Scratch file for the stream tests
+//
+
+#define STREAMTESTFILE "9:testbrstreams.bin"
+
+//
+// Size of the test file, it's several windows long
+// and not a multiple of the window size
+//
+
+#define STREAMTESTSIZE 0x5123
+
+//
+// Size of the output for the write through tests, it's
+// several times the number of bytes that are kept in memory
+//
+
+#define WRITETHROUGHSIZE 0x140000
+
+//
+// Largest number of bytes OutputMemoryStream keeps in memory
+// with SetWriteThrough(pFile,2), two chunks of data
+//
+
+#define WRITETHROUGHRESIDENT 0x80000
+
+//
+// Simple random number generator so the tests are repeatable
+//
+
+static Word32 g_uSeed;
+
+static Word Random(Word uRange)
+{
+	g_uSeed = (g_uSeed*1103515245U)+12345U;
+	return (g_uSeed>>16)%uRange;
+}
+
+//
+// Create the test data, small values so "C" strings are short
+//
+
+static void CreateStreamData(Word8 *pOutput,WordPtr uLength)
+{
+	g_uSeed = 1;
+	WordPtr i = 0;
+	do {
+		pOutput[i] = static_cast<Word8>(Random(32));
+	} while (++i<uLength);
+}
+
+/***************************************
+
+	Run the same random operations on a stream and a reference
+	stream that has the entire file in memory. Every result
+	and the mark must match.
+
+***************************************/
+
+static Word CompareStreams(InputMemoryStream *pTest,InputMemoryStream *pReference,const char *pName)
+{
+	Word8 TestBuffer[0x3000];
+	Word8 ReferenceBuffer[0x3000];
+	Word uFailure = FALSE;
+	g_uSeed = 2;
+	Word uStep = 0;
+	do {
+		Word uCommand = Random(11);
+		Word uTest = FALSE;
+		WordPtr uTestResult = 0;
+		WordPtr uReferenceResult = 0;
+		switch (uCommand) {
+		case 0:
+			uTestResult = pTest->GetByte();
+			uReferenceResult = pReference->GetByte();
+			uTest = uTestResult!=uReferenceResult;
+			break;
+		case 1:
+			uTestResult = pTest->GetShort();
+			uReferenceResult = pReference->GetShort();
+			uTest = uTestResult!=uReferenceResult;
+			break;
+		case 2:
+			uTestResult = pTest->GetBigWord32();
+			uReferenceResult = pReference->GetBigWord32();
+			uTest = uTestResult!=uReferenceResult;
+			break;
+		case 3:
+		case 4:
+			{
+				// Small reads come from the window, large ones from the file
+				WordPtr uLength = Random((uCommand==3) ? 300 : sizeof(TestBuffer));
+				uTestResult = pTest->Get(TestBuffer,uLength);
+				uReferenceResult = pReference->Get(ReferenceBuffer,uLength);
+				uTest = (uTestResult!=uReferenceResult) || MemoryCompare(TestBuffer,ReferenceBuffer,uTestResult);
+			}
+			break;
+		case 5:
+			uTestResult = Random(0x1800);
+			pTest->SkipForward(uTestResult);
+			pReference->SkipForward(uTestResult);
+			break;
+		case 6:
+			uTestResult = Random(0x1800);
+			pTest->SkipBack(uTestResult);
+			pReference->SkipBack(uTestResult);
+			break;
+		case 7:
+			uTestResult = Random(STREAMTESTSIZE+16);
+			pTest->SetMark(uTestResult);
+			pReference->SetMark(uTestResult);
+			break;
+		case 8:
+			{
+				// The prefetched data must be at GetPtr()
+				WordPtr uLength = Random(0x800);
+				uTestResult = pTest->Prefetch(uLength);
+				uReferenceResult = pReference->Prefetch(uLength);
+				uTest = (uTestResult!=uReferenceResult) || MemoryCompare(pTest->GetPtr(),pReference->GetPtr(),uTestResult);
+			}
+			break;
+		case 9:
+			{
+				// Match the upcoming data, or data with the last byte changed
+				WordPtr uLength = pReference->BytesRemaining();
+				if (uLength>64) {
+					uLength = 64;
+				}
+				if (uLength) {
+					uLength = Random(static_cast<Word>(uLength))+1;
+					MemoryCopy(ReferenceBuffer,pReference->GetPtr(),uLength);
+					if (Random(2)) {
+						ReferenceBuffer[uLength-1] ^= 0x80;
+					}
+				}
+				uTestResult = pTest->IsDataMatch(ReferenceBuffer,uLength);
+				uReferenceResult = pReference->IsDataMatch(ReferenceBuffer,uLength);
+				uTest = uTestResult!=uReferenceResult;
+			}
+			break;
+		default:
+			{
+				// Nothing is stored when there's no input left
+				WordPtr uLength = Random(64)+1;
+				TestBuffer[0] = 0;
+				ReferenceBuffer[0] = 0;
+				pTest->GetCString(reinterpret_cast<char *>(TestBuffer),uLength);
+				pReference->GetCString(reinterpret_cast<char *>(ReferenceBuffer),uLength);
+				uTest = StringCompare(reinterpret_cast<char *>(TestBuffer),reinterpret_cast<char *>(ReferenceBuffer))!=0;
+			}
+			break;
+		}
+		uTest |= (pTest->GetMark()!=pReference->GetMark()) ||
+			(pTest->BytesRemaining()!=pReference->BytesRemaining()) ||
+			(pTest->IsEmpty()!=pReference->IsEmpty());
+		if (uTest) {
+			ReportFailure("%s step %u, command %u, result %u, expected %u, mark %u, expected %u",uTest,pName,uStep,uCommand,
+				static_cast<Word>(uTestResult),static_cast<Word>(uReferenceResult),
+				static_cast<Word>(pTest->GetMark()),static_cast<Word>(pReference->GetMark()));
+			uFailure = TRUE;
+			break;
+		}
+	} while (++uStep<4000);
+	return uFailure;
+}
+
+/***************************************
+
+	Test InputMemoryStream::OpenMapped()
+
+***************************************/
+
+static Word TestInputMapped(const Word8 *pData)
+{
+	static const InputMemoryStream::eAccessHint g_Hints[4] = {
+		InputMemoryStream::ACCESS_NORMAL,
+		InputMemoryStream::ACCESS_SEQUENTIAL,
+		InputMemoryStream::ACCESS_RANDOM,
+		InputMemoryStream::ACCESS_PRELOAD
+	};
+	Word uFailure = FALSE;
+	Word i = 0;
+	do {
+		InputMemoryStream Mapped;
+		Word uReturn = Mapped.OpenMapped(STREAMTESTFILE,g_Hints[i]);
+		Word uTest = (uReturn!=0) || (Mapped.GetSize()!=STREAMTESTSIZE) || Mapped.IsWindowed();
+#if defined(BURGER_LINUX)
+		// Linux maps the file instead of loading it
+		uTest |= !Mapped.IsMapped();
+#endif
+		uFailure |= uTest;
+		ReportFailure("InputMemoryStream::OpenMapped(\"" STREAMTESTFILE "\",%u) = %u, size %u",uTest,i,uReturn,static_cast<Word>(Mapped.GetSize()));
+		if (!uTest) {
+			uTest = MemoryCompare(Mapped.GetPtr(),pData,STREAMTESTSIZE)!=0;
+			uFailure |= uTest;
+			ReportFailure("InputMemoryStream::OpenMapped(\"" STREAMTESTFILE "\",%u) data mismatch",uTest,i);
+			InputMemoryStream Reference(pData,STREAMTESTSIZE,TRUE);
+			uFailure |= CompareStreams(&Mapped,&Reference,"InputMemoryStream::OpenMapped()");
+		}
+		// Clear() unmaps the file
+		Mapped.Clear();
+		uTest = Mapped.IsMapped() || Mapped.GetSize() || Mapped.GetPtr();
+		uFailure |= uTest;
+		ReportFailure("InputMemoryStream::Clear() didn't release the mapped file",uTest);
+	} while (++i<BURGER_ARRAYSIZE(g_Hints));
+
+	// A missing file leaves the stream empty
+	InputMemoryStream Missing;
+	Word uReturn = Missing.OpenMapped("9:testbrstreams.missing");
+	Word uTest = (uReturn==0) || Missing.IsMapped() || Missing.GetSize();
+	uFailure |= uTest;
+	ReportFailure("InputMemoryStream::OpenMapped(\"9:testbrstreams.missing\") = %u",uTest,uReturn);
+	return uFailure;
+}
+
+/***************************************
+
+	Test InputMemoryStream::OpenWindow()
+
+***************************************/
+
+static Word TestInputWindow(const Word8 *pData)
+{
+	// Windows smaller than the minimum are enlarged, and
+	// a window larger than the file holds all of it
+	static const WordPtr g_WindowSizes[4] = {
+		0,
+		InputMemoryStream::MINWINDOWSIZE,
+		0x1801,
+		0x10000
+	};
+	Word uFailure = FALSE;
+	Word i = 0;
+	do {
+		InputMemoryStream Window;
+		Word uReturn = Window.OpenWindow(STREAMTESTFILE,g_WindowSizes[i]);
+		Word uTest = (uReturn!=0) || (Window.GetSize()!=STREAMTESTSIZE) ||
+			!Window.IsWindowed() || Window.IsMapped() || Window.GetMark();
+		uFailure |= uTest;
+		ReportFailure("InputMemoryStream::OpenWindow(\"" STREAMTESTFILE "\",0x%X) = %u, size %u",uTest,static_cast<Word>(g_WindowSizes[i]),uReturn,static_cast<Word>(Window.GetSize()));
+		if (!uTest) {
+			// Read the whole file a byte at a time
+			WordPtr uOffset = 0;
+			do {
+				Word uByte = Window.GetByte();
+				if (uByte!=pData[uOffset]) {
+					break;
+				}
+			} while (++uOffset<STREAMTESTSIZE);
+			uTest = (uOffset!=STREAMTESTSIZE) || !Window.IsEmpty() || Window.GetByte();
+			uFailure |= uTest;
+			ReportFailure("InputMemoryStream::GetByte() window 0x%X mismatch at %u",uTest,static_cast<Word>(g_WindowSizes[i]),static_cast<Word>(uOffset));
+
+			// Read the whole file in one call after rewinding
+			Window.SetMark(0);
+			Word8 *pBuffer = static_cast<Word8 *>(Alloc(STREAMTESTSIZE));
+			WordPtr uRead = Window.Get(pBuffer,STREAMTESTSIZE);
+			uTest = (uRead!=STREAMTESTSIZE) || MemoryCompare(pBuffer,pData,STREAMTESTSIZE) || !Window.IsEmpty();
+			uFailure |= uTest;
+			ReportFailure("InputMemoryStream::Get() window 0x%X = %u",uTest,static_cast<Word>(g_WindowSizes[i]),static_cast<Word>(uRead));
+			Free(pBuffer);
+
+			Window.SetMark(0);
+			InputMemoryStream Reference(pData,STREAMTESTSIZE,TRUE);
+			uFailure |= CompareStreams(&Window,&Reference,"InputMemoryStream::OpenWindow()");
+		}
+		// Clear() closes the file
+		Window.Clear();
+		uTest = Window.IsWindowed() || Window.GetSize() || Window.GetMark();
+		uFailure |= uTest;
+		ReportFailure("InputMemoryStream::Clear() didn't close the window",uTest);
+	} while (++i<BURGER_ARRAYSIZE(g_WindowSizes));
+
+	// A missing file leaves the stream empty
+	InputMemoryStream Missing;
+	Word uReturn = Missing.OpenWindow("9:testbrstreams.missing");
+	Word uTest = (uReturn==0) || Missing.IsWindowed() || Missing.GetSize();
+	uFailure |= uTest;
+	ReportFailure("InputMemoryStream::OpenWindow(\"9:testbrstreams.missing\") = %u",uTest,uReturn);
+	return uFailure;
+}
+
+/***************************************
+
+	Overwrite part of the stream and the reference copy.
+	Pick a span that's only in the file, only in memory
+	or that crosses from the file into memory.
+
+***************************************/
+
+static Word TestOverwrite(OutputMemoryStream *pStream,Word8 *pReference,WordPtr uSize)
+{
+	Word8 Buffer[0x400];
+	WordPtr uFlushed = pStream->GetFlushedSize();
+	WordPtr uOffset;
+	WordPtr uLength = Random(0x200)+1;
+	Word uType = Random(3);
+	if (!uFlushed) {
+		uType = 1;
+	}
+	if (!uType) {
+		// Data only in the file
+		uOffset = Random(0x10000)%uFlushed;
+		if (uLength>(uFlushed-uOffset)) {
+			uLength = uFlushed-uOffset;
+		}
+	} else if (uType==1) {
+		// Data only in memory
+		uOffset = uFlushed+(Random(0x10000)%(uSize-uFlushed));
+	} else {
+		// Start in the file, end in memory
+		uOffset = uFlushed-(Random(static_cast<Word>(uLength))%uFlushed)-1;
+		uLength = (uFlushed-uOffset)+1+Random(0x100);
+	}
+	if (uLength>(uSize-uOffset)) {
+		uLength = uSize-uOffset;
+	}
+	WordPtr i = 0;
+	do {
+		Buffer[i] = static_cast<Word8>(Random(256));
+	} while (++i<uLength);
+	MemoryCopy(pReference+uOffset,Buffer,uLength);
+	Word uReturn = pStream->Overwrite(Buffer,uLength,uOffset);
+	Word uTest = uReturn!=0;
+	ReportFailure("OutputMemoryStream::Overwrite(%u bytes at %u) flushed %u = %u",uTest,static_cast<Word>(uLength),static_cast<Word>(uOffset),static_cast<Word>(uFlushed),uReturn);
+	return uTest;
+}
+
+/***************************************
+
+	Test OutputMemoryStream::SetWriteThrough()
+
+***************************************/
+
+static Word TestOutputWriteThrough(void)
+{
+	OutputMemoryStream Stream;
+	File MyFile;
+
+	// Unopened files can't be used
+	Word uReturn = Stream.SetWriteThrough(NULL);
+	Word uTest = (uReturn==0) || Stream.GetWriteThroughFile();
+	Word uFailure = uTest;
+	ReportFailure("OutputMemoryStream::SetWriteThrough(NULL) = %u",uTest,uReturn);
+	uReturn = Stream.SetWriteThrough(&MyFile);
+	uTest = (uReturn==0) || Stream.GetWriteThroughFile();
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::SetWriteThrough(closed file) = %u",uTest,uReturn);
+
+	uReturn = MyFile.Open(STREAMTESTFILE,File::WRITEONLY);
+	uTest = uReturn!=File::OKAY;
+	uFailure |= uTest;
+	ReportFailure("File::Open(\"" STREAMTESTFILE "\",File::WRITEONLY) = %u",uTest,uReturn);
+	if (uTest) {
+		return uFailure;
+	}
+
+	// The stream starts at the file's mark
+	MyFile.Write("HEAD",4);
+	uReturn = Stream.SetWriteThrough(&MyFile,2);
+	uTest = (uReturn!=0) || (Stream.GetWriteThroughFile()!=&MyFile);
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::SetWriteThrough(&MyFile,2) = %u",uTest,uReturn);
+
+	Word8 *pReference = static_cast<Word8 *>(Alloc(WRITETHROUGHSIZE));
+	g_uSeed = 3;
+	WordPtr uSize = 0;
+	Word uFlushed = FALSE;
+	do {
+		WordPtr uLength = Random(0x9000)+1;
+		if (uLength>(WRITETHROUGHSIZE-uSize)) {
+			uLength = WRITETHROUGHSIZE-uSize;
+		}
+		WordPtr i = 0;
+		do {
+			pReference[uSize+i] = static_cast<Word8>(Random(256));
+		} while (++i<uLength);
+		uReturn = Stream.Append(pReference+uSize,uLength);
+		uSize += uLength;
+		WordPtr uStreamSize = Stream.GetSize();
+		WordPtr uInMemory = uSize-Stream.GetFlushedSize();
+		uTest = (uReturn!=0) || (uStreamSize!=uSize) || (uInMemory>WRITETHROUGHRESIDENT);
+		uFailure |= uTest;
+		ReportFailure("OutputMemoryStream::Append() = %u, size %u, expected %u, in memory %u",uTest,uReturn,static_cast<Word>(uStreamSize),static_cast<Word>(uSize),static_cast<Word>(uInMemory));
+		if (uTest) {
+			break;
+		}
+
+		// While it's all in memory, the data can be compared
+		if (!Stream.GetFlushedSize()) {
+			uTest = Stream.Compare(pReference,uSize)!=FALSE;
+			uFailure |= uTest;
+			ReportFailure("OutputMemoryStream::Compare() before writing = %u",uTest,uTest);
+		}
+		uFailure |= TestOverwrite(&Stream,pReference,uSize);
+
+		// Flush once halfway through, appending must continue afterwards
+		if (!uFlushed && (uSize>=(WRITETHROUGHSIZE/2))) {
+			uFlushed = TRUE;
+			uReturn = Stream.Flush();
+			uTest = (uReturn!=0) || (Stream.GetSize()!=uSize);
+			uFailure |= uTest;
+			ReportFailure("OutputMemoryStream::Flush() = %u at %u",uTest,uReturn,static_cast<Word>(uSize));
+		}
+	} while (uSize<WRITETHROUGHSIZE);
+
+	// Some of the data must have been written early
+	uTest = !Stream.GetFlushedSize();
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::GetFlushedSize() = 0",uTest);
+
+	// The data is no longer all in memory
+	WordPtr uFlattened = 0;
+	void *pFlattened = Stream.Flatten(&uFlattened);
+	String Saved;
+	uTest = (Stream.Compare(pReference,uSize)==FALSE) ||
+		(Stream.Flatten(pReference,uSize)==0) ||
+		(pFlattened!=NULL) ||
+		(Stream.Save(&Saved)==0);
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream Compare(), Flatten() or Save() worked after writing",uTest);
+	Free(pFlattened);
+
+	// Overwriting past the end fails
+	uReturn = Stream.Overwrite("ABCD",4,uSize-2);
+	uTest = uReturn==0;
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::Overwrite() past the end = %u",uTest,uReturn);
+	MemoryCopy(pReference+uSize-2,"AB",2);
+
+	// Finish up, the file's mark was never moved
+	uReturn = Stream.Flush();
+	WordPtr uMark = MyFile.GetMark();
+	uTest = (uReturn!=0) || (uMark!=4);
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::Flush() = %u, file mark %u",uTest,uReturn,static_cast<Word>(uMark));
+	MyFile.Close();
+
+	WordPtr uLength = 0;
+	Word8 *pData = static_cast<Word8 *>(FileManager::LoadFile(STREAMTESTFILE,&uLength));
+	uTest = (!pData) || (uLength!=(uSize+4)) || MemoryCompare(pData,"HEAD",4) || MemoryCompare(pData+4,pReference,uSize);
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream write through file is %u bytes, expected %u",uTest,static_cast<Word>(uLength),static_cast<Word>(uSize+4));
+	Free(pData);
+	Free(pReference);
+
+	// Clear() unbinds the file
+	Stream.Clear();
+	uTest = Stream.GetWriteThroughFile() || Stream.GetSize() || Stream.GetFlushedSize();
+	uFailure |= uTest;
+	ReportFailure("OutputMemoryStream::Clear() didn't reset write through mode",uTest);
+	FileManager::DeleteFile(STREAMTESTFILE);
+	return uFailure;
+}
+
+/***************************************
+
+	Test the memory streams
+
+***************************************/
+
+int BURGER_API TestBrstreams(void)
+{
+	MemoryManagerGlobalANSI Memory;
+	FileManager::Init();
+	Message("Running Memory Stream tests");
+
+	Word8 *pData = static_cast<Word8 *>(Alloc(STREAMTESTSIZE));
+	CreateStreamData(pData,STREAMTESTSIZE);
+	Word uResult = FileManager::SaveFile(STREAMTESTFILE,pData,STREAMTESTSIZE)!=TRUE;
+	ReportFailure("FileManager::SaveFile(\"" STREAMTESTFILE "\") failed",uResult);
+	if (!uResult) {
+		uResult |= TestInputMapped(pData);
+		uResult |= TestInputWindow(pData);
+		FileManager::DeleteFile(STREAMTESTFILE);
+	}
+	Free(pData);
+	uResult |= TestOutputWriteThrough();
+	FileManager::Shutdown();
+	return static_cast<int>(uResult);
+}
@@ -13,6 +13,7 @@
 
 #include "testbrstrings.h"
 #include "brstringfunctions.h"
+#include "brglobpattern.h"
 #include "common.h"
 
 /***************************************
@@ -66,6 +67,89 @@ static Word TestWildcard(void)
 	return uFailure;
 }
 
+/***************************************
+
+	Test the compiled wildcard pattern class
+
+***************************************/
+
+static const Wildcard_t s_GlobPatterns[] = {
+	{"foo","**o",TRUE},
+	{"foo","*o*o*",TRUE},
+	{"foo","*o*o*o",FALSE},
+	{"","",TRUE},
+	{"foo","",FALSE},
+	{"","?",FALSE},
+	{"image.png","*.png;*.tga",TRUE},
+	{"image.tga","*.png;*.tga",TRUE},
+	{"image.bmp","*.png;*.tga",FALSE},
+	{"a;b","a\\;b",TRUE},
+	{"foo1","foo[0-9]",TRUE},
+	{"fooa","foo[0-9]",FALSE},
+	{"fooa","foo[!0-9]",TRUE},
+	{"foo1","foo[^0-9]",FALSE},
+	{"FOOB","foo[abc]",TRUE},
+	{"foo]","foo[]]",TRUE},
+	{"foo[","foo[",TRUE},
+	{"foo*","foo\\*",TRUE},
+	{"foox","foo\\*",FALSE},
+	{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaab","*a*a*a*a*a*a*a*a*a*a*b",TRUE},
+	{"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa","*a*a*a*a*a*a*a*a*a*a*b",FALSE}
+};
+
+static Word TestGlobPattern(void)
+{
+	Word uFailure = FALSE;
+
+	// It must agree with Wildcardcmp()
+	const Wildcard_t *pWork = s_Wildcards;
+	WordPtr uCount = BURGER_ARRAYSIZE(s_Wildcards);
+	do {
+		Burger::GlobPattern Pattern(pWork->m_pWild);
+		Word uTester = Pattern.Match(pWork->m_pTest);
+		Word uTest = (uTester == pWork->m_uResult);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::GlobPattern(%s).Match(%s) = %u, expected %u",uTest,pWork->m_pWild,pWork->m_pTest,uTester,!pWork->m_uResult);
+		}
+		++pWork;
+	} while (--uCount);
+
+	// Test the extensions
+	pWork = s_GlobPatterns;
+	uCount = BURGER_ARRAYSIZE(s_GlobPatterns);
+	do {
+		Burger::GlobPattern Pattern(pWork->m_pWild);
+		Word uTester = Pattern.Match(pWork->m_pTest);
+		Word uTest = (uTester != pWork->m_uResult);
+		uFailure |= uTest;
+		if (uTest) {
+			ReportFailure("Burger::GlobPattern(%s).Match(%s) = %u, expected %u",uTest,pWork->m_pWild,pWork->m_pTest,uTester,pWork->m_uResult);
+		}
+		++pWork;
+	} while (--uCount);
+
+	// Case sensitivity
+	Burger::GlobPattern Sensitive("*.TXT",Burger::GlobPattern::FLAG_CASESENSITIVE);
+	Word uTest = Sensitive.Match("file.txt") || !Sensitive.Match("file.TXT");
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::GlobPattern::FLAG_CASESENSITIVE was ignored",uTest);
+	}
+
+	// Patterns that are too long must be rejected
+	char LongPattern[80];
+	Burger::MemoryFill(LongPattern,'a',sizeof(LongPattern)-1);
+	LongPattern[sizeof(LongPattern)-1] = 0;
+	Burger::GlobPattern TooLong;
+	uTest = !TooLong.Compile(LongPattern) || TooLong.IsValid() || TooLong.Match(LongPattern);
+	uFailure |= uTest;
+	if (uTest) {
+		ReportFailure("Burger::GlobPattern::Compile() accepted a pattern that was too long",uTest);
+	}
+	return uFailure;
+}
+
 //
 // Perform all the tests for the Burgerlib Endian Manager
 //
@@ -77,5 +161,6 @@ int BURGER_API TestBrstrings(void)
 	Message("Running String tests");
 	// Test compiler switches
 	uTotal = TestWildcard();
+	uTotal |= TestGlobPattern();
 	return static_cast<int>(uTotal);
 }
@@ -14,6 +14,7 @@
 #include "testbrtimedate.h"
 #include "common.h"
 #include "brtimedate.h"
+#include "brtick.h"
 
 /***************************************
 
@@ -41,6 +42,53 @@ static Word TestBurgerTimeDateClear(void)
 	return uFailure;
 }
 
+/***************************************
+
+	Test the high resolution timers
+
+***************************************/
+
+static Word TestBurgerTickNanoseconds(void)
+{
+	// The timer must never go backwards
+	Word uFailure = FALSE;
+	Word64 uLast = Burger::Tick::ReadNanoseconds();
+	Word i = 10000;
+	do {
+		Word64 uNow = Burger::Tick::ReadNanoseconds();
+		if (uNow<uLast) {
+			uFailure = TRUE;
+		}
+		uLast = uNow;
+	} while (--i);
+	ReportFailure("Burger::Tick::ReadNanoseconds() went backwards.",uFailure);
+	Word uResult = uFailure;
+
+	// Wait for 5 milliseconds and make sure it wasn't too short
+	Burger::Stopwatch Timer;
+	uFailure = Timer.IsRunning() || Timer.GetElapsedNanoseconds();
+	Timer.Start();
+	Word64 uCycles = Burger::Tick::ReadCycles();
+	Burger::Tick::WaitNanoseconds(5000000U);
+	uCycles = Burger::Tick::ReadCycles()-uCycles;
+	Timer.Stop();
+	Word64 uElapsed = Timer.GetElapsedNanoseconds();
+	uFailure |= Timer.IsRunning() || (uElapsed<5000000U) || (Timer.GetElapsedNanoseconds()!=uElapsed);
+	uResult |= uFailure;
+	ReportFailure("Burger::Tick::WaitNanoseconds(5000000) took %u nanoseconds.",uFailure,static_cast<Word32>(uElapsed));
+
+	// The cycle counter must have advanced at roughly the right rate
+	Word64 uCyclesPerSecond = Burger::Tick::GetCyclesPerSecond();
+	Word64 uExpected = (uCyclesPerSecond/1000U)*5U;
+	uFailure = !uCyclesPerSecond || (uCycles<(uExpected/2U));
+	uResult |= uFailure;
+	ReportFailure("Burger::Tick::ReadCycles() advanced %u cycles in 5 milliseconds at %u cycles per millisecond.",uFailure,static_cast<Word32>(uCycles),static_cast<Word32>(uCyclesPerSecond/1000U));
+	if (!uFailure) {
+		Message("Burger::Tick::WaitNanoseconds(5000000) took %u nanoseconds, cycle counter is %u KHz",static_cast<Word32>(uElapsed),static_cast<Word32>(uCyclesPerSecond/1000U));
+	}
+	return uResult;
+}
+
 //
 // Perform all the tests for the Burgerlib Endian Manager
 //
@@ -52,6 +100,7 @@ int BURGER_API TestDateTime(void)
 	Message("Running Date/Time tests");
 	// Test compiler switches
 	uResult = TestBurgerTimeDateClear();
+	uResult |= TestBurgerTickNanoseconds();
 
 	if (!uResult) {
 		char Buffer[256];
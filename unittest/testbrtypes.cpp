@@ -215,6 +215,11 @@ int BURGER_API TestBrtypes(void)
 	++iTest;
 #endif
 
+#if defined(BURGER_LINUX)
+	printf("BURGER_LINUX is defined\n");
+	++iTest;
+#endif
+
 #if defined(BURGER_MAC)
 	printf("BURGER_MAC is defined\n");
 	++iTest;